@@ -0,0 +1,130 @@
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "AppendShards.h"
+
+short int appendShardsInit(struct AppendShards *shards,
+                           unsigned int shardCount,
+                           pthread_mutex_t *lock,
+                           AppendExecutor executor,
+                           void *executorContext)
+{
+    unsigned int i;
+
+    if (shards == NULL || lock == NULL || executor == NULL) {
+        return ERROR_PARAMETER_MISMATCH;
+    }
+    if (shardCount == 0) {
+        long processors = sysconf(_SC_NPROCESSORS_ONLN);
+
+        shardCount = processors > 0 ? (unsigned int) processors : 1;
+    }
+    memset(shards, 0, sizeof *shards);
+    shards->shards = aligned_alloc(APPEND_SHARD_CACHE_LINE, shardCount * sizeof *shards->shards);
+    if (shards->shards == NULL) {
+        return ERROR_STORAGE_FAILURE;
+    }
+    for (i = 0; i < shardCount; i++) {
+        atomic_init(&shards->shards[i].head, NULL);
+        atomic_init(&shards->shards[i].requestCount, 0);
+    }
+    shards->shardCount = shardCount;
+    shards->lock = lock;
+    shards->executor = executor;
+    shards->executorContext = executorContext;
+    return EXECUTION_OK;
+}
+
+unsigned int appendShardsSelect(const struct AppendShards *shards,
+                                const unsigned char *clientId,
+                                size_t clientIdLength)
+{
+    /* FNV-1a */
+    uint32_t hash = 2166136261u;
+    size_t i;
+
+    for (i = 0; i < clientIdLength; i++) {
+        hash = (hash ^ clientId[i]) * 16777619u;
+    }
+    return hash % shards->shardCount;
+}
+
+/**
+ * Executes the queued requests of all shards. The caller holds the lock. The queues are stacks, so the requests of
+ * a shard are reversed to execute them in the order of their arrival.
+ */
+static void appendShardsCombine(struct AppendShards *shards)
+{
+    unsigned int i;
+
+    shards->batchCount++;
+    for (i = 0; i < shards->shardCount; i++) {
+        struct AppendRequest *request = NULL;
+        struct AppendRequest *ordered = NULL;
+
+        /* empty queues are only read, so that their cache lines stay shared */
+        if (atomic_load_explicit(&shards->shards[i].head, memory_order_relaxed) != NULL) {
+            request = atomic_exchange_explicit(&shards->shards[i].head, NULL, memory_order_acquire);
+        }
+
+        while (request != NULL) {
+            struct AppendRequest *next = request->next;
+
+            request->next = ordered;
+            ordered = request;
+            request = next;
+        }
+        while (ordered != NULL) {
+            /* the request may be released by its thread as soon as done is set */
+            struct AppendRequest *next = ordered->next;
+
+            ordered->result = shards->executor(shards->executorContext, ordered);
+            shards->requestCount++;
+            atomic_store_explicit(&ordered->done, true, memory_order_release);
+            ordered = next;
+        }
+    }
+}
+
+short int appendShardsSubmit(struct AppendShards *shards,
+                             unsigned int shard,
+                             struct AppendRequest *request)
+{
+    struct AppendShard *queue = &shards->shards[shard];
+    struct AppendRequest *head = atomic_load_explicit(&queue->head, memory_order_relaxed);
+    unsigned int attempt;
+
+    atomic_init(&request->done, false);
+    do {
+        request->next = head;
+    } while (!atomic_compare_exchange_weak_explicit(&queue->head, &head, request, memory_order_release,
+                                                    memory_order_relaxed));
+    atomic_fetch_add_explicit(&queue->requestCount, 1, memory_order_relaxed);
+
+    for (attempt = 0; attempt < APPEND_SHARD_SPIN_COUNT; attempt++) {
+        if (atomic_load_explicit(&request->done, memory_order_acquire)) {
+            return request->result;
+        }
+        if (pthread_mutex_trylock(shards->lock) == 0) {
+            appendShardsCombine(shards);
+            pthread_mutex_unlock(shards->lock);
+        } else {
+            sched_yield();
+        }
+    }
+    /* the holder of the lock does not execute requests, e.g. updateTime, or is descheduled */
+    while (!atomic_load_explicit(&request->done, memory_order_acquire)) {
+        pthread_mutex_lock(shards->lock);
+        appendShardsCombine(shards);
+        pthread_mutex_unlock(shards->lock);
+    }
+    return request->result;
+}
+
+void appendShardsFree(struct AppendShards *shards)
+{
+    free(shards->shards);
+    memset(shards, 0, sizeof *shards);
+}
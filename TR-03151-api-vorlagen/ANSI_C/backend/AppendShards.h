@@ -0,0 +1,144 @@
+#ifndef SEAPI_BACKEND_APPEND_SHARDS_H
+#define SEAPI_BACKEND_APPEND_SHARDS_H
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "../Exception.h"
+#include "../Constant.h"
+#include "Profile.h"
+
+#if !PROFILE_CONCURRENT
+#error "the append shards require the server build profile"
+#endif
+
+/**
+ * This header file defines the shards through which the SE API backend appends log messages when it is used by
+ * many clients on many cores.
+ *
+ * The log messages have to reach the store in the order of the signature counter, so all appends are executed
+ * under one lock. Instead of handing this lock from thread to thread for every log message, the clients are hashed
+ * by their clientId to shards, usually one per core. A thread pushes its request onto the queue of its shard, which
+ * lies on its own cache line, and tries to take the lock. The thread that holds the lock takes the queues of all
+ * shards and executes the queued requests as one batch (flat combining); the other threads wait on the completion
+ * flag of their own request, which lies on their stack, and only block on the lock if the request has not been
+ * executed after a short time. The state shared by all shards, i.e. the counters and the open transactions, is
+ * therefore only touched by one thread per batch instead of by every client.
+ */
+
+/**
+ * Size of a cache line, which separates the queues of the shards
+ */
+#define APPEND_SHARD_CACHE_LINE 64
+
+/**
+ * Number of attempts to take the lock before a thread whose request has not been executed blocks on the lock
+ */
+#define APPEND_SHARD_SPIN_COUNT 128
+
+/**
+ * Request of a thread. The request is owned by the submitting thread until it is pushed onto a queue and again
+ * after done has been set.
+ */
+struct AppendRequest {
+    struct AppendRequest *next;
+    void *data;
+    short int result;
+    atomic_bool done;
+};
+
+/**
+ * Callback that executes a request while the lock is held.
+ * @param[in] executorContext
+ *                context that has been passed to appendShardsInit [OPTIONAL]
+ * @param[in] request
+ *                the request [REQUIRED]
+ * @return the result of the request, which is returned by appendShardsSubmit
+ */
+typedef short int (*AppendExecutor)(void *executorContext,
+                                    struct AppendRequest *request);
+
+/**
+ * Queue of a shard, a stack of requests that is taken as a whole by the executing thread
+ */
+struct AppendShard {
+    _Alignas(APPEND_SHARD_CACHE_LINE) struct AppendRequest *_Atomic head;
+    _Atomic uint64_t requestCount;
+    unsigned char padding[APPEND_SHARD_CACHE_LINE - sizeof(void *) - sizeof(uint64_t)];
+};
+
+/**
+ * State of the shards. The members are managed by the functions of this header file; the statistics
+ * batchCount and requestCount are only changed while the lock is held.
+ */
+struct AppendShards {
+    struct AppendShard *shards;
+    unsigned int shardCount;
+    pthread_mutex_t *lock;
+    AppendExecutor executor;
+    void *executorContext;
+    uint64_t batchCount;
+    uint64_t requestCount;
+};
+
+/**
+ * Initializes the shards.
+ * @param[out] shards
+ *                shards to be initialized [REQUIRED]
+ * @param[in] shardCount
+ *                number of shards, 0 for the number of online processors [REQUIRED]
+ * @param[in] lock
+ *                lock under which the requests are executed; it MAY also be taken by other functions [REQUIRED]
+ * @param[in] executor
+ *                callback that executes a request [REQUIRED]
+ * @param[in] executorContext
+ *                context passed to the executor [OPTIONAL]
+ * @return EXECUTION_OK, ERROR_PARAMETER_MISMATCH if a required parameter is missing or ERROR_STORAGE_FAILURE if no
+ *         memory could be allocated
+ */
+short int appendShardsInit(struct AppendShards *shards,
+                           unsigned int shardCount,
+                           pthread_mutex_t *lock,
+                           AppendExecutor executor,
+                           void *executorContext);
+
+/**
+ * Determines the shard of a client.
+ * @param[in] shards
+ *                initialized shards [REQUIRED]
+ * @param[in] clientId
+ *                the ID of the client [OPTIONAL]
+ * @param[in] clientIdLength
+ *                the length of the array that represents the clientId [REQUIRED]
+ * @return the index of the shard
+ */
+unsigned int appendShardsSelect(const struct AppendShards *shards,
+                                const unsigned char *clientId,
+                                size_t clientIdLength);
+
+/**
+ * Executes a request through the queue of a shard and waits until it has been executed, either by the calling
+ * thread or by the thread that holds the lock.
+ * @param[in] shards
+ *                initialized shards [REQUIRED]
+ * @param[in] shard
+ *                index of the shard returned by appendShardsSelect [REQUIRED]
+ * @param[in] request
+ *                request whose member data has been set [REQUIRED]
+ * @return the result returned by the executor for the request
+ */
+short int appendShardsSubmit(struct AppendShards *shards,
+                             unsigned int shard,
+                             struct AppendRequest *request);
+
+/**
+ * Releases the memory of the shards. No request MAY be submitted concurrently.
+ * @param[in] shards
+ *                initialized shards [REQUIRED]
+ */
+void appendShardsFree(struct AppendShards *shards);
+
+#endif
@@ -0,0 +1,571 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "CertificateStore.h"
+#include "Crc32.h"
+
+/**
+ * Identifies a record of the journal ("SCRT")
+ */
+#define CERTIFICATE_USAGE_MAGIC 0x53435254u
+
+#define CERTIFICATE_JOURNAL_FILE_NAME "usage.log"
+#define CERTIFICATE_FILE_SUFFIX ".cer"
+#define CERTIFICATE_TEMPORARY_FILE_SUFFIX ".cer.tmp"
+
+/**
+ * Layout of a record of the journal. The checksum covers the record from the member firstSignatureCounter on.
+ */
+struct CertificateUsageRecord {
+    uint32_t magic;
+    uint32_t crc;
+    uint64_t firstSignatureCounter;
+    unsigned char digest[SHA256_DIGEST_LENGTH];
+};
+
+static void certificateDigestHex(const unsigned char *digest,
+                                 char *hex)
+{
+    static const char digits[] = "0123456789abcdef";
+    size_t i;
+
+    for (i = 0; i < SHA256_DIGEST_LENGTH; i++) {
+        hex[2 * i] = digits[digest[i] >> 4];
+        hex[2 * i + 1] = digits[digest[i] & 0x0F];
+    }
+    hex[2 * SHA256_DIGEST_LENGTH] = '\0';
+}
+
+static short int certificateStorePath(const struct CertificateStore *store,
+                                      const unsigned char *digest,
+                                      const char *suffix,
+                                      char *path,
+                                      size_t pathSize)
+{
+    char hex[2 * SHA256_DIGEST_LENGTH + 1];
+    int length;
+
+    if (digest != NULL) {
+        certificateDigestHex(digest, hex);
+        length = snprintf(path, pathSize, "%s/%s%s", store->directory, hex, suffix);
+    } else {
+        length = snprintf(path, pathSize, "%s/%s", store->directory, suffix);
+    }
+    if (length < 0 || (size_t) length >= pathSize) {
+        return ERROR_PARAMETER_MISMATCH;
+    }
+    return EXECUTION_OK;
+}
+
+static short int certificateStoreSyncDirectory(const char *directory)
+{
+    short int result = EXECUTION_OK;
+    int fd = open(directory, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+
+    if (fd < 0) {
+        return ERROR_STORAGE_FAILURE;
+    }
+    if (fsync(fd) != 0) {
+        result = ERROR_STORAGE_FAILURE;
+    }
+    close(fd);
+    return result;
+}
+
+static size_t certificateStoreFind(const struct CertificateStore *store,
+                                   const unsigned char *digest)
+{
+    size_t i;
+
+    /* a store holds few certificates, one for every key of the Secure Element */
+    for (i = 0; i < store->certificateCount; i++) {
+        if (memcmp(store->certificates[i].digest, digest, SHA256_DIGEST_LENGTH) == 0) {
+            return i;
+        }
+    }
+    return SIZE_MAX;
+}
+
+/**
+ * Adds a certificate to the memory of the store, which takes over the data.
+ */
+static short int certificateStoreKeep(struct CertificateStore *store,
+                                      const unsigned char *digest,
+                                      unsigned char *data,
+                                      size_t dataLength)
+{
+    struct StoredCertificate *certificate;
+
+    if (store->certificateCount == store->certificateCapacity) {
+        size_t capacity = store->certificateCapacity != 0 ? 2 * store->certificateCapacity : 4;
+        struct StoredCertificate *certificates = realloc(store->certificates, capacity * sizeof *certificates);
+        if (certificates == NULL) {
+            return ERROR_STORAGE_FAILURE;
+        }
+        store->certificates = certificates;
+        store->certificateCapacity = capacity;
+    }
+    certificate = &store->certificates[store->certificateCount++];
+    memcpy(certificate->digest, digest, SHA256_DIGEST_LENGTH);
+    certificate->data = data;
+    certificate->dataLength = dataLength;
+    return EXECUTION_OK;
+}
+
+static short int certificateStoreAddUsage(struct CertificateStore *store,
+                                          uint64_t firstSignatureCounter,
+                                          size_t certificate)
+{
+    if (store->usageCount == store->usageCapacity) {
+        size_t capacity = store->usageCapacity != 0 ? 2 * store->usageCapacity : 4;
+        struct CertificateUsage *usages = realloc(store->usages, capacity * sizeof *usages);
+        if (usages == NULL) {
+            return ERROR_STORAGE_FAILURE;
+        }
+        store->usages = usages;
+        store->usageCapacity = capacity;
+    }
+    store->usages[store->usageCount].firstSignatureCounter = firstSignatureCounter;
+    store->usages[store->usageCount].certificate = certificate;
+    store->usageCount++;
+    return EXECUTION_OK;
+}
+
+/**
+ * Loads the certificate file of a digest and verifies its content.
+ */
+static short int certificateStoreLoad(struct CertificateStore *store,
+                                      const unsigned char *digest,
+                                      size_t *certificate)
+{
+    char path[4096];
+    unsigned char computed[SHA256_DIGEST_LENGTH];
+    struct stat status;
+    unsigned char *data;
+    short int result = ERROR_STORAGE_FAILURE;
+    int fd;
+
+    *certificate = certificateStoreFind(store, digest);
+    if (*certificate != SIZE_MAX) {
+        return EXECUTION_OK;
+    }
+    if (certificateStorePath(store, digest, CERTIFICATE_FILE_SUFFIX, path, sizeof path) != EXECUTION_OK) {
+        return ERROR_STORAGE_FAILURE;
+    }
+    fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return ERROR_STORAGE_FAILURE;
+    }
+    if (fstat(fd, &status) != 0 || status.st_size <= 0 || status.st_size > CERTIFICATE_MAX_SIZE) {
+        close(fd);
+        return ERROR_STORAGE_FAILURE;
+    }
+    data = malloc((size_t) status.st_size);
+    if (data != NULL && pread(fd, data, (size_t) status.st_size, 0) == (ssize_t) status.st_size) {
+        sha256Digest(data, (size_t) status.st_size, computed);
+        if (memcmp(computed, digest, SHA256_DIGEST_LENGTH) == 0) {
+            result = certificateStoreKeep(store, digest, data, (size_t) status.st_size);
+        }
+    }
+    close(fd);
+    if (result != EXECUTION_OK) {
+        free(data);
+        return result;
+    }
+    *certificate = store->certificateCount - 1;
+    return EXECUTION_OK;
+}
+
+/**
+ * Reads the journal and truncates an incompletely written record at its end.
+ */
+static short int certificateStoreReadJournal(struct CertificateStore *store)
+{
+    struct CertificateUsageRecord record;
+    uint64_t offset = 0;
+    short int result = EXECUTION_OK;
+
+    for (;;) {
+        size_t certificate;
+        ssize_t readLength = pread(store->journalFd, &record, sizeof record, (off_t) offset);
+
+        if (readLength < 0 && errno == EINTR) {
+            continue;
+        }
+        if (readLength < 0) {
+            return ERROR_STORAGE_FAILURE;
+        }
+        if ((size_t) readLength < sizeof record || record.magic != CERTIFICATE_USAGE_MAGIC
+            || record.crc != crc32Update(0, &record.firstSignatureCounter,
+                                         sizeof record - offsetof(struct CertificateUsageRecord, firstSignatureCounter))
+            || (store->usageCount > 0
+                && record.firstSignatureCounter <= store->usages[store->usageCount - 1].firstSignatureCounter)) {
+            break;
+        }
+        result = certificateStoreLoad(store, record.digest, &certificate);
+        if (result == EXECUTION_OK) {
+            result = certificateStoreAddUsage(store, record.firstSignatureCounter, certificate);
+        }
+        if (result != EXECUTION_OK) {
+            return result;
+        }
+        offset += sizeof record;
+    }
+    if (ftruncate(store->journalFd, (off_t) offset) != 0) {
+        return ERROR_STORAGE_FAILURE;
+    }
+    return EXECUTION_OK;
+}
+
+short int certificateStoreOpen(struct CertificateStore *store,
+                               const char *directory)
+{
+    char path[4096];
+    short int result;
+
+    if (store == NULL || directory == NULL) {
+        return ERROR_PARAMETER_MISMATCH;
+    }
+    memset(store, 0, sizeof *store);
+    store->journalFd = -1;
+    if (mkdir(directory, 0700) != 0 && errno != EEXIST) {
+        return ERROR_STORAGE_FAILURE;
+    }
+    store->directory = strdup(directory);
+    if (store->directory == NULL) {
+        return ERROR_STORAGE_FAILURE;
+    }
+    result = certificateStorePath(store, NULL, CERTIFICATE_JOURNAL_FILE_NAME, path, sizeof path);
+    if (result == EXECUTION_OK) {
+        store->journalFd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+        result = ERROR_STORAGE_FAILURE;
+        if (store->journalFd >= 0) {
+            /* certificateStoreClose destroys the lock of every store whose journal is open */
+            pthread_mutex_init(&store->lock, NULL);
+            result = certificateStoreReadJournal(store);
+        }
+    }
+    if (result != EXECUTION_OK) {
+        certificateStoreClose(store);
+        return result == ERROR_PARAMETER_MISMATCH ? ERROR_STORAGE_FAILURE : result;
+    }
+    return EXECUTION_OK;
+}
+
+void certificateStoreClose(struct CertificateStore *store)
+{
+    size_t i;
+
+    if (store->journalFd >= 0) {
+        close(store->journalFd);
+        pthread_mutex_destroy(&store->lock);
+    }
+    for (i = 0; i < store->certificateCount; i++) {
+        free(store->certificates[i].data);
+    }
+    free(store->certificates);
+    free(store->usages);
+    free(store->directory);
+    memset(store, 0, sizeof *store);
+    store->journalFd = -1;
+}
+
+/**
+ * Writes the file of a certificate that is not stored yet. The file is written under a temporary name and renamed,
+ * so that a stored certificate is always complete.
+ */
+static short int certificateStoreWriteFile(struct CertificateStore *store,
+                                           const unsigned char *digest,
+                                           const unsigned char *certificate,
+                                           size_t certificateLength)
+{
+    char path[4096];
+    char temporaryPath[4096];
+    size_t written = 0;
+    short int result = EXECUTION_OK;
+    int fd;
+
+    if (certificateStorePath(store, digest, CERTIFICATE_FILE_SUFFIX, path, sizeof path) != EXECUTION_OK
+        || certificateStorePath(store, digest, CERTIFICATE_TEMPORARY_FILE_SUFFIX, temporaryPath,
+                                sizeof temporaryPath) != EXECUTION_OK) {
+        return ERROR_STORAGE_FAILURE;
+    }
+    fd = open(temporaryPath, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+    if (fd < 0) {
+        return ERROR_STORAGE_FAILURE;
+    }
+    while (result == EXECUTION_OK && written < certificateLength) {
+        ssize_t writeLength = write(fd, certificate + written, certificateLength - written);
+        if (writeLength < 0 && errno != EINTR) {
+            result = ERROR_STORAGE_FAILURE;
+        } else if (writeLength > 0) {
+            written += (size_t) writeLength;
+        }
+    }
+    if (result == EXECUTION_OK && fdatasync(fd) != 0) {
+        result = ERROR_STORAGE_FAILURE;
+    }
+    close(fd);
+    if (result == EXECUTION_OK && rename(temporaryPath, path) != 0) {
+        result = ERROR_STORAGE_FAILURE;
+    }
+    if (result != EXECUTION_OK) {
+        unlink(temporaryPath);
+        return result;
+    }
+    return certificateStoreSyncDirectory(store->directory);
+}
+
+/**
+ * Appends a usage of a kept certificate to the journal. The lock MUST be held.
+ */
+static short int certificateStoreJournalUsage(struct CertificateStore *store,
+                                              uint64_t firstSignatureCounter,
+                                              size_t index)
+{
+    struct CertificateUsageRecord record;
+
+    memset(&record, 0, sizeof record);
+    record.magic = CERTIFICATE_USAGE_MAGIC;
+    record.firstSignatureCounter = firstSignatureCounter;
+    memcpy(record.digest, store->certificates[index].digest, SHA256_DIGEST_LENGTH);
+    record.crc = crc32Update(0, &record.firstSignatureCounter,
+                             sizeof record - offsetof(struct CertificateUsageRecord, firstSignatureCounter));
+    if (pwrite(store->journalFd, &record, sizeof record, (off_t) (store->usageCount * sizeof record))
+            != (ssize_t) sizeof record
+        || fdatasync(store->journalFd) != 0) {
+        return ERROR_STORAGE_FAILURE;
+    }
+    return certificateStoreAddUsage(store, firstSignatureCounter, index);
+}
+
+/**
+ * Writes and keeps a certificate that is not kept yet. The lock MUST be held.
+ */
+static short int certificateStorePut(struct CertificateStore *store,
+                                     const unsigned char *digest,
+                                     const unsigned char *certificate,
+                                     size_t certificateLength,
+                                     size_t *index)
+{
+    unsigned char *data;
+    short int result;
+
+    *index = certificateStoreFind(store, digest);
+    if (*index != SIZE_MAX) {
+        return EXECUTION_OK;
+    }
+    data = malloc(certificateLength);
+    result = data != NULL ? certificateStoreWriteFile(store, digest, certificate, certificateLength)
+                          : ERROR_STORAGE_FAILURE;
+    if (result == EXECUTION_OK) {
+        memcpy(data, certificate, certificateLength);
+        result = certificateStoreKeep(store, digest, data, certificateLength);
+    }
+    if (result != EXECUTION_OK) {
+        free(data);
+        return result;
+    }
+    *index = store->certificateCount - 1;
+    return EXECUTION_OK;
+}
+
+short int certificateStoreStage(struct CertificateStore *store,
+                                const unsigned char *certificate,
+                                size_t certificateLength,
+                                unsigned char *digest)
+{
+    unsigned char computed[SHA256_DIGEST_LENGTH];
+    size_t index;
+    short int result;
+
+    if (store == NULL || certificate == NULL || certificateLength == 0 || certificateLength > CERTIFICATE_MAX_SIZE) {
+        return ERROR_PARAMETER_MISMATCH;
+    }
+    sha256Digest(certificate, certificateLength, computed);
+    if (digest != NULL) {
+        memcpy(digest, computed, SHA256_DIGEST_LENGTH);
+    }
+    pthread_mutex_lock(&store->lock);
+    result = certificateStorePut(store, computed, certificate, certificateLength, &index);
+    pthread_mutex_unlock(&store->lock);
+    return result;
+}
+
+short int certificateStoreLoadStaged(struct CertificateStore *store,
+                                     const unsigned char *digest)
+{
+    size_t index;
+    short int result;
+
+    pthread_mutex_lock(&store->lock);
+    result = certificateStoreLoad(store, digest, &index);
+    pthread_mutex_unlock(&store->lock);
+    return result;
+}
+
+bool certificateStoreCurrent(struct CertificateStore *store,
+                             unsigned char *digest,
+                             uint64_t *firstSignatureCounter)
+{
+    bool registered;
+
+    pthread_mutex_lock(&store->lock);
+    registered = store->usageCount > 0;
+    if (registered) {
+        const struct CertificateUsage *usage = &store->usages[store->usageCount - 1];
+
+        memcpy(digest, store->certificates[usage->certificate].digest, SHA256_DIGEST_LENGTH);
+        if (firstSignatureCounter != NULL) {
+            *firstSignatureCounter = usage->firstSignatureCounter;
+        }
+    }
+    pthread_mutex_unlock(&store->lock);
+    return registered;
+}
+
+short int certificateStoreAdd(struct CertificateStore *store,
+                              const unsigned char *certificate,
+                              size_t certificateLength,
+                              uint64_t firstSignatureCounter,
+                              unsigned char *digest)
+{
+    unsigned char computed[SHA256_DIGEST_LENGTH];
+    size_t index;
+    short int result = EXECUTION_OK;
+
+    if (store == NULL || certificate == NULL || certificateLength == 0 || certificateLength > CERTIFICATE_MAX_SIZE) {
+        return ERROR_PARAMETER_MISMATCH;
+    }
+    sha256Digest(certificate, certificateLength, computed);
+    if (digest != NULL) {
+        memcpy(digest, computed, SHA256_DIGEST_LENGTH);
+    }
+
+    pthread_mutex_lock(&store->lock);
+    index = certificateStoreFind(store, computed);
+    if (store->usageCount > 0 && store->usages[store->usageCount - 1].certificate == index) {
+        goto unlock;
+    }
+    if (store->usageCount > 0 && firstSignatureCounter <= store->usages[store->usageCount - 1].firstSignatureCounter) {
+        result = ERROR_PARAMETER_MISMATCH;
+        goto unlock;
+    }
+    /* the certificate is stored before the journal refers to it */
+    result = certificateStorePut(store, computed, certificate, certificateLength, &index);
+    if (result == EXECUTION_OK) {
+        result = certificateStoreJournalUsage(store, firstSignatureCounter, index);
+    }
+
+unlock:
+    pthread_mutex_unlock(&store->lock);
+    return result;
+}
+
+short int certificateStoreUse(struct CertificateStore *store,
+                              const unsigned char *digest,
+                              uint64_t firstSignatureCounter)
+{
+    size_t index;
+    short int result = EXECUTION_OK;
+
+    pthread_mutex_lock(&store->lock);
+    index = certificateStoreFind(store, digest);
+    if (index == SIZE_MAX
+        || (store->usageCount > 0
+            && firstSignatureCounter <= store->usages[store->usageCount - 1].firstSignatureCounter)) {
+        result = ERROR_PARAMETER_MISMATCH;
+    } else if (store->usageCount == 0 || store->usages[store->usageCount - 1].certificate != index) {
+        result = certificateStoreJournalUsage(store, firstSignatureCounter, index);
+    }
+    pthread_mutex_unlock(&store->lock);
+    return result;
+}
+
+bool certificateStoreFirstUse(struct CertificateStore *store,
+                              const unsigned char *digest,
+                              uint64_t *firstSignatureCounter)
+{
+    size_t index;
+    size_t i;
+    bool used = false;
+
+    pthread_mutex_lock(&store->lock);
+    index = certificateStoreFind(store, digest);
+    for (i = 0; index != SIZE_MAX && i < store->usageCount && !used; i++) {
+        used = store->usages[i].certificate == index;
+        if (used) {
+            *firstSignatureCounter = store->usages[i].firstSignatureCounter;
+        }
+    }
+    pthread_mutex_unlock(&store->lock);
+    return used;
+}
+
+/**
+ * Returns the position of the usage that covers a signature counter, or the first usage if none covers it.
+ */
+static size_t certificateStoreUsageAt(const struct CertificateStore *store,
+                                      uint64_t signatureCounter)
+{
+    size_t low = 0;
+    size_t high = store->usageCount;
+
+    while (low < high) {
+        size_t middle = low + (high - low) / 2;
+        if (store->usages[middle].firstSignatureCounter <= signatureCounter) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return low > 0 ? low - 1 : 0;
+}
+
+short int certificateStoreAddToArchive(struct CertificateStore *store,
+                                       uint64_t firstSignatureCounter,
+                                       uint64_t lastSignatureCounter,
+                                       struct TarWriter *writer)
+{
+    struct StoredCertificate *selected;
+    bool *taken;
+    size_t selectedCount = 0;
+    size_t i;
+    short int result = EXECUTION_OK;
+    char name[2 * SHA256_DIGEST_LENGTH + 16];
+
+    pthread_mutex_lock(&store->lock);
+    selected = malloc((store->certificateCount != 0 ? store->certificateCount : 1) * sizeof *selected);
+    taken = calloc(store->certificateCount != 0 ? store->certificateCount : 1, sizeof *taken);
+    if (selected == NULL || taken == NULL) {
+        result = ERROR_STORAGE_FAILURE;
+    }
+    for (i = certificateStoreUsageAt(store, firstSignatureCounter);
+         result == EXECUTION_OK && i < store->usageCount
+         && store->usages[i].firstSignatureCounter <= lastSignatureCounter;
+         i++) {
+        size_t certificate = store->usages[i].certificate;
+        if (!taken[certificate]) {
+            taken[certificate] = true;
+            /* the data of a certificate is kept until the store is closed, so it is written without the lock */
+            selected[selectedCount++] = store->certificates[certificate];
+        }
+    }
+    pthread_mutex_unlock(&store->lock);
+
+    for (i = 0; result == EXECUTION_OK && i < selectedCount; i++) {
+        char hex[2 * SHA256_DIGEST_LENGTH + 1];
+        certificateDigestHex(selected[i].digest, hex);
+        snprintf(name, sizeof name, "%s_X509.cer", hex);
+        result = tarWriterAddFile(writer, name, selected[i].data, selected[i].dataLength, 0);
+    }
+    free(selected);
+    free(taken);
+    return result;
+}
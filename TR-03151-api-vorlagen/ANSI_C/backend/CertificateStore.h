@@ -0,0 +1,210 @@
+#ifndef SEAPI_BACKEND_CERTIFICATE_STORE_H
+#define SEAPI_BACKEND_CERTIFICATE_STORE_H
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "../Exception.h"
+#include "../Constant.h"
+#include "Sha256.h"
+#include "TarWriter.h"
+
+/**
+ * This header file defines the content-addressed store of the certificates that are needed to verify the
+ * signatures of exported log messages.
+ *
+ * Every certificate is kept once in a file named after its SHA-256 digest, however often it is registered. A
+ * journal records from which signature counter on a certificate is in use, so the certificates of an interval of
+ * signature counters are found by binary search and every certificate is added to an archive once, no matter
+ * how many of its log messages the archive contains. The certificates are kept in memory after opening.
+ */
+
+/**
+ * Maximum size of a certificate in bytes
+ */
+#define CERTIFICATE_MAX_SIZE (64u * 1024u)
+
+/**
+ * Certificate of the store, identified by its SHA-256 digest
+ */
+struct StoredCertificate {
+    unsigned char digest[SHA256_DIGEST_LENGTH];
+    unsigned char *data;
+    size_t dataLength;
+};
+
+/**
+ * Records that a certificate is used for the log messages from a signature counter on, up to the signature counter
+ * of the next usage.
+ */
+struct CertificateUsage {
+    uint64_t firstSignatureCounter;
+    size_t certificate;
+};
+
+/**
+ * State of an opened certificate store. The members are managed by the functions of this header file.
+ */
+struct CertificateStore {
+    char *directory;
+    int journalFd;
+    pthread_mutex_t lock;
+    struct StoredCertificate *certificates;
+    size_t certificateCount;
+    size_t certificateCapacity;
+    struct CertificateUsage *usages;
+    size_t usageCount;
+    size_t usageCapacity;
+};
+
+/**
+ * Opens the certificate store in the passed directory, which is created if it does not exist, and loads its
+ * certificates. An incompletely written journal record at the end of the journal is discarded.
+ * @param[out] store
+ *                store state to be initialized [REQUIRED]
+ * @param[in] directory
+ *                directory that holds the certificates and the journal [REQUIRED]
+ * @return if the execution of the function has been successful, the return value EXECUTION_OK SHALL be returned.
+ *
+ *         If the execution of the function has failed, the appropriate error code SHALL be returned:
+ *
+ *             ERROR_PARAMETER_MISMATCH
+ *                a required parameter is missing
+ *             ERROR_STORAGE_FAILURE
+ *                the directory or the journal could not be opened, or a certificate is missing or does not match
+ *                its digest
+ */
+short int certificateStoreOpen(struct CertificateStore *store,
+                               const char *directory);
+
+/**
+ * Closes a certificate store and releases its memory.
+ * @param[in] store
+ *                opened store [REQUIRED]
+ */
+void certificateStoreClose(struct CertificateStore *store);
+
+/**
+ * Registers the certificate that is used for the log messages from a signature counter on, e.g. after the key of
+ * the Secure Element has been changed. Registering the certificate that is already in use has no effect.
+ * @param[in] store
+ *                opened store [REQUIRED]
+ * @param[in] certificate
+ *                the certificate [REQUIRED]
+ * @param[in] certificateLength
+ *                length of the array that represents the certificate [REQUIRED]
+ * @param[in] firstSignatureCounter
+ *                signature counter of the first log message signed with the key of the certificate [REQUIRED]
+ * @param[out] digest
+ *                receives the SHA-256 digest that identifies the certificate [OPTIONAL]
+ * @return if the execution of the function has been successful, the return value EXECUTION_OK SHALL be returned.
+ *
+ *         If the execution of the function has failed, the appropriate error code SHALL be returned:
+ *
+ *             ERROR_PARAMETER_MISMATCH
+ *                the certificate is empty or too large, or the signature counter does not follow the last usage
+ *             ERROR_STORAGE_FAILURE
+ *                the certificate or the journal could not be written
+ */
+short int certificateStoreAdd(struct CertificateStore *store,
+                              const unsigned char *certificate,
+                              size_t certificateLength,
+                              uint64_t firstSignatureCounter,
+                              unsigned char *digest);
+
+/**
+ * Stores a certificate that is not in use yet, e.g. the certificate of a standby key, so that registering it with
+ * certificateStoreAdd later only appends a record to the journal.
+ * @param[in] store
+ *                opened store [REQUIRED]
+ * @param[in] certificate
+ *                the certificate [REQUIRED]
+ * @param[in] certificateLength
+ *                length of the array that represents the certificate [REQUIRED]
+ * @param[out] digest
+ *                receives the SHA-256 digest that identifies the certificate [OPTIONAL]
+ * @return EXECUTION_OK, ERROR_PARAMETER_MISMATCH if the certificate is empty or too large or ERROR_STORAGE_FAILURE if
+ *         the certificate could not be written
+ */
+short int certificateStoreStage(struct CertificateStore *store,
+                                const unsigned char *certificate,
+                                size_t certificateLength,
+                                unsigned char *digest);
+
+/**
+ * Loads a certificate that has been stored with certificateStoreStage before the store has been opened.
+ * @param[in] store
+ *                opened store [REQUIRED]
+ * @param[in] digest
+ *                SHA-256 digest of the certificate [REQUIRED]
+ * @return EXECUTION_OK or ERROR_STORAGE_FAILURE if the certificate is missing or does not match its digest
+ */
+short int certificateStoreLoadStaged(struct CertificateStore *store,
+                                     const unsigned char *digest);
+
+/**
+ * Registers a certificate that has been stored with certificateStoreStage for the log messages from a signature
+ * counter on. Only a record is appended to the journal, so that the certificate of a standby key is registered
+ * between two log messages without writing the certificate.
+ * @param[in] store
+ *                opened store [REQUIRED]
+ * @param[in] digest
+ *                SHA-256 digest of the certificate [REQUIRED]
+ * @param[in] firstSignatureCounter
+ *                signature counter of the first log message signed with the key of the certificate [REQUIRED]
+ * @return EXECUTION_OK, ERROR_PARAMETER_MISMATCH if the certificate has not been stored or the signature counter
+ *         does not follow the last usage, or ERROR_STORAGE_FAILURE if the journal could not be written
+ */
+short int certificateStoreUse(struct CertificateStore *store,
+                              const unsigned char *digest,
+                              uint64_t firstSignatureCounter);
+
+/**
+ * Determines from which signature counter on a certificate has been in use first.
+ * @param[in] store
+ *                opened store [REQUIRED]
+ * @param[in] digest
+ *                SHA-256 digest of the certificate [REQUIRED]
+ * @param[out] firstSignatureCounter
+ *                receives the signature counter [REQUIRED]
+ * @return true if the certificate has been in use, false otherwise
+ */
+bool certificateStoreFirstUse(struct CertificateStore *store,
+                              const unsigned char *digest,
+                              uint64_t *firstSignatureCounter);
+
+/**
+ * Determines the certificate that is in use for the next log messages.
+ * @param[in] store
+ *                opened store [REQUIRED]
+ * @param[out] digest
+ *                receives the SHA-256 digest of the certificate [REQUIRED]
+ * @param[out] firstSignatureCounter
+ *                receives the signature counter from which the certificate is in use [OPTIONAL]
+ * @return true if a certificate has been registered, false otherwise
+ */
+bool certificateStoreCurrent(struct CertificateStore *store,
+                             unsigned char *digest,
+                             uint64_t *firstSignatureCounter);
+
+/**
+ * Appends every certificate that is used for a log message within an interval of signature counters to an archive,
+ * each certificate once. The files are named after the hexadecimal digest of the certificate.
+ * @param[in] store
+ *                opened store [REQUIRED]
+ * @param[in] firstSignatureCounter
+ *                start (inclusive) of the interval [REQUIRED]
+ * @param[in] lastSignatureCounter
+ *                end (inclusive) of the interval [REQUIRED]
+ * @param[in] writer
+ *                writer of the archive [REQUIRED]
+ * @return EXECUTION_OK, ERROR_STORAGE_FAILURE if no memory could be allocated or the error code of the writer
+ */
+short int certificateStoreAddToArchive(struct CertificateStore *store,
+                                       uint64_t firstSignatureCounter,
+                                       uint64_t lastSignatureCounter,
+                                       struct TarWriter *writer);
+
+#endif
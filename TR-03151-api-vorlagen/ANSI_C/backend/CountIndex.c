@@ -0,0 +1,216 @@
+#include "CountIndex.h"
+#include "LogStore.h"
+
+/**
+ * Fields of a count entry that are searched by countIndexFirst
+ */
+enum CountIndexField {
+maxTransactionNumberUpTo, minTransactionNumberFrom, maxLogTimeUpTo, minLogTimeFrom
+};
+
+static void countIndexSetOwn(struct SegmentCountEntry *entry,
+                             const struct SegmentInfo *info)
+{
+    entry->minTransactionNumberFrom = info->transactionRecordCount > 0 ? info->minTransactionNumber : UINT64_MAX;
+    entry->maxTransactionNumberUpTo = info->transactionRecordCount > 0 ? info->maxTransactionNumber : 0;
+    entry->minLogTimeFrom = info->recordCount > 0 ? info->minLogTime : INT64_MAX;
+    entry->maxLogTimeUpTo = info->recordCount > 0 ? info->maxLogTime : INT64_MIN;
+}
+
+static void countIndexLinkPrevious(struct SegmentCountEntry *entry,
+                                   const struct SegmentCountEntry *previous,
+                                   const struct SegmentInfo *previousInfo)
+{
+    entry->recordsBefore = previous->recordsBefore + previousInfo->recordCount;
+    entry->transactionRecordsBefore = previous->transactionRecordsBefore + previousInfo->transactionRecordCount;
+    if (previous->maxTransactionNumberUpTo > entry->maxTransactionNumberUpTo) {
+        entry->maxTransactionNumberUpTo = previous->maxTransactionNumberUpTo;
+    }
+    if (previous->maxLogTimeUpTo > entry->maxLogTimeUpTo) {
+        entry->maxLogTimeUpTo = previous->maxLogTimeUpTo;
+    }
+}
+
+void countIndexRebuild(struct SegmentCountEntry *entries,
+                       const struct SegmentInfo *segments,
+                       size_t segmentCount)
+{
+    size_t i;
+
+    for (i = 0; i < segmentCount; i++) {
+        countIndexSetOwn(&entries[i], &segments[i]);
+        if (i == 0) {
+            entries[i].recordsBefore = 0;
+            entries[i].transactionRecordsBefore = 0;
+        } else {
+            countIndexLinkPrevious(&entries[i], &entries[i - 1], &segments[i - 1]);
+        }
+    }
+    for (i = segmentCount; i-- > 1;) {
+        if (entries[i].minTransactionNumberFrom < entries[i - 1].minTransactionNumberFrom) {
+            entries[i - 1].minTransactionNumberFrom = entries[i].minTransactionNumberFrom;
+        }
+        if (entries[i].minLogTimeFrom < entries[i - 1].minLogTimeFrom) {
+            entries[i - 1].minLogTimeFrom = entries[i].minLogTimeFrom;
+        }
+    }
+}
+
+void countIndexUpdateLast(struct SegmentCountEntry *entries,
+                          const struct SegmentInfo *segments,
+                          size_t segmentCount)
+{
+    size_t last = segmentCount - 1;
+    size_t i;
+
+    countIndexSetOwn(&entries[last], &segments[last]);
+    if (last == 0) {
+        entries[last].recordsBefore = 0;
+        entries[last].transactionRecordsBefore = 0;
+        return;
+    }
+    countIndexLinkPrevious(&entries[last], &entries[last - 1], &segments[last - 1]);
+
+    /* the propagation stops at the first segment that already has a lower running minimum */
+    for (i = last; i-- > 0 && entries[i].minTransactionNumberFrom > entries[last].minTransactionNumberFrom;) {
+        entries[i].minTransactionNumberFrom = entries[last].minTransactionNumberFrom;
+    }
+    for (i = last; i-- > 0 && entries[i].minLogTimeFrom > entries[last].minLogTimeFrom;) {
+        entries[i].minLogTimeFrom = entries[last].minLogTimeFrom;
+    }
+}
+
+static bool countIndexAbove(const struct SegmentCountEntry *entry,
+                            enum CountIndexField field,
+                            bool orEqual,
+                            int64_t time,
+                            uint64_t number)
+{
+    switch (field) {
+    case maxTransactionNumberUpTo:
+        return orEqual ? entry->maxTransactionNumberUpTo >= number : entry->maxTransactionNumberUpTo > number;
+    case minTransactionNumberFrom:
+        return orEqual ? entry->minTransactionNumberFrom >= number : entry->minTransactionNumberFrom > number;
+    case maxLogTimeUpTo:
+        return orEqual ? entry->maxLogTimeUpTo >= time : entry->maxLogTimeUpTo > time;
+    default:
+        return orEqual ? entry->minLogTimeFrom >= time : entry->minLogTimeFrom > time;
+    }
+}
+
+/**
+ * Binary search for the first entry whose (monotonically non-decreasing) field lies above the passed value.
+ * @return the index of the entry or segmentCount if no entry lies above the value
+ */
+static size_t countIndexFirst(const struct SegmentCountEntry *entries,
+                              size_t segmentCount,
+                              enum CountIndexField field,
+                              bool orEqual,
+                              int64_t time,
+                              uint64_t number)
+{
+    size_t low = 0;
+    size_t high = segmentCount;
+
+    while (low < high) {
+        size_t middle = low + (high - low) / 2;
+        if (countIndexAbove(&entries[middle], field, orEqual, time, number)) {
+            high = middle;
+        } else {
+            low = middle + 1;
+        }
+    }
+    return low;
+}
+
+static uint64_t countIndexRecordsBefore(const struct SegmentCountEntry *entries,
+                                        const struct SegmentInfo *segments,
+                                        size_t segmentCount,
+                                        size_t index,
+                                        bool transactionRecords)
+{
+    if (index < segmentCount) {
+        return transactionRecords ? entries[index].transactionRecordsBefore : entries[index].recordsBefore;
+    }
+    if (segmentCount == 0) {
+        return 0;
+    }
+    return transactionRecords
+           ? entries[segmentCount - 1].transactionRecordsBefore + segments[segmentCount - 1].transactionRecordCount
+           : entries[segmentCount - 1].recordsBefore + segments[segmentCount - 1].recordCount;
+}
+
+static void countIndexNarrow(size_t *begin,
+                             size_t *end,
+                             size_t candidateBegin,
+                             size_t candidateEnd)
+{
+    if (candidateBegin > *begin) {
+        *begin = candidateBegin;
+    }
+    if (candidateEnd < *end) {
+        *end = candidateEnd;
+    }
+}
+
+void countIndexQuery(const struct SegmentCountEntry *entries,
+                     const struct SegmentInfo *segments,
+                     size_t segmentCount,
+                     const struct RecordCountQuery *query,
+                     uint64_t *lowerBound,
+                     uint64_t *upperBound)
+{
+    /* [candidateBegin, candidateEnd) may contain selected log messages, [insideBegin, insideEnd) only such */
+    size_t candidateBegin = 0;
+    size_t candidateEnd = segmentCount;
+    size_t insideBegin = 0;
+    size_t insideEnd = segmentCount;
+    bool transactionRecords = query->hasTransactionInterval;
+
+    if (query->hasTransactionInterval) {
+        countIndexNarrow(&candidateBegin, &candidateEnd,
+                         countIndexFirst(entries, segmentCount, maxTransactionNumberUpTo, true, 0,
+                                         query->startTransactionNumber),
+                         countIndexFirst(entries, segmentCount, minTransactionNumberFrom, false, 0,
+                                         query->endTransactionNumber));
+        countIndexNarrow(&insideBegin, &insideEnd,
+                         countIndexFirst(entries, segmentCount, minTransactionNumberFrom, true, 0,
+                                         query->startTransactionNumber),
+                         countIndexFirst(entries, segmentCount, maxTransactionNumberUpTo, false, 0,
+                                         query->endTransactionNumber));
+    }
+    if (query->hasStartTime) {
+        countIndexNarrow(&candidateBegin, &candidateEnd,
+                         countIndexFirst(entries, segmentCount, maxLogTimeUpTo, true, query->startTime, 0),
+                         segmentCount);
+        countIndexNarrow(&insideBegin, &insideEnd,
+                         countIndexFirst(entries, segmentCount, minLogTimeFrom, true, query->startTime, 0),
+                         segmentCount);
+    }
+    if (query->hasEndTime) {
+        countIndexNarrow(&candidateBegin, &candidateEnd, 0,
+                         countIndexFirst(entries, segmentCount, minLogTimeFrom, false, query->endTime, 0));
+        countIndexNarrow(&insideBegin, &insideEnd, 0,
+                         countIndexFirst(entries, segmentCount, maxLogTimeUpTo, false, query->endTime, 0));
+    }
+
+    *upperBound = candidateBegin < candidateEnd
+                  ? countIndexRecordsBefore(entries, segments, segmentCount, candidateEnd, false)
+                    - countIndexRecordsBefore(entries, segments, segmentCount, candidateBegin, false)
+                  : 0;
+
+    *lowerBound = 0;
+    if (insideBegin < insideEnd) {
+        uint64_t all = countIndexRecordsBefore(entries, segments, segmentCount, insideEnd, false)
+                       - countIndexRecordsBefore(entries, segments, segmentCount, insideBegin, false);
+        uint64_t transactions = countIndexRecordsBefore(entries, segments, segmentCount, insideEnd, true)
+                                - countIndexRecordsBefore(entries, segments, segmentCount, insideBegin, true);
+
+        if (query->transactionRecordsFiltered) {
+            /* only the system and audit log messages are selected for certain */
+            *lowerBound = transactionRecords ? 0 : all - transactions;
+        } else {
+            *lowerBound = transactionRecords ? transactions : all;
+        }
+    }
+}
@@ -0,0 +1,101 @@
+#ifndef SEAPI_BACKEND_COUNT_INDEX_H
+#define SEAPI_BACKEND_COUNT_INDEX_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "../Exception.h"
+#include "../Constant.h"
+
+struct SegmentInfo;
+
+/**
+ * This header file defines the count index of the log store, which answers how many log messages an export
+ * selects without reading any segment.
+ *
+ * For every segment the index keeps prefix sums of the record counts, the running maximum of the transaction
+ * numbers and log times up to the segment and the running minimum from the segment on. Both running values are
+ * monotonic, so the segments that may contain selected log messages and the segments that contain selected log
+ * messages only are found by binary search. Their prefix sums give an upper and a lower bound of the number of
+ * selected log messages, which are exact if the selection starts and ends at segment boundaries.
+ */
+
+/**
+ * Count index entry of a segment, kept parallel to the index entries of the segments.
+ */
+struct SegmentCountEntry {
+    uint64_t recordsBefore;
+    uint64_t transactionRecordsBefore;
+    uint64_t maxTransactionNumberUpTo;
+    uint64_t minTransactionNumberFrom;
+    int64_t maxLogTimeUpTo;
+    int64_t minLogTimeFrom;
+};
+
+/**
+ * Describes the log messages whose number is requested.
+ * If transactionRecordsFiltered is set, transaction log messages are further filtered (e.g. by clientId)
+ * and only count towards the upper bound.
+ */
+struct RecordCountQuery {
+    bool hasTransactionInterval;
+    uint64_t startTransactionNumber;
+    uint64_t endTransactionNumber;
+    bool hasStartTime;
+    int64_t startTime;
+    bool hasEndTime;
+    int64_t endTime;
+    bool transactionRecordsFiltered;
+};
+
+/**
+ * Builds the count entries of all segments.
+ * @param[out] entries
+ *                array of segmentCount count entries [REQUIRED]
+ * @param[in] segments
+ *                index entries of the segments in the order of the store [REQUIRED]
+ * @param[in] segmentCount
+ *                number of segments [REQUIRED]
+ */
+void countIndexRebuild(struct SegmentCountEntry *entries,
+                       const struct SegmentInfo *segments,
+                       size_t segmentCount);
+
+/**
+ * Updates the count entries after the last segment has been added or has received a record.
+ * The running minima of earlier segments are lowered where the last segment undercuts them.
+ * @param[in,out] entries
+ *                array of segmentCount count entries [REQUIRED]
+ * @param[in] segments
+ *                index entries of the segments in the order of the store [REQUIRED]
+ * @param[in] segmentCount
+ *                number of segments [REQUIRED]
+ */
+void countIndexUpdateLast(struct SegmentCountEntry *entries,
+                          const struct SegmentInfo *segments,
+                          size_t segmentCount);
+
+/**
+ * Determines bounds of the number of log messages selected by a query in O(log n).
+ * @param[in] entries
+ *                array of segmentCount count entries [REQUIRED]
+ * @param[in] segments
+ *                index entries of the segments in the order of the store [REQUIRED]
+ * @param[in] segmentCount
+ *                number of segments [REQUIRED]
+ * @param[in] query
+ *                selected log messages [REQUIRED]
+ * @param[out] lowerBound
+ *                number of log messages that are selected for certain [REQUIRED]
+ * @param[out] upperBound
+ *                number of log messages in the segments that may contain selected log messages [REQUIRED]
+ */
+void countIndexQuery(const struct SegmentCountEntry *entries,
+                     const struct SegmentInfo *segments,
+                     size_t segmentCount,
+                     const struct RecordCountQuery *query,
+                     uint64_t *lowerBound,
+                     uint64_t *upperBound);
+
+#endif
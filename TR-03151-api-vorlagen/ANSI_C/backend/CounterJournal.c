@@ -0,0 +1,223 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <stddef.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "CounterJournal.h"
+#include "Crc32.h"
+
+/**
+ * Identifies a valid journal record ("SJRN")
+ */
+#define COUNTER_JOURNAL_MAGIC 0x534A524Eu
+
+/**
+ * Layout of a journal record. The journal file holds two record slots that are written alternately,
+ * so that a torn write never destroys the last valid record.
+ */
+struct CounterJournalRecord {
+    uint32_t magic;
+    uint32_t clean;
+    uint64_t sequence;
+    uint64_t windowBase[JOURNALED_COUNTER_COUNT];
+    uint64_t reservedEnd[JOURNALED_COUNTER_COUNT];
+    uint32_t crc;
+    uint32_t padding;
+};
+
+static uint32_t counterJournalChecksum(const struct CounterJournalRecord *record)
+{
+    return crc32Update(0, record, offsetof(struct CounterJournalRecord, crc));
+}
+
+static bool counterJournalReadSlot(int fd,
+                                   unsigned int slot,
+                                   struct CounterJournalRecord *record)
+{
+    ssize_t readLength;
+
+    do {
+        readLength = pread(fd, record, sizeof *record, (off_t) (slot * sizeof *record));
+    } while (readLength < 0 && errno == EINTR);
+
+    return readLength == (ssize_t) sizeof *record
+           && record->magic == COUNTER_JOURNAL_MAGIC
+           && record->crc == counterJournalChecksum(record);
+}
+
+static short int counterJournalWriteRecord(struct CounterJournal *journal,
+                                           bool clean)
+{
+    struct CounterJournalRecord record;
+    const unsigned char *bytes = (const unsigned char *) &record;
+    size_t written = 0;
+    off_t offset;
+    int i;
+
+    memset(&record, 0, sizeof record);
+    record.magic = COUNTER_JOURNAL_MAGIC;
+    record.clean = clean ? 1u : 0u;
+    record.sequence = journal->sequence + 1;
+    for (i = 0; i < JOURNALED_COUNTER_COUNT; i++) {
+        record.windowBase[i] = journal->windowBase[i];
+        record.reservedEnd[i] = journal->reservedEnd[i];
+    }
+    record.crc = counterJournalChecksum(&record);
+
+    offset = (off_t) ((record.sequence & 1u) * sizeof record);
+    while (written < sizeof record) {
+        ssize_t result = pwrite(journal->fd, bytes + written, sizeof record - written, offset + (off_t) written);
+        if (result < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            journal->failed = true;
+            return ERROR_STORAGE_FAILURE;
+        }
+        written += (size_t) result;
+    }
+    if (fdatasync(journal->fd) != 0) {
+        journal->failed = true;
+        return ERROR_STORAGE_FAILURE;
+    }
+
+    journal->sequence = record.sequence;
+    return EXECUTION_OK;
+}
+
+short int counterJournalOpen(struct CounterJournal *journal,
+                             const char *path,
+                             uint64_t reservationSize,
+                             CounterProbe probe,
+                             void *probeContext)
+{
+    struct CounterJournalRecord slots[2];
+    struct CounterJournalRecord *latest = NULL;
+    bool valid[2];
+    unsigned int slot;
+    int i;
+
+    if (journal == NULL || path == NULL || probe == NULL) {
+        return ERROR_PARAMETER_MISMATCH;
+    }
+
+    memset(journal, 0, sizeof *journal);
+    journal->reservationSize = reservationSize != 0 ? reservationSize : COUNTER_JOURNAL_DEFAULT_RESERVATION;
+    journal->fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+    if (journal->fd < 0) {
+        return ERROR_STORAGE_FAILURE;
+    }
+
+    for (slot = 0; slot < 2; slot++) {
+        valid[slot] = counterJournalReadSlot(journal->fd, slot, &slots[slot]);
+        if (valid[slot] && (latest == NULL || slots[slot].sequence > latest->sequence)) {
+            latest = &slots[slot];
+        }
+    }
+
+    for (i = 0; i < JOURNALED_COUNTER_COUNT; i++) {
+        uint64_t next;
+
+        if (latest != NULL && latest->clean) {
+            next = latest->reservedEnd[i];
+        } else {
+            /* without any valid record the whole value range is the window, which is only probed once */
+            uint64_t fromValue = latest != NULL ? latest->windowBase[i] : 1;
+            uint64_t toValue = latest != NULL ? latest->reservedEnd[i] : UINT64_MAX;
+            uint64_t highestUsed = 0;
+            bool found = false;
+
+            if (probe(probeContext, (enum JournaledCounter) i, fromValue, toValue, &highestUsed, &found) != EXECUTION_OK
+                || (found && (highestUsed < fromValue || highestUsed >= toValue))) {
+                close(journal->fd);
+                return ERROR_STORAGE_FAILURE;
+            }
+            next = found ? highestUsed + 1 : fromValue;
+        }
+
+        journal->next[i] = next;
+        journal->windowBase[i] = next;
+        journal->reservedStart[i] = next;
+        journal->reservedEnd[i] = next;
+    }
+
+    journal->sequence = latest != NULL ? latest->sequence : 0;
+    if (pthread_mutex_init(&journal->lock, NULL) != 0) {
+        close(journal->fd);
+        return ERROR_STORAGE_FAILURE;
+    }
+    return EXECUTION_OK;
+}
+
+short int counterJournalReserve(struct CounterJournal *journal,
+                                enum JournaledCounter counter,
+                                uint64_t *value)
+{
+    short int result = EXECUTION_OK;
+
+    pthread_mutex_lock(&journal->lock);
+    if (journal->failed) {
+        result = ERROR_STORAGE_FAILURE;
+    } else if (journal->next[counter] == journal->reservedEnd[counter]) {
+        uint64_t previousBase = journal->windowBase[counter];
+        uint64_t previousEnd = journal->reservedEnd[counter];
+
+        /* the previous range may still contain values that are not yet persisted by the log store */
+        journal->windowBase[counter] = journal->reservedStart[counter];
+        journal->reservedEnd[counter] = journal->next[counter] + journal->reservationSize;
+        result = counterJournalWriteRecord(journal, false);
+        if (result == EXECUTION_OK) {
+            journal->reservedStart[counter] = journal->next[counter];
+        } else {
+            journal->windowBase[counter] = previousBase;
+            journal->reservedEnd[counter] = previousEnd;
+        }
+    }
+    if (result == EXECUTION_OK) {
+        *value = journal->next[counter];
+    }
+    pthread_mutex_unlock(&journal->lock);
+    return result;
+}
+
+void counterJournalCommit(struct CounterJournal *journal,
+                          enum JournaledCounter counter)
+{
+    pthread_mutex_lock(&journal->lock);
+    journal->next[counter]++;
+    pthread_mutex_unlock(&journal->lock);
+}
+
+short int counterJournalCurrent(struct CounterJournal *journal,
+                                enum JournaledCounter counter,
+                                uint64_t *lastValue)
+{
+    pthread_mutex_lock(&journal->lock);
+    *lastValue = journal->next[counter] - 1;
+    pthread_mutex_unlock(&journal->lock);
+    return EXECUTION_OK;
+}
+
+short int counterJournalClose(struct CounterJournal *journal)
+{
+    short int result = EXECUTION_OK;
+    int i;
+
+    pthread_mutex_lock(&journal->lock);
+    if (!journal->failed) {
+        for (i = 0; i < JOURNALED_COUNTER_COUNT; i++) {
+            journal->windowBase[i] = journal->next[i];
+            journal->reservedStart[i] = journal->next[i];
+            journal->reservedEnd[i] = journal->next[i];
+        }
+        result = counterJournalWriteRecord(journal, true);
+    }
+    pthread_mutex_unlock(&journal->lock);
+
+    if (close(journal->fd) != 0 && result == EXECUTION_OK) {
+        result = ERROR_STORAGE_FAILURE;
+    }
+    pthread_mutex_destroy(&journal->lock);
+    return result;
+}
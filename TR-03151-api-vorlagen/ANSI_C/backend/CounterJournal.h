@@ -0,0 +1,169 @@
+#ifndef SEAPI_BACKEND_COUNTER_JOURNAL_H
+#define SEAPI_BACKEND_COUNTER_JOURNAL_H
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "../Exception.h"
+#include "../Constant.h"
+
+/**
+ * This header file defines the journaled allocator for the signature counter and the transaction number
+ * that are managed by the SE API backend.
+ *
+ * Ranges of counter values are reserved in a journal file ahead of use and the values are handed out from memory,
+ * so that the journal is synchronized to the storage once per reserved range instead of once per log message.
+ * After a loss of power, the reserved but unused part of the journal window is reconciled against the log store,
+ * so that the values neither repeat nor skip.
+ *
+ * The allocator relies on the log store persisting the log messages in the order of the allocated values and on
+ * at most one reserved range of values being handed out but not yet persisted at any time.
+ */
+
+/**
+ * Represents the counters that are managed by the journal.
+ */
+enum JournaledCounter {
+journaledSignatureCounter, journaledTransactionNumber
+};
+
+/**
+ * Number of counters that are managed by the journal
+ */
+#define JOURNALED_COUNTER_COUNT 2
+
+/**
+ * Default number of values that are reserved by one journal record
+ */
+#define COUNTER_JOURNAL_DEFAULT_RESERVATION 1024
+
+/**
+ * Callback that determines the highest value of a counter that has been persisted in the log store
+ * within the interval [fromValue, toValue).
+ * @param[in] probeContext
+ *                context that has been passed to counterJournalOpen [OPTIONAL]
+ * @param[in] counter
+ *                counter whose persisted values are searched [REQUIRED]
+ * @param[in] fromValue
+ *                lowest value of the interval (inclusive) [REQUIRED]
+ * @param[in] toValue
+ *                highest value of the interval (exclusive) [REQUIRED]
+ * @param[out] highestUsed
+ *                highest value found in the interval, only set if found is true [REQUIRED]
+ * @param[out] found
+ *                true if at least one value of the interval is present in the log store [REQUIRED]
+ * @return EXECUTION_OK or ERROR_STORAGE_FAILURE if the log store could not be read
+ */
+typedef short int (*CounterProbe)(void *probeContext,
+                                  enum JournaledCounter counter,
+                                  uint64_t fromValue,
+                                  uint64_t toValue,
+                                  uint64_t *highestUsed,
+                                  bool *found);
+
+/**
+ * State of an opened counter journal. The members are managed by the functions of this header file.
+ */
+struct CounterJournal {
+    int fd;
+    pthread_mutex_t lock;
+    uint64_t reservationSize;
+    uint64_t sequence;
+    /* next value that is handed out */
+    uint64_t next[JOURNALED_COUNTER_COUNT];
+    /* lowest value that may have been handed out without being persisted by the log store */
+    uint64_t windowBase[JOURNALED_COUNTER_COUNT];
+    /* first value of the range that is currently handed out */
+    uint64_t reservedStart[JOURNALED_COUNTER_COUNT];
+    /* first value that is not covered by the durable reservation (exclusive end) */
+    uint64_t reservedEnd[JOURNALED_COUNTER_COUNT];
+    bool failed;
+};
+
+/**
+ * Opens the counter journal and recovers the counters.
+ * If the journal has not been closed cleanly, the reserved window of each counter is reconciled against the
+ * log store by means of the passed probe, so that the next handed out value directly follows the highest
+ * persisted value.
+ * @param[out] journal
+ *                journal state to be initialized [REQUIRED]
+ * @param[in] path
+ *                path of the journal file, the file is created if it does not exist [REQUIRED]
+ * @param[in] reservationSize
+ *                number of values reserved per journal record, 0 selects COUNTER_JOURNAL_DEFAULT_RESERVATION [REQUIRED]
+ * @param[in] probe
+ *                callback that searches the log store for persisted counter values [REQUIRED]
+ * @param[in] probeContext
+ *                context passed to the probe [OPTIONAL]
+ * @return if the execution of the function has been successful, the return value EXECUTION_OK SHALL be returned.
+ *
+ *         If the execution of the function has failed, the appropriate error code SHALL be returned:
+ *
+ *             ERROR_PARAMETER_MISMATCH
+ *                a required parameter is missing
+ *             ERROR_STORAGE_FAILURE
+ *                the journal could not be read or written, or the log store contains values beyond the reserved window
+ */
+short int counterJournalOpen(struct CounterJournal *journal,
+                             const char *path,
+                             uint64_t reservationSize,
+                             CounterProbe probe,
+                             void *probeContext);
+
+/**
+ * Determines the next value of a counter without handing it out, so that a value whose log message is not stored
+ * is returned again by the next call. The journal is only written and synchronized if the currently reserved range
+ * has been used up. The caller serializes the calls for a counter up to counterJournalCommit.
+ * @param[in] journal
+ *                opened journal [REQUIRED]
+ * @param[in] counter
+ *                counter whose next value is requested [REQUIRED]
+ * @param[out] value
+ *                next value [REQUIRED]
+ * @return if the execution of the function has been successful, the return value EXECUTION_OK SHALL be returned.
+ *
+ *         If the execution of the function has failed, the appropriate error code SHALL be returned:
+ *
+ *             ERROR_STORAGE_FAILURE
+ *                the reservation of a new range could not be persisted
+ */
+short int counterJournalReserve(struct CounterJournal *journal,
+                                enum JournaledCounter counter,
+                                uint64_t *value);
+
+/**
+ * Hands out the value of a counter that has been returned by counterJournalReserve, after the log message that
+ * uses it has been stored.
+ * @param[in] journal
+ *                opened journal [REQUIRED]
+ * @param[in] counter
+ *                counter whose reserved value is handed out [REQUIRED]
+ */
+void counterJournalCommit(struct CounterJournal *journal,
+                          enum JournaledCounter counter);
+
+/**
+ * Determines the value of a counter that has been handed out most recently.
+ * @param[in] journal
+ *                opened journal [REQUIRED]
+ * @param[in] counter
+ *                counter whose value is requested [REQUIRED]
+ * @param[out] lastValue
+ *                value handed out most recently or 0 if no value has been handed out yet [REQUIRED]
+ * @return EXECUTION_OK
+ */
+short int counterJournalCurrent(struct CounterJournal *journal,
+                                enum JournaledCounter counter,
+                                uint64_t *lastValue);
+
+/**
+ * Closes the journal. The unused part of the reserved ranges is released by a final record,
+ * so that the next opening does not need to consult the log store.
+ * @param[in] journal
+ *                opened journal [REQUIRED]
+ * @return EXECUTION_OK or ERROR_STORAGE_FAILURE if the final record could not be persisted
+ */
+short int counterJournalClose(struct CounterJournal *journal);
+
+#endif
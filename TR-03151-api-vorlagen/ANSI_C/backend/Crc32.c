@@ -0,0 +1,39 @@
+#include <pthread.h>
+
+#include "Crc32.h"
+
+/**
+ * Lookup table for the reflected polynomial 0xEDB88320, filled on first use
+ */
+static uint32_t crc32Table[256];
+static pthread_once_t crc32TableOnce = PTHREAD_ONCE_INIT;
+
+static void crc32BuildTable(void)
+{
+    uint32_t i;
+    int bit;
+
+    for (i = 0; i < 256; i++) {
+        uint32_t value = i;
+        for (bit = 0; bit < 8; bit++) {
+            value = (value & 1u) ? (value >> 1) ^ 0xEDB88320u : value >> 1;
+        }
+        crc32Table[i] = value;
+    }
+}
+
+uint32_t crc32Update(uint32_t crc,
+                     const void *data,
+                     size_t dataLength)
+{
+    const unsigned char *bytes = (const unsigned char *) data;
+    size_t i;
+
+    pthread_once(&crc32TableOnce, crc32BuildTable);
+
+    crc = ~crc;
+    for (i = 0; i < dataLength; i++) {
+        crc = crc32Table[(crc ^ bytes[i]) & 0xFFu] ^ (crc >> 8);
+    }
+    return ~crc;
+}
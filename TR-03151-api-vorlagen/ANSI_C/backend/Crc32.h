@@ -0,0 +1,28 @@
+#ifndef SEAPI_BACKEND_CRC32_H
+#define SEAPI_BACKEND_CRC32_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * This header file defines the checksum that is used by the SE API backend to detect
+ * torn or corrupted records in its durable files (journal records, checkpoints, segment records)
+ */
+
+/**
+ * Calculates the CRC-32 (IEEE 802.3, reflected) checksum over the passed data.
+ * The calculation can be continued over several buffers by passing the result of the
+ * previous call as the parameter crc.
+ * @param[in] crc
+ *                checksum of the preceding data or 0 for the first buffer [REQUIRED]
+ * @param[in] data
+ *                data to be included in the checksum [REQUIRED]
+ * @param[in] dataLength
+ *                length of the array that represents the data [REQUIRED]
+ * @return the updated checksum
+ */
+uint32_t crc32Update(uint32_t crc,
+                     const void *data,
+                     size_t dataLength);
+
+#endif
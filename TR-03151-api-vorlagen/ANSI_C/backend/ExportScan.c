@@ -0,0 +1,1252 @@
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Crc32.h"
+#include "ExportScan.h"
+
+/**
+ * Copy of a selected log message in the queue of a segment scan. The digest of the payload is set if the export
+ * writes a manifest.
+ */
+struct ExportQueuedRecord {
+    struct LogRecord record;
+    unsigned char *storage;
+    size_t capacity;
+    bool digested;
+    unsigned char digest[SHA256_DIGEST_LENGTH];
+};
+
+/**
+ * Queue between the scan of one segment and the merge. If offsets is set, only the records at these offsets are
+ * read instead of the whole segment.
+ */
+struct ExportStream {
+    struct SegmentInfo info;
+    uint64_t *offsets;
+    size_t offsetCount;
+    pthread_mutex_t lock;
+    pthread_cond_t changed;
+    struct ExportQueuedRecord slots[EXPORT_STREAM_DEPTH];
+    size_t head;
+    size_t count;
+    bool finished;
+    short int result;
+};
+
+/**
+ * Receives the merged log messages in the order of the signature counter with the digests of their payloads, which
+ * are NULL unless the export writes a manifest.
+ * @return EXECUTION_OK or an error code that aborts the export
+ */
+typedef short int (*ExportConsumer)(void *consumerContext,
+                                    const struct LogRecord *record,
+                                    const unsigned char *digest);
+
+/**
+ * Counters of an archive that receives merged log messages
+ */
+struct ExportArchiveState {
+    struct TarWriter *writer;
+    long int maximumNumberRecords;
+    uint64_t recordCount;
+    uint64_t clientRecordCount;
+    uint64_t firstSignatureCounter;
+    uint64_t lastSignatureCounter;
+};
+
+/**
+ * Archive of a multi-client export with the queue between the merge and the thread that writes it
+ */
+struct ExportArchiveWriter {
+    struct ExportClientArchive *archive;
+    struct ExportArchiveState state;
+    struct ExportStream queue;
+    atomic_bool aborted;
+    struct CertificateStore *certificates;
+    const struct ExportFile *files;
+    size_t fileCount;
+    pthread_t thread;
+    bool started;
+};
+
+/**
+ * Partition of the merged log messages by clientId. The table maps the hash of a clientId to the index of its
+ * writer plus one, 0 marks a free entry.
+ */
+struct ExportClientsContext {
+    struct ExportArchiveWriter *writers;
+    size_t writerCount;
+    size_t *table;
+    size_t tableMask;
+};
+
+/**
+ * Shared state of the scanning threads and the merge. A thread only starts the scan of a segment if it lies
+ * within the window ahead of the segments that have been merged completely or if the merge waits for it.
+ */
+struct ExportScanContext {
+    struct LogStore *store;
+    const struct ExportSelection *selection;
+    struct ExportStream *streams;
+    size_t streamCount;
+    pthread_mutex_t lock;
+    pthread_cond_t changed;
+    size_t nextStream;
+    size_t retiredStreams;
+    size_t demandedStream;
+    size_t window;
+    atomic_bool aborted;
+    ExportThrottle throttle;
+    void *throttleContext;
+    uint64_t bytesPlanned;
+    bool digests;
+};
+
+/**
+ * Returns whether a segment may contain transaction log messages of the selected interval of transactions.
+ */
+static bool exportSelectionCoversTransactions(const struct ExportSelection *selection,
+                                              const struct SegmentInfo *info)
+{
+    return info->transactionRecordCount > 0
+           && info->maxTransactionNumber >= selection->startTransactionNumber
+           && info->minTransactionNumber <= selection->endTransactionNumber;
+}
+
+static bool exportSelectionCoversSegment(const struct ExportSelection *selection,
+                                         const struct SegmentInfo *info)
+{
+    if (info->recordCount == 0) {
+        return false;
+    }
+    if (selection->hasStartTime && info->maxLogTime < selection->startTime) {
+        return false;
+    }
+    if (selection->hasEndTime && info->minLogTime > selection->endTime) {
+        return false;
+    }
+    if (selection->hasTransactionInterval) {
+        bool signatures = selection->hasSignatureInterval
+                          && info->lastSignatureCounter >= selection->firstSignatureCounter
+                          && info->firstSignatureCounter <= selection->lastSignatureCounter;
+        return signatures || exportSelectionCoversTransactions(selection, info);
+    }
+    return true;
+}
+
+static bool exportSelectionMatches(const struct ExportSelection *selection,
+                                   const struct LogRecord *record)
+{
+    if (selection->hasStartTime && record->logTime < selection->startTime) {
+        return false;
+    }
+    if (selection->hasEndTime && record->logTime > selection->endTime) {
+        return false;
+    }
+    if (record->type != transactionLogMessage) {
+        return !selection->hasTransactionInterval
+               || (selection->hasSignatureInterval
+                   && record->signatureCounter >= selection->firstSignatureCounter
+                   && record->signatureCounter <= selection->lastSignatureCounter);
+    }
+    if (selection->hasTransactionInterval
+        && (record->transactionNumber < selection->startTransactionNumber
+            || record->transactionNumber > selection->endTransactionNumber)) {
+        return false;
+    }
+    if (selection->clientId != NULL) {
+        return record->clientIdLength == selection->clientIdLength
+               && memcmp(record->clientId, selection->clientId, selection->clientIdLength) == 0;
+    }
+    return true;
+}
+
+static short int exportSelectionEstimate(struct LogStore *store,
+                                         const struct ExportSelection *selection,
+                                         uint64_t *lowerBound,
+                                         uint64_t *upperBound)
+{
+    struct RecordCountQuery query;
+
+    memset(&query, 0, sizeof query);
+    query.hasTransactionInterval = selection->hasTransactionInterval;
+    query.startTransactionNumber = selection->startTransactionNumber;
+    query.endTransactionNumber = selection->endTransactionNumber;
+    query.hasStartTime = selection->hasStartTime;
+    query.startTime = selection->startTime;
+    query.hasEndTime = selection->hasEndTime;
+    query.endTime = selection->endTime;
+    query.transactionRecordsFiltered = selection->clientId != NULL;
+    return logStoreEstimateRecords(store, &query, lowerBound, upperBound);
+}
+
+short int exportSelectionFromPeriod(struct ExportSelection *selection,
+                                    struct tm *startDate,
+                                    struct tm *endDate,
+                                    const unsigned char *clientId,
+                                    unsigned long int clientIdLength)
+{
+    memset(selection, 0, sizeof *selection);
+    if (startDate == NULL && endDate == NULL) {
+        return ERROR_PARAMETER_MISMATCH;
+    }
+    if (startDate != NULL) {
+        struct tm copy = *startDate;
+        selection->hasStartTime = true;
+        selection->startTime = (int64_t) timegm(&copy);
+    }
+    if (endDate != NULL) {
+        struct tm copy = *endDate;
+        selection->hasEndTime = true;
+        selection->endTime = (int64_t) timegm(&copy);
+    }
+    if (selection->hasStartTime && selection->hasEndTime && selection->startTime > selection->endTime) {
+        return ERROR_PARAMETER_MISMATCH;
+    }
+    if (clientId != NULL) {
+        if (clientIdLength == 0) {
+            return ERROR_PARAMETER_MISMATCH;
+        }
+        selection->clientId = clientId;
+        selection->clientIdLength = clientIdLength;
+    }
+    return EXECUTION_OK;
+}
+
+void exportLogMessageFileName(const struct LogRecord *record,
+                              char *name,
+                              size_t nameSize)
+{
+    static const char *const operations[] = { "", "Start", "Update", "Finish" };
+    char clientId[TRANSACTION_CLIENT_ID_MAX + 1];
+    unsigned long int i;
+
+    switch (record->type) {
+    case transactionLogMessage:
+        /* the clientId becomes part of a file name, so only printable characters other than '/' are kept */
+        for (i = 0; i < record->clientIdLength && i < TRANSACTION_CLIENT_ID_MAX; i++) {
+            unsigned char c = record->clientId[i];
+            clientId[i] = (c > 0x20 && c < 0x7F && c != '/') ? (char) c : '_';
+        }
+        clientId[i] = '\0';
+        snprintf(name, nameSize, "Unixt_%lld_Sig-%llu_Log-Tra_No-%llu_%s_Client-%s.log",
+                 (long long) record->logTime, (unsigned long long) record->signatureCounter,
+                 (unsigned long long) record->transactionNumber, operations[record->operation], clientId);
+        break;
+    case systemLogMessage:
+        snprintf(name, nameSize, "Unixt_%lld_Sig-%llu_Log-Sys.log",
+                 (long long) record->logTime, (unsigned long long) record->signatureCounter);
+        break;
+    default:
+        snprintf(name, nameSize, "Unixt_%lld_Sig-%llu_Log-Aud.log",
+                 (long long) record->logTime, (unsigned long long) record->signatureCounter);
+        break;
+    }
+}
+
+static void exportScanAbort(struct ExportScanContext *context)
+{
+    size_t i;
+
+    atomic_store(&context->aborted, true);
+    pthread_mutex_lock(&context->lock);
+    pthread_cond_broadcast(&context->changed);
+    pthread_mutex_unlock(&context->lock);
+    for (i = 0; i < context->streamCount; i++) {
+        pthread_mutex_lock(&context->streams[i].lock);
+        pthread_cond_broadcast(&context->streams[i].changed);
+        pthread_mutex_unlock(&context->streams[i].lock);
+    }
+}
+
+static bool exportStreamPush(atomic_bool *aborted,
+                             struct ExportStream *stream,
+                             const struct LogRecord *record,
+                             const unsigned char *digest)
+{
+    struct ExportQueuedRecord *slot;
+    size_t required = record->clientIdLength + record->payloadLength;
+
+    pthread_mutex_lock(&stream->lock);
+    while (stream->count == EXPORT_STREAM_DEPTH && !atomic_load(aborted)) {
+        pthread_cond_wait(&stream->changed, &stream->lock);
+    }
+    if (atomic_load(aborted)) {
+        pthread_mutex_unlock(&stream->lock);
+        return false;
+    }
+    /* the tail slot is not visible to the merge until count is increased, so it is filled without the lock */
+    slot = &stream->slots[(stream->head + stream->count) % EXPORT_STREAM_DEPTH];
+    pthread_mutex_unlock(&stream->lock);
+
+    if (required > slot->capacity) {
+        unsigned char *storage = realloc(slot->storage, required);
+        if (storage == NULL) {
+            return false;
+        }
+        slot->storage = storage;
+        slot->capacity = required;
+    }
+    slot->record = *record;
+    memcpy(slot->storage, record->clientId, record->clientIdLength);
+    memcpy(slot->storage + record->clientIdLength, record->payload, record->payloadLength);
+    slot->record.clientId = slot->storage;
+    slot->record.payload = slot->storage + record->clientIdLength;
+    slot->digested = digest != NULL;
+    if (digest != NULL) {
+        memcpy(slot->digest, digest, SHA256_DIGEST_LENGTH);
+    }
+
+    pthread_mutex_lock(&stream->lock);
+    if (stream->count++ == 0) {
+        pthread_cond_broadcast(&stream->changed);
+    }
+    pthread_mutex_unlock(&stream->lock);
+    return true;
+}
+
+static void exportStreamScan(struct ExportScanContext *context,
+                             struct ExportStream *stream)
+{
+    struct SegmentReader reader;
+    struct LogRecord record;
+    unsigned char digest[SHA256_DIGEST_LENGTH];
+    bool endOfSegment = false;
+    size_t nextOffset = 0;
+    uint64_t bytesRead = 0;
+    short int result;
+
+    result = segmentReaderOpen(&reader, context->store, stream->info.id,
+                               stream->offsetCount > 0 ? stream->offsets[0] : 0);
+    if (result == EXECUTION_OK) {
+        reader.limit = stream->info.length;
+        while (result == EXECUTION_OK) {
+            uint64_t recordOffset;
+
+            if (stream->offsets != NULL) {
+                if (nextOffset == stream->offsetCount) {
+                    break;
+                }
+                segmentReaderSeek(&reader, stream->offsets[nextOffset++]);
+            }
+            recordOffset = reader.offset;
+            result = segmentReaderNext(&reader, &record, &endOfSegment);
+            if (result != EXECUTION_OK || endOfSegment) {
+                break;
+            }
+            bytesRead += reader.offset - recordOffset;
+            if (context->throttle != NULL && bytesRead >= EXPORT_THROTTLE_BYTES) {
+                if (!context->throttle(context->throttleContext, bytesRead, context->bytesPlanned)) {
+                    exportScanAbort(context);
+                    result = ERROR_STORAGE_FAILURE;
+                    break;
+                }
+                bytesRead = 0;
+            }
+            if (!exportSelectionMatches(context->selection, &record)) {
+                continue;
+            }
+            /* the payloads are hashed by the scanning threads, so the merge only copies the digests */
+            if (context->digests) {
+                sha256Digest(record.payload, record.payloadLength, digest);
+            }
+            if (!exportStreamPush(&context->aborted, stream, &record, context->digests ? digest : NULL)) {
+                result = atomic_load(&context->aborted) ? EXECUTION_OK : ERROR_STORAGE_FAILURE;
+                break;
+            }
+        }
+        if (result == EXECUTION_OK && (stream->offsets != NULL ? endOfSegment : reader.offset < stream->info.length)) {
+            /* the indexed part of a segment has to be readable completely */
+            result = atomic_load(&context->aborted) ? EXECUTION_OK : ERROR_STORAGE_FAILURE;
+        }
+        segmentReaderClose(&reader);
+    }
+    if (result == EXECUTION_OK && context->throttle != NULL && bytesRead > 0
+        && !context->throttle(context->throttleContext, bytesRead, context->bytesPlanned)) {
+        exportScanAbort(context);
+        result = ERROR_STORAGE_FAILURE;
+    }
+
+    pthread_mutex_lock(&stream->lock);
+    stream->finished = true;
+    stream->result = result;
+    pthread_cond_broadcast(&stream->changed);
+    pthread_mutex_unlock(&stream->lock);
+}
+
+static void *exportScanWorker(void *argument)
+{
+    struct ExportScanContext *context = (struct ExportScanContext *) argument;
+
+    for (;;) {
+        size_t index;
+
+        pthread_mutex_lock(&context->lock);
+        while (!atomic_load(&context->aborted) && context->nextStream < context->streamCount
+               && context->nextStream >= context->retiredStreams + context->window
+               && context->nextStream > context->demandedStream) {
+            pthread_cond_wait(&context->changed, &context->lock);
+        }
+        if (atomic_load(&context->aborted) || context->nextStream >= context->streamCount) {
+            pthread_mutex_unlock(&context->lock);
+            return NULL;
+        }
+        index = context->nextStream++;
+        pthread_mutex_unlock(&context->lock);
+
+        exportStreamScan(context, &context->streams[index]);
+    }
+}
+
+/**
+ * Waits until the stream has a log message at its head or has been scanned completely. The copies of an exhausted
+ * stream are released at once, so that the memory of an export is bounded by the streams in the merge.
+ * @return the head or NULL if the stream is exhausted
+ */
+static const struct LogRecord *exportStreamPeek(atomic_bool *aborted,
+                                                struct ExportStream *stream,
+                                                short int *result)
+{
+    const struct LogRecord *head = NULL;
+
+    pthread_mutex_lock(&stream->lock);
+    while (stream->count == 0 && !stream->finished && !atomic_load(aborted)) {
+        pthread_cond_wait(&stream->changed, &stream->lock);
+    }
+    if (stream->count > 0) {
+        head = &stream->slots[stream->head].record;
+    } else if (stream->finished) {
+        size_t slot;
+
+        /* the producer of a finished stream does not write its slots any more */
+        for (slot = 0; slot < EXPORT_STREAM_DEPTH; slot++) {
+            free(stream->slots[slot].storage);
+            stream->slots[slot].storage = NULL;
+            stream->slots[slot].capacity = 0;
+        }
+        *result = stream->result;
+    } else {
+        *result = ERROR_STORAGE_FAILURE;
+    }
+    pthread_mutex_unlock(&stream->lock);
+    return head;
+}
+
+/**
+ * Returns the digest of the log message at the head of a stream, which is only accessed by the consumer.
+ */
+static const unsigned char *exportStreamHeadDigest(const struct ExportStream *stream)
+{
+    const struct ExportQueuedRecord *slot = &stream->slots[stream->head];
+
+    return slot->digested ? slot->digest : NULL;
+}
+
+static void exportStreamPop(struct ExportStream *stream)
+{
+    pthread_mutex_lock(&stream->lock);
+    stream->head = (stream->head + 1) % EXPORT_STREAM_DEPTH;
+    if (stream->count-- == EXPORT_STREAM_DEPTH) {
+        pthread_cond_broadcast(&stream->changed);
+    }
+    pthread_mutex_unlock(&stream->lock);
+}
+
+static void exportScanSetProgress(struct ExportScanContext *context,
+                                  size_t demandedStream,
+                                  size_t retiredStreams)
+{
+    pthread_mutex_lock(&context->lock);
+    context->demandedStream = demandedStream;
+    context->retiredStreams += retiredStreams;
+    pthread_cond_broadcast(&context->changed);
+    pthread_mutex_unlock(&context->lock);
+}
+
+static uint64_t exportStreamHeadCounter(struct ExportStream *stream)
+{
+    return stream->slots[stream->head].record.signatureCounter;
+}
+
+static void exportHeapPush(struct ExportStream *streams,
+                           size_t *heap,
+                           size_t *heapSize,
+                           size_t stream)
+{
+    size_t position = (*heapSize)++;
+
+    while (position > 0) {
+        size_t parent = (position - 1) / 2;
+        if (exportStreamHeadCounter(&streams[heap[parent]]) <= exportStreamHeadCounter(&streams[stream])) {
+            break;
+        }
+        heap[position] = heap[parent];
+        position = parent;
+    }
+    heap[position] = stream;
+}
+
+static size_t exportHeapPop(struct ExportStream *streams,
+                            size_t *heap,
+                            size_t *heapSize)
+{
+    size_t top = heap[0];
+    size_t last = heap[--(*heapSize)];
+    size_t position = 0;
+
+    for (;;) {
+        size_t child = 2 * position + 1;
+        if (child >= *heapSize) {
+            break;
+        }
+        if (child + 1 < *heapSize
+            && exportStreamHeadCounter(&streams[heap[child + 1]]) < exportStreamHeadCounter(&streams[heap[child]])) {
+            child++;
+        }
+        if (exportStreamHeadCounter(&streams[last]) <= exportStreamHeadCounter(&streams[heap[child]])) {
+            break;
+        }
+        heap[position] = heap[child];
+        position = child;
+    }
+    if (*heapSize > 0) {
+        heap[position] = last;
+    }
+    return top;
+}
+
+/**
+ * Merges the streams in the order of the signature counter. A stream is added to the merge as soon as its first
+ * signature counter lies below the smallest pending one, so that only overlapping segments are merged at a time.
+ */
+static short int exportScanMerge(struct ExportScanContext *context,
+                                 ExportConsumer consume,
+                                 void *consumerContext)
+{
+    struct ExportStream *streams = context->streams;
+    size_t *heap;
+    size_t heapSize = 0;
+    size_t admitted = 0;
+    short int result = EXECUTION_OK;
+
+    heap = malloc((context->streamCount != 0 ? context->streamCount : 1) * sizeof *heap);
+    if (heap == NULL) {
+        return ERROR_STORAGE_FAILURE;
+    }
+
+    while (result == EXECUTION_OK) {
+        const struct LogRecord *record;
+        size_t stream;
+
+        while (result == EXECUTION_OK && admitted < context->streamCount
+               && (heapSize == 0
+                   || streams[admitted].info.firstSignatureCounter < exportStreamHeadCounter(&streams[heap[0]]))) {
+            exportScanSetProgress(context, admitted, 0);
+            if (exportStreamPeek(&context->aborted, &streams[admitted], &result) != NULL) {
+                exportHeapPush(streams, heap, &heapSize, admitted);
+            } else if (result == EXECUTION_OK) {
+                exportScanSetProgress(context, admitted, 1);
+            }
+            admitted++;
+        }
+        if (result != EXECUTION_OK || heapSize == 0) {
+            break;
+        }
+
+        stream = exportHeapPop(streams, heap, &heapSize);
+        record = &streams[stream].slots[streams[stream].head].record;
+        result = consume(consumerContext, record, exportStreamHeadDigest(&streams[stream]));
+        if (result != EXECUTION_OK) {
+            break;
+        }
+        exportStreamPop(&streams[stream]);
+
+        if (result == EXECUTION_OK) {
+            if (exportStreamPeek(&context->aborted, &streams[stream], &result) != NULL) {
+                exportHeapPush(streams, heap, &heapSize, stream);
+            } else if (result == EXECUTION_OK) {
+                exportScanSetProgress(context, admitted, 1);
+            }
+        }
+    }
+
+    free(heap);
+    return result;
+}
+
+/**
+ * Appends a merged log message to an archive.
+ */
+static short int exportArchiveAdd(struct ExportArchiveState *archive,
+                                  const struct LogRecord *record,
+                                  const unsigned char *digest)
+{
+    char name[512];
+
+    archive->recordCount++;
+    if (record->type == transactionLogMessage) {
+        archive->clientRecordCount++;
+    }
+    if (archive->maximumNumberRecords > 0 && archive->recordCount > (uint64_t) archive->maximumNumberRecords) {
+        return ERROR_TOO_MANY_RECORDS;
+    }
+    if (archive->recordCount == 1) {
+        archive->firstSignatureCounter = record->signatureCounter;
+    }
+    archive->lastSignatureCounter = record->signatureCounter;
+    exportLogMessageFileName(record, name, sizeof name);
+    return tarWriterAddDigestedFile(archive->writer, name, record->payload, record->payloadLength, record->logTime,
+                                    digest);
+}
+
+static short int exportArchiveConsume(void *consumerContext,
+                                      const struct LogRecord *record,
+                                      const unsigned char *digest)
+{
+    return exportArchiveAdd((struct ExportArchiveState *) consumerContext, record, digest);
+}
+
+/**
+ * Scans the segments that may contain selected log messages and passes the selected log messages to the consumer
+ * in the order of the signature counter. If digests is set, the scanning threads calculate the digests of the
+ * payloads.
+ */
+static short int exportScanSegments(struct LogStore *store,
+                                    const struct ExportSelection *selection,
+                                    bool digests,
+                                    ExportThrottle throttle,
+                                    void *throttleContext,
+                                    ExportConsumer consume,
+                                    void *consumerContext)
+{
+    struct ExportScanContext context;
+    struct SegmentInfo *segments = NULL;
+    size_t segmentCount = 0;
+    pthread_t threads[64];
+    unsigned int threadCount;
+    unsigned int started = 0;
+    short int result;
+    size_t i;
+
+    result = logStoreSnapshotSegments(store, &segments, &segmentCount);
+    if (result != EXECUTION_OK) {
+        return result;
+    }
+
+    memset(&context, 0, sizeof context);
+    context.store = store;
+    context.selection = selection;
+    context.throttle = throttle;
+    context.throttleContext = throttleContext;
+    context.digests = digests;
+    context.streams = calloc(segmentCount != 0 ? segmentCount : 1, sizeof *context.streams);
+    if (context.streams == NULL) {
+        logStoreReleaseSnapshot(store, segments);
+        return ERROR_STORAGE_FAILURE;
+    }
+    for (i = 0; result == EXECUTION_OK && i < segmentCount; i++) {
+        uint64_t *offsets = NULL;
+        size_t offsetCount = 0;
+
+        if (!exportSelectionCoversSegment(selection, &segments[i])) {
+            continue;
+        }
+        if (selection->hasSignatureInterval && !exportSelectionCoversTransactions(selection, &segments[i])) {
+            /* a segment without selected transactions only contributes system log messages and audit log messages,
+               which are read at the offsets of the interval index */
+            result = logStoreSystemLogOffsets(store, &segments[i], selection->firstSignatureCounter,
+                                              selection->lastSignatureCounter, &offsets, &offsetCount);
+            if (result != EXECUTION_OK || offsetCount == 0) {
+                free(offsets);
+                continue;
+            }
+        }
+        /* a scan at the offsets of the interval index reads about the share of the records at these offsets */
+        context.bytesPlanned += offsets != NULL && segments[i].recordCount > offsetCount
+                                ? segments[i].length / segments[i].recordCount * offsetCount
+                                : segments[i].length;
+        context.streams[context.streamCount].info = segments[i];
+        context.streams[context.streamCount].offsets = offsets;
+        context.streams[context.streamCount].offsetCount = offsetCount;
+        pthread_mutex_init(&context.streams[context.streamCount].lock, NULL);
+        pthread_cond_init(&context.streams[context.streamCount].changed, NULL);
+        context.streamCount++;
+    }
+
+    threadCount = store->scanThreads;
+    if (threadCount > 64) {
+        threadCount = 64;
+    }
+    context.window = 2 * (size_t) threadCount;
+    pthread_mutex_init(&context.lock, NULL);
+    pthread_cond_init(&context.changed, NULL);
+    atomic_init(&context.aborted, false);
+    for (i = 0; result == EXECUTION_OK && i < threadCount && i < context.streamCount; i++) {
+        if (pthread_create(&threads[started], NULL, exportScanWorker, &context) == 0) {
+            started++;
+        }
+    }
+
+    if (result == EXECUTION_OK && context.streamCount > 0 && started == 0) {
+        result = ERROR_STORAGE_FAILURE;
+    } else if (result == EXECUTION_OK) {
+        result = exportScanMerge(&context, consume, consumerContext);
+    }
+    exportScanAbort(&context);
+    for (i = 0; i < started; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    /* the segments may be retired as soon as no thread reads them any more */
+    logStoreReleaseSnapshot(store, segments);
+
+    for (i = 0; i < context.streamCount; i++) {
+        size_t slot;
+        for (slot = 0; slot < EXPORT_STREAM_DEPTH; slot++) {
+            free(context.streams[i].slots[slot].storage);
+        }
+        free(context.streams[i].offsets);
+        pthread_cond_destroy(&context.streams[i].changed);
+        pthread_mutex_destroy(&context.streams[i].lock);
+    }
+    free(context.streams);
+    pthread_cond_destroy(&context.changed);
+    pthread_mutex_destroy(&context.lock);
+    return result;
+}
+
+/**
+ * Implementation of exportScanRun that also reports the signature counters of the first and the last exported log
+ * message.
+ */
+static short int exportScanExecute(struct LogStore *store,
+                                   const struct ExportSelection *selection,
+                                   long int maximumNumberRecords,
+                                   ExportThrottle throttle,
+                                   void *throttleContext,
+                                   struct TarWriter *writer,
+                                   uint64_t *firstSignatureCounter,
+                                   uint64_t *lastSignatureCounter)
+{
+    struct ExportArchiveState archive;
+    uint64_t lowerBound;
+    uint64_t upperBound;
+    short int result;
+
+    result = exportSelectionEstimate(store, selection, &lowerBound, &upperBound);
+    if (result != EXECUTION_OK) {
+        return result;
+    }
+    if (maximumNumberRecords > 0 && lowerBound > (uint64_t) maximumNumberRecords) {
+        return ERROR_TOO_MANY_RECORDS;
+    }
+    if (upperBound == 0) {
+        return ERROR_NO_DATA_AVAILABLE;
+    }
+
+    memset(&archive, 0, sizeof archive);
+    archive.writer = writer;
+    archive.maximumNumberRecords = maximumNumberRecords;
+    result = exportScanSegments(store, selection, writer->manifest != NULL, throttle, throttleContext,
+                                exportArchiveConsume, &archive);
+    *firstSignatureCounter = archive.firstSignatureCounter;
+    *lastSignatureCounter = archive.lastSignatureCounter;
+
+    if (result == EXECUTION_OK && archive.recordCount == 0) {
+        result = ERROR_NO_DATA_AVAILABLE;
+    } else if (result == EXECUTION_OK && selection->clientId != NULL && archive.clientRecordCount == 0) {
+        result = ERROR_ID_NOT_FOUND;
+    }
+    return result;
+}
+
+short int exportScanRun(struct LogStore *store,
+                        const struct ExportSelection *selection,
+                        long int maximumNumberRecords,
+                        struct TarWriter *writer)
+{
+    uint64_t firstSignatureCounter = 0;
+    uint64_t lastSignatureCounter = 0;
+
+    return exportScanExecute(store, selection, maximumNumberRecords, NULL, NULL, writer, &firstSignatureCounter,
+                             &lastSignatureCounter);
+}
+
+/**
+ * Runs an export into a TarMemorySink, adds the certificates of the exported log messages and, if requested, the
+ * manifest and finishes the archive.
+ * If allowEmpty is set, an export without selected log messages results in an archive without log messages.
+ */
+static short int exportScanToMemory(struct LogStore *store,
+                                    const struct ExportSelection *selection,
+                                    long int maximumNumberRecords,
+                                    bool manifest,
+                                    ExportThrottle throttle,
+                                    void *throttleContext,
+                                    bool allowEmpty,
+                                    unsigned char **exportedData,
+                                    unsigned long int *exportedDataLength,
+                                    uint64_t *lastSignatureCounter)
+{
+    struct TarMemorySink sink;
+    struct TarManifest archiveManifest;
+    struct TarWriter *writer;
+    uint64_t firstSignatureCounter = 0;
+    short int result;
+
+    *lastSignatureCounter = 0;
+    /* the writer holds its output buffer, so it is kept off the stack */
+    writer = malloc(sizeof *writer);
+    if (writer == NULL) {
+        return ERROR_STORAGE_FAILURE;
+    }
+    memset(&sink, 0, sizeof sink);
+    tarWriterInit(writer, tarMemorySinkWrite, &sink);
+    tarManifestInit(&archiveManifest, store->scanThreads);
+    if (manifest) {
+        tarWriterAttachManifest(writer, &archiveManifest);
+    }
+    result = exportScanExecute(store, selection, maximumNumberRecords, throttle, throttleContext, writer,
+                               &firstSignatureCounter, lastSignatureCounter);
+    if (result == ERROR_NO_DATA_AVAILABLE && allowEmpty) {
+        result = EXECUTION_OK;
+    } else if (result == EXECUTION_OK) {
+        result = certificateStoreAddToArchive(&store->certificates, firstSignatureCounter, *lastSignatureCounter,
+                                              writer);
+    }
+    if (result == EXECUTION_OK) {
+        result = tarWriterFinish(writer);
+    }
+    free(writer);
+    tarManifestFree(&archiveManifest);
+
+    if (result != EXECUTION_OK) {
+        free(sink.data);
+        return result;
+    }
+    *exportedData = sink.data;
+    *exportedDataLength = (unsigned long int) sink.length;
+    return EXECUTION_OK;
+}
+
+short int exportScanPeriodOfTime(struct LogStore *store,
+                                 struct tm *startDate,
+                                 struct tm *endDate,
+                                 const unsigned char *clientId,
+                                 unsigned long int clientIdLength,
+                                 long int maximumNumberRecords,
+                                 bool manifest,
+                                 ExportThrottle throttle,
+                                 void *throttleContext,
+                                 unsigned char **exportedData,
+                                 unsigned long int *exportedDataLength)
+{
+    struct ExportSelection selection;
+    uint64_t lastSignatureCounter;
+    short int result;
+
+    if (exportedData == NULL || exportedDataLength == NULL) {
+        return ERROR_PARAMETER_MISMATCH;
+    }
+    result = exportSelectionFromPeriod(&selection, startDate, endDate, clientId, clientIdLength);
+    if (result != EXECUTION_OK) {
+        return result;
+    }
+    return exportScanToMemory(store, &selection, maximumNumberRecords, manifest, throttle, throttleContext, false,
+                              exportedData, exportedDataLength, &lastSignatureCounter);
+}
+
+short int exportScanAll(struct LogStore *store,
+                        long int maximumNumberRecords,
+                        bool manifest,
+                        ExportThrottle throttle,
+                        void *throttleContext,
+                        unsigned char **exportedData,
+                        unsigned long int *exportedDataLength)
+{
+    struct ExportSelection selection;
+    uint64_t lastSignatureCounter;
+    short int result;
+
+    if (exportedData == NULL || exportedDataLength == NULL) {
+        return ERROR_PARAMETER_MISMATCH;
+    }
+    /* an empty store is exported as an archive without log messages */
+    memset(&selection, 0, sizeof selection);
+    result = exportScanToMemory(store, &selection, maximumNumberRecords, manifest, throttle, throttleContext, true,
+                                exportedData, exportedDataLength, &lastSignatureCounter);
+    if (result == EXECUTION_OK && lastSignatureCounter != 0) {
+        /* every log message up to the last one of the archive has been exported and may be deleted */
+        logStoreMarkExported(store, lastSignatureCounter);
+    }
+    return result;
+}
+
+/**
+ * Searches a segment for the first or the last selected transaction log message.
+ * @param[out] clientMismatch
+ *                set if a transaction log message of the interval has been skipped because of its clientId
+ */
+static short int exportSegmentFindTransaction(struct LogStore *store,
+                                              const struct ExportSelection *selection,
+                                              const struct SegmentInfo *info,
+                                              bool last,
+                                              uint64_t *signatureCounter,
+                                              bool *found,
+                                              bool *clientMismatch)
+{
+    struct ExportSelection interval = *selection;
+    struct SegmentReader reader;
+    struct LogRecord record;
+    bool endOfSegment = false;
+    short int result;
+
+    interval.clientId = NULL;
+    *found = false;
+    result = segmentReaderOpen(&reader, store, info->id, 0);
+    if (result != EXECUTION_OK) {
+        return result;
+    }
+    reader.limit = info->length;
+    while (result == EXECUTION_OK) {
+        result = segmentReaderNext(&reader, &record, &endOfSegment);
+        if (result != EXECUTION_OK || endOfSegment) {
+            break;
+        }
+        if (record.type != transactionLogMessage || !exportSelectionMatches(&interval, &record)) {
+            continue;
+        }
+        if (!exportSelectionMatches(selection, &record)) {
+            *clientMismatch = true;
+            continue;
+        }
+        /* the records of a segment are ordered by the signature counter */
+        *signatureCounter = record.signatureCounter;
+        *found = true;
+        if (!last) {
+            break;
+        }
+    }
+    segmentReaderClose(&reader);
+    return result;
+}
+
+short int exportSelectionFromTransactionInterval(struct ExportSelection *selection,
+                                               struct LogStore *store,
+                                               uint64_t startTransactionNumber,
+                                               uint64_t endTransactionNumber,
+                                               const unsigned char *clientId,
+                                               unsigned long int clientIdLength)
+{
+    struct SegmentInfo *segments = NULL;
+    size_t segmentCount = 0;
+    bool clientMismatch = false;
+    bool found = false;
+    short int result;
+    size_t first;
+    size_t i;
+
+    memset(selection, 0, sizeof *selection);
+    if (startTransactionNumber > endTransactionNumber || (clientId != NULL && clientIdLength == 0)) {
+        return ERROR_PARAMETER_MISMATCH;
+    }
+    selection->hasTransactionInterval = true;
+    selection->startTransactionNumber = startTransactionNumber;
+    selection->endTransactionNumber = endTransactionNumber;
+    selection->clientId = clientId;
+    selection->clientIdLength = clientId != NULL ? clientIdLength : 0;
+
+    result = logStoreSnapshotSegments(store, &segments, &segmentCount);
+    if (result != EXECUTION_OK) {
+        return result;
+    }
+    for (first = 0; result == EXECUTION_OK && !found && first < segmentCount; first++) {
+        if (exportSelectionCoversSegment(selection, &segments[first])) {
+            result = exportSegmentFindTransaction(store, selection, &segments[first], false,
+                                                  &selection->firstSignatureCounter, &found, &clientMismatch);
+        }
+    }
+    if (result == EXECUTION_OK && found) {
+        /* the last selected transaction log message lies in the segment of the first one or behind it */
+        found = false;
+        for (i = segmentCount; result == EXECUTION_OK && !found && i-- > first - 1;) {
+            if (exportSelectionCoversSegment(selection, &segments[i])) {
+                result = exportSegmentFindTransaction(store, selection, &segments[i], true,
+                                                      &selection->lastSignatureCounter, &found, &clientMismatch);
+            }
+        }
+    }
+    logStoreReleaseSnapshot(store, segments);
+    if (result != EXECUTION_OK) {
+        return result;
+    }
+    if (!found) {
+        return clientMismatch ? ERROR_ID_NOT_FOUND : ERROR_TRANSACTION_NUMBER_NOT_FOUND;
+    }
+    selection->hasSignatureInterval = true;
+    return EXECUTION_OK;
+}
+
+short int exportScanTransactionInterval(struct LogStore *store,
+                                        uint64_t startTransactionNumber,
+                                        uint64_t endTransactionNumber,
+                                        const unsigned char *clientId,
+                                        unsigned long int clientIdLength,
+                                        long int maximumNumberRecords,
+                                        bool manifest,
+                                        ExportThrottle throttle,
+                                        void *throttleContext,
+                                        unsigned char **exportedData,
+                                        unsigned long int *exportedDataLength)
+{
+    struct ExportSelection selection;
+    uint64_t lowerBound;
+    uint64_t upperBound;
+    uint64_t lastSignatureCounter;
+    short int result;
+
+    if (exportedData == NULL || exportedDataLength == NULL || startTransactionNumber > endTransactionNumber
+        || (clientId != NULL && clientIdLength == 0)) {
+        return ERROR_PARAMETER_MISMATCH;
+    }
+    memset(&selection, 0, sizeof selection);
+    selection.hasTransactionInterval = true;
+    selection.startTransactionNumber = startTransactionNumber;
+    selection.endTransactionNumber = endTransactionNumber;
+    selection.clientId = clientId;
+    selection.clientIdLength = clientId != NULL ? clientIdLength : 0;
+
+    /* the limit is enforced before the ends of the interval are searched in the segments */
+    result = exportSelectionEstimate(store, &selection, &lowerBound, &upperBound);
+    if (result != EXECUTION_OK) {
+        return result;
+    }
+    if (maximumNumberRecords > 0 && lowerBound > (uint64_t) maximumNumberRecords) {
+        return ERROR_TOO_MANY_RECORDS;
+    }
+    if (upperBound == 0) {
+        return ERROR_TRANSACTION_NUMBER_NOT_FOUND;
+    }
+
+    result = exportSelectionFromTransactionInterval(&selection, store, startTransactionNumber, endTransactionNumber,
+                                                    clientId, clientIdLength);
+    if (result != EXECUTION_OK) {
+        return result;
+    }
+    result = exportScanToMemory(store, &selection, maximumNumberRecords, manifest, throttle, throttleContext, false,
+                                exportedData, exportedDataLength, &lastSignatureCounter);
+    return result == ERROR_NO_DATA_AVAILABLE ? ERROR_TRANSACTION_NUMBER_NOT_FOUND : result;
+}
+
+static uint32_t exportClientHash(const unsigned char *clientId,
+                                 unsigned long int clientIdLength)
+{
+    return crc32Update(0, clientId, clientIdLength);
+}
+
+/**
+ * Returns the writer of the archive of a clientId or NULL if no archive has been requested for it.
+ */
+static struct ExportArchiveWriter *exportClientsFind(const struct ExportClientsContext *clients,
+                                                    const unsigned char *clientId,
+                                                    unsigned long int clientIdLength)
+{
+    size_t position = exportClientHash(clientId, clientIdLength) & clients->tableMask;
+
+    while (clients->table[position] != 0) {
+        struct ExportArchiveWriter *writer = &clients->writers[clients->table[position] - 1];
+        if (writer->archive->clientIdLength == clientIdLength
+            && memcmp(writer->archive->clientId, clientId, clientIdLength) == 0) {
+            return writer;
+        }
+        position = (position + 1) & clients->tableMask;
+    }
+    return NULL;
+}
+
+static void exportArchiveWriterAbort(struct ExportArchiveWriter *writer)
+{
+    atomic_store(&writer->aborted, true);
+    pthread_mutex_lock(&writer->queue.lock);
+    pthread_cond_broadcast(&writer->queue.changed);
+    pthread_mutex_unlock(&writer->queue.lock);
+}
+
+/**
+ * Queues a log message for the thread of an archive. If the log message cannot be copied, the archive is
+ * aborted and its thread reports ERROR_STORAGE_FAILURE.
+ */
+static void exportArchiveWriterPush(struct ExportArchiveWriter *writer,
+                                    const struct LogRecord *record,
+                                    const unsigned char *digest)
+{
+    if (!atomic_load(&writer->aborted) && !exportStreamPush(&writer->aborted, &writer->queue, record, digest)) {
+        exportArchiveWriterAbort(writer);
+    }
+}
+
+/**
+ * Distributes a merged log message: transaction log messages go to the archive of their clientId, system log
+ * messages and audit log messages to every archive.
+ */
+static short int exportClientsConsume(void *consumerContext,
+                                      const struct LogRecord *record,
+                                      const unsigned char *digest)
+{
+    struct ExportClientsContext *clients = (struct ExportClientsContext *) consumerContext;
+    struct ExportArchiveWriter *writer;
+    size_t i;
+
+    if (record->type == transactionLogMessage) {
+        writer = exportClientsFind(clients, record->clientId, record->clientIdLength);
+        if (writer != NULL) {
+            exportArchiveWriterPush(writer, record, digest);
+        }
+        return EXECUTION_OK;
+    }
+    for (i = 0; i < clients->writerCount; i++) {
+        exportArchiveWriterPush(&clients->writers[i], record, digest);
+    }
+    return EXECUTION_OK;
+}
+
+/**
+ * Thread that writes the queued log messages of one archive, appends their certificates and the additional files
+ * and finishes the archive. After a failure the thread aborts its queue, so that the merge skips the archive.
+ */
+static void *exportArchiveWriterRun(void *argument)
+{
+    struct ExportArchiveWriter *writer = (struct ExportArchiveWriter *) argument;
+    const struct LogRecord *record;
+    short int result = EXECUTION_OK;
+    size_t i;
+
+    while ((record = exportStreamPeek(&writer->aborted, &writer->queue, &result)) != NULL) {
+        result = exportArchiveAdd(&writer->state, record, exportStreamHeadDigest(&writer->queue));
+        exportStreamPop(&writer->queue);
+        if (result != EXECUTION_OK) {
+            exportArchiveWriterAbort(writer);
+            break;
+        }
+    }
+    if (result == EXECUTION_OK && writer->state.clientRecordCount == 0) {
+        result = ERROR_ID_NOT_FOUND;
+    }
+    if (result == EXECUTION_OK) {
+        result = certificateStoreAddToArchive(writer->certificates, writer->state.firstSignatureCounter,
+                                              writer->state.lastSignatureCounter, writer->state.writer);
+    }
+    for (i = 0; result == EXECUTION_OK && i < writer->fileCount; i++) {
+        result = tarWriterAddFile(writer->state.writer, writer->files[i].name, writer->files[i].data,
+                                  writer->files[i].dataLength, writer->files[i].modificationTime);
+    }
+    if (result == EXECUTION_OK) {
+        result = tarWriterFinish(writer->state.writer);
+    }
+    writer->archive->recordCount = writer->state.recordCount;
+    writer->archive->result = result;
+    return NULL;
+}
+
+short int exportScanClients(struct LogStore *store,
+                            const struct ExportSelection *selection,
+                            long int maximumNumberRecords,
+                            const struct ExportFile *files,
+                            size_t fileCount,
+                            struct ExportClientArchive *archives,
+                            size_t archiveCount)
+{
+    struct ExportClientsContext clients;
+    uint64_t lowerBound;
+    uint64_t upperBound;
+    bool digests = false;
+    short int result;
+    size_t tableSize = 2;
+    size_t i;
+
+    if (selection->clientId != NULL || archives == NULL || archiveCount == 0 || (files == NULL && fileCount > 0)) {
+        return ERROR_PARAMETER_MISMATCH;
+    }
+    for (i = 0; i < archiveCount; i++) {
+        if (archives[i].clientId == NULL || archives[i].clientIdLength == 0 || archives[i].writer == NULL) {
+            return ERROR_PARAMETER_MISMATCH;
+        }
+        archives[i].recordCount = 0;
+        archives[i].result = ERROR_STORAGE_FAILURE;
+        digests = digests || archives[i].writer->manifest != NULL;
+    }
+    result = exportSelectionEstimate(store, selection, &lowerBound, &upperBound);
+    if (result != EXECUTION_OK) {
+        return result;
+    }
+    if (upperBound == 0) {
+        return ERROR_NO_DATA_AVAILABLE;
+    }
+
+    /* the table is kept at most half full, so that a lookup ends after a few probes */
+    while (tableSize < 2 * archiveCount) {
+        tableSize *= 2;
+    }
+    memset(&clients, 0, sizeof clients);
+    clients.tableMask = tableSize - 1;
+    clients.table = calloc(tableSize, sizeof *clients.table);
+    clients.writers = calloc(archiveCount, sizeof *clients.writers);
+    if (clients.table == NULL || clients.writers == NULL) {
+        free(clients.table);
+        free(clients.writers);
+        return ERROR_STORAGE_FAILURE;
+    }
+    for (i = 0; i < archiveCount; i++) {
+        size_t position = exportClientHash(archives[i].clientId, archives[i].clientIdLength) & clients.tableMask;
+        if (exportClientsFind(&clients, archives[i].clientId, archives[i].clientIdLength) != NULL) {
+            free(clients.table);
+            free(clients.writers);
+            return ERROR_PARAMETER_MISMATCH;
+        }
+        while (clients.table[position] != 0) {
+            position = (position + 1) & clients.tableMask;
+        }
+        clients.writers[i].archive = &archives[i];
+        clients.table[position] = ++clients.writerCount;
+    }
+
+    for (i = 0; i < clients.writerCount; i++) {
+        struct ExportArchiveWriter *writer = &clients.writers[i];
+        writer->state.writer = archives[i].writer;
+        writer->state.maximumNumberRecords = maximumNumberRecords;
+        writer->certificates = &store->certificates;
+        writer->files = files;
+        writer->fileCount = fileCount;
+        atomic_init(&writer->aborted, false);
+        pthread_mutex_init(&writer->queue.lock, NULL);
+        pthread_cond_init(&writer->queue.changed, NULL);
+        writer->started = pthread_create(&writer->thread, NULL, exportArchiveWriterRun, writer) == 0;
+        if (!writer->started) {
+            /* the archive keeps ERROR_STORAGE_FAILURE and is skipped by the merge */
+            atomic_store(&writer->aborted, true);
+        }
+    }
+    result = exportScanSegments(store, selection, digests, NULL, NULL, exportClientsConsume, &clients);
+
+    for (i = 0; i < clients.writerCount; i++) {
+        struct ExportArchiveWriter *writer = &clients.writers[i];
+        size_t slot;
+        if (writer->started) {
+            pthread_mutex_lock(&writer->queue.lock);
+            writer->queue.finished = true;
+            writer->queue.result = result;
+            pthread_cond_broadcast(&writer->queue.changed);
+            pthread_mutex_unlock(&writer->queue.lock);
+            pthread_join(writer->thread, NULL);
+        }
+        for (slot = 0; slot < EXPORT_STREAM_DEPTH; slot++) {
+            free(writer->queue.slots[slot].storage);
+        }
+        pthread_cond_destroy(&writer->queue.changed);
+        pthread_mutex_destroy(&writer->queue.lock);
+    }
+    free(clients.writers);
+    free(clients.table);
+    return result;
+}
@@ -0,0 +1,389 @@
+#ifndef SEAPI_BACKEND_EXPORT_SCAN_H
+#define SEAPI_BACKEND_EXPORT_SCAN_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "../Exception.h"
+#include "../Constant.h"
+#include "LogStore.h"
+#include "TarWriter.h"
+
+/**
+ * This header file defines the selection of stored log messages for the export functions of the SE API.
+ *
+ * The segments whose index entries overlap the selection are scanned in parallel. Every scanned segment delivers
+ * its matching log messages through a bounded queue, and the queues are merged in the order of the signature
+ * counter with a k-way merge directly into the TAR writer. Only a bounded window of segments is scanned ahead of
+ * the merge, so the memory needed by an export does not depend on the length of the selected period.
+ * Before any segment is read, the number of selected log messages is bounded with the count index of the store,
+ * so that an export that exceeds maximumNumberRecords is refused without reading data.
+ * If an interval of signature counters is selected, segments without selected transaction log messages are not
+ * scanned: their system log messages and audit log messages are read at the offsets of the interval index of the
+ * store. The archives returned in memory and the archives of a multi-client export contain the certificates of the
+ * exported log messages from the certificate store, each certificate once.
+ *
+ * A multi-client export writes one archive per clientId from a single scan: the merged log messages are
+ * partitioned by their clientId and passed through bounded queues to one writer thread per archive, so that the
+ * archives are written concurrently and the store is read only once.
+ *
+ * An archive may end with an integrity manifest (see TarManifest.h). The digests of the exported log messages are
+ * then calculated by the threads that scan the segments, in parallel and ahead of the merge, and the digests of the
+ * certificates and of the other files by the writer.
+ */
+
+/**
+ * Number of log messages that a segment scan may buffer ahead of the merge
+ */
+#define EXPORT_STREAM_DEPTH 128
+
+/**
+ * Number of bytes that a segment scan reads between two invocations of the throttle
+ */
+#define EXPORT_THROTTLE_BYTES (64u * 1024u)
+
+/**
+ * Callback that is invoked by the threads that scan the segments of an export after every EXPORT_THROTTLE_BYTES
+ * read bytes and at the end of every segment, e.g. to limit the rate of the I/O or to report the progress. The
+ * callback is invoked concurrently by the scanning threads and without holding a lock of the store.
+ * @param[in] throttleContext
+ *                context that has been passed to the export [OPTIONAL]
+ * @param[in] bytesRead
+ *                number of bytes read by the calling thread since its last invocation [REQUIRED]
+ * @param[in] bytesPlanned
+ *                estimated number of bytes read by the whole export [REQUIRED]
+ * @return true to continue, false to abort the export, which then fails with ERROR_STORAGE_FAILURE
+ */
+typedef bool (*ExportThrottle)(void *throttleContext,
+                               uint64_t bytesRead,
+                               uint64_t bytesPlanned);
+
+/**
+ * Describes the log messages selected for an export.
+ * System log messages and audit log messages are selected by the period of time and, if an interval of
+ * transactions is selected, by the interval of signature counters. Transaction log messages are selected by the
+ * period of time and the interval of transactions and additionally have to correspond to the clientId if one is
+ * passed.
+ */
+struct ExportSelection {
+    bool hasStartTime;
+    int64_t startTime;
+    bool hasEndTime;
+    int64_t endTime;
+    bool hasTransactionInterval;
+    uint64_t startTransactionNumber;
+    uint64_t endTransactionNumber;
+    bool hasSignatureInterval;
+    uint64_t firstSignatureCounter;
+    uint64_t lastSignatureCounter;
+    const unsigned char *clientId;
+    unsigned long int clientIdLength;
+};
+
+/**
+ * Builds the selection for exportDataFilteredByPeriodOfTime and exportDataFilteredByPeriodOfTimeAndClientId.
+ * The dates are interpreted as UTC.
+ * @param[out] selection
+ *                selection to be initialized [REQUIRED]
+ * @param[in] startDate
+ *                starting time (inclusive) of the period [OPTIONAL]
+ * @param[in] endDate
+ *                end time (inclusive) of the period [OPTIONAL]
+ * @param[in] clientId
+ *                ID of the client whose transaction log messages are selected [OPTIONAL]
+ * @param[in] clientIdLength
+ *                length of the array that represents the clientId [REQUIRED]
+ * @return if the execution of the function has been successful, the return value EXECUTION_OK SHALL be returned.
+ *
+ *         If the execution of the function has failed, the appropriate error code SHALL be returned:
+ *
+ *             ERROR_PARAMETER_MISMATCH
+ *                neither startDate nor endDate has been passed, or startDate lies after endDate
+ */
+short int exportSelectionFromPeriod(struct ExportSelection *selection,
+                                    struct tm *startDate,
+                                    struct tm *endDate,
+                                    const unsigned char *clientId,
+                                    unsigned long int clientIdLength);
+
+/**
+ * Builds the selection of an interval of transactions. The interval of signature counters for the system log
+ * messages and audit log messages is determined from the first and the last selected transaction log message,
+ * which are searched from the ends of the candidate segments.
+ * @param[out] selection
+ *                selection to be initialized [REQUIRED]
+ * @param[in] store
+ *                opened store [REQUIRED]
+ * @param[in] startTransactionNumber
+ *                transaction number (inclusive) regarding the start of the interval [REQUIRED]
+ * @param[in] endTransactionNumber
+ *                transaction number (inclusive) regarding the end of the interval [REQUIRED]
+ * @param[in] clientId
+ *                ID of the client whose transaction log messages are selected [OPTIONAL]
+ * @param[in] clientIdLength
+ *                length of the array that represents the clientId [REQUIRED]
+ * @return if the execution of the function has been successful, the return value EXECUTION_OK SHALL be returned.
+ *
+ *         If the execution of the function has failed, the appropriate error code SHALL be returned:
+ *
+ *             ERROR_PARAMETER_MISMATCH
+ *                startTransactionNumber lies after endTransactionNumber
+ *             ERROR_TRANSACTION_NUMBER_NOT_FOUND
+ *                no data has been found for the provided interval of transactions
+ *             ERROR_ID_NOT_FOUND
+ *                no transaction log message of the interval corresponds to the clientId
+ *             ERROR_STORAGE_FAILURE
+ *                the segments could not be read
+ */
+short int exportSelectionFromTransactionInterval(struct ExportSelection *selection,
+                                               struct LogStore *store,
+                                               uint64_t startTransactionNumber,
+                                               uint64_t endTransactionNumber,
+                                               const unsigned char *clientId,
+                                               unsigned long int clientIdLength);
+
+/**
+ * Builds the name of the file that holds a log message within an export archive.
+ * @param[in] record
+ *                the log message [REQUIRED]
+ * @param[out] name
+ *                buffer for the file name [REQUIRED]
+ * @param[in] nameSize
+ *                size of the buffer [REQUIRED]
+ */
+void exportLogMessageFileName(const struct LogRecord *record,
+                              char *name,
+                              size_t nameSize);
+
+/**
+ * Selects the log messages and appends them to the archive in the order of the signature counter.
+ * The archive is not finished, so that the caller can add the files needed to verify the signatures.
+ * If an error is returned, the bytes already passed to the sink of the writer MUST be discarded.
+ * The bounds of the count index are checked before any segment is read: if more log messages than
+ * maximumNumberRecords are selected for certain, or if no segment may contain a selected log message,
+ * the function returns without scanning.
+ * @param[in] store
+ *                opened store [REQUIRED]
+ * @param[in] selection
+ *                selected log messages [REQUIRED]
+ * @param[in] maximumNumberRecords
+ *                maximum number of selected log messages, 0 for no limit [REQUIRED]
+ * @param[in] writer
+ *                writer of the archive [REQUIRED]
+ * @return if the execution of the function has been successful, the return value EXECUTION_OK SHALL be returned.
+ *
+ *         If the execution of the function has failed, the appropriate error code SHALL be returned:
+ *
+ *             ERROR_NO_DATA_AVAILABLE
+ *                no data has been found for the provided selection
+ *             ERROR_ID_NOT_FOUND
+ *                no transaction log message has been found for the provided clientId
+ *             ERROR_TOO_MANY_RECORDS
+ *                the amount of selected log messages exceeds maximumNumberRecords
+ *             ERROR_STORAGE_FAILURE
+ *                the segments could not be read
+ */
+short int exportScanRun(struct LogStore *store,
+                        const struct ExportSelection *selection,
+                        long int maximumNumberRecords,
+                        struct TarWriter *writer);
+
+/**
+ * Backend implementation of exportDataFilteredByPeriodOfTime and exportDataFilteredByPeriodOfTimeAndClientId
+ * that returns the archive in memory.
+ * @param[in] store
+ *                opened store [REQUIRED]
+ * @param[in] startDate
+ *                starting time (inclusive) of the period [OPTIONAL]
+ * @param[in] endDate
+ *                end time (inclusive) of the period [OPTIONAL]
+ * @param[in] clientId
+ *                ID of the client whose transaction log messages are selected [OPTIONAL]
+ * @param[in] clientIdLength
+ *                length of the array that represents the clientId [REQUIRED]
+ * @param[in] maximumNumberRecords
+ *                maximum number of selected log messages, 0 for no limit [REQUIRED]
+ * @param[in] manifest
+ *                true to append the integrity manifest to the archive [REQUIRED]
+ * @param[in] throttle
+ *                callback that paces the scan of the segments [OPTIONAL]
+ * @param[in] throttleContext
+ *                context passed to the throttle [OPTIONAL]
+ * @param[out] exportedData
+ *                allocated archive, to be released with free [REQUIRED]
+ * @param[out] exportedDataLength
+ *                length of the array that represents the exportedData [REQUIRED]
+ * @return the return values of exportSelectionFromPeriod and exportScanRun
+ */
+short int exportScanPeriodOfTime(struct LogStore *store,
+                                 struct tm *startDate,
+                                 struct tm *endDate,
+                                 const unsigned char *clientId,
+                                 unsigned long int clientIdLength,
+                                 long int maximumNumberRecords,
+                                 bool manifest,
+                                 ExportThrottle throttle,
+                                 void *throttleContext,
+                                 unsigned char **exportedData,
+                                 unsigned long int *exportedDataLength);
+
+/**
+ * Backend implementation of exportData that returns the archive in memory.
+ * An empty store results in an archive without log messages.
+ * After a successful export the exported log messages are marked with logStoreMarkExported,
+ * so that deleteStoredData may delete them.
+ * @param[in] store
+ *                opened store [REQUIRED]
+ * @param[in] maximumNumberRecords
+ *                maximum number of exported log messages, 0 for no limit [REQUIRED]
+ * @param[in] manifest
+ *                true to append the integrity manifest to the archive [REQUIRED]
+ * @param[in] throttle
+ *                callback that paces the scan of the segments [OPTIONAL]
+ * @param[in] throttleContext
+ *                context passed to the throttle [OPTIONAL]
+ * @param[out] exportedData
+ *                allocated archive, to be released with free [REQUIRED]
+ * @param[out] exportedDataLength
+ *                length of the array that represents the exportedData [REQUIRED]
+ * @return the return values of exportScanRun
+ */
+short int exportScanAll(struct LogStore *store,
+                        long int maximumNumberRecords,
+                        bool manifest,
+                        ExportThrottle throttle,
+                        void *throttleContext,
+                        unsigned char **exportedData,
+                        unsigned long int *exportedDataLength);
+
+/**
+ * Backend implementation of exportDataFilteredByTransactionNumberInterval and
+ * exportDataFilteredByTransactionNumberIntervalAndClientId that returns the archive in memory.
+ * The interval of signature counters for the system log messages and audit log messages is determined from the
+ * first and the last selected transaction log message, which are searched from the ends of the candidate segments.
+ * @param[in] store
+ *                opened store [REQUIRED]
+ * @param[in] startTransactionNumber
+ *                transaction number (inclusive) regarding the start of the interval [REQUIRED]
+ * @param[in] endTransactionNumber
+ *                transaction number (inclusive) regarding the end of the interval [REQUIRED]
+ * @param[in] clientId
+ *                ID of the client whose transaction log messages are selected [OPTIONAL]
+ * @param[in] clientIdLength
+ *                length of the array that represents the clientId [REQUIRED]
+ * @param[in] maximumNumberRecords
+ *                maximum number of exported log messages, 0 for no limit [REQUIRED]
+ * @param[in] manifest
+ *                true to append the integrity manifest to the archive [REQUIRED]
+ * @param[in] throttle
+ *                callback that paces the scan of the segments [OPTIONAL]
+ * @param[in] throttleContext
+ *                context passed to the throttle [OPTIONAL]
+ * @param[out] exportedData
+ *                allocated archive, to be released with free [REQUIRED]
+ * @param[out] exportedDataLength
+ *                length of the array that represents the exportedData [REQUIRED]
+ * @return if the execution of the function has been successful, the return value EXECUTION_OK SHALL be returned.
+ *
+ *         If the execution of the function has failed, the appropriate error code SHALL be returned:
+ *
+ *             ERROR_PARAMETER_MISMATCH
+ *                startTransactionNumber lies after endTransactionNumber
+ *             ERROR_TRANSACTION_NUMBER_NOT_FOUND
+ *                no data has been found for the provided interval of transactions
+ *             ERROR_ID_NOT_FOUND
+ *                no transaction log message of the interval corresponds to the clientId
+ *             ERROR_TOO_MANY_RECORDS
+ *                the amount of selected log messages exceeds maximumNumberRecords
+ *             ERROR_STORAGE_FAILURE
+ *                the segments could not be read
+ */
+short int exportScanTransactionInterval(struct LogStore *store,
+                                        uint64_t startTransactionNumber,
+                                        uint64_t endTransactionNumber,
+                                        const unsigned char *clientId,
+                                        unsigned long int clientIdLength,
+                                        long int maximumNumberRecords,
+                                        bool manifest,
+                                        ExportThrottle throttle,
+                                        void *throttleContext,
+                                        unsigned char **exportedData,
+                                        unsigned long int *exportedDataLength);
+
+/**
+ * File that is appended to every archive of a multi-client export after its log messages and certificates.
+ */
+struct ExportFile {
+    const char *name;
+    const unsigned char *data;
+    uint64_t dataLength;
+    int64_t modificationTime;
+};
+
+/**
+ * Archive of one client in a multi-client export. The caller sets clientId, clientIdLength and writer, the
+ * export sets recordCount and result.
+ */
+struct ExportClientArchive {
+    const unsigned char *clientId;
+    unsigned long int clientIdLength;
+    struct TarWriter *writer;
+    uint64_t recordCount;
+    short int result;
+};
+
+/**
+ * Exports the selected log messages into one archive per clientId with a single scan of the store.
+ * Every archive receives the transaction log messages of its clientId and all selected system log messages and
+ * audit log messages, followed by their certificates and the passed files, and is finished. Each archive is
+ * written by its own thread, so the sinks of the writers are called concurrently and MUST NOT share state without
+ * synchronization.
+ * An archive that fails does not abort the others; its result is reported in the member result and the bytes
+ * already passed to its sink MUST be discarded.
+ * With a selection of an interval of transactions (exportSelectionFromTransactionInterval without clientId), the
+ * system log messages and audit log messages of the whole interval are added to every archive.
+ * @param[in] store
+ *                opened store [REQUIRED]
+ * @param[in] selection
+ *                selected log messages, without clientId [REQUIRED]
+ * @param[in] maximumNumberRecords
+ *                maximum number of log messages in each archive, 0 for no limit [REQUIRED]
+ * @param[in] files
+ *                files appended to every archive [OPTIONAL]
+ * @param[in] fileCount
+ *                number of files [REQUIRED]
+ * @param[in,out] archives
+ *                archives with distinct clientIds and initialized writers, to which manifests MAY be attached
+ *                [REQUIRED]
+ * @param[in] archiveCount
+ *                number of archives [REQUIRED]
+ * @return if the scan of the store has been successful, the return value EXECUTION_OK SHALL be returned and the
+ *         result of each archive is either EXECUTION_OK or one of:
+ *
+ *             ERROR_ID_NOT_FOUND
+ *                no transaction log message has been found for the clientId of the archive
+ *             ERROR_TOO_MANY_RECORDS
+ *                the amount of log messages of the archive exceeds maximumNumberRecords
+ *             ERROR_STORAGE_FAILURE
+ *                the archive could not be written
+ *
+ *         If the execution of the function has failed, the appropriate error code SHALL be returned:
+ *
+ *             ERROR_PARAMETER_MISMATCH
+ *                the selection contains a clientId, or a clientId is missing or passed twice
+ *             ERROR_NO_DATA_AVAILABLE
+ *                no data has been found for the provided selection
+ *             ERROR_STORAGE_FAILURE
+ *                the segments could not be read
+ */
+short int exportScanClients(struct LogStore *store,
+                            const struct ExportSelection *selection,
+                            long int maximumNumberRecords,
+                            const struct ExportFile *files,
+                            size_t fileCount,
+                            struct ExportClientArchive *archives,
+                            size_t archiveCount);
+
+#endif
@@ -0,0 +1,413 @@
+#include <errno.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+
+#include "ExportScheduler.h"
+
+/**
+ * I/O priority class "idle" of ioprio_set, which is not exported by the C library
+ */
+#define EXPORT_SCHEDULER_IOPRIO_WHO_PROCESS 1
+#define EXPORT_SCHEDULER_IOPRIO_CLASS_IDLE 3
+#define EXPORT_SCHEDULER_IOPRIO_CLASS_SHIFT 13
+
+/**
+ * CPU time of the calling scanning thread at its last invocation of the throttle. The scanning threads are created
+ * for every export, so the value starts at 0 with the thread.
+ */
+static _Thread_local int64_t exportSchedulerThreadCpuTime;
+
+static int64_t exportSchedulerClock(clockid_t clock)
+{
+    struct timespec now;
+
+    clock_gettime(clock, &now);
+    return (int64_t) now.tv_sec * 1000000000ll + now.tv_nsec;
+}
+
+/**
+ * Lowers the priority of the calling thread; the threads that it creates inherit the priority.
+ */
+static void exportSchedulerLowerPriority(void)
+{
+#ifdef SCHED_IDLE
+    struct sched_param parameter;
+
+    memset(&parameter, 0, sizeof parameter);
+    pthread_setschedparam(pthread_self(), SCHED_IDLE, &parameter);
+#endif
+#ifdef SYS_ioprio_set
+    /* the priorities are a hint, the exports also work if they cannot be changed */
+    syscall(SYS_ioprio_set, EXPORT_SCHEDULER_IOPRIO_WHO_PROCESS, 0,
+            EXPORT_SCHEDULER_IOPRIO_CLASS_IDLE << EXPORT_SCHEDULER_IOPRIO_CLASS_SHIFT);
+#endif
+}
+
+static int exportSchedulerCompareLatencies(const void *left,
+                                           const void *right)
+{
+    uint64_t leftLatency = *(const uint64_t *) left;
+    uint64_t rightLatency = *(const uint64_t *) right;
+
+    return leftLatency < rightLatency ? -1 : leftLatency > rightLatency;
+}
+
+/**
+ * Evaluates the latencies reported since the last control interval and adapts the I/O budget. The caller holds the
+ * lock.
+ */
+static void exportSchedulerControl(struct ExportScheduler *scheduler,
+                                   int64_t now)
+{
+    uint64_t latencies[EXPORT_SCHEDULER_LATENCY_WINDOW];
+    uint64_t count;
+    uint64_t sampleCount;
+    uint64_t i;
+
+    if (now - scheduler->controlTime < EXPORT_SCHEDULER_CONTROL_INTERVAL) {
+        return;
+    }
+    scheduler->controlTime = now;
+    count = atomic_load_explicit(&scheduler->latencyCount, memory_order_acquire);
+    sampleCount = count - scheduler->evaluatedLatencyCount;
+    if (sampleCount > EXPORT_SCHEDULER_LATENCY_WINDOW) {
+        sampleCount = EXPORT_SCHEDULER_LATENCY_WINDOW;
+    }
+    scheduler->evaluatedLatencyCount = count;
+
+    /* a slot is only evaluated if its sequence shows that the latency of the expected report has been stored in it
+       and has not been replaced while it has been read */
+    for (i = count - sampleCount, sampleCount = 0; i < count; i++) {
+        size_t slot = (size_t) (i % EXPORT_SCHEDULER_LATENCY_WINDOW);
+        uint64_t latency;
+
+        if (atomic_load_explicit(&scheduler->latencySequences[slot], memory_order_acquire) != i + 1) {
+            continue;
+        }
+        latency = atomic_load_explicit(&scheduler->latencies[slot], memory_order_relaxed);
+        atomic_thread_fence(memory_order_acquire);
+        if (atomic_load_explicit(&scheduler->latencySequences[slot], memory_order_relaxed) == i + 1) {
+            latencies[sampleCount++] = latency;
+        }
+    }
+
+    if (sampleCount > 0) {
+        qsort(latencies, (size_t) sampleCount, sizeof latencies[0], exportSchedulerCompareLatencies);
+        /* nearest rank */
+        scheduler->latencyPercentile = latencies[(sampleCount * 99 + 99) / 100 - 1];
+    } else {
+        scheduler->latencyPercentile = 0;
+    }
+
+    if (scheduler->latencyPercentile > scheduler->budget.latencyBound) {
+        /* multiplicative decrease and preemption for one control interval */
+        scheduler->violationCount++;
+        scheduler->bytesPerSecond /= 2;
+        if (scheduler->bytesPerSecond < EXPORT_SCHEDULER_MIN_BYTES_PER_SECOND) {
+            scheduler->bytesPerSecond = EXPORT_SCHEDULER_MIN_BYTES_PER_SECOND;
+        }
+        if (scheduler->releaseTime < now + EXPORT_SCHEDULER_CONTROL_INTERVAL) {
+            scheduler->releaseTime = now + EXPORT_SCHEDULER_CONTROL_INTERVAL;
+        }
+        if (scheduler->running != NULL) {
+            scheduler->running->state = exportJobPaused;
+        }
+    } else {
+        /* additive increase */
+        scheduler->bytesPerSecond += scheduler->budget.bytesPerSecond / 8;
+        if (scheduler->bytesPerSecond > scheduler->budget.bytesPerSecond) {
+            scheduler->bytesPerSecond = scheduler->budget.bytesPerSecond;
+        }
+    }
+}
+
+/**
+ * Implementation of ExportThrottle. The read bytes and the CPU time of the calling thread are charged to the
+ * budgets by moving the release time; the thread waits until the release time has passed. Cancelling the job or
+ * stopping the scheduler ends the wait and aborts the export.
+ */
+static bool exportSchedulerThrottle(void *throttleContext,
+                                    uint64_t bytesRead,
+                                    uint64_t bytesPlanned)
+{
+    struct ExportScheduler *scheduler = (struct ExportScheduler *) throttleContext;
+    int64_t cpuTime = exportSchedulerClock(CLOCK_THREAD_CPUTIME_ID);
+    int64_t cpuUsed = cpuTime - exportSchedulerThreadCpuTime;
+    int64_t now = exportSchedulerClock(CLOCK_MONOTONIC);
+    uint64_t ioCost;
+    uint64_t cpuCost;
+    struct ExportJob *job;
+    struct timespec deadline;
+    bool proceed;
+
+    exportSchedulerThreadCpuTime = cpuTime;
+    pthread_mutex_lock(&scheduler->lock);
+    job = scheduler->running;
+    job->bytesRead += bytesRead;
+    job->bytesPlanned = bytesPlanned > job->bytesRead ? bytesPlanned : job->bytesRead;
+    exportSchedulerControl(scheduler, now);
+
+    ioCost = bytesRead / scheduler->bytesPerSecond * 1000000000ull
+             + bytesRead % scheduler->bytesPerSecond * 1000000000ull / scheduler->bytesPerSecond;
+    cpuCost = (uint64_t) cpuUsed * 1000u / scheduler->budget.cpuPermille;
+    if (scheduler->releaseTime < now) {
+        scheduler->releaseTime = now;
+    }
+    scheduler->releaseTime += (int64_t) (ioCost > cpuCost ? ioCost : cpuCost);
+    if (scheduler->releaseTime > now) {
+        job->pausedNanoseconds += (uint64_t) (scheduler->releaseTime - now);
+    }
+
+    deadline.tv_sec = (time_t) (scheduler->releaseTime / 1000000000ll);
+    deadline.tv_nsec = (long) (scheduler->releaseTime % 1000000000ll);
+    while (!scheduler->stopping && !job->cancelRequested
+           && pthread_cond_timedwait(&scheduler->changed, &scheduler->lock, &deadline) != ETIMEDOUT) {
+    }
+    if (job->state == exportJobPaused) {
+        job->state = exportJobRunning;
+    }
+    proceed = !scheduler->stopping && !job->cancelRequested;
+    pthread_mutex_unlock(&scheduler->lock);
+    return proceed;
+}
+
+static void exportSchedulerFinish(struct ExportJob *job,
+                                  short int result)
+{
+    if (result != EXECUTION_OK && job->cancelRequested) {
+        job->state = exportJobCancelled;
+        job->result = ERROR_STORAGE_FAILURE;
+    } else {
+        job->state = exportJobFinished;
+        job->result = result;
+    }
+}
+
+static void *exportSchedulerRun(void *argument)
+{
+    struct ExportScheduler *scheduler = (struct ExportScheduler *) argument;
+
+    exportSchedulerLowerPriority();
+    pthread_mutex_lock(&scheduler->lock);
+    for (;;) {
+        struct ExportJob *job;
+        short int result;
+
+        while (scheduler->head == NULL && !scheduler->stopping) {
+            pthread_cond_wait(&scheduler->changed, &scheduler->lock);
+        }
+        if (scheduler->stopping) {
+            break;
+        }
+        job = scheduler->head;
+        scheduler->head = job->next;
+        if (scheduler->head == NULL) {
+            scheduler->tail = NULL;
+        }
+        job->next = NULL;
+        job->state = exportJobRunning;
+        scheduler->running = job;
+        scheduler->bytesPerSecond = scheduler->budget.bytesPerSecond;
+        scheduler->releaseTime = exportSchedulerClock(CLOCK_MONOTONIC);
+        scheduler->controlTime = scheduler->releaseTime;
+        /* only the latencies reported while the export runs are evaluated */
+        scheduler->evaluatedLatencyCount = atomic_load(&scheduler->latencyCount);
+        atomic_store(&scheduler->active, true);
+        pthread_mutex_unlock(&scheduler->lock);
+
+        result = scheduler->runner(scheduler->runnerContext, job, exportSchedulerThrottle, scheduler);
+
+        pthread_mutex_lock(&scheduler->lock);
+        atomic_store(&scheduler->active, false);
+        scheduler->running = NULL;
+        exportSchedulerFinish(job, result);
+        pthread_cond_broadcast(&scheduler->changed);
+    }
+    pthread_mutex_unlock(&scheduler->lock);
+    return NULL;
+}
+
+short int exportSchedulerStart(struct ExportScheduler *scheduler,
+                               ExportJobRunner runner,
+                               void *runnerContext,
+                               const struct ExportBudget *budget)
+{
+    pthread_condattr_t attributes;
+    size_t i;
+
+    if (scheduler == NULL || runner == NULL) {
+        return ERROR_PARAMETER_MISMATCH;
+    }
+    memset(scheduler, 0, sizeof *scheduler);
+    scheduler->runner = runner;
+    scheduler->runnerContext = runnerContext;
+    if (budget != NULL) {
+        scheduler->budget = *budget;
+    }
+    if (scheduler->budget.bytesPerSecond == 0) {
+        scheduler->budget.bytesPerSecond = EXPORT_SCHEDULER_DEFAULT_BYTES_PER_SECOND;
+    }
+    if (scheduler->budget.cpuPermille == 0) {
+        scheduler->budget.cpuPermille = EXPORT_SCHEDULER_DEFAULT_CPU_PERMILLE;
+    }
+    if (scheduler->budget.latencyBound == 0) {
+        scheduler->budget.latencyBound = EXPORT_SCHEDULER_DEFAULT_LATENCY_BOUND;
+    }
+    scheduler->bytesPerSecond = scheduler->budget.bytesPerSecond;
+    for (i = 0; i < EXPORT_SCHEDULER_LATENCY_WINDOW; i++) {
+        atomic_init(&scheduler->latencies[i], 0);
+        atomic_init(&scheduler->latencySequences[i], 0);
+    }
+    atomic_init(&scheduler->latencyCount, 0);
+    atomic_init(&scheduler->active, false);
+    pthread_mutex_init(&scheduler->lock, NULL);
+    /* the release times are not affected by changes of the system time */
+    pthread_condattr_init(&attributes);
+    pthread_condattr_setclock(&attributes, CLOCK_MONOTONIC);
+    pthread_cond_init(&scheduler->changed, &attributes);
+    pthread_condattr_destroy(&attributes);
+    if (pthread_create(&scheduler->thread, NULL, exportSchedulerRun, scheduler) != 0) {
+        pthread_cond_destroy(&scheduler->changed);
+        pthread_mutex_destroy(&scheduler->lock);
+        return ERROR_STORAGE_FAILURE;
+    }
+    return EXECUTION_OK;
+}
+
+short int exportSchedulerSubmit(struct ExportScheduler *scheduler,
+                                struct ExportJob *job)
+{
+    short int result = EXECUTION_OK;
+
+    pthread_mutex_lock(&scheduler->lock);
+    if (scheduler->stopping) {
+        result = ERROR_PARAMETER_MISMATCH;
+    } else {
+        job->next = NULL;
+        job->state = exportJobQueued;
+        job->cancelRequested = false;
+        job->bytesRead = 0;
+        job->bytesPlanned = 0;
+        job->pausedNanoseconds = 0;
+        job->result = EXECUTION_OK;
+        job->exportedData = NULL;
+        job->exportedDataLength = 0;
+        if (scheduler->tail != NULL) {
+            scheduler->tail->next = job;
+        } else {
+            scheduler->head = job;
+        }
+        scheduler->tail = job;
+        pthread_cond_broadcast(&scheduler->changed);
+    }
+    pthread_mutex_unlock(&scheduler->lock);
+    return result;
+}
+
+void exportSchedulerReportLatency(struct ExportScheduler *scheduler,
+                                  uint64_t nanoseconds)
+{
+    uint64_t index = atomic_fetch_add_explicit(&scheduler->latencyCount, 1, memory_order_relaxed);
+    size_t slot = (size_t) (index % EXPORT_SCHEDULER_LATENCY_WINDOW);
+
+    /* the slot is reserved by the count and published by its sequence once the latency has been stored */
+    atomic_store_explicit(&scheduler->latencySequences[slot], 0, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    atomic_store_explicit(&scheduler->latencies[slot], nanoseconds, memory_order_relaxed);
+    atomic_store_explicit(&scheduler->latencySequences[slot], index + 1, memory_order_release);
+}
+
+bool exportSchedulerActive(struct ExportScheduler *scheduler)
+{
+    return atomic_load_explicit(&scheduler->active, memory_order_relaxed);
+}
+
+void exportSchedulerStatus(struct ExportScheduler *scheduler,
+                           const struct ExportJob *job,
+                           struct ExportJobStatus *status)
+{
+    pthread_mutex_lock(&scheduler->lock);
+    status->state = job->state;
+    status->bytesRead = job->bytesRead;
+    status->bytesPlanned = job->bytesPlanned;
+    status->pausedNanoseconds = job->pausedNanoseconds;
+    status->result = job->result;
+    pthread_mutex_unlock(&scheduler->lock);
+}
+
+/**
+ * Removes a queued job from the queue and marks it as cancelled. The caller holds the lock.
+ */
+static void exportSchedulerDequeue(struct ExportScheduler *scheduler,
+                                   struct ExportJob *job)
+{
+    struct ExportJob *previous = NULL;
+    struct ExportJob *current = scheduler->head;
+
+    while (current != NULL && current != job) {
+        previous = current;
+        current = current->next;
+    }
+    if (current == NULL) {
+        return;
+    }
+    if (previous != NULL) {
+        previous->next = job->next;
+    } else {
+        scheduler->head = job->next;
+    }
+    if (scheduler->tail == job) {
+        scheduler->tail = previous;
+    }
+    job->next = NULL;
+    job->cancelRequested = true;
+    exportSchedulerFinish(job, ERROR_STORAGE_FAILURE);
+}
+
+void exportSchedulerCancel(struct ExportScheduler *scheduler,
+                           struct ExportJob *job)
+{
+    pthread_mutex_lock(&scheduler->lock);
+    if (job->state == exportJobQueued) {
+        exportSchedulerDequeue(scheduler, job);
+    } else if (job->state == exportJobRunning || job->state == exportJobPaused) {
+        job->cancelRequested = true;
+    }
+    pthread_cond_broadcast(&scheduler->changed);
+    pthread_mutex_unlock(&scheduler->lock);
+}
+
+short int exportSchedulerWait(struct ExportScheduler *scheduler,
+                              struct ExportJob *job)
+{
+    short int result;
+
+    pthread_mutex_lock(&scheduler->lock);
+    while (job->state != exportJobFinished && job->state != exportJobCancelled) {
+        pthread_cond_wait(&scheduler->changed, &scheduler->lock);
+    }
+    result = job->result;
+    pthread_mutex_unlock(&scheduler->lock);
+    return result;
+}
+
+void exportSchedulerStop(struct ExportScheduler *scheduler)
+{
+    pthread_mutex_lock(&scheduler->lock);
+    scheduler->stopping = true;
+    while (scheduler->head != NULL) {
+        exportSchedulerDequeue(scheduler, scheduler->head);
+    }
+    if (scheduler->running != NULL) {
+        scheduler->running->cancelRequested = true;
+    }
+    pthread_cond_broadcast(&scheduler->changed);
+    pthread_mutex_unlock(&scheduler->lock);
+    pthread_join(scheduler->thread, NULL);
+    pthread_cond_destroy(&scheduler->changed);
+    pthread_mutex_destroy(&scheduler->lock);
+}
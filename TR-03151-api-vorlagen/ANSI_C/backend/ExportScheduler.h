@@ -0,0 +1,237 @@
+#ifndef SEAPI_BACKEND_EXPORT_SCHEDULER_H
+#define SEAPI_BACKEND_EXPORT_SCHEDULER_H
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "../Exception.h"
+#include "../Constant.h"
+#include "ExportScan.h"
+
+#if !PROFILE_CONCURRENT
+#error "the export scheduler requires the server build profile"
+#endif
+
+/**
+ * This header file defines the scheduler that runs exports in the background while transactions are logged, e.g.
+ * an exportData for an audit during opening hours.
+ *
+ * Exports are queued as jobs and run one after another by a thread with the lowest scheduling and I/O priority;
+ * the threads that scan the segments of an export inherit its priority. The scans are paced by the throttle of the
+ * export (see ExportScan.h): every read block is charged to an I/O budget in bytes per second and the CPU time of
+ * the scanning thread to a CPU budget in thousandths of a core, and the scan waits until both budgets allow it to
+ * continue.
+ *
+ * The functions that log transactions report their latency to the scheduler. While an export runs, the scheduler
+ * determines the 99th percentile of the latencies reported in every control interval. If it exceeds the latency
+ * bound, the export is preempted for a control interval and its I/O budget is halved; otherwise the I/O budget is
+ * raised again step by step up to the configured value. The bound therefore holds as far as the latency is caused
+ * by the export, with a reaction time of one control interval.
+ *
+ * The progress of a job is reported as the number of bytes read and the estimated number of bytes to be read.
+ * A queued or running job can be cancelled.
+ */
+
+/**
+ * Defaults of the budgets
+ */
+#define EXPORT_SCHEDULER_DEFAULT_BYTES_PER_SECOND (32ul * 1024ul * 1024ul)
+#define EXPORT_SCHEDULER_DEFAULT_CPU_PERMILLE 250u
+#define EXPORT_SCHEDULER_DEFAULT_LATENCY_BOUND 20000000ull
+
+/**
+ * Lower limit of the I/O budget to which it is reduced by latency violations
+ */
+#define EXPORT_SCHEDULER_MIN_BYTES_PER_SECOND (256ul * 1024ul)
+
+/**
+ * Length of a control interval in nanoseconds
+ */
+#define EXPORT_SCHEDULER_CONTROL_INTERVAL 100000000ll
+
+/**
+ * Number of latencies kept for a control interval; further latencies overwrite the oldest ones
+ */
+#define EXPORT_SCHEDULER_LATENCY_WINDOW 1024
+
+/**
+ * Budgets of the exports. A zero value of a member selects its default.
+ */
+struct ExportBudget {
+    uint64_t bytesPerSecond;
+    unsigned int cpuPermille;
+    uint64_t latencyBound;
+};
+
+/**
+ * Represents the state of a job.
+ */
+enum ExportJobState {
+exportJobQueued, exportJobRunning, exportJobPaused, exportJobFinished, exportJobCancelled
+};
+
+/**
+ * Job of the scheduler. The caller sets data before submitting the job; the other members are managed by the
+ * scheduler and MUST only be read through exportSchedulerStatus and after exportSchedulerWait has returned.
+ */
+struct ExportJob {
+    struct ExportJob *next;
+    void *data;
+    enum ExportJobState state;
+    bool cancelRequested;
+    uint64_t bytesRead;
+    uint64_t bytesPlanned;
+    uint64_t pausedNanoseconds;
+    short int result;
+    unsigned char *exportedData;
+    unsigned long int exportedDataLength;
+};
+
+/**
+ * Callback that runs the export of a job on the thread of the scheduler.
+ * @param[in] runnerContext
+ *                context that has been passed to exportSchedulerStart [OPTIONAL]
+ * @param[in] job
+ *                the job; the callback sets exportedData and exportedDataLength [REQUIRED]
+ * @param[in] throttle
+ *                throttle that MUST be passed to the export [REQUIRED]
+ * @param[in] throttleContext
+ *                context of the throttle [REQUIRED]
+ * @return the result of the export
+ */
+typedef short int (*ExportJobRunner)(void *runnerContext,
+                                     struct ExportJob *job,
+                                     ExportThrottle throttle,
+                                     void *throttleContext);
+
+/**
+ * Progress of a job
+ */
+struct ExportJobStatus {
+    enum ExportJobState state;
+    uint64_t bytesRead;
+    uint64_t bytesPlanned;
+    uint64_t pausedNanoseconds;
+    short int result;
+};
+
+/**
+ * State of a scheduler. The members after lock are managed by the functions of this header file and MUST only be
+ * accessed while holding it; the latencies are reported without the lock.
+ */
+struct ExportScheduler {
+    ExportJobRunner runner;
+    void *runnerContext;
+    struct ExportBudget budget;
+    _Atomic uint64_t latencies[EXPORT_SCHEDULER_LATENCY_WINDOW];
+    _Atomic uint64_t latencySequences[EXPORT_SCHEDULER_LATENCY_WINDOW];
+    _Atomic uint64_t latencyCount;
+    atomic_bool active;
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t changed;
+    struct ExportJob *head;
+    struct ExportJob *tail;
+    struct ExportJob *running;
+    uint64_t bytesPerSecond;
+    int64_t releaseTime;
+    int64_t controlTime;
+    uint64_t evaluatedLatencyCount;
+    uint64_t latencyPercentile;
+    uint64_t violationCount;
+    bool stopping;
+};
+
+/**
+ * Starts the thread of a scheduler.
+ * @param[out] scheduler
+ *                scheduler to be started [REQUIRED]
+ * @param[in] runner
+ *                callback that runs the exports [REQUIRED]
+ * @param[in] runnerContext
+ *                context passed to the runner [OPTIONAL]
+ * @param[in] budget
+ *                budgets of the exports, NULL selects the defaults [OPTIONAL]
+ * @return EXECUTION_OK, ERROR_PARAMETER_MISMATCH if a required parameter is missing or ERROR_STORAGE_FAILURE if the
+ *         thread could not be created
+ */
+short int exportSchedulerStart(struct ExportScheduler *scheduler,
+                               ExportJobRunner runner,
+                               void *runnerContext,
+                               const struct ExportBudget *budget);
+
+/**
+ * Queues a job. The job MUST NOT be changed or released until exportSchedulerWait has returned for it.
+ * @param[in] scheduler
+ *                started scheduler [REQUIRED]
+ * @param[in] job
+ *                job whose member data has been set [REQUIRED]
+ * @return EXECUTION_OK or ERROR_PARAMETER_MISMATCH if the scheduler is stopping
+ */
+short int exportSchedulerSubmit(struct ExportScheduler *scheduler,
+                                struct ExportJob *job);
+
+/**
+ * Reports the latency of a transaction call. The function does not block and may be invoked concurrently.
+ * @param[in] scheduler
+ *                started scheduler [REQUIRED]
+ * @param[in] nanoseconds
+ *                duration of the call [REQUIRED]
+ */
+void exportSchedulerReportLatency(struct ExportScheduler *scheduler,
+                                  uint64_t nanoseconds);
+
+/**
+ * Returns whether an export is running, so that callers can skip measuring their latency otherwise.
+ * @param[in] scheduler
+ *                started scheduler [REQUIRED]
+ * @return true if a job is running
+ */
+bool exportSchedulerActive(struct ExportScheduler *scheduler);
+
+/**
+ * Copies the progress of a job.
+ * @param[in] scheduler
+ *                started scheduler [REQUIRED]
+ * @param[in] job
+ *                submitted job [REQUIRED]
+ * @param[out] status
+ *                receives the progress [REQUIRED]
+ */
+void exportSchedulerStatus(struct ExportScheduler *scheduler,
+                           const struct ExportJob *job,
+                           struct ExportJobStatus *status);
+
+/**
+ * Cancels a job. A queued job is removed from the queue, a running job is aborted at the next invocation of the
+ * throttle. A finished job is not changed.
+ * @param[in] scheduler
+ *                started scheduler [REQUIRED]
+ * @param[in] job
+ *                submitted job [REQUIRED]
+ */
+void exportSchedulerCancel(struct ExportScheduler *scheduler,
+                           struct ExportJob *job);
+
+/**
+ * Waits until a job has finished or has been cancelled.
+ * @param[in] scheduler
+ *                started scheduler [REQUIRED]
+ * @param[in] job
+ *                submitted job [REQUIRED]
+ * @return the result of the export, ERROR_STORAGE_FAILURE for a cancelled job
+ */
+short int exportSchedulerWait(struct ExportScheduler *scheduler,
+                              struct ExportJob *job);
+
+/**
+ * Stops the thread of the scheduler. Queued jobs and the running job are cancelled, their results remain readable
+ * in the jobs. No thread MAY wait for a job or submit a job concurrently.
+ * @param[in] scheduler
+ *                started scheduler [REQUIRED]
+ */
+void exportSchedulerStop(struct ExportScheduler *scheduler);
+
+#endif
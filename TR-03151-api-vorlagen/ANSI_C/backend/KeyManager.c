@@ -0,0 +1,844 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "KeyManager.h"
+#include "Crc32.h"
+
+/**
+ * Identifies a key file ("SKEY") and its layout version
+ */
+#define KEY_FILE_MAGIC 0x534B4559u
+#define KEY_FILE_VERSION 1u
+
+#define KEY_FILE_NAME "keys.dat"
+#define KEY_TEMPORARY_FILE_NAME "keys.dat.tmp"
+
+/**
+ * Flag of the key file: the Secure Element has been disabled while no key was active
+ */
+#define KEY_FILE_DISABLED_WITHOUT_KEY 0x1u
+
+/**
+ * Lengths of the TLV encoding of a serial number record: SEQUENCE { serialNumber OCTET STRING,
+ * isUsedForTransactionLogs BOOLEAN, isUsedForSystemLogs BOOLEAN, isUsedForAuditLogs BOOLEAN }
+ */
+#define KEY_SERIAL_NUMBER_RECORD_CONTENT_LENGTH (2 + SHA256_DIGEST_LENGTH + 3 * 3)
+#define KEY_SERIAL_NUMBER_RECORD_LENGTH (2 + KEY_SERIAL_NUMBER_RECORD_CONTENT_LENGTH)
+
+/**
+ * Layout of the header of the key file, which is followed by keyCount records. The checksum covers the whole file
+ * with the member crc set to 0.
+ */
+struct KeyFileHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t keyCount;
+    uint32_t flags;
+    uint32_t crc;
+    uint32_t reserved;
+};
+
+/**
+ * Layout of a key in the key file
+ */
+struct KeyFileRecord {
+    uint32_t state;
+    uint16_t signatureAlgorithmLength;
+    uint16_t publicKeyLength;
+    int64_t notAfter;
+    char signatureAlgorithm[RECEIPT_CODE_ALGORITHM_MAX];
+    unsigned char publicKey[RECEIPT_CODE_PUBLIC_KEY_MAX];
+    unsigned char certificateDigest[SHA256_DIGEST_LENGTH];
+};
+
+static short int keyManagerFilePath(const char *directory,
+                                    const char *name,
+                                    char *path,
+                                    size_t pathSize)
+{
+    int length = snprintf(path, pathSize, "%s/%s", directory, name);
+
+    if (length < 0 || (size_t) length >= pathSize) {
+        return ERROR_PARAMETER_MISMATCH;
+    }
+    return EXECUTION_OK;
+}
+
+/**
+ * Replaces the key file by the passed header and records.
+ */
+static short int keyManagerWriteFile(const char *directory,
+                                     struct KeyFileHeader *header,
+                                     const struct KeyFileRecord *records)
+{
+    char path[4096];
+    char temporaryPath[4096];
+    const unsigned char *parts[2];
+    size_t partLengths[2];
+    short int result = EXECUTION_OK;
+    size_t part;
+    int fd;
+
+    if (keyManagerFilePath(directory, KEY_FILE_NAME, path, sizeof path) != EXECUTION_OK
+        || keyManagerFilePath(directory, KEY_TEMPORARY_FILE_NAME, temporaryPath, sizeof temporaryPath)
+               != EXECUTION_OK) {
+        return ERROR_STORAGE_FAILURE;
+    }
+    header->magic = KEY_FILE_MAGIC;
+    header->version = KEY_FILE_VERSION;
+    header->crc = 0;
+    header->reserved = 0;
+    header->crc = crc32Update(crc32Update(0, header, sizeof *header), records, header->keyCount * sizeof *records);
+    parts[0] = (const unsigned char *) header;
+    partLengths[0] = sizeof *header;
+    parts[1] = (const unsigned char *) records;
+    partLengths[1] = header->keyCount * sizeof *records;
+
+    fd = open(temporaryPath, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+    if (fd < 0) {
+        return ERROR_STORAGE_FAILURE;
+    }
+    for (part = 0; part < 2 && result == EXECUTION_OK; part++) {
+        size_t position = 0;
+
+        while (position < partLengths[part]) {
+            ssize_t written = write(fd, parts[part] + position, partLengths[part] - position);
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                result = ERROR_STORAGE_FAILURE;
+                break;
+            }
+            position += (size_t) written;
+        }
+    }
+    if (result == EXECUTION_OK && fdatasync(fd) != 0) {
+        result = ERROR_STORAGE_FAILURE;
+    }
+    close(fd);
+    if (result == EXECUTION_OK && rename(temporaryPath, path) != 0) {
+        result = ERROR_STORAGE_FAILURE;
+    }
+    if (result != EXECUTION_OK) {
+        unlink(temporaryPath);
+        return result;
+    }
+    fd = open(directory, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd < 0 || fsync(fd) != 0) {
+        result = ERROR_STORAGE_FAILURE;
+    }
+    if (fd >= 0) {
+        close(fd);
+    }
+    return result;
+}
+
+static void keyManagerToRecord(const struct ManagedKey *key,
+                               struct KeyFileRecord *record)
+{
+    memset(record, 0, sizeof *record);
+    record->state = (uint32_t) key->state;
+    record->notAfter = key->notAfter;
+    record->signatureAlgorithmLength = (uint16_t) key->signatureAlgorithmLength;
+    memcpy(record->signatureAlgorithm, key->signatureAlgorithm, key->signatureAlgorithmLength);
+    record->publicKeyLength = (uint16_t) key->publicKeyLength;
+    memcpy(record->publicKey, key->publicKey, key->publicKeyLength);
+    memcpy(record->certificateDigest, key->certificateDigest, SHA256_DIGEST_LENGTH);
+}
+
+static short int keyManagerFromRecord(const struct KeyFileRecord *record,
+                                      struct ManagedKey *key)
+{
+    if (record->state > managedKeyDisabled || record->signatureAlgorithmLength > RECEIPT_CODE_ALGORITHM_MAX
+        || record->publicKeyLength == 0 || record->publicKeyLength > RECEIPT_CODE_PUBLIC_KEY_MAX) {
+        return ERROR_STORAGE_FAILURE;
+    }
+    memset(key, 0, sizeof *key);
+    key->state = (enum ManagedKeyState) record->state;
+    key->notAfter = record->notAfter;
+    key->signatureAlgorithmLength = record->signatureAlgorithmLength;
+    memcpy(key->signatureAlgorithm, record->signatureAlgorithm, record->signatureAlgorithmLength);
+    key->publicKeyLength = record->publicKeyLength;
+    memcpy(key->publicKey, record->publicKey, record->publicKeyLength);
+    memcpy(key->certificateDigest, record->certificateDigest, SHA256_DIGEST_LENGTH);
+    sha256Digest(key->publicKey, key->publicKeyLength, key->serialNumber);
+    return receiptCodeKeyInit(&key->receiptCodeKey, key->signatureAlgorithm, key->signatureAlgorithmLength,
+                              key->publicKey, key->publicKeyLength) == EXECUTION_OK
+           ? EXECUTION_OK
+           : ERROR_STORAGE_FAILURE;
+}
+
+/**
+ * Copies the keys into the records of the key file. The lock MUST be held. The records are released with free.
+ */
+static struct KeyFileRecord *keyManagerSnapshot(const struct KeyManager *manager,
+                                                size_t extraCount,
+                                                struct KeyFileHeader *header)
+{
+    struct KeyFileRecord *records = malloc((manager->keyCount + extraCount + 1) * sizeof *records);
+    size_t i;
+
+    if (records == NULL) {
+        return NULL;
+    }
+    for (i = 0; i < manager->keyCount; i++) {
+        keyManagerToRecord(&manager->keys[i], &records[i]);
+    }
+    memset(header, 0, sizeof *header);
+    header->keyCount = (uint32_t) manager->keyCount;
+    header->flags = manager->active == SIZE_MAX && manager->activeDisabled ? KEY_FILE_DISABLED_WITHOUT_KEY : 0u;
+    return records;
+}
+
+static short int keyManagerReadFile(struct KeyManager *manager,
+                                    uint32_t *flags)
+{
+    char path[4096];
+    struct KeyFileHeader header;
+    struct KeyFileRecord *records = NULL;
+    uint32_t crc;
+    off_t size;
+    short int result = ERROR_STORAGE_FAILURE;
+    size_t i;
+    int fd;
+
+    *flags = 0;
+    if (keyManagerFilePath(manager->directory, KEY_FILE_NAME, path, sizeof path) != EXECUTION_OK) {
+        return ERROR_STORAGE_FAILURE;
+    }
+    fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return errno == ENOENT ? EXECUTION_OK : ERROR_STORAGE_FAILURE;
+    }
+    size = lseek(fd, 0, SEEK_END);
+    if (size < (off_t) sizeof header || pread(fd, &header, sizeof header, 0) != (ssize_t) sizeof header
+        || header.magic != KEY_FILE_MAGIC || header.version != KEY_FILE_VERSION
+        || (uint64_t) size != sizeof header + (uint64_t) header.keyCount * sizeof *records) {
+        close(fd);
+        return ERROR_STORAGE_FAILURE;
+    }
+    records = malloc((header.keyCount + 1) * sizeof *records);
+    manager->keys = calloc(header.keyCount + 1, sizeof *manager->keys);
+    if (records != NULL && manager->keys != NULL
+        && pread(fd, records, header.keyCount * sizeof *records, sizeof header)
+               == (ssize_t) (header.keyCount * sizeof *records)) {
+        crc = header.crc;
+        header.crc = 0;
+        if (crc32Update(crc32Update(0, &header, sizeof header), records, header.keyCount * sizeof *records) == crc) {
+            result = EXECUTION_OK;
+        }
+    }
+    close(fd);
+    for (i = 0; result == EXECUTION_OK && i < header.keyCount; i++) {
+        result = keyManagerFromRecord(&records[i], &manager->keys[i]);
+    }
+    free(records);
+    if (result != EXECUTION_OK) {
+        return result;
+    }
+    manager->keyCount = header.keyCount;
+    manager->keyCapacity = header.keyCount + 1;
+    *flags = header.flags;
+    return EXECUTION_OK;
+}
+
+static size_t keyManagerFirstStandby(const struct KeyManager *manager)
+{
+    size_t i;
+
+    for (i = 0; i < manager->keyCount; i++) {
+        if (manager->keys[i].state == managedKeyStandby) {
+            return i;
+        }
+    }
+    return SIZE_MAX;
+}
+
+static unsigned int keyManagerStandbyAvailable(const struct KeyManager *manager)
+{
+    unsigned int count = 0;
+    size_t i;
+
+    for (i = 0; i < manager->keyCount; i++) {
+        count += manager->keys[i].state == managedKeyStandby;
+    }
+    return count;
+}
+
+/**
+ * Publishes the times and the state that the append path reads without the lock. The lock MUST be held.
+ */
+static void keyManagerSchedule(struct KeyManager *manager)
+{
+    const struct ManagedKey *active = manager->active != SIZE_MAX ? &manager->keys[manager->active] : NULL;
+    int64_t rotationTime = INT64_MAX;
+
+    if (keyManagerFirstStandby(manager) != SIZE_MAX) {
+        if (active == NULL || manager->activeDisabled) {
+            rotationTime = INT64_MIN;
+        } else if (active->notAfter != 0) {
+            rotationTime = active->notAfter > INT64_MIN + manager->rotationLead
+                           ? active->notAfter - manager->rotationLead
+                           : INT64_MIN;
+        }
+    }
+    atomic_store(&manager->rotationTime, rotationTime);
+    atomic_store(&manager->expiryTime,
+                 active != NULL && !manager->activeDisabled && active->notAfter != 0 ? active->notAfter : INT64_MAX);
+    atomic_store(&manager->disabled, manager->activeDisabled);
+}
+
+/**
+ * Appends the DER encoding of a length.
+ */
+static size_t keyManagerDerLength(unsigned char *output,
+                                  size_t length)
+{
+    size_t byteCount = 0;
+    size_t remaining;
+    size_t i;
+
+    if (length < 0x80) {
+        output[0] = (unsigned char) length;
+        return 1;
+    }
+    for (remaining = length; remaining != 0; remaining >>= 8) {
+        byteCount++;
+    }
+    output[0] = (unsigned char) (0x80 | byteCount);
+    for (i = 0; i < byteCount; i++) {
+        output[byteCount - i] = (unsigned char) (length >> (8 * i));
+    }
+    return 1 + byteCount;
+}
+
+/**
+ * Copy of the members of a used key that the cached export data is built from
+ */
+struct KeyCacheEntry {
+    size_t index;
+    uint64_t firstSignatureCounter;
+    unsigned char serialNumber[SHA256_DIGEST_LENGTH];
+    bool used;
+    bool archived;
+};
+
+/**
+ * Brings the cached data of exportSerialNumbers and exportCertificates up to date. The cache lock MUST be held and
+ * the lock MUST NOT be held: the keys are copied under the lock, the certificates are read without it, so that the
+ * activation of a key does not wait for the update. The archive is extended in place: its end-of-archive marker is
+ * replaced by the certificates of the keys that have been activated since the last update.
+ */
+static short int keyManagerRefreshCaches(struct KeyManager *manager)
+{
+    struct KeyCacheEntry *entries;
+    unsigned char *serialNumbers;
+    struct TarWriter *writer;
+    uint64_t generation;
+    size_t usedCount = 0;
+    size_t position;
+    size_t i;
+    short int result = EXECUTION_OK;
+
+    profileLock(&manager->lock);
+    generation = manager->generation;
+    if (manager->cachedGeneration == generation) {
+        profileUnlock(&manager->lock);
+        return EXECUTION_OK;
+    }
+    for (i = 0; i < manager->keyCount; i++) {
+        usedCount += manager->keys[i].state != managedKeyStandby;
+    }
+    entries = malloc((usedCount != 0 ? usedCount : 1) * sizeof *entries);
+    if (entries == NULL) {
+        profileUnlock(&manager->lock);
+        return ERROR_STORAGE_FAILURE;
+    }
+    for (i = 0, usedCount = 0; i < manager->keyCount; i++) {
+        const struct ManagedKey *key = &manager->keys[i];
+        struct KeyCacheEntry *entry = &entries[usedCount];
+
+        if (key->state == managedKeyStandby) {
+            continue;
+        }
+        entry->index = i;
+        entry->firstSignatureCounter = key->firstSignatureCounter;
+        memcpy(entry->serialNumber, key->serialNumber, SHA256_DIGEST_LENGTH);
+        entry->used = i == manager->active && !manager->activeDisabled;
+        entry->archived = key->archived;
+        usedCount++;
+    }
+    profileUnlock(&manager->lock);
+
+    serialNumbers = malloc(6 + usedCount * KEY_SERIAL_NUMBER_RECORD_LENGTH);
+    if (serialNumbers == NULL) {
+        free(entries);
+        return ERROR_STORAGE_FAILURE;
+    }
+    serialNumbers[0] = 0x30;
+    position = 1 + keyManagerDerLength(serialNumbers + 1, usedCount * KEY_SERIAL_NUMBER_RECORD_LENGTH);
+    for (i = 0; i < usedCount; i++) {
+        unsigned char used = entries[i].used ? 0xFF : 0x00;
+        int flag;
+
+        serialNumbers[position++] = 0x30;
+        serialNumbers[position++] = KEY_SERIAL_NUMBER_RECORD_CONTENT_LENGTH;
+        serialNumbers[position++] = 0x04;
+        serialNumbers[position++] = SHA256_DIGEST_LENGTH;
+        memcpy(serialNumbers + position, entries[i].serialNumber, SHA256_DIGEST_LENGTH);
+        position += SHA256_DIGEST_LENGTH;
+        for (flag = 0; flag < 3; flag++) {
+            serialNumbers[position++] = 0x01;
+            serialNumbers[position++] = 0x01;
+            serialNumbers[position++] = used;
+        }
+    }
+    free(manager->serialNumbers);
+    manager->serialNumbers = serialNumbers;
+    manager->serialNumbersLength = position;
+
+    writer = malloc(sizeof *writer);
+    if (writer == NULL) {
+        free(entries);
+        return ERROR_STORAGE_FAILURE;
+    }
+    if (manager->certificateArchive.length >= 2 * TAR_BLOCK_SIZE) {
+        manager->certificateArchive.length -= 2 * TAR_BLOCK_SIZE;
+    }
+    tarWriterInit(writer, tarMemorySinkWrite, &manager->certificateArchive);
+    for (i = 0; i < usedCount && result == EXECUTION_OK; i++) {
+        if (!entries[i].archived) {
+            result = certificateStoreAddToArchive(manager->certificates, entries[i].firstSignatureCounter,
+                                                  entries[i].firstSignatureCounter, writer);
+        }
+    }
+    if (result == EXECUTION_OK) {
+        result = tarWriterFinish(writer);
+    }
+    free(writer);
+
+    profileLock(&manager->lock);
+    if (result != EXECUTION_OK) {
+        /* the archive is built again from the start by the next update */
+        manager->certificateArchive.length = 0;
+        for (i = 0; i < manager->keyCount; i++) {
+            manager->keys[i].archived = false;
+        }
+    } else {
+        for (i = 0; i < usedCount; i++) {
+            manager->keys[entries[i].index].archived = true;
+        }
+        manager->cachedGeneration = generation;
+    }
+    profileUnlock(&manager->lock);
+    free(entries);
+    return result;
+}
+
+short int keyManagerOpen(struct KeyManager *manager,
+                         const char *directory,
+                         struct CertificateStore *certificates,
+                         struct ReceiptCodeKey *receiptCodeKey)
+{
+    unsigned char currentDigest[SHA256_DIGEST_LENGTH];
+    uint64_t currentSignatureCounter = 0;
+    bool current;
+    uint32_t flags;
+    short int result;
+    size_t i;
+
+    memset(manager, 0, sizeof *manager);
+    manager->directory = strdup(directory);
+    if (manager->directory == NULL) {
+        return ERROR_STORAGE_FAILURE;
+    }
+    manager->certificates = certificates;
+    manager->active = SIZE_MAX;
+    manager->standbyCount = KEY_MANAGER_DEFAULT_STANDBY_COUNT;
+    manager->rotationLead = KEY_MANAGER_DEFAULT_ROTATION_LEAD;
+    result = keyManagerReadFile(manager, &flags);
+
+    /* the keys whose certificates have been registered are in use; the last one is active */
+    current = certificateStoreCurrent(certificates, currentDigest, &currentSignatureCounter);
+    for (i = 0; result == EXECUTION_OK && i < manager->keyCount; i++) {
+        struct ManagedKey *key = &manager->keys[i];
+
+        result = certificateStoreLoadStaged(certificates, key->certificateDigest);
+        if (result == EXECUTION_OK && certificateStoreFirstUse(certificates, key->certificateDigest,
+                                                               &key->firstSignatureCounter)) {
+            if (current && memcmp(key->certificateDigest, currentDigest, SHA256_DIGEST_LENGTH) == 0) {
+                manager->active = i;
+                manager->activeDisabled = key->state == managedKeyDisabled;
+            }
+            if (key->state != managedKeyDisabled) {
+                key->state = i == manager->active ? managedKeyActive : managedKeyRetired;
+            }
+        }
+    }
+    if (result != EXECUTION_OK) {
+        free(manager->keys);
+        free(manager->directory);
+        return result;
+    }
+    if (manager->active == SIZE_MAX && !current && (flags & KEY_FILE_DISABLED_WITHOUT_KEY) != 0) {
+        manager->activeDisabled = true;
+    }
+    if (manager->active != SIZE_MAX && !manager->activeDisabled) {
+        *receiptCodeKey = manager->keys[manager->active].receiptCodeKey;
+    }
+
+    pthread_mutex_init(&manager->persistLock, NULL);
+    pthread_mutex_init(&manager->lock, NULL);
+    pthread_mutex_init(&manager->cacheLock, NULL);
+#if PROFILE_CONCURRENT
+    {
+        pthread_condattr_t attributes;
+
+        pthread_condattr_init(&attributes);
+        pthread_condattr_setclock(&attributes, CLOCK_MONOTONIC);
+        pthread_cond_init(&manager->changed, &attributes);
+        pthread_condattr_destroy(&attributes);
+    }
+#endif
+    manager->generation = 1;
+    keyManagerSchedule(manager);
+    return EXECUTION_OK;
+}
+
+short int keyManagerAddStandby(struct KeyManager *manager,
+                               const struct KeyProvision *provision)
+{
+    struct ManagedKey key;
+    struct KeyFileHeader header;
+    struct KeyFileRecord *records;
+    short int result;
+    size_t i;
+
+    if (provision == NULL || provision->signatureAlgorithmLength > RECEIPT_CODE_ALGORITHM_MAX
+        || provision->publicKeyLength == 0 || provision->publicKeyLength > RECEIPT_CODE_PUBLIC_KEY_MAX) {
+        return ERROR_PARAMETER_MISMATCH;
+    }
+    memset(&key, 0, sizeof key);
+    key.state = managedKeyStandby;
+    key.notAfter = provision->notAfter;
+    key.signatureAlgorithmLength = provision->signatureAlgorithmLength;
+    memcpy(key.signatureAlgorithm, provision->signatureAlgorithm, provision->signatureAlgorithmLength);
+    key.publicKeyLength = provision->publicKeyLength;
+    memcpy(key.publicKey, provision->publicKey, provision->publicKeyLength);
+    sha256Digest(key.publicKey, key.publicKeyLength, key.serialNumber);
+    result = receiptCodeKeyInit(&key.receiptCodeKey, key.signatureAlgorithm, key.signatureAlgorithmLength,
+                                key.publicKey, key.publicKeyLength);
+    if (result == EXECUTION_OK) {
+        /* the certificate is written before the key file refers to it */
+        result = certificateStoreStage(manager->certificates, provision->certificate, provision->certificateLength,
+                                       key.certificateDigest);
+    }
+    if (result != EXECUTION_OK) {
+        return result;
+    }
+
+    /* the key file is written before the key can be activated, so that an active key is always known after a
+       restart */
+    profileLock(&manager->persistLock);
+    profileLock(&manager->lock);
+    for (i = 0; i < manager->keyCount; i++) {
+        if (memcmp(manager->keys[i].serialNumber, key.serialNumber, SHA256_DIGEST_LENGTH) == 0
+            || memcmp(manager->keys[i].certificateDigest, key.certificateDigest, SHA256_DIGEST_LENGTH) == 0) {
+            result = ERROR_PARAMETER_MISMATCH;
+        }
+    }
+    records = result == EXECUTION_OK ? keyManagerSnapshot(manager, 1, &header) : NULL;
+    if (records != NULL) {
+        keyManagerToRecord(&key, &records[header.keyCount++]);
+    }
+    profileUnlock(&manager->lock);
+    if (result == EXECUTION_OK) {
+        result = records != NULL ? keyManagerWriteFile(manager->directory, &header, records) : ERROR_STORAGE_FAILURE;
+    }
+    free(records);
+
+    if (result == EXECUTION_OK) {
+        profileLock(&manager->lock);
+        if (manager->keyCount == manager->keyCapacity) {
+            size_t capacity = manager->keyCapacity != 0 ? 2 * manager->keyCapacity : 4;
+            struct ManagedKey *keys = realloc(manager->keys, capacity * sizeof *keys);
+            if (keys != NULL) {
+                manager->keys = keys;
+                manager->keyCapacity = capacity;
+            }
+        }
+        if (manager->keyCount < manager->keyCapacity) {
+            manager->keys[manager->keyCount++] = key;
+            keyManagerSchedule(manager);
+#if PROFILE_CONCURRENT
+            pthread_cond_broadcast(&manager->changed);
+#endif
+        } else {
+            result = ERROR_STORAGE_FAILURE;
+        }
+        profileUnlock(&manager->lock);
+    }
+    profileUnlock(&manager->persistLock);
+    return result;
+}
+
+bool keyManagerDue(struct KeyManager *manager,
+                   int64_t logTime)
+{
+    return logTime >= atomic_load(&manager->rotationTime);
+}
+
+short int keyManagerActivate(struct KeyManager *manager,
+                             uint64_t firstSignatureCounter,
+                             struct ReceiptCodeKey *receiptCodeKey)
+{
+    struct ManagedKey *key;
+    size_t standby;
+    short int result;
+
+    profileLock(&manager->lock);
+    standby = keyManagerFirstStandby(manager);
+    if (standby == SIZE_MAX) {
+        profileUnlock(&manager->lock);
+        return EXECUTION_OK;
+    }
+    key = &manager->keys[standby];
+    result = certificateStoreUse(manager->certificates, key->certificateDigest, firstSignatureCounter);
+    if (result == EXECUTION_OK) {
+        if (manager->active != SIZE_MAX && !manager->activeDisabled) {
+            manager->keys[manager->active].state = managedKeyRetired;
+        }
+        key->state = managedKeyActive;
+        key->firstSignatureCounter = firstSignatureCounter;
+        manager->active = standby;
+        manager->activeDisabled = false;
+        manager->generation++;
+        *receiptCodeKey = key->receiptCodeKey;
+        keyManagerSchedule(manager);
+#if PROFILE_CONCURRENT
+        pthread_cond_broadcast(&manager->changed);
+#endif
+    }
+    profileUnlock(&manager->lock);
+    return result;
+}
+
+bool keyManagerDisabled(struct KeyManager *manager)
+{
+    return atomic_load(&manager->disabled);
+}
+
+bool keyManagerExpired(struct KeyManager *manager,
+                       int64_t logTime)
+{
+    return logTime >= atomic_load(&manager->expiryTime);
+}
+
+short int keyManagerDisable(struct KeyManager *manager)
+{
+    struct KeyFileHeader header;
+    struct KeyFileRecord *records;
+    short int result;
+
+    /* the disabling is persisted before it is applied; the caller holds the append lock, so no key is activated in
+       between */
+    profileLock(&manager->persistLock);
+    profileLock(&manager->lock);
+    records = keyManagerSnapshot(manager, 0, &header);
+    if (records != NULL) {
+        if (manager->active != SIZE_MAX) {
+            records[manager->active].state = managedKeyDisabled;
+        } else {
+            header.flags |= KEY_FILE_DISABLED_WITHOUT_KEY;
+        }
+    }
+    profileUnlock(&manager->lock);
+    result = records != NULL ? keyManagerWriteFile(manager->directory, &header, records) : ERROR_STORAGE_FAILURE;
+    free(records);
+
+    if (result == EXECUTION_OK) {
+        profileLock(&manager->lock);
+        if (manager->active != SIZE_MAX) {
+            manager->keys[manager->active].state = managedKeyDisabled;
+        }
+        manager->activeDisabled = true;
+        manager->generation++;
+        keyManagerSchedule(manager);
+#if PROFILE_CONCURRENT
+        pthread_cond_broadcast(&manager->changed);
+#endif
+        profileUnlock(&manager->lock);
+    }
+    profileUnlock(&manager->persistLock);
+    return result == EXECUTION_OK ? EXECUTION_OK : ERROR_DISABLE_SECURE_ELEMENT_FAILED;
+}
+
+short int keyManagerExportSerialNumbers(struct KeyManager *manager,
+                                        unsigned char **data,
+                                        size_t *dataLength)
+{
+    short int result;
+
+    profileLock(&manager->cacheLock);
+    result = keyManagerRefreshCaches(manager);
+    *data = result == EXECUTION_OK ? malloc(manager->serialNumbersLength) : NULL;
+    if (*data != NULL) {
+        memcpy(*data, manager->serialNumbers, manager->serialNumbersLength);
+        *dataLength = manager->serialNumbersLength;
+    }
+    profileUnlock(&manager->cacheLock);
+    return *data != NULL ? EXECUTION_OK : ERROR_EXPORT_SERIAL_NUMBERS_FAILED;
+}
+
+short int keyManagerExportCertificates(struct KeyManager *manager,
+                                       unsigned char **data,
+                                       size_t *dataLength)
+{
+    short int result;
+
+    profileLock(&manager->cacheLock);
+    result = keyManagerRefreshCaches(manager);
+    *data = result == EXECUTION_OK ? malloc(manager->certificateArchive.length) : NULL;
+    if (*data != NULL) {
+        memcpy(*data, manager->certificateArchive.data, manager->certificateArchive.length);
+        *dataLength = manager->certificateArchive.length;
+    }
+    profileUnlock(&manager->cacheLock);
+    return *data != NULL ? EXECUTION_OK : ERROR_EXPORT_CERT_FAILED;
+}
+
+short int keyManagerRefill(struct KeyManager *manager)
+{
+    struct KeyProvision provision;
+    KeyProvisioner provisioner;
+    void *provisionerContext;
+    bool needed;
+    short int result = EXECUTION_OK;
+
+    do {
+        profileLock(&manager->lock);
+        provisioner = manager->provisioner;
+        provisionerContext = manager->provisionerContext;
+        needed = provisioner != NULL && !manager->stopping
+                 && keyManagerStandbyAvailable(manager) < manager->standbyCount;
+        profileUnlock(&manager->lock);
+        if (needed) {
+            memset(&provision, 0, sizeof provision);
+            result = provisioner(provisionerContext, &provision);
+            if (result == EXECUTION_OK) {
+                result = keyManagerAddStandby(manager, &provision);
+            }
+        }
+    } while (needed && result == EXECUTION_OK);
+    return result;
+}
+
+#if PROFILE_CONCURRENT
+/**
+ * Checks whether the thread has nothing to do. The lock MUST be held.
+ */
+static bool keyManagerIdle(const struct KeyManager *manager)
+{
+    return manager->cachedGeneration == manager->generation
+           && (manager->provisioner == NULL || keyManagerStandbyAvailable(manager) >= manager->standbyCount);
+}
+
+/**
+ * Thread that provisions standby keys and updates the cached export data after an activation.
+ */
+static void *keyManagerRun(void *argument)
+{
+    struct KeyManager *manager = (struct KeyManager *) argument;
+
+    pthread_mutex_lock(&manager->lock);
+    while (!manager->stopping) {
+        struct timespec deadline;
+        short int result;
+        short int refillResult;
+
+        pthread_mutex_unlock(&manager->lock);
+        pthread_mutex_lock(&manager->cacheLock);
+        result = keyManagerRefreshCaches(manager);
+        pthread_mutex_unlock(&manager->cacheLock);
+        refillResult = keyManagerRefill(manager);
+        pthread_mutex_lock(&manager->lock);
+
+        /* a failure is retried after an interval; an export updates the cached data itself in the meantime */
+        if (result != EXECUTION_OK || refillResult != EXECUTION_OK) {
+            clock_gettime(CLOCK_MONOTONIC, &deadline);
+            deadline.tv_sec += KEY_MANAGER_RETRY_INTERVAL;
+            while (!manager->stopping
+                   && pthread_cond_timedwait(&manager->changed, &manager->lock, &deadline) != ETIMEDOUT) {
+            }
+        } else {
+            while (!manager->stopping && keyManagerIdle(manager)) {
+                pthread_cond_wait(&manager->changed, &manager->lock);
+            }
+        }
+    }
+    pthread_mutex_unlock(&manager->lock);
+    return NULL;
+}
+#endif
+
+short int keyManagerStart(struct KeyManager *manager,
+                          KeyProvisioner provisioner,
+                          void *provisionerContext,
+                          unsigned int standbyCount,
+                          int64_t rotationLead)
+{
+    profileLock(&manager->lock);
+    if (manager->started || rotationLead < 0) {
+        profileUnlock(&manager->lock);
+        return ERROR_PARAMETER_MISMATCH;
+    }
+    manager->started = true;
+    manager->provisioner = provisioner;
+    manager->provisionerContext = provisionerContext;
+    manager->standbyCount = standbyCount != 0 ? standbyCount : KEY_MANAGER_DEFAULT_STANDBY_COUNT;
+    manager->rotationLead = rotationLead != 0 ? rotationLead : KEY_MANAGER_DEFAULT_ROTATION_LEAD;
+    keyManagerSchedule(manager);
+    profileUnlock(&manager->lock);
+
+#if PROFILE_CONCURRENT
+    if (pthread_create(&manager->thread, NULL, keyManagerRun, manager) != 0) {
+        pthread_mutex_lock(&manager->lock);
+        manager->started = false;
+        manager->provisioner = NULL;
+        pthread_mutex_unlock(&manager->lock);
+        return ERROR_STORAGE_FAILURE;
+    }
+    return EXECUTION_OK;
+#else
+    /* without a thread the cached export data is updated by the next export */
+    return keyManagerRefill(manager);
+#endif
+}
+
+void keyManagerClose(struct KeyManager *manager)
+{
+#if PROFILE_CONCURRENT
+    if (manager->started) {
+        pthread_mutex_lock(&manager->lock);
+        manager->stopping = true;
+        pthread_cond_broadcast(&manager->changed);
+        pthread_mutex_unlock(&manager->lock);
+        pthread_join(manager->thread, NULL);
+    }
+    pthread_cond_destroy(&manager->changed);
+#endif
+    pthread_mutex_destroy(&manager->cacheLock);
+    pthread_mutex_destroy(&manager->lock);
+    pthread_mutex_destroy(&manager->persistLock);
+    free(manager->serialNumbers);
+    free(manager->certificateArchive.data);
+    free(manager->keys);
+    free(manager->directory);
+    memset(manager, 0, sizeof *manager);
+}
@@ -0,0 +1,307 @@
+#ifndef SEAPI_BACKEND_KEY_MANAGER_H
+#define SEAPI_BACKEND_KEY_MANAGER_H
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "../Exception.h"
+#include "../Constant.h"
+#include "CertificateStore.h"
+#include "Profile.h"
+#include "ReceiptCode.h"
+#include "TarWriter.h"
+
+/**
+ * This header file defines the key lifecycle of the SE API backend: the keys whose certificates verify the log
+ * messages, the standby keys that take over when the certificate of the active key nears its expiry or the Secure
+ * Element of the active key is disabled, and the data of exportSerialNumbers and exportCertificates.
+ *
+ * The backend does not sign and cannot generate keys. Standby keys are generated and certified outside of it, e.g.
+ * by a second Secure Element and the certification authority, and are passed to keyManagerAddStandby or returned
+ * by a KeyProvisioner, which a thread of the key manager calls whenever fewer standby keys than requested are
+ * available. The certificate of a standby key is stored in the certificate store before the key is needed.
+ *
+ * A standby key is activated by the thread that appends a log message while holding the append lock, i.e. between
+ * two log messages: the certificate store records that the certificate of the standby key is in use from the
+ * signature counter of the next log message on, which only appends a record to its journal, and the receipt code
+ * key, whose Base64 form has been computed when the standby key was added, is copied. The cached data of
+ * exportSerialNumbers and exportCertificates is updated afterwards in place, by the thread of the key manager or by
+ * the next export; the transaction functions never wait for it.
+ *
+ * The keys are kept in the file keys.dat in the directory of the backend. Which key is active is not written to
+ * the file when a key is activated but derived from the certificate store when the key manager is opened.
+ *
+ * In the embedded build profile (see Profile.h) no thread is started: the provisioner is called by keyManagerStart
+ * and keyManagerRefill on the calling thread.
+ */
+
+/**
+ * Default number of standby keys that the provisioner keeps available
+ */
+#define KEY_MANAGER_DEFAULT_STANDBY_COUNT 1
+
+/**
+ * Default time in seconds before the end of the validity of the certificate of the active key at which a standby
+ * key is activated
+ */
+#define KEY_MANAGER_DEFAULT_ROTATION_LEAD (7l * 24l * 60l * 60l)
+
+/**
+ * Time in seconds after which a failed provisioning is retried
+ */
+#define KEY_MANAGER_RETRY_INTERVAL 60
+
+/**
+ * States of a key
+ */
+enum ManagedKeyState {
+managedKeyStandby, managedKeyActive, managedKeyRetired, managedKeyDisabled
+};
+
+/**
+ * New key pair that has been generated and certified outside of the backend. The certificate is owned by the
+ * caller.
+ */
+struct KeyProvision {
+    char signatureAlgorithm[RECEIPT_CODE_ALGORITHM_MAX];
+    size_t signatureAlgorithmLength;
+    unsigned char publicKey[RECEIPT_CODE_PUBLIC_KEY_MAX];
+    size_t publicKeyLength;
+    const unsigned char *certificate;
+    size_t certificateLength;
+    int64_t notAfter;
+};
+
+/**
+ * Callback that generates and certifies a standby key. It is called without holding a lock of the backend and MAY
+ * take as long as the certification takes.
+ * @param[in] provisionerContext
+ *                context that has been passed to keyManagerStart [OPTIONAL]
+ * @param[out] provision
+ *                receives the new key; the certificate MUST stay available until the callback is called again or
+ *                the key manager has been closed [REQUIRED]
+ * @return EXECUTION_OK or an error code, after which the provisioning is retried after
+ *         KEY_MANAGER_RETRY_INTERVAL seconds
+ */
+typedef short int (*KeyProvisioner)(void *provisionerContext,
+                                    struct KeyProvision *provision);
+
+/**
+ * Key of the backend. The serial number is the SHA-256 digest of the public key.
+ */
+struct ManagedKey {
+    enum ManagedKeyState state;
+    int64_t notAfter;
+    uint64_t firstSignatureCounter;
+    unsigned char serialNumber[SHA256_DIGEST_LENGTH];
+    unsigned char certificateDigest[SHA256_DIGEST_LENGTH];
+    char signatureAlgorithm[RECEIPT_CODE_ALGORITHM_MAX];
+    size_t signatureAlgorithmLength;
+    unsigned char publicKey[RECEIPT_CODE_PUBLIC_KEY_MAX];
+    size_t publicKeyLength;
+    struct ReceiptCodeKey receiptCodeKey;
+    bool archived;
+};
+
+/**
+ * State of a key manager. The members are managed by the functions of this header file; the members from lock to
+ * stopping MUST only be accessed while holding lock, the members after cacheLock, i.e. the cached export data, while
+ * holding cacheLock. A thread that holds both takes cacheLock first.
+ */
+struct KeyManager {
+    char *directory;
+    struct CertificateStore *certificates;
+    _Atomic int64_t rotationTime;
+    _Atomic int64_t expiryTime;
+    atomic_bool disabled;
+    pthread_mutex_t persistLock;
+#if PROFILE_CONCURRENT
+    pthread_t thread;
+#endif
+    bool started;
+    pthread_mutex_t lock;
+#if PROFILE_CONCURRENT
+    pthread_cond_t changed;
+#endif
+    KeyProvisioner provisioner;
+    void *provisionerContext;
+    unsigned int standbyCount;
+    int64_t rotationLead;
+    struct ManagedKey *keys;
+    size_t keyCount;
+    size_t keyCapacity;
+    size_t active;
+    bool activeDisabled;
+    uint64_t generation;
+    uint64_t cachedGeneration;
+    bool stopping;
+    pthread_mutex_t cacheLock;
+    unsigned char *serialNumbers;
+    size_t serialNumbersLength;
+    struct TarMemorySink certificateArchive;
+};
+
+/**
+ * Opens the key manager of a backend and determines the active key from the certificate store.
+ * @param[out] manager
+ *                key manager to be initialized [REQUIRED]
+ * @param[in] directory
+ *                directory of the backend, terminated by NUL [REQUIRED]
+ * @param[in] certificates
+ *                opened certificate store of the backend, which MUST stay open until the key manager has been
+ *                closed [REQUIRED]
+ * @param[out] receiptCodeKey
+ *                receives the receipt code key of the active key, unchanged if no key is active [REQUIRED]
+ * @return EXECUTION_OK or ERROR_STORAGE_FAILURE if the key file or a certificate of a key cannot be read
+ */
+short int keyManagerOpen(struct KeyManager *manager,
+                         const char *directory,
+                         struct CertificateStore *certificates,
+                         struct ReceiptCodeKey *receiptCodeKey);
+
+/**
+ * Starts the provisioning of standby keys. In the server build profile a thread is started that calls the
+ * provisioner whenever fewer standby keys than requested are available and updates the cached export data after an
+ * activation.
+ * @param[in] manager
+ *                opened key manager [REQUIRED]
+ * @param[in] provisioner
+ *                callback that generates and certifies standby keys, NULL if the standby keys are only added with
+ *                keyManagerAddStandby [OPTIONAL]
+ * @param[in] provisionerContext
+ *                context passed to the provisioner [OPTIONAL]
+ * @param[in] standbyCount
+ *                number of standby keys that are kept available, 0 selects the default [REQUIRED]
+ * @param[in] rotationLead
+ *                time in seconds before the end of the validity of the active certificate at which a standby key is
+ *                activated, 0 selects the default [REQUIRED]
+ * @return EXECUTION_OK, ERROR_PARAMETER_MISMATCH if the provisioning has already been started or
+ *         ERROR_STORAGE_FAILURE if the thread could not be created
+ */
+short int keyManagerStart(struct KeyManager *manager,
+                          KeyProvisioner provisioner,
+                          void *provisionerContext,
+                          unsigned int standbyCount,
+                          int64_t rotationLead);
+
+/**
+ * Calls the provisioner until the requested number of standby keys is available. It is called by the thread of the
+ * key manager in the server build profile and by the backend after a log message in the embedded build profile.
+ * @param[in] manager
+ *                opened key manager [REQUIRED]
+ * @return EXECUTION_OK or the return values of the provisioner and keyManagerAddStandby
+ */
+short int keyManagerRefill(struct KeyManager *manager);
+
+/**
+ * Adds a standby key, whose certificate is stored in the certificate store.
+ * @param[in] manager
+ *                opened key manager [REQUIRED]
+ * @param[in] provision
+ *                the key [REQUIRED]
+ * @return if the execution of the function has been successful, the return value EXECUTION_OK SHALL be returned.
+ *
+ *         If the execution of the function has failed, the appropriate error code SHALL be returned:
+ *
+ *             ERROR_PARAMETER_MISMATCH
+ *                a length is out of range, or the key or its certificate is already known
+ *             ERROR_STORAGE_FAILURE
+ *                the certificate or the key file could not be written
+ */
+short int keyManagerAddStandby(struct KeyManager *manager,
+                               const struct KeyProvision *provision);
+
+/**
+ * Checks whether a standby key is to be activated before the next log message. The caller holds the append lock.
+ * @param[in] manager
+ *                opened key manager [REQUIRED]
+ * @param[in] logTime
+ *                log time of the next log message [REQUIRED]
+ * @return true if keyManagerActivate is to be called
+ */
+bool keyManagerDue(struct KeyManager *manager,
+                   int64_t logTime);
+
+/**
+ * Activates the oldest standby key. The caller holds the append lock and has not appended the next log message
+ * yet.
+ * @param[in] manager
+ *                opened key manager [REQUIRED]
+ * @param[in] firstSignatureCounter
+ *                signature counter of the next log message [REQUIRED]
+ * @param[out] receiptCodeKey
+ *                receives the receipt code key of the activated key [REQUIRED]
+ * @return EXECUTION_OK or the return values of certificateStoreAdd
+ */
+short int keyManagerActivate(struct KeyManager *manager,
+                             uint64_t firstSignatureCounter,
+                             struct ReceiptCodeKey *receiptCodeKey);
+
+/**
+ * Checks whether the Secure Element has been disabled and no standby key can take over.
+ * @param[in] manager
+ *                opened key manager [REQUIRED]
+ * @return true if no log message can be stored
+ */
+bool keyManagerDisabled(struct KeyManager *manager);
+
+/**
+ * Checks whether the certificate of the active key has expired at a log time.
+ * @param[in] manager
+ *                opened key manager [REQUIRED]
+ * @param[in] logTime
+ *                log time of a stored log message [REQUIRED]
+ * @return true if the certificate has expired
+ */
+bool keyManagerExpired(struct KeyManager *manager,
+                       int64_t logTime);
+
+/**
+ * Disables the active key, whose Secure Element has been disabled, and persists it. The next log message
+ * activates the oldest standby key; without a standby key no log message can be stored until one is added. The
+ * caller holds the append lock and has appended the log message of disableSecureElement.
+ * @param[in] manager
+ *                opened key manager [REQUIRED]
+ * @return EXECUTION_OK or ERROR_DISABLE_SECURE_ELEMENT_FAILED if the key file could not be written
+ */
+short int keyManagerDisable(struct KeyManager *manager);
+
+/**
+ * Returns the serial numbers of the keys that have been in use, encoded in the TLV structure of exportSerialNumbers.
+ * @param[in] manager
+ *                opened key manager [REQUIRED]
+ * @param[out] data
+ *                receives the data, which is released with free [REQUIRED]
+ * @param[out] dataLength
+ *                receives the length of the data [REQUIRED]
+ * @return EXECUTION_OK or ERROR_EXPORT_SERIAL_NUMBERS_FAILED if no memory could be allocated
+ */
+short int keyManagerExportSerialNumbers(struct KeyManager *manager,
+                                        unsigned char **data,
+                                        size_t *dataLength);
+
+/**
+ * Returns the TAR archive of the certificates of the keys that have been in use.
+ * @param[in] manager
+ *                opened key manager [REQUIRED]
+ * @param[out] data
+ *                receives the archive, which is released with free [REQUIRED]
+ * @param[out] dataLength
+ *                receives the length of the archive [REQUIRED]
+ * @return EXECUTION_OK or ERROR_EXPORT_CERT_FAILED if the archive could not be built
+ */
+short int keyManagerExportCertificates(struct KeyManager *manager,
+                                       unsigned char **data,
+                                       size_t *dataLength);
+
+/**
+ * Stops the provisioning and releases the memory of the key manager.
+ * @param[in] manager
+ *                opened key manager [REQUIRED]
+ */
+void keyManagerClose(struct KeyManager *manager);
+
+#endif
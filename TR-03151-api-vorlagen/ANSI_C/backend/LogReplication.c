@@ -0,0 +1,715 @@
+#include <errno.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include "Crc32.h"
+#include "LogReplication.h"
+
+#define LOG_REPLICATION_POSITION_MAGIC 0x50505253u
+#define LOG_REPLICATION_RECORD_MAGIC 0x52505253u
+#define LOG_REPLICATION_ACKNOWLEDGMENT_MAGIC 0x41505253u
+
+/**
+ * Header of a shipped log message, followed by the clientId and the payload. The checksum covers the header with
+ * crc set to 0, the clientId and the payload.
+ */
+struct LogReplicationRecord {
+    uint32_t magic;
+    uint32_t crc;
+    uint64_t signatureCounter;
+    uint64_t transactionNumber;
+    int64_t logTime;
+    uint32_t type;
+    uint32_t operation;
+    uint32_t clientIdLength;
+    uint32_t payloadLength;
+};
+
+/**
+ * Position sent by the standby after a connection has been accepted and acknowledgment sent after appended log
+ * messages
+ */
+struct LogReplicationCounter {
+    uint32_t magic;
+    uint32_t padding;
+    uint64_t signatureCounter;
+};
+
+static uint32_t logReplicationChecksum(const struct LogReplicationRecord *header,
+                                       const unsigned char *clientId,
+                                       const unsigned char *payload)
+{
+    struct LogReplicationRecord copy = *header;
+    uint32_t crc;
+
+    copy.crc = 0;
+    crc = crc32Update(0, &copy, sizeof copy);
+    crc = crc32Update(crc, clientId, copy.clientIdLength);
+    return crc32Update(crc, payload, copy.payloadLength);
+}
+
+static short int logReplicationAddress(const char *socketPath,
+                                       struct sockaddr_un *address)
+{
+    size_t length = strlen(socketPath);
+
+    memset(address, 0, sizeof *address);
+    address->sun_family = AF_UNIX;
+    if (length == 0 || length >= sizeof address->sun_path) {
+        return ERROR_PARAMETER_MISMATCH;
+    }
+    memcpy(address->sun_path, socketPath, length);
+    return EXECUTION_OK;
+}
+
+/**
+ * Reads and discards the value of an eventfd, so that it no longer reports being readable.
+ */
+static void logReplicationClearWake(int wakeFd)
+{
+    uint64_t value;
+
+    if (read(wakeFd, &value, sizeof value) < 0) {
+        /* EAGAIN: there was nothing to clear */
+    }
+}
+
+static void logReplicationWake(int wakeFd)
+{
+    uint64_t value = 1;
+
+    if (write(wakeFd, &value, sizeof value) < 0) {
+        /* the counter of the eventfd is already set */
+    }
+}
+
+static void logShipperDisconnect(struct LogShipper *shipper)
+{
+    close(shipper->socketFd);
+    shipper->socketFd = -1;
+    shipper->bufferFill = 0;
+    shipper->acknowledgmentFill = 0;
+    pthread_mutex_lock(&shipper->lock);
+    shipper->connected = false;
+    pthread_cond_broadcast(&shipper->acknowledged);
+    pthread_mutex_unlock(&shipper->lock);
+}
+
+/**
+ * Reads the acknowledgments that the standby has sent so far and wakes up the waiting appenders.
+ */
+static short int logShipperReceive(struct LogShipper *shipper)
+{
+    unsigned char data[64 * sizeof(struct LogReplicationCounter)];
+    uint64_t acknowledged = 0;
+    size_t position = 0;
+    ssize_t received;
+
+    received = recv(shipper->socketFd, data, sizeof data, MSG_DONTWAIT);
+    if (received == 0 || (received < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+        return ERROR_STORAGE_FAILURE;
+    }
+    while (received > 0 && position < (size_t) received) {
+        struct LogReplicationCounter counter;
+        size_t length = sizeof counter - shipper->acknowledgmentFill;
+
+        if (length > (size_t) received - position) {
+            length = (size_t) received - position;
+        }
+        memcpy(shipper->acknowledgment + shipper->acknowledgmentFill, data + position, length);
+        shipper->acknowledgmentFill += length;
+        position += length;
+        if (shipper->acknowledgmentFill == sizeof counter) {
+            memcpy(&counter, shipper->acknowledgment, sizeof counter);
+            if (counter.magic != LOG_REPLICATION_ACKNOWLEDGMENT_MAGIC) {
+                return ERROR_STORAGE_FAILURE;
+            }
+            acknowledged = counter.signatureCounter;
+            shipper->acknowledgmentFill = 0;
+        }
+    }
+    if (acknowledged != 0) {
+        pthread_mutex_lock(&shipper->lock);
+        if (acknowledged > shipper->acknowledgedSignatureCounter) {
+            shipper->acknowledgedSignatureCounter = acknowledged;
+        }
+        if (shipper->acknowledgedSignatureCounter >= atomic_load(&shipper->appendedSignatureCounter)) {
+            shipper->lagging = false;
+        }
+        pthread_cond_broadcast(&shipper->acknowledged);
+        pthread_mutex_unlock(&shipper->lock);
+    }
+    return EXECUTION_OK;
+}
+
+/**
+ * Sends data to the standby. While the socket buffer is full, acknowledgments are read, so that neither side can
+ * block the other; a stop request aborts the sending.
+ */
+static short int logShipperSend(struct LogShipper *shipper,
+                                const void *data,
+                                size_t dataLength)
+{
+    const unsigned char *position = (const unsigned char *) data;
+
+    while (dataLength > 0) {
+        struct pollfd descriptors[2];
+        ssize_t sent = send(shipper->socketFd, position, dataLength, MSG_NOSIGNAL | MSG_DONTWAIT);
+
+        if (sent > 0) {
+            position += sent;
+            dataLength -= (size_t) sent;
+            continue;
+        }
+        if (sent < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+            return ERROR_STORAGE_FAILURE;
+        }
+        descriptors[0].fd = shipper->socketFd;
+        descriptors[0].events = POLLOUT | POLLIN;
+        descriptors[1].fd = shipper->wakeFd;
+        descriptors[1].events = POLLIN;
+        if (poll(descriptors, 2, -1) < 0 && errno != EINTR) {
+            return ERROR_STORAGE_FAILURE;
+        }
+        if (descriptors[1].revents & POLLIN) {
+            logReplicationClearWake(shipper->wakeFd);
+        }
+        if (atomic_load(&shipper->stopping)) {
+            return ERROR_STORAGE_FAILURE;
+        }
+        if ((descriptors[0].revents & (POLLIN | POLLHUP | POLLERR)) && logShipperReceive(shipper) != EXECUTION_OK) {
+            return ERROR_STORAGE_FAILURE;
+        }
+    }
+    return EXECUTION_OK;
+}
+
+static short int logShipperFlush(struct LogShipper *shipper)
+{
+    short int result = logShipperSend(shipper, shipper->buffer, shipper->bufferFill);
+
+    shipper->bufferFill = 0;
+    return result;
+}
+
+/**
+ * Adds a log message to the send buffer. Log messages that do not fit into the buffer are sent directly.
+ */
+static short int logShipperAdd(struct LogShipper *shipper,
+                               const struct LogRecord *record)
+{
+    struct LogReplicationRecord header;
+    size_t length = sizeof header + record->clientIdLength + record->payloadLength;
+    short int result = EXECUTION_OK;
+
+    header.magic = LOG_REPLICATION_RECORD_MAGIC;
+    header.signatureCounter = record->signatureCounter;
+    header.transactionNumber = record->transactionNumber;
+    header.logTime = record->logTime;
+    header.type = (uint32_t) record->type;
+    header.operation = (uint32_t) record->operation;
+    header.clientIdLength = (uint32_t) record->clientIdLength;
+    header.payloadLength = (uint32_t) record->payloadLength;
+    header.crc = logReplicationChecksum(&header, record->clientId, record->payload);
+
+    if (length > LOG_REPLICATION_BUFFER_SIZE - shipper->bufferFill) {
+        result = logShipperFlush(shipper);
+    }
+    if (result != EXECUTION_OK) {
+        return result;
+    }
+    if (length > LOG_REPLICATION_BUFFER_SIZE) {
+        result = logShipperSend(shipper, &header, sizeof header);
+        if (result == EXECUTION_OK) {
+            result = logShipperSend(shipper, record->clientId, record->clientIdLength);
+        }
+        if (result == EXECUTION_OK) {
+            result = logShipperSend(shipper, record->payload, record->payloadLength);
+        }
+        return result;
+    }
+    memcpy(shipper->buffer + shipper->bufferFill, &header, sizeof header);
+    if (record->clientIdLength > 0) {
+        memcpy(shipper->buffer + shipper->bufferFill + sizeof header, record->clientId, record->clientIdLength);
+    }
+    if (record->payloadLength > 0) {
+        memcpy(shipper->buffer + shipper->bufferFill + sizeof header + record->clientIdLength, record->payload,
+               record->payloadLength);
+    }
+    shipper->bufferFill += length;
+    return EXECUTION_OK;
+}
+
+/**
+ * Sends all stored log messages after the shipped position. The segments are read from a copy of the index
+ * entries; the active segment is read from the offset at which the previous pass has stopped, unless it has been
+ * rewritten since.
+ */
+static short int logShipperShip(struct LogShipper *shipper)
+{
+    struct SegmentInfo *segments;
+    size_t segmentCount;
+    size_t i;
+    uint64_t lastSignatureCounter = 0;
+    short int result = EXECUTION_OK;
+
+    if (logStoreSnapshotSegments(shipper->store, &segments, &segmentCount) != EXECUTION_OK) {
+        return ERROR_STORAGE_FAILURE;
+    }
+    for (i = 0; i < segmentCount && result == EXECUTION_OK; i++) {
+        const struct SegmentInfo *info = &segments[i];
+        struct SegmentReader reader;
+        struct LogRecord record;
+        bool endOfSegment = false;
+        uint64_t offset = 0;
+
+        if (info->recordCount == 0) {
+            continue;
+        }
+        lastSignatureCounter = info->lastSignatureCounter;
+        if (info->lastSignatureCounter <= shipper->shippedSignatureCounter) {
+            continue;
+        }
+        if (info->id == shipper->cursorSegmentId && info->firstSignatureCounter == shipper->cursorFirstSignatureCounter
+            && shipper->cursorOffset <= info->length) {
+            offset = shipper->cursorOffset;
+        }
+        if (segmentReaderOpen(&reader, shipper->store, info->id, offset) != EXECUTION_OK) {
+            result = ERROR_STORAGE_FAILURE;
+            break;
+        }
+        reader.limit = info->length;
+        for (;;) {
+            result = segmentReaderNext(&reader, &record, &endOfSegment);
+            if (result != EXECUTION_OK || endOfSegment) {
+                break;
+            }
+            if (record.signatureCounter > shipper->shippedSignatureCounter) {
+                result = logShipperAdd(shipper, &record);
+                if (result != EXECUTION_OK) {
+                    break;
+                }
+                shipper->shippedSignatureCounter = record.signatureCounter;
+            }
+        }
+        shipper->cursorSegmentId = info->id;
+        shipper->cursorFirstSignatureCounter = info->firstSignatureCounter;
+        shipper->cursorOffset = reader.offset;
+        segmentReaderClose(&reader);
+    }
+    logStoreReleaseSnapshot(shipper->store, segments);
+    if (result == EXECUTION_OK) {
+        result = logShipperFlush(shipper);
+    }
+    /* log messages that have been retired before they could be shipped are skipped */
+    if (result == EXECUTION_OK && lastSignatureCounter > shipper->shippedSignatureCounter) {
+        shipper->shippedSignatureCounter = lastSignatureCounter;
+    }
+    return result;
+}
+
+/**
+ * Connects to the standby and reads its position, from which the shipping is resumed.
+ */
+static short int logShipperConnect(struct LogShipper *shipper)
+{
+    struct sockaddr_un address;
+    struct LogReplicationCounter position;
+    struct pollfd descriptor;
+
+    logReplicationAddress(shipper->socketPath, &address);
+    shipper->socketFd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (shipper->socketFd < 0) {
+        return ERROR_STORAGE_FAILURE;
+    }
+    descriptor.fd = shipper->socketFd;
+    descriptor.events = POLLIN;
+    if (connect(shipper->socketFd, (const struct sockaddr *) &address, sizeof address) != 0
+        || poll(&descriptor, 1, LOG_REPLICATION_RETRY_INTERVAL) != 1
+        || recv(shipper->socketFd, &position, sizeof position, MSG_WAITALL) != (ssize_t) sizeof position
+        || position.magic != LOG_REPLICATION_POSITION_MAGIC) {
+        close(shipper->socketFd);
+        shipper->socketFd = -1;
+        return ERROR_STORAGE_FAILURE;
+    }
+
+    /* the standby may not have received everything that has been sent, the segments are read again from the start */
+    shipper->shippedSignatureCounter = position.signatureCounter;
+    shipper->cursorFirstSignatureCounter = 0;
+    pthread_mutex_lock(&shipper->lock);
+    shipper->connected = true;
+    shipper->lagging = false;
+    shipper->acknowledgedSignatureCounter = position.signatureCounter;
+    pthread_cond_broadcast(&shipper->acknowledged);
+    pthread_mutex_unlock(&shipper->lock);
+    return EXECUTION_OK;
+}
+
+static void *logShipperRun(void *argument)
+{
+    struct LogShipper *shipper = (struct LogShipper *) argument;
+
+    while (!atomic_load(&shipper->stopping)) {
+        struct pollfd descriptors[2];
+
+        if (shipper->socketFd < 0) {
+            if (logShipperConnect(shipper) != EXECUTION_OK) {
+                descriptors[0].fd = shipper->wakeFd;
+                descriptors[0].events = POLLIN;
+                if (poll(descriptors, 1, LOG_REPLICATION_RETRY_INTERVAL) == 1) {
+                    logReplicationClearWake(shipper->wakeFd);
+                }
+                continue;
+            }
+        }
+        if (logShipperShip(shipper) != EXECUTION_OK) {
+            logShipperDisconnect(shipper);
+            continue;
+        }
+
+        /* the appenders only signal the eventfd while the thread is sleeping */
+        atomic_store(&shipper->sleeping, true);
+        if (atomic_load(&shipper->appendedSignatureCounter) > shipper->shippedSignatureCounter
+            || atomic_load(&shipper->stopping)) {
+            atomic_store(&shipper->sleeping, false);
+            continue;
+        }
+        descriptors[0].fd = shipper->wakeFd;
+        descriptors[0].events = POLLIN;
+        descriptors[1].fd = shipper->socketFd;
+        descriptors[1].events = POLLIN;
+        if (poll(descriptors, 2, -1) < 0 && errno != EINTR) {
+            descriptors[0].revents = 0;
+            descriptors[1].revents = POLLERR;
+        }
+        atomic_store(&shipper->sleeping, false);
+        if (descriptors[0].revents & POLLIN) {
+            logReplicationClearWake(shipper->wakeFd);
+        }
+        if ((descriptors[1].revents & (POLLIN | POLLHUP | POLLERR)) && logShipperReceive(shipper) != EXECUTION_OK) {
+            logShipperDisconnect(shipper);
+        }
+    }
+    if (shipper->socketFd >= 0) {
+        logShipperDisconnect(shipper);
+    }
+    return NULL;
+}
+
+short int logShipperStart(struct LogShipper *shipper,
+                          struct LogStore *store,
+                          const char *socketPath)
+{
+    struct sockaddr_un address;
+    pthread_condattr_t attributes;
+
+    if (shipper == NULL || store == NULL || socketPath == NULL) {
+        return ERROR_PARAMETER_MISMATCH;
+    }
+    if (logReplicationAddress(socketPath, &address) != EXECUTION_OK) {
+        return ERROR_PARAMETER_MISMATCH;
+    }
+    memset(shipper, 0, sizeof *shipper);
+    shipper->store = store;
+    shipper->socketFd = -1;
+    shipper->socketPath = strdup(socketPath);
+    shipper->buffer = malloc(LOG_REPLICATION_BUFFER_SIZE);
+    shipper->wakeFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (shipper->socketPath == NULL || shipper->buffer == NULL || shipper->wakeFd < 0) {
+        free(shipper->socketPath);
+        free(shipper->buffer);
+        if (shipper->wakeFd >= 0) {
+            close(shipper->wakeFd);
+        }
+        return ERROR_STORAGE_FAILURE;
+    }
+    pthread_mutex_lock(&store->lock);
+    atomic_store(&shipper->appendedSignatureCounter, store->lastSignatureCounter);
+    pthread_mutex_unlock(&store->lock);
+    pthread_mutex_init(&shipper->lock, NULL);
+    /* the timeouts of the semi-synchronous mode are not affected by changes of the system time */
+    pthread_condattr_init(&attributes);
+    pthread_condattr_setclock(&attributes, CLOCK_MONOTONIC);
+    pthread_cond_init(&shipper->acknowledged, &attributes);
+    pthread_condattr_destroy(&attributes);
+    if (pthread_create(&shipper->thread, NULL, logShipperRun, shipper) != 0) {
+        pthread_cond_destroy(&shipper->acknowledged);
+        pthread_mutex_destroy(&shipper->lock);
+        close(shipper->wakeFd);
+        free(shipper->buffer);
+        free(shipper->socketPath);
+        return ERROR_STORAGE_FAILURE;
+    }
+    return EXECUTION_OK;
+}
+
+void logShipperNotify(struct LogShipper *shipper,
+                      uint64_t signatureCounter)
+{
+    atomic_store(&shipper->appendedSignatureCounter, signatureCounter);
+    if (atomic_load(&shipper->sleeping)) {
+        logReplicationWake(shipper->wakeFd);
+    }
+}
+
+bool logShipperWaitAcknowledged(struct LogShipper *shipper,
+                                uint64_t signatureCounter,
+                                unsigned int timeout)
+{
+    struct timespec deadline;
+    bool acknowledged;
+
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    deadline.tv_sec += (time_t) (timeout / 1000u);
+    deadline.tv_nsec += (long) (timeout % 1000u) * 1000000l;
+    if (deadline.tv_nsec >= 1000000000l) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000l;
+    }
+    pthread_mutex_lock(&shipper->lock);
+    while (shipper->connected && !shipper->lagging && shipper->acknowledgedSignatureCounter < signatureCounter) {
+        if (pthread_cond_timedwait(&shipper->acknowledged, &shipper->lock, &deadline) == ETIMEDOUT) {
+            /* continue asynchronously until the standby has caught up */
+            shipper->lagging = shipper->acknowledgedSignatureCounter < signatureCounter;
+            break;
+        }
+    }
+    acknowledged = shipper->acknowledgedSignatureCounter >= signatureCounter;
+    pthread_mutex_unlock(&shipper->lock);
+    return acknowledged;
+}
+
+void logShipperStop(struct LogShipper *shipper)
+{
+    atomic_store(&shipper->stopping, true);
+    logReplicationWake(shipper->wakeFd);
+    pthread_join(shipper->thread, NULL);
+    pthread_cond_destroy(&shipper->acknowledged);
+    pthread_mutex_destroy(&shipper->lock);
+    close(shipper->wakeFd);
+    free(shipper->buffer);
+    free(shipper->socketPath);
+}
+
+static short int logReceiverAcknowledge(int connectionFd,
+                                        uint32_t magic,
+                                        uint64_t signatureCounter)
+{
+    struct LogReplicationCounter counter;
+
+    counter.magic = magic;
+    counter.padding = 0;
+    counter.signatureCounter = signatureCounter;
+    return send(connectionFd, &counter, sizeof counter, MSG_NOSIGNAL) == (ssize_t) sizeof counter
+           ? EXECUTION_OK : ERROR_STORAGE_FAILURE;
+}
+
+/**
+ * Appends the complete log messages in the receive buffer to the store. The number of consumed bytes is returned
+ * in consumed, the size of an incomplete log message that does not fit into the buffer in required.
+ */
+static short int logReceiverAppend(struct LogReceiver *receiver,
+                                   size_t fill,
+                                   uint64_t *lastSignatureCounter,
+                                   size_t *consumed,
+                                   size_t *required)
+{
+    size_t position = 0;
+
+    *required = 0;
+    while (fill - position >= sizeof(struct LogReplicationRecord)) {
+        struct LogReplicationRecord header;
+        struct LogRecord record;
+        const unsigned char *clientId;
+        size_t length;
+
+        memcpy(&header, receiver->buffer + position, sizeof header);
+        if (header.magic != LOG_REPLICATION_RECORD_MAGIC || header.type > auditLogMessage
+            || header.operation > finishTransactionOperation || header.clientIdLength > TRANSACTION_CLIENT_ID_MAX
+            || header.payloadLength > LOG_STORE_MAX_PAYLOAD_LENGTH) {
+            /* the lengths are checked before the checksum, as they determine how much is received */
+            return ERROR_STORAGE_FAILURE;
+        }
+        length = sizeof header + header.clientIdLength + header.payloadLength;
+        if (fill - position < length) {
+            *required = length;
+            break;
+        }
+        clientId = receiver->buffer + position + sizeof header;
+        if (header.crc != logReplicationChecksum(&header, clientId, clientId + header.clientIdLength)) {
+            return ERROR_STORAGE_FAILURE;
+        }
+        position += length;
+        if (header.signatureCounter <= *lastSignatureCounter) {
+            continue;
+        }
+
+        record.signatureCounter = header.signatureCounter;
+        record.transactionNumber = header.transactionNumber;
+        record.logTime = header.logTime;
+        record.type = (enum LogMessageType) header.type;
+        record.operation = (enum TransactionOperation) header.operation;
+        record.clientId = clientId;
+        record.clientIdLength = header.clientIdLength;
+        record.payload = clientId + header.clientIdLength;
+        record.payloadLength = header.payloadLength;
+        switch (logStoreAppend(receiver->store, &record)) {
+        case EXECUTION_OK:
+            break;
+        case ERROR_NO_TRANSACTION:
+            /* the start of the transaction has been retired on the primary before it could be shipped */
+            receiver->skippedRecordCount++;
+            break;
+        default:
+            return ERROR_STORAGE_FAILURE;
+        }
+        *lastSignatureCounter = header.signatureCounter;
+    }
+    *consumed = position;
+    return EXECUTION_OK;
+}
+
+/**
+ * Receives log messages from a connected primary until the connection is closed or the receiver is stopped.
+ */
+static void logReceiverServe(struct LogReceiver *receiver,
+                             int connectionFd)
+{
+    uint64_t lastSignatureCounter;
+    size_t fill = 0;
+
+    pthread_mutex_lock(&receiver->store->lock);
+    lastSignatureCounter = receiver->store->lastSignatureCounter;
+    pthread_mutex_unlock(&receiver->store->lock);
+    if (logReceiverAcknowledge(connectionFd, LOG_REPLICATION_POSITION_MAGIC, lastSignatureCounter) != EXECUTION_OK) {
+        return;
+    }
+
+    for (;;) {
+        struct pollfd descriptors[2];
+        uint64_t acknowledged = lastSignatureCounter;
+        size_t consumed;
+        size_t required;
+        ssize_t received;
+
+        descriptors[0].fd = connectionFd;
+        descriptors[0].events = POLLIN;
+        descriptors[1].fd = receiver->wakeFd;
+        descriptors[1].events = POLLIN;
+        if (poll(descriptors, 2, -1) < 0 && errno != EINTR) {
+            return;
+        }
+        if (atomic_load(&receiver->stopping)) {
+            return;
+        }
+        received = recv(connectionFd, receiver->buffer + fill, receiver->bufferSize - fill, MSG_DONTWAIT);
+        if (received == 0 || (received < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+            return;
+        }
+        if (received < 0) {
+            continue;
+        }
+        fill += (size_t) received;
+
+        if (logReceiverAppend(receiver, fill, &lastSignatureCounter, &consumed, &required) != EXECUTION_OK) {
+            return;
+        }
+        fill -= consumed;
+        memmove(receiver->buffer, receiver->buffer + consumed, fill);
+        if (required > receiver->bufferSize) {
+            unsigned char *buffer = realloc(receiver->buffer, required);
+
+            if (buffer == NULL) {
+                return;
+            }
+            receiver->buffer = buffer;
+            receiver->bufferSize = required;
+        }
+        if (lastSignatureCounter != acknowledged
+            && logReceiverAcknowledge(connectionFd, LOG_REPLICATION_ACKNOWLEDGMENT_MAGIC, lastSignatureCounter)
+               != EXECUTION_OK) {
+            return;
+        }
+    }
+}
+
+static void *logReceiverRun(void *argument)
+{
+    struct LogReceiver *receiver = (struct LogReceiver *) argument;
+
+    while (!atomic_load(&receiver->stopping)) {
+        struct pollfd descriptors[2];
+        int connectionFd;
+
+        descriptors[0].fd = receiver->listenFd;
+        descriptors[0].events = POLLIN;
+        descriptors[1].fd = receiver->wakeFd;
+        descriptors[1].events = POLLIN;
+        if ((poll(descriptors, 2, -1) < 0 && errno != EINTR) || atomic_load(&receiver->stopping)) {
+            break;
+        }
+        connectionFd = accept4(receiver->listenFd, NULL, NULL, SOCK_CLOEXEC);
+        if (connectionFd >= 0) {
+            logReceiverServe(receiver, connectionFd);
+            close(connectionFd);
+        }
+    }
+    return NULL;
+}
+
+short int logReceiverStart(struct LogReceiver *receiver,
+                           struct LogStore *store,
+                           const char *socketPath)
+{
+    struct sockaddr_un address;
+
+    if (receiver == NULL || store == NULL || socketPath == NULL) {
+        return ERROR_PARAMETER_MISMATCH;
+    }
+    if (logReplicationAddress(socketPath, &address) != EXECUTION_OK) {
+        return ERROR_PARAMETER_MISMATCH;
+    }
+    memset(receiver, 0, sizeof *receiver);
+    receiver->store = store;
+    receiver->bufferSize = LOG_REPLICATION_BUFFER_SIZE;
+    receiver->socketPath = strdup(socketPath);
+    receiver->buffer = malloc(receiver->bufferSize);
+    receiver->wakeFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    receiver->listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (receiver->socketPath != NULL && receiver->listenFd >= 0) {
+        unlink(socketPath);
+    }
+    if (receiver->socketPath == NULL || receiver->buffer == NULL || receiver->wakeFd < 0 || receiver->listenFd < 0
+        || bind(receiver->listenFd, (const struct sockaddr *) &address, sizeof address) != 0
+        || listen(receiver->listenFd, 1) != 0
+        || pthread_create(&receiver->thread, NULL, logReceiverRun, receiver) != 0) {
+        if (receiver->listenFd >= 0) {
+            close(receiver->listenFd);
+        }
+        if (receiver->wakeFd >= 0) {
+            close(receiver->wakeFd);
+        }
+        free(receiver->buffer);
+        free(receiver->socketPath);
+        return ERROR_STORAGE_FAILURE;
+    }
+    return EXECUTION_OK;
+}
+
+void logReceiverStop(struct LogReceiver *receiver)
+{
+    atomic_store(&receiver->stopping, true);
+    logReplicationWake(receiver->wakeFd);
+    pthread_join(receiver->thread, NULL);
+    close(receiver->listenFd);
+    close(receiver->wakeFd);
+    unlink(receiver->socketPath);
+    free(receiver->buffer);
+    free(receiver->socketPath);
+}
@@ -0,0 +1,177 @@
+#ifndef SEAPI_BACKEND_LOG_REPLICATION_H
+#define SEAPI_BACKEND_LOG_REPLICATION_H
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "../Exception.h"
+#include "../Constant.h"
+#include "LogStore.h"
+
+#if !PROFILE_CONCURRENT
+#error "the replication of the log store requires the server build profile"
+#endif
+
+/**
+ * This header file defines the replication of the log store of the SE API backend to a standby process by log
+ * shipping over a Unix domain socket.
+ *
+ * The standby opens its own log store and listens on the socket with a log receiver. The log shipper of the primary
+ * connects to it, receives the signature counter of the last log message stored by the standby and sends every
+ * later log message: first those that are stored in the segments of the primary, read with a segment reader, then
+ * each new log message after it has been appended. The standby appends the log messages to its store and
+ * acknowledges the signature counter of the last appended one. After a lost connection the shipper reconnects and
+ * resumes after the acknowledged log message, so that neither side has to export or import the stored data.
+ *
+ * The shipping is asynchronous. In the semi-synchronous mode a log message is only reported as stored after the
+ * standby has acknowledged it or after a timeout, after which the shipper continues asynchronously until the
+ * standby has caught up again. The standby store can be used for exports while it receives log messages, and a
+ * failover consists of stopping the receiver and opening the backend on the standby store. Log messages that have
+ * been deleted on the primary before they could be shipped are missing on the standby, as well as later log messages
+ * of transactions whose start is missing; the latter are counted in skippedRecordCount of the receiver.
+ *
+ * Messages on the socket (all integers in the byte order of the host):
+ *
+ *     standby -> primary   position       magic SRPP, signature counter of the last stored log message
+ *     primary -> standby   log message    header with magic SRPR and checksum, clientId, payload
+ *     standby -> primary   acknowledgment magic SRPA, signature counter of the last appended log message
+ */
+
+/**
+ * Interval in milliseconds after which the shipper tries to connect again
+ */
+#define LOG_REPLICATION_RETRY_INTERVAL 1000
+
+/**
+ * Size of the send buffer of the shipper and of the receive buffer of the receiver
+ */
+#define LOG_REPLICATION_BUFFER_SIZE (256u * 1024u)
+
+/**
+ * State of the log shipper of the primary. The members are managed by the functions of this header file.
+ */
+struct LogShipper {
+    struct LogStore *store;
+    char *socketPath;
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t acknowledged;
+    int wakeFd;
+    int socketFd;
+    atomic_bool sleeping;
+    atomic_bool stopping;
+    _Atomic uint64_t appendedSignatureCounter;
+    uint64_t acknowledgedSignatureCounter;
+    bool connected;
+    bool lagging;
+    uint32_t cursorSegmentId;
+    uint64_t cursorOffset;
+    uint64_t cursorFirstSignatureCounter;
+    uint64_t shippedSignatureCounter;
+    unsigned char *buffer;
+    size_t bufferFill;
+    unsigned char acknowledgment[16];
+    size_t acknowledgmentFill;
+};
+
+/**
+ * State of the log receiver of the standby. The members are managed by the functions of this header file.
+ */
+struct LogReceiver {
+    struct LogStore *store;
+    char *socketPath;
+    pthread_t thread;
+    int listenFd;
+    int wakeFd;
+    atomic_bool stopping;
+    uint64_t skippedRecordCount;
+    unsigned char *buffer;
+    size_t bufferSize;
+};
+
+/**
+ * Starts the shipper thread of the primary.
+ * @param[out] shipper
+ *                shipper to be started [REQUIRED]
+ * @param[in] store
+ *                opened store, which MUST stay open until the shipper has been stopped [REQUIRED]
+ * @param[in] socketPath
+ *                path of the Unix domain socket of the receiver, terminated by NUL [REQUIRED]
+ * @return if the execution of the function has been successful, the return value EXECUTION_OK SHALL be returned.
+ *
+ *         If the execution of the function has failed, the appropriate error code SHALL be returned:
+ *
+ *             ERROR_PARAMETER_MISMATCH
+ *                the socket path is too long
+ *             ERROR_STORAGE_FAILURE
+ *                no memory could be allocated or the thread could not be created
+ */
+short int logShipperStart(struct LogShipper *shipper,
+                          struct LogStore *store,
+                          const char *socketPath);
+
+/**
+ * Notifies the shipper that a log message has been appended to the store. The shipper thread is only woken up if
+ * it waits for new log messages.
+ * @param[in] shipper
+ *                started shipper [REQUIRED]
+ * @param[in] signatureCounter
+ *                signature counter of the appended log message [REQUIRED]
+ */
+void logShipperNotify(struct LogShipper *shipper,
+                      uint64_t signatureCounter);
+
+/**
+ * Waits until the standby has acknowledged a log message (semi-synchronous mode). The function returns immediately
+ * if no standby is connected or if the standby has not caught up since the last timeout.
+ * @param[in] shipper
+ *                started shipper [REQUIRED]
+ * @param[in] signatureCounter
+ *                signature counter of the log message [REQUIRED]
+ * @param[in] timeout
+ *                maximum waiting time in milliseconds [REQUIRED]
+ * @return true if the standby has acknowledged the log message
+ */
+bool logShipperWaitAcknowledged(struct LogShipper *shipper,
+                                uint64_t signatureCounter,
+                                unsigned int timeout);
+
+/**
+ * Stops the shipper thread and releases its resources.
+ * @param[in] shipper
+ *                started shipper [REQUIRED]
+ */
+void logShipperStop(struct LogShipper *shipper);
+
+/**
+ * Starts the receiver thread of the standby, which listens on the socket and accepts one primary at a time.
+ * An existing socket file at the path is replaced.
+ * @param[out] receiver
+ *                receiver to be started [REQUIRED]
+ * @param[in] store
+ *                opened store of the standby, which MUST stay open until the receiver has been stopped [REQUIRED]
+ * @param[in] socketPath
+ *                path of the Unix domain socket, terminated by NUL [REQUIRED]
+ * @return if the execution of the function has been successful, the return value EXECUTION_OK SHALL be returned.
+ *
+ *         If the execution of the function has failed, the appropriate error code SHALL be returned:
+ *
+ *             ERROR_PARAMETER_MISMATCH
+ *                the socket path is too long
+ *             ERROR_STORAGE_FAILURE
+ *                the socket could not be created, no memory could be allocated or the thread could not be created
+ */
+short int logReceiverStart(struct LogReceiver *receiver,
+                           struct LogStore *store,
+                           const char *socketPath);
+
+/**
+ * Stops the receiver thread, closes the connection and removes the socket file.
+ * @param[in] receiver
+ *                started receiver [REQUIRED]
+ */
+void logReceiverStop(struct LogReceiver *receiver);
+
+#endif
@@ -0,0 +1,1937 @@
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include "LogStore.h"
+#include "Crc32.h"
+
+/**
+ * Identifies a record in a segment file ("SLOG")
+ */
+#define LOG_RECORD_MAGIC 0x534C4F47u
+
+/**
+ * Identifies a checkpoint file ("SCKP") and its layout version
+ */
+#define CHECKPOINT_MAGIC 0x53434B50u
+#define CHECKPOINT_VERSION 3u
+
+#define CHECKPOINT_FILE_NAME "index.ckp"
+#define CERTIFICATE_DIRECTORY_NAME "certificates"
+#define CHECKPOINT_TEMPORARY_FILE_NAME "index.ckp.tmp"
+#define SEGMENT_FILE_FORMAT "segment-%08x.log"
+#define SEGMENT_COMPACT_FILE_FORMAT "segment-%08x.log.compact"
+#define SEGMENT_COMPACT_BUFFER_SIZE (256u * 1024u)
+
+/**
+ * Layout of the header that precedes the clientId and the payload of every record in a segment file.
+ * The checksum covers the header from the member signatureCounter on, the clientId and the payload.
+ */
+struct LogRecordHeader {
+    uint32_t magic;
+    uint32_t crc;
+    uint64_t signatureCounter;
+    uint64_t transactionNumber;
+    int64_t logTime;
+    uint32_t payloadLength;
+    uint16_t clientIdLength;
+    uint8_t type;
+    uint8_t operation;
+};
+
+/**
+ * Layout of the header of the checkpoint file. It is followed by segmentCount index entries and
+ * openTransactionCount open transactions. The checksum covers the whole file with the member crc set to 0.
+ */
+struct CheckpointHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t segmentCount;
+    uint64_t openTransactionCount;
+    uint64_t lastSignatureCounter;
+    uint64_t lastTransactionNumber;
+    uint64_t exportedSignatureCounter;
+    uint64_t deletableSignatureCounter;
+    uint32_t crc;
+    uint32_t padding;
+};
+
+/**
+ * Work item of the recovery for one segment. The transactions started in the segment and not finished within it
+ * are collected in opened, the transactions of earlier segments that are updated or finished are collected in
+ * touched, so that the results of the segments can be applied in order after the parallel scan.
+ */
+struct SegmentScanJob {
+    uint32_t segmentId;
+    uint64_t offset;
+    struct SegmentInfo info;
+    struct TransactionTable opened;
+    struct TransactionTable touched;
+    uint64_t maxTransactionNumber;
+    bool truncated;
+    short int result;
+};
+
+struct SegmentScanContext {
+    struct LogStore *store;
+    struct SegmentScanJob *jobs;
+    size_t jobCount;
+    size_t nextJob;
+    pthread_mutex_t lock;
+};
+
+static uint32_t logRecordChecksum(const struct LogRecordHeader *header,
+                                  const unsigned char *clientId,
+                                  const unsigned char *payload)
+{
+    uint32_t crc = crc32Update(0, &header->signatureCounter,
+                               sizeof *header - offsetof(struct LogRecordHeader, signatureCounter));
+    crc = crc32Update(crc, clientId, header->clientIdLength);
+    return crc32Update(crc, payload, header->payloadLength);
+}
+
+static void logRecordHeaderInit(struct LogRecordHeader *header,
+                                const struct LogRecord *record)
+{
+    memset(header, 0, sizeof *header);
+    header->magic = LOG_RECORD_MAGIC;
+    header->signatureCounter = record->signatureCounter;
+    header->transactionNumber = record->transactionNumber;
+    header->logTime = record->logTime;
+    header->payloadLength = (uint32_t) record->payloadLength;
+    header->clientIdLength = (uint16_t) record->clientIdLength;
+    header->type = (uint8_t) record->type;
+    header->operation = (uint8_t) record->operation;
+    header->crc = logRecordChecksum(header, record->clientId, record->payload);
+}
+
+static short int logStoreWriteVector(int fd,
+                                     struct iovec *vector,
+                                     int vectorCount)
+{
+    while (vectorCount > 0) {
+        ssize_t written = writev(fd, vector, vectorCount);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return ERROR_STORAGE_FAILURE;
+        }
+        while (vectorCount > 0 && (size_t) written >= vector->iov_len) {
+            written -= (ssize_t) vector->iov_len;
+            vector++;
+            vectorCount--;
+        }
+        if (vectorCount > 0) {
+            vector->iov_base = (unsigned char *) vector->iov_base + written;
+            vector->iov_len -= (size_t) written;
+        }
+    }
+    return EXECUTION_OK;
+}
+
+static short int logStoreSyncDirectory(const char *directory)
+{
+    int fd = open(directory, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    short int result = EXECUTION_OK;
+
+    if (fd < 0) {
+        return ERROR_STORAGE_FAILURE;
+    }
+    if (fsync(fd) != 0) {
+        result = ERROR_STORAGE_FAILURE;
+    }
+    close(fd);
+    return result;
+}
+
+static void segmentInfoAdd(struct SegmentInfo *info,
+                           const struct LogRecord *record,
+                           uint64_t recordLength)
+{
+    if (info->recordCount == 0) {
+        info->firstSignatureCounter = record->signatureCounter;
+        info->minLogTime = record->logTime;
+        info->maxLogTime = record->logTime;
+    }
+    info->lastSignatureCounter = record->signatureCounter;
+    if (record->logTime < info->minLogTime) {
+        info->minLogTime = record->logTime;
+    }
+    if (record->logTime > info->maxLogTime) {
+        info->maxLogTime = record->logTime;
+    }
+    if (record->type == transactionLogMessage) {
+        if (info->transactionRecordCount == 0 || record->transactionNumber < info->minTransactionNumber) {
+            info->minTransactionNumber = record->transactionNumber;
+        }
+        if (info->transactionRecordCount == 0 || record->transactionNumber > info->maxTransactionNumber) {
+            info->maxTransactionNumber = record->transactionNumber;
+        }
+        info->transactionRecordCount++;
+    }
+    info->recordCount++;
+    info->length += recordLength;
+}
+
+static void openTransactionFromRecord(struct OpenTransaction *entry,
+                                      const struct LogRecord *record)
+{
+    memset(entry, 0, sizeof *entry);
+    entry->transactionNumber = record->transactionNumber;
+    entry->lastSignatureCounter = record->signatureCounter;
+    entry->startTime = record->logTime;
+    entry->lastUpdateTime = record->logTime;
+    entry->clientIdLength = (uint16_t) record->clientIdLength;
+    memcpy(entry->clientId, record->clientId, record->clientIdLength);
+}
+
+static short int logStoreGrowSegments(struct LogStore *store,
+                                      size_t required)
+{
+    struct SegmentInfo *segments;
+    struct SegmentCountEntry *counts;
+    size_t capacity = store->segmentCapacity != 0 ? store->segmentCapacity : 16;
+
+    if (required <= store->segmentCapacity) {
+        return EXECUTION_OK;
+    }
+    while (capacity < required) {
+        capacity *= 2;
+    }
+    segments = realloc(store->segments, capacity * sizeof *segments);
+    if (segments == NULL) {
+        return ERROR_STORAGE_FAILURE;
+    }
+    store->segments = segments;
+    counts = realloc(store->segmentCounts, capacity * sizeof *counts);
+    if (counts == NULL) {
+        return ERROR_STORAGE_FAILURE;
+    }
+    store->segmentCounts = counts;
+    store->segmentCapacity = capacity;
+    return EXECUTION_OK;
+}
+
+short int logStoreSegmentPath(const struct LogStore *store,
+                              uint32_t segmentId,
+                              char *path,
+                              size_t pathSize)
+{
+    int length = snprintf(path, pathSize, "%s/" SEGMENT_FILE_FORMAT, store->directory, segmentId);
+
+    if (length < 0 || (size_t) length >= pathSize) {
+        return ERROR_PARAMETER_MISMATCH;
+    }
+    return EXECUTION_OK;
+}
+
+static short int logStoreFilePath(const struct LogStore *store,
+                                  const char *name,
+                                  char *path,
+                                  size_t pathSize)
+{
+    int length = snprintf(path, pathSize, "%s/%s", store->directory, name);
+
+    if (length < 0 || (size_t) length >= pathSize) {
+        return ERROR_PARAMETER_MISMATCH;
+    }
+    return EXECUTION_OK;
+}
+
+static bool segmentReaderFill(struct SegmentReader *reader,
+                              size_t required,
+                              short int *result)
+{
+    size_t available = reader->bufferFill - reader->bufferPosition;
+    uint64_t bufferStart;
+
+    *result = EXECUTION_OK;
+    if (available >= required) {
+        return true;
+    }
+
+    memmove(reader->buffer, reader->buffer + reader->bufferPosition, available);
+    reader->bufferFill = available;
+    reader->bufferPosition = 0;
+    if (required > reader->bufferSize) {
+        unsigned char *buffer;
+
+        if (reader->bufferIndex >= 0) {
+            /* a record larger than a registered buffer continues in an ordinary buffer */
+            buffer = malloc(required);
+            if (buffer != NULL) {
+                memcpy(buffer, reader->buffer, available);
+                storageIoReleaseBuffer(reader->io, reader->bufferIndex);
+                reader->bufferIndex = -1;
+            }
+        } else {
+            buffer = realloc(reader->buffer, required);
+        }
+        if (buffer == NULL) {
+            *result = ERROR_STORAGE_FAILURE;
+            return false;
+        }
+        reader->buffer = buffer;
+        reader->bufferSize = required;
+    }
+
+    bufferStart = reader->offset;
+    while (reader->bufferFill < required) {
+        size_t readLength;
+
+        *result = storageIoRead(reader->io, reader->fd, reader->buffer + reader->bufferFill,
+                                reader->bufferSize - reader->bufferFill, bufferStart + reader->bufferFill,
+                                reader->bufferIndex, &readLength);
+        if (*result != EXECUTION_OK) {
+            return false;
+        }
+        if (readLength == 0) {
+            return false;
+        }
+        reader->bufferFill += readLength;
+    }
+    return true;
+}
+
+short int segmentReaderOpen(struct SegmentReader *reader,
+                            const struct LogStore *store,
+                            uint32_t segmentId,
+                            uint64_t offset)
+{
+    char path[4096];
+
+    memset(reader, 0, sizeof *reader);
+    reader->bufferIndex = -1;
+    if (logStoreSegmentPath(store, segmentId, path, sizeof path) != EXECUTION_OK) {
+        return ERROR_STORAGE_FAILURE;
+    }
+    reader->fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (reader->fd < 0) {
+        return ERROR_STORAGE_FAILURE;
+    }
+    reader->io = store->io;
+    reader->bufferIndex = storageIoAcquireBuffer(reader->io, &reader->buffer);
+    if (reader->bufferIndex < 0) {
+        reader->buffer = malloc(SEGMENT_READER_BUFFER_SIZE);
+    }
+    if (reader->buffer == NULL) {
+        close(reader->fd);
+        return ERROR_STORAGE_FAILURE;
+    }
+    reader->bufferSize = SEGMENT_READER_BUFFER_SIZE;
+    reader->offset = offset;
+    reader->limit = UINT64_MAX;
+    return EXECUTION_OK;
+}
+
+short int segmentReaderNext(struct SegmentReader *reader,
+                            struct LogRecord *record,
+                            bool *endOfSegment)
+{
+    struct LogRecordHeader header;
+    const unsigned char *clientId;
+    const unsigned char *payload;
+    size_t recordLength;
+    short int result;
+
+    *endOfSegment = false;
+    if (reader->offset >= reader->limit) {
+        *endOfSegment = true;
+        return EXECUTION_OK;
+    }
+    if (!segmentReaderFill(reader, sizeof header, &result)) {
+        *endOfSegment = true;
+        reader->truncated = reader->bufferFill > reader->bufferPosition;
+        return result;
+    }
+
+    memcpy(&header, reader->buffer + reader->bufferPosition, sizeof header);
+    /* the lengths are bounded like those of logStoreAppend before a corrupted header can grow the buffer */
+    if (header.magic != LOG_RECORD_MAGIC || header.type > auditLogMessage
+        || header.operation > finishTransactionOperation || header.clientIdLength > TRANSACTION_CLIENT_ID_MAX
+        || header.payloadLength > LOG_STORE_MAX_PAYLOAD_LENGTH) {
+        *endOfSegment = true;
+        reader->truncated = true;
+        return EXECUTION_OK;
+    }
+
+    recordLength = sizeof header + header.clientIdLength + header.payloadLength;
+    if (!segmentReaderFill(reader, recordLength, &result)) {
+        *endOfSegment = true;
+        reader->truncated = true;
+        return result;
+    }
+
+    clientId = reader->buffer + reader->bufferPosition + sizeof header;
+    payload = clientId + header.clientIdLength;
+    if (header.crc != logRecordChecksum(&header, clientId, payload)) {
+        *endOfSegment = true;
+        reader->truncated = true;
+        return EXECUTION_OK;
+    }
+
+    record->signatureCounter = header.signatureCounter;
+    record->transactionNumber = header.transactionNumber;
+    record->logTime = header.logTime;
+    record->type = (enum LogMessageType) header.type;
+    record->operation = (enum TransactionOperation) header.operation;
+    record->clientId = clientId;
+    record->clientIdLength = header.clientIdLength;
+    record->payload = payload;
+    record->payloadLength = header.payloadLength;
+
+    reader->bufferPosition += recordLength;
+    reader->offset += recordLength;
+    return EXECUTION_OK;
+}
+
+void segmentReaderSeek(struct SegmentReader *reader,
+                       uint64_t offset)
+{
+    uint64_t bufferStart = reader->offset - reader->bufferPosition;
+
+    if (offset >= bufferStart && offset <= bufferStart + reader->bufferFill) {
+        reader->bufferPosition = (size_t) (offset - bufferStart);
+    } else {
+        reader->bufferFill = 0;
+        reader->bufferPosition = 0;
+    }
+    reader->offset = offset;
+}
+
+void segmentReaderClose(struct SegmentReader *reader)
+{
+    if (reader->bufferIndex >= 0) {
+        storageIoReleaseBuffer(reader->io, reader->bufferIndex);
+        reader->bufferIndex = -1;
+    } else {
+        free(reader->buffer);
+    }
+    reader->buffer = NULL;
+    if (reader->fd >= 0) {
+        close(reader->fd);
+        reader->fd = -1;
+    }
+}
+
+static short int segmentScanRecord(struct SegmentScanJob *job,
+                                   const struct LogRecord *record)
+{
+    struct OpenTransaction entry;
+    struct OpenTransaction *existing;
+
+    if (record->type != transactionLogMessage) {
+        return EXECUTION_OK;
+    }
+    if (record->transactionNumber > job->maxTransactionNumber) {
+        job->maxTransactionNumber = record->transactionNumber;
+    }
+
+    switch (record->operation) {
+    case startTransactionOperation:
+        openTransactionFromRecord(&entry, record);
+        return transactionTableInsert(&job->opened, &entry, NULL);
+    case updateTransactionOperation:
+    case finishTransactionOperation:
+        existing = transactionTableFind(&job->opened, record->transactionNumber);
+        if (existing != NULL) {
+            if (record->operation == finishTransactionOperation) {
+                transactionTableRemove(&job->opened, record->transactionNumber);
+            } else {
+                existing->lastSignatureCounter = record->signatureCounter;
+                existing->lastUpdateTime = record->logTime;
+            }
+            return EXECUTION_OK;
+        }
+        openTransactionFromRecord(&entry, record);
+        if (record->operation == finishTransactionOperation) {
+            entry.flags |= OPEN_TRANSACTION_FINISHED;
+        }
+        return transactionTableInsert(&job->touched, &entry, NULL);
+    default:
+        return EXECUTION_OK;
+    }
+}
+
+static void segmentScanJobRun(struct LogStore *store,
+                              struct SegmentScanJob *job)
+{
+    struct SegmentReader reader;
+    struct LogRecord record;
+    bool endOfSegment = false;
+
+    job->result = segmentReaderOpen(&reader, store, job->segmentId, job->offset);
+    if (job->result != EXECUTION_OK) {
+        return;
+    }
+    while (job->result == EXECUTION_OK) {
+        uint64_t recordOffset = reader.offset;
+
+        job->result = segmentReaderNext(&reader, &record, &endOfSegment);
+        if (job->result != EXECUTION_OK || endOfSegment) {
+            break;
+        }
+        segmentInfoAdd(&job->info, &record, reader.offset - recordOffset);
+        job->result = segmentScanRecord(job, &record);
+    }
+    job->truncated = reader.truncated;
+    segmentReaderClose(&reader);
+}
+
+static void *segmentScanWorker(void *argument)
+{
+    struct SegmentScanContext *context = (struct SegmentScanContext *) argument;
+
+    for (;;) {
+        size_t index;
+
+        pthread_mutex_lock(&context->lock);
+        index = context->nextJob++;
+        pthread_mutex_unlock(&context->lock);
+        if (index >= context->jobCount) {
+            return NULL;
+        }
+        segmentScanJobRun(context->store, &context->jobs[index]);
+    }
+}
+
+static short int segmentScanRunParallel(struct SegmentScanContext *context,
+                                        unsigned int threadCount)
+{
+    pthread_t threads[64];
+    unsigned int started = 0;
+    unsigned int i;
+
+    if (threadCount > 64) {
+        threadCount = 64;
+    }
+    if (threadCount > context->jobCount) {
+        threadCount = (unsigned int) context->jobCount;
+    }
+    for (i = 1; i < threadCount; i++) {
+        if (pthread_create(&threads[started], NULL, segmentScanWorker, context) == 0) {
+            started++;
+        }
+    }
+    /* the calling thread takes part in the scan, so the recovery also proceeds if no thread could be created */
+    segmentScanWorker(context);
+    for (i = 0; i < started; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    return EXECUTION_OK;
+}
+
+static int segmentIdCompare(const void *left,
+                            const void *right)
+{
+    uint32_t a = *(const uint32_t *) left;
+    uint32_t b = *(const uint32_t *) right;
+    return (a > b) - (a < b);
+}
+
+static short int logStoreListSegments(const char *directory,
+                                      uint32_t **segmentIds,
+                                      size_t *segmentCount)
+{
+    DIR *handle = opendir(directory);
+    struct dirent *entry;
+    uint32_t *ids = NULL;
+    size_t count = 0;
+    size_t capacity = 0;
+
+    if (handle == NULL) {
+        return ERROR_STORAGE_FAILURE;
+    }
+    while ((entry = readdir(handle)) != NULL) {
+        unsigned int id;
+        char expected[64];
+
+        if (sscanf(entry->d_name, SEGMENT_FILE_FORMAT, &id) != 1) {
+            continue;
+        }
+        snprintf(expected, sizeof expected, SEGMENT_FILE_FORMAT, id);
+        if (strcmp(expected, entry->d_name) != 0) {
+            continue;
+        }
+        if (count == capacity) {
+            uint32_t *grown;
+            capacity = capacity != 0 ? capacity * 2 : 64;
+            grown = realloc(ids, capacity * sizeof *ids);
+            if (grown == NULL) {
+                free(ids);
+                closedir(handle);
+                return ERROR_STORAGE_FAILURE;
+            }
+            ids = grown;
+        }
+        ids[count++] = (uint32_t) id;
+    }
+    closedir(handle);
+
+    if (count > 1) {
+        qsort(ids, count, sizeof *ids, segmentIdCompare);
+    }
+    *segmentIds = ids;
+    *segmentCount = count;
+    return EXECUTION_OK;
+}
+
+/**
+ * Loads the checkpoint into the store. The checkpoint is only accepted if its segments are the oldest segments
+ * that exist in the directory apart from retired ones and the recorded length of its last segment is present on
+ * the storage. Segments older than the first segment of the checkpoint have been retired and are counted
+ * in retiredCount.
+ */
+static bool logStoreLoadCheckpoint(struct LogStore *store,
+                                   const uint32_t *segmentIds,
+                                   size_t segmentCount,
+                                   size_t *retiredCount)
+{
+    char path[4096];
+    struct CheckpointHeader header;
+    unsigned char *content = NULL;
+    struct stat status;
+    size_t expectedLength;
+    uint32_t crc;
+    bool accepted = false;
+    size_t retired = 0;
+    size_t i;
+    int fd;
+
+    *retiredCount = 0;
+    if (logStoreFilePath(store, CHECKPOINT_FILE_NAME, path, sizeof path) != EXECUTION_OK) {
+        return false;
+    }
+    fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    if (fstat(fd, &status) != 0 || (size_t) status.st_size < sizeof header) {
+        close(fd);
+        return false;
+    }
+    content = malloc((size_t) status.st_size);
+    if (content == NULL || pread(fd, content, (size_t) status.st_size, 0) != (ssize_t) status.st_size) {
+        goto cleanup;
+    }
+
+    memcpy(&header, content, sizeof header);
+    expectedLength = sizeof header + header.segmentCount * sizeof(struct SegmentInfo)
+                     + header.openTransactionCount * sizeof(struct OpenTransaction);
+    if (header.magic != CHECKPOINT_MAGIC || header.version != CHECKPOINT_VERSION
+        || header.segmentCount > segmentCount || expectedLength != (size_t) status.st_size) {
+        goto cleanup;
+    }
+    crc = header.crc;
+    header.crc = 0;
+    memcpy(content, &header, sizeof header);
+    if (crc32Update(0, content, expectedLength) != crc) {
+        goto cleanup;
+    }
+
+    if (logStoreGrowSegments(store, segmentCount + 1) != EXECUTION_OK) {
+        goto cleanup;
+    }
+    memcpy(store->segments, content + sizeof header, header.segmentCount * sizeof(struct SegmentInfo));
+    if (header.segmentCount > 0) {
+        while (retired < segmentCount && segmentIds[retired] < store->segments[0].id) {
+            retired++;
+        }
+    }
+    if (header.segmentCount > segmentCount - retired) {
+        goto cleanup;
+    }
+    for (i = 0; i < header.segmentCount; i++) {
+        if (store->segments[i].id != segmentIds[retired + i]) {
+            goto cleanup;
+        }
+    }
+    if (header.segmentCount > 0) {
+        char segmentPath[4096];
+        const struct SegmentInfo *tail = &store->segments[header.segmentCount - 1];
+        if (logStoreSegmentPath(store, tail->id, segmentPath, sizeof segmentPath) != EXECUTION_OK
+            || stat(segmentPath, &status) != 0 || (uint64_t) status.st_size < tail->length) {
+            goto cleanup;
+        }
+    }
+
+    for (i = 0; i < header.openTransactionCount; i++) {
+        struct OpenTransaction entry;
+        memcpy(&entry, content + sizeof header + header.segmentCount * sizeof(struct SegmentInfo)
+                       + i * sizeof entry, sizeof entry);
+        if (transactionTableInsert(&store->openTransactions, &entry, NULL) != EXECUTION_OK) {
+            goto cleanup;
+        }
+    }
+    store->segmentCount = (size_t) header.segmentCount;
+    store->lastSignatureCounter = header.lastSignatureCounter;
+    store->lastTransactionNumber = header.lastTransactionNumber;
+    store->exportedSignatureCounter = header.exportedSignatureCounter;
+    store->deletableSignatureCounter = header.deletableSignatureCounter;
+    *retiredCount = retired;
+    accepted = true;
+
+cleanup:
+    if (!accepted) {
+        /* a rejected checkpoint falls back to a full scan of all segments */
+        transactionTableFree(&store->openTransactions);
+        transactionTableInit(&store->openTransactions, 0);
+        store->segmentCount = 0;
+        store->lastSignatureCounter = 0;
+        store->lastTransactionNumber = 0;
+        store->exportedSignatureCounter = 0;
+        store->deletableSignatureCounter = 0;
+    }
+    free(content);
+    close(fd);
+    return accepted;
+}
+
+static short int logStoreApplyScanJob(struct LogStore *store,
+                                      struct SegmentScanJob *job)
+{
+    struct OpenTransaction *entry;
+    size_t cursor = 0;
+
+    while ((entry = transactionTableIterate(&job->touched, &cursor)) != NULL) {
+        if (entry->flags & OPEN_TRANSACTION_FINISHED) {
+            transactionTableRemove(&store->openTransactions, entry->transactionNumber);
+        } else {
+            struct OpenTransaction *open = transactionTableFind(&store->openTransactions, entry->transactionNumber);
+            if (open != NULL) {
+                open->lastSignatureCounter = entry->lastSignatureCounter;
+                open->lastUpdateTime = entry->lastUpdateTime;
+            }
+        }
+    }
+    cursor = 0;
+    while ((entry = transactionTableIterate(&job->opened, &cursor)) != NULL) {
+        if (transactionTableInsert(&store->openTransactions, entry, NULL) != EXECUTION_OK) {
+            return ERROR_STORAGE_FAILURE;
+        }
+    }
+
+    if (job->info.recordCount > 0 && job->info.lastSignatureCounter > store->lastSignatureCounter) {
+        store->lastSignatureCounter = job->info.lastSignatureCounter;
+    }
+    if (job->maxTransactionNumber > store->lastTransactionNumber) {
+        store->lastTransactionNumber = job->maxTransactionNumber;
+    }
+    return EXECUTION_OK;
+}
+
+/**
+ * Deletes the files of segments that have been removed from the index by a retirement that was interrupted,
+ * and rebuilds the index entry of the first segment if it has been rewritten after the checkpoint.
+ */
+static short int logStoreCompleteRetirement(struct LogStore *store,
+                                            const uint32_t *retiredIds,
+                                            size_t retiredCount,
+                                            size_t checkpointCount)
+{
+    char path[4096];
+    char name[64];
+    struct stat status;
+    struct SegmentScanJob job;
+    size_t i;
+
+    for (i = 0; i < retiredCount; i++) {
+        if (logStoreSegmentPath(store, retiredIds[i], path, sizeof path) != EXECUTION_OK
+            || (unlink(path) != 0 && errno != ENOENT)) {
+            return ERROR_STORAGE_FAILURE;
+        }
+    }
+    if (checkpointCount == 0) {
+        return EXECUTION_OK;
+    }
+    snprintf(name, sizeof name, SEGMENT_COMPACT_FILE_FORMAT, store->segments[0].id);
+    if (logStoreFilePath(store, name, path, sizeof path) == EXECUTION_OK) {
+        unlink(path);
+    }
+
+    /* a rewritten segment is shorter than before, the last checkpointed segment is replayed anyway */
+    if (checkpointCount < 2 || logStoreSegmentPath(store, store->segments[0].id, path, sizeof path) != EXECUTION_OK
+        || stat(path, &status) != 0 || (uint64_t) status.st_size == store->segments[0].length) {
+        return EXECUTION_OK;
+    }
+    memset(&job, 0, sizeof job);
+    job.segmentId = store->segments[0].id;
+    job.info.id = job.segmentId;
+    if (transactionTableInit(&job.opened, 0) != EXECUTION_OK || transactionTableInit(&job.touched, 0) != EXECUTION_OK) {
+        transactionTableFree(&job.opened);
+        return ERROR_STORAGE_FAILURE;
+    }
+    /* the open transactions of the checkpoint already reflect the segment, so only its index entry is taken */
+    segmentScanJobRun(store, &job);
+    if (job.result == EXECUTION_OK && job.truncated) {
+        job.result = ERROR_STORAGE_FAILURE;
+    }
+    if (job.result == EXECUTION_OK) {
+        store->segments[0] = job.info;
+    }
+    transactionTableFree(&job.opened);
+    transactionTableFree(&job.touched);
+    return job.result;
+}
+
+static short int logStoreRecover(struct LogStore *store)
+{
+    struct SegmentScanContext context;
+    struct SegmentScanJob *jobs = NULL;
+    uint32_t *listedIds = NULL;
+    const uint32_t *segmentIds;
+    size_t segmentCount = 0;
+    size_t checkpointCount = 0;
+    size_t retiredCount = 0;
+    size_t jobCount;
+    size_t i;
+    short int result;
+
+    result = logStoreListSegments(store->directory, &listedIds, &segmentCount);
+    if (result != EXECUTION_OK) {
+        return result;
+    }
+    if (logStoreGrowSegments(store, segmentCount + 1) != EXECUTION_OK) {
+        free(listedIds);
+        return ERROR_STORAGE_FAILURE;
+    }
+    if (logStoreLoadCheckpoint(store, listedIds, segmentCount, &retiredCount)) {
+        checkpointCount = store->segmentCount;
+    }
+    result = logStoreCompleteRetirement(store, listedIds, retiredCount, checkpointCount);
+    if (result != EXECUTION_OK) {
+        free(listedIds);
+        return result;
+    }
+    segmentIds = listedIds + retiredCount;
+    segmentCount -= retiredCount;
+
+    /* the last checkpointed segment is replayed from its recorded length, later segments from their start */
+    jobCount = segmentCount - checkpointCount + (checkpointCount > 0 ? 1 : 0);
+    jobs = calloc(jobCount != 0 ? jobCount : 1, sizeof *jobs);
+    if (jobs == NULL) {
+        free(listedIds);
+        return ERROR_STORAGE_FAILURE;
+    }
+    for (i = 0; i < jobCount; i++) {
+        size_t segmentIndex = checkpointCount > 0 ? checkpointCount - 1 + i : i;
+        struct SegmentScanJob *job = &jobs[i];
+
+        job->segmentId = segmentIds[segmentIndex];
+        if (segmentIndex < checkpointCount) {
+            job->info = store->segments[segmentIndex];
+            job->offset = job->info.length;
+        } else {
+            job->info.id = job->segmentId;
+        }
+        if (transactionTableInit(&job->opened, 0) != EXECUTION_OK
+            || transactionTableInit(&job->touched, 0) != EXECUTION_OK) {
+            result = ERROR_STORAGE_FAILURE;
+        }
+    }
+
+    if (result == EXECUTION_OK && jobCount > 0) {
+        context.store = store;
+        context.jobs = jobs;
+        context.jobCount = jobCount;
+        context.nextJob = 0;
+        pthread_mutex_init(&context.lock, NULL);
+        segmentScanRunParallel(&context, store->scanThreads);
+        pthread_mutex_destroy(&context.lock);
+    }
+
+    store->segmentCount = checkpointCount > 0 ? checkpointCount - 1 : 0;
+    for (i = 0; i < jobCount && result == EXECUTION_OK; i++) {
+        struct SegmentScanJob *job = &jobs[i];
+
+        if (job->result != EXECUTION_OK) {
+            result = job->result;
+        } else if (job->truncated && i + 1 < jobCount) {
+            /* only the segment that has been written last may end with an incomplete record */
+            result = ERROR_STORAGE_FAILURE;
+        } else if (job->truncated) {
+            char path[4096];
+            if (logStoreSegmentPath(store, job->segmentId, path, sizeof path) != EXECUTION_OK
+                || truncate(path, (off_t) job->info.length) != 0) {
+                result = ERROR_STORAGE_FAILURE;
+            }
+        }
+        if (result == EXECUTION_OK) {
+            store->segments[store->segmentCount++] = job->info;
+            result = logStoreApplyScanJob(store, job);
+        }
+    }
+
+    for (i = 0; i < jobCount; i++) {
+        transactionTableFree(&jobs[i].opened);
+        transactionTableFree(&jobs[i].touched);
+    }
+    free(jobs);
+    free(listedIds);
+    return result;
+}
+
+static short int logStoreOpenCertificates(struct LogStore *store)
+{
+    char path[4096];
+
+    if (logStoreFilePath(store, CERTIFICATE_DIRECTORY_NAME, path, sizeof path) != EXECUTION_OK) {
+        return ERROR_STORAGE_FAILURE;
+    }
+    return certificateStoreOpen(&store->certificates, path);
+}
+
+/**
+ * Opens the last segment for appending. A created segment is empty, so its interval index is complete from the
+ * start and is extended by the appends.
+ */
+static short int logStoreOpenActiveSegment(struct LogStore *store,
+                                           bool create)
+{
+    char path[4096];
+    struct SegmentInfo *info = &store->segments[store->segmentCount - 1];
+    struct SystemLogSegment *segment;
+
+    if (logStoreSegmentPath(store, info->id, path, sizeof path) != EXECUTION_OK) {
+        return ERROR_STORAGE_FAILURE;
+    }
+    if (create && systemLogIndexTrack(&store->systemLogs, info->id, &segment) != EXECUTION_OK) {
+        return ERROR_STORAGE_FAILURE;
+    }
+    store->activeFd = open(path, O_WRONLY | O_APPEND | O_CLOEXEC | (create ? O_CREAT : 0), 0600);
+    if (store->activeFd < 0) {
+        return ERROR_STORAGE_FAILURE;
+    }
+    if (create) {
+        return logStoreSyncDirectory(store->directory);
+    }
+    return EXECUTION_OK;
+}
+
+/**
+ * Creates the timers of the recovered open transactions. The wheel starts at the latest log time of the store.
+ */
+static short int logStoreStartTransactionTimers(struct LogStore *store)
+{
+    struct OpenTransaction *entry;
+    int64_t now = 0;
+    size_t cursor = 0;
+    size_t i;
+
+    for (i = 0; i < store->segmentCount; i++) {
+        if (store->segments[i].recordCount > 0 && store->segments[i].maxLogTime > now) {
+            now = store->segments[i].maxLogTime;
+        }
+    }
+    timerWheelInit(&store->transactionTimers, now);
+    while ((entry = transactionTableIterate(&store->openTransactions, &cursor)) != NULL) {
+        if (timerWheelAdd(&store->transactionTimers, entry->transactionNumber,
+                          entry->lastUpdateTime + store->staleTransactionAge, &entry->timerNode) != EXECUTION_OK) {
+            return ERROR_STORAGE_FAILURE;
+        }
+    }
+    return EXECUTION_OK;
+}
+
+/**
+ * Releases the storage backend of the store unless it is shared with other stores.
+ */
+static void logStoreReleaseIo(struct LogStore *store)
+{
+    if (!store->ioShared) {
+        storageIoFree(store->io);
+        free(store->io);
+    }
+}
+
+/**
+ * Releases the memory, the certificate store and the locks of an opened store whose active segment is closed.
+ */
+static void logStoreRelease(struct LogStore *store)
+{
+    certificateStoreClose(&store->certificates);
+    systemLogIndexFree(&store->systemLogs);
+    timerWheelFree(&store->transactionTimers);
+    transactionTableFree(&store->openTransactions);
+    free(store->segmentCounts);
+    free(store->segments);
+    logStoreReleaseIo(store);
+    free(store->directory);
+    pthread_cond_destroy(&store->snapshotReleased);
+    pthread_mutex_destroy(&store->checkpointLock);
+    pthread_mutex_destroy(&store->lock);
+}
+
+short int logStoreOpen(struct LogStore *store,
+                       const char *directory,
+                       const struct LogStoreOptions *options)
+{
+    enum StorageIoBackend storageBackend = storageIoPortable;
+    struct StorageIo *sharedIo = NULL;
+    short int result;
+
+    if (store == NULL || directory == NULL) {
+        return ERROR_PARAMETER_MISMATCH;
+    }
+
+    memset(store, 0, sizeof *store);
+    store->activeFd = -1;
+    store->segmentSizeLimit = LOG_STORE_DEFAULT_SEGMENT_SIZE;
+    store->scanThreads = LOG_STORE_DEFAULT_SCAN_THREADS;
+    store->staleTransactionAge = LOG_STORE_DEFAULT_STALE_TRANSACTION_AGE;
+    if (options != NULL) {
+        if (options->segmentSizeLimit != 0) {
+            store->segmentSizeLimit = options->segmentSizeLimit;
+        }
+        if (options->scanThreads != 0) {
+            store->scanThreads = options->scanThreads;
+        }
+        if (options->staleTransactionAge != 0) {
+            store->staleTransactionAge = options->staleTransactionAge;
+        }
+        store->syncEachAppend = options->syncEachAppend;
+        storageBackend = options->storageBackend;
+        sharedIo = options->sharedIo;
+    }
+    store->directory = strdup(directory);
+    store->ioShared = sharedIo != NULL;
+    store->io = sharedIo != NULL ? sharedIo : malloc(sizeof *store->io);
+    if (store->directory == NULL || store->io == NULL) {
+        if (!store->ioShared) {
+            free(store->io);
+        }
+        free(store->directory);
+        return ERROR_STORAGE_FAILURE;
+    }
+    /* the segment readers of the recovery already read through the storage backend */
+    if (!store->ioShared
+        && storageIoInit(store->io, storageBackend, PROFILE_REGISTERED_BUFFERS, SEGMENT_READER_BUFFER_SIZE)
+           != EXECUTION_OK) {
+        free(store->io);
+        free(store->directory);
+        return ERROR_STORAGE_FAILURE;
+    }
+    if (transactionTableInit(&store->openTransactions, 0) != EXECUTION_OK) {
+        logStoreReleaseIo(store);
+        free(store->directory);
+        return ERROR_STORAGE_FAILURE;
+    }
+    systemLogIndexInit(&store->systemLogs);
+
+    result = logStoreOpenCertificates(store);
+    if (result == EXECUTION_OK) {
+        result = logStoreRecover(store);
+    }
+    if (result == EXECUTION_OK) {
+        result = logStoreStartTransactionTimers(store);
+    }
+    if (result == EXECUTION_OK) {
+        bool create = store->segmentCount == 0;
+        if (create) {
+            memset(&store->segments[0], 0, sizeof store->segments[0]);
+            store->segmentCount = 1;
+        }
+        result = logStoreOpenActiveSegment(store, create);
+    }
+    if (result != EXECUTION_OK) {
+        certificateStoreClose(&store->certificates);
+        systemLogIndexFree(&store->systemLogs);
+        timerWheelFree(&store->transactionTimers);
+        transactionTableFree(&store->openTransactions);
+        free(store->segmentCounts);
+        free(store->segments);
+        logStoreReleaseIo(store);
+        free(store->directory);
+        return result;
+    }
+
+    countIndexRebuild(store->segmentCounts, store->segments, store->segmentCount);
+    pthread_mutex_init(&store->lock, NULL);
+    pthread_mutex_init(&store->checkpointLock, NULL);
+    pthread_cond_init(&store->snapshotReleased, NULL);
+    /* a fresh checkpoint bounds the replay of the next start to the records appended from now on */
+    result = logStoreCheckpoint(store);
+    if (result != EXECUTION_OK) {
+        /* a store that could not be opened is not closed by the caller */
+        close(store->activeFd);
+        logStoreRelease(store);
+    }
+    return result;
+}
+
+static short int logStoreRollSegment(struct LogStore *store)
+{
+    struct SegmentInfo *info;
+    uint32_t nextId = store->segments[store->segmentCount - 1].id + 1;
+    int previousFd = store->activeFd;
+
+    if (storageIoSynchronize(store->io, store->activeFd) != EXECUTION_OK
+        || logStoreGrowSegments(store, store->segmentCount + 1) != EXECUTION_OK) {
+        return ERROR_STORAGE_FAILURE;
+    }
+
+    info = &store->segments[store->segmentCount++];
+    memset(info, 0, sizeof *info);
+    info->id = nextId;
+    if (logStoreOpenActiveSegment(store, true) != EXECUTION_OK) {
+        /* the appends continue in the previous segment, the roll is retried by the next append */
+        if (store->activeFd >= 0) {
+            close(store->activeFd);
+        }
+        store->activeFd = previousFd;
+        systemLogIndexDrop(&store->systemLogs, nextId);
+        store->segmentCount--;
+        return ERROR_STORAGE_FAILURE;
+    }
+    close(previousFd);
+    countIndexUpdateLast(store->segmentCounts, store->segments, store->segmentCount);
+    return EXECUTION_OK;
+}
+
+short int logStoreAppend(struct LogStore *store,
+                         const struct LogRecord *record)
+{
+    struct LogRecordHeader header;
+    struct iovec vector[3];
+    struct SegmentInfo *info;
+    struct SystemLogSegment *segment;
+    struct OpenTransaction *open = NULL;
+    struct OpenTransaction entry;
+    uint64_t recordLength;
+    bool checkpointDue = false;
+    short int result = EXECUTION_OK;
+
+    if (record == NULL || record->clientIdLength > TRANSACTION_CLIENT_ID_MAX
+        || record->payloadLength > LOG_STORE_MAX_PAYLOAD_LENGTH || record->signatureCounter == 0) {
+        return ERROR_PARAMETER_MISMATCH;
+    }
+    recordLength = sizeof header + record->clientIdLength + record->payloadLength;
+
+    profileLock(&store->lock);
+    if (record->signatureCounter <= store->lastSignatureCounter) {
+        result = ERROR_PARAMETER_MISMATCH;
+        goto unlock;
+    }
+    if (record->type == transactionLogMessage) {
+        open = transactionTableFind(&store->openTransactions, record->transactionNumber);
+        if (record->operation == startTransactionOperation ? open != NULL : open == NULL) {
+            result = record->operation == startTransactionOperation ? ERROR_PARAMETER_MISMATCH : ERROR_NO_TRANSACTION;
+            goto unlock;
+        }
+        /* the open transaction is entered after the write, where it must not fail any more */
+        if (record->operation == startTransactionOperation
+            && (timerWheelReserve(&store->transactionTimers) != EXECUTION_OK
+                || transactionTableReserve(&store->openTransactions) != EXECUTION_OK)) {
+            result = ERROR_STORAGE_FAILURE;
+            goto unlock;
+        }
+    }
+
+    info = &store->segments[store->segmentCount - 1];
+    if (info->length > 0 && info->length + recordLength > store->segmentSizeLimit) {
+        result = logStoreRollSegment(store);
+        if (result != EXECUTION_OK) {
+            goto unlock;
+        }
+        info = &store->segments[store->segmentCount - 1];
+        checkpointDue = true;
+    }
+
+    logRecordHeaderInit(&header, record);
+    vector[0].iov_base = &header;
+    vector[0].iov_len = sizeof header;
+    vector[1].iov_base = (void *) record->clientId;
+    vector[1].iov_len = record->clientIdLength;
+    vector[2].iov_base = (void *) record->payload;
+    vector[2].iov_len = record->payloadLength;
+    result = storageIoAppend(store->io, store->activeFd, vector, 3, store->syncEachAppend);
+    if (result != EXECUTION_OK) {
+        /* remove a partially written record, so that later records do not follow a corrupted one */
+        if (ftruncate(store->activeFd, (off_t) info->length) != 0) {
+            result = ERROR_STORAGE_FAILURE;
+        }
+        goto unlock;
+    }
+
+    segment = systemLogIndexFind(&store->systemLogs, info->id);
+    if (segment != NULL && segment->indexedLength == info->length
+        && systemLogIndexAdd(segment, record, recordLength) != EXECUTION_OK) {
+        /* the interval index of the segment is rebuilt from the segment when it is needed */
+        systemLogIndexDrop(&store->systemLogs, info->id);
+    }
+    segmentInfoAdd(info, record, recordLength);
+    countIndexUpdateLast(store->segmentCounts, store->segments, store->segmentCount);
+    store->lastSignatureCounter = record->signatureCounter;
+    timerWheelAdvance(&store->transactionTimers, record->logTime);
+    if (record->type == transactionLogMessage) {
+        int64_t deadline = record->logTime + store->staleTransactionAge;
+
+        if (record->transactionNumber > store->lastTransactionNumber) {
+            store->lastTransactionNumber = record->transactionNumber;
+        }
+        switch (record->operation) {
+        case startTransactionOperation:
+            /* the node and the slot have been reserved before the write */
+            openTransactionFromRecord(&entry, record);
+            timerWheelAdd(&store->transactionTimers, entry.transactionNumber, deadline, &entry.timerNode);
+            transactionTableInsert(&store->openTransactions, &entry, NULL);
+            break;
+        case updateTransactionOperation:
+            open->lastSignatureCounter = record->signatureCounter;
+            open->lastUpdateTime = record->logTime;
+            timerWheelReschedule(&store->transactionTimers, open->timerNode, deadline);
+            break;
+        case finishTransactionOperation:
+            timerWheelRemove(&store->transactionTimers, open->timerNode);
+            transactionTableRemove(&store->openTransactions, record->transactionNumber);
+            break;
+        default:
+            break;
+        }
+    }
+
+unlock:
+    profileUnlock(&store->lock);
+    if (result == EXECUTION_OK && checkpointDue) {
+        /* the record is stored; a checkpoint that fails only lengthens the replay of the next start */
+        logStoreCheckpoint(store);
+    }
+    return result;
+}
+
+short int logStoreCheckpoint(struct LogStore *store)
+{
+    char path[4096];
+    char temporaryPath[4096];
+    struct CheckpointHeader header;
+    struct OpenTransaction *entry;
+    unsigned char *content;
+    size_t contentLength;
+    size_t cursor = 0;
+    size_t position;
+    short int result = EXECUTION_OK;
+    int synchronizeFd = -1;
+    int fd;
+
+    if (logStoreFilePath(store, CHECKPOINT_FILE_NAME, path, sizeof path) != EXECUTION_OK
+        || logStoreFilePath(store, CHECKPOINT_TEMPORARY_FILE_NAME, temporaryPath, sizeof temporaryPath) != EXECUTION_OK) {
+        return ERROR_STORAGE_FAILURE;
+    }
+
+    profileLock(&store->checkpointLock);
+
+    /* the snapshot is taken under the store lock; the active segment is synchronized and the file is written after
+       releasing it, through a duplicate of its descriptor, which a concurrent roll does not close */
+    profileLock(&store->lock);
+    if (!store->syncEachAppend) {
+        synchronizeFd = dup(store->activeFd);
+        if (synchronizeFd < 0) {
+            profileUnlock(&store->lock);
+            profileUnlock(&store->checkpointLock);
+            return ERROR_STORAGE_FAILURE;
+        }
+    }
+    memset(&header, 0, sizeof header);
+    header.magic = CHECKPOINT_MAGIC;
+    header.version = CHECKPOINT_VERSION;
+    header.segmentCount = store->segmentCount;
+    header.openTransactionCount = store->openTransactions.count;
+    header.lastSignatureCounter = store->lastSignatureCounter;
+    header.lastTransactionNumber = store->lastTransactionNumber;
+    header.exportedSignatureCounter = store->exportedSignatureCounter;
+    header.deletableSignatureCounter = store->deletableSignatureCounter;
+    contentLength = sizeof header + store->segmentCount * sizeof(struct SegmentInfo)
+                    + store->openTransactions.count * sizeof(struct OpenTransaction);
+    content = malloc(contentLength);
+    if (content == NULL) {
+        profileUnlock(&store->lock);
+        profileUnlock(&store->checkpointLock);
+        if (synchronizeFd >= 0) {
+            close(synchronizeFd);
+        }
+        return ERROR_STORAGE_FAILURE;
+    }
+    position = sizeof header;
+    memcpy(content + position, store->segments, store->segmentCount * sizeof(struct SegmentInfo));
+    position += store->segmentCount * sizeof(struct SegmentInfo);
+    while ((entry = transactionTableIterate(&store->openTransactions, &cursor)) != NULL) {
+        memcpy(content + position, entry, sizeof *entry);
+        position += sizeof *entry;
+    }
+    profileUnlock(&store->lock);
+
+    /* the segment lengths of the snapshot MUST be durable before the checkpoint refers to them */
+    if (synchronizeFd >= 0) {
+        result = storageIoSynchronize(store->io, synchronizeFd);
+        close(synchronizeFd);
+    }
+
+    memcpy(content, &header, sizeof header);
+    header.crc = crc32Update(0, content, contentLength);
+    memcpy(content, &header, sizeof header);
+
+    fd = result == EXECUTION_OK ? open(temporaryPath, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600) : -1;
+    if (fd < 0) {
+        result = ERROR_STORAGE_FAILURE;
+    } else {
+        struct iovec vector;
+        vector.iov_base = content;
+        vector.iov_len = contentLength;
+        result = logStoreWriteVector(fd, &vector, 1);
+        if (result == EXECUTION_OK && fdatasync(fd) != 0) {
+            result = ERROR_STORAGE_FAILURE;
+        }
+        close(fd);
+    }
+    if (result == EXECUTION_OK && rename(temporaryPath, path) != 0) {
+        result = ERROR_STORAGE_FAILURE;
+    }
+    if (result == EXECUTION_OK) {
+        result = logStoreSyncDirectory(store->directory);
+    }
+
+    free(content);
+    profileUnlock(&store->checkpointLock);
+    return result;
+}
+
+static size_t logStoreCollectStale(struct LogStore *store,
+                                   int64_t now,
+                                   struct StaleTransaction *transactions,
+                                   size_t capacity)
+{
+    const struct TimerNode *node;
+    uint32_t cursor = TIMER_NODE_NONE;
+    size_t count = 0;
+
+    timerWheelAdvance(&store->transactionTimers, now);
+    while (count < capacity && (node = timerWheelExpired(&store->transactionTimers, &cursor)) != NULL) {
+        const struct OpenTransaction *entry = transactionTableFind(&store->openTransactions, node->key);
+        struct StaleTransaction *transaction = &transactions[count++];
+
+        transaction->transactionNumber = entry->transactionNumber;
+        transaction->lastUpdateTime = entry->lastUpdateTime;
+        transaction->clientIdLength = entry->clientIdLength;
+        memcpy(transaction->clientId, entry->clientId, entry->clientIdLength);
+    }
+    return count;
+}
+
+short int logStoreStaleTransactions(struct LogStore *store,
+                                    int64_t now,
+                                    struct StaleTransaction *transactions,
+                                    size_t capacity,
+                                    size_t *count)
+{
+    profileLock(&store->lock);
+    logStoreCollectStale(store, now, transactions, transactions != NULL ? capacity : 0);
+    *count = store->transactionTimers.expiredCount;
+    profileUnlock(&store->lock);
+    return EXECUTION_OK;
+}
+
+bool logStoreTransactionUnchanged(struct LogStore *store,
+                                  const struct StaleTransaction *transaction)
+{
+    const struct OpenTransaction *entry;
+    bool unchanged;
+
+    profileLock(&store->lock);
+    entry = transactionTableFind(&store->openTransactions, transaction->transactionNumber);
+    unchanged = entry != NULL && entry->lastUpdateTime == transaction->lastUpdateTime;
+    profileUnlock(&store->lock);
+    return unchanged;
+}
+
+short int logStoreFinishStaleTransactions(struct LogStore *store,
+                                          int64_t now,
+                                          StaleTransactionFinisher finisher,
+                                          void *finisherContext,
+                                          size_t *finishedCount)
+{
+    struct StaleTransaction *transactions;
+    size_t count;
+    size_t i;
+    short int result = EXECUTION_OK;
+
+    *finishedCount = 0;
+    profileLock(&store->lock);
+    timerWheelAdvance(&store->transactionTimers, now);
+    count = store->transactionTimers.expiredCount;
+    transactions = malloc((count != 0 ? count : 1) * sizeof *transactions);
+    if (transactions != NULL) {
+        count = logStoreCollectStale(store, now, transactions, count);
+    }
+    profileUnlock(&store->lock);
+    if (transactions == NULL) {
+        return ERROR_STORAGE_FAILURE;
+    }
+
+    for (i = 0; i < count; i++) {
+        short int finished = finisher(finisherContext, &transactions[i]);
+        if (finished == EXECUTION_OK) {
+            (*finishedCount)++;
+        } else if (finished != ERROR_NO_TRANSACTION && result == EXECUTION_OK) {
+            result = finished;
+        }
+    }
+    free(transactions);
+    return result;
+}
+
+/**
+ * Copy of the index entries with the generation of the index that it has been taken from. The callers only see the
+ * member segments.
+ */
+struct SegmentSnapshot {
+    uint64_t generation;
+    struct SegmentInfo segments[];
+};
+
+short int logStoreSnapshotSegments(struct LogStore *store,
+                                   struct SegmentInfo **segments,
+                                   size_t *segmentCount)
+{
+    struct SegmentSnapshot *snapshot;
+    short int result = EXECUTION_OK;
+
+    profileLock(&store->lock);
+#if PROFILE_CONCURRENT
+    /* the copy would describe the first segment while its file is replaced */
+    while (store->replacingSegment) {
+        pthread_cond_wait(&store->snapshotReleased, &store->lock);
+    }
+#endif
+    snapshot = malloc(sizeof *snapshot + store->segmentCount * sizeof *snapshot->segments);
+    if (snapshot == NULL) {
+        result = ERROR_STORAGE_FAILURE;
+    } else {
+        snapshot->generation = store->indexGeneration;
+        memcpy(snapshot->segments, store->segments, store->segmentCount * sizeof *snapshot->segments);
+        *segments = snapshot->segments;
+        *segmentCount = store->segmentCount;
+        store->snapshotCount++;
+    }
+    profileUnlock(&store->lock);
+    return result;
+}
+
+void logStoreReleaseSnapshot(struct LogStore *store,
+                             struct SegmentInfo *segments)
+{
+    struct SegmentSnapshot *snapshot;
+
+    snapshot = (struct SegmentSnapshot *) ((unsigned char *) segments - offsetof(struct SegmentSnapshot, segments));
+    profileLock(&store->lock);
+    if (snapshot->generation == store->indexGeneration) {
+        store->snapshotCount--;
+    } else if (--store->previousSnapshotCount == 0) {
+        pthread_cond_broadcast(&store->snapshotReleased);
+    }
+    profileUnlock(&store->lock);
+    free(snapshot);
+}
+
+void logStoreMarkExported(struct LogStore *store,
+                          uint64_t signatureCounter)
+{
+    profileLock(&store->lock);
+    if (signatureCounter > store->exportedSignatureCounter) {
+        store->exportedSignatureCounter = signatureCounter;
+    }
+    profileUnlock(&store->lock);
+}
+
+size_t logStoreMemoryUsage(struct LogStore *store)
+{
+    size_t usage;
+
+    profileLock(&store->lock);
+    usage = store->openTransactions.capacity * sizeof(struct OpenTransaction)
+            + store->transactionTimers.nodeCapacity * sizeof(struct TimerNode)
+            + store->segmentCapacity * (sizeof(struct SegmentInfo) + sizeof(struct SegmentCountEntry))
+            + store->systemLogs.capacity * sizeof(struct SystemLogSegment);
+    profileUnlock(&store->lock);
+    return usage;
+}
+
+short int logStoreMarkDeletable(struct LogStore *store)
+{
+    short int result = EXECUTION_OK;
+    size_t i;
+
+    profileLock(&store->lock);
+    if (store->exportedSignatureCounter > store->deletableSignatureCounter) {
+        store->deletableSignatureCounter = store->exportedSignatureCounter;
+    } else {
+        /* the request only fails if records are stored and none of them is waiting for its deletion */
+        for (i = 0; i < store->segmentCount; i++) {
+            if (store->segments[i].recordCount > 0
+                && store->segments[i].lastSignatureCounter > store->deletableSignatureCounter) {
+                result = ERROR_UNEXPORTED_STORED_DATA;
+                break;
+            }
+        }
+        for (i = 0; result == ERROR_UNEXPORTED_STORED_DATA && i < store->segmentCount; i++) {
+            if (store->segments[i].recordCount > 0
+                && store->segments[i].firstSignatureCounter <= store->deletableSignatureCounter) {
+                result = EXECUTION_OK;
+            }
+        }
+    }
+    profileUnlock(&store->lock);
+    return result;
+}
+
+/**
+ * Starts a new generation of the index after segments have been removed from it or before the first segment is
+ * replaced. The lock of the store MUST be held.
+ */
+static void logStoreAdvanceGeneration(struct LogStore *store)
+{
+    store->indexGeneration++;
+    store->previousSnapshotCount += store->snapshotCount;
+    store->snapshotCount = 0;
+}
+
+/**
+ * Waits until no copy of the index entries is held that has been taken before the current generation of the index,
+ * the copies taken since do not delay the wait. The lock of the store MUST be held. In the embedded profile the
+ * copies are only held by the calling thread during an export, so none is held here.
+ */
+static void logStoreWaitForSnapshots(struct LogStore *store)
+{
+#if PROFILE_CONCURRENT
+    while (store->previousSnapshotCount > 0) {
+        pthread_cond_wait(&store->snapshotReleased, &store->lock);
+    }
+#else
+    (void) store;
+#endif
+}
+
+/**
+ * Removes the segments that only hold deletable records from the index, writes the checkpoint that no longer
+ * refers to them and deletes their files once the copies of the index entries taken before are released.
+ * The active segment is never removed.
+ */
+static short int logStoreDropSegments(struct LogStore *store,
+                                      uint64_t deletable,
+                                      bool checkpointDue)
+{
+    char path[4096];
+    uint32_t *segmentIds;
+    size_t dropCount = 0;
+    size_t i;
+    short int result = EXECUTION_OK;
+
+    profileLock(&store->lock);
+    while (dropCount + 1 < store->segmentCount
+           && (store->segments[dropCount].recordCount == 0
+               || store->segments[dropCount].lastSignatureCounter <= deletable)) {
+        dropCount++;
+    }
+    segmentIds = malloc((dropCount != 0 ? dropCount : 1) * sizeof *segmentIds);
+    if (segmentIds == NULL) {
+        profileUnlock(&store->lock);
+        return ERROR_DELETE_STORED_DATA_FAILED;
+    }
+    for (i = 0; i < dropCount; i++) {
+        segmentIds[i] = store->segments[i].id;
+    }
+    if (dropCount > 0) {
+        store->segmentCount -= dropCount;
+        memmove(store->segments, store->segments + dropCount, store->segmentCount * sizeof *store->segments);
+        countIndexRebuild(store->segmentCounts, store->segments, store->segmentCount);
+        /* the copies taken from now on do not refer to the removed segments */
+        logStoreAdvanceGeneration(store);
+    }
+    profileUnlock(&store->lock);
+
+    /* the files are deleted after the checkpoint, a recovery deletes the files of an interrupted retirement */
+    if (dropCount > 0 || checkpointDue) {
+        result = logStoreCheckpoint(store);
+    }
+    if (dropCount > 0) {
+        profileLock(&store->lock);
+        logStoreWaitForSnapshots(store);
+        /* the earlier copies may have indexed the system logs of the removed segments until now */
+        for (i = 0; i < dropCount; i++) {
+            systemLogIndexDrop(&store->systemLogs, segmentIds[i]);
+        }
+        profileUnlock(&store->lock);
+    }
+    for (i = 0; result == EXECUTION_OK && i < dropCount; i++) {
+        if (logStoreSegmentPath(store, segmentIds[i], path, sizeof path) != EXECUTION_OK
+            || (unlink(path) != 0 && errno != ENOENT)) {
+            result = ERROR_STORAGE_FAILURE;
+        }
+    }
+    if (result == EXECUTION_OK && dropCount > 0) {
+        result = logStoreSyncDirectory(store->directory);
+    }
+    free(segmentIds);
+    return result == EXECUTION_OK ? EXECUTION_OK : ERROR_DELETE_STORED_DATA_FAILED;
+}
+
+static short int logStoreCompactFlush(int fd,
+                                      unsigned char *buffer,
+                                      size_t *bufferFill,
+                                      SegmentCopyThrottle throttle,
+                                      void *throttleContext,
+                                      bool *aborted)
+{
+    struct iovec vector;
+
+    vector.iov_base = buffer;
+    vector.iov_len = *bufferFill;
+    if (logStoreWriteVector(fd, &vector, 1) != EXECUTION_OK) {
+        return ERROR_STORAGE_FAILURE;
+    }
+    if (throttle != NULL && !throttle(throttleContext, *bufferFill)) {
+        *aborted = true;
+    }
+    *bufferFill = 0;
+    return EXECUTION_OK;
+}
+
+/**
+ * Copies the records of a segment that are not deletable into the file at path and determines their index entry.
+ */
+static short int logStoreCompactCopy(struct LogStore *store,
+                                     const struct SegmentInfo *info,
+                                     uint64_t deletable,
+                                     const char *path,
+                                     SegmentCopyThrottle throttle,
+                                     void *throttleContext,
+                                     struct SegmentInfo *compacted,
+                                     bool *aborted)
+{
+    struct SegmentReader reader;
+    struct LogRecord record;
+    struct LogRecordHeader header;
+    unsigned char *buffer;
+    size_t bufferFill = 0;
+    bool endOfSegment = false;
+    short int result;
+    int fd;
+
+    memset(compacted, 0, sizeof *compacted);
+    compacted->id = info->id;
+    buffer = malloc(SEGMENT_COMPACT_BUFFER_SIZE);
+    if (buffer == NULL) {
+        return ERROR_STORAGE_FAILURE;
+    }
+    fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+    if (fd < 0) {
+        free(buffer);
+        return ERROR_STORAGE_FAILURE;
+    }
+    result = segmentReaderOpen(&reader, store, info->id, 0);
+    if (result == EXECUTION_OK) {
+        reader.limit = info->length;
+        while (result == EXECUTION_OK && !*aborted) {
+            uint64_t recordLength;
+
+            result = segmentReaderNext(&reader, &record, &endOfSegment);
+            if (result != EXECUTION_OK || endOfSegment) {
+                break;
+            }
+            if (record.signatureCounter <= deletable) {
+                continue;
+            }
+            logRecordHeaderInit(&header, &record);
+            recordLength = sizeof header + record.clientIdLength + record.payloadLength;
+            if (bufferFill + recordLength > SEGMENT_COMPACT_BUFFER_SIZE && bufferFill > 0) {
+                result = logStoreCompactFlush(fd, buffer, &bufferFill, throttle, throttleContext, aborted);
+            }
+            if (result == EXECUTION_OK && recordLength > SEGMENT_COMPACT_BUFFER_SIZE) {
+                struct iovec vector[3];
+                vector[0].iov_base = &header;
+                vector[0].iov_len = sizeof header;
+                vector[1].iov_base = (void *) record.clientId;
+                vector[1].iov_len = record.clientIdLength;
+                vector[2].iov_base = (void *) record.payload;
+                vector[2].iov_len = record.payloadLength;
+                result = logStoreWriteVector(fd, vector, 3);
+            } else if (result == EXECUTION_OK) {
+                memcpy(buffer + bufferFill, &header, sizeof header);
+                memcpy(buffer + bufferFill + sizeof header, record.clientId, record.clientIdLength);
+                memcpy(buffer + bufferFill + sizeof header + record.clientIdLength, record.payload,
+                       record.payloadLength);
+                bufferFill += recordLength;
+            }
+            segmentInfoAdd(compacted, &record, recordLength);
+        }
+        if (result == EXECUTION_OK && !*aborted && reader.offset != info->length) {
+            result = ERROR_STORAGE_FAILURE;
+        }
+        segmentReaderClose(&reader);
+    }
+    if (result == EXECUTION_OK && !*aborted && bufferFill > 0) {
+        result = logStoreCompactFlush(fd, buffer, &bufferFill, throttle, throttleContext, aborted);
+    }
+    if (result == EXECUTION_OK && fdatasync(fd) != 0) {
+        result = ERROR_STORAGE_FAILURE;
+    }
+    close(fd);
+    free(buffer);
+    return result;
+}
+
+/**
+ * Rewrites the first segment without its deletable records if it holds deletable and other records.
+ * The copy is written without holding the lock, the file and the index entry are replaced under the lock
+ * once the copies of the index entries taken before are released. No copy is taken until then.
+ */
+static short int logStoreCompactFirstSegment(struct LogStore *store,
+                                             uint64_t deletable,
+                                             SegmentCopyThrottle throttle,
+                                             void *throttleContext)
+{
+    char path[4096];
+    char compactPath[4096];
+    char name[64];
+    struct SegmentInfo info;
+    struct SegmentInfo compacted;
+    size_t segmentCount;
+    bool aborted = false;
+    short int result;
+
+    profileLock(&store->lock);
+    info = store->segments[0];
+    segmentCount = store->segmentCount;
+    profileUnlock(&store->lock);
+    /* the first segment is not the active one, so its records do not change while they are copied */
+    if (segmentCount < 2 || info.recordCount == 0 || info.firstSignatureCounter > deletable
+        || info.lastSignatureCounter <= deletable) {
+        return EXECUTION_OK;
+    }
+    snprintf(name, sizeof name, SEGMENT_COMPACT_FILE_FORMAT, info.id);
+    if (logStoreSegmentPath(store, info.id, path, sizeof path) != EXECUTION_OK
+        || logStoreFilePath(store, name, compactPath, sizeof compactPath) != EXECUTION_OK) {
+        return ERROR_DELETE_STORED_DATA_FAILED;
+    }
+
+    result = logStoreCompactCopy(store, &info, deletable, compactPath, throttle, throttleContext,
+                                 &compacted, &aborted);
+    if (result != EXECUTION_OK || aborted) {
+        unlink(compactPath);
+        return result == EXECUTION_OK ? EXECUTION_OK : ERROR_DELETE_STORED_DATA_FAILED;
+    }
+
+    profileLock(&store->lock);
+    store->replacingSegment = true;
+    logStoreAdvanceGeneration(store);
+    logStoreWaitForSnapshots(store);
+    if (rename(compactPath, path) != 0) {
+        result = ERROR_STORAGE_FAILURE;
+    } else {
+        store->segments[0] = compacted;
+        countIndexRebuild(store->segmentCounts, store->segments, store->segmentCount);
+        /* the offsets of the rewritten segment have changed */
+        systemLogIndexDrop(&store->systemLogs, compacted.id);
+    }
+    store->replacingSegment = false;
+    pthread_cond_broadcast(&store->snapshotReleased);
+    profileUnlock(&store->lock);
+
+    /* until the checkpoint has been written, a recovery detects the rewritten segment by its length */
+    if (result == EXECUTION_OK) {
+        result = logStoreSyncDirectory(store->directory);
+    }
+    if (result == EXECUTION_OK) {
+        result = logStoreCheckpoint(store);
+    }
+    if (result != EXECUTION_OK) {
+        unlink(compactPath);
+        return ERROR_DELETE_STORED_DATA_FAILED;
+    }
+    return EXECUTION_OK;
+}
+
+short int logStoreRetireSegments(struct LogStore *store,
+                                 SegmentCopyThrottle throttle,
+                                 void *throttleContext)
+{
+    struct SegmentInfo *active;
+    uint64_t deletable;
+    bool checkpointDue = false;
+    short int result = EXECUTION_OK;
+
+    profileLock(&store->lock);
+    deletable = store->deletableSignatureCounter;
+    active = &store->segments[store->segmentCount - 1];
+    if (active->recordCount > 0 && active->firstSignatureCounter <= deletable) {
+        /* the active segment is completed, so that its deletable records can be retired like any other */
+        result = logStoreRollSegment(store);
+        checkpointDue = result == EXECUTION_OK;
+    }
+    profileUnlock(&store->lock);
+    if (result != EXECUTION_OK) {
+        return ERROR_DELETE_STORED_DATA_FAILED;
+    }
+
+    result = logStoreDropSegments(store, deletable, checkpointDue);
+    if (result == EXECUTION_OK) {
+        result = logStoreCompactFirstSegment(store, deletable, throttle, throttleContext);
+    }
+    return result;
+}
+
+/**
+ * Reads the part of a segment from an offset up to the length of its index entry into an interval index.
+ */
+static short int logStoreIndexSystemLogs(const struct LogStore *store,
+                                         const struct SegmentInfo *info,
+                                         uint64_t offset,
+                                         struct SystemLogSegment *continuation)
+{
+    struct SegmentReader reader;
+    struct LogRecord record;
+    bool endOfSegment = false;
+    short int result;
+
+    memset(continuation, 0, sizeof *continuation);
+    continuation->segmentId = info->id;
+    continuation->indexedLength = offset;
+    result = segmentReaderOpen(&reader, store, info->id, offset);
+    if (result != EXECUTION_OK) {
+        return result;
+    }
+    reader.limit = info->length;
+    while (result == EXECUTION_OK) {
+        uint64_t recordOffset = reader.offset;
+
+        result = segmentReaderNext(&reader, &record, &endOfSegment);
+        if (result != EXECUTION_OK || endOfSegment) {
+            break;
+        }
+        result = systemLogIndexAdd(continuation, &record, reader.offset - recordOffset);
+    }
+    if (result == EXECUTION_OK && reader.offset < info->length) {
+        result = ERROR_STORAGE_FAILURE;
+    }
+    segmentReaderClose(&reader);
+    if (result != EXECUTION_OK) {
+        free(continuation->entries);
+    }
+    return result;
+}
+
+short int logStoreSystemLogOffsets(struct LogStore *store,
+                                   const struct SegmentInfo *info,
+                                   uint64_t firstSignatureCounter,
+                                   uint64_t lastSignatureCounter,
+                                   uint64_t **offsets,
+                                   size_t *offsetCount)
+{
+    struct SystemLogSegment *segment;
+    struct SystemLogSegment continuation;
+    uint64_t indexedLength;
+    size_t first;
+    size_t count;
+    size_t i;
+    short int result;
+
+    *offsets = NULL;
+    *offsetCount = 0;
+    for (;;) {
+        profileLock(&store->lock);
+        result = systemLogIndexTrack(&store->systemLogs, info->id, &segment);
+        if (result != EXECUTION_OK || segment->indexedLength >= info->length) {
+            break;
+        }
+        indexedLength = segment->indexedLength;
+        profileUnlock(&store->lock);
+
+        /* the segment is read without the lock, a concurrent extension of the same part is discarded */
+        result = logStoreIndexSystemLogs(store, info, indexedLength, &continuation);
+        if (result != EXECUTION_OK) {
+            return result;
+        }
+        profileLock(&store->lock);
+        segment = systemLogIndexFind(&store->systemLogs, info->id);
+        if (segment != NULL && segment->indexedLength == indexedLength) {
+            result = systemLogIndexJoin(segment, &continuation);
+        }
+        profileUnlock(&store->lock);
+        free(continuation.entries);
+        if (result != EXECUTION_OK) {
+            return result;
+        }
+    }
+
+    if (result == EXECUTION_OK) {
+        count = systemLogIndexRange(segment, firstSignatureCounter, lastSignatureCounter, &first);
+        /* entries appended after the copy of the index entries are not part of the export */
+        while (count > 0 && segment->entries[first + count - 1].offset >= info->length) {
+            count--;
+        }
+        *offsets = malloc((count != 0 ? count : 1) * sizeof **offsets);
+        if (*offsets == NULL) {
+            result = ERROR_STORAGE_FAILURE;
+        } else {
+            for (i = 0; i < count; i++) {
+                (*offsets)[i] = segment->entries[first + i].offset;
+            }
+            *offsetCount = count;
+        }
+    }
+    profileUnlock(&store->lock);
+    return result;
+}
+
+short int logStoreEstimateRecords(struct LogStore *store,
+                                  const struct RecordCountQuery *query,
+                                  uint64_t *lowerBound,
+                                  uint64_t *upperBound)
+{
+    if (store == NULL || query == NULL || lowerBound == NULL || upperBound == NULL) {
+        return ERROR_PARAMETER_MISMATCH;
+    }
+    profileLock(&store->lock);
+    countIndexQuery(store->segmentCounts, store->segments, store->segmentCount, query, lowerBound, upperBound);
+    profileUnlock(&store->lock);
+    return EXECUTION_OK;
+}
+
+short int logStoreClose(struct LogStore *store)
+{
+    short int result = logStoreCheckpoint(store);
+
+    if (close(store->activeFd) != 0 && result == EXECUTION_OK) {
+        result = ERROR_STORAGE_FAILURE;
+    }
+    logStoreRelease(store);
+    return result;
+}
+
+short int logStoreProbeCounter(void *probeContext,
+                               enum JournaledCounter counter,
+                               uint64_t fromValue,
+                               uint64_t toValue,
+                               uint64_t *highestUsed,
+                               bool *found)
+{
+    struct LogStore *store = (struct LogStore *) probeContext;
+    uint64_t last;
+
+    (void) toValue;
+    profileLock(&store->lock);
+    last = counter == journaledSignatureCounter ? store->lastSignatureCounter : store->lastTransactionNumber;
+    profileUnlock(&store->lock);
+
+    *found = last != 0 && last >= fromValue;
+    if (*found) {
+        *highestUsed = last;
+    }
+    return EXECUTION_OK;
+}
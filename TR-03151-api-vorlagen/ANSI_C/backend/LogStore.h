@@ -0,0 +1,545 @@
+#ifndef SEAPI_BACKEND_LOG_STORE_H
+#define SEAPI_BACKEND_LOG_STORE_H
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "../Exception.h"
+#include "../Constant.h"
+#include "CertificateStore.h"
+#include "CountIndex.h"
+#include "CounterJournal.h"
+#include "Profile.h"
+#include "StorageIo.h"
+#include "SystemLogIndex.h"
+#include "TimerWheel.h"
+#include "TransactionTable.h"
+
+/**
+ * This header file defines the log store of the SE API backend.
+ *
+ * The log messages are appended to segment files of bounded size. For every segment the store keeps an index
+ * entry (counter and time ranges, record counts) that is used to select segments for the export of stored data.
+ * The index entries, the set of open transactions and the last counter values are written to a checkpoint whenever
+ * a segment is completed. After a restart only the part of the store that has been written after the last
+ * checkpoint is replayed, and segments that are not covered by the checkpoint are scanned in parallel,
+ * so that the time until the first startTransaction does not depend on the size of the store.
+ * The count index kept next to the index entries answers how many log messages an export selects
+ * before any segment is read. The interval index of the system log messages and audit log messages locates them
+ * by their signature counter, and the certificates needed to verify the exported signatures are kept in the
+ * certificate store in the subdirectory certificates.
+ *
+ * Every open transaction has a timer that is moved forward by each of its log messages. Transactions whose last
+ * log message is older than the configured age are reported as stale and can be finished in one pass, so that
+ * transactions left open by crashed clients do not exhaust the maximum number of open transactions.
+ *
+ * Stored data is deleted by retiring segments from the front of the store: segments whose log messages have all
+ * been exported are removed from the index by a checkpoint and deleted afterwards, and the first segment is
+ * rewritten without its exported log messages if it has only been exported partially. The copying is done
+ * without holding the lock of the store, so that appends are not blocked by a deletion.
+ */
+
+/**
+ * Represents the types of log messages that are kept in the store.
+ */
+enum LogMessageType {
+transactionLogMessage, systemLogMessage, auditLogMessage
+};
+
+/**
+ * Represents the SE API function that has created a transaction log message.
+ */
+enum TransactionOperation {
+noTransactionOperation, startTransactionOperation, updateTransactionOperation, finishTransactionOperation
+};
+
+/**
+ * Default size limit of a segment file in bytes, which depends on the build profile
+ */
+#define LOG_STORE_DEFAULT_SEGMENT_SIZE PROFILE_SEGMENT_SIZE
+
+/**
+ * Default number of threads that scan segments during the recovery and the exports, which depends on the build
+ * profile
+ */
+#define LOG_STORE_DEFAULT_SCAN_THREADS PROFILE_SCAN_THREADS
+
+/**
+ * Size of the buffer of a segment reader; a storage backend passed as sharedIo registers buffers of this size
+ */
+#define SEGMENT_READER_BUFFER_SIZE (1024u * 1024u)
+
+/**
+ * Maximum length of the payload of a log message in bytes, which also bounds the buffer of a replication receiver
+ */
+#define LOG_STORE_MAX_PAYLOAD_LENGTH (64ul * 1024ul * 1024ul)
+
+/**
+ * Default age in seconds after which an open transaction without log messages is considered stale
+ */
+#define LOG_STORE_DEFAULT_STALE_TRANSACTION_AGE (24l * 60l * 60l)
+
+/**
+ * Represents a log message together with the metadata that is needed to index it.
+ * The logTime is given in seconds since the epoch (UTC).
+ */
+struct LogRecord {
+    uint64_t signatureCounter;
+    uint64_t transactionNumber;
+    int64_t logTime;
+    enum LogMessageType type;
+    enum TransactionOperation operation;
+    const unsigned char *clientId;
+    unsigned long int clientIdLength;
+    const unsigned char *payload;
+    unsigned long int payloadLength;
+};
+
+/**
+ * Index entry of a segment. The ranges are only meaningful if recordCount is not 0,
+ * the transaction number range is only meaningful if transactionRecordCount is not 0.
+ */
+struct SegmentInfo {
+    uint32_t id;
+    uint32_t padding;
+    uint64_t length;
+    uint64_t recordCount;
+    uint64_t transactionRecordCount;
+    uint64_t firstSignatureCounter;
+    uint64_t lastSignatureCounter;
+    uint64_t minTransactionNumber;
+    uint64_t maxTransactionNumber;
+    int64_t minLogTime;
+    int64_t maxLogTime;
+};
+
+/**
+ * Options for opening a log store. A zero value of a member selects its default. If sharedIo is not NULL, the store
+ * uses this initialized storage backend, e.g. together with the other stores of a tenant host, instead of creating
+ * one of the type storageBackend; it MUST stay initialized until the store has been closed.
+ */
+struct LogStoreOptions {
+    uint64_t segmentSizeLimit;
+    unsigned int scanThreads;
+    bool syncEachAppend;
+    int64_t staleTransactionAge;
+    enum StorageIoBackend storageBackend;
+    struct StorageIo *sharedIo;
+};
+
+/**
+ * Describes an open transaction whose last log message is older than the stale transaction age.
+ */
+struct StaleTransaction {
+    uint64_t transactionNumber;
+    int64_t lastUpdateTime;
+    uint16_t clientIdLength;
+    unsigned char clientId[TRANSACTION_CLIENT_ID_MAX];
+};
+
+/**
+ * Callback that finishes a stale transaction, usually by invoking finishTransaction for it.
+ * The callback is invoked without holding the lock of the store and may append to the store. As the transaction
+ * may have been updated since it has been collected, the callback MUST check with logStoreTransactionUnchanged,
+ * while no log message can be appended to it, that it is still stale.
+ * @param[in] finisherContext
+ *                context that has been passed to logStoreFinishStaleTransactions [OPTIONAL]
+ * @param[in] transaction
+ *                the stale transaction [REQUIRED]
+ * @return EXECUTION_OK, ERROR_NO_TRANSACTION if the transaction has been updated or finished meanwhile and has been
+ *         left open, or the error code of finishing the transaction
+ */
+typedef short int (*StaleTransactionFinisher)(void *finisherContext,
+                                              const struct StaleTransaction *transaction);
+
+/**
+ * Callback that is invoked by the retirement of segments after every written block of a rewritten segment,
+ * e.g. to limit the rate of the I/O.
+ * @param[in] throttleContext
+ *                context that has been passed to logStoreRetireSegments [OPTIONAL]
+ * @param[in] bytesWritten
+ *                number of bytes written since the last invocation [REQUIRED]
+ * @return true to continue, false to abort the rewriting of the segment
+ */
+typedef bool (*SegmentCopyThrottle)(void *throttleContext,
+                                    uint64_t bytesWritten);
+
+/**
+ * State of an opened log store. The members are managed by the functions of this header file
+ * and MUST only be read while holding the lock.
+ */
+struct LogStore {
+    char *directory;
+    pthread_mutex_t lock;
+    pthread_mutex_t checkpointLock;
+    int activeFd;
+    struct SegmentInfo *segments;
+    struct SegmentCountEntry *segmentCounts;
+    size_t segmentCount;
+    size_t segmentCapacity;
+    struct TransactionTable openTransactions;
+    struct TimerWheel transactionTimers;
+    int64_t staleTransactionAge;
+    uint64_t lastSignatureCounter;
+    uint64_t lastTransactionNumber;
+    uint64_t exportedSignatureCounter;
+    uint64_t deletableSignatureCounter;
+    pthread_cond_t snapshotReleased;
+    uint64_t indexGeneration;
+    size_t snapshotCount;
+    size_t previousSnapshotCount;
+    bool replacingSegment;
+    struct SystemLogIndex systemLogs;
+    struct CertificateStore certificates;
+    uint64_t segmentSizeLimit;
+    unsigned int scanThreads;
+    bool syncEachAppend;
+    struct StorageIo *io;
+    bool ioShared;
+};
+
+/**
+ * Sequential reader over the records of one segment.
+ * The record returned by segmentReaderNext is valid until the next call.
+ * The reader stops at the member limit, which can be set to the length of a segment in an index snapshot.
+ * If bufferIndex is not negative, the buffer is a registered buffer of the storage backend of the store.
+ */
+struct SegmentReader {
+    int fd;
+    struct StorageIo *io;
+    int bufferIndex;
+    unsigned char *buffer;
+    size_t bufferSize;
+    size_t bufferFill;
+    size_t bufferPosition;
+    uint64_t offset;
+    uint64_t limit;
+    bool truncated;
+};
+
+/**
+ * Opens the log store in the passed directory and recovers its index.
+ * The checkpoint is loaded, the tail written after the checkpoint is replayed and segments that are not covered
+ * by the checkpoint are scanned in parallel. An incompletely written record at the end of the last segment is
+ * discarded.
+ * @param[out] store
+ *                store state to be initialized [REQUIRED]
+ * @param[in] directory
+ *                existing directory that holds the segment files and the checkpoint [REQUIRED]
+ * @param[in] options
+ *                options of the store, NULL selects the defaults [OPTIONAL]
+ * @return if the execution of the function has been successful, the return value EXECUTION_OK SHALL be returned.
+ *
+ *         If the execution of the function has failed, the appropriate error code SHALL be returned:
+ *
+ *             ERROR_PARAMETER_MISMATCH
+ *                a required parameter is missing
+ *             ERROR_STORAGE_FAILURE
+ *                the segments could not be read or a segment other than the last one is corrupted
+ */
+short int logStoreOpen(struct LogStore *store,
+                       const char *directory,
+                       const struct LogStoreOptions *options);
+
+/**
+ * Appends a log message to the store and updates the index and the set of open transactions.
+ * The signature counter of the record MUST be greater than the signature counter of all stored records.
+ * @param[in] store
+ *                opened store [REQUIRED]
+ * @param[in] record
+ *                log message to be stored [REQUIRED]
+ * @return if the execution of the function has been successful, the return value EXECUTION_OK SHALL be returned.
+ *
+ *         If the execution of the function has failed, the appropriate error code SHALL be returned:
+ *
+ *             ERROR_PARAMETER_MISMATCH
+ *                the signature counter does not follow the stored records or the clientId is too long
+ *             ERROR_NO_TRANSACTION
+ *                an update or finish record refers to a transaction that is not open
+ *             ERROR_STORAGE_FAILURE
+ *                storing of the log message failed, the log message has not been stored
+ */
+short int logStoreAppend(struct LogStore *store,
+                         const struct LogRecord *record);
+
+/**
+ * Determines the open transactions whose last log message is older than the stale transaction age.
+ * @param[in] store
+ *                opened store [REQUIRED]
+ * @param[in] now
+ *                current time in seconds since the epoch (UTC) [REQUIRED]
+ * @param[out] transactions
+ *                array that receives the stale transactions [OPTIONAL]
+ * @param[in] capacity
+ *                number of elements of the array transactions [REQUIRED]
+ * @param[out] count
+ *                number of stale transactions, which may exceed the capacity [REQUIRED]
+ * @return EXECUTION_OK
+ */
+short int logStoreStaleTransactions(struct LogStore *store,
+                                    int64_t now,
+                                    struct StaleTransaction *transactions,
+                                    size_t capacity,
+                                    size_t *count);
+
+/**
+ * Checks whether a transaction collected as stale is still open and has not been updated since.
+ * @param[in] store
+ *                opened store [REQUIRED]
+ * @param[in] transaction
+ *                the stale transaction [REQUIRED]
+ * @return true if the transaction is open and its last log message is the one it has been collected with
+ */
+bool logStoreTransactionUnchanged(struct LogStore *store,
+                                  const struct StaleTransaction *transaction);
+
+/**
+ * Finishes all stale transactions in one pass. The stale transactions are collected under the lock of the store
+ * and passed to the finisher after releasing it, so that concurrent transactions are not stalled.
+ * @param[in] store
+ *                opened store [REQUIRED]
+ * @param[in] now
+ *                current time in seconds since the epoch (UTC) [REQUIRED]
+ * @param[in] finisher
+ *                callback that finishes a transaction [REQUIRED]
+ * @param[in] finisherContext
+ *                context passed to the finisher [OPTIONAL]
+ * @param[out] finishedCount
+ *                number of transactions for which the finisher succeeded [REQUIRED]
+ * @return EXECUTION_OK, ERROR_STORAGE_FAILURE if no memory could be allocated or the first error code
+ *         returned by the finisher other than ERROR_NO_TRANSACTION
+ */
+short int logStoreFinishStaleTransactions(struct LogStore *store,
+                                          int64_t now,
+                                          StaleTransactionFinisher finisher,
+                                          void *finisherContext,
+                                          size_t *finishedCount);
+
+/**
+ * Writes a checkpoint of the index, the set of open transactions and the counter values.
+ * The checkpoint is written to a temporary file and renamed, so that a valid checkpoint exists at any time.
+ * @param[in] store
+ *                opened store [REQUIRED]
+ * @return EXECUTION_OK or ERROR_STORAGE_FAILURE if the checkpoint could not be written
+ */
+short int logStoreCheckpoint(struct LogStore *store);
+
+/**
+ * Writes a final checkpoint and closes the store.
+ * @param[in] store
+ *                opened store [REQUIRED]
+ * @return EXECUTION_OK or ERROR_STORAGE_FAILURE if the final checkpoint could not be written
+ */
+short int logStoreClose(struct LogStore *store);
+
+/**
+ * Implementation of CounterProbe that is answered from the recovered index of the store.
+ * The probeContext is the opened store.
+ */
+short int logStoreProbeCounter(void *probeContext,
+                               enum JournaledCounter counter,
+                               uint64_t fromValue,
+                               uint64_t toValue,
+                               uint64_t *highestUsed,
+                               bool *found);
+
+/**
+ * Copies the index entries of all segments. The copy stays consistent while records are appended,
+ * the entry of the active segment describes the records that have been stored up to the call.
+ * The files of the segments in the copy are not deleted or rewritten until it is released with
+ * logStoreReleaseSnapshot; the copies taken later do not delay the retirement of segments. While the first
+ * segment is rewritten, the call waits until the copies taken before are released, so a thread MUST NOT take a
+ * copy while it holds another.
+ * @param[in] store
+ *                opened store [REQUIRED]
+ * @param[out] segments
+ *                allocated copy of the index entries, to be released with logStoreReleaseSnapshot [REQUIRED]
+ * @param[out] segmentCount
+ *                number of index entries [REQUIRED]
+ * @return EXECUTION_OK or ERROR_STORAGE_FAILURE if no memory could be allocated
+ */
+short int logStoreSnapshotSegments(struct LogStore *store,
+                                   struct SegmentInfo **segments,
+                                   size_t *segmentCount);
+
+/**
+ * Releases a copy of the index entries that has been created by logStoreSnapshotSegments.
+ * @param[in] store
+ *                opened store [REQUIRED]
+ * @param[in] segments
+ *                the copy of the index entries [REQUIRED]
+ */
+void logStoreReleaseSnapshot(struct LogStore *store,
+                             struct SegmentInfo *segments);
+
+/**
+ * Records that all log messages up to a signature counter have been exported, e.g. by exportData.
+ * The value is kept in the checkpoint and only increases.
+ * @param[in] store
+ *                opened store [REQUIRED]
+ * @param[in] signatureCounter
+ *                signature counter of the last exported log message [REQUIRED]
+ */
+void logStoreMarkExported(struct LogStore *store,
+                          uint64_t signatureCounter);
+
+/**
+ * Estimates the memory allocated by the store for the open transactions, their timers and the index of the
+ * segments, which grows with the use of the store. The memory of the storage backend is not included.
+ * @param[in] store
+ *                opened store [REQUIRED]
+ * @return the number of bytes
+ */
+size_t logStoreMemoryUsage(struct LogStore *store);
+
+/**
+ * Backend part of deleteStoredData: marks the exported log messages as deletable. The deletion itself is
+ * done by logStoreRetireSegments.
+ * @param[in] store
+ *                opened store [REQUIRED]
+ * @return if the execution of the function has been successful, the return value EXECUTION_OK SHALL be returned.
+ *
+ *         If the execution of the function has failed, the appropriate error code SHALL be returned:
+ *
+ *             ERROR_UNEXPORTED_STORED_DATA
+ *                the store holds log messages, but none that have been exported and not yet deleted
+ */
+short int logStoreMarkDeletable(struct LogStore *store);
+
+/**
+ * Deletes the log messages that have been marked as deletable. The active segment is completed if it holds
+ * deletable log messages, segments that only hold deletable log messages are removed from the index and deleted,
+ * and the first remaining segment is rewritten without its deletable log messages.
+ * The lock of the store is only held to change the index. The file of a segment is not deleted or rewritten while
+ * a copy of the index entries that refers to it is held. The function MUST NOT be invoked concurrently for the
+ * same store.
+ * @param[in] store
+ *                opened store [REQUIRED]
+ * @param[in] throttle
+ *                callback invoked while a segment is rewritten [OPTIONAL]
+ * @param[in] throttleContext
+ *                context passed to the throttle [OPTIONAL]
+ * @return if the execution of the function has been successful, the return value EXECUTION_OK SHALL be returned.
+ *
+ *         If the execution of the function has failed, the appropriate error code SHALL be returned:
+ *
+ *             ERROR_DELETE_STORED_DATA_FAILED
+ *                a segment could not be completed, rewritten or deleted, or the checkpoint could not be written
+ */
+short int logStoreRetireSegments(struct LogStore *store,
+                                 SegmentCopyThrottle throttle,
+                                 void *throttleContext);
+
+/**
+ * Determines bounds of the number of stored log messages selected by a query from the count index,
+ * without reading any segment.
+ * @param[in] store
+ *                opened store [REQUIRED]
+ * @param[in] query
+ *                selected log messages [REQUIRED]
+ * @param[out] lowerBound
+ *                number of log messages that are selected for certain [REQUIRED]
+ * @param[out] upperBound
+ *                number of log messages in the segments that may contain selected log messages [REQUIRED]
+ * @return EXECUTION_OK or ERROR_PARAMETER_MISMATCH if a required parameter is missing
+ */
+short int logStoreEstimateRecords(struct LogStore *store,
+                                  const struct RecordCountQuery *query,
+                                  uint64_t *lowerBound,
+                                  uint64_t *upperBound);
+
+/**
+ * Determines the file offsets of the system log messages and audit log messages of a segment whose signature
+ * counters lie within an interval. If the interval index does not cover the segment up to the length of the passed
+ * index entry, the missing part is read once and added to the interval index.
+ * @param[in] store
+ *                opened store [REQUIRED]
+ * @param[in] info
+ *                index entry of the segment from a copy of the index entries [REQUIRED]
+ * @param[in] firstSignatureCounter
+ *                start (inclusive) of the interval [REQUIRED]
+ * @param[in] lastSignatureCounter
+ *                end (inclusive) of the interval [REQUIRED]
+ * @param[out] offsets
+ *                allocated array of the offsets in ascending order, to be released with free [REQUIRED]
+ * @param[out] offsetCount
+ *                number of offsets [REQUIRED]
+ * @return EXECUTION_OK or ERROR_STORAGE_FAILURE if the segment could not be read or no memory could be allocated
+ */
+short int logStoreSystemLogOffsets(struct LogStore *store,
+                                   const struct SegmentInfo *info,
+                                   uint64_t firstSignatureCounter,
+                                   uint64_t lastSignatureCounter,
+                                   uint64_t **offsets,
+                                   size_t *offsetCount);
+
+/**
+ * Builds the path of a segment file.
+ * @param[in] store
+ *                opened store [REQUIRED]
+ * @param[in] segmentId
+ *                id of the segment [REQUIRED]
+ * @param[out] path
+ *                buffer for the path [REQUIRED]
+ * @param[in] pathSize
+ *                size of the buffer [REQUIRED]
+ * @return EXECUTION_OK or ERROR_PARAMETER_MISMATCH if the buffer is too small
+ */
+short int logStoreSegmentPath(const struct LogStore *store,
+                              uint32_t segmentId,
+                              char *path,
+                              size_t pathSize);
+
+/**
+ * Opens a reader over the records of a segment.
+ * @param[out] reader
+ *                reader to be initialized [REQUIRED]
+ * @param[in] store
+ *                opened store [REQUIRED]
+ * @param[in] segmentId
+ *                id of the segment [REQUIRED]
+ * @param[in] offset
+ *                file offset of the first record to be read, 0 for the start of the segment [REQUIRED]
+ * @return EXECUTION_OK or ERROR_STORAGE_FAILURE if the segment could not be opened
+ */
+short int segmentReaderOpen(struct SegmentReader *reader,
+                            const struct LogStore *store,
+                            uint32_t segmentId,
+                            uint64_t offset);
+
+/**
+ * Moves a reader to the record at a file offset. Bytes of the buffer that are still valid are kept.
+ * @param[in] reader
+ *                opened reader [REQUIRED]
+ * @param[in] offset
+ *                file offset of the next record to be read [REQUIRED]
+ */
+void segmentReaderSeek(struct SegmentReader *reader,
+                       uint64_t offset);
+
+/**
+ * Reads the next record of the segment. If the end of the valid records has been reached, endOfSegment is set
+ * and the member offset of the reader holds the length of the valid part of the segment. The member truncated is
+ * set if bytes follow that do not form a valid record.
+ * @param[in] reader
+ *                opened reader [REQUIRED]
+ * @param[out] record
+ *                the record read, the arrays point into the buffer of the reader [REQUIRED]
+ * @param[out] endOfSegment
+ *                true if no further valid record exists [REQUIRED]
+ * @return EXECUTION_OK or ERROR_STORAGE_FAILURE if the segment could not be read
+ */
+short int segmentReaderNext(struct SegmentReader *reader,
+                            struct LogRecord *record,
+                            bool *endOfSegment);
+
+/**
+ * Closes a reader.
+ * @param[in] reader
+ *                opened reader [REQUIRED]
+ */
+void segmentReaderClose(struct SegmentReader *reader);
+
+#endif
@@ -0,0 +1,101 @@
+#ifndef SEAPI_BACKEND_PROFILE_H
+#define SEAPI_BACKEND_PROFILE_H
+
+#include <pthread.h>
+
+/**
+ * This header file defines the build profiles of the SE API backend, which select the policies of the backend when
+ * it is compiled instead of when it is opened, so that the policies that are not selected cost neither code nor a
+ * branch on every call.
+ *
+ * The server profile, which is built by default, serves many concurrent clients: the log store and the append path
+ * are protected by locks, the storage backend uses io_uring with registered read buffers if the kernel provides it,
+ * the recovery and the exports scan segments in parallel and the optional modules that run threads of their own
+ * (append shards, log shipping, export scheduler, background retirement) are available.
+ *
+ * The embedded profile is selected by defining SEAPI_BACKEND_PROFILE_EMBEDDED, e.g. with
+ * -DSEAPI_BACKEND_PROFILE_EMBEDDED. It serves a single client thread on a small device: the locks of the log store
+ * and of the append path are compiled to nothing, the storage backend uses blocking system calls without registered
+ * buffers, segments are smaller, the recovery runs on the calling thread, the deletion of stored data is executed by
+ * deleteStoredData itself and the modules that run threads of their own are not compiled. The functions of the
+ * backend MUST then not be invoked concurrently; the threads that an export starts only read the store while the
+ * calling thread waits for them.
+ */
+
+#if defined(SEAPI_BACKEND_PROFILE_EMBEDDED) && defined(SEAPI_BACKEND_PROFILE_SERVER)
+#error "SEAPI_BACKEND_PROFILE_EMBEDDED and SEAPI_BACKEND_PROFILE_SERVER are mutually exclusive"
+#endif
+
+#ifdef SEAPI_BACKEND_PROFILE_EMBEDDED
+
+/**
+ * Locking policy: the backend is used by one thread at a time
+ */
+#define PROFILE_CONCURRENT 0
+
+/**
+ * Storage policy: blocking system calls without registered buffers
+ */
+#define PROFILE_STORAGE_BACKEND storageIoPortable
+#define PROFILE_REGISTERED_BUFFERS 0u
+
+/**
+ * Index policy: size limit of a segment and number of threads that scan segments
+ */
+#define PROFILE_SEGMENT_SIZE (4ul * 1024ul * 1024ul)
+#define PROFILE_SCAN_THREADS 1
+
+#else
+
+#ifndef SEAPI_BACKEND_PROFILE_SERVER
+#define SEAPI_BACKEND_PROFILE_SERVER
+#endif
+
+/**
+ * Locking policy: the backend is used by many threads concurrently
+ */
+#define PROFILE_CONCURRENT 1
+
+/**
+ * Storage policy: io_uring with registered read buffers, blocking system calls if the kernel does not provide it
+ */
+#define PROFILE_STORAGE_BACKEND storageIoUring
+#define PROFILE_REGISTERED_BUFFERS 4u
+
+/**
+ * Index policy: size limit of a segment and number of threads that scan segments
+ */
+#define PROFILE_SEGMENT_SIZE (64ul * 1024ul * 1024ul)
+#define PROFILE_SCAN_THREADS 4
+
+#endif
+
+/**
+ * Takes a lock of the locking policy.
+ * @param[in] lock
+ *                the lock, which is not used by the embedded profile [REQUIRED]
+ */
+static inline void profileLock(pthread_mutex_t *lock)
+{
+#if PROFILE_CONCURRENT
+    pthread_mutex_lock(lock);
+#else
+    (void) lock;
+#endif
+}
+
+/**
+ * Releases a lock taken with profileLock.
+ * @param[in] lock
+ *                the lock, which is not used by the embedded profile [REQUIRED]
+ */
+static inline void profileUnlock(pthread_mutex_t *lock)
+{
+#if PROFILE_CONCURRENT
+    pthread_mutex_unlock(lock);
+#else
+    (void) lock;
+#endif
+}
+
+#endif
@@ -0,0 +1,221 @@
+#include <string.h>
+#include <time.h>
+
+#include "ReceiptCode.h"
+
+#define RECEIPT_CODE_VERSION "V0"
+#define RECEIPT_CODE_TIME_FORMAT "utcTime"
+#define RECEIPT_CODE_TIME_LENGTH 24
+#define RECEIPT_CODE_FIELD_COUNT 12
+
+static const char receiptCodeBase64Alphabet[64] = {
+    'A', 'B', 'C', 'D', 'E', 'F', 'G', 'H', 'I', 'J', 'K', 'L', 'M', 'N', 'O', 'P',
+    'Q', 'R', 'S', 'T', 'U', 'V', 'W', 'X', 'Y', 'Z', 'a', 'b', 'c', 'd', 'e', 'f',
+    'g', 'h', 'i', 'j', 'k', 'l', 'm', 'n', 'o', 'p', 'q', 'r', 's', 't', 'u', 'v',
+    'w', 'x', 'y', 'z', '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', '+', '/'
+};
+
+/**
+ * Two decimal digits of the values 0 to 99, so that numbers and times are formatted two digits at a time
+ */
+static const char receiptCodeDigitPairs[200] = {
+    '0', '0', '0', '1', '0', '2', '0', '3', '0', '4', '0', '5', '0', '6', '0', '7', '0', '8', '0', '9',
+    '1', '0', '1', '1', '1', '2', '1', '3', '1', '4', '1', '5', '1', '6', '1', '7', '1', '8', '1', '9',
+    '2', '0', '2', '1', '2', '2', '2', '3', '2', '4', '2', '5', '2', '6', '2', '7', '2', '8', '2', '9',
+    '3', '0', '3', '1', '3', '2', '3', '3', '3', '4', '3', '5', '3', '6', '3', '7', '3', '8', '3', '9',
+    '4', '0', '4', '1', '4', '2', '4', '3', '4', '4', '4', '5', '4', '6', '4', '7', '4', '8', '4', '9',
+    '5', '0', '5', '1', '5', '2', '5', '3', '5', '4', '5', '5', '5', '6', '5', '7', '5', '8', '5', '9',
+    '6', '0', '6', '1', '6', '2', '6', '3', '6', '4', '6', '5', '6', '6', '6', '7', '6', '8', '6', '9',
+    '7', '0', '7', '1', '7', '2', '7', '3', '7', '4', '7', '5', '7', '6', '7', '7', '7', '8', '7', '9',
+    '8', '0', '8', '1', '8', '2', '8', '3', '8', '4', '8', '5', '8', '6', '8', '7', '8', '8', '8', '9',
+    '9', '0', '9', '1', '9', '2', '9', '3', '9', '4', '9', '5', '9', '6', '9', '7', '9', '8', '9', '9'
+};
+
+/**
+ * Encodes data in Base64 with padding and returns the length of the encoding. Groups of three bytes are encoded
+ * without branches; only the last incomplete group is treated separately.
+ */
+static size_t receiptCodeBase64(const unsigned char *data,
+                                size_t dataLength,
+                                char *encoded)
+{
+    char *output = encoded;
+    size_t i;
+
+    for (i = 0; i + 3 <= dataLength; i += 3) {
+        uint32_t group = (uint32_t) data[i] << 16 | (uint32_t) data[i + 1] << 8 | data[i + 2];
+
+        output[0] = receiptCodeBase64Alphabet[group >> 18];
+        output[1] = receiptCodeBase64Alphabet[(group >> 12) & 0x3f];
+        output[2] = receiptCodeBase64Alphabet[(group >> 6) & 0x3f];
+        output[3] = receiptCodeBase64Alphabet[group & 0x3f];
+        output += 4;
+    }
+    if (i < dataLength) {
+        uint32_t group = (uint32_t) data[i] << 16 | (i + 1 < dataLength ? (uint32_t) data[i + 1] << 8 : 0);
+
+        output[0] = receiptCodeBase64Alphabet[group >> 18];
+        output[1] = receiptCodeBase64Alphabet[(group >> 12) & 0x3f];
+        output[2] = i + 1 < dataLength ? receiptCodeBase64Alphabet[(group >> 6) & 0x3f] : '=';
+        output[3] = '=';
+        output += 4;
+    }
+    return (size_t) (output - encoded);
+}
+
+static size_t receiptCodeDecimalLength(uint64_t value)
+{
+    size_t length = 1;
+
+    while (value >= 10) {
+        value /= 10;
+        length++;
+    }
+    return length;
+}
+
+/**
+ * Writes the decimal digits of a value, whose number has been determined by receiptCodeDecimalLength.
+ */
+static void receiptCodeDecimal(uint64_t value,
+                               char *output,
+                               size_t length)
+{
+    char *position = output + length;
+
+    while (value >= 100) {
+        unsigned int pair = (unsigned int) (value % 100) * 2;
+
+        value /= 100;
+        position -= 2;
+        position[0] = receiptCodeDigitPairs[pair];
+        position[1] = receiptCodeDigitPairs[pair + 1];
+    }
+    if (value >= 10) {
+        position -= 2;
+        position[0] = receiptCodeDigitPairs[value * 2];
+        position[1] = receiptCodeDigitPairs[value * 2 + 1];
+    } else {
+        position[-1] = (char) ('0' + value);
+    }
+}
+
+static char *receiptCodePair(char *output,
+                             int value,
+                             char separator)
+{
+    output[0] = receiptCodeDigitPairs[value * 2];
+    output[1] = receiptCodeDigitPairs[value * 2 + 1];
+    output[2] = separator;
+    return output + 3;
+}
+
+/**
+ * Writes a time in the format utcTime, e.g. 2019-07-10T18:41:04.000Z.
+ */
+static void receiptCodeTime(const struct tm *date,
+                            char *output)
+{
+    int year = date->tm_year + 1900;
+
+    output[0] = receiptCodeDigitPairs[(year / 100) * 2];
+    output[1] = receiptCodeDigitPairs[(year / 100) * 2 + 1];
+    output = receiptCodePair(output + 2, year % 100, '-');
+    output = receiptCodePair(output, date->tm_mon + 1, '-');
+    output = receiptCodePair(output, date->tm_mday, 'T');
+    output = receiptCodePair(output, date->tm_hour, ':');
+    output = receiptCodePair(output, date->tm_min, ':');
+    output = receiptCodePair(output, date->tm_sec, '.');
+    memcpy(output, "000Z", 4);
+}
+
+static short int receiptCodeDate(int64_t time,
+                                 struct tm *date)
+{
+    time_t value = (time_t) time;
+
+    if ((int64_t) value != time || gmtime_r(&value, date) == NULL || date->tm_year < -1900
+        || date->tm_year > 9999 - 1900) {
+        return ERROR_INVALID_TIME;
+    }
+    return EXECUTION_OK;
+}
+
+static char *receiptCodeField(char *output,
+                              const void *data,
+                              size_t dataLength)
+{
+    if (dataLength > 0) {
+        memcpy(output, data, dataLength);
+    }
+    output[dataLength] = ';';
+    return output + dataLength + 1;
+}
+
+short int receiptCodeKeyInit(struct ReceiptCodeKey *key,
+                             const char *signatureAlgorithm,
+                             size_t signatureAlgorithmLength,
+                             const unsigned char *publicKey,
+                             size_t publicKeyLength)
+{
+    if (signatureAlgorithmLength > RECEIPT_CODE_ALGORITHM_MAX || publicKeyLength > RECEIPT_CODE_PUBLIC_KEY_MAX
+        || (signatureAlgorithm == NULL && signatureAlgorithmLength > 0)
+        || (publicKey == NULL && publicKeyLength > 0)) {
+        return ERROR_PARAMETER_MISMATCH;
+    }
+    if (signatureAlgorithmLength > 0) {
+        memcpy(key->signatureAlgorithm, signatureAlgorithm, signatureAlgorithmLength);
+    }
+    key->signatureAlgorithmLength = signatureAlgorithmLength;
+    key->publicKeyLength = receiptCodeBase64(publicKey, publicKeyLength, key->publicKey);
+    return EXECUTION_OK;
+}
+
+short int receiptCodeBuild(const struct ReceiptCodeKey *key,
+                           const struct ReceiptCodeTransaction *transaction,
+                           char *code,
+                           size_t capacity,
+                           size_t *length)
+{
+    size_t transactionNumberLength = receiptCodeDecimalLength(transaction->transactionNumber);
+    size_t signatureCounterLength = receiptCodeDecimalLength(transaction->signatureCounter);
+    struct tm startDate;
+    struct tm logDate;
+    char *output = code;
+
+    *length = sizeof RECEIPT_CODE_VERSION - 1 + (RECEIPT_CODE_FIELD_COUNT - 1) + transaction->clientIdLength
+              + transaction->processTypeLength + transaction->processDataLength + transactionNumberLength
+              + signatureCounterLength + 2 * RECEIPT_CODE_TIME_LENGTH + key->signatureAlgorithmLength
+              + sizeof RECEIPT_CODE_TIME_FORMAT - 1 + RECEIPT_CODE_BASE64_LENGTH(transaction->signatureValueLength)
+              + key->publicKeyLength;
+    if (receiptCodeDate(transaction->startTime, &startDate) != EXECUTION_OK
+        || receiptCodeDate(transaction->logTime, &logDate) != EXECUTION_OK) {
+        return ERROR_INVALID_TIME;
+    }
+    if (*length > capacity) {
+        return ERROR_PARAMETER_MISMATCH;
+    }
+
+    output = receiptCodeField(output, RECEIPT_CODE_VERSION, sizeof RECEIPT_CODE_VERSION - 1);
+    output = receiptCodeField(output, transaction->clientId, transaction->clientIdLength);
+    output = receiptCodeField(output, transaction->processType, transaction->processTypeLength);
+    output = receiptCodeField(output, transaction->processData, transaction->processDataLength);
+    receiptCodeDecimal(transaction->transactionNumber, output, transactionNumberLength);
+    output[transactionNumberLength] = ';';
+    output += transactionNumberLength + 1;
+    receiptCodeDecimal(transaction->signatureCounter, output, signatureCounterLength);
+    output[signatureCounterLength] = ';';
+    output += signatureCounterLength + 1;
+    receiptCodeTime(&startDate, output);
+    output[RECEIPT_CODE_TIME_LENGTH] = ';';
+    output += RECEIPT_CODE_TIME_LENGTH + 1;
+    receiptCodeTime(&logDate, output);
+    output[RECEIPT_CODE_TIME_LENGTH] = ';';
+    output += RECEIPT_CODE_TIME_LENGTH + 1;
+    output = receiptCodeField(output, key->signatureAlgorithm, key->signatureAlgorithmLength);
+    output = receiptCodeField(output, RECEIPT_CODE_TIME_FORMAT, sizeof RECEIPT_CODE_TIME_FORMAT - 1);
+    output += receiptCodeBase64(transaction->signatureValue, transaction->signatureValueLength, output);
+    *output++ = ';';
+    memcpy(output, key->publicKey, key->publicKeyLength);
+    return EXECUTION_OK;
+}
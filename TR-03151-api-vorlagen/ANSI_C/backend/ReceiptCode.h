@@ -0,0 +1,110 @@
+#ifndef SEAPI_BACKEND_RECEIPT_CODE_H
+#define SEAPI_BACKEND_RECEIPT_CODE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "../Exception.h"
+#include "../Constant.h"
+
+/**
+ * This header file defines the builder of the receipt code of the SE API backend, i.e. the content of the QR code
+ * that a cash register prints on the receipt of a finished transaction so that the receipt can be verified:
+ *
+ *     V0;clientId;processType;processData;transactionNumber;signatureCounter;startTime;logTime;
+ *     signatureAlgorithm;logTimeFormat;signatureValue;publicKey
+ *
+ * The times are written in the format utcTime (YYYY-MM-DDThh:mm:ss.000Z), the signature value and the public key
+ * in Base64. The code is written to a buffer of the caller without allocating memory or calling formatted output
+ * functions; the Base64 form of the public key, which is the same on every receipt, is computed once when the key
+ * is set.
+ */
+
+/**
+ * Maximum lengths of the public key and of the name of the signature algorithm
+ */
+#define RECEIPT_CODE_PUBLIC_KEY_MAX 512
+#define RECEIPT_CODE_ALGORITHM_MAX 64
+
+/**
+ * Length of the Base64 form of a number of bytes
+ */
+#define RECEIPT_CODE_BASE64_LENGTH(length) (((length) + 2) / 3 * 4)
+
+/**
+ * Key data that is the same on every receipt. The members are managed by receiptCodeKeyInit.
+ */
+struct ReceiptCodeKey {
+    char signatureAlgorithm[RECEIPT_CODE_ALGORITHM_MAX];
+    size_t signatureAlgorithmLength;
+    char publicKey[RECEIPT_CODE_BASE64_LENGTH(RECEIPT_CODE_PUBLIC_KEY_MAX)];
+    size_t publicKeyLength;
+};
+
+/**
+ * Output parameters of finishTransaction and the data of the transaction that are contained in the receipt code.
+ * The times are given in seconds since the epoch (UTC).
+ */
+struct ReceiptCodeTransaction {
+    const unsigned char *clientId;
+    size_t clientIdLength;
+    const unsigned char *processType;
+    size_t processTypeLength;
+    const unsigned char *processData;
+    size_t processDataLength;
+    uint64_t transactionNumber;
+    uint64_t signatureCounter;
+    int64_t startTime;
+    int64_t logTime;
+    const unsigned char *signatureValue;
+    size_t signatureValueLength;
+};
+
+/**
+ * Sets the key data of the receipt codes.
+ * @param[out] key
+ *                key data to be initialized [REQUIRED]
+ * @param[in] signatureAlgorithm
+ *                name of the signature algorithm, e.g. ecdsa-plain-SHA256 [OPTIONAL]
+ * @param[in] signatureAlgorithmLength
+ *                length of the name, at most RECEIPT_CODE_ALGORITHM_MAX [REQUIRED]
+ * @param[in] publicKey
+ *                public key whose private key signs the log messages [OPTIONAL]
+ * @param[in] publicKeyLength
+ *                length of the public key, at most RECEIPT_CODE_PUBLIC_KEY_MAX [REQUIRED]
+ * @return EXECUTION_OK or ERROR_PARAMETER_MISMATCH if a length is out of range
+ */
+short int receiptCodeKeyInit(struct ReceiptCodeKey *key,
+                             const char *signatureAlgorithm,
+                             size_t signatureAlgorithmLength,
+                             const unsigned char *publicKey,
+                             size_t publicKeyLength);
+
+/**
+ * Builds the receipt code of a finished transaction.
+ * @param[in] key
+ *                initialized key data [REQUIRED]
+ * @param[in] transaction
+ *                data of the transaction [REQUIRED]
+ * @param[out] code
+ *                receives the receipt code, not terminated by NUL [OPTIONAL]
+ * @param[in] capacity
+ *                size of the array code [REQUIRED]
+ * @param[out] length
+ *                receives the length of the receipt code, also if it does not fit into the array [REQUIRED]
+ * @return if the execution of the function has been successful, the return value EXECUTION_OK SHALL be returned.
+ *
+ *         If the execution of the function has failed, the appropriate error code SHALL be returned:
+ *
+ *             ERROR_PARAMETER_MISMATCH
+ *                the receipt code is longer than the capacity, nothing has been written
+ *             ERROR_INVALID_TIME
+ *                a time lies outside of the years 0 to 9999
+ */
+short int receiptCodeBuild(const struct ReceiptCodeKey *key,
+                           const struct ReceiptCodeTransaction *transaction,
+                           char *code,
+                           size_t capacity,
+                           size_t *length);
+
+#endif
@@ -0,0 +1,320 @@
+#include <string.h>
+
+#include "RecentLogMessages.h"
+
+/**
+ * Copy of the key of a client entry taken by recentLogClientRead
+ */
+struct RecentLogClientKey {
+    uint64_t hash;
+    uint32_t clientIdLength;
+    uint64_t clientId[RECENT_LOG_CLIENT_ID_WORDS];
+    uint64_t messageCount;
+};
+
+static uint64_t recentLogHash(const unsigned char *clientId,
+                              uint32_t clientIdLength)
+{
+    /* FNV-1a */
+    uint64_t hash = 0xcbf29ce484222325u;
+    uint32_t i;
+
+    for (i = 0; i < clientIdLength; i++) {
+        hash ^= clientId[i];
+        hash *= 0x100000001b3u;
+    }
+    return hash;
+}
+
+static void recentLogKey(const unsigned char *clientId,
+                         uint32_t clientIdLength,
+                         uint64_t *key)
+{
+    memset(key, 0, RECENT_LOG_CLIENT_ID_WORDS * sizeof *key);
+    if (clientIdLength > 0) {
+        memcpy(key, clientId, clientIdLength);
+    }
+}
+
+static void recentLogSlotInit(struct RecentLogSlot *slot)
+{
+    int i;
+
+    atomic_init(&slot->sequence, 0);
+    atomic_init(&slot->signatureCounter, 0);
+    atomic_init(&slot->transactionNumber, 0);
+    atomic_init(&slot->logTime, 0);
+    atomic_init(&slot->type, 0);
+    atomic_init(&slot->operation, 0);
+    atomic_init(&slot->clientIdLength, 0);
+    atomic_init(&slot->payloadLength, 0);
+    for (i = 0; i < RECENT_LOG_CLIENT_ID_WORDS; i++) {
+        atomic_init(&slot->clientId[i], 0);
+    }
+    for (i = 0; i < RECENT_LOG_PAYLOAD_WORDS; i++) {
+        atomic_init(&slot->payload[i], 0);
+    }
+}
+
+/**
+ * Makes the following stores of the single writer invisible to readers until recentLogRelease.
+ */
+static void recentLogClaim(_Atomic uint64_t *sequence)
+{
+    atomic_store_explicit(sequence, atomic_load_explicit(sequence, memory_order_relaxed) + 1, memory_order_relaxed);
+    /* the data stores must not become visible before the odd sequence number */
+    atomic_thread_fence(memory_order_release);
+}
+
+static void recentLogRelease(_Atomic uint64_t *sequence)
+{
+    atomic_fetch_add_explicit(sequence, 1, memory_order_release);
+}
+
+static void recentLogSlotWrite(struct RecentLogSlot *slot,
+                               const struct LogRecord *record)
+{
+    size_t words = record->payloadLength <= RECENT_LOG_MESSAGE_PAYLOAD_SIZE ? (record->payloadLength + 7) / 8 : 0;
+    uint64_t key[RECENT_LOG_CLIENT_ID_WORDS];
+    size_t i;
+
+    recentLogKey(record->clientId, (uint32_t) record->clientIdLength, key);
+    recentLogClaim(&slot->sequence);
+    atomic_store_explicit(&slot->signatureCounter, record->signatureCounter, memory_order_relaxed);
+    atomic_store_explicit(&slot->transactionNumber, record->transactionNumber, memory_order_relaxed);
+    atomic_store_explicit(&slot->logTime, record->logTime, memory_order_relaxed);
+    atomic_store_explicit(&slot->type, (uint32_t) record->type, memory_order_relaxed);
+    atomic_store_explicit(&slot->operation, (uint32_t) record->operation, memory_order_relaxed);
+    atomic_store_explicit(&slot->clientIdLength, (uint32_t) record->clientIdLength, memory_order_relaxed);
+    atomic_store_explicit(&slot->payloadLength, (uint32_t) record->payloadLength, memory_order_relaxed);
+    for (i = 0; i < RECENT_LOG_CLIENT_ID_WORDS; i++) {
+        atomic_store_explicit(&slot->clientId[i], key[i], memory_order_relaxed);
+    }
+    for (i = 0; i < words; i++) {
+        uint64_t word = 0;
+
+        memcpy(&word, record->payload + i * 8,
+               record->payloadLength - i * 8 < sizeof word ? record->payloadLength - i * 8 : sizeof word);
+        atomic_store_explicit(&slot->payload[i], word, memory_order_relaxed);
+    }
+    recentLogRelease(&slot->sequence);
+}
+
+/**
+ * Reads a consistent copy of a slot. The clientId of the copy is returned as key in addition.
+ */
+static void recentLogSlotRead(struct RecentLogSlot *slot,
+                              struct RecentLogMessage *message,
+                              uint64_t *key)
+{
+    for (;;) {
+        uint64_t sequence = atomic_load_explicit(&slot->sequence, memory_order_acquire);
+        size_t words;
+        size_t i;
+
+        if ((sequence & 1u) != 0) {
+            continue;
+        }
+        message->signatureCounter = atomic_load_explicit(&slot->signatureCounter, memory_order_relaxed);
+        message->transactionNumber = atomic_load_explicit(&slot->transactionNumber, memory_order_relaxed);
+        message->logTime = atomic_load_explicit(&slot->logTime, memory_order_relaxed);
+        message->type = (enum LogMessageType) atomic_load_explicit(&slot->type, memory_order_relaxed);
+        message->operation = (enum TransactionOperation) atomic_load_explicit(&slot->operation,
+                                                                              memory_order_relaxed);
+        message->clientIdLength = atomic_load_explicit(&slot->clientIdLength, memory_order_relaxed);
+        message->payloadLength = atomic_load_explicit(&slot->payloadLength, memory_order_relaxed);
+        for (i = 0; i < RECENT_LOG_CLIENT_ID_WORDS; i++) {
+            key[i] = atomic_load_explicit(&slot->clientId[i], memory_order_relaxed);
+        }
+        words = message->payloadLength <= RECENT_LOG_MESSAGE_PAYLOAD_SIZE ? (message->payloadLength + 7) / 8 : 0;
+        for (i = 0; i < words; i++) {
+            uint64_t word = atomic_load_explicit(&slot->payload[i], memory_order_relaxed);
+
+            memcpy(message->payload + i * 8, &word, sizeof word);
+        }
+        atomic_thread_fence(memory_order_acquire);
+        if (atomic_load_explicit(&slot->sequence, memory_order_relaxed) == sequence) {
+            break;
+        }
+    }
+    if (message->clientIdLength > TRANSACTION_CLIENT_ID_MAX) {
+        message->clientIdLength = 0;
+    }
+    memcpy(message->clientId, key, message->clientIdLength);
+}
+
+static void recentLogClientRead(struct RecentLogClient *client,
+                                struct RecentLogClientKey *key)
+{
+    for (;;) {
+        uint64_t sequence = atomic_load_explicit(&client->sequence, memory_order_acquire);
+        int i;
+
+        if ((sequence & 1u) != 0) {
+            continue;
+        }
+        key->hash = atomic_load_explicit(&client->hash, memory_order_relaxed);
+        key->clientIdLength = atomic_load_explicit(&client->clientIdLength, memory_order_relaxed);
+        for (i = 0; i < RECENT_LOG_CLIENT_ID_WORDS; i++) {
+            key->clientId[i] = atomic_load_explicit(&client->clientId[i], memory_order_relaxed);
+        }
+        key->messageCount = atomic_load_explicit(&client->messageCount, memory_order_relaxed);
+        atomic_thread_fence(memory_order_acquire);
+        if (atomic_load_explicit(&client->sequence, memory_order_relaxed) == sequence) {
+            return;
+        }
+    }
+}
+
+/**
+ * Returns the entry of the client of a record. A client without entry takes over the first unused entry of its
+ * probe sequence or, if the table is full, the entry whose last log message is the oldest. Since entries are never
+ * released, the table stays full once it has been filled and every probe sequence still reaches every client.
+ */
+static struct RecentLogClient *recentLogClientFor(struct RecentLogMessages *messages,
+                                                  const struct LogRecord *record,
+                                                  uint64_t hash,
+                                                  const uint64_t *key)
+{
+    struct RecentLogClient *oldest = NULL;
+    struct RecentLogClient *client = NULL;
+    size_t probe;
+    int i;
+
+    for (probe = 0; probe < RECENT_LOG_CLIENT_CAPACITY; probe++) {
+        struct RecentLogClient *candidate = &messages->clients[(hash + probe) & (RECENT_LOG_CLIENT_CAPACITY - 1)];
+        uint32_t clientIdLength = atomic_load_explicit(&candidate->clientIdLength, memory_order_relaxed);
+
+        if (clientIdLength == 0) {
+            client = candidate;
+            break;
+        }
+        if (clientIdLength == record->clientIdLength
+            && atomic_load_explicit(&candidate->hash, memory_order_relaxed) == hash) {
+            for (i = 0; i < RECENT_LOG_CLIENT_ID_WORDS
+                        && atomic_load_explicit(&candidate->clientId[i], memory_order_relaxed) == key[i]; i++) {
+            }
+            if (i == RECENT_LOG_CLIENT_ID_WORDS) {
+                return candidate;
+            }
+        }
+        if (oldest == NULL || candidate->lastSignatureCounter < oldest->lastSignatureCounter) {
+            oldest = candidate;
+        }
+    }
+    if (client == NULL) {
+        client = oldest;
+    }
+
+    recentLogClaim(&client->sequence);
+    atomic_store_explicit(&client->hash, hash, memory_order_relaxed);
+    atomic_store_explicit(&client->clientIdLength, (uint32_t) record->clientIdLength, memory_order_relaxed);
+    for (i = 0; i < RECENT_LOG_CLIENT_ID_WORDS; i++) {
+        atomic_store_explicit(&client->clientId[i], key[i], memory_order_relaxed);
+    }
+    atomic_store_explicit(&client->messageCount, 0, memory_order_relaxed);
+    recentLogRelease(&client->sequence);
+    return client;
+}
+
+void recentLogMessagesInit(struct RecentLogMessages *messages)
+{
+    size_t i;
+    int j;
+
+    recentLogSlotInit(&messages->last);
+    for (i = 0; i < RECENT_LOG_CLIENT_CAPACITY; i++) {
+        struct RecentLogClient *client = &messages->clients[i];
+
+        atomic_init(&client->sequence, 0);
+        atomic_init(&client->hash, 0);
+        atomic_init(&client->clientIdLength, 0);
+        for (j = 0; j < RECENT_LOG_CLIENT_ID_WORDS; j++) {
+            atomic_init(&client->clientId[j], 0);
+        }
+        atomic_init(&client->messageCount, 0);
+        client->lastSignatureCounter = 0;
+        for (j = 0; j < RECENT_LOG_MESSAGES_PER_CLIENT; j++) {
+            recentLogSlotInit(&client->messages[j]);
+        }
+    }
+}
+
+void recentLogMessagesAdd(struct RecentLogMessages *messages,
+                          const struct LogRecord *record)
+{
+    struct RecentLogClient *client;
+    uint64_t key[RECENT_LOG_CLIENT_ID_WORDS];
+    uint64_t messageCount;
+    uint64_t hash;
+
+    recentLogSlotWrite(&messages->last, record);
+    if (record->type != transactionLogMessage || record->clientIdLength == 0
+        || record->clientIdLength > TRANSACTION_CLIENT_ID_MAX) {
+        return;
+    }
+    hash = recentLogHash(record->clientId, (uint32_t) record->clientIdLength);
+    recentLogKey(record->clientId, (uint32_t) record->clientIdLength, key);
+    client = recentLogClientFor(messages, record, hash, key);
+
+    /* the slot is complete before the message count that makes it the most recent one is published */
+    messageCount = atomic_load_explicit(&client->messageCount, memory_order_relaxed);
+    recentLogSlotWrite(&client->messages[messageCount & (RECENT_LOG_MESSAGES_PER_CLIENT - 1)], record);
+    atomic_store_explicit(&client->messageCount, messageCount + 1, memory_order_release);
+    client->lastSignatureCounter = record->signatureCounter;
+}
+
+short int recentLogMessagesLast(struct RecentLogMessages *messages,
+                                struct RecentLogMessage *message)
+{
+    uint64_t key[RECENT_LOG_CLIENT_ID_WORDS];
+
+    recentLogSlotRead(&messages->last, message, key);
+    return message->signatureCounter != 0 ? EXECUTION_OK : ERROR_NO_LOG_MESSAGE;
+}
+
+short int recentLogMessagesFind(struct RecentLogMessages *messages,
+                                const unsigned char *clientId,
+                                uint32_t clientIdLength,
+                                uint64_t transactionNumber,
+                                struct RecentLogMessage *message)
+{
+    uint64_t key[RECENT_LOG_CLIENT_ID_WORDS];
+    uint64_t slotKey[RECENT_LOG_CLIENT_ID_WORDS];
+    uint64_t hash;
+    size_t probe;
+
+    if (clientId == NULL || clientIdLength == 0 || clientIdLength > TRANSACTION_CLIENT_ID_MAX) {
+        return ERROR_NO_LOG_MESSAGE;
+    }
+    hash = recentLogHash(clientId, clientIdLength);
+    recentLogKey(clientId, clientIdLength, key);
+
+    for (probe = 0; probe < RECENT_LOG_CLIENT_CAPACITY; probe++) {
+        struct RecentLogClient *client = &messages->clients[(hash + probe) & (RECENT_LOG_CLIENT_CAPACITY - 1)];
+        struct RecentLogClientKey clientKey;
+        uint64_t i;
+
+        recentLogClientRead(client, &clientKey);
+        if (clientKey.clientIdLength == 0) {
+            break;
+        }
+        if (clientKey.hash != hash || clientKey.clientIdLength != clientIdLength
+            || memcmp(clientKey.clientId, key, sizeof key) != 0) {
+            continue;
+        }
+        /* newest first; a slot that has been overwritten meanwhile holds a newer log message or another client */
+        for (i = 0; i < clientKey.messageCount && i < RECENT_LOG_MESSAGES_PER_CLIENT; i++) {
+            uint64_t position = (clientKey.messageCount - 1 - i) & (RECENT_LOG_MESSAGES_PER_CLIENT - 1);
+
+            recentLogSlotRead(&client->messages[position], message, slotKey);
+            if (message->signatureCounter != 0 && message->clientIdLength == clientIdLength
+                && memcmp(slotKey, key, sizeof key) == 0
+                && (transactionNumber == 0 || message->transactionNumber == transactionNumber)) {
+                return EXECUTION_OK;
+            }
+        }
+        break;
+    }
+    return ERROR_NO_LOG_MESSAGE;
+}
@@ -0,0 +1,160 @@
+#ifndef SEAPI_BACKEND_RECENT_LOG_MESSAGES_H
+#define SEAPI_BACKEND_RECENT_LOG_MESSAGES_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "../Exception.h"
+#include "../Constant.h"
+#include "LogStore.h"
+
+/**
+ * This header file defines the in-memory copies of the most recent log messages of the SE API backend, from which
+ * readLogMessage is answered without reading the store.
+ *
+ * The last log message and, for every client, a ring of its most recent transaction log messages are kept in slots
+ * that are protected by sequence locks. The rings are found through an open-addressing table of fixed size keyed by
+ * the clientId. If all entries of the table are used, the ring of the client whose last log message is the oldest is
+ * taken over. Readers, e.g. cash registers that poll the log message of every transaction to print the QR code of
+ * the receipt, neither take a lock nor write to shared memory and retry if a slot changed while they read it. Log
+ * messages are added by a single writer, i.e. under the lock that orders the appends to the store.
+ */
+
+/**
+ * Number of clients whose log messages are kept, a power of two
+ */
+#define RECENT_LOG_CLIENT_CAPACITY 64
+
+/**
+ * Number of log messages kept per client, a power of two
+ */
+#define RECENT_LOG_MESSAGES_PER_CLIENT 8
+
+/**
+ * Maximum length of a payload that is kept in memory, a multiple of 8. The payload of longer log messages is not
+ * kept and has to be read from the store.
+ */
+#define RECENT_LOG_MESSAGE_PAYLOAD_SIZE 1024
+
+#define RECENT_LOG_CLIENT_ID_WORDS (TRANSACTION_CLIENT_ID_MAX / 8)
+#define RECENT_LOG_PAYLOAD_WORDS (RECENT_LOG_MESSAGE_PAYLOAD_SIZE / 8)
+
+/**
+ * Slot of a log message. All members are only accessed atomically; the data members are valid if the sequence
+ * number is even and has not changed while they have been read. A signatureCounter of 0 marks an empty slot.
+ */
+struct RecentLogSlot {
+    _Atomic uint64_t sequence;
+    _Atomic uint64_t signatureCounter;
+    _Atomic uint64_t transactionNumber;
+    _Atomic int64_t logTime;
+    _Atomic uint32_t type;
+    _Atomic uint32_t operation;
+    _Atomic uint32_t clientIdLength;
+    _Atomic uint32_t payloadLength;
+    _Atomic uint64_t clientId[RECENT_LOG_CLIENT_ID_WORDS];
+    _Atomic uint64_t payload[RECENT_LOG_PAYLOAD_WORDS];
+};
+
+/**
+ * Entry of the client table with the ring of the log messages of the client. The key members are protected by the
+ * sequence number of the entry, messageCount is the number of log messages added to the ring since the client has
+ * taken over the entry. The member lastSignatureCounter is only accessed by the writer.
+ */
+struct RecentLogClient {
+    _Atomic uint64_t sequence;
+    _Atomic uint64_t hash;
+    _Atomic uint32_t clientIdLength;
+    _Atomic uint64_t clientId[RECENT_LOG_CLIENT_ID_WORDS];
+    _Atomic uint64_t messageCount;
+    uint64_t lastSignatureCounter;
+    struct RecentLogSlot messages[RECENT_LOG_MESSAGES_PER_CLIENT];
+};
+
+/**
+ * Recent log messages. The members are managed by the functions of this header file.
+ */
+struct RecentLogMessages {
+    struct RecentLogSlot last;
+    struct RecentLogClient clients[RECENT_LOG_CLIENT_CAPACITY];
+};
+
+/**
+ * Copy of a log message returned by the read functions. The payload is only contained if payloadLength does not
+ * exceed RECENT_LOG_MESSAGE_PAYLOAD_SIZE.
+ */
+struct RecentLogMessage {
+    uint64_t signatureCounter;
+    uint64_t transactionNumber;
+    int64_t logTime;
+    enum LogMessageType type;
+    enum TransactionOperation operation;
+    uint32_t clientIdLength;
+    uint32_t payloadLength;
+    unsigned char clientId[TRANSACTION_CLIENT_ID_MAX];
+    unsigned char payload[RECENT_LOG_MESSAGE_PAYLOAD_SIZE];
+};
+
+/**
+ * Initializes empty recent log messages.
+ * @param[out] messages
+ *                recent log messages to be initialized [REQUIRED]
+ */
+void recentLogMessagesInit(struct RecentLogMessages *messages);
+
+/**
+ * Adds a stored log message. Transaction log messages are also added to the ring of their client.
+ * The function MUST NOT be invoked concurrently for the same recent log messages.
+ * @param[in] messages
+ *                initialized recent log messages [REQUIRED]
+ * @param[in] record
+ *                log message that has been appended to the store [REQUIRED]
+ */
+void recentLogMessagesAdd(struct RecentLogMessages *messages,
+                          const struct LogRecord *record);
+
+/**
+ * Reads the last added log message. The function does not block.
+ * @param[in] messages
+ *                initialized recent log messages [REQUIRED]
+ * @param[out] message
+ *                receives the copy of the log message [REQUIRED]
+ * @return if the execution of the function has been successful, the return value EXECUTION_OK SHALL be returned.
+ *
+ *         If the execution of the function has failed, the appropriate error code SHALL be returned:
+ *
+ *             ERROR_NO_LOG_MESSAGE
+ *                no log message has been added
+ */
+short int recentLogMessagesLast(struct RecentLogMessages *messages,
+                                struct RecentLogMessage *message);
+
+/**
+ * Reads the most recent log message of a client, optionally restricted to one transaction. The function does not
+ * block.
+ * @param[in] messages
+ *                initialized recent log messages [REQUIRED]
+ * @param[in] clientId
+ *                the ID of the client [REQUIRED]
+ * @param[in] clientIdLength
+ *                the length of the array that represents the clientId [REQUIRED]
+ * @param[in] transactionNumber
+ *                number of the transaction, 0 for any transaction of the client [REQUIRED]
+ * @param[out] message
+ *                receives the copy of the log message [REQUIRED]
+ * @return if the execution of the function has been successful, the return value EXECUTION_OK SHALL be returned.
+ *
+ *         If the execution of the function has failed, the appropriate error code SHALL be returned:
+ *
+ *             ERROR_NO_LOG_MESSAGE
+ *                no log message of the client or the transaction is among the kept log messages
+ */
+short int recentLogMessagesFind(struct RecentLogMessages *messages,
+                                const unsigned char *clientId,
+                                uint32_t clientIdLength,
+                                uint64_t transactionNumber,
+                                struct RecentLogMessage *message);
+
+#endif
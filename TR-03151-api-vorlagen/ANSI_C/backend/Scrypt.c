@@ -0,0 +1,164 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "Scrypt.h"
+#include "Sha256.h"
+
+#define SCRYPT_ROTATE(value, count) (((value) << (count)) | ((value) >> (32 - (count))))
+
+static void salsa208(uint32_t *block)
+{
+    uint32_t x[16];
+    int round;
+    int i;
+
+    memcpy(x, block, sizeof x);
+    for (round = 0; round < 8; round += 2) {
+        x[4] ^= SCRYPT_ROTATE(x[0] + x[12], 7);
+        x[8] ^= SCRYPT_ROTATE(x[4] + x[0], 9);
+        x[12] ^= SCRYPT_ROTATE(x[8] + x[4], 13);
+        x[0] ^= SCRYPT_ROTATE(x[12] + x[8], 18);
+        x[9] ^= SCRYPT_ROTATE(x[5] + x[1], 7);
+        x[13] ^= SCRYPT_ROTATE(x[9] + x[5], 9);
+        x[1] ^= SCRYPT_ROTATE(x[13] + x[9], 13);
+        x[5] ^= SCRYPT_ROTATE(x[1] + x[13], 18);
+        x[14] ^= SCRYPT_ROTATE(x[10] + x[6], 7);
+        x[2] ^= SCRYPT_ROTATE(x[14] + x[10], 9);
+        x[6] ^= SCRYPT_ROTATE(x[2] + x[14], 13);
+        x[10] ^= SCRYPT_ROTATE(x[6] + x[2], 18);
+        x[3] ^= SCRYPT_ROTATE(x[15] + x[11], 7);
+        x[7] ^= SCRYPT_ROTATE(x[3] + x[15], 9);
+        x[11] ^= SCRYPT_ROTATE(x[7] + x[3], 13);
+        x[15] ^= SCRYPT_ROTATE(x[11] + x[7], 18);
+        x[1] ^= SCRYPT_ROTATE(x[0] + x[3], 7);
+        x[2] ^= SCRYPT_ROTATE(x[1] + x[0], 9);
+        x[3] ^= SCRYPT_ROTATE(x[2] + x[1], 13);
+        x[0] ^= SCRYPT_ROTATE(x[3] + x[2], 18);
+        x[6] ^= SCRYPT_ROTATE(x[5] + x[4], 7);
+        x[7] ^= SCRYPT_ROTATE(x[6] + x[5], 9);
+        x[4] ^= SCRYPT_ROTATE(x[7] + x[6], 13);
+        x[5] ^= SCRYPT_ROTATE(x[4] + x[7], 18);
+        x[11] ^= SCRYPT_ROTATE(x[10] + x[9], 7);
+        x[8] ^= SCRYPT_ROTATE(x[11] + x[10], 9);
+        x[9] ^= SCRYPT_ROTATE(x[8] + x[11], 13);
+        x[10] ^= SCRYPT_ROTATE(x[9] + x[8], 18);
+        x[12] ^= SCRYPT_ROTATE(x[15] + x[14], 7);
+        x[13] ^= SCRYPT_ROTATE(x[12] + x[15], 9);
+        x[14] ^= SCRYPT_ROTATE(x[13] + x[12], 13);
+        x[15] ^= SCRYPT_ROTATE(x[14] + x[13], 18);
+    }
+    for (i = 0; i < 16; i++) {
+        block[i] += x[i];
+    }
+}
+
+/**
+ * scryptBlockMix over 2 * blockSize blocks of 16 words; the output is written to output
+ */
+static void scryptBlockMix(const uint32_t *input,
+                           uint32_t *output,
+                           uint32_t blockSize)
+{
+    uint32_t x[16];
+    uint32_t i;
+    int j;
+
+    memcpy(x, &input[(2 * blockSize - 1) * 16], sizeof x);
+    for (i = 0; i < 2 * blockSize; i++) {
+        for (j = 0; j < 16; j++) {
+            x[j] ^= input[i * 16 + j];
+        }
+        salsa208(x);
+        /* even blocks go to the first half of the output, odd blocks to the second half */
+        memcpy(&output[((i & 1u) * blockSize + i / 2) * 16], x, sizeof x);
+    }
+}
+
+static void scryptRoMix(unsigned char *block,
+                        uint32_t blockSize,
+                        uint64_t cost,
+                        uint32_t *memory,
+                        uint32_t *x,
+                        uint32_t *y)
+{
+    size_t words = 32 * (size_t) blockSize;
+    uint64_t i;
+    size_t k;
+
+    for (k = 0; k < words; k++) {
+        x[k] = (uint32_t) block[4 * k] | (uint32_t) block[4 * k + 1] << 8
+               | (uint32_t) block[4 * k + 2] << 16 | (uint32_t) block[4 * k + 3] << 24;
+    }
+    for (i = 0; i < cost; i++) {
+        memcpy(&memory[i * words], x, words * sizeof *x);
+        scryptBlockMix(x, y, blockSize);
+        memcpy(x, y, words * sizeof *x);
+    }
+    for (i = 0; i < cost; i++) {
+        uint64_t j = x[(2 * blockSize - 1) * 16] & (cost - 1);
+        for (k = 0; k < words; k++) {
+            x[k] ^= memory[j * words + k];
+        }
+        scryptBlockMix(x, y, blockSize);
+        memcpy(x, y, words * sizeof *x);
+    }
+    for (k = 0; k < words; k++) {
+        block[4 * k] = (unsigned char) x[k];
+        block[4 * k + 1] = (unsigned char) (x[k] >> 8);
+        block[4 * k + 2] = (unsigned char) (x[k] >> 16);
+        block[4 * k + 3] = (unsigned char) (x[k] >> 24);
+    }
+}
+
+short int scryptDerive(const unsigned char *password,
+                       size_t passwordLength,
+                       const unsigned char *salt,
+                       size_t saltLength,
+                       unsigned int costLog2,
+                       uint32_t blockSize,
+                       uint32_t parallelism,
+                       unsigned char *output,
+                       size_t outputLength)
+{
+    uint64_t cost;
+    size_t blockLength;
+    unsigned char *blocks;
+    uint32_t *memory;
+    uint32_t *scratch;
+    uint32_t i;
+
+    if (costLog2 < 1 || costLog2 > 30 || blockSize == 0 || parallelism == 0
+        || (uint64_t) blockSize * parallelism >= (1u << 30) || blockSize > SIZE_MAX / 256 / parallelism) {
+        return ERROR_PARAMETER_MISMATCH;
+    }
+    cost = (uint64_t) 1 << costLog2;
+    blockLength = 128 * (size_t) blockSize;
+    if (cost > SIZE_MAX / blockLength) {
+        return ERROR_PARAMETER_MISMATCH;
+    }
+
+    blocks = malloc(blockLength * parallelism);
+    memory = malloc((size_t) cost * blockLength);
+    scratch = malloc(2 * blockLength);
+    if (blocks == NULL || memory == NULL || scratch == NULL) {
+        free(blocks);
+        free(memory);
+        free(scratch);
+        return ERROR_STORAGE_FAILURE;
+    }
+
+    pbkdf2HmacSha256(password, passwordLength, salt, saltLength, 1, blocks, blockLength * parallelism);
+    for (i = 0; i < parallelism; i++) {
+        scryptRoMix(blocks + i * blockLength, blockSize, cost, memory, scratch, scratch + 32 * blockSize);
+    }
+    pbkdf2HmacSha256(password, passwordLength, blocks, blockLength * parallelism, 1, output, outputLength);
+
+    /* the intermediate state allows to verify guesses of the password, so it is cleared */
+    memset(blocks, 0, blockLength * parallelism);
+    memset(memory, 0, (size_t) cost * blockLength);
+    memset(scratch, 0, 2 * blockLength);
+    free(blocks);
+    free(memory);
+    free(scratch);
+    return EXECUTION_OK;
+}
@@ -0,0 +1,62 @@
+#ifndef SEAPI_BACKEND_SCRYPT_H
+#define SEAPI_BACKEND_SCRYPT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "../Exception.h"
+#include "../Constant.h"
+
+/**
+ * This header file defines the memory-hard key derivation function scrypt (RFC 7914), which the SE API backend
+ * uses to store PINs and PUKs. The derivation needs 128 * blockSize * costParameter bytes of memory, so that
+ * guessing short PINs from stored hashes is expensive also on dedicated hardware.
+ */
+
+/**
+ * Parameters used for new PIN and PUK hashes: 2^15 * 128 * 8 bytes = 32 MiB of memory per derivation
+ */
+#define SCRYPT_DEFAULT_COST_LOG2 15
+#define SCRYPT_DEFAULT_BLOCK_SIZE 8
+#define SCRYPT_DEFAULT_PARALLELISM 1
+
+/**
+ * Derives key material with scrypt.
+ * @param[in] password
+ *                password, e.g. the PIN [REQUIRED]
+ * @param[in] passwordLength
+ *                length of the array that represents the password [REQUIRED]
+ * @param[in] salt
+ *                salt [REQUIRED]
+ * @param[in] saltLength
+ *                length of the array that represents the salt [REQUIRED]
+ * @param[in] costLog2
+ *                binary logarithm of the CPU/memory cost parameter N, between 1 and 30 [REQUIRED]
+ * @param[in] blockSize
+ *                block size parameter r [REQUIRED]
+ * @param[in] parallelism
+ *                parallelization parameter p [REQUIRED]
+ * @param[out] output
+ *                derived key material [REQUIRED]
+ * @param[in] outputLength
+ *                length of the derived key material [REQUIRED]
+ * @return if the execution of the function has been successful, the return value EXECUTION_OK SHALL be returned.
+ *
+ *         If the execution of the function has failed, the appropriate error code SHALL be returned:
+ *
+ *             ERROR_PARAMETER_MISMATCH
+ *                a parameter lies outside the range of RFC 7914
+ *             ERROR_STORAGE_FAILURE
+ *                the memory of the derivation could not be allocated
+ */
+short int scryptDerive(const unsigned char *password,
+                       size_t passwordLength,
+                       const unsigned char *salt,
+                       size_t saltLength,
+                       unsigned int costLog2,
+                       uint32_t blockSize,
+                       uint32_t parallelism,
+                       unsigned char *output,
+                       size_t outputLength);
+
+#endif
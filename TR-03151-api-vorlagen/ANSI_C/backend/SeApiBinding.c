@@ -0,0 +1,1426 @@
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "SeApiBinding.h"
+#include "ExportScan.h"
+
+#define SE_API_BINDING_JOURNAL_FILE_NAME "counters.jnl"
+#define SE_API_BINDING_COLUMNS_DIRECTORY_NAME "analytics"
+#define SE_API_BINDING_MAX_PROCESS_TYPE_LENGTH 100
+#define SE_API_BINDING_STACK_PAYLOAD_SIZE 4096
+
+/**
+ * Indexes of the times taken by a traced call of seApiBindingLog, at which its phases end
+ */
+#define SE_API_BINDING_TRACE_CALL 0
+#define SE_API_BINDING_TRACE_LOCKED 1
+#define SE_API_BINDING_TRACE_COUNTERS 2
+#define SE_API_BINDING_TRACE_STORAGE 3
+#define SE_API_BINDING_TRACE_INDEX 4
+#define SE_API_BINDING_TRACE_RECEIPT_CODE 5
+#define SE_API_BINDING_TRACE_REPLICATION 6
+#define SE_API_BINDING_TRACE_TIMES 7
+
+static int64_t seApiBindingRealTime(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_REALTIME, &now);
+    return (int64_t) now.tv_sec;
+}
+
+static int64_t seApiBindingMonotonicTime(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (int64_t) now.tv_sec;
+}
+
+#if PROFILE_CONCURRENT
+static uint64_t seApiBindingMonotonicNanoseconds(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t) now.tv_sec * 1000000000ull + (uint64_t) now.tv_nsec;
+}
+#endif
+
+/**
+ * Allocates the signature counter and appends the record. The caller holds the append lock, so that the
+ * records reach the store in the order of their signature counters and the recent log messages have a single
+ * writer. The signature counter is only handed out once the record has been stored, so that a rejected record
+ * leaves no gap. ERROR_CERTIFICATE_EXPIRED is returned after the record has been appended. If traceTimes is not
+ * NULL, the ends of the phases are taken.
+ */
+static short int seApiBindingAppend(struct SeApiBinding *binding,
+                                    struct LogRecord *record,
+                                    int64_t *results,
+                                    uint64_t *traceTimes)
+{
+    short int result;
+
+    result = counterJournalReserve(&binding->journal, journaledSignatureCounter, &record->signatureCounter);
+    if (result != EXECUTION_OK) {
+        return result;
+    }
+    /* a standby key takes over between the previous log message and this one; if that fails, the active key is
+       used until the next log message tries again. If this log message is not stored, the next one takes over its
+       signature counter, so that the key is still in use from the first log message stored after the switch */
+    if (keyManagerDue(&binding->keys, record->logTime)) {
+        result = keyManagerActivate(&binding->keys, record->signatureCounter, &binding->receiptCodeKey);
+    }
+    if (keyManagerDisabled(&binding->keys)) {
+        return result != EXECUTION_OK ? result : ERROR_SECURE_ELEMENT_DISABLED;
+    }
+    if (traceTimes != NULL) {
+        traceTimes[SE_API_BINDING_TRACE_COUNTERS] = transactionTraceNow();
+    }
+    result = logStoreAppend(&binding->store, record);
+    if (result != EXECUTION_OK) {
+        return result;
+    }
+    counterJournalCommit(&binding->journal, journaledSignatureCounter);
+    if (traceTimes != NULL) {
+        traceTimes[SE_API_BINDING_TRACE_STORAGE] = transactionTraceNow();
+    }
+    recentLogMessagesAdd(&binding->recentLogMessages, record);
+    if (atomic_load(&binding->columns) != NULL) {
+        /* the column store is derived, rows that cannot be added are added again when it is opened */
+        transactionColumnsAdd(atomic_load(&binding->columns), record);
+    }
+#if PROFILE_CONCURRENT
+    if (binding->shipper != NULL) {
+        logShipperNotify(binding->shipper, record->signatureCounter);
+    }
+#endif
+    if (traceTimes != NULL) {
+        traceTimes[SE_API_BINDING_TRACE_INDEX] = transactionTraceNow();
+    }
+    results[SE_API_BINDING_TRANSACTION_NUMBER] = (int64_t) record->transactionNumber;
+    results[SE_API_BINDING_SIGNATURE_COUNTER] = (int64_t) record->signatureCounter;
+    results[SE_API_BINDING_LOG_TIME] = record->logTime;
+    return keyManagerExpired(&binding->keys, record->logTime) ? ERROR_CERTIFICATE_EXPIRED : EXECUTION_OK;
+}
+
+short int seApiBindingOpen(const char *directory,
+                           int64_t *results)
+{
+    return seApiBindingOpenShared(directory, NULL, results);
+}
+
+short int seApiBindingOpenShared(const char *directory,
+                                 const struct SeApiBindingShared *shared,
+                                 int64_t *results)
+{
+    struct SeApiBinding *binding;
+    struct LogStoreOptions options;
+    char journalPath[4096];
+    int length;
+    short int result;
+
+    if (directory == NULL || results == NULL) {
+        return ERROR_PARAMETER_MISMATCH;
+    }
+    length = snprintf(journalPath, sizeof journalPath, "%s/%s", directory, SE_API_BINDING_JOURNAL_FILE_NAME);
+    if (length < 0 || (size_t) length >= sizeof journalPath) {
+        return ERROR_PARAMETER_MISMATCH;
+    }
+    binding = calloc(1, sizeof *binding);
+    if (binding == NULL) {
+        return ERROR_STORAGE_FAILURE;
+    }
+
+    /* the storage backend of the build profile; io_uring is used if the kernel provides it */
+    memset(&options, 0, sizeof options);
+    options.storageBackend = PROFILE_STORAGE_BACKEND;
+    options.sharedIo = shared != NULL ? shared->io : NULL;
+    result = logStoreOpen(&binding->store, directory, &options);
+    if (result != EXECUTION_OK) {
+        free(binding);
+        return result;
+    }
+    result = counterJournalOpen(&binding->journal, journalPath, 0, logStoreProbeCounter, &binding->store);
+    if (result == EXECUTION_OK) {
+        result = seDescriptionLoad(&binding->description, directory);
+        if (result == EXECUTION_OK) {
+            result = userSessionsOpen(&binding->userSessions, directory, 0);
+        }
+        if (result == EXECUTION_OK) {
+            receiptCodeKeyInit(&binding->receiptCodeKey, NULL, 0, NULL, 0);
+            result = keyManagerOpen(&binding->keys, directory, &binding->store.certificates, &binding->receiptCodeKey);
+            if (result != EXECUTION_OK) {
+                userSessionsClose(&binding->userSessions);
+            }
+        }
+        if (result == EXECUTION_OK) {
+            /* a shared retirer also resumes a retirement that has been interrupted by a restart */
+            binding->retirer = shared != NULL && shared->retirer != NULL ? shared->retirer : &binding->ownRetirer;
+            result = binding->retirer != &binding->ownRetirer ? segmentRetirerAdd(binding->retirer, &binding->store)
+                     : segmentRetirerStart(binding->retirer, &binding->store, 0);
+            if (result != EXECUTION_OK) {
+                keyManagerClose(&binding->keys);
+                userSessionsClose(&binding->userSessions);
+            }
+        }
+        if (result != EXECUTION_OK) {
+            counterJournalClose(&binding->journal);
+        }
+    }
+    if (result != EXECUTION_OK) {
+        logStoreClose(&binding->store);
+        free(binding);
+        return result;
+    }
+
+    recentLogMessagesInit(&binding->recentLogMessages);
+    binding->trace = shared != NULL && shared->trace != NULL ? shared->trace : &binding->ownTrace;
+    if (binding->trace == &binding->ownTrace) {
+        transactionTraceInit(&binding->ownTrace);
+    }
+    binding->traceSource = transactionTraceAddSource(binding->trace, directory);
+    pthread_mutex_init(&binding->appendLock, NULL);
+    atomic_init(&binding->timeSet, false);
+    atomic_init(&binding->timeOffset, 0);
+    atomic_init(&binding->columns, NULL);
+    binding->memoryQuota = shared != NULL ? shared->memoryQuota : 0;
+#if PROFILE_CONCURRENT
+    atomic_init(&binding->shards, NULL);
+    atomic_init(&binding->exportScheduler, shared != NULL ? shared->exportScheduler : NULL);
+    binding->exportSchedulerShared = shared != NULL && shared->exportScheduler != NULL;
+    atomic_init(&binding->exportQueued, false);
+#endif
+    results[0] = (int64_t) (intptr_t) binding;
+    return EXECUTION_OK;
+}
+
+short int seApiBindingClose(struct SeApiBinding *binding)
+{
+    short int journalResult;
+    short int storeResult;
+
+#if PROFILE_CONCURRENT
+    if (binding->shipper != NULL) {
+        logShipperStop(binding->shipper);
+        free(binding->shipper);
+    }
+    if (atomic_load(&binding->shards) != NULL) {
+        appendShardsFree(atomic_load(&binding->shards));
+        free(atomic_load(&binding->shards));
+    }
+    if (atomic_load(&binding->exportScheduler) != NULL && !binding->exportSchedulerShared) {
+        exportSchedulerStop(atomic_load(&binding->exportScheduler));
+        free(atomic_load(&binding->exportScheduler));
+    }
+#endif
+    if (atomic_load(&binding->columns) != NULL) {
+        transactionColumnsClose(atomic_load(&binding->columns));
+        free(atomic_load(&binding->columns));
+    }
+    if (binding->retirer != &binding->ownRetirer) {
+        segmentRetirerRemove(binding->retirer, &binding->store);
+    } else {
+        segmentRetirerStop(binding->retirer);
+    }
+    keyManagerClose(&binding->keys);
+    userSessionsClose(&binding->userSessions);
+    journalResult = counterJournalClose(&binding->journal);
+    storeResult = logStoreClose(&binding->store);
+    if (binding->trace == &binding->ownTrace) {
+        transactionTraceClose(&binding->ownTrace);
+    }
+    pthread_mutex_destroy(&binding->appendLock);
+    free(binding);
+    return storeResult != EXECUTION_OK ? storeResult : journalResult;
+}
+
+short int seApiBindingUpdateTime(struct SeApiBinding *binding,
+                                 int64_t newTime,
+                                 int64_t *results)
+{
+    static const unsigned char payload[] = "updateTime";
+    struct LogRecord record;
+    short int result;
+
+    if (newTime <= 0) {
+        return ERROR_INVALID_TIME;
+    }
+    memset(&record, 0, sizeof record);
+    record.type = systemLogMessage;
+    record.operation = noTransactionOperation;
+    record.logTime = newTime;
+    record.payload = payload;
+    record.payloadLength = sizeof payload - 1;
+
+    profileLock(&binding->appendLock);
+    result = seApiBindingAppend(binding, &record, results, NULL);
+    if (result == EXECUTION_OK || result == ERROR_CERTIFICATE_EXPIRED) {
+        atomic_store(&binding->timeOffset, newTime - seApiBindingRealTime());
+        atomic_store(&binding->timeSet, true);
+    }
+    profileUnlock(&binding->appendLock);
+    return result;
+}
+
+/**
+ * Builds the receipt code of a transaction that is about to be finished. The caller holds the append lock.
+ */
+static void seApiBindingReceiptCode(struct SeApiBinding *binding,
+                                    const struct LogRecord *record,
+                                    int64_t startTime,
+                                    const unsigned char *processType,
+                                    uint64_t processTypeLength,
+                                    char *receiptCode,
+                                    uint64_t receiptCodeCapacity,
+                                    int64_t *results)
+{
+    struct ReceiptCodeTransaction transaction;
+    size_t length = 0;
+
+    memset(&transaction, 0, sizeof transaction);
+    transaction.clientId = record->clientId;
+    transaction.clientIdLength = record->clientIdLength;
+    transaction.processType = processType;
+    transaction.processTypeLength = (size_t) processTypeLength;
+    transaction.processData = record->payload + 1 + processTypeLength;
+    transaction.processDataLength = (size_t) (record->payloadLength - 1 - processTypeLength);
+    transaction.transactionNumber = record->transactionNumber;
+    transaction.signatureCounter = record->signatureCounter;
+    transaction.startTime = startTime;
+    transaction.logTime = record->logTime;
+    if (receiptCodeBuild(&binding->receiptCodeKey, &transaction, receiptCode, (size_t) receiptCodeCapacity,
+                         &length) == ERROR_INVALID_TIME) {
+        length = 0;
+    }
+    results[SE_API_BINDING_RECEIPT_CODE_LENGTH] = (int64_t) length;
+}
+
+/**
+ * Log message of seApiBindingLog, which is stored either by the calling thread or through the append shards. The
+ * times of the phases are taken if traceTimes is not NULL, which is reset if the transaction is not sampled.
+ */
+struct SeApiBindingLogRequest {
+    struct SeApiBinding *binding;
+    struct LogRecord *record;
+    const unsigned char *processType;
+    uint64_t processTypeLength;
+    char *receiptCode;
+    uint64_t receiptCodeCapacity;
+    int64_t *results;
+    uint64_t *traceTimes;
+#if PROFILE_CONCURRENT
+    struct LogShipper *shipper;
+    unsigned int semiSynchronousTimeout;
+#endif
+};
+
+/**
+ * Stores the log message of seApiBindingLog. The caller holds the append lock.
+ */
+static short int seApiBindingLogLocked(struct SeApiBindingLogRequest *request)
+{
+    struct SeApiBinding *binding = request->binding;
+    struct LogRecord *record = request->record;
+    uint64_t lockedTime = request->traceTimes != NULL ? transactionTraceNow() : 0;
+    int64_t startTime = 0;
+    short int result = EXECUTION_OK;
+
+    record->logTime = seApiBindingRealTime() + atomic_load(&binding->timeOffset);
+    if (record->operation == startTransactionOperation) {
+        /* the open transactions are the part of the memory of a backend that its clients let grow */
+        result = binding->memoryQuota != 0
+                 && sizeof *binding + logStoreMemoryUsage(&binding->store) >= binding->memoryQuota
+                 ? ERROR_START_TRANSACTION_FAILED
+                 : counterJournalReserve(&binding->journal, journaledTransactionNumber, &record->transactionNumber);
+    }
+    /* the sample is drawn once the transaction number of startTransaction has been allocated */
+    if (request->traceTimes != NULL) {
+        if (result == EXECUTION_OK && transactionTraceSampled(binding->trace, record->transactionNumber)) {
+            request->traceTimes[SE_API_BINDING_TRACE_LOCKED] = lockedTime;
+        } else {
+            request->traceTimes = NULL;
+        }
+    }
+    if (result == EXECUTION_OK && request->receiptCode != NULL) {
+        struct OpenTransaction *open;
+
+        /* the start time is taken before the finish record removes the open transaction */
+        profileLock(&binding->store.lock);
+        open = transactionTableFind(&binding->store.openTransactions, record->transactionNumber);
+        startTime = open != NULL ? open->startTime : record->logTime;
+        profileUnlock(&binding->store.lock);
+    }
+    if (result == EXECUTION_OK) {
+        result = seApiBindingAppend(binding, record, request->results, request->traceTimes);
+    }
+    /* like the signature counter, the transaction number is only handed out with a stored log message */
+    if ((result == EXECUTION_OK || result == ERROR_CERTIFICATE_EXPIRED)
+        && record->operation == startTransactionOperation) {
+        counterJournalCommit(&binding->journal, journaledTransactionNumber);
+    }
+    if ((result == EXECUTION_OK || result == ERROR_CERTIFICATE_EXPIRED) && request->receiptCode != NULL) {
+        seApiBindingReceiptCode(binding, record, startTime, request->processType, request->processTypeLength,
+                                request->receiptCode, request->receiptCodeCapacity, request->results);
+        if (request->traceTimes != NULL) {
+            request->traceTimes[SE_API_BINDING_TRACE_RECEIPT_CODE] = transactionTraceNow();
+        }
+    }
+#if PROFILE_CONCURRENT
+    request->shipper = binding->shipper;
+    request->semiSynchronousTimeout = binding->semiSynchronousTimeout;
+#endif
+    return result;
+}
+
+#if PROFILE_CONCURRENT
+/**
+ * Implementation of AppendExecutor for the requests of seApiBindingLog.
+ */
+static short int seApiBindingExecuteLog(void *executorContext,
+                                        struct AppendRequest *request)
+{
+    (void) executorContext;
+    return seApiBindingLogLocked((struct SeApiBindingLogRequest *) request->data);
+}
+#endif
+
+/**
+ * Records the spans of a traced call of seApiBindingLog. A span is left out if one of its ends has not been taken,
+ * e.g. the receipt code of a call without one.
+ */
+static void seApiBindingTraceLog(struct SeApiBinding *binding,
+                                 const struct LogRecord *record,
+                                 const uint64_t *traceTimes,
+                                 uint64_t end)
+{
+    static const struct {
+        enum TransactionTracePhase phase;
+        int start;
+        int end;
+    } spans[] = {
+        {transactionTraceQueueing, SE_API_BINDING_TRACE_CALL, SE_API_BINDING_TRACE_LOCKED},
+        {transactionTraceCounters, SE_API_BINDING_TRACE_LOCKED, SE_API_BINDING_TRACE_COUNTERS},
+        {transactionTraceStorage, SE_API_BINDING_TRACE_COUNTERS, SE_API_BINDING_TRACE_STORAGE},
+        {transactionTraceIndex, SE_API_BINDING_TRACE_STORAGE, SE_API_BINDING_TRACE_INDEX},
+        {transactionTraceReceiptCode, SE_API_BINDING_TRACE_INDEX, SE_API_BINDING_TRACE_RECEIPT_CODE}
+    };
+    size_t i;
+
+    transactionTraceRecord(binding->trace, binding->traceSource,
+                           record->operation == startTransactionOperation ? transactionTraceStartTransaction
+                           : record->operation == updateTransactionOperation ? transactionTraceUpdateTransaction
+                           : transactionTraceFinishTransaction,
+                           record->transactionNumber, traceTimes[SE_API_BINDING_TRACE_CALL], end);
+    for (i = 0; i < sizeof spans / sizeof *spans; i++) {
+        if (traceTimes[spans[i].start] != 0 && traceTimes[spans[i].end] != 0) {
+            transactionTraceRecord(binding->trace, binding->traceSource, spans[i].phase, record->transactionNumber,
+                                   traceTimes[spans[i].start], traceTimes[spans[i].end]);
+        }
+    }
+    if (traceTimes[SE_API_BINDING_TRACE_REPLICATION] != 0) {
+        transactionTraceRecord(binding->trace, binding->traceSource, transactionTraceReplication,
+                               record->transactionNumber, traceTimes[SE_API_BINDING_TRACE_REPLICATION], end);
+    }
+}
+
+/**
+ * Implementation of seApiBindingLogTransaction and seApiBindingFinishTransaction. The receipt code is only built
+ * if receiptCode is not NULL.
+ */
+static short int seApiBindingLog(struct SeApiBinding *binding,
+                                 uint32_t operation,
+                                 const unsigned char *clientId,
+                                 uint64_t clientIdLength,
+                                 uint64_t transactionNumber,
+                                 const unsigned char *processData,
+                                 uint64_t processDataLength,
+                                 const unsigned char *processType,
+                                 uint64_t processTypeLength,
+                                 char *receiptCode,
+                                 uint64_t receiptCodeCapacity,
+                                 int64_t *results)
+{
+    unsigned char stackPayload[SE_API_BINDING_STACK_PAYLOAD_SIZE];
+    unsigned char *payload = stackPayload;
+    uint64_t payloadLength = 1 + processTypeLength + processDataLength;
+    struct LogRecord record;
+    struct SeApiBindingLogRequest request;
+    uint64_t traceTimes[SE_API_BINDING_TRACE_TIMES];
+#if PROFILE_CONCURRENT
+    struct AppendShards *shards = atomic_load(&binding->shards);
+    struct ExportScheduler *exportScheduler = atomic_load(&binding->exportScheduler);
+    uint64_t startTime = 0;
+#endif
+    short int result;
+
+    if (operation < seApiBindingStart || operation > seApiBindingFinish
+        || clientIdLength == 0 || clientIdLength > TRANSACTION_CLIENT_ID_MAX
+        || processTypeLength > SE_API_BINDING_MAX_PROCESS_TYPE_LENGTH
+        || processDataLength > LOG_STORE_MAX_PAYLOAD_LENGTH - 1 - processTypeLength) {
+        return ERROR_PARAMETER_MISMATCH;
+    }
+    if (!atomic_load(&binding->timeSet)) {
+        return ERROR_TIME_NOT_SET;
+    }
+#if PROFILE_CONCURRENT
+    /* the latency bound of the export scheduler only applies while an export runs */
+    if (exportScheduler != NULL && exportSchedulerActive(exportScheduler)) {
+        startTime = seApiBindingMonotonicNanoseconds();
+    }
+#endif
+
+    /* the payload holds the length of the processType, the processType and the processData */
+    if (payloadLength > sizeof stackPayload) {
+        payload = malloc((size_t) payloadLength);
+        if (payload == NULL) {
+            return ERROR_STORAGE_FAILURE;
+        }
+    }
+    payload[0] = (unsigned char) processTypeLength;
+    if (processTypeLength > 0) {
+        memcpy(payload + 1, processType, (size_t) processTypeLength);
+    }
+    if (processDataLength > 0) {
+        memcpy(payload + 1 + processTypeLength, processData, (size_t) processDataLength);
+    }
+
+    memset(&record, 0, sizeof record);
+    record.type = transactionLogMessage;
+    record.operation = operation == seApiBindingStart ? startTransactionOperation
+                       : operation == seApiBindingUpdate ? updateTransactionOperation
+                       : finishTransactionOperation;
+    record.transactionNumber = transactionNumber;
+    record.clientId = clientId;
+    record.clientIdLength = (unsigned long int) clientIdLength;
+    record.payload = payload;
+    record.payloadLength = (unsigned long int) payloadLength;
+
+    request.binding = binding;
+    request.record = &record;
+    request.processType = processType;
+    request.processTypeLength = processTypeLength;
+    request.receiptCode = receiptCode;
+    request.receiptCodeCapacity = receiptCodeCapacity;
+    request.results = results;
+    request.traceTimes = NULL;
+    if (transactionTraceEnabled(binding->trace)) {
+        memset(traceTimes, 0, sizeof traceTimes);
+        traceTimes[SE_API_BINDING_TRACE_CALL] = transactionTraceNow();
+        request.traceTimes = traceTimes;
+    }
+#if PROFILE_CONCURRENT
+    if (shards != NULL) {
+        struct AppendRequest append;
+
+        append.data = &request;
+        result = appendShardsSubmit(shards, appendShardsSelect(shards, clientId, (size_t) clientIdLength), &append);
+    } else {
+        pthread_mutex_lock(&binding->appendLock);
+        result = seApiBindingLogLocked(&request);
+        pthread_mutex_unlock(&binding->appendLock);
+    }
+
+    /* semi-synchronous replication: the standby may lag behind after the timeout, the log message is stored */
+    if ((result == EXECUTION_OK || result == ERROR_CERTIFICATE_EXPIRED) && request.shipper != NULL
+        && request.semiSynchronousTimeout != 0) {
+        if (request.traceTimes != NULL) {
+            traceTimes[SE_API_BINDING_TRACE_REPLICATION] = transactionTraceNow();
+        }
+        logShipperWaitAcknowledged(request.shipper, record.signatureCounter, request.semiSynchronousTimeout);
+    }
+#else
+    result = seApiBindingLogLocked(&request);
+
+    /* without the thread of the key manager a standby key that has taken over is replaced here */
+    keyManagerRefill(&binding->keys);
+#endif
+
+    /* request.traceTimes has been reset by seApiBindingLogLocked if the transaction is not sampled */
+    if (request.traceTimes != NULL) {
+        seApiBindingTraceLog(binding, &record, traceTimes, transactionTraceNow());
+    }
+    if (payload != stackPayload) {
+        free(payload);
+    }
+#if PROFILE_CONCURRENT
+    if (startTime != 0) {
+        exportSchedulerReportLatency(exportScheduler, seApiBindingMonotonicNanoseconds() - startTime);
+    }
+#endif
+    return result;
+}
+
+short int seApiBindingLogTransaction(struct SeApiBinding *binding,
+                                     uint32_t operation,
+                                     const unsigned char *clientId,
+                                     uint64_t clientIdLength,
+                                     uint64_t transactionNumber,
+                                     const unsigned char *processData,
+                                     uint64_t processDataLength,
+                                     const unsigned char *processType,
+                                     uint64_t processTypeLength,
+                                     int64_t *results)
+{
+    return seApiBindingLog(binding, operation, clientId, clientIdLength, transactionNumber, processData,
+                           processDataLength, processType, processTypeLength, NULL, 0, results);
+}
+
+short int seApiBindingFinishTransaction(struct SeApiBinding *binding,
+                                        const unsigned char *clientId,
+                                        uint64_t clientIdLength,
+                                        uint64_t transactionNumber,
+                                        const unsigned char *processData,
+                                        uint64_t processDataLength,
+                                        const unsigned char *processType,
+                                        uint64_t processTypeLength,
+                                        char *receiptCode,
+                                        uint64_t receiptCodeCapacity,
+                                        int64_t *results)
+{
+    char noReceiptCode[1];
+
+    /* a missing array still yields the length of the receipt code */
+    return seApiBindingLog(binding, seApiBindingFinish, clientId, clientIdLength, transactionNumber, processData,
+                           processDataLength, processType, processTypeLength,
+                           receiptCode != NULL ? receiptCode : noReceiptCode,
+                           receiptCode != NULL ? receiptCodeCapacity : 0, results);
+}
+
+short int seApiBindingSetReceiptCodeKey(struct SeApiBinding *binding,
+                                        const char *signatureAlgorithm,
+                                        uint64_t signatureAlgorithmLength,
+                                        const unsigned char *publicKey,
+                                        uint64_t publicKeyLength)
+{
+    struct ReceiptCodeKey key;
+    short int result;
+
+    if (signatureAlgorithmLength > RECEIPT_CODE_ALGORITHM_MAX || publicKeyLength > RECEIPT_CODE_PUBLIC_KEY_MAX) {
+        return ERROR_PARAMETER_MISMATCH;
+    }
+    result = receiptCodeKeyInit(&key, signatureAlgorithm, (size_t) signatureAlgorithmLength, publicKey,
+                                (size_t) publicKeyLength);
+    if (result == EXECUTION_OK) {
+        profileLock(&binding->appendLock);
+        binding->receiptCodeKey = key;
+        profileUnlock(&binding->appendLock);
+    }
+    return result;
+}
+
+short int seApiBindingStartKeyManager(struct SeApiBinding *binding,
+                                      KeyProvisioner provisioner,
+                                      void *provisionerContext,
+                                      uint32_t standbyCount,
+                                      int64_t rotationLead)
+{
+    return keyManagerStart(&binding->keys, provisioner, provisionerContext, standbyCount, rotationLead);
+}
+
+short int seApiBindingAddStandbyKey(struct SeApiBinding *binding,
+                                    const char *signatureAlgorithm,
+                                    uint64_t signatureAlgorithmLength,
+                                    const unsigned char *publicKey,
+                                    uint64_t publicKeyLength,
+                                    const unsigned char *certificate,
+                                    uint64_t certificateLength,
+                                    int64_t notAfter)
+{
+    struct KeyProvision provision;
+
+    if ((signatureAlgorithm == NULL && signatureAlgorithmLength != 0)
+        || signatureAlgorithmLength > RECEIPT_CODE_ALGORITHM_MAX || publicKey == NULL
+        || publicKeyLength > RECEIPT_CODE_PUBLIC_KEY_MAX || certificateLength > CERTIFICATE_MAX_SIZE) {
+        return ERROR_PARAMETER_MISMATCH;
+    }
+    memset(&provision, 0, sizeof provision);
+    if (signatureAlgorithmLength > 0) {
+        memcpy(provision.signatureAlgorithm, signatureAlgorithm, (size_t) signatureAlgorithmLength);
+    }
+    provision.signatureAlgorithmLength = (size_t) signatureAlgorithmLength;
+    memcpy(provision.publicKey, publicKey, (size_t) publicKeyLength);
+    provision.publicKeyLength = (size_t) publicKeyLength;
+    provision.certificate = certificate;
+    provision.certificateLength = (size_t) certificateLength;
+    provision.notAfter = notAfter;
+    return keyManagerAddStandby(&binding->keys, &provision);
+}
+
+short int seApiBindingDisableSecureElement(struct SeApiBinding *binding,
+                                           const unsigned char *userId,
+                                           uint64_t userIdLength,
+                                           int64_t *results)
+{
+    static const unsigned char payload[] = "disableSecureElement";
+    struct LogRecord record;
+    short int result;
+
+    if (userId == NULL || userIdLength > USER_ID_MAX_LENGTH) {
+        return ERROR_USER_NOT_AUTHENTICATED;
+    }
+    result = userSessionsCheck(&binding->userSessions, userId, (unsigned int) userIdLength,
+                               USER_PERMISSION_DISABLE_SECURE_ELEMENT, seApiBindingMonotonicTime());
+    if (result != EXECUTION_OK) {
+        return result;
+    }
+    if (!atomic_load(&binding->timeSet)) {
+        return ERROR_TIME_NOT_SET;
+    }
+    memset(&record, 0, sizeof record);
+    record.type = systemLogMessage;
+    record.operation = noTransactionOperation;
+    record.logTime = seApiBindingRealTime() + atomic_load(&binding->timeOffset);
+    record.payload = payload;
+    record.payloadLength = sizeof payload - 1;
+
+    /* the log message is the last one of the disabled key; no other log message is appended in between */
+    profileLock(&binding->appendLock);
+    result = seApiBindingAppend(binding, &record, results, NULL);
+    if (result == EXECUTION_OK || result == ERROR_CERTIFICATE_EXPIRED) {
+        short int disableResult = keyManagerDisable(&binding->keys);
+
+        result = disableResult != EXECUTION_OK ? disableResult : result;
+    }
+    profileUnlock(&binding->appendLock);
+    return result;
+}
+
+short int seApiBindingExportSerialNumbers(struct SeApiBinding *binding,
+                                          int64_t *results)
+{
+    unsigned char *data;
+    size_t dataLength;
+    short int result = keyManagerExportSerialNumbers(&binding->keys, &data, &dataLength);
+
+    if (result == EXECUTION_OK) {
+        results[SE_API_BINDING_EXPORT_ADDRESS] = (int64_t) (intptr_t) data;
+        results[SE_API_BINDING_EXPORT_LENGTH] = (int64_t) dataLength;
+    }
+    return result;
+}
+
+short int seApiBindingExportCertificates(struct SeApiBinding *binding,
+                                         int64_t *results)
+{
+    unsigned char *data;
+    size_t dataLength;
+    short int result = keyManagerExportCertificates(&binding->keys, &data, &dataLength);
+
+    if (result == EXECUTION_OK) {
+        results[SE_API_BINDING_EXPORT_ADDRESS] = (int64_t) (intptr_t) data;
+        results[SE_API_BINDING_EXPORT_LENGTH] = (int64_t) dataLength;
+    }
+    return result;
+}
+
+#if PROFILE_CONCURRENT
+short int seApiBindingStartReplication(struct SeApiBinding *binding,
+                                       const char *socketPath,
+                                       uint32_t semiSynchronousTimeout)
+{
+    struct LogShipper *shipper;
+    short int result;
+
+    if (socketPath == NULL) {
+        return ERROR_PARAMETER_MISMATCH;
+    }
+    shipper = malloc(sizeof *shipper);
+    if (shipper == NULL) {
+        return ERROR_STORAGE_FAILURE;
+    }
+    /* no log message is appended between reading the last signature counter and setting the shipper */
+    pthread_mutex_lock(&binding->appendLock);
+    result = binding->shipper != NULL ? ERROR_PARAMETER_MISMATCH
+             : logShipperStart(shipper, &binding->store, socketPath);
+    if (result == EXECUTION_OK) {
+        binding->shipper = shipper;
+        binding->semiSynchronousTimeout = semiSynchronousTimeout;
+    }
+    pthread_mutex_unlock(&binding->appendLock);
+    if (result != EXECUTION_OK) {
+        free(shipper);
+    }
+    return result;
+}
+
+short int seApiBindingStartAppendShards(struct SeApiBinding *binding,
+                                        uint32_t shardCount)
+{
+    struct AppendShards *shards = malloc(sizeof *shards);
+    short int result;
+
+    if (shards == NULL) {
+        return ERROR_STORAGE_FAILURE;
+    }
+    result = appendShardsInit(shards, shardCount, &binding->appendLock, seApiBindingExecuteLog, NULL);
+    if (result == EXECUTION_OK) {
+        pthread_mutex_lock(&binding->appendLock);
+        if (atomic_load(&binding->shards) != NULL) {
+            result = ERROR_PARAMETER_MISMATCH;
+        } else {
+            atomic_store(&binding->shards, shards);
+        }
+        pthread_mutex_unlock(&binding->appendLock);
+        if (result != EXECUTION_OK) {
+            appendShardsFree(shards);
+        }
+    }
+    if (result != EXECUTION_OK) {
+        free(shards);
+    }
+    return result;
+}
+#endif
+
+short int seApiBindingOpenTransactionColumns(struct SeApiBinding *binding)
+{
+    struct TransactionColumns *columns;
+    char directory[4096];
+    int length;
+    short int result;
+
+    if (atomic_load(&binding->columns) != NULL) {
+        return ERROR_PARAMETER_MISMATCH;
+    }
+    length = snprintf(directory, sizeof directory, "%s/%s", binding->store.directory,
+                      SE_API_BINDING_COLUMNS_DIRECTORY_NAME);
+    if (length < 0 || (size_t) length >= sizeof directory) {
+        return ERROR_PARAMETER_MISMATCH;
+    }
+    columns = malloc(sizeof *columns);
+    if (columns == NULL) {
+        return ERROR_STORAGE_FAILURE;
+    }
+    /* the bulk of the missing rows is added without blocking the appends, the rest under the append lock */
+    result = transactionColumnsOpen(columns, directory, &binding->store);
+    if (result != EXECUTION_OK) {
+        free(columns);
+        return result;
+    }
+    profileLock(&binding->appendLock);
+    result = atomic_load(&binding->columns) != NULL ? ERROR_PARAMETER_MISMATCH
+             : transactionColumnsCatchUp(columns, &binding->store);
+    if (result == EXECUTION_OK) {
+        atomic_store(&binding->columns, columns);
+    }
+    profileUnlock(&binding->appendLock);
+    if (result != EXECUTION_OK) {
+        transactionColumnsClose(columns);
+        free(columns);
+    }
+    return result;
+}
+
+short int seApiBindingTransactionVolumes(struct SeApiBinding *binding,
+                                         int64_t startTime,
+                                         int64_t endTime,
+                                         const unsigned char *clientId,
+                                         uint64_t clientIdLength,
+                                         const unsigned char *processType,
+                                         uint64_t processTypeLength,
+                                         int64_t interval,
+                                         int64_t *results)
+{
+    struct TransactionColumns *columns = atomic_load(&binding->columns);
+    struct TransactionColumnQuery query;
+    struct TransactionVolume *volumes;
+    size_t volumeCount;
+    short int result;
+
+    if (columns == NULL || clientIdLength > TRANSACTION_CLIENT_ID_MAX
+        || processTypeLength > SE_API_BINDING_MAX_PROCESS_TYPE_LENGTH) {
+        return ERROR_PARAMETER_MISMATCH;
+    }
+    query.startTime = startTime;
+    query.endTime = endTime;
+    query.client = TRANSACTION_COLUMNS_ANY;
+    query.processType = TRANSACTION_COLUMNS_ANY;
+    query.interval = interval;
+    results[SE_API_BINDING_EXPORT_ADDRESS] = 0;
+    results[SE_API_BINDING_EXPORT_LENGTH] = 0;
+    /* a value that no row contains selects nothing */
+    if ((clientId != NULL
+         && transactionColumnsLookup(columns, false, clientId, (size_t) clientIdLength, &query.client) != EXECUTION_OK)
+        || (processType != NULL
+            && transactionColumnsLookup(columns, true, processType, (size_t) processTypeLength, &query.processType)
+               != EXECUTION_OK)) {
+        return EXECUTION_OK;
+    }
+    result = transactionColumnsAggregate(columns, &query, &volumes, &volumeCount);
+    if (result == EXECUTION_OK) {
+        results[SE_API_BINDING_EXPORT_ADDRESS] = (int64_t) (intptr_t) volumes;
+        results[SE_API_BINDING_EXPORT_LENGTH] = (int64_t) volumeCount;
+    }
+    return result;
+}
+
+short int seApiBindingTransactionColumnValue(struct SeApiBinding *binding,
+                                             uint32_t processType,
+                                             uint32_t code,
+                                             unsigned char *value,
+                                             uint64_t capacity,
+                                             int64_t *results)
+{
+    struct TransactionColumns *columns = atomic_load(&binding->columns);
+    size_t valueLength = 0;
+    short int result;
+
+    if (columns == NULL) {
+        return ERROR_PARAMETER_MISMATCH;
+    }
+    result = transactionColumnsValue(columns, processType != 0, code, value,
+                                     capacity > SIZE_MAX ? SIZE_MAX : (size_t) capacity, &valueLength);
+    results[0] = (int64_t) valueLength;
+    return result;
+}
+
+#if PROFILE_CONCURRENT
+/**
+ * Export queued with seApiBindingSubmitExport
+ */
+struct SeApiBindingExportJob {
+    struct ExportJob job;
+    struct SeApiBinding *binding;
+    uint32_t filter;
+    int64_t start;
+    int64_t end;
+    unsigned char clientId[TRANSACTION_CLIENT_ID_MAX];
+    uint64_t clientIdLength;
+    int64_t maximumNumberRecords;
+};
+#endif
+
+/**
+ * Implementation of seApiBindingExport with the throttle of the export scheduler
+ */
+static short int seApiBindingRunExport(struct SeApiBinding *binding,
+                                       uint32_t filter,
+                                       int64_t start,
+                                       int64_t end,
+                                       const unsigned char *clientId,
+                                       uint64_t clientIdLength,
+                                       int64_t maximumNumberRecords,
+                                       ExportThrottle throttle,
+                                       void *throttleContext,
+                                       unsigned char **exportedData,
+                                       unsigned long int *exportedDataLength)
+{
+    bool manifest = (filter & SE_API_BINDING_EXPORT_MANIFEST) != 0;
+    short int result;
+
+    if (maximumNumberRecords < 0 || maximumNumberRecords > LONG_MAX || clientIdLength > TRANSACTION_CLIENT_ID_MAX) {
+        return ERROR_PARAMETER_MISMATCH;
+    }
+    if (clientIdLength == 0) {
+        clientId = NULL;
+    }
+    switch (filter & ~SE_API_BINDING_EXPORT_MANIFEST) {
+    case seApiBindingExportAll:
+        result = exportScanAll(&binding->store, (long int) maximumNumberRecords, manifest, throttle, throttleContext,
+                               exportedData, exportedDataLength);
+        break;
+    case seApiBindingExportTransactions:
+        if (start < 0 || end < 0) {
+            return ERROR_PARAMETER_MISMATCH;
+        }
+        result = exportScanTransactionInterval(&binding->store, (uint64_t) start, (uint64_t) end, clientId,
+                                               (unsigned long int) clientIdLength, (long int) maximumNumberRecords,
+                                               manifest, throttle, throttleContext, exportedData,
+                                               exportedDataLength);
+        break;
+    case seApiBindingExportPeriod: {
+        struct tm startDate;
+        struct tm endDate;
+        time_t startTime = (time_t) start;
+        time_t endTime = (time_t) end;
+
+        if ((start != INT64_MIN && gmtime_r(&startTime, &startDate) == NULL)
+            || (end != INT64_MAX && gmtime_r(&endTime, &endDate) == NULL)) {
+            return ERROR_PARAMETER_MISMATCH;
+        }
+        result = exportScanPeriodOfTime(&binding->store, start != INT64_MIN ? &startDate : NULL,
+                                        end != INT64_MAX ? &endDate : NULL, clientId,
+                                        (unsigned long int) clientIdLength, (long int) maximumNumberRecords,
+                                        manifest, throttle, throttleContext, exportedData, exportedDataLength);
+        break;
+    }
+    default:
+        return ERROR_PARAMETER_MISMATCH;
+    }
+    return result;
+}
+
+short int seApiBindingExport(struct SeApiBinding *binding,
+                             uint32_t filter,
+                             int64_t start,
+                             int64_t end,
+                             const unsigned char *clientId,
+                             uint64_t clientIdLength,
+                             int64_t maximumNumberRecords,
+                             int64_t *results)
+{
+    unsigned char *exportedData = NULL;
+    unsigned long int exportedDataLength = 0;
+    short int result;
+
+    result = seApiBindingRunExport(binding, filter, start, end, clientId, clientIdLength, maximumNumberRecords, NULL,
+                                   NULL, &exportedData, &exportedDataLength);
+    if (result != EXECUTION_OK) {
+        return result;
+    }
+    results[SE_API_BINDING_EXPORT_ADDRESS] = (int64_t) (intptr_t) exportedData;
+    results[SE_API_BINDING_EXPORT_LENGTH] = (int64_t) exportedDataLength;
+    return EXECUTION_OK;
+}
+
+void seApiBindingFreeExport(unsigned char *data)
+{
+    free(data);
+}
+
+#if PROFILE_CONCURRENT
+short int seApiBindingExecuteExport(void *runnerContext,
+                                    struct ExportJob *job,
+                                    ExportThrottle throttle,
+                                    void *throttleContext)
+{
+    struct SeApiBindingExportJob *exportJob = (struct SeApiBindingExportJob *) job->data;
+
+    (void) runnerContext;
+    return seApiBindingRunExport(exportJob->binding, exportJob->filter, exportJob->start, exportJob->end,
+                                 exportJob->clientId, exportJob->clientIdLength, exportJob->maximumNumberRecords,
+                                 throttle, throttleContext, &job->exportedData, &job->exportedDataLength);
+}
+
+short int seApiBindingStartExportScheduler(struct SeApiBinding *binding,
+                                           uint64_t bytesPerSecond,
+                                           uint32_t cpuPermille,
+                                           uint64_t latencyBound)
+{
+    struct ExportScheduler *exportScheduler = malloc(sizeof *exportScheduler);
+    struct ExportScheduler *expected = NULL;
+    struct ExportBudget budget;
+    short int result;
+
+    if (exportScheduler == NULL) {
+        return ERROR_STORAGE_FAILURE;
+    }
+    budget.bytesPerSecond = bytesPerSecond;
+    budget.cpuPermille = cpuPermille;
+    budget.latencyBound = latencyBound;
+    result = exportSchedulerStart(exportScheduler, seApiBindingExecuteExport, NULL, &budget);
+    if (result != EXECUTION_OK) {
+        free(exportScheduler);
+        return result;
+    }
+    if (!atomic_compare_exchange_strong(&binding->exportScheduler, &expected, exportScheduler)) {
+        exportSchedulerStop(exportScheduler);
+        free(exportScheduler);
+        return ERROR_PARAMETER_MISMATCH;
+    }
+    return EXECUTION_OK;
+}
+
+short int seApiBindingSubmitExport(struct SeApiBinding *binding,
+                                   uint32_t filter,
+                                   int64_t start,
+                                   int64_t end,
+                                   const unsigned char *clientId,
+                                   uint64_t clientIdLength,
+                                   int64_t maximumNumberRecords,
+                                   int64_t *results)
+{
+    struct ExportScheduler *exportScheduler = atomic_load(&binding->exportScheduler);
+    struct SeApiBindingExportJob *exportJob;
+    short int result;
+
+    if (exportScheduler == NULL || (filter & ~SE_API_BINDING_EXPORT_MANIFEST) > seApiBindingExportPeriod
+        || maximumNumberRecords < 0 || maximumNumberRecords > LONG_MAX || clientIdLength > TRANSACTION_CLIENT_ID_MAX) {
+        return ERROR_PARAMETER_MISMATCH;
+    }
+    /* one export per tenant in a shared scheduler lets the first-come order alternate between the tenants */
+    if (binding->exportSchedulerShared && atomic_exchange(&binding->exportQueued, true)) {
+        return ERROR_PARAMETER_MISMATCH;
+    }
+    exportJob = calloc(1, sizeof *exportJob);
+    if (exportJob == NULL) {
+        atomic_store(&binding->exportQueued, false);
+        return ERROR_STORAGE_FAILURE;
+    }
+    exportJob->job.data = exportJob;
+    exportJob->binding = binding;
+    exportJob->filter = filter;
+    exportJob->start = start;
+    exportJob->end = end;
+    if (clientId != NULL && clientIdLength > 0) {
+        memcpy(exportJob->clientId, clientId, (size_t) clientIdLength);
+        exportJob->clientIdLength = clientIdLength;
+    }
+    exportJob->maximumNumberRecords = maximumNumberRecords;
+    result = exportSchedulerSubmit(exportScheduler, &exportJob->job);
+    if (result != EXECUTION_OK) {
+        free(exportJob);
+        atomic_store(&binding->exportQueued, false);
+        return result;
+    }
+    results[SE_API_BINDING_EXPORT_JOB] = (int64_t) (intptr_t) exportJob;
+    return EXECUTION_OK;
+}
+
+void seApiBindingExportStatus(struct SeApiBinding *binding,
+                              int64_t job,
+                              int64_t *results)
+{
+    struct SeApiBindingExportJob *exportJob = (struct SeApiBindingExportJob *) (intptr_t) job;
+    struct ExportJobStatus status;
+
+    exportSchedulerStatus(atomic_load(&binding->exportScheduler), &exportJob->job, &status);
+    results[SE_API_BINDING_EXPORT_STATE] = (int64_t) status.state;
+    results[SE_API_BINDING_EXPORT_BYTES_READ] = (int64_t) status.bytesRead;
+    results[SE_API_BINDING_EXPORT_BYTES_PLANNED] = (int64_t) status.bytesPlanned;
+    results[SE_API_BINDING_EXPORT_RESULT] = status.result;
+}
+
+void seApiBindingCancelExport(struct SeApiBinding *binding,
+                              int64_t job)
+{
+    struct SeApiBindingExportJob *exportJob = (struct SeApiBindingExportJob *) (intptr_t) job;
+
+    exportSchedulerCancel(atomic_load(&binding->exportScheduler), &exportJob->job);
+}
+
+short int seApiBindingCollectExport(struct SeApiBinding *binding,
+                                    int64_t job,
+                                    int64_t *results)
+{
+    struct SeApiBindingExportJob *exportJob = (struct SeApiBindingExportJob *) (intptr_t) job;
+    short int result = exportSchedulerWait(atomic_load(&binding->exportScheduler), &exportJob->job);
+
+    if (result == EXECUTION_OK) {
+        results[SE_API_BINDING_EXPORT_ADDRESS] = (int64_t) (intptr_t) exportJob->job.exportedData;
+        results[SE_API_BINDING_EXPORT_LENGTH] = (int64_t) exportJob->job.exportedDataLength;
+    } else {
+        free(exportJob->job.exportedData);
+    }
+    free(exportJob);
+    atomic_store(&binding->exportQueued, false);
+    return result;
+}
+#endif
+
+/**
+ * Reads a stored log message. A signature counter of 0 selects the last stored log message.
+ * @param[out] record
+ *                receives the log message without clientId; its payload is allocated and released by the caller
+ */
+static short int seApiBindingReadStored(struct SeApiBinding *binding,
+                                        uint64_t signatureCounter,
+                                        struct LogRecord *record)
+{
+    struct SegmentInfo *segments;
+    struct SegmentInfo *info = NULL;
+    struct SegmentReader reader;
+    size_t segmentCount;
+    size_t i;
+    bool endOfSegment = false;
+    short int result;
+
+    if (logStoreSnapshotSegments(&binding->store, &segments, &segmentCount) != EXECUTION_OK) {
+        return ERROR_READING_LOG_MESSAGE;
+    }
+    for (i = segmentCount; i > 0; i--) {
+        struct SegmentInfo *candidate = &segments[i - 1];
+
+        if (candidate->recordCount > 0 && (signatureCounter == 0
+                                           || (candidate->firstSignatureCounter <= signatureCounter
+                                               && signatureCounter <= candidate->lastSignatureCounter))) {
+            info = candidate;
+            break;
+        }
+    }
+    if (info == NULL) {
+        logStoreReleaseSnapshot(&binding->store, segments);
+        return signatureCounter == 0 ? ERROR_NO_LOG_MESSAGE : ERROR_READING_LOG_MESSAGE;
+    }
+    if (signatureCounter == 0) {
+        signatureCounter = info->lastSignatureCounter;
+    }
+
+    result = segmentReaderOpen(&reader, &binding->store, info->id, 0) == EXECUTION_OK ? EXECUTION_OK
+             : ERROR_READING_LOG_MESSAGE;
+    if (result == EXECUTION_OK) {
+        reader.limit = info->length;
+        do {
+            if (segmentReaderNext(&reader, record, &endOfSegment) != EXECUTION_OK || endOfSegment) {
+                result = ERROR_READING_LOG_MESSAGE;
+            }
+        } while (result == EXECUTION_OK && record->signatureCounter != signatureCounter);
+        if (result == EXECUTION_OK) {
+            /* the record points into the buffer of the reader, which is released below */
+            unsigned char *payload = malloc(record->payloadLength > 0 ? record->payloadLength : 1);
+
+            if (payload == NULL) {
+                result = ERROR_READING_LOG_MESSAGE;
+            } else {
+                memcpy(payload, record->payload, record->payloadLength);
+                record->payload = payload;
+                record->clientId = NULL;
+                record->clientIdLength = 0;
+            }
+        }
+        segmentReaderClose(&reader);
+    }
+    logStoreReleaseSnapshot(&binding->store, segments);
+    return result;
+}
+
+short int seApiBindingReadLogMessage(struct SeApiBinding *binding,
+                                     const unsigned char *clientId,
+                                     uint64_t clientIdLength,
+                                     uint64_t transactionNumber,
+                                     unsigned char *logMessage,
+                                     uint64_t logMessageCapacity,
+                                     int64_t *results)
+{
+    struct RecentLogMessage message;
+    struct LogRecord stored;
+    const unsigned char *payload = message.payload;
+    unsigned char *storedPayload = NULL;
+    short int result;
+
+    if (clientIdLength > TRANSACTION_CLIENT_ID_MAX) {
+        return ERROR_PARAMETER_MISMATCH;
+    }
+    if (clientIdLength > 0) {
+        result = recentLogMessagesFind(&binding->recentLogMessages, clientId, (uint32_t) clientIdLength,
+                                       transactionNumber, &message);
+    } else {
+        result = recentLogMessagesLast(&binding->recentLogMessages, &message);
+    }
+
+    if ((result == ERROR_NO_LOG_MESSAGE && clientIdLength == 0)
+        || (result == EXECUTION_OK && message.payloadLength > RECENT_LOG_MESSAGE_PAYLOAD_SIZE)) {
+        result = seApiBindingReadStored(binding, result == EXECUTION_OK ? message.signatureCounter : 0, &stored);
+        if (result == EXECUTION_OK) {
+            storedPayload = (unsigned char *) stored.payload;
+            payload = storedPayload;
+            message.signatureCounter = stored.signatureCounter;
+            message.transactionNumber = stored.transactionNumber;
+            message.logTime = stored.logTime;
+            message.payloadLength = (uint32_t) stored.payloadLength;
+        }
+    }
+    if (result != EXECUTION_OK) {
+        return result;
+    }
+
+    results[SE_API_BINDING_TRANSACTION_NUMBER] = (int64_t) message.transactionNumber;
+    results[SE_API_BINDING_SIGNATURE_COUNTER] = (int64_t) message.signatureCounter;
+    results[SE_API_BINDING_LOG_TIME] = message.logTime;
+    results[SE_API_BINDING_LOG_MESSAGE_LENGTH] = (int64_t) message.payloadLength;
+    if (message.payloadLength > logMessageCapacity) {
+        result = ERROR_PARAMETER_MISMATCH;
+    } else if (message.payloadLength > 0) {
+        memcpy(logMessage, payload, message.payloadLength);
+    }
+    free(storedPayload);
+    return result;
+}
+
+short int seApiBindingAuthenticateUser(struct SeApiBinding *binding,
+                                       const unsigned char *userId,
+                                       uint64_t userIdLength,
+                                       const unsigned char *pin,
+                                       uint64_t pinLength,
+                                       int64_t *results)
+{
+    enum CredentialCheck authenticationResult = credentialUnknownUser;
+    short int remainingRetries = 0;
+    short int result;
+
+    if (userIdLength > USER_ID_MAX_LENGTH || pinLength > UINT_MAX) {
+        return ERROR_PARAMETER_MISMATCH;
+    }
+    result = userSessionsAuthenticate(&binding->userSessions, userId, (unsigned int) userIdLength, pin,
+                                      (unsigned int) pinLength, seApiBindingMonotonicTime(), &authenticationResult,
+                                      &remainingRetries);
+    results[SE_API_BINDING_RESULT] = authenticationResult;
+    results[SE_API_BINDING_REMAINING_RETRIES] = remainingRetries;
+    return result;
+}
+
+short int seApiBindingLogOut(struct SeApiBinding *binding,
+                             const unsigned char *userId,
+                             uint64_t userIdLength)
+{
+    if (userIdLength > USER_ID_MAX_LENGTH) {
+        return ERROR_USER_ID_NOT_MANAGED;
+    }
+    return userSessionsLogOut(&binding->userSessions, userId, (unsigned int) userIdLength,
+                              seApiBindingMonotonicTime());
+}
+
+short int seApiBindingUnblockUser(struct SeApiBinding *binding,
+                                  const unsigned char *userId,
+                                  uint64_t userIdLength,
+                                  const unsigned char *puk,
+                                  uint64_t pukLength,
+                                  const unsigned char *newPin,
+                                  uint64_t newPinLength,
+                                  int64_t *results)
+{
+    enum CredentialCheck unblockResult = credentialUnknownUser;
+    short int result;
+
+    if (userIdLength > USER_ID_MAX_LENGTH || pukLength > UINT_MAX || newPinLength > UINT_MAX) {
+        return ERROR_PARAMETER_MISMATCH;
+    }
+    result = userSessionsUnblock(&binding->userSessions, userId, (unsigned int) userIdLength, puk,
+                                 (unsigned int) pukLength, newPin, (unsigned int) newPinLength, &unblockResult);
+    results[SE_API_BINDING_RESULT] = unblockResult;
+    return result;
+}
+
+short int seApiBindingDeleteStoredData(struct SeApiBinding *binding,
+                                       const unsigned char *userId,
+                                       uint64_t userIdLength)
+{
+    short int result;
+
+    if (userId == NULL || userIdLength > USER_ID_MAX_LENGTH) {
+        return ERROR_USER_NOT_AUTHENTICATED;
+    }
+    result = userSessionsCheck(&binding->userSessions, userId, (unsigned int) userIdLength,
+                               USER_PERMISSION_DELETE_STORED_DATA, seApiBindingMonotonicTime());
+    if (result != EXECUTION_OK) {
+        return result;
+    }
+    return segmentRetirerDeleteStoredData(binding->retirer, &binding->store);
+}
+
+short int seApiBindingCurrentNumberOfTransactions(struct SeApiBinding *binding,
+                                                  int64_t *results)
+{
+    profileLock(&binding->store.lock);
+    results[0] = (int64_t) binding->store.openTransactions.count;
+    profileUnlock(&binding->store.lock);
+    return EXECUTION_OK;
+}
+
+/**
+ * Implementation of StaleTransactionFinisher for seApiBindingFinishStaleTransactions.
+ */
+static short int seApiBindingFinishStale(void *finisherContext,
+                                         const struct StaleTransaction *transaction)
+{
+    struct SeApiBinding *binding = (struct SeApiBinding *) finisherContext;
+    unsigned char payload[1] = {0};
+    int64_t results[SE_API_BINDING_RESULT_COUNT];
+    struct LogRecord record;
+    struct SeApiBindingLogRequest request;
+    short int result;
+
+    memset(&record, 0, sizeof record);
+    record.type = transactionLogMessage;
+    record.operation = finishTransactionOperation;
+    record.transactionNumber = transaction->transactionNumber;
+    record.clientId = transaction->clientId;
+    record.clientIdLength = transaction->clientIdLength;
+    record.payload = payload;
+    record.payloadLength = sizeof payload;
+    memset(&request, 0, sizeof request);
+    request.binding = binding;
+    request.record = &record;
+    request.results = results;
+
+    /* every log message is appended under the append lock, so the transaction cannot be updated after the check */
+    profileLock(&binding->appendLock);
+    result = logStoreTransactionUnchanged(&binding->store, transaction) ? seApiBindingLogLocked(&request)
+             : ERROR_NO_TRANSACTION;
+    profileUnlock(&binding->appendLock);
+    return result == ERROR_CERTIFICATE_EXPIRED ? EXECUTION_OK : result;
+}
+
+short int seApiBindingFinishStaleTransactions(struct SeApiBinding *binding,
+                                              int64_t *results)
+{
+    size_t finishedCount = 0;
+    short int result;
+
+    if (!atomic_load(&binding->timeSet)) {
+        return ERROR_TIME_NOT_SET;
+    }
+    result = logStoreFinishStaleTransactions(&binding->store,
+                                             seApiBindingRealTime() + atomic_load(&binding->timeOffset),
+                                             seApiBindingFinishStale, binding, &finishedCount);
+    results[0] = (int64_t) finishedCount;
+    return result;
+}
+
+short int seApiBindingInitialize(struct SeApiBinding *binding,
+                                 const unsigned char *userId,
+                                 uint64_t userIdLength,
+                                 const unsigned char *description,
+                                 uint64_t descriptionLength,
+                                 int64_t *results)
+{
+    static const unsigned char payload[] = "initialize";
+    struct LogRecord record;
+    short int result;
+
+    if (userId == NULL || userIdLength > USER_ID_MAX_LENGTH) {
+        return ERROR_USER_NOT_AUTHENTICATED;
+    }
+    if (descriptionLength > SE_DESCRIPTION_MAX) {
+        return ERROR_PARAMETER_MISMATCH;
+    }
+    result = userSessionsCheck(&binding->userSessions, userId, (unsigned int) userIdLength,
+                               USER_PERMISSION_INITIALIZE, seApiBindingMonotonicTime());
+    if (result != EXECUTION_OK) {
+        return result;
+    }
+    memset(&record, 0, sizeof record);
+    record.type = systemLogMessage;
+    record.operation = noTransactionOperation;
+    record.logTime = seApiBindingRealTime() + atomic_load(&binding->timeOffset);
+    record.payload = payload;
+    record.payloadLength = sizeof payload - 1;
+
+    /* the description of the backend is only changed by the thread that holds the append lock */
+    profileLock(&binding->appendLock);
+    result = seDescriptionInitialize(&binding->description, binding->store.directory, description,
+                                     (size_t) descriptionLength);
+    if (result == EXECUTION_OK) {
+        result = seApiBindingAppend(binding, &record, results, NULL);
+    }
+    profileUnlock(&binding->appendLock);
+    return result;
+}
+
+short int seApiBindingMemoryUsage(struct SeApiBinding *binding,
+                                  int64_t *results)
+{
+    results[0] = (int64_t) (sizeof *binding + logStoreMemoryUsage(&binding->store));
+    results[1] = (int64_t) binding->memoryQuota;
+    return EXECUTION_OK;
+}
+
+short int seApiBindingSetTraceSampling(struct SeApiBinding *binding,
+                                       uint32_t samplingInterval)
+{
+    transactionTraceSetSampling(binding->trace, samplingInterval);
+    return EXECUTION_OK;
+}
+
+short int seApiBindingDumpTrace(struct SeApiBinding *binding,
+                                const char *path)
+{
+    if (path == NULL) {
+        return ERROR_PARAMETER_MISMATCH;
+    }
+    return transactionTraceDump(binding->trace, path);
+}
@@ -0,0 +1,806 @@
+#ifndef SEAPI_BACKEND_SE_API_BINDING_H
+#define SEAPI_BACKEND_SE_API_BINDING_H
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "../Exception.h"
+#include "../Constant.h"
+#include "CounterJournal.h"
+#include "KeyManager.h"
+#include "LogStore.h"
+#include "Profile.h"
+#include "ReceiptCode.h"
+#include "RecentLogMessages.h"
+#include "SeDescription.h"
+#include "SegmentRetirer.h"
+#include "TransactionColumns.h"
+#include "TransactionTrace.h"
+#include "UserSessions.h"
+#if PROFILE_CONCURRENT
+#include "AppendShards.h"
+#include "ExportScheduler.h"
+#include "LogReplication.h"
+#endif
+
+/**
+ * This header file defines the binding of the SE API backend for foreign callers, in particular for the Java
+ * implementation of SEAPI.java, which calls it through the Foreign Function & Memory API or through JNI.
+ *
+ * The functions only use pointers and fixed-size integers, so that they can be described without knowledge of the
+ * structures of the backend. Input data is passed as address and length and read in place, so that callers can
+ * pass off-heap memory without copying it. Output values are written to an array of 64-bit integers provided by
+ * the caller. Exported archives are returned as address and length of memory allocated by the backend, which the
+ * caller reads in place and releases with seApiBindingFreeExport.
+ *
+ * The backend stores the log messages unsigned; serial numbers and signature values are not created. The most
+ * recent log messages are kept in memory, so that readLogMessage is answered without reading the store. The store
+ * can be replicated to a standby process, which keeps its own log store and receives the log messages with a log
+ * receiver (see LogReplication.h); for a failover the backend is opened on the directory of the standby.
+ * Transaction volumes are answered from an optional column store of the finished transactions (see
+ * TransactionColumns.h). Exports can be run in the background by an export scheduler with I/O and CPU budgets and a
+ * latency bound for the transaction functions (see ExportScheduler.h). The replication, the export scheduler and the
+ * append shards run threads of their own and are only available in the server build profile (see Profile.h).
+ * Several backends can be opened in one process by a tenant host (see TenantHost.h), which shares its storage
+ * backend, its retirer and its export scheduler with them and limits the memory of each backend by a quota.
+ *
+ * The keys whose certificates verify the log messages are managed by a key manager (see KeyManager.h): standby keys
+ * that have been certified outside of the backend take over between two log messages when the certificate of the
+ * active key nears its expiry or disableSecureElement has been invoked, without interrupting the transaction
+ * functions.
+ *
+ * The transaction functions can be traced (see TransactionTrace.h): for a sample of the transactions, every call
+ * records the wait for the append lock or the append shard (queueing), the allocation of the counters and the
+ * activation of a standby key (counters), the write to the log store (storage), the update of the recent log
+ * messages and of the column store (index), the receipt code of finishTransaction (receiptCode) and the wait for the
+ * standby of a semi-synchronous replication (replication), which seApiBindingDumpTrace writes to a file.
+ */
+
+/**
+ * Represents the SE API function that is executed by seApiBindingLogTransaction.
+ */
+enum SeApiBindingOperation {
+seApiBindingStart = 1, seApiBindingUpdate = 2, seApiBindingFinish = 3
+};
+
+/**
+ * Represents the selection of seApiBindingExport.
+ */
+enum SeApiBindingExportFilter {
+seApiBindingExportAll, seApiBindingExportTransactions, seApiBindingExportPeriod
+};
+
+/**
+ * Flag that is combined with a value of enum SeApiBindingExportFilter to append the integrity manifest (see
+ * TarManifest.h) to the archive
+ */
+#define SE_API_BINDING_EXPORT_MANIFEST 0x100u
+
+/**
+ * Indexes of the output values of the functions
+ */
+#define SE_API_BINDING_TRANSACTION_NUMBER 0
+#define SE_API_BINDING_SIGNATURE_COUNTER 1
+#define SE_API_BINDING_LOG_TIME 2
+#define SE_API_BINDING_LOG_MESSAGE_LENGTH 3
+#define SE_API_BINDING_RECEIPT_CODE_LENGTH 3
+#define SE_API_BINDING_EXPORT_ADDRESS 0
+#define SE_API_BINDING_EXPORT_LENGTH 1
+#define SE_API_BINDING_EXPORT_JOB 0
+#define SE_API_BINDING_EXPORT_STATE 0
+#define SE_API_BINDING_EXPORT_BYTES_READ 1
+#define SE_API_BINDING_EXPORT_BYTES_PLANNED 2
+#define SE_API_BINDING_EXPORT_RESULT 3
+#define SE_API_BINDING_RESULT 0
+#define SE_API_BINDING_REMAINING_RETRIES 1
+#define SE_API_BINDING_RESULT_COUNT 4
+
+/**
+ * Resources that a backend shares with the other backends of a tenant host. A member that is NULL is created by the
+ * backend for itself; a memoryQuota of 0 does not limit the memory of the backend. The resources MUST stay
+ * available until the backend has been closed.
+ */
+struct SeApiBindingShared {
+    struct StorageIo *io;
+    struct SegmentRetirer *retirer;
+    struct TransactionTrace *trace;
+#if PROFILE_CONCURRENT
+    struct ExportScheduler *exportScheduler;
+#endif
+    uint64_t memoryQuota;
+};
+
+/**
+ * State of an opened backend. The members are managed by the functions of this header file.
+ */
+struct SeApiBinding {
+    struct LogStore store;
+    struct CounterJournal journal;
+    struct SegmentRetirer *retirer;
+    struct SegmentRetirer ownRetirer;
+    struct UserSessions userSessions;
+    struct RecentLogMessages recentLogMessages;
+    struct ReceiptCodeKey receiptCodeKey;
+    struct KeyManager keys;
+    struct SeDescription description;
+    uint64_t memoryQuota;
+    struct TransactionTrace *trace;
+    struct TransactionTrace ownTrace;
+    uint32_t traceSource;
+    struct TransactionColumns *_Atomic columns;
+#if PROFILE_CONCURRENT
+    struct LogShipper *shipper;
+    unsigned int semiSynchronousTimeout;
+    struct AppendShards *_Atomic shards;
+    struct ExportScheduler *_Atomic exportScheduler;
+    bool exportSchedulerShared;
+    atomic_bool exportQueued;
+#endif
+    pthread_mutex_t appendLock;
+    atomic_bool timeSet;
+    _Atomic int64_t timeOffset;
+};
+
+/**
+ * Opens the backend in a directory.
+ * @param[in] directory
+ *                existing directory for the stored data, terminated by NUL [REQUIRED]
+ * @param[out] results
+ *                receives the address of the opened backend at index 0 [REQUIRED]
+ * @return the return values of logStoreOpen, counterJournalOpen and userSessionsOpen
+ */
+short int seApiBindingOpen(const char *directory,
+                           int64_t *results);
+
+/**
+ * Opens the backend in a directory with resources shared with other backends.
+ * @param[in] directory
+ *                existing directory for the stored data, terminated by NUL [REQUIRED]
+ * @param[in] shared
+ *                the shared resources, NULL for none [OPTIONAL]
+ * @param[out] results
+ *                receives the address of the opened backend at index 0 [REQUIRED]
+ * @return the return values of logStoreOpen, counterJournalOpen, seDescriptionLoad, userSessionsOpen and
+ *         segmentRetirerAdd
+ */
+short int seApiBindingOpenShared(const char *directory,
+                                 const struct SeApiBindingShared *shared,
+                                 int64_t *results);
+
+/**
+ * Closes the backend and releases its memory.
+ * @param[in] binding
+ *                opened backend [REQUIRED]
+ * @return the return values of logStoreClose and counterJournalClose
+ */
+short int seApiBindingClose(struct SeApiBinding *binding);
+
+/**
+ * Backend implementation of updateTime. The time of the backend follows the real-time clock of the host with the
+ * offset of the last update.
+ * @param[in] binding
+ *                opened backend [REQUIRED]
+ * @param[in] newTime
+ *                new time in seconds since the epoch (UTC) [REQUIRED]
+ * @param[out] results
+ *                receives the signature counter and the log time of the system log message [REQUIRED]
+ * @return EXECUTION_OK, ERROR_INVALID_TIME or the return values of logStoreAppend
+ */
+short int seApiBindingUpdateTime(struct SeApiBinding *binding,
+                                 int64_t newTime,
+                                 int64_t *results);
+
+/**
+ * Backend implementation of startTransaction, updateTransaction and finishTransaction. The payload of the log message
+ * consists of the length of the processType in one byte, the processType and the processData.
+ * @param[in] binding
+ *                opened backend [REQUIRED]
+ * @param[in] operation
+ *                value of enum SeApiBindingOperation [REQUIRED]
+ * @param[in] clientId
+ *                the ID of the application that has invoked the function [REQUIRED]
+ * @param[in] clientIdLength
+ *                the length of the array that represents the clientId [REQUIRED]
+ * @param[in] transactionNumber
+ *                the number of the open transaction, ignored for seApiBindingStart [REQUIRED]
+ * @param[in] processData
+ *                the process data [OPTIONAL]
+ * @param[in] processDataLength
+ *                the length of the array that represents the processData [REQUIRED]
+ * @param[in] processType
+ *                the type of the transaction [OPTIONAL]
+ * @param[in] processTypeLength
+ *                the length of the array that represents the processType, at most 100 [REQUIRED]
+ * @param[out] results
+ *                receives the transaction number, the signature counter and the log time [REQUIRED]
+ * @return if the execution of the function has been successful, the return value EXECUTION_OK SHALL be returned.
+ *
+ *         If the execution of the function has failed, the appropriate error code SHALL be returned:
+ *
+ *             ERROR_PARAMETER_MISMATCH
+ *                the operation is unknown or a length is out of range
+ *             ERROR_TIME_NOT_SET
+ *                the time has not been set by updateTime
+ *             ERROR_NO_TRANSACTION
+ *                no transaction is known to be open under the provided transaction number
+ *             ERROR_STORAGE_FAILURE
+ *                storing of the log message failed
+ *             ERROR_CERTIFICATE_EXPIRED
+ *                the certificate of the active key has expired and no standby key has taken over; the log message
+ *                has been stored and the results have been written
+ *             ERROR_SECURE_ELEMENT_DISABLED
+ *                the Secure Element has been disabled and no standby key has taken over
+ */
+short int seApiBindingLogTransaction(struct SeApiBinding *binding,
+                                     uint32_t operation,
+                                     const unsigned char *clientId,
+                                     uint64_t clientIdLength,
+                                     uint64_t transactionNumber,
+                                     const unsigned char *processData,
+                                     uint64_t processDataLength,
+                                     const unsigned char *processType,
+                                     uint64_t processTypeLength,
+                                     int64_t *results);
+
+/**
+ * Backend implementation of finishTransaction that returns the receipt code of the transaction (see ReceiptCode.h)
+ * as additional output, so that the receipt can be printed without formatting the outputs of finishTransaction.
+ * The receipt code is built while the append lock is held and without allocating memory.
+ * @param[in] receiptCode
+ *                receives the receipt code if it does not exceed receiptCodeCapacity [OPTIONAL]
+ * @param[in] receiptCodeCapacity
+ *                size of the array receiptCode [REQUIRED]
+ * @param[out] results
+ *                receives the transaction number, the signature counter, the log time and the length of the
+ *                receipt code, which is 0 if a time cannot be represented in the receipt code [REQUIRED]
+ * @return the return values of seApiBindingLogTransaction; a receipt code that does not fit into receiptCode is
+ *         not an error, since the transaction has been finished
+ */
+short int seApiBindingFinishTransaction(struct SeApiBinding *binding,
+                                        const unsigned char *clientId,
+                                        uint64_t clientIdLength,
+                                        uint64_t transactionNumber,
+                                        const unsigned char *processData,
+                                        uint64_t processDataLength,
+                                        const unsigned char *processType,
+                                        uint64_t processTypeLength,
+                                        char *receiptCode,
+                                        uint64_t receiptCodeCapacity,
+                                        int64_t *results);
+
+/**
+ * Sets the signature algorithm and the public key that are written to the receipt codes. Both are empty after
+ * opening if no key of the key manager is active, since the backend does not sign the log messages. The next
+ * activation of a standby key replaces them.
+ * @return the return values of receiptCodeKeyInit
+ */
+short int seApiBindingSetReceiptCodeKey(struct SeApiBinding *binding,
+                                        const char *signatureAlgorithm,
+                                        uint64_t signatureAlgorithmLength,
+                                        const unsigned char *publicKey,
+                                        uint64_t publicKeyLength);
+
+/**
+ * Starts the provisioning of standby keys by a callback, e.g. one that generates a key pair on a second Secure
+ * Element and has it certified (see keyManagerStart).
+ * @param[in] binding
+ *                opened backend [REQUIRED]
+ * @param[in] provisioner
+ *                callback that generates and certifies standby keys, NULL if standby keys are only added with
+ *                seApiBindingAddStandbyKey [OPTIONAL]
+ * @param[in] provisionerContext
+ *                context passed to the provisioner [OPTIONAL]
+ * @param[in] standbyCount
+ *                number of standby keys that are kept available, 0 selects the default [REQUIRED]
+ * @param[in] rotationLead
+ *                time in seconds before the end of the validity of the active certificate at which a standby key
+ *                takes over, 0 selects the default [REQUIRED]
+ * @return the return values of keyManagerStart
+ */
+short int seApiBindingStartKeyManager(struct SeApiBinding *binding,
+                                      KeyProvisioner provisioner,
+                                      void *provisionerContext,
+                                      uint32_t standbyCount,
+                                      int64_t rotationLead);
+
+/**
+ * Adds a standby key that has been generated and certified outside of the backend. The first key that is added
+ * to a backend without an active key takes over with the next log message.
+ * @param[in] binding
+ *                opened backend [REQUIRED]
+ * @param[in] signatureAlgorithm
+ *                name of the signature algorithm of the key [OPTIONAL]
+ * @param[in] signatureAlgorithmLength
+ *                the length of the name [REQUIRED]
+ * @param[in] publicKey
+ *                the public key [REQUIRED]
+ * @param[in] publicKeyLength
+ *                the length of the public key [REQUIRED]
+ * @param[in] certificate
+ *                the certificate of the public key [REQUIRED]
+ * @param[in] certificateLength
+ *                the length of the certificate [REQUIRED]
+ * @param[in] notAfter
+ *                end of the validity of the certificate in seconds since the epoch (UTC), 0 if it does not
+ *                expire [REQUIRED]
+ * @return the return values of keyManagerAddStandby
+ */
+short int seApiBindingAddStandbyKey(struct SeApiBinding *binding,
+                                    const char *signatureAlgorithm,
+                                    uint64_t signatureAlgorithmLength,
+                                    const unsigned char *publicKey,
+                                    uint64_t publicKeyLength,
+                                    const unsigned char *certificate,
+                                    uint64_t certificateLength,
+                                    int64_t notAfter);
+
+/**
+ * Backend implementation of disableSecureElement for the authenticated user that has invoked it. The
+ * deactivation is logged as a system log message, after which the active key is not used anymore. A standby key
+ * takes over with the next log message; without a standby key the log functions fail with
+ * ERROR_SECURE_ELEMENT_DISABLED until one is added.
+ * @param[in] binding
+ *                opened backend [REQUIRED]
+ * @param[in] userId
+ *                the ID of the user [REQUIRED]
+ * @param[in] userIdLength
+ *                the length of the array that represents the userId [REQUIRED]
+ * @param[out] results
+ *                receives the signature counter and the log time of the system log message [REQUIRED]
+ * @return the return values of userSessionsCheck, logStoreAppend and keyManagerDisable
+ */
+short int seApiBindingDisableSecureElement(struct SeApiBinding *binding,
+                                           const unsigned char *userId,
+                                           uint64_t userIdLength,
+                                           int64_t *results);
+
+/**
+ * Backend implementation of exportSerialNumbers. The data is returned from a cache that is updated after a key has
+ * taken over.
+ * @param[in] binding
+ *                opened backend [REQUIRED]
+ * @param[out] results
+ *                receives the address and the length of the TLV encoded serial numbers, which are released with
+ *                seApiBindingFreeExport [REQUIRED]
+ * @return the return values of keyManagerExportSerialNumbers
+ */
+short int seApiBindingExportSerialNumbers(struct SeApiBinding *binding,
+                                          int64_t *results);
+
+/**
+ * Backend implementation of exportCertificates. The archive is returned from a cache that is extended after a key
+ * has taken over.
+ * @param[in] binding
+ *                opened backend [REQUIRED]
+ * @param[out] results
+ *                receives the address and the length of the TAR archive, which is released with
+ *                seApiBindingFreeExport [REQUIRED]
+ * @return the return values of keyManagerExportCertificates
+ */
+short int seApiBindingExportCertificates(struct SeApiBinding *binding,
+                                         int64_t *results);
+
+#if PROFILE_CONCURRENT
+/**
+ * Starts the replication of the store to a standby, whose log receiver listens on a Unix domain socket. The log
+ * messages stored so far are shipped first; the replication continues until the backend is closed.
+ * @param[in] binding
+ *                opened backend [REQUIRED]
+ * @param[in] socketPath
+ *                path of the socket of the standby, terminated by NUL [REQUIRED]
+ * @param[in] semiSynchronousTimeout
+ *                maximum time in milliseconds that startTransaction, updateTransaction and finishTransaction wait for
+ *                the acknowledgment of the standby, 0 for an asynchronous replication [REQUIRED]
+ * @return if the execution of the function has been successful, the return value EXECUTION_OK SHALL be returned.
+ *
+ *         If the execution of the function has failed, the appropriate error code SHALL be returned:
+ *
+ *             ERROR_PARAMETER_MISMATCH
+ *                the replication has already been started or the socket path is too long
+ *             ERROR_STORAGE_FAILURE
+ *                the shipper could not be started
+ */
+short int seApiBindingStartReplication(struct SeApiBinding *binding,
+                                       const char *socketPath,
+                                       uint32_t semiSynchronousTimeout);
+#endif
+
+/**
+ * Backend implementation of the exportData functions.
+ * @param[in] binding
+ *                opened backend [REQUIRED]
+ * @param[in] filter
+ *                value of enum SeApiBindingExportFilter, optionally combined with SE_API_BINDING_EXPORT_MANIFEST
+ *                [REQUIRED]
+ * @param[in] start
+ *                first transaction number, or starting time in seconds since the epoch and INT64_MIN if the period
+ *                has no start [REQUIRED]
+ * @param[in] end
+ *                last transaction number, or end time in seconds since the epoch and INT64_MAX if the period has no
+ *                end [REQUIRED]
+ * @param[in] clientId
+ *                ID of the client whose transaction log messages are selected [OPTIONAL]
+ * @param[in] clientIdLength
+ *                length of the array that represents the clientId [REQUIRED]
+ * @param[in] maximumNumberRecords
+ *                maximum number of exported log messages, 0 for no limit [REQUIRED]
+ * @param[out] results
+ *                receives the address and the length of the archive [REQUIRED]
+ * @return the return values of exportScanAll, exportScanTransactionInterval and exportScanPeriodOfTime
+ */
+short int seApiBindingExport(struct SeApiBinding *binding,
+                             uint32_t filter,
+                             int64_t start,
+                             int64_t end,
+                             const unsigned char *clientId,
+                             uint64_t clientIdLength,
+                             int64_t maximumNumberRecords,
+                             int64_t *results);
+
+/**
+ * Releases an archive returned by seApiBindingExport.
+ * @param[in] data
+ *                address of the archive [OPTIONAL]
+ */
+void seApiBindingFreeExport(unsigned char *data);
+
+#if PROFILE_CONCURRENT
+/**
+ * Starts the export scheduler, which runs the exports submitted with seApiBindingSubmitExport in the background.
+ * While an export runs, startTransaction, updateTransaction and finishTransaction report their latency to it.
+ * @param[in] binding
+ *                opened backend [REQUIRED]
+ * @param[in] bytesPerSecond
+ *                I/O budget of the exports, 0 selects the default [REQUIRED]
+ * @param[in] cpuPermille
+ *                CPU budget of the exports in thousandths of a core, 0 selects the default [REQUIRED]
+ * @param[in] latencyBound
+ *                bound of the 99th percentile of the latency of the transaction functions in nanoseconds, 0 selects
+ *                the default [REQUIRED]
+ * @return EXECUTION_OK, ERROR_PARAMETER_MISMATCH if the scheduler has already been started or ERROR_STORAGE_FAILURE
+ *         if the scheduler could not be started
+ */
+short int seApiBindingStartExportScheduler(struct SeApiBinding *binding,
+                                           uint64_t bytesPerSecond,
+                                           uint32_t cpuPermille,
+                                           uint64_t latencyBound);
+
+/**
+ * Queues an export with the parameters of seApiBindingExport. The job MUST be collected with
+ * seApiBindingCollectExport before the backend is closed. A backend whose export scheduler is shared by a tenant host
+ * has at most one export queued or running, so that the scheduler runs the exports of the tenants in turn.
+ * @param[in] binding
+ *                backend with a started export scheduler [REQUIRED]
+ * @param[in] filter
+ *                see seApiBindingExport [REQUIRED]
+ * @param[in] start
+ *                see seApiBindingExport [REQUIRED]
+ * @param[in] end
+ *                see seApiBindingExport [REQUIRED]
+ * @param[in] clientId
+ *                ID of the client whose transaction log messages are selected [OPTIONAL]
+ * @param[in] clientIdLength
+ *                length of the array that represents the clientId [REQUIRED]
+ * @param[in] maximumNumberRecords
+ *                maximum number of exported log messages, 0 for no limit [REQUIRED]
+ * @param[out] results
+ *                receives the address of the job at index SE_API_BINDING_EXPORT_JOB [REQUIRED]
+ * @return EXECUTION_OK, ERROR_PARAMETER_MISMATCH if the scheduler has not been started, a parameter is invalid or,
+ *         for a scheduler shared by a tenant host, an export of the backend has not been collected yet, or
+ *         ERROR_STORAGE_FAILURE if no memory could be allocated
+ */
+short int seApiBindingSubmitExport(struct SeApiBinding *binding,
+                                   uint32_t filter,
+                                   int64_t start,
+                                   int64_t end,
+                                   const unsigned char *clientId,
+                                   uint64_t clientIdLength,
+                                   int64_t maximumNumberRecords,
+                                   int64_t *results);
+
+/**
+ * Reports the progress of a queued export.
+ * @param[in] binding
+ *                backend with a started export scheduler [REQUIRED]
+ * @param[in] job
+ *                address of the job [REQUIRED]
+ * @param[out] results
+ *                receives the value of enum ExportJobState, the number of bytes read, the estimated number of bytes
+ *                to be read and the result of a finished export [REQUIRED]
+ */
+void seApiBindingExportStatus(struct SeApiBinding *binding,
+                              int64_t job,
+                              int64_t *results);
+
+/**
+ * Cancels a queued or running export; the export is collected with seApiBindingCollectExport as usual.
+ * @param[in] binding
+ *                backend with a started export scheduler [REQUIRED]
+ * @param[in] job
+ *                address of the job [REQUIRED]
+ */
+void seApiBindingCancelExport(struct SeApiBinding *binding,
+                              int64_t job);
+
+/**
+ * Waits until a queued export has finished, returns its archive and releases the job.
+ * @param[in] binding
+ *                backend with a started export scheduler [REQUIRED]
+ * @param[in] job
+ *                address of the job [REQUIRED]
+ * @param[out] results
+ *                receives the address and the length of the archive [REQUIRED]
+ * @return the return values of seApiBindingExport, ERROR_STORAGE_FAILURE for a cancelled export
+ */
+short int seApiBindingCollectExport(struct SeApiBinding *binding,
+                                    int64_t job,
+                                    int64_t *results);
+
+/**
+ * Lets startTransaction, updateTransaction and finishTransaction store their log messages through append shards
+ * (see AppendShards.h), so that concurrent clients on many cores are served in batches by the thread that holds
+ * the append lock. The shards are used until the backend is closed.
+ * @param[in] binding
+ *                opened backend [REQUIRED]
+ * @param[in] shardCount
+ *                number of shards, 0 for the number of online processors [REQUIRED]
+ * @return EXECUTION_OK, ERROR_PARAMETER_MISMATCH if the shards have already been started or ERROR_STORAGE_FAILURE
+ *         if no memory could be allocated
+ */
+short int seApiBindingStartAppendShards(struct SeApiBinding *binding,
+                                        uint32_t shardCount);
+
+/**
+ * Implementation of ExportJobRunner that runs the exports submitted with seApiBindingSubmitExport, which is passed
+ * to an export scheduler that is shared by several backends.
+ */
+short int seApiBindingExecuteExport(void *runnerContext,
+                                    struct ExportJob *job,
+                                    ExportThrottle throttle,
+                                    void *throttleContext);
+#endif
+
+/**
+ * Opens the column store of the finished transactions in the subdirectory analytics and adds the finished
+ * transactions that are missing in it. Afterwards every finishTransaction adds a row.
+ * @param[in] binding
+ *                opened backend [REQUIRED]
+ * @return EXECUTION_OK, ERROR_PARAMETER_MISMATCH if the column store has already been opened or the return values of
+ *         transactionColumnsOpen
+ */
+short int seApiBindingOpenTransactionColumns(struct SeApiBinding *binding);
+
+/**
+ * Aggregates the finished transactions of a period by client, process type and interval of the log time.
+ * @param[in] binding
+ *                opened backend [REQUIRED]
+ * @param[in] startTime
+ *                start (inclusive) of the period in seconds since the epoch (UTC) [REQUIRED]
+ * @param[in] endTime
+ *                end (inclusive) of the period in seconds since the epoch (UTC) [REQUIRED]
+ * @param[in] clientId
+ *                ID of the client whose transactions are aggregated, all clients if it is missing [OPTIONAL]
+ * @param[in] clientIdLength
+ *                length of the array that represents the clientId [REQUIRED]
+ * @param[in] processType
+ *                process type of the aggregated transactions, all process types if it is missing [OPTIONAL]
+ * @param[in] processTypeLength
+ *                length of the array that represents the processType [REQUIRED]
+ * @param[in] interval
+ *                length of the intervals in seconds, e.g. 3600 for hours, 0 for the whole period [REQUIRED]
+ * @param[out] results
+ *                receives the address and the number of the aggregates (struct TransactionVolume), to be released
+ *                with seApiBindingFreeExport [REQUIRED]
+ * @return EXECUTION_OK, ERROR_PARAMETER_MISMATCH if the column store has not been opened or the return values of
+ *         transactionColumnsAggregate
+ */
+short int seApiBindingTransactionVolumes(struct SeApiBinding *binding,
+                                         int64_t startTime,
+                                         int64_t endTime,
+                                         const unsigned char *clientId,
+                                         uint64_t clientIdLength,
+                                         const unsigned char *processType,
+                                         uint64_t processTypeLength,
+                                         int64_t interval,
+                                         int64_t *results);
+
+/**
+ * Copies the clientId or processType of a code of an aggregate returned by seApiBindingTransactionVolumes.
+ * @param[in] binding
+ *                opened backend [REQUIRED]
+ * @param[in] processType
+ *                1 for a process type, 0 for a clientId [REQUIRED]
+ * @param[in] code
+ *                the code [REQUIRED]
+ * @param[out] value
+ *                receives the value [OPTIONAL]
+ * @param[in] capacity
+ *                size of the array value [REQUIRED]
+ * @param[out] results
+ *                receives the length of the value at index 0 [REQUIRED]
+ * @return EXECUTION_OK, ERROR_PARAMETER_MISMATCH if the column store has not been opened or the return values of
+ *         transactionColumnsValue
+ */
+short int seApiBindingTransactionColumnValue(struct SeApiBinding *binding,
+                                             uint32_t processType,
+                                             uint32_t code,
+                                             unsigned char *value,
+                                             uint64_t capacity,
+                                             int64_t *results);
+
+/**
+ * Backend implementation of readLogMessage and of its variant for a client or a transaction. The log message is
+ * copied from the recent log messages kept in memory. The store is only read for the last log message if no log
+ * message has been stored since the backend has been opened, and for log messages whose payload is longer than
+ * RECENT_LOG_MESSAGE_PAYLOAD_SIZE.
+ * @param[in] binding
+ *                opened backend [REQUIRED]
+ * @param[in] clientId
+ *                ID of the client whose most recent transaction log message is read, the last log message of all
+ *                clients is read if it is missing [OPTIONAL]
+ * @param[in] clientIdLength
+ *                length of the array that represents the clientId [REQUIRED]
+ * @param[in] transactionNumber
+ *                number of the transaction of the client whose most recent log message is read, 0 for any
+ *                transaction [REQUIRED]
+ * @param[out] logMessage
+ *                receives the payload of the log message [OPTIONAL]
+ * @param[in] logMessageCapacity
+ *                size of the array logMessage [REQUIRED]
+ * @param[out] results
+ *                receives the transaction number, the signature counter, the log time and the length of the
+ *                log message [REQUIRED]
+ * @return if the execution of the function has been successful, the return value EXECUTION_OK SHALL be returned.
+ *
+ *         If the execution of the function has failed, the appropriate error code SHALL be returned:
+ *
+ *             ERROR_PARAMETER_MISMATCH
+ *                the clientId is too long or the log message is longer than logMessageCapacity; the required
+ *                length has been written to the results
+ *             ERROR_NO_LOG_MESSAGE
+ *                no log message is stored or none of the client or the transaction is among the recent log messages
+ *             ERROR_READING_LOG_MESSAGE
+ *                the log message could not be read from the store
+ */
+short int seApiBindingReadLogMessage(struct SeApiBinding *binding,
+                                     const unsigned char *clientId,
+                                     uint64_t clientIdLength,
+                                     uint64_t transactionNumber,
+                                     unsigned char *logMessage,
+                                     uint64_t logMessageCapacity,
+                                     int64_t *results);
+
+/**
+ * Backend implementation of authenticateUser.
+ * @param[out] results
+ *                receives the value of enum CredentialCheck and the number of remaining retries [REQUIRED]
+ * @return the return values of userSessionsAuthenticate
+ */
+short int seApiBindingAuthenticateUser(struct SeApiBinding *binding,
+                                       const unsigned char *userId,
+                                       uint64_t userIdLength,
+                                       const unsigned char *pin,
+                                       uint64_t pinLength,
+                                       int64_t *results);
+
+/**
+ * Backend implementation of logOut.
+ * @return the return values of userSessionsLogOut
+ */
+short int seApiBindingLogOut(struct SeApiBinding *binding,
+                             const unsigned char *userId,
+                             uint64_t userIdLength);
+
+/**
+ * Backend implementation of unblockUser.
+ * @param[out] results
+ *                receives the value of enum CredentialCheck [REQUIRED]
+ * @return the return values of userSessionsUnblock
+ */
+short int seApiBindingUnblockUser(struct SeApiBinding *binding,
+                                  const unsigned char *userId,
+                                  uint64_t userIdLength,
+                                  const unsigned char *puk,
+                                  uint64_t pukLength,
+                                  const unsigned char *newPin,
+                                  uint64_t newPinLength,
+                                  int64_t *results);
+
+/**
+ * Backend implementation of deleteStoredData for the authenticated user that has invoked it.
+ * @return the return values of userSessionsCheck and segmentRetirerDeleteStoredData
+ */
+short int seApiBindingDeleteStoredData(struct SeApiBinding *binding,
+                                       const unsigned char *userId,
+                                       uint64_t userIdLength);
+
+/**
+ * Backend implementation of getCurrentNumberOfTransactions.
+ * @param[out] results
+ *                receives the number of open transactions [REQUIRED]
+ * @return EXECUTION_OK
+ */
+short int seApiBindingCurrentNumberOfTransactions(struct SeApiBinding *binding,
+                                                  int64_t *results);
+
+/**
+ * Finishes the open transactions whose last log message is older than the stale transaction age of the store,
+ * e.g. those of a till that has crashed, by a finishTransaction log message without process data for each of them.
+ * Every transaction is finished under the append lock after checking that it has not been updated since it has
+ * been found stale, so that a transaction that is used again is left open.
+ * @param[in] binding
+ *                opened backend [REQUIRED]
+ * @param[out] results
+ *                receives the number of finished transactions [REQUIRED]
+ * @return EXECUTION_OK, ERROR_TIME_NOT_SET if the time has not been set or the return values of
+ *         logStoreFinishStaleTransactions
+ */
+short int seApiBindingFinishStaleTransactions(struct SeApiBinding *binding,
+                                              int64_t *results);
+
+/**
+ * Backend implementation of initializeDescriptionSet and initializeDescriptionNotSet for the authenticated user
+ * that has invoked it. The initialization is logged as a system log message.
+ * @param[in] binding
+ *                opened backend [REQUIRED]
+ * @param[in] userId
+ *                the ID of the user [REQUIRED]
+ * @param[in] userIdLength
+ *                the length of the array that represents the userId [REQUIRED]
+ * @param[in] description
+ *                description for initializeDescriptionNotSet, NULL for initializeDescriptionSet [OPTIONAL]
+ * @param[in] descriptionLength
+ *                the length of the description [REQUIRED]
+ * @param[out] results
+ *                receives the signature counter and the log time of the system log message [REQUIRED]
+ * @return the return values of userSessionsCheck, seDescriptionInitialize and logStoreAppend
+ */
+short int seApiBindingInitialize(struct SeApiBinding *binding,
+                                 const unsigned char *userId,
+                                 uint64_t userIdLength,
+                                 const unsigned char *description,
+                                 uint64_t descriptionLength,
+                                 int64_t *results);
+
+/**
+ * Determines the memory of the backend that is limited by the memory quota of a tenant host: the state of the
+ * backend and the memory estimated by logStoreMemoryUsage. startTransaction fails with
+ * ERROR_START_TRANSACTION_FAILED while it reaches the quota.
+ * @param[in] binding
+ *                opened backend [REQUIRED]
+ * @param[out] results
+ *                receives the number of bytes at index 0 and the quota at index 1 [REQUIRED]
+ * @return EXECUTION_OK
+ */
+short int seApiBindingMemoryUsage(struct SeApiBinding *binding,
+                                  int64_t *results);
+
+/**
+ * Sets the sampling interval of the trace of the transaction functions. The trace of a backend of a tenant host is
+ * shared by all its backends.
+ * @param[in] binding
+ *                opened backend [REQUIRED]
+ * @param[in] samplingInterval
+ *                the transactions whose transaction number is a multiple of this interval are traced, 0 to disable
+ *                the tracing [REQUIRED]
+ * @return EXECUTION_OK
+ */
+short int seApiBindingSetTraceSampling(struct SeApiBinding *binding,
+                                       uint32_t samplingInterval);
+
+/**
+ * Writes the recorded spans of the trace of the transaction functions to a file in the JSON trace event format,
+ * which is read by chrome://tracing and the Perfetto UI.
+ * @param[in] binding
+ *                opened backend [REQUIRED]
+ * @param[in] path
+ *                path of the file, which is replaced, terminated by NUL [REQUIRED]
+ * @return EXECUTION_OK, ERROR_PARAMETER_MISMATCH if the path is missing or the return values of
+ *         transactionTraceDump
+ */
+short int seApiBindingDumpTrace(struct SeApiBinding *binding,
+                                const char *path);
+
+#endif
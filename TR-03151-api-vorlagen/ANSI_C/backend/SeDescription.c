@@ -0,0 +1,196 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "SeDescription.h"
+#include "Crc32.h"
+
+/**
+ * Identifies a description file ("SDSC") and its layout version
+ */
+#define DESCRIPTION_MAGIC 0x53445343u
+#define DESCRIPTION_VERSION 1u
+
+#define DESCRIPTION_FILE_NAME "description.dat"
+#define DESCRIPTION_TEMPORARY_FILE_NAME "description.dat.tmp"
+
+#define DESCRIPTION_SET_BY_MANUFACTURER 0x1u
+#define DESCRIPTION_INITIALIZED 0x2u
+
+/**
+ * Layout of the description file. The checksum covers the whole file with the member crc set to 0.
+ */
+struct DescriptionFile {
+    uint32_t magic;
+    uint32_t version;
+    uint16_t flags;
+    uint16_t length;
+    uint32_t crc;
+    unsigned char value[SE_DESCRIPTION_MAX];
+};
+
+static short int seDescriptionFilePath(const char *directory,
+                                       const char *name,
+                                       char *path,
+                                       size_t pathSize)
+{
+    int length = snprintf(path, pathSize, "%s/%s", directory, name);
+
+    if (length < 0 || (size_t) length >= pathSize) {
+        return ERROR_PARAMETER_MISMATCH;
+    }
+    return EXECUTION_OK;
+}
+
+/**
+ * Replaces the description file by the passed description.
+ */
+static short int seDescriptionPersist(const char *directory,
+                                      const struct SeDescription *description)
+{
+    char path[4096];
+    char temporaryPath[4096];
+    struct DescriptionFile file;
+    size_t position = 0;
+    short int result = EXECUTION_OK;
+    int fd;
+
+    if (seDescriptionFilePath(directory, DESCRIPTION_FILE_NAME, path, sizeof path) != EXECUTION_OK
+        || seDescriptionFilePath(directory, DESCRIPTION_TEMPORARY_FILE_NAME, temporaryPath,
+                                 sizeof temporaryPath) != EXECUTION_OK) {
+        return ERROR_STORING_INIT_DATA_FAILED;
+    }
+
+    memset(&file, 0, sizeof file);
+    file.magic = DESCRIPTION_MAGIC;
+    file.version = DESCRIPTION_VERSION;
+    file.flags = (uint16_t) ((description->setByManufacturer ? DESCRIPTION_SET_BY_MANUFACTURER : 0u)
+                             | (description->initialized ? DESCRIPTION_INITIALIZED : 0u));
+    file.length = description->length;
+    memcpy(file.value, description->value, description->length);
+    file.crc = crc32Update(0, &file, sizeof file);
+
+    fd = open(temporaryPath, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+    if (fd < 0) {
+        return ERROR_STORING_INIT_DATA_FAILED;
+    }
+    while (position < sizeof file) {
+        ssize_t written = write(fd, (const unsigned char *) &file + position, sizeof file - position);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            result = ERROR_STORING_INIT_DATA_FAILED;
+            break;
+        }
+        position += (size_t) written;
+    }
+    if (result == EXECUTION_OK && fdatasync(fd) != 0) {
+        result = ERROR_STORING_INIT_DATA_FAILED;
+    }
+    close(fd);
+    if (result == EXECUTION_OK && rename(temporaryPath, path) != 0) {
+        result = ERROR_STORING_INIT_DATA_FAILED;
+    }
+    if (result == EXECUTION_OK) {
+        fd = open(directory, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (fd < 0 || fsync(fd) != 0) {
+            result = ERROR_STORING_INIT_DATA_FAILED;
+        }
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+    return result;
+}
+
+short int seDescriptionLoad(struct SeDescription *description,
+                            const char *directory)
+{
+    char path[4096];
+    struct DescriptionFile file;
+    uint32_t crc;
+    ssize_t readLength;
+    int fd;
+
+    memset(description, 0, sizeof *description);
+    if (seDescriptionFilePath(directory, DESCRIPTION_FILE_NAME, path, sizeof path) != EXECUTION_OK) {
+        return ERROR_STORAGE_FAILURE;
+    }
+    fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return errno == ENOENT ? EXECUTION_OK : ERROR_STORAGE_FAILURE;
+    }
+    do {
+        readLength = read(fd, &file, sizeof file);
+    } while (readLength < 0 && errno == EINTR);
+    close(fd);
+    if (readLength != (ssize_t) sizeof file) {
+        return ERROR_STORAGE_FAILURE;
+    }
+    crc = file.crc;
+    file.crc = 0;
+    if (file.magic != DESCRIPTION_MAGIC || file.version != DESCRIPTION_VERSION || file.length > SE_DESCRIPTION_MAX
+        || crc32Update(0, &file, sizeof file) != crc) {
+        return ERROR_STORAGE_FAILURE;
+    }
+    description->setByManufacturer = (file.flags & DESCRIPTION_SET_BY_MANUFACTURER) != 0;
+    description->initialized = (file.flags & DESCRIPTION_INITIALIZED) != 0;
+    description->length = file.length;
+    memcpy(description->value, file.value, file.length);
+    return EXECUTION_OK;
+}
+
+short int seDescriptionSetByManufacturer(const char *directory,
+                                         const unsigned char *value,
+                                         size_t length)
+{
+    struct SeDescription description;
+    short int result;
+
+    if (value == NULL || length > SE_DESCRIPTION_MAX) {
+        return ERROR_PARAMETER_MISMATCH;
+    }
+    result = seDescriptionLoad(&description, directory);
+    if (result != EXECUTION_OK) {
+        return ERROR_STORING_INIT_DATA_FAILED;
+    }
+    if (description.setByManufacturer || description.initialized) {
+        return ERROR_DESCRIPTION_SET_BY_MANUFACTURER;
+    }
+    description.setByManufacturer = true;
+    description.length = (uint16_t) length;
+    memcpy(description.value, value, length);
+    return seDescriptionPersist(directory, &description);
+}
+
+short int seDescriptionInitialize(struct SeDescription *description,
+                                  const char *directory,
+                                  const unsigned char *value,
+                                  size_t length)
+{
+    struct SeDescription initialized = *description;
+    short int result;
+
+    if (value == NULL && !description->setByManufacturer) {
+        return ERROR_DESCRIPTION_NOT_SET_BY_MANUFACTURER;
+    }
+    if (value != NULL && description->setByManufacturer) {
+        return ERROR_DESCRIPTION_SET_BY_MANUFACTURER;
+    }
+    if (value != NULL) {
+        if (length > SE_DESCRIPTION_MAX) {
+            return ERROR_PARAMETER_MISMATCH;
+        }
+        initialized.length = (uint16_t) length;
+        memcpy(initialized.value, value, length);
+    }
+    initialized.initialized = true;
+    result = seDescriptionPersist(directory, &initialized);
+    if (result == EXECUTION_OK) {
+        *description = initialized;
+    }
+    return result;
+}
@@ -0,0 +1,93 @@
+#ifndef SEAPI_BACKEND_SE_DESCRIPTION_H
+#define SEAPI_BACKEND_SE_DESCRIPTION_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "../Exception.h"
+#include "../Constant.h"
+
+/**
+ * This header file defines the description of the SE API that is set by the manufacturer or passed to
+ * initializeDescriptionNotSet, and whether the SE API has been initialized by initializeDescriptionSet or
+ * initializeDescriptionNotSet.
+ *
+ * The state is kept in the file description.dat in the directory of the backend. The file is written under a
+ * temporary name and renamed, so that a crash leaves either the previous or the new state. A directory without
+ * the file belongs to an SE API whose description has not been set by the manufacturer and that has not been
+ * initialized.
+ */
+
+/**
+ * Maximum length of a description in bytes
+ */
+#define SE_DESCRIPTION_MAX 256
+
+/**
+ * Description of an SE API
+ */
+struct SeDescription {
+    bool setByManufacturer;
+    bool initialized;
+    uint16_t length;
+    unsigned char value[SE_DESCRIPTION_MAX];
+};
+
+/**
+ * Reads the description of the SE API in a directory.
+ * @param[out] description
+ *                receives the description [REQUIRED]
+ * @param[in] directory
+ *                directory of the backend, terminated by NUL [REQUIRED]
+ * @return EXECUTION_OK or ERROR_STORAGE_FAILURE if the file cannot be read or is corrupted
+ */
+short int seDescriptionLoad(struct SeDescription *description,
+                            const char *directory);
+
+/**
+ * Sets the description of the manufacturer for an SE API whose directory does not hold a description yet, e.g.
+ * when a tenant host creates the directory of a new tenant.
+ * @param[in] directory
+ *                directory of the backend, terminated by NUL [REQUIRED]
+ * @param[in] value
+ *                the description [REQUIRED]
+ * @param[in] length
+ *                the length of the description, at most SE_DESCRIPTION_MAX [REQUIRED]
+ * @return EXECUTION_OK, ERROR_PARAMETER_MISMATCH if the description is too long, ERROR_DESCRIPTION_SET_BY_MANUFACTURER
+ *         if the directory already holds a description or ERROR_STORING_INIT_DATA_FAILED
+ */
+short int seDescriptionSetByManufacturer(const char *directory,
+                                         const unsigned char *value,
+                                         size_t length);
+
+/**
+ * Backend implementation of the checks and the storing of the initialization data of initializeDescriptionSet and
+ * initializeDescriptionNotSet.
+ * @param[in,out] description
+ *                description loaded with seDescriptionLoad, which is updated if the function succeeds [REQUIRED]
+ * @param[in] directory
+ *                directory of the backend, terminated by NUL [REQUIRED]
+ * @param[in] value
+ *                description passed to initializeDescriptionNotSet, NULL for initializeDescriptionSet [OPTIONAL]
+ * @param[in] length
+ *                the length of the description, at most SE_DESCRIPTION_MAX [REQUIRED]
+ * @return if the execution of the function has been successful, the return value EXECUTION_OK SHALL be returned.
+ *
+ *         If the execution of the function has failed, the appropriate error code SHALL be returned:
+ *
+ *             ERROR_PARAMETER_MISMATCH
+ *                the description is too long
+ *             ERROR_DESCRIPTION_NOT_SET_BY_MANUFACTURER
+ *                no description has been passed although the description has not been set by the manufacturer
+ *             ERROR_DESCRIPTION_SET_BY_MANUFACTURER
+ *                a description has been passed although the description has been set by the manufacturer
+ *             ERROR_STORING_INIT_DATA_FAILED
+ *                storing of the data for the description of the SE API failed
+ */
+short int seDescriptionInitialize(struct SeDescription *description,
+                                  const char *directory,
+                                  const unsigned char *value,
+                                  size_t length);
+
+#endif
@@ -0,0 +1,276 @@
+#include <errno.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+
+#include "SegmentRetirer.h"
+
+/**
+ * I/O priority class "idle" of ioprio_set, which is not exported by the C library
+ */
+#define SEGMENT_RETIRER_IOPRIO_WHO_PROCESS 1
+#define SEGMENT_RETIRER_IOPRIO_CLASS_IDLE 3
+#define SEGMENT_RETIRER_IOPRIO_CLASS_SHIFT 13
+
+#if PROFILE_CONCURRENT
+static void segmentRetirerLowerPriority(void)
+{
+#ifdef SCHED_IDLE
+    struct sched_param parameter;
+
+    memset(&parameter, 0, sizeof parameter);
+    pthread_setschedparam(pthread_self(), SCHED_IDLE, &parameter);
+#endif
+#ifdef SYS_ioprio_set
+    /* the priorities are a hint, the retirement also works if they cannot be changed */
+    syscall(SYS_ioprio_set, SEGMENT_RETIRER_IOPRIO_WHO_PROCESS, 0,
+            SEGMENT_RETIRER_IOPRIO_CLASS_IDLE << SEGMENT_RETIRER_IOPRIO_CLASS_SHIFT);
+#endif
+}
+
+/**
+ * Implementation of SegmentCopyThrottle. The thread waits until the written bytes fit into the rate limit,
+ * a stop request or the removal of the store ends the wait and aborts the rewriting.
+ */
+static bool segmentRetirerThrottle(void *throttleContext,
+                                   uint64_t bytesWritten)
+{
+    struct SegmentRetirer *retirer = (struct SegmentRetirer *) throttleContext;
+    struct timespec deadline;
+    uint64_t nanoseconds;
+    bool proceed;
+
+    pthread_mutex_lock(&retirer->lock);
+    retirer->throttledBytes += bytesWritten;
+    nanoseconds = retirer->throttledBytes / retirer->bytesPerSecond * 1000000000ull
+                  + retirer->throttledBytes % retirer->bytesPerSecond * 1000000000ull / retirer->bytesPerSecond;
+    deadline = retirer->throttleStart;
+    deadline.tv_sec += (time_t) (nanoseconds / 1000000000ull);
+    deadline.tv_nsec += (long) (nanoseconds % 1000000000ull);
+    if (deadline.tv_nsec >= 1000000000l) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000l;
+    }
+    while (!retirer->stopping && !retirer->abortRunning
+           && pthread_cond_timedwait(&retirer->changed, &retirer->lock, &deadline) != ETIMEDOUT) {
+    }
+    proceed = !retirer->stopping && !retirer->abortRunning;
+    pthread_mutex_unlock(&retirer->lock);
+    return proceed;
+}
+
+static void *segmentRetirerRun(void *argument)
+{
+    struct SegmentRetirer *retirer = (struct SegmentRetirer *) argument;
+
+    segmentRetirerLowerPriority();
+    pthread_mutex_lock(&retirer->lock);
+    for (;;) {
+        struct LogStore *store;
+        short int result;
+
+        while (retirer->pendingCount == 0 && !retirer->stopping) {
+            pthread_cond_wait(&retirer->changed, &retirer->lock);
+        }
+        if (retirer->stopping) {
+            break;
+        }
+        store = retirer->pending[0];
+        retirer->pendingCount--;
+        memmove(retirer->pending, retirer->pending + 1, retirer->pendingCount * sizeof *retirer->pending);
+        retirer->running = store;
+        retirer->abortRunning = false;
+        retirer->throttledBytes = 0;
+        clock_gettime(CLOCK_MONOTONIC, &retirer->throttleStart);
+        pthread_mutex_unlock(&retirer->lock);
+
+        result = logStoreRetireSegments(store, segmentRetirerThrottle, retirer);
+
+        pthread_mutex_lock(&retirer->lock);
+        retirer->running = NULL;
+        retirer->result = result;
+        pthread_cond_broadcast(&retirer->changed);
+    }
+    pthread_mutex_unlock(&retirer->lock);
+    return NULL;
+}
+
+/**
+ * Queues the retirement of a store unless it is already queued. The lock of the retirer MUST be held.
+ */
+static short int segmentRetirerQueue(struct SegmentRetirer *retirer,
+                                     struct LogStore *store)
+{
+    size_t i;
+
+    for (i = 0; i < retirer->pendingCount; i++) {
+        if (retirer->pending[i] == store) {
+            return EXECUTION_OK;
+        }
+    }
+    if (retirer->pendingCount == retirer->pendingCapacity) {
+        size_t capacity = retirer->pendingCapacity != 0 ? 2 * retirer->pendingCapacity : 4;
+        struct LogStore **pending = realloc(retirer->pending, capacity * sizeof *pending);
+
+        if (pending == NULL) {
+            return ERROR_STORAGE_FAILURE;
+        }
+        retirer->pending = pending;
+        retirer->pendingCapacity = capacity;
+    }
+    retirer->pending[retirer->pendingCount++] = store;
+    pthread_cond_broadcast(&retirer->changed);
+    return EXECUTION_OK;
+}
+
+short int segmentRetirerStart(struct SegmentRetirer *retirer,
+                              struct LogStore *store,
+                              uint64_t bytesPerSecond)
+{
+    pthread_condattr_t attributes;
+
+    if (retirer == NULL) {
+        return ERROR_PARAMETER_MISMATCH;
+    }
+    memset(retirer, 0, sizeof *retirer);
+    retirer->bytesPerSecond = bytesPerSecond != 0 ? bytesPerSecond : SEGMENT_RETIRER_DEFAULT_BYTES_PER_SECOND;
+    retirer->result = EXECUTION_OK;
+    pthread_mutex_init(&retirer->lock, NULL);
+    /* the deadlines of the throttle are not affected by changes of the system time */
+    pthread_condattr_init(&attributes);
+    pthread_condattr_setclock(&attributes, CLOCK_MONOTONIC);
+    pthread_cond_init(&retirer->changed, &attributes);
+    pthread_condattr_destroy(&attributes);
+    if ((store != NULL && segmentRetirerQueue(retirer, store) != EXECUTION_OK)
+        || pthread_create(&retirer->thread, NULL, segmentRetirerRun, retirer) != 0) {
+        pthread_cond_destroy(&retirer->changed);
+        pthread_mutex_destroy(&retirer->lock);
+        free(retirer->pending);
+        return ERROR_STORAGE_FAILURE;
+    }
+    return EXECUTION_OK;
+}
+
+short int segmentRetirerAdd(struct SegmentRetirer *retirer,
+                            struct LogStore *store)
+{
+    short int result;
+
+    pthread_mutex_lock(&retirer->lock);
+    result = segmentRetirerQueue(retirer, store);
+    pthread_mutex_unlock(&retirer->lock);
+    return result;
+}
+
+short int segmentRetirerDeleteStoredData(struct SegmentRetirer *retirer,
+                                         struct LogStore *store)
+{
+    short int result = logStoreMarkDeletable(store);
+
+    if (result == EXECUTION_OK && segmentRetirerAdd(retirer, store) != EXECUTION_OK) {
+        result = ERROR_DELETE_STORED_DATA_FAILED;
+    }
+    return result;
+}
+
+void segmentRetirerRemove(struct SegmentRetirer *retirer,
+                          struct LogStore *store)
+{
+    size_t i;
+
+    pthread_mutex_lock(&retirer->lock);
+    for (i = 0; i < retirer->pendingCount; i++) {
+        if (retirer->pending[i] == store) {
+            retirer->pendingCount--;
+            memmove(retirer->pending + i, retirer->pending + i + 1,
+                    (retirer->pendingCount - i) * sizeof *retirer->pending);
+            break;
+        }
+    }
+    if (retirer->running == store) {
+        retirer->abortRunning = true;
+        pthread_cond_broadcast(&retirer->changed);
+    }
+    while (retirer->running == store) {
+        pthread_cond_wait(&retirer->changed, &retirer->lock);
+    }
+    pthread_mutex_unlock(&retirer->lock);
+}
+
+short int segmentRetirerWait(struct SegmentRetirer *retirer)
+{
+    short int result;
+
+    pthread_mutex_lock(&retirer->lock);
+    while ((retirer->pendingCount > 0 || retirer->running != NULL) && !retirer->stopping) {
+        pthread_cond_wait(&retirer->changed, &retirer->lock);
+    }
+    result = retirer->result;
+    pthread_mutex_unlock(&retirer->lock);
+    return result;
+}
+
+void segmentRetirerStop(struct SegmentRetirer *retirer)
+{
+    pthread_mutex_lock(&retirer->lock);
+    retirer->stopping = true;
+    pthread_cond_broadcast(&retirer->changed);
+    pthread_mutex_unlock(&retirer->lock);
+    pthread_join(retirer->thread, NULL);
+    pthread_cond_destroy(&retirer->changed);
+    pthread_mutex_destroy(&retirer->lock);
+    free(retirer->pending);
+}
+#else
+short int segmentRetirerStart(struct SegmentRetirer *retirer,
+                              struct LogStore *store,
+                              uint64_t bytesPerSecond)
+{
+    if (retirer == NULL) {
+        return ERROR_PARAMETER_MISMATCH;
+    }
+    memset(retirer, 0, sizeof *retirer);
+    retirer->bytesPerSecond = bytesPerSecond != 0 ? bytesPerSecond : SEGMENT_RETIRER_DEFAULT_BYTES_PER_SECOND;
+    retirer->result = EXECUTION_OK;
+    return store != NULL ? segmentRetirerAdd(retirer, store) : EXECUTION_OK;
+}
+
+short int segmentRetirerAdd(struct SegmentRetirer *retirer,
+                            struct LogStore *store)
+{
+    /* no append runs concurrently, so the segments are rewritten without a rate limit */
+    retirer->result = logStoreRetireSegments(store, NULL, NULL);
+    return retirer->result;
+}
+
+short int segmentRetirerDeleteStoredData(struct SegmentRetirer *retirer,
+                                         struct LogStore *store)
+{
+    short int result = logStoreMarkDeletable(store);
+
+    if (result == EXECUTION_OK) {
+        result = segmentRetirerAdd(retirer, store);
+    }
+    return result;
+}
+
+void segmentRetirerRemove(struct SegmentRetirer *retirer,
+                          struct LogStore *store)
+{
+    (void) retirer;
+    (void) store;
+}
+
+short int segmentRetirerWait(struct SegmentRetirer *retirer)
+{
+    return retirer->result;
+}
+
+void segmentRetirerStop(struct SegmentRetirer *retirer)
+{
+    (void) retirer;
+}
+#endif
@@ -0,0 +1,124 @@
+#ifndef SEAPI_BACKEND_SEGMENT_RETIRER_H
+#define SEAPI_BACKEND_SEGMENT_RETIRER_H
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "../Exception.h"
+#include "../Constant.h"
+#include "LogStore.h"
+
+/**
+ * This header file defines the background deletion of stored data for deleteStoredData.
+ *
+ * deleteStoredData only marks the exported log messages as deletable and returns. A thread with the lowest
+ * scheduling and I/O priority retires the segments with logStoreRetireSegments and limits the rate at which
+ * partially exported segments are rewritten, so that the latency of startTransaction and the other functions
+ * that append to the store is not affected by a deletion.
+ *
+ * A retirer can serve several stores, e.g. the stores of the tenants of a tenant host (see TenantHost.h). The
+ * stores whose retirement has been requested are queued and retired one after another in the order of their
+ * requests, so that a store whose retirement is requested repeatedly does not delay the other stores.
+ *
+ * In the embedded build profile (see Profile.h) no thread is started: the retirement is executed by
+ * segmentRetirerStart, segmentRetirerAdd and segmentRetirerDeleteStoredData on the calling thread without a rate
+ * limit, and these functions return the error code of the retirement.
+ */
+
+/**
+ * Default rate limit for rewriting segments in bytes per second
+ */
+#define SEGMENT_RETIRER_DEFAULT_BYTES_PER_SECOND (8ul * 1024ul * 1024ul)
+
+/**
+ * State of a retirer. The members are managed by the functions of this header file; the members after lock MUST
+ * only be accessed while holding it.
+ */
+struct SegmentRetirer {
+    pthread_t thread;
+    uint64_t bytesPerSecond;
+    pthread_mutex_t lock;
+    pthread_cond_t changed;
+    uint64_t throttledBytes;
+    struct timespec throttleStart;
+    struct LogStore **pending;
+    size_t pendingCount;
+    size_t pendingCapacity;
+    struct LogStore *running;
+    bool abortRunning;
+    bool stopping;
+    short int result;
+};
+
+/**
+ * Starts the retirer thread. A retirement of the passed store that has been requested before a restart is resumed
+ * immediately.
+ * @param[out] retirer
+ *                retirer to be started [REQUIRED]
+ * @param[in] store
+ *                opened store, which MUST stay open until the retirer has been stopped; NULL starts a retirer to
+ *                which stores are added with segmentRetirerAdd [OPTIONAL]
+ * @param[in] bytesPerSecond
+ *                rate limit for rewriting segments, 0 selects the default [REQUIRED]
+ * @return EXECUTION_OK or ERROR_STORAGE_FAILURE if the thread could not be created
+ */
+short int segmentRetirerStart(struct SegmentRetirer *retirer,
+                              struct LogStore *store,
+                              uint64_t bytesPerSecond);
+
+/**
+ * Requests the retirement of a store, which resumes a retirement that has been requested before a restart.
+ * @param[in] retirer
+ *                started retirer [REQUIRED]
+ * @param[in] store
+ *                opened store, which MUST stay open until it has been removed with segmentRetirerRemove or the
+ *                retirer has been stopped [REQUIRED]
+ * @return EXECUTION_OK or ERROR_STORAGE_FAILURE if no memory could be allocated; in the embedded build profile the
+ *         error code of the retirement, e.g. ERROR_DELETE_STORED_DATA_FAILED
+ */
+short int segmentRetirerAdd(struct SegmentRetirer *retirer,
+                            struct LogStore *store);
+
+/**
+ * Backend implementation of deleteStoredData. The exported log messages are marked as deletable
+ * and the retirement of the store is requested, the function does not wait for the deletion.
+ * @param[in] retirer
+ *                started retirer [REQUIRED]
+ * @param[in] store
+ *                opened store [REQUIRED]
+ * @return the return values of logStoreMarkDeletable or ERROR_DELETE_STORED_DATA_FAILED if the retirement could not
+ *         be requested or, in the embedded build profile, has failed
+ */
+short int segmentRetirerDeleteStoredData(struct SegmentRetirer *retirer,
+                                         struct LogStore *store);
+
+/**
+ * Removes a store from the retirer before it is closed. A segment of the store that is being rewritten is left
+ * unchanged, its retirement is resumed when the store is added again.
+ * @param[in] retirer
+ *                started retirer [REQUIRED]
+ * @param[in] store
+ *                store to be removed [REQUIRED]
+ */
+void segmentRetirerRemove(struct SegmentRetirer *retirer,
+                          struct LogStore *store);
+
+/**
+ * Waits until the retirer has no pending work.
+ * @param[in] retirer
+ *                started retirer [REQUIRED]
+ * @return EXECUTION_OK or the error code of the last retirement, e.g. ERROR_DELETE_STORED_DATA_FAILED
+ */
+short int segmentRetirerWait(struct SegmentRetirer *retirer);
+
+/**
+ * Stops the retirer thread. A segment that is being rewritten is left unchanged, its retirement
+ * is resumed by the next start.
+ * @param[in] retirer
+ *                started retirer [REQUIRED]
+ */
+void segmentRetirerStop(struct SegmentRetirer *retirer);
+
+#endif
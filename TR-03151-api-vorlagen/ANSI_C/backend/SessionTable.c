@@ -0,0 +1,266 @@
+#include <string.h>
+
+#include "SessionTable.h"
+
+/**
+ * States of a slot. Probe sequences end at a slot that has never been used; removed sessions leave a slot that
+ * may be reused but does not end a probe sequence.
+ */
+enum SessionSlotState {
+sessionSlotUnused, sessionSlotUsed, sessionSlotRemoved
+};
+
+/**
+ * Copy of a slot taken by sessionSlotRead
+ */
+struct SessionSnapshot {
+    uint32_t state;
+    uint32_t userIdLength;
+    uint64_t hash;
+    int64_t expiry;
+    uint32_t permissions;
+    uint64_t userId[SESSION_KEY_WORDS];
+};
+
+static uint64_t sessionHash(const unsigned char *userId,
+                            unsigned int userIdLength)
+{
+    /* FNV-1a */
+    uint64_t hash = 0xcbf29ce484222325u;
+    unsigned int i;
+
+    for (i = 0; i < userIdLength; i++) {
+        hash ^= userId[i];
+        hash *= 0x100000001b3u;
+    }
+    return hash;
+}
+
+static void sessionKey(const unsigned char *userId,
+                       unsigned int userIdLength,
+                       uint64_t *key)
+{
+    memset(key, 0, SESSION_KEY_WORDS * sizeof *key);
+    memcpy(key, userId, userIdLength);
+}
+
+/**
+ * Reads a consistent copy of a slot and returns its sequence number.
+ */
+static uint64_t sessionSlotRead(struct SessionSlot *slot,
+                                struct SessionSnapshot *snapshot)
+{
+    for (;;) {
+        uint64_t sequence = atomic_load_explicit(&slot->sequence, memory_order_acquire);
+        int i;
+
+        if ((sequence & 1u) != 0) {
+            continue;
+        }
+        snapshot->state = atomic_load_explicit(&slot->state, memory_order_relaxed);
+        snapshot->userIdLength = atomic_load_explicit(&slot->userIdLength, memory_order_relaxed);
+        snapshot->hash = atomic_load_explicit(&slot->hash, memory_order_relaxed);
+        snapshot->expiry = atomic_load_explicit(&slot->expiry, memory_order_relaxed);
+        snapshot->permissions = atomic_load_explicit(&slot->permissions, memory_order_relaxed);
+        for (i = 0; i < SESSION_KEY_WORDS; i++) {
+            snapshot->userId[i] = atomic_load_explicit(&slot->userId[i], memory_order_relaxed);
+        }
+        atomic_thread_fence(memory_order_acquire);
+        if (atomic_load_explicit(&slot->sequence, memory_order_relaxed) == sequence) {
+            return sequence;
+        }
+    }
+}
+
+static bool sessionSnapshotMatches(const struct SessionSnapshot *snapshot,
+                                   uint64_t hash,
+                                   const uint64_t *key,
+                                   unsigned int userIdLength)
+{
+    return snapshot->state == sessionSlotUsed && snapshot->hash == hash && snapshot->userIdLength == userIdLength
+           && memcmp(snapshot->userId, key, SESSION_KEY_WORDS * sizeof *key) == 0;
+}
+
+/**
+ * Claims a slot for writing if its sequence number is still the one that has been read.
+ */
+static bool sessionSlotClaim(struct SessionSlot *slot,
+                             uint64_t sequence)
+{
+    if (!atomic_compare_exchange_strong_explicit(&slot->sequence, &sequence, sequence + 1,
+                                                 memory_order_acquire, memory_order_relaxed)) {
+        return false;
+    }
+    /* the data stores must not become visible before the odd sequence number */
+    atomic_thread_fence(memory_order_release);
+    return true;
+}
+
+static void sessionSlotRelease(struct SessionSlot *slot)
+{
+    atomic_fetch_add_explicit(&slot->sequence, 1, memory_order_release);
+}
+
+static void sessionSlotWrite(struct SessionSlot *slot,
+                             uint64_t hash,
+                             const uint64_t *key,
+                             unsigned int userIdLength,
+                             uint32_t permissions,
+                             int64_t expiry)
+{
+    int i;
+
+    atomic_store_explicit(&slot->userIdLength, userIdLength, memory_order_relaxed);
+    atomic_store_explicit(&slot->hash, hash, memory_order_relaxed);
+    atomic_store_explicit(&slot->expiry, expiry, memory_order_relaxed);
+    atomic_store_explicit(&slot->permissions, permissions, memory_order_relaxed);
+    for (i = 0; i < SESSION_KEY_WORDS; i++) {
+        atomic_store_explicit(&slot->userId[i], key[i], memory_order_relaxed);
+    }
+    atomic_store_explicit(&slot->state, sessionSlotUsed, memory_order_relaxed);
+}
+
+void sessionTableInit(struct SessionTable *table)
+{
+    size_t i;
+    int j;
+
+    for (i = 0; i < SESSION_TABLE_CAPACITY; i++) {
+        struct SessionSlot *slot = &table->slots[i];
+        atomic_init(&slot->sequence, 0);
+        atomic_init(&slot->state, sessionSlotUnused);
+        atomic_init(&slot->userIdLength, 0);
+        atomic_init(&slot->hash, 0);
+        atomic_init(&slot->expiry, 0);
+        atomic_init(&slot->permissions, 0);
+        for (j = 0; j < SESSION_KEY_WORDS; j++) {
+            atomic_init(&slot->userId[j], 0);
+        }
+    }
+}
+
+short int sessionTableInsert(struct SessionTable *table,
+                             const unsigned char *userId,
+                             unsigned int userIdLength,
+                             uint32_t permissions,
+                             int64_t expiry,
+                             int64_t now)
+{
+    uint64_t key[SESSION_KEY_WORDS];
+    uint64_t hash;
+
+    if (userIdLength > USER_ID_MAX_LENGTH) {
+        return ERROR_PARAMETER_MISMATCH;
+    }
+    hash = sessionHash(userId, userIdLength);
+    sessionKey(userId, userIdLength, key);
+
+    for (;;) {
+        struct SessionSlot *target = NULL;
+        uint64_t targetSequence = 0;
+        size_t probe;
+
+        /* an existing session of the user is extended in place, otherwise the first reusable slot is taken */
+        for (probe = 0; probe < SESSION_TABLE_CAPACITY; probe++) {
+            struct SessionSlot *slot = &table->slots[(hash + probe) & (SESSION_TABLE_CAPACITY - 1)];
+            struct SessionSnapshot snapshot;
+            uint64_t sequence = sessionSlotRead(slot, &snapshot);
+
+            if (sessionSnapshotMatches(&snapshot, hash, key, userIdLength)) {
+                target = slot;
+                targetSequence = sequence;
+                break;
+            }
+            if (target == NULL && (snapshot.state != sessionSlotUsed || snapshot.expiry <= now)) {
+                target = slot;
+                targetSequence = sequence;
+            }
+            if (snapshot.state == sessionSlotUnused) {
+                break;
+            }
+        }
+        if (target == NULL) {
+            return ERROR_STORAGE_FAILURE;
+        }
+        if (sessionSlotClaim(target, targetSequence)) {
+            sessionSlotWrite(target, hash, key, userIdLength, permissions, expiry);
+            sessionSlotRelease(target);
+            return EXECUTION_OK;
+        }
+        /* another writer changed the slot, the probe sequence is repeated */
+    }
+}
+
+bool sessionTableRemove(struct SessionTable *table,
+                        const unsigned char *userId,
+                        unsigned int userIdLength,
+                        int64_t now)
+{
+    uint64_t key[SESSION_KEY_WORDS];
+    uint64_t hash;
+    bool removed = false;
+    size_t probe;
+
+    if (userIdLength > USER_ID_MAX_LENGTH) {
+        return false;
+    }
+    hash = sessionHash(userId, userIdLength);
+    sessionKey(userId, userIdLength, key);
+
+    /* concurrent authentications may have left more than one slot of the user, all of them are removed */
+    for (probe = 0; probe < SESSION_TABLE_CAPACITY; probe++) {
+        struct SessionSlot *slot = &table->slots[(hash + probe) & (SESSION_TABLE_CAPACITY - 1)];
+        struct SessionSnapshot snapshot;
+        uint64_t sequence = sessionSlotRead(slot, &snapshot);
+
+        if (snapshot.state == sessionSlotUnused) {
+            break;
+        }
+        if (!sessionSnapshotMatches(&snapshot, hash, key, userIdLength)) {
+            continue;
+        }
+        if (!sessionSlotClaim(slot, sequence)) {
+            /* the slot has changed, it is read again */
+            probe--;
+            continue;
+        }
+        atomic_store_explicit(&slot->state, sessionSlotRemoved, memory_order_relaxed);
+        sessionSlotRelease(slot);
+        if (snapshot.expiry > now) {
+            removed = true;
+        }
+    }
+    return removed;
+}
+
+short int sessionTableCheck(struct SessionTable *table,
+                            const unsigned char *userId,
+                            unsigned int userIdLength,
+                            uint32_t requiredPermissions,
+                            int64_t now)
+{
+    uint64_t key[SESSION_KEY_WORDS];
+    uint64_t hash;
+    size_t probe;
+
+    if (userIdLength > USER_ID_MAX_LENGTH) {
+        return ERROR_USER_NOT_AUTHENTICATED;
+    }
+    hash = sessionHash(userId, userIdLength);
+    sessionKey(userId, userIdLength, key);
+
+    for (probe = 0; probe < SESSION_TABLE_CAPACITY; probe++) {
+        struct SessionSlot *slot = &table->slots[(hash + probe) & (SESSION_TABLE_CAPACITY - 1)];
+        struct SessionSnapshot snapshot;
+
+        sessionSlotRead(slot, &snapshot);
+        if (snapshot.state == sessionSlotUnused) {
+            break;
+        }
+        if (sessionSnapshotMatches(&snapshot, hash, key, userIdLength) && snapshot.expiry > now) {
+            return (snapshot.permissions & requiredPermissions) == requiredPermissions
+                   ? EXECUTION_OK : ERROR_USER_NOT_AUTHORIZED;
+        }
+    }
+    return ERROR_USER_NOT_AUTHENTICATED;
+}
@@ -0,0 +1,132 @@
+#ifndef SEAPI_BACKEND_SESSION_TABLE_H
+#define SEAPI_BACKEND_SESSION_TABLE_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "../Exception.h"
+#include "../Constant.h"
+#include "UserCredentials.h"
+
+/**
+ * This header file defines the table of the authenticated users of the SE API backend.
+ *
+ * The table is an open-addressing hash table of fixed size whose slots are protected by sequence locks. Restricted
+ * functions check the authentication of the calling user with a single probe sequence that neither takes a lock
+ * nor writes to shared memory, so that concurrent checks do not contend. Writers, i.e. authenticateUser and
+ * logOut, claim a slot by advancing its sequence number to an odd value; readers retry if the sequence number
+ * changed while they read the slot. Every session expires at a time passed on authentication.
+ */
+
+/**
+ * Number of slots of the table, a power of two
+ */
+#define SESSION_TABLE_CAPACITY 128
+
+#define SESSION_KEY_WORDS (USER_ID_MAX_LENGTH / 8)
+
+/**
+ * Slot of the table. All members are only accessed atomically; the data members are valid if the sequence
+ * number is even and has not changed while they have been read.
+ */
+struct SessionSlot {
+    _Atomic uint64_t sequence;
+    _Atomic uint32_t state;
+    _Atomic uint32_t userIdLength;
+    _Atomic uint64_t hash;
+    _Atomic int64_t expiry;
+    _Atomic uint32_t permissions;
+    _Atomic uint64_t userId[SESSION_KEY_WORDS];
+};
+
+/**
+ * Table of authenticated users. The members are managed by the functions of this header file.
+ */
+struct SessionTable {
+    struct SessionSlot slots[SESSION_TABLE_CAPACITY];
+};
+
+/**
+ * Initializes an empty table.
+ * @param[out] table
+ *                table to be initialized [REQUIRED]
+ */
+void sessionTableInit(struct SessionTable *table);
+
+/**
+ * Adds the session of a user or extends an existing session. Expired sessions are replaced.
+ * @param[in] table
+ *                initialized table [REQUIRED]
+ * @param[in] userId
+ *                the ID of the user or application [REQUIRED]
+ * @param[in] userIdLength
+ *                the length of the array that represents the userId, at most USER_ID_MAX_LENGTH [REQUIRED]
+ * @param[in] permissions
+ *                bit mask of the restricted functions that the user may call [REQUIRED]
+ * @param[in] expiry
+ *                time at which the session ends [REQUIRED]
+ * @param[in] now
+ *                current time on the scale of expiry [REQUIRED]
+ * @return if the execution of the function has been successful, the return value EXECUTION_OK SHALL be returned.
+ *
+ *         If the execution of the function has failed, the appropriate error code SHALL be returned:
+ *
+ *             ERROR_PARAMETER_MISMATCH
+ *                the userId is too long
+ *             ERROR_STORAGE_FAILURE
+ *                all slots are occupied by valid sessions
+ */
+short int sessionTableInsert(struct SessionTable *table,
+                             const unsigned char *userId,
+                             unsigned int userIdLength,
+                             uint32_t permissions,
+                             int64_t expiry,
+                             int64_t now);
+
+/**
+ * Ends the session of a user.
+ * @param[in] table
+ *                initialized table [REQUIRED]
+ * @param[in] userId
+ *                the ID of the user or application [REQUIRED]
+ * @param[in] userIdLength
+ *                the length of the array that represents the userId [REQUIRED]
+ * @param[in] now
+ *                current time on the scale of the expiry [REQUIRED]
+ * @return true if a session that had not expired has been ended
+ */
+bool sessionTableRemove(struct SessionTable *table,
+                        const unsigned char *userId,
+                        unsigned int userIdLength,
+                        int64_t now);
+
+/**
+ * Checks whether a user is authenticated and may call a restricted function. The check does not block.
+ * @param[in] table
+ *                initialized table [REQUIRED]
+ * @param[in] userId
+ *                the ID of the user or application [REQUIRED]
+ * @param[in] userIdLength
+ *                the length of the array that represents the userId [REQUIRED]
+ * @param[in] requiredPermissions
+ *                bit mask of the permissions needed by the restricted function [REQUIRED]
+ * @param[in] now
+ *                current time on the scale of the expiry [REQUIRED]
+ * @return if the user is authenticated and has the permissions, the return value EXECUTION_OK SHALL be returned.
+ *
+ *         Otherwise the appropriate error code SHALL be returned:
+ *
+ *             ERROR_USER_NOT_AUTHENTICATED
+ *                the user has no session or the session has expired
+ *             ERROR_USER_NOT_AUTHORIZED
+ *                the user lacks a required permission
+ */
+short int sessionTableCheck(struct SessionTable *table,
+                            const unsigned char *userId,
+                            unsigned int userIdLength,
+                            uint32_t requiredPermissions,
+                            int64_t now);
+
+#endif
@@ -0,0 +1,248 @@
+#include <string.h>
+
+#include "Sha256.h"
+
+static const uint32_t sha256RoundConstants[64] = {
+    0x428a2f98u, 0x71374491u, 0xb5c0fbcfu, 0xe9b5dba5u, 0x3956c25bu, 0x59f111f1u, 0x923f82a4u, 0xab1c5ed5u,
+    0xd807aa98u, 0x12835b01u, 0x243185beu, 0x550c7dc3u, 0x72be5d74u, 0x80deb1feu, 0x9bdc06a7u, 0xc19bf174u,
+    0xe49b69c1u, 0xefbe4786u, 0x0fc19dc6u, 0x240ca1ccu, 0x2de92c6fu, 0x4a7484aau, 0x5cb0a9dcu, 0x76f988dau,
+    0x983e5152u, 0xa831c66du, 0xb00327c8u, 0xbf597fc7u, 0xc6e00bf3u, 0xd5a79147u, 0x06ca6351u, 0x14292967u,
+    0x27b70a85u, 0x2e1b2138u, 0x4d2c6dfcu, 0x53380d13u, 0x650a7354u, 0x766a0abbu, 0x81c2c92eu, 0x92722c85u,
+    0xa2bfe8a1u, 0xa81a664bu, 0xc24b8b70u, 0xc76c51a3u, 0xd192e819u, 0xd6990624u, 0xf40e3585u, 0x106aa070u,
+    0x19a4c116u, 0x1e376c08u, 0x2748774cu, 0x34b0bcb5u, 0x391c0cb3u, 0x4ed8aa4au, 0x5b9cca4fu, 0x682e6ff3u,
+    0x748f82eeu, 0x78a5636fu, 0x84c87814u, 0x8cc70208u, 0x90befffau, 0xa4506cebu, 0xbef9a3f7u, 0xc67178f2u
+};
+
+#define SHA256_ROTATE(value, count) (((value) >> (count)) | ((value) << (32 - (count))))
+
+static void sha256Compress(uint32_t *state,
+                           const unsigned char *block)
+{
+    uint32_t schedule[64];
+    uint32_t a, b, c, d, e, f, g, h;
+    int i;
+
+    for (i = 0; i < 16; i++) {
+        schedule[i] = (uint32_t) block[4 * i] << 24 | (uint32_t) block[4 * i + 1] << 16
+                      | (uint32_t) block[4 * i + 2] << 8 | (uint32_t) block[4 * i + 3];
+    }
+    for (i = 16; i < 64; i++) {
+        uint32_t s0 = SHA256_ROTATE(schedule[i - 15], 7) ^ SHA256_ROTATE(schedule[i - 15], 18)
+                      ^ (schedule[i - 15] >> 3);
+        uint32_t s1 = SHA256_ROTATE(schedule[i - 2], 17) ^ SHA256_ROTATE(schedule[i - 2], 19)
+                      ^ (schedule[i - 2] >> 10);
+        schedule[i] = schedule[i - 16] + s0 + schedule[i - 7] + s1;
+    }
+
+    a = state[0];
+    b = state[1];
+    c = state[2];
+    d = state[3];
+    e = state[4];
+    f = state[5];
+    g = state[6];
+    h = state[7];
+    for (i = 0; i < 64; i++) {
+        uint32_t t1 = h + (SHA256_ROTATE(e, 6) ^ SHA256_ROTATE(e, 11) ^ SHA256_ROTATE(e, 25))
+                      + ((e & f) ^ (~e & g)) + sha256RoundConstants[i] + schedule[i];
+        uint32_t t2 = (SHA256_ROTATE(a, 2) ^ SHA256_ROTATE(a, 13) ^ SHA256_ROTATE(a, 22))
+                      + ((a & b) ^ (a & c) ^ (b & c));
+        h = g;
+        g = f;
+        f = e;
+        e = d + t1;
+        d = c;
+        c = b;
+        b = a;
+        a = t1 + t2;
+    }
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+    state[5] += f;
+    state[6] += g;
+    state[7] += h;
+}
+
+void sha256Init(struct Sha256Context *context)
+{
+    static const uint32_t initial[8] = {
+        0x6a09e667u, 0xbb67ae85u, 0x3c6ef372u, 0xa54ff53au, 0x510e527fu, 0x9b05688cu, 0x1f83d9abu, 0x5be0cd19u
+    };
+
+    memcpy(context->state, initial, sizeof initial);
+    context->length = 0;
+    context->blockFill = 0;
+}
+
+void sha256Update(struct Sha256Context *context,
+                  const void *data,
+                  size_t dataLength)
+{
+    const unsigned char *bytes = (const unsigned char *) data;
+
+    context->length += dataLength;
+    if (context->blockFill > 0) {
+        size_t chunk = SHA256_BLOCK_LENGTH - context->blockFill;
+        if (chunk > dataLength) {
+            chunk = dataLength;
+        }
+        memcpy(context->block + context->blockFill, bytes, chunk);
+        context->blockFill += chunk;
+        bytes += chunk;
+        dataLength -= chunk;
+        if (context->blockFill < SHA256_BLOCK_LENGTH) {
+            return;
+        }
+        sha256Compress(context->state, context->block);
+        context->blockFill = 0;
+    }
+    /* whole blocks are compressed directly from the input */
+    while (dataLength >= SHA256_BLOCK_LENGTH) {
+        sha256Compress(context->state, bytes);
+        bytes += SHA256_BLOCK_LENGTH;
+        dataLength -= SHA256_BLOCK_LENGTH;
+    }
+    memcpy(context->block, bytes, dataLength);
+    context->blockFill = dataLength;
+}
+
+void sha256Final(struct Sha256Context *context,
+                 unsigned char *digest)
+{
+    uint64_t bitLength = context->length * 8;
+    int i;
+
+    context->block[context->blockFill++] = 0x80;
+    if (context->blockFill > SHA256_BLOCK_LENGTH - 8) {
+        memset(context->block + context->blockFill, 0, SHA256_BLOCK_LENGTH - context->blockFill);
+        sha256Compress(context->state, context->block);
+        context->blockFill = 0;
+    }
+    memset(context->block + context->blockFill, 0, SHA256_BLOCK_LENGTH - 8 - context->blockFill);
+    for (i = 0; i < 8; i++) {
+        context->block[SHA256_BLOCK_LENGTH - 1 - i] = (unsigned char) (bitLength >> (8 * i));
+    }
+    sha256Compress(context->state, context->block);
+    for (i = 0; i < 8; i++) {
+        digest[4 * i] = (unsigned char) (context->state[i] >> 24);
+        digest[4 * i + 1] = (unsigned char) (context->state[i] >> 16);
+        digest[4 * i + 2] = (unsigned char) (context->state[i] >> 8);
+        digest[4 * i + 3] = (unsigned char) context->state[i];
+    }
+}
+
+void sha256Digest(const void *data,
+                  size_t dataLength,
+                  unsigned char *digest)
+{
+    struct Sha256Context context;
+
+    sha256Init(&context);
+    sha256Update(&context, data, dataLength);
+    sha256Final(&context, digest);
+}
+
+/**
+ * Prepares the inner and the outer context of an HMAC, so that they can be reused for several messages.
+ */
+static void hmacSha256Prepare(const unsigned char *key,
+                              size_t keyLength,
+                              struct Sha256Context *inner,
+                              struct Sha256Context *outer)
+{
+    unsigned char block[SHA256_BLOCK_LENGTH];
+    unsigned char hashedKey[SHA256_DIGEST_LENGTH];
+    size_t i;
+
+    if (keyLength > SHA256_BLOCK_LENGTH) {
+        sha256Digest(key, keyLength, hashedKey);
+        key = hashedKey;
+        keyLength = SHA256_DIGEST_LENGTH;
+    }
+    memset(block, 0, sizeof block);
+    memcpy(block, key, keyLength);
+    for (i = 0; i < SHA256_BLOCK_LENGTH; i++) {
+        block[i] ^= 0x36;
+    }
+    sha256Init(inner);
+    sha256Update(inner, block, sizeof block);
+    for (i = 0; i < SHA256_BLOCK_LENGTH; i++) {
+        block[i] ^= 0x36 ^ 0x5c;
+    }
+    sha256Init(outer);
+    sha256Update(outer, block, sizeof block);
+}
+
+static void hmacSha256Finish(struct Sha256Context *inner,
+                             struct Sha256Context *outer,
+                             unsigned char *mac)
+{
+    unsigned char innerDigest[SHA256_DIGEST_LENGTH];
+
+    sha256Final(inner, innerDigest);
+    sha256Update(outer, innerDigest, sizeof innerDigest);
+    sha256Final(outer, mac);
+}
+
+void hmacSha256(const unsigned char *key,
+                size_t keyLength,
+                const unsigned char *data,
+                size_t dataLength,
+                unsigned char *mac)
+{
+    struct Sha256Context inner;
+    struct Sha256Context outer;
+
+    hmacSha256Prepare(key, keyLength, &inner, &outer);
+    sha256Update(&inner, data, dataLength);
+    hmacSha256Finish(&inner, &outer, mac);
+}
+
+void pbkdf2HmacSha256(const unsigned char *password,
+                      size_t passwordLength,
+                      const unsigned char *salt,
+                      size_t saltLength,
+                      uint32_t iterations,
+                      unsigned char *output,
+                      size_t outputLength)
+{
+    struct Sha256Context keyedInner;
+    struct Sha256Context keyedOuter;
+    uint32_t blockIndex;
+
+    hmacSha256Prepare(password, passwordLength, &keyedInner, &keyedOuter);
+    for (blockIndex = 1; outputLength > 0; blockIndex++) {
+        struct Sha256Context inner = keyedInner;
+        struct Sha256Context outer = keyedOuter;
+        unsigned char counter[4];
+        unsigned char u[SHA256_DIGEST_LENGTH];
+        unsigned char t[SHA256_DIGEST_LENGTH];
+        size_t chunk = outputLength < SHA256_DIGEST_LENGTH ? outputLength : SHA256_DIGEST_LENGTH;
+        uint32_t iteration;
+        size_t i;
+
+        counter[0] = (unsigned char) (blockIndex >> 24);
+        counter[1] = (unsigned char) (blockIndex >> 16);
+        counter[2] = (unsigned char) (blockIndex >> 8);
+        counter[3] = (unsigned char) blockIndex;
+        sha256Update(&inner, salt, saltLength);
+        sha256Update(&inner, counter, sizeof counter);
+        hmacSha256Finish(&inner, &outer, u);
+        memcpy(t, u, sizeof t);
+        for (iteration = 1; iteration < iterations; iteration++) {
+            inner = keyedInner;
+            outer = keyedOuter;
+            sha256Update(&inner, u, sizeof u);
+            hmacSha256Finish(&inner, &outer, u);
+            for (i = 0; i < sizeof t; i++) {
+                t[i] ^= u[i];
+            }
+        }
+        memcpy(output, t, chunk);
+        output += chunk;
+        outputLength -= chunk;
+    }
+}
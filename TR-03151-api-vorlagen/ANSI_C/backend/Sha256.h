@@ -0,0 +1,119 @@
+#ifndef SEAPI_BACKEND_SHA256_H
+#define SEAPI_BACKEND_SHA256_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * This header file defines the hash function SHA-256 (FIPS 180-4) and the constructions based on it that are used
+ * by the SE API backend: HMAC-SHA-256 (RFC 2104) and PBKDF2-HMAC-SHA-256 (RFC 8018).
+ */
+
+/**
+ * Length of a SHA-256 digest in bytes
+ */
+#define SHA256_DIGEST_LENGTH 32
+
+/**
+ * Length of a SHA-256 input block in bytes
+ */
+#define SHA256_BLOCK_LENGTH 64
+
+/**
+ * State of an incremental SHA-256 calculation. The members are managed by the functions of this header file.
+ */
+struct Sha256Context {
+    uint32_t state[8];
+    uint64_t length;
+    unsigned char block[SHA256_BLOCK_LENGTH];
+    size_t blockFill;
+};
+
+/**
+ * Starts a calculation.
+ * @param[out] context
+ *                context to be initialized [REQUIRED]
+ */
+void sha256Init(struct Sha256Context *context);
+
+/**
+ * Adds data to a calculation.
+ * @param[in] context
+ *                initialized context [REQUIRED]
+ * @param[in] data
+ *                data to be hashed [REQUIRED]
+ * @param[in] dataLength
+ *                length of the array that represents the data [REQUIRED]
+ */
+void sha256Update(struct Sha256Context *context,
+                  const void *data,
+                  size_t dataLength);
+
+/**
+ * Finishes a calculation.
+ * @param[in] context
+ *                initialized context, which has to be initialized again before further use [REQUIRED]
+ * @param[out] digest
+ *                array of SHA256_DIGEST_LENGTH bytes that receives the digest [REQUIRED]
+ */
+void sha256Final(struct Sha256Context *context,
+                 unsigned char *digest);
+
+/**
+ * Calculates the digest of data in one call.
+ * @param[in] data
+ *                data to be hashed [REQUIRED]
+ * @param[in] dataLength
+ *                length of the array that represents the data [REQUIRED]
+ * @param[out] digest
+ *                array of SHA256_DIGEST_LENGTH bytes that receives the digest [REQUIRED]
+ */
+void sha256Digest(const void *data,
+                  size_t dataLength,
+                  unsigned char *digest);
+
+/**
+ * Calculates HMAC-SHA-256.
+ * @param[in] key
+ *                key of the MAC [REQUIRED]
+ * @param[in] keyLength
+ *                length of the array that represents the key [REQUIRED]
+ * @param[in] data
+ *                authenticated data [REQUIRED]
+ * @param[in] dataLength
+ *                length of the array that represents the data [REQUIRED]
+ * @param[out] mac
+ *                array of SHA256_DIGEST_LENGTH bytes that receives the MAC [REQUIRED]
+ */
+void hmacSha256(const unsigned char *key,
+                size_t keyLength,
+                const unsigned char *data,
+                size_t dataLength,
+                unsigned char *mac);
+
+/**
+ * Derives key material with PBKDF2-HMAC-SHA-256.
+ * @param[in] password
+ *                password [REQUIRED]
+ * @param[in] passwordLength
+ *                length of the array that represents the password [REQUIRED]
+ * @param[in] salt
+ *                salt [REQUIRED]
+ * @param[in] saltLength
+ *                length of the array that represents the salt [REQUIRED]
+ * @param[in] iterations
+ *                number of iterations, at least 1 [REQUIRED]
+ * @param[out] output
+ *                derived key material [REQUIRED]
+ * @param[in] outputLength
+ *                length of the derived key material [REQUIRED]
+ */
+void pbkdf2HmacSha256(const unsigned char *password,
+                      size_t passwordLength,
+                      const unsigned char *salt,
+                      size_t saltLength,
+                      uint32_t iterations,
+                      unsigned char *output,
+                      size_t outputLength);
+
+#endif
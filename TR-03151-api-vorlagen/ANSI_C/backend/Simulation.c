@@ -0,0 +1,466 @@
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Simulation.h"
+
+#define SIMULATION_CLIENT_ID_SIZE 24
+
+/**
+ * State of a virtual client. The pending request is repeated until it has been answered by EXECUTION_OK.
+ */
+struct SimulatedClient {
+    enum SimulatedOperation pending;
+    uint64_t transactionNumber;
+    unsigned int remainingUpdates;
+    bool needsTime;
+    char clientId[SIMULATION_CLIENT_ID_SIZE];
+    unsigned long int clientIdLength;
+};
+
+/**
+ * Next request of a client. The heap is ordered by the time and the client, so that the order of requests with
+ * the same time does not depend on the implementation of the heap.
+ */
+struct SimulationEvent {
+    int64_t time;
+    uint32_t client;
+};
+
+struct SimulationState {
+    struct SimulationConfig config;
+    const struct SimulationTarget *target;
+    FILE *trace;
+    struct SimulationReport *report;
+    uint64_t random[4];
+    struct SimulatedClient *clients;
+    struct SimulationEvent *events;
+    size_t eventCount;
+    int64_t *latencies;
+    struct SimulatedRecord *expected;
+    size_t expectedCount;
+    size_t expectedCapacity;
+    int64_t secureElementFreeAt;
+    int64_t disabledUntil;
+    bool resetPending;
+    bool timeSet;
+    int64_t clockOffset;
+};
+
+/**
+ * Position of the verification within the expected log messages
+ */
+struct SimulationVerification {
+    const struct SimulationState *state;
+    size_t next;
+    uint64_t stored;
+    uint64_t unexpected;
+};
+
+static const char *const simulatedOperationNames[SIMULATED_OPERATION_COUNT] = {
+    "startTransaction", "updateTransaction", "finishTransaction", "updateTime"
+};
+
+static uint64_t simulationSplitMix(uint64_t *seed)
+{
+    uint64_t value = (*seed += 0x9e3779b97f4a7c15u);
+
+    value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9u;
+    value = (value ^ (value >> 27)) * 0x94d049bb133111ebu;
+    return value ^ (value >> 31);
+}
+
+static uint64_t simulationRotate(uint64_t value,
+                                 int count)
+{
+    return (value << count) | (value >> (64 - count));
+}
+
+/**
+ * xoshiro256** generator, seeded by SplitMix64
+ */
+static uint64_t simulationRandom(struct SimulationState *state)
+{
+    uint64_t *s = state->random;
+    uint64_t result = simulationRotate(s[1] * 5, 7) * 9;
+    uint64_t t = s[1] << 17;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = simulationRotate(s[3], 45);
+    return result;
+}
+
+static int64_t simulationUniform(struct SimulationState *state,
+                                 int64_t bound)
+{
+    return bound > 0 ? (int64_t) (simulationRandom(state) % (uint64_t) bound) : 0;
+}
+
+static bool simulationChance(struct SimulationState *state,
+                             uint32_t partsPerMillion)
+{
+    return partsPerMillion > 0 && simulationRandom(state) % 1000000u < partsPerMillion;
+}
+
+static bool simulationEventBefore(const struct SimulationEvent *left,
+                                  const struct SimulationEvent *right)
+{
+    return left->time < right->time || (left->time == right->time && left->client < right->client);
+}
+
+static void simulationPush(struct SimulationState *state,
+                           int64_t time,
+                           uint32_t client)
+{
+    size_t position = state->eventCount++;
+
+    state->events[position].time = time;
+    state->events[position].client = client;
+    while (position > 0) {
+        size_t parent = (position - 1) / 2;
+        struct SimulationEvent swap;
+        if (!simulationEventBefore(&state->events[position], &state->events[parent])) {
+            break;
+        }
+        swap = state->events[parent];
+        state->events[parent] = state->events[position];
+        state->events[position] = swap;
+        position = parent;
+    }
+}
+
+static struct SimulationEvent simulationPop(struct SimulationState *state)
+{
+    struct SimulationEvent first = state->events[0];
+    size_t position = 0;
+
+    state->events[0] = state->events[--state->eventCount];
+    for (;;) {
+        size_t smallest = position;
+        size_t child = 2 * position + 1;
+        struct SimulationEvent swap;
+
+        if (child < state->eventCount && simulationEventBefore(&state->events[child], &state->events[smallest])) {
+            smallest = child;
+        }
+        if (child + 1 < state->eventCount
+            && simulationEventBefore(&state->events[child + 1], &state->events[smallest])) {
+            smallest = child + 1;
+        }
+        if (smallest == position) {
+            break;
+        }
+        swap = state->events[smallest];
+        state->events[smallest] = state->events[position];
+        state->events[position] = swap;
+        position = smallest;
+    }
+    return first;
+}
+
+static void simulationApplyDefaults(struct SimulationConfig *config)
+{
+    int i;
+
+    if (config->clientCount == 0) {
+        config->clientCount = SIMULATION_DEFAULT_CLIENT_COUNT;
+    }
+    if (config->requestCount == 0) {
+        config->requestCount = SIMULATION_DEFAULT_REQUEST_COUNT;
+    }
+    if (config->meanThinkTime == 0) {
+        config->meanThinkTime = SIMULATION_DEFAULT_MEAN_THINK_TIME;
+    }
+    if (config->retryDelay == 0) {
+        config->retryDelay = SIMULATION_DEFAULT_RETRY_DELAY;
+    }
+    if (config->maximumUpdates == 0) {
+        config->maximumUpdates = SIMULATION_DEFAULT_MAXIMUM_UPDATES;
+    }
+    for (i = 0; i < SIMULATED_OPERATION_COUNT; i++) {
+        if (config->serviceTime[i] == 0) {
+            config->serviceTime[i] = SIMULATION_DEFAULT_SERVICE_TIME;
+        }
+    }
+    if (config->syncDuration == 0) {
+        config->syncDuration = SIMULATION_DEFAULT_SYNC_DURATION;
+    }
+}
+
+static short int simulationExpect(struct SimulationState *state,
+                                  const struct SimulatedRecord *record)
+{
+    if (state->expectedCount == state->expectedCapacity) {
+        size_t capacity = state->expectedCapacity != 0 ? 2 * state->expectedCapacity : 1024;
+        struct SimulatedRecord *grown = realloc(state->expected, capacity * sizeof *grown);
+        if (grown == NULL) {
+            return ERROR_STORAGE_FAILURE;
+        }
+        state->expected = grown;
+        state->expectedCapacity = capacity;
+    }
+    state->expected[state->expectedCount++] = *record;
+    return EXECUTION_OK;
+}
+
+/**
+ * Moves a client to its next request after a request has been answered by EXECUTION_OK.
+ * @return the think time before the next request
+ */
+static int64_t simulationAdvanceClient(struct SimulationState *state,
+                                       struct SimulatedClient *client,
+                                       enum SimulatedOperation operation,
+                                       const struct SimulatedRecord *record)
+{
+    int64_t thinkTime = 1 + simulationUniform(state, 2 * state->config.meanThinkTime);
+
+    switch (operation) {
+    case simulatedUpdateTime:
+        /* the interrupted request is repeated immediately */
+        client->needsTime = false;
+        return 0;
+    case simulatedStartTransaction:
+        client->transactionNumber = record->transactionNumber;
+        client->remainingUpdates = (unsigned int) simulationUniform(state, state->config.maximumUpdates + 1);
+        break;
+    case simulatedUpdateTransaction:
+        client->remainingUpdates--;
+        break;
+    default:
+        state->report->finishedTransactions++;
+        client->pending = simulatedStartTransaction;
+        return thinkTime;
+    }
+    client->pending = client->remainingUpdates > 0 ? simulatedUpdateTransaction : simulatedFinishTransaction;
+    return thinkTime;
+}
+
+/**
+ * Serves the next request of a client on the simulated Secure Element.
+ */
+static short int simulationServe(struct SimulationState *state,
+                                 const struct SimulationEvent *event)
+{
+    struct SimulatedClient *client = &state->clients[event->client];
+    struct SimulationReport *report = state->report;
+    enum SimulatedOperation operation = client->needsTime ? simulatedUpdateTime : client->pending;
+    int64_t start = event->time > state->secureElementFreeAt ? event->time : state->secureElementFreeAt;
+    int64_t serviceTime = SIMULATION_SE_DISABLED_SERVICE_TIME;
+    int64_t delay = state->config.retryDelay;
+    struct SimulatedRecord record;
+    short int result;
+
+    if (state->resetPending && start >= state->disabledUntil) {
+        result = state->target->reset(state->target->context);
+        if (result != EXECUTION_OK) {
+            return result;
+        }
+        state->resetPending = false;
+        state->timeSet = false;
+    }
+
+    if (start < state->disabledUntil) {
+        result = ERROR_SECURE_ELEMENT_DISABLED;
+        report->secureElementDisabled++;
+    } else if (!state->timeSet && operation != simulatedUpdateTime) {
+        result = ERROR_TIME_NOT_SET;
+        report->timeNotSet++;
+        client->needsTime = true;
+        delay = 0;
+    } else {
+        serviceTime = state->config.serviceTime[operation] + state->config.syncDuration;
+        if (simulationChance(state, state->config.faults.slowSync)) {
+            serviceTime += state->config.faults.slowSyncDuration;
+            report->slowSyncs++;
+        }
+        if (simulationChance(state, state->config.faults.storageFailure)) {
+            result = ERROR_STORAGE_FAILURE;
+            report->storageFailures++;
+        } else {
+            struct SimulatedRequest request;
+            request.operation = operation;
+            request.transactionNumber = client->transactionNumber;
+            request.logTime = state->config.startTime + start / 1000000 + state->clockOffset;
+            request.clientId = (const unsigned char *) client->clientId;
+            request.clientIdLength = client->clientIdLength;
+            result = state->target->execute(state->target->context, &request, &record);
+            if (result == EXECUTION_OK) {
+                short int stored = simulationExpect(state, &record);
+                if (stored != EXECUTION_OK) {
+                    return stored;
+                }
+                if (operation == simulatedUpdateTime) {
+                    state->timeSet = true;
+                }
+                if (simulationChance(state, state->config.faults.lostAcknowledgement)) {
+                    /* the log message has been stored, but the client repeats the request */
+                    result = ERROR_STORAGE_FAILURE;
+                    report->lostAcknowledgements++;
+                }
+            }
+        }
+
+        if (simulationChance(state, state->config.faults.clockJump)) {
+            int64_t jump = 1 + simulationUniform(state, state->config.faults.clockJumpSeconds);
+            state->clockOffset += simulationUniform(state, 2) == 0 ? jump : -jump;
+            report->clockJumps++;
+        }
+        if (simulationChance(state, state->config.faults.reset)) {
+            state->disabledUntil = start + serviceTime + state->config.faults.resetDuration;
+            state->resetPending = true;
+            report->resets++;
+        }
+    }
+
+    if (result == EXECUTION_OK) {
+        report->succeeded++;
+        delay = simulationAdvanceClient(state, client, operation, &record);
+    } else if (result == ERROR_NO_TRANSACTION && operation != simulatedStartTransaction) {
+        /* the transaction has been finished by a request whose acknowledgement was lost */
+        report->otherErrors++;
+        client->pending = simulatedStartTransaction;
+    } else if (result != ERROR_STORAGE_FAILURE && result != ERROR_SECURE_ELEMENT_DISABLED
+               && result != ERROR_TIME_NOT_SET) {
+        report->otherErrors++;
+    }
+
+    state->secureElementFreeAt = start + serviceTime;
+    state->latencies[report->requests] = state->secureElementFreeAt - event->time;
+    report->requests++;
+    if (state->trace != NULL) {
+        fprintf(state->trace, "%" PRId64 ",%" PRIu32 ",%s,%d,%" PRId64 "\n", event->time, event->client,
+                simulatedOperationNames[operation], result, state->secureElementFreeAt - event->time);
+    }
+    simulationPush(state, state->secureElementFreeAt + delay, event->client);
+    return EXECUTION_OK;
+}
+
+static void simulationVisit(void *visitorContext,
+                            const struct SimulatedRecord *record)
+{
+    struct SimulationVerification *verification = (struct SimulationVerification *) visitorContext;
+    const struct SimulationState *state = verification->state;
+
+    verification->stored++;
+    /* expected log messages with lower signature counters than the stored one are missing */
+    while (verification->next < state->expectedCount
+           && state->expected[verification->next].signatureCounter < record->signatureCounter) {
+        verification->next++;
+    }
+    if (verification->next < state->expectedCount
+        && state->expected[verification->next].signatureCounter == record->signatureCounter
+        && state->expected[verification->next].transactionNumber == record->transactionNumber
+        && state->expected[verification->next].operation == record->operation) {
+        verification->next++;
+        return;
+    }
+    verification->unexpected++;
+}
+
+static int simulationCompareLatencies(const void *left,
+                                      const void *right)
+{
+    int64_t a = *(const int64_t *) left;
+    int64_t b = *(const int64_t *) right;
+
+    return (a > b) - (a < b);
+}
+
+static short int simulationVerify(struct SimulationState *state)
+{
+    struct SimulationReport *report = state->report;
+    struct SimulationVerification verification;
+    short int result;
+
+    memset(&verification, 0, sizeof verification);
+    verification.state = state;
+    result = state->target->collect(state->target->context, simulationVisit, &verification);
+    if (result != EXECUTION_OK) {
+        return result;
+    }
+    report->storedRecords = verification.stored;
+    report->unexpectedRecords = verification.unexpected;
+    /* every expected log message that has not been matched is missing */
+    report->missingRecords = state->expectedCount - (verification.stored - verification.unexpected);
+    report->consistent = report->missingRecords == 0 && report->unexpectedRecords == 0;
+    return EXECUTION_OK;
+}
+
+static void simulationSummarize(struct SimulationState *state)
+{
+    struct SimulationReport *report = state->report;
+    uint64_t count = report->requests;
+
+    if (count == 0) {
+        return;
+    }
+    qsort(state->latencies, (size_t) count, sizeof *state->latencies, simulationCompareLatencies);
+    report->latencyPercentile50 = state->latencies[(count - 1) * 500 / 1000];
+    report->latencyPercentile99 = state->latencies[(count - 1) * 990 / 1000];
+    report->latencyPercentile999 = state->latencies[(count - 1) * 999 / 1000];
+    report->latencyMaximum = state->latencies[count - 1];
+    report->virtualDuration = state->secureElementFreeAt;
+}
+
+short int simulationRun(const struct SimulationConfig *config,
+                        const struct SimulationTarget *target,
+                        FILE *trace,
+                        struct SimulationReport *report)
+{
+    struct SimulationState state;
+    uint64_t seed;
+    short int result = EXECUTION_OK;
+    uint32_t i;
+
+    if (config == NULL || target == NULL || target->execute == NULL || target->reset == NULL
+        || target->collect == NULL || report == NULL) {
+        return ERROR_PARAMETER_MISMATCH;
+    }
+    memset(&state, 0, sizeof state);
+    memset(report, 0, sizeof *report);
+    state.config = *config;
+    simulationApplyDefaults(&state.config);
+    state.target = target;
+    state.trace = trace;
+    state.report = report;
+    seed = state.config.seed;
+    for (i = 0; i < 4; i++) {
+        state.random[i] = simulationSplitMix(&seed);
+    }
+
+    state.clients = calloc(state.config.clientCount, sizeof *state.clients);
+    state.events = malloc(state.config.clientCount * sizeof *state.events);
+    state.latencies = malloc((size_t) state.config.requestCount * sizeof *state.latencies);
+    if (state.clients == NULL || state.events == NULL || state.latencies == NULL) {
+        result = ERROR_STORAGE_FAILURE;
+    }
+
+    if (result == EXECUTION_OK) {
+        /* the time has to be set before the first transaction, as after a reset */
+        for (i = 0; i < state.config.clientCount; i++) {
+            struct SimulatedClient *client = &state.clients[i];
+            client->pending = simulatedStartTransaction;
+            client->clientIdLength = (unsigned long int) snprintf(client->clientId, sizeof client->clientId,
+                                                                  "client-%05" PRIu32, i);
+            simulationPush(&state, simulationUniform(&state, state.config.meanThinkTime), i);
+        }
+        while (result == EXECUTION_OK && report->requests < state.config.requestCount) {
+            struct SimulationEvent event = simulationPop(&state);
+            result = simulationServe(&state, &event);
+        }
+    }
+    if (result == EXECUTION_OK) {
+        simulationSummarize(&state);
+        result = simulationVerify(&state);
+    }
+
+    free(state.clients);
+    free(state.events);
+    free(state.latencies);
+    free(state.expected);
+    return result;
+}
@@ -0,0 +1,212 @@
+#ifndef SEAPI_BACKEND_SIMULATION_H
+#define SEAPI_BACKEND_SIMULATION_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "../Exception.h"
+#include "../Constant.h"
+
+/**
+ * This header file defines a deterministic simulation of SE API clients for measuring how the throughput and the
+ * latency of an implementation degrade under faults.
+ *
+ * The simulation runs in virtual time on a single thread. Virtual clients start, update and finish transactions
+ * with random think times; their requests are served in the order of arrival by the simulated Secure Element,
+ * whose service times are taken from the configuration. Storage failures, lost acknowledgements, slow
+ * synchronizations, jumps of the clock and resets of the Secure Element are injected with configured
+ * probabilities. All random decisions are drawn from a generator that is seeded by the configuration, so that a
+ * run, its latency trace and its result are reproducible from the seed.
+ *
+ * After the run the log messages stored by the implementation are compared with the log messages whose storing the
+ * implementation has confirmed, including those whose acknowledgement has been dropped by an injected fault.
+ */
+
+/**
+ * Represents the SE API functions that are invoked by the virtual clients.
+ */
+enum SimulatedOperation {
+simulatedStartTransaction, simulatedUpdateTransaction, simulatedFinishTransaction, simulatedUpdateTime
+};
+
+#define SIMULATED_OPERATION_COUNT 4
+
+/**
+ * Request passed to the implementation under test.
+ */
+struct SimulatedRequest {
+    enum SimulatedOperation operation;
+    uint64_t transactionNumber;
+    int64_t logTime;
+    const unsigned char *clientId;
+    unsigned long int clientIdLength;
+};
+
+/**
+ * Log message reported by the implementation under test, either on storing it or when the stored log messages
+ * are collected for the verification.
+ */
+struct SimulatedRecord {
+    uint64_t signatureCounter;
+    uint64_t transactionNumber;
+    enum SimulatedOperation operation;
+};
+
+/**
+ * Callback that receives the stored log messages in the order of the signature counter.
+ * @param[in] visitorContext
+ *                context of the verification [REQUIRED]
+ * @param[in] record
+ *                the stored log message [REQUIRED]
+ */
+typedef void (*SimulatedRecordVisitor)(void *visitorContext,
+                                       const struct SimulatedRecord *record);
+
+/**
+ * Callback that executes a request with the implementation under test.
+ * For simulatedStartTransaction the implementation assigns the transaction number.
+ * @param[in] targetContext
+ *                context of the target [OPTIONAL]
+ * @param[in] request
+ *                the request [REQUIRED]
+ * @param[out] record
+ *                the stored log message, only set for EXECUTION_OK [REQUIRED]
+ * @return EXECUTION_OK or the error code of the SE API function
+ */
+typedef short int (*SimulationExecute)(void *targetContext,
+                                       const struct SimulatedRequest *request,
+                                       struct SimulatedRecord *record);
+
+/**
+ * Callback that resets the Secure Element, e.g. by closing and reopening the storage. Open transactions stay open.
+ * @param[in] targetContext
+ *                context of the target [OPTIONAL]
+ * @return EXECUTION_OK or an error code that ends the simulation
+ */
+typedef short int (*SimulationReset)(void *targetContext);
+
+/**
+ * Callback that passes all stored log messages to the visitor in the order of the signature counter.
+ * @param[in] targetContext
+ *                context of the target [OPTIONAL]
+ * @param[in] visitor
+ *                visitor of the stored log messages [REQUIRED]
+ * @param[in] visitorContext
+ *                context passed to the visitor [REQUIRED]
+ * @return EXECUTION_OK or an error code that ends the verification
+ */
+typedef short int (*SimulationCollect)(void *targetContext,
+                                       SimulatedRecordVisitor visitor,
+                                       void *visitorContext);
+
+/**
+ * Implementation of the SE API under test.
+ */
+struct SimulationTarget {
+    void *context;
+    SimulationExecute execute;
+    SimulationReset reset;
+    SimulationCollect collect;
+};
+
+/**
+ * Probabilities of the injected faults per request in parts per million and the parameters of the faults.
+ * A storage failure is returned without invoking the implementation, a lost acknowledgement is returned after the
+ * implementation has stored the log message. A reset disables the Secure Element for resetDuration; afterwards
+ * the time has to be set again by updateTime.
+ */
+struct SimulationFaults {
+    uint32_t storageFailure;
+    uint32_t lostAcknowledgement;
+    uint32_t slowSync;
+    int64_t slowSyncDuration;
+    uint32_t clockJump;
+    int64_t clockJumpSeconds;
+    uint32_t reset;
+    int64_t resetDuration;
+};
+
+/**
+ * Configuration of a run. Durations are given in virtual microseconds; a zero value selects the default.
+ */
+struct SimulationConfig {
+    uint64_t seed;
+    unsigned int clientCount;
+    uint64_t requestCount;
+    int64_t startTime;
+    int64_t meanThinkTime;
+    int64_t retryDelay;
+    unsigned int maximumUpdates;
+    int64_t serviceTime[SIMULATED_OPERATION_COUNT];
+    int64_t syncDuration;
+    struct SimulationFaults faults;
+};
+
+/**
+ * Default parameters of a run
+ */
+#define SIMULATION_DEFAULT_CLIENT_COUNT 1000
+#define SIMULATION_DEFAULT_REQUEST_COUNT 100000
+#define SIMULATION_DEFAULT_MEAN_THINK_TIME 2000000
+#define SIMULATION_DEFAULT_RETRY_DELAY 50000
+#define SIMULATION_DEFAULT_MAXIMUM_UPDATES 8
+#define SIMULATION_DEFAULT_SERVICE_TIME 400
+#define SIMULATION_DEFAULT_SYNC_DURATION 250
+#define SIMULATION_SE_DISABLED_SERVICE_TIME 20
+
+/**
+ * Result of a run. Latencies are given in virtual microseconds from the arrival of a request to its completion.
+ */
+struct SimulationReport {
+    uint64_t requests;
+    uint64_t succeeded;
+    uint64_t storageFailures;
+    uint64_t lostAcknowledgements;
+    uint64_t secureElementDisabled;
+    uint64_t timeNotSet;
+    uint64_t otherErrors;
+    uint64_t resets;
+    uint64_t clockJumps;
+    uint64_t slowSyncs;
+    uint64_t finishedTransactions;
+    int64_t virtualDuration;
+    int64_t latencyPercentile50;
+    int64_t latencyPercentile99;
+    int64_t latencyPercentile999;
+    int64_t latencyMaximum;
+    uint64_t storedRecords;
+    uint64_t missingRecords;
+    uint64_t unexpectedRecords;
+    bool consistent;
+};
+
+/**
+ * Runs a simulation.
+ * @param[in] config
+ *                configuration of the run [REQUIRED]
+ * @param[in] target
+ *                implementation under test, which MUST NOT be used concurrently [REQUIRED]
+ * @param[in] trace
+ *                stream that receives one line "time,client,operation,result,latency" per request [OPTIONAL]
+ * @param[out] report
+ *                result of the run [REQUIRED]
+ * @return if the execution of the function has been successful, the return value EXECUTION_OK SHALL be returned.
+ *         The consistency of the stored log messages is reported in the member consistent of the report.
+ *
+ *         If the execution of the function has failed, the appropriate error code SHALL be returned:
+ *
+ *             ERROR_PARAMETER_MISMATCH
+ *                a required parameter is missing
+ *             ERROR_STORAGE_FAILURE
+ *                no memory could be allocated
+ *
+ *         or the error code returned by the reset or collect function of the target.
+ */
+short int simulationRun(const struct SimulationConfig *config,
+                        const struct SimulationTarget *target,
+                        FILE *trace,
+                        struct SimulationReport *report);
+
+#endif
@@ -0,0 +1,463 @@
+#include <errno.h>
+#include <linux/io_uring.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "StorageIo.h"
+
+/**
+ * Alignment of the registered buffers
+ */
+#define STORAGE_IO_BUFFER_ALIGNMENT 4096
+
+/**
+ * Operation in flight. The completion is stored by the thread that reaps it; the operation lies on the stack of the
+ * submitting thread, which waits until done is set.
+ */
+struct StorageIoOperation {
+    int result;
+    bool done;
+};
+
+static int storageIoSetup(unsigned int entries,
+                          struct io_uring_params *params)
+{
+    return (int) syscall(__NR_io_uring_setup, entries, params);
+}
+
+static int storageIoEnter(int ringFd,
+                          unsigned int submitCount,
+                          unsigned int completeCount,
+                          unsigned int flags)
+{
+    return (int) syscall(__NR_io_uring_enter, ringFd, submitCount, completeCount, flags, NULL, 0);
+}
+
+static int storageIoRegister(int ringFd,
+                             unsigned int opcode,
+                             const void *argument,
+                             unsigned int argumentCount)
+{
+    return (int) syscall(__NR_io_uring_register, ringFd, opcode, argument, argumentCount);
+}
+
+static void storageIoUnmap(struct StorageIo *io)
+{
+    if (io->entries != NULL) {
+        munmap(io->entries, io->entriesSize);
+    }
+    if (io->completionRing != NULL && io->completionRing != io->submissionRing) {
+        munmap(io->completionRing, io->completionRingSize);
+    }
+    if (io->submissionRing != NULL) {
+        munmap(io->submissionRing, io->submissionRingSize);
+    }
+    io->entries = NULL;
+    io->completionRing = NULL;
+    io->submissionRing = NULL;
+}
+
+/**
+ * Sets up the rings shared with the kernel. Kernels without the features used here (before 5.6) are treated like
+ * kernels without io_uring.
+ */
+static bool storageIoSetupRing(struct StorageIo *io)
+{
+    struct io_uring_params params;
+    unsigned char *submissionRing;
+    unsigned char *completionRing;
+
+    memset(&params, 0, sizeof params);
+    io->ringFd = storageIoSetup(STORAGE_IO_QUEUE_ENTRIES, &params);
+    if (io->ringFd < 0) {
+        return false;
+    }
+    if ((params.features & (IORING_FEAT_SINGLE_MMAP | IORING_FEAT_NODROP | IORING_FEAT_RW_CUR_POS))
+        != (IORING_FEAT_SINGLE_MMAP | IORING_FEAT_NODROP | IORING_FEAT_RW_CUR_POS)) {
+        close(io->ringFd);
+        io->ringFd = -1;
+        return false;
+    }
+
+    io->submissionRingSize = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+    io->completionRingSize = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    if (io->completionRingSize > io->submissionRingSize) {
+        io->submissionRingSize = io->completionRingSize;
+    }
+    io->completionRingSize = io->submissionRingSize;
+    io->entriesSize = params.sq_entries * sizeof(struct io_uring_sqe);
+    io->submissionRing = mmap(NULL, io->submissionRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                              io->ringFd, IORING_OFF_SQ_RING);
+    if (io->submissionRing == MAP_FAILED) {
+        io->submissionRing = NULL;
+    } else {
+        io->completionRing = io->submissionRing;
+        io->entries = mmap(NULL, io->entriesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, io->ringFd,
+                           IORING_OFF_SQES);
+        if (io->entries == MAP_FAILED) {
+            io->entries = NULL;
+        }
+    }
+    if (io->entries == NULL) {
+        storageIoUnmap(io);
+        close(io->ringFd);
+        io->ringFd = -1;
+        return false;
+    }
+
+    submissionRing = io->submissionRing;
+    completionRing = io->completionRing;
+    io->submissionHead = (_Atomic uint32_t *) (void *) (submissionRing + params.sq_off.head);
+    io->submissionTail = (_Atomic uint32_t *) (void *) (submissionRing + params.sq_off.tail);
+    io->submissionArray = (uint32_t *) (void *) (submissionRing + params.sq_off.array);
+    io->submissionMask = *(uint32_t *) (void *) (submissionRing + params.sq_off.ring_mask);
+    io->completionHead = (_Atomic uint32_t *) (void *) (completionRing + params.cq_off.head);
+    io->completionTail = (_Atomic uint32_t *) (void *) (completionRing + params.cq_off.tail);
+    io->completions = (struct io_uring_cqe *) (void *) (completionRing + params.cq_off.cqes);
+    io->completionMask = *(uint32_t *) (void *) (completionRing + params.cq_off.ring_mask);
+    return true;
+}
+
+/**
+ * Allocates and registers the buffers. Buffers that cannot be registered, e.g. because of RLIMIT_MEMLOCK, are not
+ * used; reads then go to ordinary buffers.
+ */
+static short int storageIoRegisterBuffers(struct StorageIo *io,
+                                          unsigned int bufferCount,
+                                          size_t bufferSize)
+{
+    struct iovec vectors[STORAGE_IO_MAX_BUFFERS];
+    size_t alignedSize = (bufferSize + STORAGE_IO_BUFFER_ALIGNMENT - 1) & ~(size_t) (STORAGE_IO_BUFFER_ALIGNMENT - 1);
+    unsigned int i;
+
+    io->buffers = aligned_alloc(STORAGE_IO_BUFFER_ALIGNMENT, bufferCount * alignedSize);
+    if (io->buffers == NULL) {
+        return ERROR_STORAGE_FAILURE;
+    }
+    for (i = 0; i < bufferCount; i++) {
+        vectors[i].iov_base = io->buffers + i * alignedSize;
+        vectors[i].iov_len = alignedSize;
+    }
+    if (storageIoRegister(io->ringFd, IORING_REGISTER_BUFFERS, vectors, bufferCount) != 0) {
+        free(io->buffers);
+        io->buffers = NULL;
+        return EXECUTION_OK;
+    }
+    io->bufferSize = alignedSize;
+    io->bufferCount = bufferCount;
+    io->freeBuffers = bufferCount == 64 ? UINT64_MAX : (UINT64_C(1) << bufferCount) - 1;
+    return EXECUTION_OK;
+}
+
+short int storageIoInit(struct StorageIo *io,
+                        enum StorageIoBackend backend,
+                        unsigned int bufferCount,
+                        size_t bufferSize)
+{
+    if (io == NULL || bufferCount > STORAGE_IO_MAX_BUFFERS || (bufferCount > 0 && bufferSize == 0)) {
+        return ERROR_PARAMETER_MISMATCH;
+    }
+    memset(io, 0, sizeof *io);
+    io->backend = storageIoPortable;
+    io->ringFd = -1;
+    if (backend == storageIoUring && storageIoSetupRing(io)) {
+        if (bufferCount > 0 && storageIoRegisterBuffers(io, bufferCount, bufferSize) != EXECUTION_OK) {
+            storageIoUnmap(io);
+            close(io->ringFd);
+            return ERROR_STORAGE_FAILURE;
+        }
+        io->backend = storageIoUring;
+    }
+
+    pthread_mutex_init(&io->lock, NULL);
+    pthread_cond_init(&io->completed, NULL);
+    return EXECUTION_OK;
+}
+
+/**
+ * Stores the available completions in their operations. The caller holds the lock.
+ */
+static void storageIoReap(struct StorageIo *io)
+{
+    uint32_t head = atomic_load_explicit(io->completionHead, memory_order_relaxed);
+    uint32_t tail = atomic_load_explicit(io->completionTail, memory_order_acquire);
+
+    while (head != tail) {
+        const struct io_uring_cqe *completion = &io->completions[head & io->completionMask];
+        struct StorageIoOperation *operation = (struct StorageIoOperation *) (uintptr_t) completion->user_data;
+
+        operation->result = completion->res;
+        operation->done = true;
+        io->pendingCount--;
+        head++;
+    }
+    atomic_store_explicit(io->completionHead, head, memory_order_release);
+}
+
+static bool storageIoDone(const struct StorageIoOperation *operations,
+                          unsigned int count)
+{
+    unsigned int i;
+
+    for (i = 0; i < count; i++) {
+        if (!operations[i].done) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Submits entries and waits until all of them have been completed. The results are stored in the array operations.
+ * The thread that waits in the kernel reaps the completions of all threads; the other threads wait on the condition
+ * variable until their operations are done or the waiting thread has finished.
+ */
+static void storageIoExecute(struct StorageIo *io,
+                             struct io_uring_sqe *entries,
+                             struct StorageIoOperation *operations,
+                             unsigned int count)
+{
+    uint32_t tail;
+    unsigned int submitted = 0;
+    unsigned int i;
+
+    pthread_mutex_lock(&io->lock);
+    while (io->pendingCount + count > STORAGE_IO_QUEUE_ENTRIES) {
+        pthread_cond_wait(&io->completed, &io->lock);
+    }
+
+    tail = atomic_load_explicit(io->submissionTail, memory_order_relaxed);
+    for (i = 0; i < count; i++) {
+        uint32_t index = (tail + i) & io->submissionMask;
+
+        operations[i].done = false;
+        entries[i].user_data = (uint64_t) (uintptr_t) &operations[i];
+        io->entries[index] = entries[i];
+        io->submissionArray[index] = index;
+    }
+    atomic_store_explicit(io->submissionTail, tail + count, memory_order_release);
+    io->pendingCount += count;
+
+    /* the kernel only consumes entries during io_uring_enter, which is only invoked while holding the lock */
+    while (submitted < count) {
+        int result = storageIoEnter(io->ringFd, count - submitted, 0, 0);
+
+        if (result > 0) {
+            submitted += (unsigned int) result;
+        } else if (result < 0 && errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+            break;
+        }
+    }
+    if (submitted < count) {
+        atomic_store_explicit(io->submissionTail, tail + submitted, memory_order_release);
+        for (i = submitted; i < count; i++) {
+            operations[i].result = -ECANCELED;
+            operations[i].done = true;
+        }
+        io->pendingCount -= count - submitted;
+    }
+
+    while (!storageIoDone(operations, count)) {
+        if (io->reaping) {
+            pthread_cond_wait(&io->completed, &io->lock);
+            continue;
+        }
+        io->reaping = true;
+        storageIoReap(io);
+        if (!storageIoDone(operations, count)) {
+            pthread_mutex_unlock(&io->lock);
+            storageIoEnter(io->ringFd, 0, 1, IORING_ENTER_GETEVENTS);
+            pthread_mutex_lock(&io->lock);
+            storageIoReap(io);
+        }
+        io->reaping = false;
+        pthread_cond_broadcast(&io->completed);
+    }
+    pthread_mutex_unlock(&io->lock);
+}
+
+static void storageIoAdvance(struct iovec **vector,
+                             int *vectorCount,
+                             size_t written)
+{
+    while (*vectorCount > 0 && written >= (*vector)->iov_len) {
+        written -= (*vector)->iov_len;
+        (*vector)++;
+        (*vectorCount)--;
+    }
+    if (*vectorCount > 0) {
+        (*vector)->iov_base = (unsigned char *) (*vector)->iov_base + written;
+        (*vector)->iov_len -= written;
+    }
+}
+
+static short int storageIoAppendPortable(int fd,
+                                         struct iovec *vector,
+                                         int vectorCount,
+                                         bool synchronize)
+{
+    while (vectorCount > 0) {
+        ssize_t written = writev(fd, vector, vectorCount);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return ERROR_STORAGE_FAILURE;
+        }
+        storageIoAdvance(&vector, &vectorCount, (size_t) written);
+    }
+    if (synchronize && fdatasync(fd) != 0) {
+        return ERROR_STORAGE_FAILURE;
+    }
+    return EXECUTION_OK;
+}
+
+short int storageIoAppend(struct StorageIo *io,
+                          int fd,
+                          struct iovec *vector,
+                          int vectorCount,
+                          bool synchronize)
+{
+    if (io->backend == storageIoPortable) {
+        return storageIoAppendPortable(fd, vector, vectorCount, synchronize);
+    }
+
+    while (vectorCount > 0) {
+        struct io_uring_sqe entries[2];
+        struct StorageIoOperation operations[2];
+        unsigned int count = synchronize ? 2 : 1;
+
+        /* a short write breaks the link, so the synchronization is only executed after the complete data */
+        memset(entries, 0, sizeof entries);
+        entries[0].opcode = IORING_OP_WRITEV;
+        entries[0].fd = fd;
+        entries[0].addr = (uint64_t) (uintptr_t) vector;
+        entries[0].len = (uint32_t) vectorCount;
+        entries[0].off = (uint64_t) -1;
+        if (synchronize) {
+            entries[0].flags = IOSQE_IO_LINK;
+            entries[1].opcode = IORING_OP_FSYNC;
+            entries[1].fd = fd;
+            entries[1].fsync_flags = IORING_FSYNC_DATASYNC;
+        }
+        storageIoExecute(io, entries, operations, count);
+
+        if (operations[0].result < 0) {
+            if (operations[0].result == -EINTR || operations[0].result == -EAGAIN) {
+                continue;
+            }
+            return ERROR_STORAGE_FAILURE;
+        }
+        storageIoAdvance(&vector, &vectorCount, (size_t) operations[0].result);
+        if (vectorCount == 0 && synchronize && operations[1].result < 0) {
+            return ERROR_STORAGE_FAILURE;
+        }
+    }
+    return EXECUTION_OK;
+}
+
+short int storageIoSynchronize(struct StorageIo *io,
+                               int fd)
+{
+    struct io_uring_sqe entry;
+    struct StorageIoOperation operation;
+
+    if (io->backend == storageIoPortable) {
+        return fdatasync(fd) == 0 ? EXECUTION_OK : ERROR_STORAGE_FAILURE;
+    }
+    memset(&entry, 0, sizeof entry);
+    entry.opcode = IORING_OP_FSYNC;
+    entry.fd = fd;
+    entry.fsync_flags = IORING_FSYNC_DATASYNC;
+    storageIoExecute(io, &entry, &operation, 1);
+    return operation.result == 0 ? EXECUTION_OK : ERROR_STORAGE_FAILURE;
+}
+
+int storageIoAcquireBuffer(struct StorageIo *io,
+                           unsigned char **buffer)
+{
+    int bufferIndex = -1;
+
+    if (io->bufferCount == 0) {
+        return -1;
+    }
+    pthread_mutex_lock(&io->lock);
+    if (io->freeBuffers != 0) {
+        bufferIndex = 0;
+        while ((io->freeBuffers & (UINT64_C(1) << bufferIndex)) == 0) {
+            bufferIndex++;
+        }
+        io->freeBuffers &= ~(UINT64_C(1) << bufferIndex);
+        *buffer = io->buffers + (size_t) bufferIndex * io->bufferSize;
+    }
+    pthread_mutex_unlock(&io->lock);
+    return bufferIndex;
+}
+
+void storageIoReleaseBuffer(struct StorageIo *io,
+                            int bufferIndex)
+{
+    pthread_mutex_lock(&io->lock);
+    io->freeBuffers |= UINT64_C(1) << bufferIndex;
+    pthread_mutex_unlock(&io->lock);
+}
+
+short int storageIoRead(struct StorageIo *io,
+                        int fd,
+                        unsigned char *buffer,
+                        size_t length,
+                        uint64_t offset,
+                        int bufferIndex,
+                        size_t *readLength)
+{
+    struct io_uring_sqe entry;
+    struct StorageIoOperation operation;
+
+    if (io->backend == storageIoPortable) {
+        for (;;) {
+            ssize_t result = pread(fd, buffer, length, (off_t) offset);
+            if (result >= 0) {
+                *readLength = (size_t) result;
+                return EXECUTION_OK;
+            }
+            if (errno != EINTR) {
+                return ERROR_STORAGE_FAILURE;
+            }
+        }
+    }
+
+    memset(&entry, 0, sizeof entry);
+    entry.opcode = bufferIndex >= 0 ? IORING_OP_READ_FIXED : IORING_OP_READ;
+    entry.fd = fd;
+    entry.addr = (uint64_t) (uintptr_t) buffer;
+    entry.len = length > UINT32_MAX ? UINT32_MAX : (uint32_t) length;
+    entry.off = offset;
+    if (bufferIndex >= 0) {
+        entry.buf_index = (uint16_t) bufferIndex;
+    }
+    do {
+        storageIoExecute(io, &entry, &operation, 1);
+    } while (operation.result == -EINTR || operation.result == -EAGAIN);
+    if (operation.result < 0) {
+        return ERROR_STORAGE_FAILURE;
+    }
+    *readLength = (size_t) operation.result;
+    return EXECUTION_OK;
+}
+
+void storageIoFree(struct StorageIo *io)
+{
+    if (io->backend == storageIoUring) {
+        /* closing the ring also unregisters the buffers */
+        storageIoUnmap(io);
+        close(io->ringFd);
+        free(io->buffers);
+    }
+    pthread_cond_destroy(&io->completed);
+    pthread_mutex_destroy(&io->lock);
+    memset(io, 0, sizeof *io);
+    io->ringFd = -1;
+}
@@ -0,0 +1,184 @@
+#ifndef SEAPI_BACKEND_STORAGE_IO_H
+#define SEAPI_BACKEND_STORAGE_IO_H
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/uio.h>
+
+#include "../Exception.h"
+#include "../Constant.h"
+
+/**
+ * This header file defines the storage backend through which the log store appends log messages, synchronizes the
+ * active segment and reads segments, e.g. for exports.
+ *
+ * The portable backend executes every operation with blocking system calls (writev, fdatasync, pread). The io_uring
+ * backend submits the operations to a submission queue shared with the kernel: an append and the synchronization of
+ * the file are submitted together as linked operations, so that a synchronized append costs one system call, and the
+ * readers of segments read into buffers that have been registered with the kernel once, so that their pages are not
+ * pinned again for every read. Operations of several threads are in flight at the same time; the thread that waits
+ * for completions hands the completions of the other threads to them.
+ *
+ * The io_uring backend is selected when the storage backend is initialized. If the kernel does not provide io_uring
+ * or it is not permitted, e.g. by a seccomp filter, the portable backend is used instead.
+ */
+
+/**
+ * Represents the implementation of a storage backend.
+ */
+enum StorageIoBackend {
+storageIoPortable, storageIoUring
+};
+
+/**
+ * Number of entries of the submission queue, which limits the number of operations in flight
+ */
+#define STORAGE_IO_QUEUE_ENTRIES 64
+
+/**
+ * Maximum number of registered buffers
+ */
+#define STORAGE_IO_MAX_BUFFERS 64
+
+/**
+ * State of a storage backend. The members are managed by the functions of this header file; the members after
+ * lock MUST only be accessed while holding it.
+ */
+struct StorageIo {
+    enum StorageIoBackend backend;
+    int ringFd;
+    void *submissionRing;
+    size_t submissionRingSize;
+    void *completionRing;
+    size_t completionRingSize;
+    struct io_uring_sqe *entries;
+    size_t entriesSize;
+    _Atomic uint32_t *submissionHead;
+    _Atomic uint32_t *submissionTail;
+    uint32_t *submissionArray;
+    uint32_t submissionMask;
+    _Atomic uint32_t *completionHead;
+    _Atomic uint32_t *completionTail;
+    struct io_uring_cqe *completions;
+    uint32_t completionMask;
+    unsigned char *buffers;
+    size_t bufferSize;
+    unsigned int bufferCount;
+    pthread_mutex_t lock;
+    pthread_cond_t completed;
+    unsigned int pendingCount;
+    bool reaping;
+    uint64_t freeBuffers;
+};
+
+/**
+ * Initializes a storage backend.
+ * @param[out] io
+ *                storage backend to be initialized [REQUIRED]
+ * @param[in] backend
+ *                requested implementation; storageIoUring falls back to storageIoPortable if io_uring is not
+ *                available, the implementation in use is stored in the member backend [REQUIRED]
+ * @param[in] bufferCount
+ *                number of buffers registered with the kernel, at most STORAGE_IO_MAX_BUFFERS; 0 registers no
+ *                buffers [REQUIRED]
+ * @param[in] bufferSize
+ *                size of a registered buffer [REQUIRED]
+ * @return EXECUTION_OK, ERROR_PARAMETER_MISMATCH if io is missing or too many buffers are requested or
+ *         ERROR_STORAGE_FAILURE if no memory could be allocated
+ */
+short int storageIoInit(struct StorageIo *io,
+                        enum StorageIoBackend backend,
+                        unsigned int bufferCount,
+                        size_t bufferSize);
+
+/**
+ * Appends the data of an I/O vector to a file opened with O_APPEND and synchronizes its data if requested.
+ * @param[in] io
+ *                initialized storage backend [REQUIRED]
+ * @param[in] fd
+ *                file descriptor of the file [REQUIRED]
+ * @param[in] vector
+ *                the data; the array is modified by the function [REQUIRED]
+ * @param[in] vectorCount
+ *                number of elements of the array vector [REQUIRED]
+ * @param[in] synchronize
+ *                true to synchronize the data of the file after the append, as with fdatasync [REQUIRED]
+ * @return EXECUTION_OK or ERROR_STORAGE_FAILURE if the data could not be written or synchronized; the data MAY then
+ *         have been written partially
+ */
+short int storageIoAppend(struct StorageIo *io,
+                          int fd,
+                          struct iovec *vector,
+                          int vectorCount,
+                          bool synchronize);
+
+/**
+ * Synchronizes the data of a file, as with fdatasync.
+ * @param[in] io
+ *                initialized storage backend [REQUIRED]
+ * @param[in] fd
+ *                file descriptor of the file [REQUIRED]
+ * @return EXECUTION_OK or ERROR_STORAGE_FAILURE
+ */
+short int storageIoSynchronize(struct StorageIo *io,
+                               int fd);
+
+/**
+ * Takes a registered buffer of the size passed to storageIoInit.
+ * @param[in] io
+ *                initialized storage backend [REQUIRED]
+ * @param[out] buffer
+ *                receives the address of the buffer [REQUIRED]
+ * @return the index of the buffer or -1 if no registered buffer is free
+ */
+int storageIoAcquireBuffer(struct StorageIo *io,
+                           unsigned char **buffer);
+
+/**
+ * Returns a registered buffer taken with storageIoAcquireBuffer.
+ * @param[in] io
+ *                initialized storage backend [REQUIRED]
+ * @param[in] bufferIndex
+ *                the index returned by storageIoAcquireBuffer [REQUIRED]
+ */
+void storageIoReleaseBuffer(struct StorageIo *io,
+                            int bufferIndex);
+
+/**
+ * Reads from a file at an offset, as with pread.
+ * @param[in] io
+ *                initialized storage backend [REQUIRED]
+ * @param[in] fd
+ *                file descriptor of the file [REQUIRED]
+ * @param[out] buffer
+ *                receives the data; it MUST lie within the registered buffer bufferIndex if bufferIndex is not
+ *                negative [REQUIRED]
+ * @param[in] length
+ *                maximum number of bytes to read [REQUIRED]
+ * @param[in] offset
+ *                offset in the file [REQUIRED]
+ * @param[in] bufferIndex
+ *                index of the registered buffer that contains buffer or -1 [REQUIRED]
+ * @param[out] readLength
+ *                receives the number of bytes read, 0 at the end of the file [REQUIRED]
+ * @return EXECUTION_OK or ERROR_STORAGE_FAILURE
+ */
+short int storageIoRead(struct StorageIo *io,
+                        int fd,
+                        unsigned char *buffer,
+                        size_t length,
+                        uint64_t offset,
+                        int bufferIndex,
+                        size_t *readLength);
+
+/**
+ * Releases the resources of a storage backend. No operation MAY be in flight.
+ * @param[in] io
+ *                initialized storage backend [REQUIRED]
+ */
+void storageIoFree(struct StorageIo *io);
+
+#endif
@@ -0,0 +1,278 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "StoreSimulationTarget.h"
+#include "CountIndex.h"
+#include "ExportScan.h"
+#include "TarWriter.h"
+
+#define STORE_SIMULATION_JOURNAL_FILE_NAME "counters.jnl"
+#define STORE_SIMULATION_PAYLOAD_LENGTH 64
+
+static short int storeSimulationTargetOpenStorage(struct StoreSimulationTarget *storeTarget)
+{
+    short int result = logStoreOpen(&storeTarget->store, storeTarget->directory, &storeTarget->options);
+
+    if (result != EXECUTION_OK) {
+        return result;
+    }
+    result = counterJournalOpen(&storeTarget->journal, storeTarget->journalPath, 0, logStoreProbeCounter,
+                                &storeTarget->store);
+    if (result != EXECUTION_OK) {
+        logStoreClose(&storeTarget->store);
+        return result;
+    }
+    storeTarget->opened = true;
+    return EXECUTION_OK;
+}
+
+static short int storeSimulationTargetCloseStorage(struct StoreSimulationTarget *storeTarget)
+{
+    short int journalResult;
+    short int storeResult;
+
+    if (!storeTarget->opened) {
+        return EXECUTION_OK;
+    }
+    storeTarget->opened = false;
+    journalResult = counterJournalClose(&storeTarget->journal);
+    storeResult = logStoreClose(&storeTarget->store);
+    return storeResult != EXECUTION_OK ? storeResult : journalResult;
+}
+
+static short int storeSimulationExecute(void *targetContext,
+                                        const struct SimulatedRequest *request,
+                                        struct SimulatedRecord *record)
+{
+    struct StoreSimulationTarget *storeTarget = (struct StoreSimulationTarget *) targetContext;
+    unsigned char payload[STORE_SIMULATION_PAYLOAD_LENGTH];
+    struct LogRecord logRecord;
+    short int result;
+
+    if (!storeTarget->opened) {
+        return ERROR_SECURE_ELEMENT_DISABLED;
+    }
+    memset(&logRecord, 0, sizeof logRecord);
+    logRecord.logTime = request->logTime;
+    logRecord.transactionNumber = request->transactionNumber;
+    if (request->operation == simulatedUpdateTime) {
+        logRecord.type = systemLogMessage;
+        logRecord.operation = noTransactionOperation;
+        logRecord.transactionNumber = 0;
+    } else {
+        logRecord.type = transactionLogMessage;
+        logRecord.operation = request->operation == simulatedStartTransaction ? startTransactionOperation
+                              : request->operation == simulatedUpdateTransaction ? updateTransactionOperation
+                              : finishTransactionOperation;
+        logRecord.clientId = request->clientId;
+        logRecord.clientIdLength = request->clientIdLength;
+    }
+    if (request->operation == simulatedStartTransaction) {
+        result = counterJournalReserve(&storeTarget->journal, journaledTransactionNumber,
+                                       &logRecord.transactionNumber);
+        if (result != EXECUTION_OK) {
+            return result;
+        }
+    }
+    result = counterJournalReserve(&storeTarget->journal, journaledSignatureCounter, &logRecord.signatureCounter);
+    if (result != EXECUTION_OK) {
+        return result;
+    }
+
+    /* the payload stands in for the signed log message parts */
+    memset(payload, 0, sizeof payload);
+    snprintf((char *) payload, sizeof payload, "%s %llu", request->operation == simulatedUpdateTime
+             ? "updateTime" : "transaction", (unsigned long long) logRecord.signatureCounter);
+    logRecord.payload = payload;
+    logRecord.payloadLength = sizeof payload;
+
+    result = logStoreAppend(&storeTarget->store, &logRecord);
+    if (result != EXECUTION_OK) {
+        return result;
+    }
+    /* the values of a log message that has not been stored are used by the next one */
+    counterJournalCommit(&storeTarget->journal, journaledSignatureCounter);
+    if (request->operation == simulatedStartTransaction) {
+        counterJournalCommit(&storeTarget->journal, journaledTransactionNumber);
+    }
+    record->signatureCounter = logRecord.signatureCounter;
+    record->transactionNumber = logRecord.transactionNumber;
+    record->operation = request->operation;
+    return EXECUTION_OK;
+}
+
+static short int storeSimulationReset(void *targetContext)
+{
+    struct StoreSimulationTarget *storeTarget = (struct StoreSimulationTarget *) targetContext;
+    short int result = storeSimulationTargetCloseStorage(storeTarget);
+
+    if (result != EXECUTION_OK) {
+        return result;
+    }
+    return storeSimulationTargetOpenStorage(storeTarget);
+}
+
+static short int storeSimulationCountSink(void *sinkContext,
+                                          const unsigned char *data,
+                                          size_t dataLength)
+{
+    (void) sinkContext;
+    (void) data;
+    (void) dataLength;
+    return EXECUTION_OK;
+}
+
+/**
+ * Compares the number of visited log messages with the count index and with an export of all data.
+ */
+static short int storeSimulationCheckCounts(struct StoreSimulationTarget *storeTarget,
+                                            uint64_t visited)
+{
+    struct RecordCountQuery query;
+    struct ExportSelection selection;
+    struct TarWriter *writer;
+    uint64_t lowerBound;
+    uint64_t upperBound;
+    short int result;
+
+    memset(&query, 0, sizeof query);
+    result = logStoreEstimateRecords(&storeTarget->store, &query, &lowerBound, &upperBound);
+    if (result != EXECUTION_OK) {
+        return result;
+    }
+    if (lowerBound != visited || upperBound != visited) {
+        return ERROR_STORAGE_FAILURE;
+    }
+    if (visited == 0) {
+        return EXECUTION_OK;
+    }
+
+    writer = malloc(sizeof *writer);
+    if (writer == NULL) {
+        return ERROR_STORAGE_FAILURE;
+    }
+    memset(&selection, 0, sizeof selection);
+    tarWriterInit(writer, storeSimulationCountSink, NULL);
+    result = exportScanRun(&storeTarget->store, &selection, 0, writer);
+    if (result == EXECUTION_OK && writer->entryCount != visited) {
+        result = ERROR_STORAGE_FAILURE;
+    }
+    free(writer);
+    return result;
+}
+
+static short int storeSimulationCollect(void *targetContext,
+                                        SimulatedRecordVisitor visitor,
+                                        void *visitorContext)
+{
+    struct StoreSimulationTarget *storeTarget = (struct StoreSimulationTarget *) targetContext;
+    struct SegmentInfo *segments;
+    size_t segmentCount;
+    uint64_t visited = 0;
+    short int result;
+    size_t i;
+
+    if (!storeTarget->opened) {
+        return ERROR_SECURE_ELEMENT_DISABLED;
+    }
+    result = logStoreSnapshotSegments(&storeTarget->store, &segments, &segmentCount);
+    if (result != EXECUTION_OK) {
+        return result;
+    }
+    for (i = 0; i < segmentCount && result == EXECUTION_OK; i++) {
+        struct SegmentReader reader;
+        struct LogRecord logRecord;
+        bool endOfSegment = false;
+
+        result = segmentReaderOpen(&reader, &storeTarget->store, segments[i].id, 0);
+        if (result != EXECUTION_OK) {
+            break;
+        }
+        reader.limit = segments[i].length;
+        while (result == EXECUTION_OK) {
+            struct SimulatedRecord record;
+
+            result = segmentReaderNext(&reader, &logRecord, &endOfSegment);
+            if (result != EXECUTION_OK || endOfSegment) {
+                break;
+            }
+            record.signatureCounter = logRecord.signatureCounter;
+            record.transactionNumber = logRecord.type == transactionLogMessage ? logRecord.transactionNumber : 0;
+            record.operation = logRecord.operation == startTransactionOperation ? simulatedStartTransaction
+                               : logRecord.operation == updateTransactionOperation ? simulatedUpdateTransaction
+                               : logRecord.operation == finishTransactionOperation ? simulatedFinishTransaction
+                               : simulatedUpdateTime;
+            visitor(visitorContext, &record);
+            visited++;
+        }
+        if (result == EXECUTION_OK && reader.offset < segments[i].length) {
+            result = ERROR_STORAGE_FAILURE;
+        }
+        segmentReaderClose(&reader);
+    }
+    logStoreReleaseSnapshot(&storeTarget->store, segments);
+
+    if (result == EXECUTION_OK) {
+        result = storeSimulationCheckCounts(storeTarget, visited);
+    }
+    return result;
+}
+
+static char *storeSimulationJoin(const char *directory,
+                                 const char *name)
+{
+    size_t length = strlen(directory) + strlen(name) + 2;
+    char *path = malloc(length);
+
+    if (path != NULL) {
+        snprintf(path, length, "%s/%s", directory, name);
+    }
+    return path;
+}
+
+short int storeSimulationTargetOpen(struct StoreSimulationTarget *storeTarget,
+                                    const char *directory,
+                                    const struct LogStoreOptions *options,
+                                    struct SimulationTarget *target)
+{
+    short int result;
+
+    if (storeTarget == NULL || directory == NULL || target == NULL) {
+        return ERROR_PARAMETER_MISMATCH;
+    }
+    memset(storeTarget, 0, sizeof *storeTarget);
+    if (options != NULL) {
+        storeTarget->options = *options;
+    }
+    storeTarget->directory = strdup(directory);
+    storeTarget->journalPath = storeSimulationJoin(directory, STORE_SIMULATION_JOURNAL_FILE_NAME);
+    if (storeTarget->directory == NULL || storeTarget->journalPath == NULL) {
+        free(storeTarget->directory);
+        free(storeTarget->journalPath);
+        return ERROR_STORAGE_FAILURE;
+    }
+    result = storeSimulationTargetOpenStorage(storeTarget);
+    if (result != EXECUTION_OK) {
+        free(storeTarget->directory);
+        free(storeTarget->journalPath);
+        return result;
+    }
+
+    target->context = storeTarget;
+    target->execute = storeSimulationExecute;
+    target->reset = storeSimulationReset;
+    target->collect = storeSimulationCollect;
+    return EXECUTION_OK;
+}
+
+short int storeSimulationTargetClose(struct StoreSimulationTarget *storeTarget)
+{
+    short int result = storeSimulationTargetCloseStorage(storeTarget);
+
+    free(storeTarget->directory);
+    free(storeTarget->journalPath);
+    storeTarget->directory = NULL;
+    storeTarget->journalPath = NULL;
+    return result;
+}
@@ -0,0 +1,56 @@
+#ifndef SEAPI_BACKEND_STORE_SIMULATION_TARGET_H
+#define SEAPI_BACKEND_STORE_SIMULATION_TARGET_H
+
+#include <stdbool.h>
+
+#include "../Exception.h"
+#include "../Constant.h"
+#include "CounterJournal.h"
+#include "LogStore.h"
+#include "Simulation.h"
+
+/**
+ * This header file defines the simulation target that runs the simulated requests against the log store and the
+ * counter journal of the SE API backend. A reset of the Secure Element closes and reopens both, so that every
+ * injected reset exercises the recovery. The verification additionally compares the stored log messages with the
+ * count index and with the number of log messages selected by an export of all data.
+ */
+
+/**
+ * State of the target. The members are managed by the functions of this header file.
+ */
+struct StoreSimulationTarget {
+    char *directory;
+    char *journalPath;
+    struct LogStoreOptions options;
+    struct LogStore store;
+    struct CounterJournal journal;
+    bool opened;
+};
+
+/**
+ * Opens the log store and the counter journal in a directory and initializes the simulation target.
+ * @param[out] storeTarget
+ *                target to be initialized [REQUIRED]
+ * @param[in] directory
+ *                existing directory for the log store and the counter journal [REQUIRED]
+ * @param[in] options
+ *                options of the store, NULL selects the defaults [OPTIONAL]
+ * @param[out] target
+ *                simulation target that refers to storeTarget [REQUIRED]
+ * @return the return values of logStoreOpen and counterJournalOpen
+ */
+short int storeSimulationTargetOpen(struct StoreSimulationTarget *storeTarget,
+                                    const char *directory,
+                                    const struct LogStoreOptions *options,
+                                    struct SimulationTarget *target);
+
+/**
+ * Closes the log store and the counter journal.
+ * @param[in] storeTarget
+ *                opened target [REQUIRED]
+ * @return the return values of logStoreClose and counterJournalClose
+ */
+short int storeSimulationTargetClose(struct StoreSimulationTarget *storeTarget);
+
+#endif
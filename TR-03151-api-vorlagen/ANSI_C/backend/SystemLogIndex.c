@@ -0,0 +1,183 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "LogStore.h"
+#include "SystemLogIndex.h"
+
+void systemLogIndexInit(struct SystemLogIndex *index)
+{
+    memset(index, 0, sizeof *index);
+}
+
+void systemLogIndexFree(struct SystemLogIndex *index)
+{
+    size_t i;
+
+    for (i = 0; i < index->count; i++) {
+        free(index->segments[i].entries);
+    }
+    free(index->segments);
+    memset(index, 0, sizeof *index);
+}
+
+/**
+ * Returns the position of the first tracked segment whose id is not below segmentId.
+ */
+static size_t systemLogIndexLowerBound(const struct SystemLogIndex *index,
+                                       uint32_t segmentId)
+{
+    size_t low = 0;
+    size_t high = index->count;
+
+    while (low < high) {
+        size_t middle = low + (high - low) / 2;
+        if (index->segments[middle].segmentId < segmentId) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+struct SystemLogSegment *systemLogIndexFind(struct SystemLogIndex *index,
+                                            uint32_t segmentId)
+{
+    size_t position = systemLogIndexLowerBound(index, segmentId);
+
+    if (position < index->count && index->segments[position].segmentId == segmentId) {
+        return &index->segments[position];
+    }
+    return NULL;
+}
+
+short int systemLogIndexTrack(struct SystemLogIndex *index,
+                              uint32_t segmentId,
+                              struct SystemLogSegment **segment)
+{
+    size_t position = systemLogIndexLowerBound(index, segmentId);
+
+    if (position < index->count && index->segments[position].segmentId == segmentId) {
+        *segment = &index->segments[position];
+        return EXECUTION_OK;
+    }
+    if (index->count == index->capacity) {
+        size_t capacity = index->capacity != 0 ? 2 * index->capacity : 16;
+        struct SystemLogSegment *segments = realloc(index->segments, capacity * sizeof *segments);
+        if (segments == NULL) {
+            return ERROR_STORAGE_FAILURE;
+        }
+        index->segments = segments;
+        index->capacity = capacity;
+    }
+    /* segments are usually tracked in the order of their ids, so the move is empty */
+    memmove(&index->segments[position + 1], &index->segments[position],
+            (index->count - position) * sizeof *index->segments);
+    index->count++;
+    memset(&index->segments[position], 0, sizeof index->segments[position]);
+    index->segments[position].segmentId = segmentId;
+    *segment = &index->segments[position];
+    return EXECUTION_OK;
+}
+
+void systemLogIndexDrop(struct SystemLogIndex *index,
+                        uint32_t segmentId)
+{
+    size_t position = systemLogIndexLowerBound(index, segmentId);
+
+    if (position < index->count && index->segments[position].segmentId == segmentId) {
+        free(index->segments[position].entries);
+        index->count--;
+        memmove(&index->segments[position], &index->segments[position + 1],
+                (index->count - position) * sizeof *index->segments);
+    }
+}
+
+static short int systemLogIndexReserve(struct SystemLogSegment *segment,
+                                       size_t required)
+{
+    struct SystemLogEntry *entries;
+    size_t capacity = segment->capacity != 0 ? segment->capacity : 64;
+
+    if (required <= segment->capacity) {
+        return EXECUTION_OK;
+    }
+    while (capacity < required) {
+        capacity *= 2;
+    }
+    entries = realloc(segment->entries, capacity * sizeof *entries);
+    if (entries == NULL) {
+        return ERROR_STORAGE_FAILURE;
+    }
+    segment->entries = entries;
+    segment->capacity = capacity;
+    return EXECUTION_OK;
+}
+
+short int systemLogIndexAdd(struct SystemLogSegment *segment,
+                            const struct LogRecord *record,
+                            uint64_t recordLength)
+{
+    if (record->type != transactionLogMessage) {
+        if (systemLogIndexReserve(segment, segment->count + 1) != EXECUTION_OK) {
+            return ERROR_STORAGE_FAILURE;
+        }
+        segment->entries[segment->count].signatureCounter = record->signatureCounter;
+        segment->entries[segment->count].offset = segment->indexedLength;
+        segment->count++;
+    }
+    segment->indexedLength += recordLength;
+    return EXECUTION_OK;
+}
+
+short int systemLogIndexJoin(struct SystemLogSegment *segment,
+                             const struct SystemLogSegment *continuation)
+{
+    if (systemLogIndexReserve(segment, segment->count + continuation->count) != EXECUTION_OK) {
+        return ERROR_STORAGE_FAILURE;
+    }
+    if (continuation->count > 0) {
+        memcpy(&segment->entries[segment->count], continuation->entries,
+               continuation->count * sizeof *continuation->entries);
+    }
+    segment->count += continuation->count;
+    segment->indexedLength = continuation->indexedLength;
+    return EXECUTION_OK;
+}
+
+/**
+ * Returns the position of the first entry whose signature counter is not below signatureCounter.
+ */
+static size_t systemLogIndexFirstFrom(const struct SystemLogSegment *segment,
+                                      uint64_t signatureCounter)
+{
+    size_t low = 0;
+    size_t high = segment->count;
+
+    while (low < high) {
+        size_t middle = low + (high - low) / 2;
+        if (segment->entries[middle].signatureCounter < signatureCounter) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+size_t systemLogIndexRange(const struct SystemLogSegment *segment,
+                           uint64_t firstSignatureCounter,
+                           uint64_t lastSignatureCounter,
+                           size_t *first)
+{
+    size_t end;
+
+    if (firstSignatureCounter > lastSignatureCounter) {
+        *first = 0;
+        return 0;
+    }
+    *first = systemLogIndexFirstFrom(segment, firstSignatureCounter);
+    end = lastSignatureCounter == UINT64_MAX ? segment->count
+                                             : systemLogIndexFirstFrom(segment, lastSignatureCounter + 1);
+    return end - *first;
+}
@@ -0,0 +1,144 @@
+#ifndef SEAPI_BACKEND_SYSTEM_LOG_INDEX_H
+#define SEAPI_BACKEND_SYSTEM_LOG_INDEX_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "../Exception.h"
+#include "../Constant.h"
+
+struct LogRecord;
+
+/**
+ * This header file defines the interval index of the system log messages and audit log messages of the log store.
+ *
+ * Exports of an interval of transactions have to include every system log message and audit log message whose
+ * signature counter lies within the interval of the selected transaction log messages. For every segment the index
+ * keeps the signature counters and file offsets of these log messages in the order of the signature counter, so
+ * that they are found by binary search and read directly instead of scanning the segment. The index of a segment
+ * covers the part of the segment up to indexedLength: it is extended by appends as long as it is complete and
+ * otherwise from the part of the segment that has not been indexed yet, so every part of a segment is read for the
+ * index at most once.
+ */
+
+/**
+ * Position of a system log message or audit log message within its segment
+ */
+struct SystemLogEntry {
+    uint64_t signatureCounter;
+    uint64_t offset;
+};
+
+/**
+ * Index of one segment
+ */
+struct SystemLogSegment {
+    uint32_t segmentId;
+    uint64_t indexedLength;
+    struct SystemLogEntry *entries;
+    size_t count;
+    size_t capacity;
+};
+
+/**
+ * State of the index. The segments are kept in the order of their ids. Pointers to segments are only valid until
+ * the next call of systemLogIndexTrack or systemLogIndexDrop.
+ */
+struct SystemLogIndex {
+    struct SystemLogSegment *segments;
+    size_t count;
+    size_t capacity;
+};
+
+/**
+ * Initializes an empty index.
+ * @param[out] index
+ *                index to be initialized [REQUIRED]
+ */
+void systemLogIndexInit(struct SystemLogIndex *index);
+
+/**
+ * Releases the memory of an index.
+ * @param[in] index
+ *                initialized index [REQUIRED]
+ */
+void systemLogIndexFree(struct SystemLogIndex *index);
+
+/**
+ * Returns the index of a segment or NULL if the segment is not tracked.
+ * @param[in] index
+ *                initialized index [REQUIRED]
+ * @param[in] segmentId
+ *                id of the segment [REQUIRED]
+ */
+struct SystemLogSegment *systemLogIndexFind(struct SystemLogIndex *index,
+                                            uint32_t segmentId);
+
+/**
+ * Returns the index of a segment and starts an empty one if the segment is not tracked yet.
+ * @param[in] index
+ *                initialized index [REQUIRED]
+ * @param[in] segmentId
+ *                id of the segment [REQUIRED]
+ * @param[out] segment
+ *                the index of the segment [REQUIRED]
+ * @return EXECUTION_OK or ERROR_STORAGE_FAILURE if no memory could be allocated
+ */
+short int systemLogIndexTrack(struct SystemLogIndex *index,
+                              uint32_t segmentId,
+                              struct SystemLogSegment **segment);
+
+/**
+ * Stops tracking a segment, e.g. because it has been deleted or rewritten.
+ * @param[in] index
+ *                initialized index [REQUIRED]
+ * @param[in] segmentId
+ *                id of the segment [REQUIRED]
+ */
+void systemLogIndexDrop(struct SystemLogIndex *index,
+                        uint32_t segmentId);
+
+/**
+ * Adds the record that follows the indexed part of a segment. Transaction log messages only extend the indexed
+ * length.
+ * @param[in] segment
+ *                index of the segment [REQUIRED]
+ * @param[in] record
+ *                the record that starts at indexedLength [REQUIRED]
+ * @param[in] recordLength
+ *                length of the record within the segment file [REQUIRED]
+ * @return EXECUTION_OK or ERROR_STORAGE_FAILURE if no memory could be allocated
+ */
+short int systemLogIndexAdd(struct SystemLogSegment *segment,
+                            const struct LogRecord *record,
+                            uint64_t recordLength);
+
+/**
+ * Appends an index that has been built for the part of the segment that follows the indexed part.
+ * @param[in] segment
+ *                index of the segment [REQUIRED]
+ * @param[in] continuation
+ *                index of the following part, started with indexedLength set to that of the segment [REQUIRED]
+ * @return EXECUTION_OK or ERROR_STORAGE_FAILURE if no memory could be allocated
+ */
+short int systemLogIndexJoin(struct SystemLogSegment *segment,
+                             const struct SystemLogSegment *continuation);
+
+/**
+ * Determines the entries of a segment whose signature counters lie within an interval in O(log n).
+ * @param[in] segment
+ *                index of the segment [REQUIRED]
+ * @param[in] firstSignatureCounter
+ *                start (inclusive) of the interval [REQUIRED]
+ * @param[in] lastSignatureCounter
+ *                end (inclusive) of the interval [REQUIRED]
+ * @param[out] first
+ *                position of the first entry within the interval [REQUIRED]
+ * @return the number of entries within the interval
+ */
+size_t systemLogIndexRange(const struct SystemLogSegment *segment,
+                           uint64_t firstSignatureCounter,
+                           uint64_t lastSignatureCounter,
+                           size_t *first);
+
+#endif
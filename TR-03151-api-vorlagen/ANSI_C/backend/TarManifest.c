@@ -0,0 +1,257 @@
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "TarManifest.h"
+
+/**
+ * Maximum number of threads that reduce the Merkle tree
+ */
+#define TAR_MANIFEST_MAX_THREADS 64
+
+/**
+ * Subtree of the Merkle tree that is reduced by one thread
+ */
+struct TarManifestSubtree {
+    const struct TarManifest *manifest;
+    unsigned char (*nodes)[SHA256_DIGEST_LENGTH];
+    size_t begin;
+    size_t end;
+    pthread_t thread;
+};
+
+static void tarManifestLeaf(const struct TarManifest *manifest,
+                            const struct TarManifestEntry *entry,
+                            unsigned char *leaf)
+{
+    static const unsigned char prefix = 0x00;
+    struct Sha256Context context;
+
+    sha256Init(&context);
+    sha256Update(&context, &prefix, 1);
+    sha256Update(&context, entry->digest, SHA256_DIGEST_LENGTH);
+    sha256Update(&context, manifest->names + entry->nameOffset, entry->nameLength);
+    sha256Final(&context, leaf);
+}
+
+/**
+ * Reduces the nodes of a level to the root of their subtree in nodes[0]. An odd node at the end of a level is
+ * moved up unchanged, which results in the tree of RFC 6962.
+ */
+static void tarManifestReduce(unsigned char (*nodes)[SHA256_DIGEST_LENGTH],
+                              size_t nodeCount)
+{
+    static const unsigned char prefix = 0x01;
+
+    while (nodeCount > 1) {
+        size_t i;
+
+        for (i = 0; i + 1 < nodeCount; i += 2) {
+            struct Sha256Context context;
+
+            sha256Init(&context);
+            sha256Update(&context, &prefix, 1);
+            sha256Update(&context, nodes[i], SHA256_DIGEST_LENGTH);
+            sha256Update(&context, nodes[i + 1], SHA256_DIGEST_LENGTH);
+            sha256Final(&context, nodes[i / 2]);
+        }
+        if (nodeCount % 2 != 0) {
+            memcpy(nodes[nodeCount / 2], nodes[nodeCount - 1], SHA256_DIGEST_LENGTH);
+        }
+        nodeCount = (nodeCount + 1) / 2;
+    }
+}
+
+static void *tarManifestReduceSubtree(void *argument)
+{
+    struct TarManifestSubtree *subtree = (struct TarManifestSubtree *) argument;
+    size_t i;
+
+    for (i = subtree->begin; i < subtree->end; i++) {
+        tarManifestLeaf(subtree->manifest, &subtree->manifest->entries[i], subtree->nodes[i]);
+    }
+    tarManifestReduce(subtree->nodes + subtree->begin, subtree->end - subtree->begin);
+    return NULL;
+}
+
+static short int tarManifestReserve(void **array,
+                                    size_t *capacity,
+                                    size_t required,
+                                    size_t elementSize)
+{
+    size_t grown = *capacity != 0 ? *capacity : 64;
+    void *reallocated;
+
+    if (required <= *capacity) {
+        return EXECUTION_OK;
+    }
+    while (grown < required) {
+        grown *= 2;
+    }
+    reallocated = realloc(*array, grown * elementSize);
+    if (reallocated == NULL) {
+        return ERROR_STORAGE_FAILURE;
+    }
+    *array = reallocated;
+    *capacity = grown;
+    return EXECUTION_OK;
+}
+
+static void tarManifestHex(const unsigned char *digest,
+                           char *hex)
+{
+    static const char digits[] = "0123456789abcdef";
+    size_t i;
+
+    for (i = 0; i < SHA256_DIGEST_LENGTH; i++) {
+        hex[2 * i] = digits[digest[i] >> 4];
+        hex[2 * i + 1] = digits[digest[i] & 0x0F];
+    }
+    hex[2 * SHA256_DIGEST_LENGTH] = '\0';
+}
+
+void tarManifestInit(struct TarManifest *manifest,
+                     unsigned int threadCount)
+{
+    memset(manifest, 0, sizeof *manifest);
+    manifest->threadCount = threadCount;
+}
+
+short int tarManifestAdd(struct TarManifest *manifest,
+                         const char *name,
+                         uint64_t offset,
+                         uint64_t length,
+                         const unsigned char *digest)
+{
+    size_t nameLength = strlen(name);
+    struct TarManifestEntry *entry;
+
+    if (tarManifestReserve((void **) &manifest->entries, &manifest->entryCapacity, manifest->entryCount + 1,
+                           sizeof *manifest->entries) != EXECUTION_OK
+        || tarManifestReserve((void **) &manifest->names, &manifest->namesCapacity,
+                              manifest->namesLength + nameLength, 1) != EXECUTION_OK) {
+        return ERROR_STORAGE_FAILURE;
+    }
+    entry = &manifest->entries[manifest->entryCount++];
+    entry->offset = offset;
+    entry->length = length;
+    entry->nameOffset = manifest->namesLength;
+    entry->nameLength = nameLength;
+    memcpy(entry->digest, digest, SHA256_DIGEST_LENGTH);
+    memcpy(manifest->names + manifest->namesLength, name, nameLength);
+    manifest->namesLength += nameLength;
+    return EXECUTION_OK;
+}
+
+short int tarManifestRoot(const struct TarManifest *manifest,
+                          unsigned char *root)
+{
+    struct TarManifestSubtree subtrees[TAR_MANIFEST_MAX_THREADS];
+    unsigned char (*nodes)[SHA256_DIGEST_LENGTH];
+    size_t subtreeSize = 1;
+    size_t subtreeCount;
+    size_t threadCount = manifest->threadCount;
+    size_t started = 0;
+    size_t i;
+
+    if (manifest->entryCount == 0) {
+        sha256Digest("", 0, root);
+        return EXECUTION_OK;
+    }
+    nodes = malloc(manifest->entryCount * sizeof *nodes);
+    if (nodes == NULL) {
+        return ERROR_STORAGE_FAILURE;
+    }
+
+    /* the subtrees are aligned to a power of two, so that each of them is a subtree of the whole tree */
+    if (threadCount > TAR_MANIFEST_MAX_THREADS) {
+        threadCount = TAR_MANIFEST_MAX_THREADS;
+    }
+    if (threadCount > manifest->entryCount / TAR_MANIFEST_PARALLEL_ENTRIES) {
+        threadCount = manifest->entryCount / TAR_MANIFEST_PARALLEL_ENTRIES;
+    }
+    if (threadCount == 0) {
+        threadCount = 1;
+    }
+    while (subtreeSize * threadCount < manifest->entryCount) {
+        subtreeSize *= 2;
+    }
+    subtreeCount = (manifest->entryCount + subtreeSize - 1) / subtreeSize;
+
+    for (i = 0; i < subtreeCount; i++) {
+        subtrees[i].manifest = manifest;
+        subtrees[i].nodes = nodes;
+        subtrees[i].begin = i * subtreeSize;
+        subtrees[i].end = subtrees[i].begin + subtreeSize < manifest->entryCount
+                          ? subtrees[i].begin + subtreeSize
+                          : manifest->entryCount;
+    }
+    /* the first subtree is reduced by the calling thread, and so is every subtree whose thread cannot be created */
+    for (i = 1; i < subtreeCount; i++) {
+        if (pthread_create(&subtrees[i].thread, NULL, tarManifestReduceSubtree, &subtrees[i]) != 0) {
+            break;
+        }
+        started++;
+    }
+    tarManifestReduceSubtree(&subtrees[0]);
+    for (i = 1 + started; i < subtreeCount; i++) {
+        tarManifestReduceSubtree(&subtrees[i]);
+    }
+    for (i = 1; i <= started; i++) {
+        pthread_join(subtrees[i].thread, NULL);
+    }
+
+    for (i = 1; i < subtreeCount; i++) {
+        memcpy(nodes[i], nodes[subtrees[i].begin], SHA256_DIGEST_LENGTH);
+    }
+    tarManifestReduce(nodes, subtreeCount);
+    memcpy(root, nodes[0], SHA256_DIGEST_LENGTH);
+    free(nodes);
+    return EXECUTION_OK;
+}
+
+short int tarManifestEncode(const struct TarManifest *manifest,
+                            unsigned char **data,
+                            size_t *dataLength)
+{
+    unsigned char root[SHA256_DIGEST_LENGTH];
+    char hex[2 * SHA256_DIGEST_LENGTH + 1];
+    size_t capacity;
+    size_t length;
+    char *text;
+    size_t i;
+
+    if (tarManifestRoot(manifest, root) != EXECUTION_OK) {
+        return ERROR_STORAGE_FAILURE;
+    }
+    /* a line holds two numbers of at most 20 digits, a digest, three separators, the name and LF */
+    capacity = 128 + 2 * SHA256_DIGEST_LENGTH + manifest->entryCount * (44 + 2 * SHA256_DIGEST_LENGTH)
+               + manifest->namesLength;
+    text = malloc(capacity);
+    if (text == NULL) {
+        return ERROR_STORAGE_FAILURE;
+    }
+    tarManifestHex(root, hex);
+    length = (size_t) snprintf(text, capacity, "SHA-256 manifest 1\nroot %s\nentries %zu\n", hex,
+                               manifest->entryCount);
+    for (i = 0; i < manifest->entryCount; i++) {
+        const struct TarManifestEntry *entry = &manifest->entries[i];
+
+        tarManifestHex(entry->digest, hex);
+        length += (size_t) snprintf(text + length, capacity - length, "%llu %llu %s %.*s\n",
+                                    (unsigned long long) entry->offset, (unsigned long long) entry->length, hex,
+                                    (int) entry->nameLength, manifest->names + entry->nameOffset);
+    }
+    *data = (unsigned char *) text;
+    *dataLength = length;
+    return EXECUTION_OK;
+}
+
+void tarManifestFree(struct TarManifest *manifest)
+{
+    free(manifest->entries);
+    free(manifest->names);
+    memset(manifest, 0, sizeof *manifest);
+}
@@ -0,0 +1,129 @@
+#ifndef SEAPI_BACKEND_TAR_MANIFEST_H
+#define SEAPI_BACKEND_TAR_MANIFEST_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "../Exception.h"
+#include "../Constant.h"
+#include "Sha256.h"
+
+/**
+ * This header file defines the integrity manifest that a TAR writer can append to an export archive as its last
+ * file. The manifest lists every file of the archive before it with the offset and the length of its content within
+ * the archive and the SHA-256 digest of the content, and the root of a Merkle tree over these files, so that a
+ * consumer can verify a single log message by reading the manifest and the range of that file only, and can skip
+ * the ranges whose digests are unchanged since an earlier download.
+ *
+ * The manifest is a text file with lines terminated by LF:
+ *
+ *     SHA-256 manifest 1
+ *     root <digest>
+ *     entries <count>
+ *     <offset> <length> <digest> <name>
+ *     ...
+ *
+ * with the offsets and lengths in decimal, the digests in lowercase hexadecimal and one line per file in the order
+ * of the archive. The Merkle tree is the tree of RFC 6962: the leaf of a file is SHA-256(0x00 || digest || name),
+ * an inner node is SHA-256(0x01 || left || right), and the root of an empty archive is the digest of the empty
+ * string. The digests of the log messages are calculated by the threads that scan the segments of an export, the
+ * tree is reduced by up to threadCount threads in subtrees of equal size.
+ */
+
+/**
+ * Name of the manifest within the archive
+ */
+#define TAR_MANIFEST_NAME "Manifest_SHA-256.txt"
+
+/**
+ * Minimum number of files per thread that reduces a subtree of the Merkle tree
+ */
+#define TAR_MANIFEST_PARALLEL_ENTRIES 4096
+
+/**
+ * File listed in a manifest. The name is stored in the name pool of the manifest.
+ */
+struct TarManifestEntry {
+    uint64_t offset;
+    uint64_t length;
+    size_t nameOffset;
+    size_t nameLength;
+    unsigned char digest[SHA256_DIGEST_LENGTH];
+};
+
+/**
+ * State of a manifest. The members are managed by the functions of this header file.
+ */
+struct TarManifest {
+    struct TarManifestEntry *entries;
+    size_t entryCount;
+    size_t entryCapacity;
+    char *names;
+    size_t namesLength;
+    size_t namesCapacity;
+    unsigned int threadCount;
+};
+
+/**
+ * Initializes an empty manifest.
+ * @param[out] manifest
+ *                manifest to be initialized [REQUIRED]
+ * @param[in] threadCount
+ *                maximum number of threads that reduce the Merkle tree, 0 for the calling thread only [REQUIRED]
+ */
+void tarManifestInit(struct TarManifest *manifest,
+                     unsigned int threadCount);
+
+/**
+ * Adds a file to a manifest.
+ * @param[in] manifest
+ *                initialized manifest [REQUIRED]
+ * @param[in] name
+ *                name of the file within the archive [REQUIRED]
+ * @param[in] offset
+ *                offset of the content of the file within the archive [REQUIRED]
+ * @param[in] length
+ *                length of the content [REQUIRED]
+ * @param[in] digest
+ *                SHA-256 digest of the content [REQUIRED]
+ * @return EXECUTION_OK or ERROR_STORAGE_FAILURE if no memory could be allocated
+ */
+short int tarManifestAdd(struct TarManifest *manifest,
+                         const char *name,
+                         uint64_t offset,
+                         uint64_t length,
+                         const unsigned char *digest);
+
+/**
+ * Calculates the root of the Merkle tree over the files of a manifest.
+ * @param[in] manifest
+ *                initialized manifest [REQUIRED]
+ * @param[out] root
+ *                array of SHA256_DIGEST_LENGTH bytes that receives the root [REQUIRED]
+ * @return EXECUTION_OK or ERROR_STORAGE_FAILURE if no memory could be allocated
+ */
+short int tarManifestRoot(const struct TarManifest *manifest,
+                          unsigned char *root);
+
+/**
+ * Encodes a manifest as the content of the file TAR_MANIFEST_NAME.
+ * @param[in] manifest
+ *                initialized manifest [REQUIRED]
+ * @param[out] data
+ *                receives the content, which is released with free [REQUIRED]
+ * @param[out] dataLength
+ *                receives the length of the content [REQUIRED]
+ * @return EXECUTION_OK or ERROR_STORAGE_FAILURE if no memory could be allocated
+ */
+short int tarManifestEncode(const struct TarManifest *manifest,
+                            unsigned char **data,
+                            size_t *dataLength);
+
+/**
+ * Releases the memory of a manifest.
+ * @param[in] manifest
+ *                initialized manifest [REQUIRED]
+ */
+void tarManifestFree(struct TarManifest *manifest);
+
+#endif
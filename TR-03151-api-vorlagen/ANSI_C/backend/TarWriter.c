@@ -0,0 +1,257 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "TarWriter.h"
+
+/**
+ * Layout of a ustar header block
+ */
+struct TarHeader {
+    char name[100];
+    char mode[8];
+    char uid[8];
+    char gid[8];
+    char size[12];
+    char mtime[12];
+    char checksum[8];
+    char typeflag;
+    char linkname[100];
+    char magic[6];
+    char version[2];
+    char uname[32];
+    char gname[32];
+    char devmajor[8];
+    char devminor[8];
+    char prefix[155];
+    char padding[12];
+};
+
+static short int tarWriterFlush(struct TarWriter *writer)
+{
+    if (writer->result == EXECUTION_OK && writer->bufferFill > 0) {
+        writer->result = writer->sink(writer->sinkContext, writer->buffer, writer->bufferFill);
+    }
+    writer->bufferFill = 0;
+    return writer->result;
+}
+
+static short int tarWriterPut(struct TarWriter *writer,
+                              const unsigned char *data,
+                              uint64_t dataLength)
+{
+    while (dataLength > 0 && writer->result == EXECUTION_OK) {
+        size_t chunk = TAR_WRITER_BUFFER_SIZE - writer->bufferFill;
+
+        if (chunk > dataLength) {
+            chunk = (size_t) dataLength;
+        }
+        if (data != NULL) {
+            memcpy(writer->buffer + writer->bufferFill, data, chunk);
+            data += chunk;
+        } else {
+            memset(writer->buffer + writer->bufferFill, 0, chunk);
+        }
+        writer->bufferFill += chunk;
+        writer->bytesWritten += chunk;
+        dataLength -= chunk;
+        if (writer->bufferFill == TAR_WRITER_BUFFER_SIZE) {
+            tarWriterFlush(writer);
+        }
+    }
+    return writer->result;
+}
+
+static short int tarWriterPutPadded(struct TarWriter *writer,
+                                    const unsigned char *data,
+                                    uint64_t dataLength)
+{
+    uint64_t remainder = dataLength % TAR_BLOCK_SIZE;
+
+    tarWriterPut(writer, data, dataLength);
+    if (remainder != 0) {
+        tarWriterPut(writer, NULL, TAR_BLOCK_SIZE - remainder);
+    }
+    return writer->result;
+}
+
+static void tarFormatOctal(char *field,
+                           size_t fieldSize,
+                           uint64_t value)
+{
+    /* the field is terminated by NUL and filled with leading zeros */
+    field[fieldSize - 1] = '\0';
+    while (fieldSize-- > 1) {
+        field[fieldSize - 1] = (char) ('0' + (value & 7u));
+        value >>= 3;
+    }
+}
+
+static short int tarWriterPutHeader(struct TarWriter *writer,
+                                    const char *name,
+                                    char typeflag,
+                                    uint64_t size,
+                                    int64_t modificationTime)
+{
+    struct TarHeader header;
+    const unsigned char *bytes = (const unsigned char *) &header;
+    unsigned int checksum = 0;
+    size_t i;
+
+    memset(&header, 0, sizeof header);
+    strncpy(header.name, name, sizeof header.name - 1);
+    tarFormatOctal(header.mode, sizeof header.mode, 0644);
+    tarFormatOctal(header.uid, sizeof header.uid, 0);
+    tarFormatOctal(header.gid, sizeof header.gid, 0);
+    tarFormatOctal(header.size, sizeof header.size, size);
+    tarFormatOctal(header.mtime, sizeof header.mtime, modificationTime > 0 ? (uint64_t) modificationTime : 0);
+    header.typeflag = typeflag;
+    memcpy(header.magic, "ustar", 6);
+    memcpy(header.version, "00", 2);
+
+    memset(header.checksum, ' ', sizeof header.checksum);
+    for (i = 0; i < sizeof header; i++) {
+        checksum += bytes[i];
+    }
+    tarFormatOctal(header.checksum, sizeof header.checksum - 1, checksum);
+    header.checksum[7] = ' ';
+
+    return tarWriterPut(writer, bytes, sizeof header);
+}
+
+/**
+ * Calculates the digest of the content of a file, which consists of zeros if no data is passed.
+ */
+static void tarWriterDigest(const unsigned char *data,
+                            uint64_t dataLength,
+                            unsigned char *digest)
+{
+    static const unsigned char zeros[TAR_BLOCK_SIZE];
+    struct Sha256Context context;
+
+    sha256Init(&context);
+    if (data != NULL) {
+        sha256Update(&context, data, (size_t) dataLength);
+    } else {
+        while (dataLength > 0) {
+            size_t chunk = dataLength < sizeof zeros ? (size_t) dataLength : sizeof zeros;
+
+            sha256Update(&context, zeros, chunk);
+            dataLength -= chunk;
+        }
+    }
+    sha256Final(&context, digest);
+}
+
+void tarWriterInit(struct TarWriter *writer,
+                   TarSink sink,
+                   void *sinkContext)
+{
+    writer->sink = sink;
+    writer->sinkContext = sinkContext;
+    writer->bufferFill = 0;
+    writer->entryCount = 0;
+    writer->bytesWritten = 0;
+    writer->manifest = NULL;
+    writer->result = EXECUTION_OK;
+}
+
+void tarWriterAttachManifest(struct TarWriter *writer,
+                             struct TarManifest *manifest)
+{
+    writer->manifest = manifest;
+}
+
+short int tarWriterAddFile(struct TarWriter *writer,
+                           const char *name,
+                           const unsigned char *data,
+                           uint64_t dataLength,
+                           int64_t modificationTime)
+{
+    return tarWriterAddDigestedFile(writer, name, data, dataLength, modificationTime, NULL);
+}
+
+short int tarWriterAddDigestedFile(struct TarWriter *writer,
+                                   const char *name,
+                                   const unsigned char *data,
+                                   uint64_t dataLength,
+                                   int64_t modificationTime,
+                                   const unsigned char *digest)
+{
+    unsigned char calculated[SHA256_DIGEST_LENGTH];
+    size_t nameLength = strlen(name);
+
+    if (nameLength >= sizeof(((struct TarHeader *) 0)->name)) {
+        /* pax record "<length> path=<name>\n", where the length includes its own digits */
+        char record[1024];
+        size_t recordLength = nameLength + 8;
+        int written;
+
+        for (;;) {
+            written = snprintf(record, sizeof record, "%zu path=%s\n", recordLength, name);
+            if (written < 0 || (size_t) written >= sizeof record) {
+                return ERROR_PARAMETER_MISMATCH;
+            }
+            if ((size_t) written == recordLength) {
+                break;
+            }
+            recordLength = (size_t) written;
+        }
+        tarWriterPutHeader(writer, "PaxHeader", 'x', recordLength, modificationTime);
+        tarWriterPutPadded(writer, (const unsigned char *) record, recordLength);
+    }
+
+    tarWriterPutHeader(writer, name, '0', dataLength, modificationTime);
+    if (writer->manifest != NULL && writer->result == EXECUTION_OK) {
+        if (digest == NULL) {
+            tarWriterDigest(data, dataLength, calculated);
+            digest = calculated;
+        }
+        writer->result = tarManifestAdd(writer->manifest, name, writer->bytesWritten, dataLength, digest);
+    }
+    tarWriterPutPadded(writer, data, dataLength);
+    writer->entryCount++;
+    return writer->result;
+}
+
+short int tarWriterFinish(struct TarWriter *writer)
+{
+    if (writer->manifest != NULL && writer->result == EXECUTION_OK) {
+        unsigned char *manifest;
+        size_t manifestLength;
+
+        writer->result = tarManifestEncode(writer->manifest, &manifest, &manifestLength);
+        writer->manifest = NULL;
+        if (writer->result == EXECUTION_OK) {
+            tarWriterAddFile(writer, TAR_MANIFEST_NAME, manifest, manifestLength, 0);
+            free(manifest);
+        }
+    }
+    tarWriterPut(writer, NULL, 2 * TAR_BLOCK_SIZE);
+    return tarWriterFlush(writer);
+}
+
+short int tarMemorySinkWrite(void *sinkContext,
+                             const unsigned char *data,
+                             size_t dataLength)
+{
+    struct TarMemorySink *sink = (struct TarMemorySink *) sinkContext;
+
+    if (sink->length + dataLength > sink->capacity) {
+        size_t capacity = sink->capacity != 0 ? sink->capacity : TAR_WRITER_BUFFER_SIZE;
+        unsigned char *grown;
+
+        while (capacity < sink->length + dataLength) {
+            capacity *= 2;
+        }
+        grown = realloc(sink->data, capacity);
+        if (grown == NULL) {
+            return ERROR_STORAGE_FAILURE;
+        }
+        sink->data = grown;
+        sink->capacity = capacity;
+    }
+    memcpy(sink->data + sink->length, data, dataLength);
+    sink->length += dataLength;
+    return EXECUTION_OK;
+}
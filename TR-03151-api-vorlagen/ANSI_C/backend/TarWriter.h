@@ -0,0 +1,151 @@
+#ifndef SEAPI_BACKEND_TAR_WRITER_H
+#define SEAPI_BACKEND_TAR_WRITER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "../Exception.h"
+#include "../Constant.h"
+#include "TarManifest.h"
+
+/**
+ * This header file defines the writer for the TAR archives that are created by the export functions of the SE API.
+ * The archive is produced as a stream and passed to a sink in blocks, so that an export never needs to hold the
+ * complete archive or the complete list of selected log messages.
+ *
+ * If a manifest (see TarManifest.h) is attached to a writer, every added file is listed in it and tarWriterFinish
+ * appends it as the last file of the archive. The digest of a file is calculated by the writer unless the caller
+ * passes it to tarWriterAddDigestedFile, e.g. from the thread that has read the file.
+ */
+
+/**
+ * Size of the blocks of a TAR archive and of the output buffer of the writer
+ */
+#define TAR_BLOCK_SIZE 512
+#define TAR_WRITER_BUFFER_SIZE (64u * 1024u)
+
+/**
+ * Callback that receives the bytes of the archive in order.
+ * @param[in] sinkContext
+ *                context that has been passed to tarWriterInit [OPTIONAL]
+ * @param[in] data
+ *                next bytes of the archive [REQUIRED]
+ * @param[in] dataLength
+ *                length of the array that represents the data [REQUIRED]
+ * @return EXECUTION_OK or an error code that aborts the export
+ */
+typedef short int (*TarSink)(void *sinkContext,
+                             const unsigned char *data,
+                             size_t dataLength);
+
+/**
+ * State of a TAR writer. The members are managed by the functions of this header file.
+ */
+struct TarWriter {
+    TarSink sink;
+    void *sinkContext;
+    unsigned char buffer[TAR_WRITER_BUFFER_SIZE];
+    size_t bufferFill;
+    uint64_t entryCount;
+    uint64_t bytesWritten;
+    struct TarManifest *manifest;
+    short int result;
+};
+
+/**
+ * Growable memory buffer that can be used as the sink of a TAR writer, e.g. for the output parameter exportedData
+ * of the export functions of the SE API.
+ */
+struct TarMemorySink {
+    unsigned char *data;
+    size_t length;
+    size_t capacity;
+};
+
+/**
+ * Initializes a writer.
+ * @param[out] writer
+ *                writer to be initialized [REQUIRED]
+ * @param[in] sink
+ *                callback that receives the archive [REQUIRED]
+ * @param[in] sinkContext
+ *                context passed to the sink [OPTIONAL]
+ */
+void tarWriterInit(struct TarWriter *writer,
+                   TarSink sink,
+                   void *sinkContext);
+
+/**
+ * Appends a file to the archive. Names longer than the ustar name field are stored in a pax extended header.
+ * @param[in] writer
+ *                initialized writer [REQUIRED]
+ * @param[in] name
+ *                name of the file within the archive [REQUIRED]
+ * @param[in] data
+ *                content of the file [OPTIONAL]
+ * @param[in] dataLength
+ *                length of the content [REQUIRED]
+ * @param[in] modificationTime
+ *                modification time of the file in seconds since the epoch [REQUIRED]
+ * @return EXECUTION_OK or the error code returned by the sink
+ */
+short int tarWriterAddFile(struct TarWriter *writer,
+                           const char *name,
+                           const unsigned char *data,
+                           uint64_t dataLength,
+                           int64_t modificationTime);
+
+/**
+ * Appends a file whose SHA-256 digest has already been calculated to the archive.
+ * @param[in] writer
+ *                initialized writer [REQUIRED]
+ * @param[in] name
+ *                name of the file within the archive [REQUIRED]
+ * @param[in] data
+ *                content of the file [OPTIONAL]
+ * @param[in] dataLength
+ *                length of the content [REQUIRED]
+ * @param[in] modificationTime
+ *                modification time of the file in seconds since the epoch [REQUIRED]
+ * @param[in] digest
+ *                SHA-256 digest of the content, calculated by the writer if NULL and a manifest is attached
+ *                [OPTIONAL]
+ * @return EXECUTION_OK, ERROR_STORAGE_FAILURE if the file could not be added to the manifest or the error code
+ *         returned by the sink
+ */
+short int tarWriterAddDigestedFile(struct TarWriter *writer,
+                                   const char *name,
+                                   const unsigned char *data,
+                                   uint64_t dataLength,
+                                   int64_t modificationTime,
+                                   const unsigned char *digest);
+
+/**
+ * Attaches a manifest to a writer before its first file is added. The manifest MUST stay initialized until the
+ * writer has been finished and is released by the caller.
+ * @param[in] writer
+ *                initialized writer [REQUIRED]
+ * @param[in] manifest
+ *                initialized, empty manifest [REQUIRED]
+ */
+void tarWriterAttachManifest(struct TarWriter *writer,
+                             struct TarManifest *manifest);
+
+/**
+ * Appends the attached manifest, writes the end-of-archive marker and passes the remaining buffered bytes to the
+ * sink.
+ * @param[in] writer
+ *                initialized writer [REQUIRED]
+ * @return EXECUTION_OK, ERROR_STORAGE_FAILURE if the manifest could not be encoded or the error code returned by the
+ *         sink
+ */
+short int tarWriterFinish(struct TarWriter *writer);
+
+/**
+ * Implementation of TarSink that appends to a TarMemorySink. The sinkContext is the memory sink.
+ */
+short int tarMemorySinkWrite(void *sinkContext,
+                             const unsigned char *data,
+                             size_t dataLength);
+
+#endif
@@ -0,0 +1,332 @@
+#include <errno.h>
+#include <ftw.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#include "TenantHost.h"
+
+/**
+ * Initial number of buckets of the tenant table
+ */
+#define TENANT_HOST_INITIAL_BUCKETS 64
+
+static uint64_t tenantHostHash(const char *tenantId,
+                               size_t tenantIdLength)
+{
+    uint64_t hash = 1469598103934665603ull;
+    size_t i;
+
+    for (i = 0; i < tenantIdLength; i++) {
+        hash ^= (unsigned char) tenantId[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+/**
+ * Checks that a tenant ID can be used as the name of a subdirectory.
+ */
+static bool tenantHostValidId(const char *tenantId,
+                              uint64_t tenantIdLength)
+{
+    uint64_t i;
+
+    if (tenantId == NULL || tenantIdLength == 0 || tenantIdLength > TENANT_ID_MAX) {
+        return false;
+    }
+    for (i = 0; i < tenantIdLength; i++) {
+        char c = tenantId[i];
+        bool alphanumeric = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9');
+
+        if (!alphanumeric && (i == 0 || (c != '-' && c != '_' && c != '.'))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Returns the link that refers to the entry of a tenant or to the end of its chain. The lock MUST be held.
+ */
+static struct Tenant **tenantHostFind(struct TenantHost *host,
+                                      const char *tenantId,
+                                      size_t tenantIdLength)
+{
+    struct Tenant **link = &host->table[tenantHostHash(tenantId, tenantIdLength) & host->tableMask];
+
+    while (*link != NULL
+           && ((*link)->idLength != tenantIdLength || memcmp((*link)->id, tenantId, tenantIdLength) != 0)) {
+        link = &(*link)->next;
+    }
+    return link;
+}
+
+/**
+ * Doubles the number of buckets. The lock MUST be held. The table keeps its size if no memory is available.
+ */
+static void tenantHostGrow(struct TenantHost *host)
+{
+    size_t bucketCount = 2 * (host->tableMask + 1);
+    struct Tenant **table = calloc(bucketCount, sizeof *table);
+    size_t i;
+
+    if (table == NULL) {
+        return;
+    }
+    for (i = 0; i <= host->tableMask; i++) {
+        while (host->table[i] != NULL) {
+            struct Tenant *tenant = host->table[i];
+            size_t bucket = tenantHostHash(tenant->id, tenant->idLength) & (bucketCount - 1);
+
+            host->table[i] = tenant->next;
+            tenant->next = table[bucket];
+            table[bucket] = tenant;
+        }
+    }
+    free(host->table);
+    host->table = table;
+    host->tableMask = bucketCount - 1;
+}
+
+static int tenantHostRemoveEntry(const char *path,
+                                 const struct stat *status,
+                                 int type,
+                                 struct FTW *position)
+{
+    (void) status;
+    (void) type;
+    (void) position;
+    return remove(path);
+}
+
+/**
+ * Creates the directory of a new tenant together with the description set by the manufacturer. The directory is
+ * prepared under a name that is no valid tenant ID and renamed when it is complete, so that a failed attach leaves
+ * no tenant behind whose description is missing.
+ */
+static short int tenantHostCreate(const char *path,
+                                  const unsigned char *description,
+                                  uint64_t descriptionLength)
+{
+    char staging[4096];
+    const char *name = strrchr(path, '/') + 1;
+    int length;
+    short int result = EXECUTION_OK;
+
+    length = snprintf(staging, sizeof staging, "%.*s.%s.new", (int) (name - path), path, name);
+    if (length < 0 || (size_t) length >= sizeof staging) {
+        return ERROR_PARAMETER_MISMATCH;
+    }
+    /* a staging directory is left behind by an attach that has been interrupted */
+    nftw(staging, tenantHostRemoveEntry, 8, FTW_DEPTH | FTW_PHYS);
+    if (mkdir(staging, 0700) != 0) {
+        return ERROR_STORAGE_FAILURE;
+    }
+    if (description != NULL) {
+        result = seDescriptionSetByManufacturer(staging, description, (size_t) descriptionLength);
+    }
+    if (result == EXECUTION_OK && rename(staging, path) != 0) {
+        result = ERROR_STORAGE_FAILURE;
+    }
+    if (result != EXECUTION_OK) {
+        nftw(staging, tenantHostRemoveEntry, 8, FTW_DEPTH | FTW_PHYS);
+    }
+    return result;
+}
+
+short int tenantHostOpen(const char *directory,
+                         uint64_t memoryQuota,
+                         uint64_t bytesPerSecond,
+                         uint32_t cpuPermille,
+                         uint64_t latencyBound,
+                         int64_t *results)
+{
+    struct TenantHost *host;
+    struct ExportBudget budget;
+    short int result;
+
+    if (directory == NULL || results == NULL) {
+        return ERROR_PARAMETER_MISMATCH;
+    }
+    host = calloc(1, sizeof *host);
+    if (host == NULL) {
+        return ERROR_STORAGE_FAILURE;
+    }
+    host->directory = strdup(directory);
+    host->table = calloc(TENANT_HOST_INITIAL_BUCKETS, sizeof *host->table);
+    if (host->directory == NULL || host->table == NULL) {
+        free(host->table);
+        free(host->directory);
+        free(host);
+        return ERROR_STORAGE_FAILURE;
+    }
+    host->tableMask = TENANT_HOST_INITIAL_BUCKETS - 1;
+
+    budget.bytesPerSecond = bytesPerSecond;
+    budget.cpuPermille = cpuPermille;
+    budget.latencyBound = latencyBound;
+    result = storageIoInit(&host->io, PROFILE_STORAGE_BACKEND, PROFILE_REGISTERED_BUFFERS, SEGMENT_READER_BUFFER_SIZE);
+    if (result == EXECUTION_OK) {
+        result = segmentRetirerStart(&host->retirer, NULL, 0);
+        if (result == EXECUTION_OK) {
+            result = exportSchedulerStart(&host->exportScheduler, seApiBindingExecuteExport, NULL, &budget);
+            if (result != EXECUTION_OK) {
+                segmentRetirerStop(&host->retirer);
+            }
+        }
+        if (result != EXECUTION_OK) {
+            storageIoFree(&host->io);
+        }
+    }
+    if (result != EXECUTION_OK) {
+        free(host->table);
+        free(host->directory);
+        free(host);
+        return result;
+    }
+
+    host->shared.io = &host->io;
+    host->shared.retirer = &host->retirer;
+    host->shared.exportScheduler = &host->exportScheduler;
+    transactionTraceInit(&host->trace);
+    host->shared.trace = &host->trace;
+    host->shared.memoryQuota = memoryQuota != 0 ? memoryQuota : TENANT_HOST_DEFAULT_MEMORY_QUOTA;
+    pthread_mutex_init(&host->lock, NULL);
+    pthread_cond_init(&host->opened, NULL);
+    results[0] = (int64_t) (intptr_t) host;
+    return EXECUTION_OK;
+}
+
+short int tenantHostAttach(struct TenantHost *host,
+                           const char *tenantId,
+                           uint64_t tenantIdLength,
+                           const unsigned char *description,
+                           uint64_t descriptionLength,
+                           int64_t *results)
+{
+    char path[4096];
+    struct Tenant **link;
+    struct Tenant *tenant;
+    struct stat status;
+    int64_t bindingResults[1];
+    int length;
+    short int result = EXECUTION_OK;
+
+    if (!tenantHostValidId(tenantId, tenantIdLength) || descriptionLength > SE_DESCRIPTION_MAX) {
+        return ERROR_PARAMETER_MISMATCH;
+    }
+    length = snprintf(path, sizeof path, "%s/%.*s", host->directory, (int) tenantIdLength, tenantId);
+    if (length < 0 || (size_t) length >= sizeof path) {
+        return ERROR_PARAMETER_MISMATCH;
+    }
+
+    pthread_mutex_lock(&host->lock);
+    link = tenantHostFind(host, tenantId, (size_t) tenantIdLength);
+    while (*link != NULL && (*link)->binding == NULL) {
+        pthread_cond_wait(&host->opened, &host->lock);
+        link = tenantHostFind(host, tenantId, (size_t) tenantIdLength);
+    }
+    if (*link != NULL) {
+        results[0] = (int64_t) (intptr_t) (*link)->binding;
+        pthread_mutex_unlock(&host->lock);
+        return EXECUTION_OK;
+    }
+    tenant = calloc(1, sizeof *tenant);
+    if (tenant == NULL) {
+        pthread_mutex_unlock(&host->lock);
+        return ERROR_STORAGE_FAILURE;
+    }
+    /* the entry without a backend keeps a concurrent attach of the tenant from opening its directory a second time */
+    tenant->idLength = (size_t) tenantIdLength;
+    memcpy(tenant->id, tenantId, (size_t) tenantIdLength);
+    *link = tenant;
+    if (++host->tenantCount > host->tableMask + 1) {
+        tenantHostGrow(host);
+    }
+    pthread_mutex_unlock(&host->lock);
+
+    if (stat(path, &status) != 0) {
+        result = errno == ENOENT ? tenantHostCreate(path, description, descriptionLength) : ERROR_STORAGE_FAILURE;
+    }
+    if (result == EXECUTION_OK) {
+        result = seApiBindingOpenShared(path, &host->shared, bindingResults);
+    }
+
+    pthread_mutex_lock(&host->lock);
+    if (result == EXECUTION_OK) {
+        tenant->binding = (struct SeApiBinding *) (intptr_t) bindingResults[0];
+        results[0] = bindingResults[0];
+    } else {
+        link = tenantHostFind(host, tenantId, (size_t) tenantIdLength);
+        *link = tenant->next;
+        host->tenantCount--;
+    }
+    pthread_cond_broadcast(&host->opened);
+    pthread_mutex_unlock(&host->lock);
+    if (result != EXECUTION_OK) {
+        free(tenant);
+    }
+    return result;
+}
+
+short int tenantHostDetach(struct TenantHost *host,
+                           const char *tenantId,
+                           uint64_t tenantIdLength)
+{
+    struct Tenant **link;
+    struct Tenant *tenant;
+    short int result;
+
+    if (!tenantHostValidId(tenantId, tenantIdLength)) {
+        return ERROR_ID_NOT_FOUND;
+    }
+    pthread_mutex_lock(&host->lock);
+    link = tenantHostFind(host, tenantId, (size_t) tenantIdLength);
+    while (*link != NULL && (*link)->binding == NULL) {
+        pthread_cond_wait(&host->opened, &host->lock);
+        link = tenantHostFind(host, tenantId, (size_t) tenantIdLength);
+    }
+    tenant = *link;
+    if (tenant != NULL) {
+        *link = tenant->next;
+        host->tenantCount--;
+    }
+    pthread_mutex_unlock(&host->lock);
+    if (tenant == NULL) {
+        return ERROR_ID_NOT_FOUND;
+    }
+    result = seApiBindingClose(tenant->binding);
+    free(tenant);
+    return result;
+}
+
+short int tenantHostClose(struct TenantHost *host)
+{
+    short int result = EXECUTION_OK;
+    size_t i;
+
+    for (i = 0; i <= host->tableMask; i++) {
+        while (host->table[i] != NULL) {
+            struct Tenant *tenant = host->table[i];
+            short int closeResult = seApiBindingClose(tenant->binding);
+
+            if (closeResult != EXECUTION_OK && result == EXECUTION_OK) {
+                result = closeResult;
+            }
+            host->table[i] = tenant->next;
+            free(tenant);
+        }
+    }
+    exportSchedulerStop(&host->exportScheduler);
+    segmentRetirerStop(&host->retirer);
+    storageIoFree(&host->io);
+    transactionTraceClose(&host->trace);
+    pthread_cond_destroy(&host->opened);
+    pthread_mutex_destroy(&host->lock);
+    free(host->table);
+    free(host->directory);
+    free(host);
+    return result;
+}
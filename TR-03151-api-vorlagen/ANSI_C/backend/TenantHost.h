@@ -0,0 +1,165 @@
+#ifndef SEAPI_BACKEND_TENANT_HOST_H
+#define SEAPI_BACKEND_TENANT_HOST_H
+
+#include <pthread.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "../Exception.h"
+#include "../Constant.h"
+#include "ExportScheduler.h"
+#include "Profile.h"
+#include "SeApiBinding.h"
+#include "SegmentRetirer.h"
+#include "StorageIo.h"
+#include "TransactionTrace.h"
+
+#if !PROFILE_CONCURRENT
+#error "the tenant host requires the server build profile"
+#endif
+
+/**
+ * This header file defines the tenant host, which serves many logical SE APIs in one process, e.g. one per store of
+ * a cloud deployment, instead of one process per SE API.
+ *
+ * Every tenant is a backend (see SeApiBinding.h) in its own subdirectory of the directory of the host, which is
+ * named by the tenant ID and holds its log store, counters, users, receipt code key and description. The functions
+ * of SeApiBinding.h are invoked with the address of the backend returned by tenantHostAttach.
+ *
+ * The backends share the resources of the host instead of creating their own: the storage backend, so that the
+ * io_uring and its registered buffers exist once per process; one retirer thread, which retires the stores of the
+ * tenants one after another in the order of their deleteStoredData requests; and one export scheduler, in which
+ * every tenant has at most one export, so that the exports of the tenants are run in turn and share the I/O and CPU
+ * budgets of the host. The memory of every backend is limited by a quota: while the backend, its open transactions
+ * and the index of its segments reach the quota, startTransaction of the tenant fails with
+ * ERROR_START_TRANSACTION_FAILED, so that a tenant cannot take the memory of the others. The tenants also share
+ * one trace of the transaction functions, in which every tenant is a source named after its subdirectory.
+ */
+
+/**
+ * Maximum length of a tenant ID
+ */
+#define TENANT_ID_MAX 64
+
+/**
+ * Default memory quota of a tenant in bytes
+ */
+#define TENANT_HOST_DEFAULT_MEMORY_QUOTA (4ul * 1024ul * 1024ul)
+
+/**
+ * Attached tenant. The member binding is NULL while the backend is opened by tenantHostAttach.
+ */
+struct Tenant {
+    struct Tenant *next;
+    struct SeApiBinding *binding;
+    size_t idLength;
+    char id[TENANT_ID_MAX + 1];
+};
+
+/**
+ * State of a tenant host. The members are managed by the functions of this header file; the members after lock
+ * MUST only be accessed while holding it.
+ */
+struct TenantHost {
+    char *directory;
+    struct StorageIo io;
+    struct SegmentRetirer retirer;
+    struct ExportScheduler exportScheduler;
+    struct TransactionTrace trace;
+    struct SeApiBindingShared shared;
+    pthread_mutex_t lock;
+    pthread_cond_t opened;
+    struct Tenant **table;
+    size_t tableMask;
+    size_t tenantCount;
+};
+
+/**
+ * Opens a tenant host in a directory and starts its shared resources.
+ * @param[in] directory
+ *                existing directory that holds the subdirectories of the tenants, terminated by NUL [REQUIRED]
+ * @param[in] memoryQuota
+ *                memory quota of every tenant in bytes, 0 selects the default [REQUIRED]
+ * @param[in] bytesPerSecond
+ *                I/O budget of the exports of all tenants, 0 selects the default [REQUIRED]
+ * @param[in] cpuPermille
+ *                CPU budget of the exports of all tenants in thousandths of a core, 0 selects the default [REQUIRED]
+ * @param[in] latencyBound
+ *                bound of the 99th percentile of the latency of the transaction functions of all tenants in
+ *                nanoseconds, 0 selects the default [REQUIRED]
+ * @param[out] results
+ *                receives the address of the opened host at index 0 [REQUIRED]
+ * @return EXECUTION_OK, ERROR_PARAMETER_MISMATCH if a required parameter is missing or the return values of
+ *         storageIoInit, segmentRetirerStart and exportSchedulerStart
+ */
+short int tenantHostOpen(const char *directory,
+                         uint64_t memoryQuota,
+                         uint64_t bytesPerSecond,
+                         uint32_t cpuPermille,
+                         uint64_t latencyBound,
+                         int64_t *results);
+
+/**
+ * Opens the backend of a tenant, whose subdirectory is created if the tenant is new. If the tenant is already
+ * attached, its backend is returned. The backend is opened without holding the lock of the host, so that the
+ * tenants that are already attached are not delayed by the recovery of its store; a concurrent attach of the same
+ * tenant waits until the backend has been opened.
+ * @param[in] host
+ *                opened host [REQUIRED]
+ * @param[in] tenantId
+ *                ID of the tenant of at most TENANT_ID_MAX letters, digits, '-', '_' and '.', starting with a letter
+ *                or a digit [REQUIRED]
+ * @param[in] tenantIdLength
+ *                the length of the array that represents the tenantId [REQUIRED]
+ * @param[in] description
+ *                description of the SE API of a new tenant that is set by the manufacturer, ignored for an existing
+ *                tenant [OPTIONAL]
+ * @param[in] descriptionLength
+ *                the length of the description [REQUIRED]
+ * @param[out] results
+ *                receives the address of the backend at index 0 [REQUIRED]
+ * @return if the execution of the function has been successful, the return value EXECUTION_OK SHALL be returned.
+ *
+ *         If the execution of the function has failed, the appropriate error code SHALL be returned:
+ *
+ *             ERROR_PARAMETER_MISMATCH
+ *                the tenant ID or the description is invalid
+ *             ERROR_STORAGE_FAILURE
+ *                the subdirectory could not be created or no memory could be allocated
+ *             ERROR_STORING_INIT_DATA_FAILED
+ *                the description could not be stored
+ *
+ *         and the return values of seApiBindingOpenShared.
+ */
+short int tenantHostAttach(struct TenantHost *host,
+                           const char *tenantId,
+                           uint64_t tenantIdLength,
+                           const unsigned char *description,
+                           uint64_t descriptionLength,
+                           int64_t *results);
+
+/**
+ * Closes the backend of a tenant. Its exports MUST have been collected and no function MAY be invoked for it
+ * concurrently.
+ * @param[in] host
+ *                opened host [REQUIRED]
+ * @param[in] tenantId
+ *                ID of the tenant [REQUIRED]
+ * @param[in] tenantIdLength
+ *                the length of the array that represents the tenantId [REQUIRED]
+ * @return ERROR_ID_NOT_FOUND if the tenant is not attached or the return values of seApiBindingClose
+ */
+short int tenantHostDetach(struct TenantHost *host,
+                           const char *tenantId,
+                           uint64_t tenantIdLength);
+
+/**
+ * Closes the backends of all tenants, stops the shared resources and releases the memory of the host. The exports
+ * of all tenants MUST have been collected.
+ * @param[in] host
+ *                opened host [REQUIRED]
+ * @return EXECUTION_OK or the first error returned by seApiBindingClose
+ */
+short int tenantHostClose(struct TenantHost *host);
+
+#endif
@@ -0,0 +1,223 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "TimerWheel.h"
+
+#define TIMER_WHEEL_SLOT_MASK ((int64_t) TIMER_WHEEL_SLOTS - 1)
+
+static void timerWheelUnlink(struct TimerWheel *wheel,
+                             uint32_t index)
+{
+    struct TimerNode *node = &wheel->nodes[index];
+
+    if (node->list == TIMER_NODE_NONE) {
+        return;
+    }
+    if (node->previous != TIMER_NODE_NONE) {
+        wheel->nodes[node->previous].next = node->next;
+    } else {
+        wheel->heads[node->list] = node->next;
+    }
+    if (node->next != TIMER_NODE_NONE) {
+        wheel->nodes[node->next].previous = node->previous;
+    }
+    if (node->list == TIMER_WHEEL_EXPIRED) {
+        wheel->expiredCount--;
+    }
+    node->list = TIMER_NODE_NONE;
+    node->next = TIMER_NODE_NONE;
+    node->previous = TIMER_NODE_NONE;
+}
+
+static void timerWheelLink(struct TimerWheel *wheel,
+                           uint32_t index,
+                           uint32_t list)
+{
+    struct TimerNode *node = &wheel->nodes[index];
+
+    node->list = list;
+    node->previous = TIMER_NODE_NONE;
+    node->next = wheel->heads[list];
+    if (node->next != TIMER_NODE_NONE) {
+        wheel->nodes[node->next].previous = index;
+    }
+    wheel->heads[list] = index;
+    if (list == TIMER_WHEEL_EXPIRED) {
+        wheel->expiredCount++;
+    }
+}
+
+/**
+ * Links a node into the level whose range covers the distance to its deadline.
+ * Deadlines beyond the last level are kept in the last level and cascaded again when their slot comes up.
+ */
+static void timerWheelPlace(struct TimerWheel *wheel,
+                            uint32_t index)
+{
+    int64_t deadline = wheel->nodes[index].deadline;
+    int64_t delta = deadline - wheel->currentTime;
+    unsigned int level;
+
+    if (delta <= 0) {
+        timerWheelLink(wheel, index, TIMER_WHEEL_EXPIRED);
+        return;
+    }
+    for (level = 0; level + 1 < TIMER_WHEEL_LEVELS; level++) {
+        if (delta < ((int64_t) 1 << (TIMER_WHEEL_SLOT_BITS * (level + 1)))) {
+            break;
+        }
+    }
+    if (delta >= ((int64_t) 1 << (TIMER_WHEEL_SLOT_BITS * TIMER_WHEEL_LEVELS))) {
+        /* too far ahead: park in the slot that is visited last */
+        deadline = wheel->currentTime + ((int64_t) 1 << (TIMER_WHEEL_SLOT_BITS * TIMER_WHEEL_LEVELS)) - 1;
+    }
+    timerWheelLink(wheel, index,
+                   level * TIMER_WHEEL_SLOTS
+                   + (uint32_t) ((deadline >> (TIMER_WHEEL_SLOT_BITS * level)) & TIMER_WHEEL_SLOT_MASK));
+}
+
+static void timerWheelReplaceList(struct TimerWheel *wheel,
+                                  uint32_t list)
+{
+    uint32_t index = wheel->heads[list];
+
+    wheel->heads[list] = TIMER_NODE_NONE;
+    while (index != TIMER_NODE_NONE) {
+        uint32_t next = wheel->nodes[index].next;
+        wheel->nodes[index].list = TIMER_NODE_NONE;
+        timerWheelPlace(wheel, index);
+        index = next;
+    }
+}
+
+short int timerWheelInit(struct TimerWheel *wheel,
+                         int64_t now)
+{
+    unsigned int i;
+
+    memset(wheel, 0, sizeof *wheel);
+    for (i = 0; i <= TIMER_WHEEL_EXPIRED; i++) {
+        wheel->heads[i] = TIMER_NODE_NONE;
+    }
+    wheel->freeHead = TIMER_NODE_NONE;
+    wheel->currentTime = now;
+    return EXECUTION_OK;
+}
+
+void timerWheelFree(struct TimerWheel *wheel)
+{
+    free(wheel->nodes);
+    wheel->nodes = NULL;
+    wheel->nodeCapacity = 0;
+}
+
+short int timerWheelReserve(struct TimerWheel *wheel)
+{
+    if (wheel->freeHead == TIMER_NODE_NONE) {
+        uint32_t capacity = wheel->nodeCapacity != 0 ? wheel->nodeCapacity * 2 : 64;
+        struct TimerNode *nodes;
+        uint32_t i;
+
+        if (capacity >= TIMER_NODE_NONE) {
+            return ERROR_STORAGE_FAILURE;
+        }
+        nodes = realloc(wheel->nodes, capacity * sizeof *nodes);
+        if (nodes == NULL) {
+            return ERROR_STORAGE_FAILURE;
+        }
+        for (i = wheel->nodeCapacity; i < capacity; i++) {
+            nodes[i].list = TIMER_NODE_NONE;
+            nodes[i].next = i + 1 < capacity ? i + 1 : TIMER_NODE_NONE;
+        }
+        wheel->freeHead = wheel->nodeCapacity;
+        wheel->nodes = nodes;
+        wheel->nodeCapacity = capacity;
+    }
+    return EXECUTION_OK;
+}
+
+short int timerWheelAdd(struct TimerWheel *wheel,
+                        uint64_t key,
+                        int64_t deadline,
+                        uint32_t *node)
+{
+    uint32_t index;
+
+    if (timerWheelReserve(wheel) != EXECUTION_OK) {
+        return ERROR_STORAGE_FAILURE;
+    }
+
+    index = wheel->freeHead;
+    wheel->freeHead = wheel->nodes[index].next;
+    wheel->nodes[index].key = key;
+    wheel->nodes[index].deadline = deadline;
+    wheel->nodes[index].list = TIMER_NODE_NONE;
+    timerWheelPlace(wheel, index);
+    wheel->timerCount++;
+    *node = index;
+    return EXECUTION_OK;
+}
+
+void timerWheelReschedule(struct TimerWheel *wheel,
+                          uint32_t node,
+                          int64_t deadline)
+{
+    timerWheelUnlink(wheel, node);
+    wheel->nodes[node].deadline = deadline;
+    timerWheelPlace(wheel, node);
+}
+
+void timerWheelRemove(struct TimerWheel *wheel,
+                      uint32_t node)
+{
+    timerWheelUnlink(wheel, node);
+    wheel->nodes[node].next = wheel->freeHead;
+    wheel->freeHead = node;
+    wheel->timerCount--;
+}
+
+void timerWheelAdvance(struct TimerWheel *wheel,
+                       int64_t now)
+{
+    if (now <= wheel->currentTime) {
+        return;
+    }
+
+    if (now - wheel->currentTime >= (int64_t) TIMER_WHEEL_SLOTS) {
+        /* after a jump every pending timer is placed again, which costs less than visiting each second */
+        uint32_t list;
+
+        wheel->currentTime = now;
+        for (list = 0; list < TIMER_WHEEL_EXPIRED; list++) {
+            timerWheelReplaceList(wheel, list);
+        }
+        return;
+    }
+
+    while (wheel->currentTime < now) {
+        int64_t tick = ++wheel->currentTime;
+        unsigned int level;
+
+        /* cascade the slots of the higher levels whose range starts at this tick */
+        for (level = 1; level < TIMER_WHEEL_LEVELS; level++) {
+            if ((tick & (((int64_t) 1 << (TIMER_WHEEL_SLOT_BITS * level)) - 1)) != 0) {
+                break;
+            }
+            timerWheelReplaceList(wheel, level * TIMER_WHEEL_SLOTS
+                                         + (uint32_t) ((tick >> (TIMER_WHEEL_SLOT_BITS * level)) & TIMER_WHEEL_SLOT_MASK));
+        }
+        timerWheelReplaceList(wheel, (uint32_t) (tick & TIMER_WHEEL_SLOT_MASK));
+    }
+}
+
+const struct TimerNode *timerWheelExpired(const struct TimerWheel *wheel,
+                                          uint32_t *cursor)
+{
+    uint32_t index = *cursor == TIMER_NODE_NONE ? wheel->heads[TIMER_WHEEL_EXPIRED] : wheel->nodes[*cursor].next;
+
+    if (index == TIMER_NODE_NONE) {
+        return NULL;
+    }
+    *cursor = index;
+    return &wheel->nodes[index];
+}
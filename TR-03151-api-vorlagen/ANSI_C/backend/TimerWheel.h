@@ -0,0 +1,150 @@
+#ifndef SEAPI_BACKEND_TIMER_WHEEL_H
+#define SEAPI_BACKEND_TIMER_WHEEL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "../Exception.h"
+#include "../Constant.h"
+
+/**
+ * This header file defines a hierarchical timer wheel with a resolution of one second.
+ * Adding, rescheduling and removing a timer take constant time. Timers whose deadline has passed are moved to
+ * the list of expired timers when the wheel is advanced and stay there until they are rescheduled or removed.
+ * Timers are addressed by the index of their node, which stays valid until the timer is removed.
+ */
+
+/**
+ * Number of levels of the wheel and number of slots per level.
+ * The four levels cover deadlines up to 2^24 seconds (about 194 days) ahead, later deadlines are cascaded.
+ */
+#define TIMER_WHEEL_LEVELS 4
+#define TIMER_WHEEL_SLOT_BITS 6
+#define TIMER_WHEEL_SLOTS (1u << TIMER_WHEEL_SLOT_BITS)
+
+/**
+ * Index that marks the absence of a node
+ */
+#define TIMER_NODE_NONE UINT32_MAX
+
+/**
+ * Timer of the wheel, identified by a key chosen by the caller.
+ */
+struct TimerNode {
+    uint64_t key;
+    int64_t deadline;
+    uint32_t next;
+    uint32_t previous;
+    /* list the node is linked into: level * TIMER_WHEEL_SLOTS + slot, TIMER_WHEEL_EXPIRED or TIMER_NODE_NONE */
+    uint32_t list;
+};
+
+/**
+ * List index of the expired timers
+ */
+#define TIMER_WHEEL_EXPIRED (TIMER_WHEEL_LEVELS * TIMER_WHEEL_SLOTS)
+
+/**
+ * State of a timer wheel. The members are managed by the functions of this header file.
+ */
+struct TimerWheel {
+    struct TimerNode *nodes;
+    uint32_t nodeCapacity;
+    uint32_t freeHead;
+    uint32_t heads[TIMER_WHEEL_EXPIRED + 1];
+    int64_t currentTime;
+    size_t timerCount;
+    size_t expiredCount;
+};
+
+/**
+ * Initializes an empty wheel.
+ * @param[out] wheel
+ *                wheel to be initialized [REQUIRED]
+ * @param[in] now
+ *                current time in seconds [REQUIRED]
+ * @return EXECUTION_OK
+ */
+short int timerWheelInit(struct TimerWheel *wheel,
+                         int64_t now);
+
+/**
+ * Releases the memory of the wheel.
+ * @param[in] wheel
+ *                initialized wheel [REQUIRED]
+ */
+void timerWheelFree(struct TimerWheel *wheel);
+
+/**
+ * Allocates a free node if needed, so that the next addition of a timer does not fail.
+ * @param[in] wheel
+ *                initialized wheel [REQUIRED]
+ * @return EXECUTION_OK or ERROR_STORAGE_FAILURE if no memory could be allocated
+ */
+short int timerWheelReserve(struct TimerWheel *wheel);
+
+/**
+ * Adds a timer.
+ * @param[in] wheel
+ *                initialized wheel [REQUIRED]
+ * @param[in] key
+ *                key of the timer [REQUIRED]
+ * @param[in] deadline
+ *                time in seconds at which the timer expires [REQUIRED]
+ * @param[out] node
+ *                index of the node of the timer [REQUIRED]
+ * @return EXECUTION_OK or ERROR_STORAGE_FAILURE if no memory could be allocated
+ */
+short int timerWheelAdd(struct TimerWheel *wheel,
+                        uint64_t key,
+                        int64_t deadline,
+                        uint32_t *node);
+
+/**
+ * Moves a timer to a new deadline. An expired timer becomes pending again if the deadline lies in the future.
+ * @param[in] wheel
+ *                initialized wheel [REQUIRED]
+ * @param[in] node
+ *                index of the node of the timer [REQUIRED]
+ * @param[in] deadline
+ *                new time in seconds at which the timer expires [REQUIRED]
+ */
+void timerWheelReschedule(struct TimerWheel *wheel,
+                          uint32_t node,
+                          int64_t deadline);
+
+/**
+ * Removes a timer and releases its node.
+ * @param[in] wheel
+ *                initialized wheel [REQUIRED]
+ * @param[in] node
+ *                index of the node of the timer [REQUIRED]
+ */
+void timerWheelRemove(struct TimerWheel *wheel,
+                      uint32_t node);
+
+/**
+ * Advances the wheel to the passed time and moves the timers whose deadline has been reached to the list of
+ * expired timers. A time that lies before the current time of the wheel is ignored.
+ * Large jumps are handled by redistributing all timers instead of visiting every second in between.
+ * @param[in] wheel
+ *                initialized wheel [REQUIRED]
+ * @param[in] now
+ *                current time in seconds [REQUIRED]
+ */
+void timerWheelAdvance(struct TimerWheel *wheel,
+                       int64_t now);
+
+/**
+ * Iterates over the expired timers. The wheel MUST NOT be modified during the iteration.
+ * @param[in] wheel
+ *                initialized wheel [REQUIRED]
+ * @param[in,out] cursor
+ *                position of the iteration, TIMER_NODE_NONE for the first call [REQUIRED]
+ * @return the next expired timer or NULL if all expired timers have been visited
+ */
+const struct TimerNode *timerWheelExpired(const struct TimerWheel *wheel,
+                                          uint32_t *cursor);
+
+#endif
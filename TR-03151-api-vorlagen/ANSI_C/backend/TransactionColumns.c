@@ -0,0 +1,863 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "TransactionColumns.h"
+
+#define TRANSACTION_COLUMNS_CLIENTS_FILE_NAME "clients.dic"
+#define TRANSACTION_COLUMNS_PROCESS_TYPES_FILE_NAME "processTypes.dic"
+#define TRANSACTION_COLUMNS_INITIAL_VOLUME_SLOTS 256
+
+/**
+ * Columns in the order of the member columnFds
+ */
+enum TransactionColumn {
+transactionNumberColumn, signatureCounterColumn, logTimeColumn, clientColumn, processTypeColumn,
+processDataLengthColumn, transactionColumnCount
+};
+
+static const char *const transactionColumnFileNames[transactionColumnCount] = {
+    "transactionNumber.col", "signatureCounter.col", "logTime.col", "client.col", "processType.col",
+    "processDataLength.col"
+};
+
+static const size_t transactionColumnWidths[transactionColumnCount] = {
+    sizeof(uint64_t), sizeof(uint64_t), sizeof(int64_t), sizeof(uint32_t), sizeof(uint32_t), sizeof(uint32_t)
+};
+
+/**
+ * Returns the array of a column within a chunk.
+ */
+static unsigned char *transactionColumnArray(struct TransactionColumnChunk *chunk,
+                                             enum TransactionColumn column)
+{
+    switch (column) {
+    case transactionNumberColumn:
+        return (unsigned char *) chunk->transactionNumber;
+    case signatureCounterColumn:
+        return (unsigned char *) chunk->signatureCounter;
+    case logTimeColumn:
+        return (unsigned char *) chunk->logTime;
+    case clientColumn:
+        return (unsigned char *) chunk->client;
+    case processTypeColumn:
+        return (unsigned char *) chunk->processType;
+    default:
+        return (unsigned char *) chunk->processDataLength;
+    }
+}
+
+static uint64_t transactionColumnsHash(const unsigned char *data,
+                                       size_t length)
+{
+    /* FNV-1a */
+    uint64_t hash = 14695981039346656037ull;
+    size_t i;
+
+    for (i = 0; i < length; i++) {
+        hash = (hash ^ data[i]) * 1099511628211ull;
+    }
+    return hash;
+}
+
+static short int transactionColumnsPath(const char *directory,
+                                        const char *fileName,
+                                        char *path,
+                                        size_t pathSize)
+{
+    int length = snprintf(path, pathSize, "%s/%s", directory, fileName);
+
+    return length < 0 || (size_t) length >= pathSize ? ERROR_PARAMETER_MISMATCH : EXECUTION_OK;
+}
+
+static short int transactionColumnsWriteAll(int fd,
+                                            const void *data,
+                                            size_t dataLength,
+                                            uint64_t offset)
+{
+    const unsigned char *position = (const unsigned char *) data;
+
+    while (dataLength > 0) {
+        ssize_t written = pwrite(fd, position, dataLength, (off_t) offset);
+
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+        if (written <= 0) {
+            return ERROR_STORAGE_FAILURE;
+        }
+        position += written;
+        dataLength -= (size_t) written;
+        offset += (uint64_t) written;
+    }
+    return EXECUTION_OK;
+}
+
+static short int transactionColumnsReadAll(int fd,
+                                           void *data,
+                                           size_t dataLength,
+                                           uint64_t offset)
+{
+    unsigned char *position = (unsigned char *) data;
+
+    while (dataLength > 0) {
+        ssize_t readLength = pread(fd, position, dataLength, (off_t) offset);
+
+        if (readLength < 0 && errno == EINTR) {
+            continue;
+        }
+        if (readLength <= 0) {
+            return ERROR_STORAGE_FAILURE;
+        }
+        position += readLength;
+        dataLength -= (size_t) readLength;
+        offset += (uint64_t) readLength;
+    }
+    return EXECUTION_OK;
+}
+
+/**
+ * Inserts the code of a value into the open-addressing table, which has at least one free slot.
+ */
+static void transactionColumnDictionaryIndex(struct TransactionColumnDictionary *dictionary,
+                                             uint32_t code)
+{
+    const struct TransactionColumnValue *value = &dictionary->values[code];
+    uint32_t slot = (uint32_t) transactionColumnsHash(value->data, value->length) & (dictionary->slotCount - 1);
+
+    while (dictionary->slots[slot] != TRANSACTION_COLUMNS_ANY) {
+        slot = (slot + 1) & (dictionary->slotCount - 1);
+    }
+    dictionary->slots[slot] = code;
+}
+
+static bool transactionColumnDictionaryFind(const struct TransactionColumnDictionary *dictionary,
+                                            const unsigned char *data,
+                                            size_t length,
+                                            uint32_t *code)
+{
+    uint32_t slot;
+
+    if (dictionary->slotCount == 0) {
+        return false;
+    }
+    slot = (uint32_t) transactionColumnsHash(data, length) & (dictionary->slotCount - 1);
+    while (dictionary->slots[slot] != TRANSACTION_COLUMNS_ANY) {
+        const struct TransactionColumnValue *value = &dictionary->values[dictionary->slots[slot]];
+
+        if (value->length == length && (length == 0 || memcmp(value->data, data, length) == 0)) {
+            *code = dictionary->slots[slot];
+            return true;
+        }
+        slot = (slot + 1) & (dictionary->slotCount - 1);
+    }
+    return false;
+}
+
+/**
+ * Adds a value to the dictionary in memory, the table of codes is kept at most half full.
+ */
+static short int transactionColumnDictionaryInsert(struct TransactionColumnDictionary *dictionary,
+                                                   const unsigned char *data,
+                                                   size_t length,
+                                                   uint32_t *code)
+{
+    struct TransactionColumnValue *value;
+
+    if (dictionary->count == dictionary->capacity) {
+        uint32_t capacity = dictionary->capacity == 0 ? 64 : dictionary->capacity * 2;
+        struct TransactionColumnValue *values = realloc(dictionary->values, capacity * sizeof *values);
+
+        if (values == NULL) {
+            return ERROR_STORAGE_FAILURE;
+        }
+        dictionary->values = values;
+        dictionary->capacity = capacity;
+    }
+    if ((uint64_t) (dictionary->count + 1) * 2 > dictionary->slotCount) {
+        uint32_t slotCount = dictionary->slotCount == 0 ? 128 : dictionary->slotCount * 2;
+        uint32_t *slots = malloc(slotCount * sizeof *slots);
+        uint32_t i;
+
+        if (slots == NULL) {
+            return ERROR_STORAGE_FAILURE;
+        }
+        free(dictionary->slots);
+        memset(slots, 0xff, slotCount * sizeof *slots);
+        dictionary->slots = slots;
+        dictionary->slotCount = slotCount;
+        for (i = 0; i < dictionary->count; i++) {
+            transactionColumnDictionaryIndex(dictionary, i);
+        }
+    }
+
+    value = &dictionary->values[dictionary->count];
+    value->data = malloc(length > 0 ? length : 1);
+    if (value->data == NULL) {
+        return ERROR_STORAGE_FAILURE;
+    }
+    if (length > 0) {
+        memcpy(value->data, data, length);
+    }
+    value->length = length;
+    *code = dictionary->count++;
+    transactionColumnDictionaryIndex(dictionary, *code);
+    return EXECUTION_OK;
+}
+
+/**
+ * Determines the code of a value and appends new values to the file of the dictionary, before the first row that
+ * refers to them is written.
+ */
+static short int transactionColumnDictionaryCode(struct TransactionColumnDictionary *dictionary,
+                                                 const unsigned char *data,
+                                                 size_t length,
+                                                 uint32_t *code)
+{
+    uint32_t fileLength = (uint32_t) length;
+    off_t offset;
+    short int result;
+
+    if (transactionColumnDictionaryFind(dictionary, data, length, code)) {
+        return EXECUTION_OK;
+    }
+    offset = lseek(dictionary->fd, 0, SEEK_END);
+    if (offset < 0) {
+        return ERROR_STORAGE_FAILURE;
+    }
+    result = transactionColumnsWriteAll(dictionary->fd, &fileLength, sizeof fileLength, (uint64_t) offset);
+    if (result == EXECUTION_OK && length > 0) {
+        result = transactionColumnsWriteAll(dictionary->fd, data, length, (uint64_t) offset + sizeof fileLength);
+    }
+    if (result != EXECUTION_OK) {
+        /* a partially written value is not loaded */
+        return ftruncate(dictionary->fd, offset) == 0 ? result : ERROR_STORAGE_FAILURE;
+    }
+    return transactionColumnDictionaryInsert(dictionary, data, length, code);
+}
+
+/**
+ * Opens and loads the file of a dictionary. An incompletely written value at the end of the file is discarded.
+ */
+static short int transactionColumnDictionaryOpen(struct TransactionColumnDictionary *dictionary,
+                                                 const char *directory,
+                                                 const char *fileName)
+{
+    char path[4096];
+    unsigned char value[TRANSACTION_CLIENT_ID_MAX > 256 ? TRANSACTION_CLIENT_ID_MAX : 256];
+    struct stat status;
+    uint64_t offset = 0;
+    short int result = transactionColumnsPath(directory, fileName, path, sizeof path);
+
+    memset(dictionary, 0, sizeof *dictionary);
+    dictionary->fd = -1;
+    if (result != EXECUTION_OK) {
+        return ERROR_STORAGE_FAILURE;
+    }
+    dictionary->fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+    if (dictionary->fd < 0 || fstat(dictionary->fd, &status) != 0) {
+        return ERROR_STORAGE_FAILURE;
+    }
+    while (offset + sizeof(uint32_t) <= (uint64_t) status.st_size) {
+        uint32_t length;
+        uint32_t code;
+
+        if (transactionColumnsReadAll(dictionary->fd, &length, sizeof length, offset) != EXECUTION_OK) {
+            return ERROR_STORAGE_FAILURE;
+        }
+        if (length > sizeof value || offset + sizeof length + length > (uint64_t) status.st_size) {
+            break;
+        }
+        if ((length > 0 && transactionColumnsReadAll(dictionary->fd, value, length, offset + sizeof length)
+                           != EXECUTION_OK)
+            || transactionColumnDictionaryInsert(dictionary, value, length, &code) != EXECUTION_OK) {
+            return ERROR_STORAGE_FAILURE;
+        }
+        offset += sizeof length + length;
+    }
+    return ftruncate(dictionary->fd, (off_t) offset) == 0 ? EXECUTION_OK : ERROR_STORAGE_FAILURE;
+}
+
+static void transactionColumnDictionaryClose(struct TransactionColumnDictionary *dictionary)
+{
+    uint32_t i;
+
+    if (dictionary->fd >= 0) {
+        close(dictionary->fd);
+    }
+    for (i = 0; i < dictionary->count; i++) {
+        free(dictionary->values[i].data);
+    }
+    free(dictionary->values);
+    free(dictionary->slots);
+    memset(dictionary, 0, sizeof *dictionary);
+    dictionary->fd = -1;
+}
+
+/**
+ * Makes sure that the chunk of the next row exists.
+ */
+static short int transactionColumnsReserve(struct TransactionColumns *columns)
+{
+    struct TransactionColumnChunk *chunk;
+
+    if (columns->rowCount < (uint64_t) columns->chunkCount * TRANSACTION_COLUMNS_CHUNK_ROWS) {
+        return EXECUTION_OK;
+    }
+    if (columns->chunkCount == columns->chunkCapacity) {
+        size_t capacity = columns->chunkCapacity == 0 ? 16 : columns->chunkCapacity * 2;
+        struct TransactionColumnChunk **chunks = realloc(columns->chunks, capacity * sizeof *chunks);
+
+        if (chunks == NULL) {
+            return ERROR_STORAGE_FAILURE;
+        }
+        columns->chunks = chunks;
+        columns->chunkCapacity = capacity;
+    }
+    chunk = malloc(sizeof *chunk);
+    if (chunk == NULL) {
+        return ERROR_STORAGE_FAILURE;
+    }
+    chunk->minLogTime = INT64_MAX;
+    chunk->maxLogTime = INT64_MIN;
+    columns->chunks[columns->chunkCount++] = chunk;
+    return EXECUTION_OK;
+}
+
+static uint64_t transactionColumnsLastSignatureCounter(const struct TransactionColumns *columns)
+{
+    uint64_t row = columns->rowCount - 1;
+
+    if (columns->rowCount == 0) {
+        return 0;
+    }
+    return columns->chunks[row / TRANSACTION_COLUMNS_CHUNK_ROWS]
+           ->signatureCounter[row % TRANSACTION_COLUMNS_CHUNK_ROWS];
+}
+
+/**
+ * Writes the rows from writtenRowCount to rowCount to the column files.
+ */
+static short int transactionColumnsWrite(struct TransactionColumns *columns)
+{
+    while (columns->writtenRowCount < columns->rowCount) {
+        struct TransactionColumnChunk *chunk;
+        size_t first = (size_t) (columns->writtenRowCount % TRANSACTION_COLUMNS_CHUNK_ROWS);
+        size_t count = TRANSACTION_COLUMNS_CHUNK_ROWS - first;
+        int column;
+
+        chunk = columns->chunks[columns->writtenRowCount / TRANSACTION_COLUMNS_CHUNK_ROWS];
+        if (count > columns->rowCount - columns->writtenRowCount) {
+            count = (size_t) (columns->rowCount - columns->writtenRowCount);
+        }
+        for (column = 0; column < transactionColumnCount; column++) {
+            size_t width = transactionColumnWidths[column];
+
+            if (transactionColumnsWriteAll(columns->columnFds[column],
+                                           transactionColumnArray(chunk, (enum TransactionColumn) column)
+                                           + first * width, count * width,
+                                           columns->writtenRowCount * width) != EXECUTION_OK) {
+                return ERROR_STORAGE_FAILURE;
+            }
+        }
+        columns->writtenRowCount += count;
+    }
+    return EXECUTION_OK;
+}
+
+static void transactionColumnsUpdateRange(struct TransactionColumnChunk *chunk,
+                                          size_t row)
+{
+    if (chunk->logTime[row] < chunk->minLogTime) {
+        chunk->minLogTime = chunk->logTime[row];
+    }
+    if (chunk->logTime[row] > chunk->maxLogTime) {
+        chunk->maxLogTime = chunk->logTime[row];
+    }
+}
+
+/**
+ * Loads the rows of the column files. The number of rows is that of the shortest column; rows that refer to a
+ * value that is missing in a dictionary are discarded with all following rows.
+ */
+static short int transactionColumnsLoad(struct TransactionColumns *columns)
+{
+    uint64_t rowCount = UINT64_MAX;
+    uint64_t row;
+    int column;
+
+    for (column = 0; column < transactionColumnCount; column++) {
+        struct stat status;
+
+        if (fstat(columns->columnFds[column], &status) != 0) {
+            return ERROR_STORAGE_FAILURE;
+        }
+        if ((uint64_t) status.st_size / transactionColumnWidths[column] < rowCount) {
+            rowCount = (uint64_t) status.st_size / transactionColumnWidths[column];
+        }
+    }
+
+    for (row = 0; row < rowCount; row += TRANSACTION_COLUMNS_CHUNK_ROWS) {
+        struct TransactionColumnChunk *chunk;
+        size_t count = rowCount - row < TRANSACTION_COLUMNS_CHUNK_ROWS ? (size_t) (rowCount - row)
+                       : TRANSACTION_COLUMNS_CHUNK_ROWS;
+        size_t i;
+
+        if (transactionColumnsReserve(columns) != EXECUTION_OK) {
+            return ERROR_STORAGE_FAILURE;
+        }
+        chunk = columns->chunks[columns->chunkCount - 1];
+        for (column = 0; column < transactionColumnCount; column++) {
+            size_t width = transactionColumnWidths[column];
+
+            if (transactionColumnsReadAll(columns->columnFds[column],
+                                          transactionColumnArray(chunk, (enum TransactionColumn) column),
+                                          count * width, row * width) != EXECUTION_OK) {
+                return ERROR_STORAGE_FAILURE;
+            }
+        }
+        for (i = 0; i < count; i++) {
+            if (chunk->client[i] >= columns->clients.count || chunk->processType[i] >= columns->processTypes.count
+                || chunk->signatureCounter[i] <= transactionColumnsLastSignatureCounter(columns)) {
+                break;
+            }
+            transactionColumnsUpdateRange(chunk, i);
+            columns->rowCount++;
+        }
+        if (i < count) {
+            break;
+        }
+    }
+
+    columns->writtenRowCount = columns->rowCount;
+    for (column = 0; column < transactionColumnCount; column++) {
+        if (ftruncate(columns->columnFds[column], (off_t) (columns->rowCount * transactionColumnWidths[column]))
+            != 0) {
+            return ERROR_STORAGE_FAILURE;
+        }
+    }
+    return EXECUTION_OK;
+}
+
+short int transactionColumnsOpen(struct TransactionColumns *columns,
+                                 const char *directory,
+                                 struct LogStore *store)
+{
+    char path[4096];
+    short int result;
+    int column;
+
+    if (columns == NULL || directory == NULL || store == NULL) {
+        return ERROR_PARAMETER_MISMATCH;
+    }
+    memset(columns, 0, sizeof *columns);
+    for (column = 0; column < transactionColumnCount; column++) {
+        columns->columnFds[column] = -1;
+    }
+    columns->clients.fd = -1;
+    columns->processTypes.fd = -1;
+    if (mkdir(directory, 0700) != 0 && errno != EEXIST) {
+        return ERROR_STORAGE_FAILURE;
+    }
+    columns->directory = strdup(directory);
+    result = columns->directory != NULL ? EXECUTION_OK : ERROR_STORAGE_FAILURE;
+    for (column = 0; column < transactionColumnCount && result == EXECUTION_OK; column++) {
+        result = transactionColumnsPath(directory, transactionColumnFileNames[column], path, sizeof path);
+        if (result == EXECUTION_OK) {
+            columns->columnFds[column] = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+            result = columns->columnFds[column] >= 0 ? EXECUTION_OK : ERROR_STORAGE_FAILURE;
+        }
+    }
+    if (result == EXECUTION_OK) {
+        result = transactionColumnDictionaryOpen(&columns->clients, directory, TRANSACTION_COLUMNS_CLIENTS_FILE_NAME);
+    }
+    if (result == EXECUTION_OK) {
+        result = transactionColumnDictionaryOpen(&columns->processTypes, directory,
+                                                 TRANSACTION_COLUMNS_PROCESS_TYPES_FILE_NAME);
+    }
+    if (result == EXECUTION_OK) {
+        result = transactionColumnsLoad(columns);
+    }
+    pthread_mutex_init(&columns->lock, NULL);
+    if (result == EXECUTION_OK) {
+        result = transactionColumnsCatchUp(columns, store);
+    }
+    if (result != EXECUTION_OK) {
+        transactionColumnsClose(columns);
+        return ERROR_STORAGE_FAILURE;
+    }
+    return EXECUTION_OK;
+}
+
+short int transactionColumnsCatchUp(struct TransactionColumns *columns,
+                                    struct LogStore *store)
+{
+    struct SegmentInfo *segments;
+    size_t segmentCount;
+    size_t i;
+    uint64_t lastSignatureCounter;
+    short int result = EXECUTION_OK;
+
+    pthread_mutex_lock(&columns->lock);
+    lastSignatureCounter = transactionColumnsLastSignatureCounter(columns);
+    pthread_mutex_unlock(&columns->lock);
+    if (logStoreSnapshotSegments(store, &segments, &segmentCount) != EXECUTION_OK) {
+        return ERROR_STORAGE_FAILURE;
+    }
+    for (i = 0; i < segmentCount && result == EXECUTION_OK; i++) {
+        struct SegmentReader reader;
+        struct LogRecord record;
+        bool endOfSegment = false;
+
+        if (segments[i].transactionRecordCount == 0 || segments[i].lastSignatureCounter <= lastSignatureCounter) {
+            continue;
+        }
+        if (segmentReaderOpen(&reader, store, segments[i].id, 0) != EXECUTION_OK) {
+            result = ERROR_STORAGE_FAILURE;
+            break;
+        }
+        reader.limit = segments[i].length;
+        while (result == EXECUTION_OK) {
+            result = segmentReaderNext(&reader, &record, &endOfSegment);
+            if (result != EXECUTION_OK || endOfSegment) {
+                break;
+            }
+            result = transactionColumnsAdd(columns, &record);
+        }
+        segmentReaderClose(&reader);
+    }
+    logStoreReleaseSnapshot(store, segments);
+    return result != EXECUTION_OK ? ERROR_STORAGE_FAILURE : EXECUTION_OK;
+}
+
+short int transactionColumnsAdd(struct TransactionColumns *columns,
+                                const struct LogRecord *record)
+{
+    struct TransactionColumnChunk *chunk;
+    size_t processTypeLength = 0;
+    size_t row;
+    short int result;
+
+    if (record->type != transactionLogMessage || record->operation != finishTransactionOperation) {
+        return EXECUTION_OK;
+    }
+    /* the payload holds the length of the processType, the processType and the processData */
+    if (record->payloadLength > 0 && record->payload[0] < record->payloadLength) {
+        processTypeLength = record->payload[0];
+    }
+
+    pthread_mutex_lock(&columns->lock);
+    if (record->signatureCounter <= transactionColumnsLastSignatureCounter(columns)) {
+        pthread_mutex_unlock(&columns->lock);
+        return EXECUTION_OK;
+    }
+    result = transactionColumnsReserve(columns);
+    if (result == EXECUTION_OK) {
+        chunk = columns->chunks[columns->chunkCount - 1];
+        row = (size_t) (columns->rowCount % TRANSACTION_COLUMNS_CHUNK_ROWS);
+        result = transactionColumnDictionaryCode(&columns->clients, record->clientId, record->clientIdLength,
+                                                 &chunk->client[row]);
+        if (result == EXECUTION_OK) {
+            result = transactionColumnDictionaryCode(&columns->processTypes,
+                                                     processTypeLength > 0 ? record->payload + 1 : NULL,
+                                                     processTypeLength, &chunk->processType[row]);
+        }
+        if (result == EXECUTION_OK) {
+            chunk->transactionNumber[row] = record->transactionNumber;
+            chunk->signatureCounter[row] = record->signatureCounter;
+            chunk->logTime[row] = record->logTime;
+            chunk->processDataLength[row] = record->payloadLength > 0
+                                            ? (uint32_t) (record->payloadLength - 1 - processTypeLength) : 0;
+            transactionColumnsUpdateRange(chunk, row);
+            columns->rowCount++;
+            /* the rows of a complete chunk are written together, missing rows are added again by the catch-up */
+            if (row + 1 == TRANSACTION_COLUMNS_CHUNK_ROWS) {
+                result = transactionColumnsWrite(columns);
+            }
+        }
+    }
+    pthread_mutex_unlock(&columns->lock);
+    return result;
+}
+
+short int transactionColumnsLookup(struct TransactionColumns *columns,
+                                   bool processType,
+                                   const unsigned char *value,
+                                   size_t valueLength,
+                                   uint32_t *code)
+{
+    bool found;
+
+    if (value == NULL && valueLength > 0) {
+        return ERROR_PARAMETER_MISMATCH;
+    }
+    pthread_mutex_lock(&columns->lock);
+    found = transactionColumnDictionaryFind(processType ? &columns->processTypes : &columns->clients, value,
+                                            valueLength, code);
+    pthread_mutex_unlock(&columns->lock);
+    return found ? EXECUTION_OK : ERROR_PARAMETER_MISMATCH;
+}
+
+short int transactionColumnsValue(struct TransactionColumns *columns,
+                                  bool processType,
+                                  uint32_t code,
+                                  unsigned char *value,
+                                  size_t capacity,
+                                  size_t *valueLength)
+{
+    const struct TransactionColumnDictionary *dictionary = processType ? &columns->processTypes : &columns->clients;
+    short int result = ERROR_PARAMETER_MISMATCH;
+
+    pthread_mutex_lock(&columns->lock);
+    if (code < dictionary->count) {
+        *valueLength = dictionary->values[code].length;
+        if (*valueLength <= capacity && (value != NULL || *valueLength == 0)) {
+            if (*valueLength > 0) {
+                memcpy(value, dictionary->values[code].data, *valueLength);
+            }
+            result = EXECUTION_OK;
+        }
+    }
+    pthread_mutex_unlock(&columns->lock);
+    return result;
+}
+
+/**
+ * Open-addressing table of the aggregates of a query. A transactionCount of 0 marks a free slot.
+ */
+struct TransactionVolumeTable {
+    struct TransactionVolume *slots;
+    size_t slotCount;
+    size_t count;
+};
+
+static size_t transactionVolumeSlot(const struct TransactionVolumeTable *table,
+                                    int64_t intervalStart,
+                                    uint32_t client,
+                                    uint32_t processType)
+{
+    uint64_t hash = ((uint64_t) intervalStart * 0x9e3779b97f4a7c15ull) ^ ((uint64_t) client << 32 | processType);
+
+    hash ^= hash >> 29;
+    hash *= 0xbf58476d1ce4e5b9ull;
+    hash ^= hash >> 32;
+    return (size_t) hash & (table->slotCount - 1);
+}
+
+static struct TransactionVolume *transactionVolumeFind(struct TransactionVolumeTable *table,
+                                                       int64_t intervalStart,
+                                                       uint32_t client,
+                                                       uint32_t processType)
+{
+    struct TransactionVolume *volume;
+    size_t slot;
+
+    if ((table->count + 1) * 2 > table->slotCount) {
+        struct TransactionVolumeTable grown;
+        size_t i;
+
+        grown.slotCount = table->slotCount * 2;
+        grown.count = table->count;
+        grown.slots = calloc(grown.slotCount, sizeof *grown.slots);
+        if (grown.slots == NULL) {
+            return NULL;
+        }
+        for (i = 0; i < table->slotCount; i++) {
+            if (table->slots[i].transactionCount > 0) {
+                slot = transactionVolumeSlot(&grown, table->slots[i].intervalStart, table->slots[i].client,
+                                             table->slots[i].processType);
+                while (grown.slots[slot].transactionCount > 0) {
+                    slot = (slot + 1) & (grown.slotCount - 1);
+                }
+                grown.slots[slot] = table->slots[i];
+            }
+        }
+        free(table->slots);
+        *table = grown;
+    }
+
+    slot = transactionVolumeSlot(table, intervalStart, client, processType);
+    for (;;) {
+        volume = &table->slots[slot];
+        if (volume->transactionCount == 0) {
+            volume->intervalStart = intervalStart;
+            volume->client = client;
+            volume->processType = processType;
+            volume->firstSignatureCounter = UINT64_MAX;
+            table->count++;
+            return volume;
+        }
+        if (volume->intervalStart == intervalStart && volume->client == client && volume->processType == processType) {
+            return volume;
+        }
+        slot = (slot + 1) & (table->slotCount - 1);
+    }
+}
+
+static int transactionVolumeCompare(const void *first,
+                                    const void *second)
+{
+    const struct TransactionVolume *a = (const struct TransactionVolume *) first;
+    const struct TransactionVolume *b = (const struct TransactionVolume *) second;
+
+    if (a->intervalStart != b->intervalStart) {
+        return a->intervalStart < b->intervalStart ? -1 : 1;
+    }
+    if (a->client != b->client) {
+        return a->client < b->client ? -1 : 1;
+    }
+    return a->processType < b->processType ? -1 : a->processType > b->processType;
+}
+
+/**
+ * Selects the rows of a chunk. The conditions are combined without branches, so that the loop does not depend on
+ * the selectivity of the query and can be vectorised by the compiler.
+ */
+static size_t transactionColumnsSelect(const struct TransactionColumnChunk *chunk,
+                                       size_t rowCount,
+                                       const struct TransactionColumnQuery *query,
+                                       uint16_t *selection)
+{
+    unsigned int anyClient = query->client == TRANSACTION_COLUMNS_ANY;
+    unsigned int anyProcessType = query->processType == TRANSACTION_COLUMNS_ANY;
+    size_t count = 0;
+    size_t row;
+
+    for (row = 0; row < rowCount; row++) {
+        unsigned int selected = (unsigned int) (chunk->logTime[row] >= query->startTime)
+                                & (unsigned int) (chunk->logTime[row] <= query->endTime)
+                                & (anyClient | (unsigned int) (chunk->client[row] == query->client))
+                                & (anyProcessType | (unsigned int) (chunk->processType[row] == query->processType));
+
+        selection[count] = (uint16_t) row;
+        count += selected;
+    }
+    return count;
+}
+
+short int transactionColumnsAggregate(struct TransactionColumns *columns,
+                                      const struct TransactionColumnQuery *query,
+                                      struct TransactionVolume **volumes,
+                                      size_t *volumeCount)
+{
+    struct TransactionColumnChunk **chunks;
+    struct TransactionVolumeTable table;
+    struct TransactionVolume *last = NULL;
+    uint16_t selection[TRANSACTION_COLUMNS_CHUNK_ROWS];
+    uint64_t rowCount;
+    size_t chunkCount;
+    size_t i;
+
+    if (query->interval < 0) {
+        return ERROR_PARAMETER_MISMATCH;
+    }
+    table.slotCount = TRANSACTION_COLUMNS_INITIAL_VOLUME_SLOTS;
+    table.count = 0;
+    table.slots = calloc(table.slotCount, sizeof *table.slots);
+    if (table.slots == NULL) {
+        return ERROR_STORAGE_FAILURE;
+    }
+    /* chunks are not released before the column store is closed, the rows below rowCount are not changed */
+    pthread_mutex_lock(&columns->lock);
+    rowCount = columns->rowCount;
+    chunkCount = columns->chunkCount;
+    chunks = malloc((chunkCount > 0 ? chunkCount : 1) * sizeof *chunks);
+    if (chunks != NULL && chunkCount > 0) {
+        memcpy(chunks, columns->chunks, chunkCount * sizeof *chunks);
+    }
+    pthread_mutex_unlock(&columns->lock);
+    if (chunks == NULL) {
+        free(table.slots);
+        return ERROR_STORAGE_FAILURE;
+    }
+
+    for (i = 0; i < chunkCount; i++) {
+        const struct TransactionColumnChunk *chunk = chunks[i];
+        uint64_t chunkStart = (uint64_t) i * TRANSACTION_COLUMNS_CHUNK_ROWS;
+        size_t chunkRows = rowCount - chunkStart < TRANSACTION_COLUMNS_CHUNK_ROWS ? (size_t) (rowCount - chunkStart)
+                           : TRANSACTION_COLUMNS_CHUNK_ROWS;
+        size_t count;
+        size_t j;
+
+        if (chunkStart >= rowCount) {
+            break;
+        }
+        if (chunkRows == TRANSACTION_COLUMNS_CHUNK_ROWS
+            && (chunk->maxLogTime < query->startTime || chunk->minLogTime > query->endTime)) {
+            continue;
+        }
+        count = transactionColumnsSelect(chunk, chunkRows, query, selection);
+        for (j = 0; j < count; j++) {
+            size_t row = selection[j];
+            int64_t intervalStart = query->startTime;
+
+            if (query->interval > 0) {
+                int64_t remainder = chunk->logTime[row] % query->interval;
+
+                intervalStart = chunk->logTime[row] - (remainder < 0 ? remainder + query->interval : remainder);
+            }
+            /* consecutive rows mostly belong to the same aggregate */
+            if (last == NULL || last->intervalStart != intervalStart || last->client != chunk->client[row]
+                || last->processType != chunk->processType[row]) {
+                last = transactionVolumeFind(&table, intervalStart, chunk->client[row], chunk->processType[row]);
+                if (last == NULL) {
+                    free(chunks);
+                    free(table.slots);
+                    return ERROR_STORAGE_FAILURE;
+                }
+            }
+            last->transactionCount++;
+            last->processDataLength += chunk->processDataLength[row];
+            if (chunk->signatureCounter[row] < last->firstSignatureCounter) {
+                last->firstSignatureCounter = chunk->signatureCounter[row];
+            }
+            if (chunk->signatureCounter[row] > last->lastSignatureCounter) {
+                last->lastSignatureCounter = chunk->signatureCounter[row];
+            }
+        }
+    }
+    free(chunks);
+
+    /* the aggregates are moved to the front of the table and sorted */
+    *volumeCount = 0;
+    for (i = 0; i < table.slotCount; i++) {
+        if (table.slots[i].transactionCount > 0) {
+            table.slots[(*volumeCount)++] = table.slots[i];
+        }
+    }
+    qsort(table.slots, *volumeCount, sizeof *table.slots, transactionVolumeCompare);
+    *volumes = table.slots;
+    return EXECUTION_OK;
+}
+
+short int transactionColumnsClose(struct TransactionColumns *columns)
+{
+    short int result = EXECUTION_OK;
+    size_t i;
+    int column;
+
+    if (columns->columnFds[transactionColumnCount - 1] >= 0 && columns->directory != NULL) {
+        result = transactionColumnsWrite(columns);
+    }
+    for (column = 0; column < transactionColumnCount; column++) {
+        if (columns->columnFds[column] >= 0) {
+            close(columns->columnFds[column]);
+        }
+    }
+    transactionColumnDictionaryClose(&columns->clients);
+    transactionColumnDictionaryClose(&columns->processTypes);
+    for (i = 0; i < columns->chunkCount; i++) {
+        free(columns->chunks[i]);
+    }
+    free(columns->chunks);
+    free(columns->directory);
+    if (columns->directory != NULL) {
+        pthread_mutex_destroy(&columns->lock);
+    }
+    memset(columns, 0, sizeof *columns);
+    return result;
+}
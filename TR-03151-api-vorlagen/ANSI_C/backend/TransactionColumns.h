@@ -0,0 +1,235 @@
+#ifndef SEAPI_BACKEND_TRANSACTION_COLUMNS_H
+#define SEAPI_BACKEND_TRANSACTION_COLUMNS_H
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "../Exception.h"
+#include "../Constant.h"
+#include "LogStore.h"
+
+/**
+ * This header file defines the column store of the finished transactions of the SE API backend, which answers
+ * queries of transaction volumes, e.g. by clientId, processType and hour, without exporting and parsing the log
+ * messages.
+ *
+ * For every finishTransaction log message a row with the transaction number, the clientId, the processType, the
+ * log time, the signature counter and the length of the processData is added. The columns are kept in chunks of
+ * TRANSACTION_COLUMNS_CHUNK_ROWS rows with one array per column; clientId and processType are stored as codes of a
+ * dictionary. A query selects the rows of a chunk without branches into a selection vector and aggregates the
+ * selected rows; chunks whose log time range does not overlap the queried period are skipped.
+ *
+ * The column store is derived from the log store and does not contain signed data. Every column and dictionary is
+ * appended to its own file in the subdirectory analytics, complete chunks are written when they are filled. Rows
+ * that have not been written before a crash are added again from the log store when the column store is opened.
+ * Rows are not removed when stored data is deleted.
+ */
+
+/**
+ * Number of rows of a chunk
+ */
+#define TRANSACTION_COLUMNS_CHUNK_ROWS 4096
+
+/**
+ * Code that selects all clients or all process types in a query
+ */
+#define TRANSACTION_COLUMNS_ANY UINT32_MAX
+
+/**
+ * Rows of a chunk. Complete chunks are not changed anymore; the log time range is only valid for complete chunks.
+ */
+struct TransactionColumnChunk {
+    int64_t minLogTime;
+    int64_t maxLogTime;
+    uint64_t transactionNumber[TRANSACTION_COLUMNS_CHUNK_ROWS];
+    uint64_t signatureCounter[TRANSACTION_COLUMNS_CHUNK_ROWS];
+    int64_t logTime[TRANSACTION_COLUMNS_CHUNK_ROWS];
+    uint32_t client[TRANSACTION_COLUMNS_CHUNK_ROWS];
+    uint32_t processType[TRANSACTION_COLUMNS_CHUNK_ROWS];
+    uint32_t processDataLength[TRANSACTION_COLUMNS_CHUNK_ROWS];
+};
+
+/**
+ * Value of a dictionary
+ */
+struct TransactionColumnValue {
+    unsigned char *data;
+    size_t length;
+};
+
+/**
+ * Dictionary of the values of a column. The codes are the positions of the values, which are found by an
+ * open-addressing table of codes.
+ */
+struct TransactionColumnDictionary {
+    int fd;
+    struct TransactionColumnValue *values;
+    uint32_t count;
+    uint32_t capacity;
+    uint32_t *slots;
+    uint32_t slotCount;
+};
+
+/**
+ * State of an opened column store. The members are managed by the functions of this header file and MUST only be
+ * read while holding the lock; the rows of the chunks below rowCount may be read after releasing it.
+ */
+struct TransactionColumns {
+    char *directory;
+    pthread_mutex_t lock;
+    struct TransactionColumnChunk **chunks;
+    size_t chunkCount;
+    size_t chunkCapacity;
+    uint64_t rowCount;
+    uint64_t writtenRowCount;
+    int columnFds[6];
+    struct TransactionColumnDictionary clients;
+    struct TransactionColumnDictionary processTypes;
+};
+
+/**
+ * Selection of the rows of a query. The period is inclusive, the codes are determined with
+ * transactionColumnsLookup.
+ */
+struct TransactionColumnQuery {
+    int64_t startTime;
+    int64_t endTime;
+    uint32_t client;
+    uint32_t processType;
+    int64_t interval;
+};
+
+/**
+ * Aggregated rows of a client and process type within an interval of the log time.
+ */
+struct TransactionVolume {
+    int64_t intervalStart;
+    uint32_t client;
+    uint32_t processType;
+    uint64_t transactionCount;
+    uint64_t processDataLength;
+    uint64_t firstSignatureCounter;
+    uint64_t lastSignatureCounter;
+};
+
+/**
+ * Opens the column store in the passed directory, which is created if it does not exist, and adds the finished
+ * transactions of the log store that are missing in the column store.
+ * @param[out] columns
+ *                column store state to be initialized [REQUIRED]
+ * @param[in] directory
+ *                directory that holds the column files [REQUIRED]
+ * @param[in] store
+ *                opened log store from which the column store is derived [REQUIRED]
+ * @return if the execution of the function has been successful, the return value EXECUTION_OK SHALL be returned.
+ *
+ *         If the execution of the function has failed, the appropriate error code SHALL be returned:
+ *
+ *             ERROR_PARAMETER_MISMATCH
+ *                a required parameter is missing
+ *             ERROR_STORAGE_FAILURE
+ *                the directory or a file could not be opened, the log store could not be read or no memory could be
+ *                allocated
+ */
+short int transactionColumnsOpen(struct TransactionColumns *columns,
+                                 const char *directory,
+                                 struct LogStore *store);
+
+/**
+ * Adds the finished transactions of the log store whose signature counter is greater than that of the last row.
+ * @param[in] columns
+ *                opened column store [REQUIRED]
+ * @param[in] store
+ *                opened log store from which the column store is derived [REQUIRED]
+ * @return EXECUTION_OK or ERROR_STORAGE_FAILURE if the log store could not be read or a row could not be added
+ */
+short int transactionColumnsCatchUp(struct TransactionColumns *columns,
+                                    struct LogStore *store);
+
+/**
+ * Adds the row of a finishTransaction log message; other log messages and log messages whose signature counter is
+ * not greater than that of the last row are ignored. The function MUST NOT be invoked concurrently for the same
+ * column store.
+ * @param[in] columns
+ *                opened column store [REQUIRED]
+ * @param[in] record
+ *                log message that has been appended to the log store [REQUIRED]
+ * @return EXECUTION_OK or ERROR_STORAGE_FAILURE if no memory could be allocated or a file could not be written
+ */
+short int transactionColumnsAdd(struct TransactionColumns *columns,
+                                const struct LogRecord *record);
+
+/**
+ * Determines the code of a clientId or processType.
+ * @param[in] columns
+ *                opened column store [REQUIRED]
+ * @param[in] processType
+ *                true for the dictionary of the process types, false for the dictionary of the clients [REQUIRED]
+ * @param[in] value
+ *                the clientId or processType [OPTIONAL]
+ * @param[in] valueLength
+ *                the length of the value [REQUIRED]
+ * @param[out] code
+ *                receives the code [REQUIRED]
+ * @return EXECUTION_OK or ERROR_PARAMETER_MISMATCH if no row contains the value
+ */
+short int transactionColumnsLookup(struct TransactionColumns *columns,
+                                   bool processType,
+                                   const unsigned char *value,
+                                   size_t valueLength,
+                                   uint32_t *code);
+
+/**
+ * Copies the clientId or processType of a code.
+ * @param[in] columns
+ *                opened column store [REQUIRED]
+ * @param[in] processType
+ *                true for the dictionary of the process types, false for the dictionary of the clients [REQUIRED]
+ * @param[in] code
+ *                code of a row or of an aggregate [REQUIRED]
+ * @param[out] value
+ *                receives the value [OPTIONAL]
+ * @param[in] capacity
+ *                size of the array value [REQUIRED]
+ * @param[out] valueLength
+ *                receives the length of the value, also if it does not fit into the array [REQUIRED]
+ * @return EXECUTION_OK or ERROR_PARAMETER_MISMATCH if the code is unknown or the value does not fit into the array
+ */
+short int transactionColumnsValue(struct TransactionColumns *columns,
+                                  bool processType,
+                                  uint32_t code,
+                                  unsigned char *value,
+                                  size_t capacity,
+                                  size_t *valueLength);
+
+/**
+ * Aggregates the selected rows by client, process type and interval of the log time. The rows are scanned
+ * without holding the lock, so that finishTransaction is not blocked by a query.
+ * @param[in] columns
+ *                opened column store [REQUIRED]
+ * @param[in] query
+ *                selection of the rows; an interval of 0 aggregates the whole period [REQUIRED]
+ * @param[out] volumes
+ *                allocated array of the aggregates ordered by interval, client and process type, to be released with
+ *                free [REQUIRED]
+ * @param[out] volumeCount
+ *                number of aggregates [REQUIRED]
+ * @return EXECUTION_OK, ERROR_PARAMETER_MISMATCH if the interval is negative or ERROR_STORAGE_FAILURE if no memory
+ *         could be allocated
+ */
+short int transactionColumnsAggregate(struct TransactionColumns *columns,
+                                      const struct TransactionColumnQuery *query,
+                                      struct TransactionVolume **volumes,
+                                      size_t *volumeCount);
+
+/**
+ * Writes the rows that have not been written yet and closes the column store.
+ * @param[in] columns
+ *                opened column store [REQUIRED]
+ * @return EXECUTION_OK or ERROR_STORAGE_FAILURE if the rows could not be written
+ */
+short int transactionColumnsClose(struct TransactionColumns *columns);
+
+#endif
@@ -0,0 +1,156 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "TransactionTable.h"
+
+#define TRANSACTION_TABLE_MIN_CAPACITY 64
+
+static size_t transactionTableHash(uint64_t transactionNumber,
+                                   size_t capacity)
+{
+    /* splitmix64 finalizer, the capacity is always a power of two */
+    uint64_t value = transactionNumber;
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+    value = value ^ (value >> 31);
+    return (size_t) value & (capacity - 1);
+}
+
+static short int transactionTableAllocate(struct TransactionTable *table,
+                                          size_t capacity)
+{
+    table->slots = calloc(capacity, sizeof *table->slots);
+    if (table->slots == NULL) {
+        return ERROR_STORAGE_FAILURE;
+    }
+    table->capacity = capacity;
+    table->count = 0;
+    return EXECUTION_OK;
+}
+
+static short int transactionTableGrow(struct TransactionTable *table)
+{
+    struct OpenTransaction *previous = table->slots;
+    size_t previousCapacity = table->capacity;
+    size_t i;
+
+    if (transactionTableAllocate(table, previousCapacity * 2) != EXECUTION_OK) {
+        table->slots = previous;
+        table->capacity = previousCapacity;
+        return ERROR_STORAGE_FAILURE;
+    }
+    for (i = 0; i < previousCapacity; i++) {
+        if (previous[i].transactionNumber != 0) {
+            transactionTableInsert(table, &previous[i], NULL);
+        }
+    }
+    free(previous);
+    return EXECUTION_OK;
+}
+
+short int transactionTableInit(struct TransactionTable *table,
+                               size_t initialCapacity)
+{
+    size_t capacity = TRANSACTION_TABLE_MIN_CAPACITY;
+
+    /* keep the load factor below 0.7 for the expected number of entries */
+    while (capacity * 7 < initialCapacity * 10) {
+        capacity *= 2;
+    }
+    return transactionTableAllocate(table, capacity);
+}
+
+void transactionTableFree(struct TransactionTable *table)
+{
+    free(table->slots);
+    table->slots = NULL;
+    table->capacity = 0;
+    table->count = 0;
+}
+
+struct OpenTransaction *transactionTableFind(const struct TransactionTable *table,
+                                             uint64_t transactionNumber)
+{
+    size_t index = transactionTableHash(transactionNumber, table->capacity);
+
+    while (table->slots[index].transactionNumber != 0) {
+        if (table->slots[index].transactionNumber == transactionNumber) {
+            return &table->slots[index];
+        }
+        index = (index + 1) & (table->capacity - 1);
+    }
+    return NULL;
+}
+
+short int transactionTableReserve(struct TransactionTable *table)
+{
+    if ((table->count + 1) * 10 > table->capacity * 7 && transactionTableGrow(table) != EXECUTION_OK) {
+        return ERROR_STORAGE_FAILURE;
+    }
+    return EXECUTION_OK;
+}
+
+short int transactionTableInsert(struct TransactionTable *table,
+                                 const struct OpenTransaction *entry,
+                                 struct OpenTransaction **slot)
+{
+    size_t index;
+
+    if (transactionTableReserve(table) != EXECUTION_OK) {
+        return ERROR_STORAGE_FAILURE;
+    }
+
+    index = transactionTableHash(entry->transactionNumber, table->capacity);
+    while (table->slots[index].transactionNumber != 0
+           && table->slots[index].transactionNumber != entry->transactionNumber) {
+        index = (index + 1) & (table->capacity - 1);
+    }
+    if (table->slots[index].transactionNumber == 0) {
+        table->count++;
+    }
+    table->slots[index] = *entry;
+    if (slot != NULL) {
+        *slot = &table->slots[index];
+    }
+    return EXECUTION_OK;
+}
+
+bool transactionTableRemove(struct TransactionTable *table,
+                            uint64_t transactionNumber)
+{
+    size_t mask = table->capacity - 1;
+    size_t hole;
+    size_t index;
+    struct OpenTransaction *entry = transactionTableFind(table, transactionNumber);
+
+    if (entry == NULL) {
+        return false;
+    }
+
+    /* backward shift deletion keeps the probe sequences intact without tombstones */
+    hole = (size_t) (entry - table->slots);
+    index = (hole + 1) & mask;
+    while (table->slots[index].transactionNumber != 0) {
+        size_t home = transactionTableHash(table->slots[index].transactionNumber, table->capacity);
+        if (((index - home) & mask) >= ((index - hole) & mask)) {
+            table->slots[hole] = table->slots[index];
+            hole = index;
+        }
+        index = (index + 1) & mask;
+    }
+    memset(&table->slots[hole], 0, sizeof table->slots[hole]);
+    table->count--;
+    return true;
+}
+
+struct OpenTransaction *transactionTableIterate(const struct TransactionTable *table,
+                                                size_t *cursor)
+{
+    while (*cursor < table->capacity) {
+        struct OpenTransaction *entry = &table->slots[(*cursor)++];
+        if (entry->transactionNumber != 0) {
+            return entry;
+        }
+    }
+    return NULL;
+}
@@ -0,0 +1,124 @@
+#ifndef SEAPI_BACKEND_TRANSACTION_TABLE_H
+#define SEAPI_BACKEND_TRANSACTION_TABLE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "../Exception.h"
+#include "../Constant.h"
+
+/**
+ * This header file defines the table of open transactions that is maintained by the SE API backend.
+ * The table is a hash table with open addressing keyed by the transaction number.
+ * Pointers to entries are only valid until the next insertion or removal.
+ */
+
+/**
+ * Maximum length of a clientId that is kept for an open transaction
+ */
+#define TRANSACTION_CLIENT_ID_MAX 128
+
+/**
+ * Entry flag that marks a transaction as finished (used while reconciling partial scans)
+ */
+#define OPEN_TRANSACTION_FINISHED 0x1u
+
+/**
+ * Represents a transaction that has been started and not yet finished.
+ * The transaction number 0 marks an unused slot.
+ */
+struct OpenTransaction {
+    uint64_t transactionNumber;
+    uint64_t lastSignatureCounter;
+    int64_t startTime;
+    int64_t lastUpdateTime;
+    uint32_t flags;
+    uint32_t timerNode;
+    uint16_t clientIdLength;
+    unsigned char clientId[TRANSACTION_CLIENT_ID_MAX];
+};
+
+/**
+ * State of a transaction table. The members are managed by the functions of this header file.
+ */
+struct TransactionTable {
+    struct OpenTransaction *slots;
+    size_t capacity;
+    size_t count;
+};
+
+/**
+ * Initializes an empty table.
+ * @param[out] table
+ *                table to be initialized [REQUIRED]
+ * @param[in] initialCapacity
+ *                expected number of entries, 0 selects a small default [REQUIRED]
+ * @return EXECUTION_OK or ERROR_STORAGE_FAILURE if no memory could be allocated
+ */
+short int transactionTableInit(struct TransactionTable *table,
+                               size_t initialCapacity);
+
+/**
+ * Releases the memory of the table.
+ * @param[in] table
+ *                initialized table [REQUIRED]
+ */
+void transactionTableFree(struct TransactionTable *table);
+
+/**
+ * Searches the entry of a transaction.
+ * @param[in] table
+ *                initialized table [REQUIRED]
+ * @param[in] transactionNumber
+ *                number of the transaction [REQUIRED]
+ * @return the entry or NULL if the transaction is not contained in the table
+ */
+struct OpenTransaction *transactionTableFind(const struct TransactionTable *table,
+                                             uint64_t transactionNumber);
+
+/**
+ * Enlarges the table if needed, so that the next insertion of an entry does not fail.
+ * @param[in] table
+ *                initialized table [REQUIRED]
+ * @return EXECUTION_OK or ERROR_STORAGE_FAILURE if the table could not be enlarged
+ */
+short int transactionTableReserve(struct TransactionTable *table);
+
+/**
+ * Inserts an entry or replaces the entry with the same transaction number.
+ * @param[in] table
+ *                initialized table [REQUIRED]
+ * @param[in] entry
+ *                entry to be copied into the table, the transaction number MUST NOT be 0 [REQUIRED]
+ * @param[out] slot
+ *                position of the stored entry [OPTIONAL]
+ * @return EXECUTION_OK or ERROR_STORAGE_FAILURE if the table could not be enlarged
+ */
+short int transactionTableInsert(struct TransactionTable *table,
+                                 const struct OpenTransaction *entry,
+                                 struct OpenTransaction **slot);
+
+/**
+ * Removes the entry of a transaction.
+ * @param[in] table
+ *                initialized table [REQUIRED]
+ * @param[in] transactionNumber
+ *                number of the transaction [REQUIRED]
+ * @return true if an entry has been removed
+ */
+bool transactionTableRemove(struct TransactionTable *table,
+                            uint64_t transactionNumber);
+
+/**
+ * Iterates over the entries of the table. The table MUST NOT be modified during the iteration.
+ * @param[in] table
+ *                initialized table [REQUIRED]
+ * @param[in,out] cursor
+ *                position of the iteration, 0 for the first call [REQUIRED]
+ * @return the next entry or NULL if all entries have been visited
+ */
+struct OpenTransaction *transactionTableIterate(const struct TransactionTable *table,
+                                                size_t *cursor);
+
+#endif
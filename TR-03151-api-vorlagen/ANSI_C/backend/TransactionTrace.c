@@ -0,0 +1,335 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "TransactionTrace.h"
+
+#define TRANSACTION_TRACE_DURATION_MASK ((1ull << 40) - 1)
+
+static const char *const transactionTracePhaseNames[] = {
+    "startTransaction", "updateTransaction", "finishTransaction", "queueing", "counters", "storage", "index",
+    "receiptCode", "replication"
+};
+
+/**
+ * Copy of a span taken by transactionTraceDump
+ */
+struct TransactionTraceCopy {
+    uint64_t transactionNumber;
+    uint64_t start;
+    uint64_t info;
+};
+
+/**
+ * Destructor of the thread-specific key: the buffer of an ended thread is taken over by the next new thread, its
+ * spans are kept until they are overwritten.
+ */
+static void transactionTraceRelease(void *value)
+{
+    atomic_store(&((struct TransactionTraceBuffer *) value)->released, true);
+}
+
+/**
+ * Returns the buffer of the calling thread, which is taken over or allocated on its first span.
+ * @return the buffer or NULL if no buffer is available
+ */
+static struct TransactionTraceBuffer *transactionTraceBuffer(struct TransactionTrace *trace)
+{
+    struct TransactionTraceBuffer *buffer;
+    size_t bufferCount;
+    size_t index;
+
+    if (!atomic_load_explicit(&trace->keyCreated, memory_order_acquire)) {
+        return NULL;
+    }
+    buffer = pthread_getspecific(trace->key);
+    if (buffer != NULL) {
+        return buffer;
+    }
+
+    bufferCount = atomic_load(&trace->bufferCount);
+    for (index = 0; index < bufferCount && index < TRANSACTION_TRACE_MAX_THREADS; index++) {
+        bool released = true;
+
+        buffer = atomic_load(&trace->buffers[index]);
+        if (buffer != NULL && atomic_compare_exchange_strong(&buffer->released, &released, false)) {
+            pthread_setspecific(trace->key, buffer);
+            return buffer;
+        }
+    }
+    index = atomic_fetch_add(&trace->bufferCount, 1);
+    if (index >= TRANSACTION_TRACE_MAX_THREADS) {
+        return NULL;
+    }
+    buffer = calloc(1, sizeof *buffer);
+    if (buffer == NULL) {
+        return NULL;
+    }
+    atomic_store(&trace->buffers[index], buffer);
+    pthread_setspecific(trace->key, buffer);
+    return buffer;
+}
+
+static void transactionTraceWriteString(FILE *file,
+                                        const char *value)
+{
+    fputc('"', file);
+    for (; *value != '\0'; value++) {
+        unsigned char c = (unsigned char) *value;
+
+        if (c == '"' || c == '\\') {
+            fputc('\\', file);
+            fputc(c, file);
+        } else if (c < 0x20) {
+            fprintf(file, "\\u%04x", c);
+        } else {
+            fputc(c, file);
+        }
+    }
+    fputc('"', file);
+}
+
+/**
+ * Copies the spans of a buffer that have not been overwritten during the copy.
+ * @return the number of copied spans
+ */
+static size_t transactionTraceCopy(struct TransactionTraceBuffer *buffer,
+                                   struct TransactionTraceCopy *copies)
+{
+    uint64_t written = atomic_load_explicit(&buffer->written, memory_order_acquire);
+    uint64_t first = written > TRANSACTION_TRACE_BUFFER_EVENTS ? written - TRANSACTION_TRACE_BUFFER_EVENTS : 0;
+    uint64_t begun;
+    uint64_t index;
+    size_t count = 0;
+
+    for (index = first; index < written; index++) {
+        struct TransactionTraceEvent *event = &buffer->events[index & (TRANSACTION_TRACE_BUFFER_EVENTS - 1)];
+
+        copies[index - first].transactionNumber = atomic_load_explicit(&event->transactionNumber,
+                                                                       memory_order_relaxed);
+        copies[index - first].start = atomic_load_explicit(&event->start, memory_order_relaxed);
+        copies[index - first].info = atomic_load_explicit(&event->info, memory_order_relaxed);
+    }
+    atomic_thread_fence(memory_order_acquire);
+    begun = atomic_load_explicit(&buffer->begun, memory_order_relaxed);
+
+    /* the spans below begun - TRANSACTION_TRACE_BUFFER_EVENTS may have been overwritten while they were copied */
+    if (begun > first + TRANSACTION_TRACE_BUFFER_EVENTS) {
+        uint64_t overwritten = begun - TRANSACTION_TRACE_BUFFER_EVENTS - first;
+
+        if (overwritten >= written - first) {
+            return 0;
+        }
+        memmove(copies, copies + overwritten, (size_t) (written - first - overwritten) * sizeof *copies);
+        count = (size_t) (written - first - overwritten);
+    } else {
+        count = (size_t) (written - first);
+    }
+    return count;
+}
+
+void transactionTraceInit(struct TransactionTrace *trace)
+{
+    size_t i;
+
+    atomic_init(&trace->keyCreated, false);
+    atomic_init(&trace->samplingInterval, 0);
+    for (i = 0; i < TRANSACTION_TRACE_MAX_THREADS; i++) {
+        atomic_init(&trace->buffers[i], NULL);
+    }
+    atomic_init(&trace->bufferCount, 0);
+    atomic_init(&trace->droppedEvents, 0);
+    pthread_mutex_init(&trace->lock, NULL);
+    trace->sources = NULL;
+    trace->sourceCount = 0;
+    trace->sourceCapacity = 0;
+}
+
+uint32_t transactionTraceAddSource(struct TransactionTrace *trace,
+                                   const char *name)
+{
+    uint32_t source = 0;
+    char *copy = strdup(name);
+    size_t i;
+
+    pthread_mutex_lock(&trace->lock);
+
+    /* a backend that is opened again, e.g. a tenant that is attached again, keeps its source */
+    for (i = 0; i < trace->sourceCount; i++) {
+        if (strcmp(trace->sources[i], name) == 0) {
+            pthread_mutex_unlock(&trace->lock);
+            free(copy);
+            return (uint32_t) i + 1;
+        }
+    }
+    if (copy != NULL && trace->sourceCount == trace->sourceCapacity && trace->sourceCount < UINT16_MAX) {
+        size_t capacity = trace->sourceCapacity != 0 ? 2 * trace->sourceCapacity : 16;
+        char **sources = realloc(trace->sources, capacity * sizeof *sources);
+
+        if (sources != NULL) {
+            trace->sources = sources;
+            trace->sourceCapacity = capacity;
+        }
+    }
+    if (copy != NULL && trace->sourceCount < trace->sourceCapacity && trace->sourceCount < UINT16_MAX) {
+        trace->sources[trace->sourceCount++] = copy;
+        source = (uint32_t) trace->sourceCount;
+        copy = NULL;
+    }
+    pthread_mutex_unlock(&trace->lock);
+    free(copy);
+    return source;
+}
+
+void transactionTraceSetSampling(struct TransactionTrace *trace,
+                                 uint32_t samplingInterval)
+{
+    if (samplingInterval != 0 && !atomic_load(&trace->keyCreated)) {
+        pthread_mutex_lock(&trace->lock);
+        if (!atomic_load(&trace->keyCreated) && pthread_key_create(&trace->key, transactionTraceRelease) == 0) {
+            atomic_store_explicit(&trace->keyCreated, true, memory_order_release);
+        }
+        pthread_mutex_unlock(&trace->lock);
+    }
+    atomic_store(&trace->samplingInterval, samplingInterval);
+}
+
+bool transactionTraceEnabled(struct TransactionTrace *trace)
+{
+    return atomic_load_explicit(&trace->samplingInterval, memory_order_relaxed) != 0;
+}
+
+bool transactionTraceSampled(struct TransactionTrace *trace,
+                             uint64_t transactionNumber)
+{
+    uint32_t samplingInterval = atomic_load_explicit(&trace->samplingInterval, memory_order_relaxed);
+
+    return samplingInterval != 0 && transactionNumber % samplingInterval == 0;
+}
+
+uint64_t transactionTraceNow(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t) now.tv_sec * 1000000000ull + (uint64_t) now.tv_nsec;
+}
+
+void transactionTraceRecord(struct TransactionTrace *trace,
+                            uint32_t source,
+                            enum TransactionTracePhase phase,
+                            uint64_t transactionNumber,
+                            uint64_t start,
+                            uint64_t end)
+{
+    struct TransactionTraceBuffer *buffer = transactionTraceBuffer(trace);
+    struct TransactionTraceEvent *event;
+    uint64_t duration = end > start ? end - start : 0;
+    uint64_t index;
+
+    if (buffer == NULL) {
+        atomic_fetch_add_explicit(&trace->droppedEvents, 1, memory_order_relaxed);
+        return;
+    }
+    if (duration > TRANSACTION_TRACE_DURATION_MASK) {
+        duration = TRANSACTION_TRACE_DURATION_MASK;
+    }
+
+    /* the buffer has a single writer, so its counters are advanced without a read-modify-write operation */
+    index = atomic_load_explicit(&buffer->written, memory_order_relaxed);
+    event = &buffer->events[index & (TRANSACTION_TRACE_BUFFER_EVENTS - 1)];
+    atomic_store_explicit(&buffer->begun, index + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    atomic_store_explicit(&event->transactionNumber, transactionNumber, memory_order_relaxed);
+    atomic_store_explicit(&event->start, start, memory_order_relaxed);
+    atomic_store_explicit(&event->info, duration | (uint64_t) phase << 40 | (uint64_t) (source & 0xFFFFu) << 48,
+                          memory_order_relaxed);
+    atomic_store_explicit(&buffer->written, index + 1, memory_order_release);
+}
+
+short int transactionTraceDump(struct TransactionTrace *trace,
+                               const char *path)
+{
+    struct TransactionTraceCopy *copies;
+    FILE *file;
+    size_t bufferCount = atomic_load(&trace->bufferCount);
+    const char *separator = "";
+    size_t index;
+    size_t i;
+    int closeResult;
+
+    copies = malloc(TRANSACTION_TRACE_BUFFER_EVENTS * sizeof *copies);
+    if (copies == NULL) {
+        return ERROR_STORAGE_FAILURE;
+    }
+    file = fopen(path, "w");
+    if (file == NULL) {
+        free(copies);
+        return ERROR_STORAGE_FAILURE;
+    }
+
+    fputs("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[", file);
+    pthread_mutex_lock(&trace->lock);
+    for (i = 0; i < trace->sourceCount; i++) {
+        fprintf(file, "%s\n{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%zu,\"tid\":0,\"args\":{\"name\":",
+                separator, i + 1);
+        transactionTraceWriteString(file, trace->sources[i]);
+        fputs("}}", file);
+        separator = ",";
+    }
+    pthread_mutex_unlock(&trace->lock);
+
+    for (index = 0; index < bufferCount && index < TRANSACTION_TRACE_MAX_THREADS; index++) {
+        struct TransactionTraceBuffer *buffer = atomic_load(&trace->buffers[index]);
+        size_t count;
+
+        if (buffer == NULL) {
+            continue;
+        }
+        count = transactionTraceCopy(buffer, copies);
+        for (i = 0; i < count; i++) {
+            uint64_t duration = copies[i].info & TRANSACTION_TRACE_DURATION_MASK;
+            unsigned int phase = (unsigned int) (copies[i].info >> 40 & 0xFFu);
+
+            if (phase >= sizeof transactionTracePhaseNames / sizeof *transactionTracePhaseNames) {
+                continue;
+            }
+            /* the timestamps of the format are microseconds */
+            fprintf(file,
+                    "%s\n{\"name\":\"%s\",\"cat\":\"transaction\",\"ph\":\"X\",\"pid\":%u,\"tid\":%zu,"
+                    "\"ts\":%llu.%03u,\"dur\":%llu.%03u,\"args\":{\"transactionNumber\":%llu}}",
+                    separator, transactionTracePhaseNames[phase], (unsigned int) (copies[i].info >> 48), index + 1,
+                    (unsigned long long) (copies[i].start / 1000), (unsigned int) (copies[i].start % 1000),
+                    (unsigned long long) (duration / 1000), (unsigned int) (duration % 1000),
+                    (unsigned long long) copies[i].transactionNumber);
+            separator = ",";
+        }
+    }
+    fprintf(file, "\n],\"otherData\":{\"droppedEvents\":\"%llu\"}}\n",
+            (unsigned long long) atomic_load(&trace->droppedEvents));
+    free(copies);
+
+    closeResult = ferror(file) ? EOF : 0;
+    if (fclose(file) != 0 || closeResult != 0) {
+        return ERROR_STORAGE_FAILURE;
+    }
+    return EXECUTION_OK;
+}
+
+void transactionTraceClose(struct TransactionTrace *trace)
+{
+    size_t i;
+
+    if (atomic_load(&trace->keyCreated)) {
+        pthread_key_delete(trace->key);
+    }
+    for (i = 0; i < TRANSACTION_TRACE_MAX_THREADS; i++) {
+        free(atomic_load(&trace->buffers[i]));
+    }
+    for (i = 0; i < trace->sourceCount; i++) {
+        free(trace->sources[i]);
+    }
+    free(trace->sources);
+    pthread_mutex_destroy(&trace->lock);
+}
@@ -0,0 +1,184 @@
+#ifndef SEAPI_BACKEND_TRANSACTION_TRACE_H
+#define SEAPI_BACKEND_TRANSACTION_TRACE_H
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "../Exception.h"
+#include "../Constant.h"
+
+/**
+ * This header file defines the tracing of the transaction functions of the SE API backend, which attributes the
+ * time of startTransaction, updateTransaction and finishTransaction to their phases, e.g. the wait for the append
+ * lock or the write to the log store, per transaction number.
+ *
+ * Every thread that records a span writes to a ring buffer of its own, which it finds through a thread-specific key,
+ * so that recording takes neither a lock nor an atomic read-modify-write operation. The ring keeps the latest
+ * TRANSACTION_TRACE_BUFFER_EVENTS spans of the thread. transactionTraceDump copies the rings while they are written
+ * and discards the spans that have been overwritten meanwhile, and writes them to a file in the JSON trace event
+ * format, which is read by chrome://tracing and the Perfetto UI. Every backend that records to a trace is a source,
+ * which is shown as a process named after the directory of the backend.
+ *
+ * A transaction is traced if its transaction number is a multiple of the sampling interval, so that all calls of a
+ * traced transaction are recorded. The sampling interval 0 disables the tracing, which then costs one atomic load
+ * per call.
+ */
+
+/**
+ * Number of spans that the ring buffer of a thread holds, a power of two
+ */
+#define TRANSACTION_TRACE_BUFFER_EVENTS 16384u
+
+/**
+ * Maximum number of ring buffers of a trace. The buffer of a thread that has ended is taken over by the next new
+ * thread; spans of further threads are dropped.
+ */
+#define TRANSACTION_TRACE_MAX_THREADS 256
+
+/**
+ * Phases of a transaction function. The first three phases span the whole call.
+ */
+enum TransactionTracePhase {
+transactionTraceStartTransaction, transactionTraceUpdateTransaction, transactionTraceFinishTransaction, transactionTraceQueueing, transactionTraceCounters, transactionTraceStorage, transactionTraceIndex, transactionTraceReceiptCode, transactionTraceReplication
+};
+
+/**
+ * Span in a ring buffer. The members are atomic, so that a concurrent dump reads them without a data race; the
+ * member info holds the duration in nanoseconds in the bits 0 to 39, the phase in the bits 40 to 47 and the source
+ * in the bits 48 to 63.
+ */
+struct TransactionTraceEvent {
+    _Atomic uint64_t transactionNumber;
+    _Atomic uint64_t start;
+    _Atomic uint64_t info;
+};
+
+/**
+ * Ring buffer of a thread. Only its thread writes it: begun is increased before a span is written and written
+ * after, so that a reader can tell which spans have been overwritten while it has copied them.
+ */
+struct TransactionTraceBuffer {
+    _Atomic uint64_t begun;
+    _Atomic uint64_t written;
+    atomic_bool released;
+    struct TransactionTraceEvent events[TRANSACTION_TRACE_BUFFER_EVENTS];
+};
+
+/**
+ * State of a trace. The members are managed by the functions of this header file; the members after lock MUST only
+ * be accessed while holding it.
+ */
+struct TransactionTrace {
+    pthread_key_t key;
+    atomic_bool keyCreated;
+    _Atomic uint32_t samplingInterval;
+    struct TransactionTraceBuffer *_Atomic buffers[TRANSACTION_TRACE_MAX_THREADS];
+    _Atomic size_t bufferCount;
+    _Atomic uint64_t droppedEvents;
+    pthread_mutex_t lock;
+    char **sources;
+    size_t sourceCount;
+    size_t sourceCapacity;
+};
+
+/**
+ * Initializes a trace with the sampling interval 0.
+ * @param[out] trace
+ *                trace to be initialized [REQUIRED]
+ */
+void transactionTraceInit(struct TransactionTrace *trace);
+
+/**
+ * Registers a backend that records to a trace. A name that is already registered returns its source.
+ * @param[in] trace
+ *                initialized trace [REQUIRED]
+ * @param[in] name
+ *                name of the source in the dump, e.g. the directory of the backend, terminated by NUL [REQUIRED]
+ * @return the number of the source, or 0 if the source could not be registered, whose spans are dumped without
+ *         its name
+ */
+uint32_t transactionTraceAddSource(struct TransactionTrace *trace,
+                                   const char *name);
+
+/**
+ * Sets the sampling interval of a trace. The thread-specific key of the trace, of which a process has a limited
+ * number, is created by the first interval that is not 0; if no key is available, no spans are recorded.
+ * @param[in] trace
+ *                initialized trace [REQUIRED]
+ * @param[in] samplingInterval
+ *                the transactions whose transaction number is a multiple of this interval are traced, 0 to disable
+ *                the tracing [REQUIRED]
+ */
+void transactionTraceSetSampling(struct TransactionTrace *trace,
+                                 uint32_t samplingInterval);
+
+/**
+ * Checks whether spans are to be taken, before the transaction number of a call is known.
+ * @param[in] trace
+ *                initialized trace [REQUIRED]
+ * @return true if the sampling interval is not 0
+ */
+bool transactionTraceEnabled(struct TransactionTrace *trace);
+
+/**
+ * Checks whether a transaction is traced.
+ * @param[in] trace
+ *                initialized trace [REQUIRED]
+ * @param[in] transactionNumber
+ *                transaction number of the transaction [REQUIRED]
+ * @return true if the spans of the transaction are recorded
+ */
+bool transactionTraceSampled(struct TransactionTrace *trace,
+                             uint64_t transactionNumber);
+
+/**
+ * Returns the time of the clock of the spans.
+ * @return the monotonic time in nanoseconds
+ */
+uint64_t transactionTraceNow(void);
+
+/**
+ * Records a span in the ring buffer of the calling thread.
+ * @param[in] trace
+ *                initialized trace [REQUIRED]
+ * @param[in] source
+ *                number of the source returned by transactionTraceAddSource [REQUIRED]
+ * @param[in] phase
+ *                value of enum TransactionTracePhase [REQUIRED]
+ * @param[in] transactionNumber
+ *                transaction number of the transaction [REQUIRED]
+ * @param[in] start
+ *                start of the span, returned by transactionTraceNow [REQUIRED]
+ * @param[in] end
+ *                end of the span, returned by transactionTraceNow [REQUIRED]
+ */
+void transactionTraceRecord(struct TransactionTrace *trace,
+                            uint32_t source,
+                            enum TransactionTracePhase phase,
+                            uint64_t transactionNumber,
+                            uint64_t start,
+                            uint64_t end);
+
+/**
+ * Writes the recorded spans to a file in the JSON trace event format. The spans are recorded further during the
+ * dump and stay recorded after it.
+ * @param[in] trace
+ *                initialized trace [REQUIRED]
+ * @param[in] path
+ *                path of the file, which is replaced, terminated by NUL [REQUIRED]
+ * @return EXECUTION_OK or ERROR_STORAGE_FAILURE if the file could not be written
+ */
+short int transactionTraceDump(struct TransactionTrace *trace,
+                               const char *path);
+
+/**
+ * Releases the memory of a trace. No thread MAY record to it concurrently.
+ * @param[in] trace
+ *                initialized trace [REQUIRED]
+ */
+void transactionTraceClose(struct TransactionTrace *trace);
+
+#endif
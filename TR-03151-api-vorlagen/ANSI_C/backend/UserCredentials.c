@@ -0,0 +1,526 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/random.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "UserCredentials.h"
+#include "Crc32.h"
+#include "Scrypt.h"
+
+/**
+ * Identifies a credential file ("SUSR") and its layout version
+ */
+#define CREDENTIALS_MAGIC 0x53555352u
+#define CREDENTIALS_VERSION 1u
+
+#define CREDENTIALS_FILE_NAME "users.dat"
+#define CREDENTIALS_TEMPORARY_FILE_NAME "users.dat.tmp"
+
+/**
+ * Layout of the header of the credential file. It is followed by userCount entries.
+ * The checksum covers the whole file with the member crc set to 0.
+ */
+struct CredentialsHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t userCount;
+    uint32_t crc;
+};
+
+static short int userCredentialsFilePath(const struct UserCredentials *credentials,
+                                         const char *name,
+                                         char *path,
+                                         size_t pathSize)
+{
+    int length = snprintf(path, pathSize, "%s/%s", credentials->directory, name);
+
+    if (length < 0 || (size_t) length >= pathSize) {
+        return ERROR_PARAMETER_MISMATCH;
+    }
+    return EXECUTION_OK;
+}
+
+static short int userCredentialsSyncDirectory(const char *directory)
+{
+    int fd = open(directory, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    short int result = EXECUTION_OK;
+
+    if (fd < 0) {
+        return ERROR_STORAGE_FAILURE;
+    }
+    if (fsync(fd) != 0) {
+        result = ERROR_STORAGE_FAILURE;
+    }
+    close(fd);
+    return result;
+}
+
+/**
+ * Replaces the credential file by the entries in memory. The caller holds the lock.
+ */
+static short int userCredentialsPersist(struct UserCredentials *credentials)
+{
+    char path[4096];
+    char temporaryPath[4096];
+    struct CredentialsHeader header;
+    unsigned char content[sizeof(struct CredentialsHeader)
+                          + USER_CREDENTIALS_MAX_USERS * sizeof(struct UserCredential)];
+    size_t contentLength = sizeof header + credentials->userCount * sizeof(struct UserCredential);
+    size_t position = 0;
+    short int result = EXECUTION_OK;
+    int fd;
+
+    if (userCredentialsFilePath(credentials, CREDENTIALS_FILE_NAME, path, sizeof path) != EXECUTION_OK
+        || userCredentialsFilePath(credentials, CREDENTIALS_TEMPORARY_FILE_NAME, temporaryPath,
+                                   sizeof temporaryPath) != EXECUTION_OK) {
+        return ERROR_STORAGE_FAILURE;
+    }
+
+    memset(&header, 0, sizeof header);
+    header.magic = CREDENTIALS_MAGIC;
+    header.version = CREDENTIALS_VERSION;
+    header.userCount = (uint32_t) credentials->userCount;
+    memcpy(content, &header, sizeof header);
+    memcpy(content + sizeof header, credentials->users, credentials->userCount * sizeof(struct UserCredential));
+    header.crc = crc32Update(0, content, contentLength);
+    memcpy(content, &header, sizeof header);
+
+    fd = open(temporaryPath, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+    if (fd < 0) {
+        return ERROR_STORAGE_FAILURE;
+    }
+    while (position < contentLength) {
+        ssize_t written = write(fd, content + position, contentLength - position);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            result = ERROR_STORAGE_FAILURE;
+            break;
+        }
+        position += (size_t) written;
+    }
+    if (result == EXECUTION_OK && fdatasync(fd) != 0) {
+        result = ERROR_STORAGE_FAILURE;
+    }
+    close(fd);
+    if (result == EXECUTION_OK && rename(temporaryPath, path) != 0) {
+        result = ERROR_STORAGE_FAILURE;
+    }
+    if (result == EXECUTION_OK) {
+        result = userCredentialsSyncDirectory(credentials->directory);
+    }
+    return result;
+}
+
+static short int userCredentialsLoad(struct UserCredentials *credentials)
+{
+    char path[4096];
+    struct CredentialsHeader header;
+    unsigned char content[sizeof(struct CredentialsHeader)
+                          + USER_CREDENTIALS_MAX_USERS * sizeof(struct UserCredential)];
+    size_t contentLength = 0;
+    uint32_t crc;
+    int fd;
+
+    if (userCredentialsFilePath(credentials, CREDENTIALS_FILE_NAME, path, sizeof path) != EXECUTION_OK) {
+        return ERROR_STORAGE_FAILURE;
+    }
+    fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return errno == ENOENT ? EXECUTION_OK : ERROR_STORAGE_FAILURE;
+    }
+    for (;;) {
+        ssize_t length = read(fd, content + contentLength, sizeof content - contentLength);
+        if (length < 0 && errno == EINTR) {
+            continue;
+        }
+        if (length < 0) {
+            close(fd);
+            return ERROR_STORAGE_FAILURE;
+        }
+        if (length == 0 || contentLength + (size_t) length == sizeof content) {
+            contentLength += (size_t) length;
+            break;
+        }
+        contentLength += (size_t) length;
+    }
+    close(fd);
+
+    if (contentLength < sizeof header) {
+        return ERROR_STORAGE_FAILURE;
+    }
+    memcpy(&header, content, sizeof header);
+    if (header.magic != CREDENTIALS_MAGIC || header.version != CREDENTIALS_VERSION
+        || header.userCount > USER_CREDENTIALS_MAX_USERS
+        || contentLength != sizeof header + header.userCount * sizeof(struct UserCredential)) {
+        return ERROR_STORAGE_FAILURE;
+    }
+    crc = header.crc;
+    header.crc = 0;
+    memcpy(content, &header, sizeof header);
+    if (crc32Update(0, content, contentLength) != crc) {
+        return ERROR_STORAGE_FAILURE;
+    }
+    memcpy(credentials->users, content + sizeof header, header.userCount * sizeof(struct UserCredential));
+    credentials->userCount = header.userCount;
+    return EXECUTION_OK;
+}
+
+/**
+ * @return the index of the user or USER_CREDENTIALS_MAX_USERS if the user is not managed
+ */
+static size_t userCredentialsFind(const struct UserCredentials *credentials,
+                                  const unsigned char *userId,
+                                  unsigned int userIdLength)
+{
+    size_t i;
+
+    for (i = 0; i < credentials->userCount; i++) {
+        if (credentials->users[i].userIdLength == userIdLength
+            && memcmp(credentials->users[i].userId, userId, userIdLength) == 0) {
+            return i;
+        }
+    }
+    return USER_CREDENTIALS_MAX_USERS;
+}
+
+static short int userCredentialsRandom(unsigned char *data,
+                                       size_t dataLength)
+{
+    while (dataLength > 0) {
+        ssize_t length = getrandom(data, dataLength, 0);
+        if (length < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return ERROR_STORAGE_FAILURE;
+        }
+        data += length;
+        dataLength -= (size_t) length;
+    }
+    return EXECUTION_OK;
+}
+
+/**
+ * Compares two hashes in a time that does not depend on the position of the first difference.
+ */
+static bool userCredentialsHashEqual(const unsigned char *hash,
+                                     const unsigned char *expectedHash)
+{
+    volatile unsigned char difference = 0;
+    size_t i;
+
+    for (i = 0; i < USER_CREDENTIALS_HASH_LENGTH; i++) {
+        difference |= hash[i] ^ expectedHash[i];
+    }
+    return difference == 0;
+}
+
+static short int userCredentialsDerive(const struct UserCredential *entry,
+                                       const unsigned char *secret,
+                                       unsigned int secretLength,
+                                       const unsigned char *salt,
+                                       unsigned char *hash)
+{
+    short int result = scryptDerive(secret, secretLength, salt, USER_CREDENTIALS_SALT_LENGTH, entry->costLog2,
+                                    entry->blockSize, entry->parallelism, hash, USER_CREDENTIALS_HASH_LENGTH);
+
+    /* parameters that scrypt refuses can only stem from a damaged file */
+    return result == EXECUTION_OK ? EXECUTION_OK : ERROR_STORAGE_FAILURE;
+}
+
+/**
+ * Derives and discards a hash with the parameters of new hashes, so that an unknown userId takes as long to be
+ * answered as a wrong PIN or PUK and cannot be told apart from a managed user by the response time.
+ */
+static void userCredentialsDeriveDummy(const struct UserCredentials *credentials,
+                                       const unsigned char *secret,
+                                       unsigned int secretLength)
+{
+    struct UserCredential entry;
+    unsigned char hash[USER_CREDENTIALS_HASH_LENGTH];
+
+    memset(&entry, 0, sizeof entry);
+    entry.costLog2 = (uint8_t) credentials->costLog2;
+    entry.blockSize = SCRYPT_DEFAULT_BLOCK_SIZE;
+    entry.parallelism = SCRYPT_DEFAULT_PARALLELISM;
+    (void) userCredentialsDerive(&entry, secret, secretLength, entry.pinSalt, hash);
+}
+
+/**
+ * Sets a new salt and the hash of the PIN of an entry that is not visible to other threads.
+ */
+static short int userCredentialsHashPin(struct UserCredential *entry,
+                                        const unsigned char *pin,
+                                        unsigned int pinLength)
+{
+    short int result = userCredentialsRandom(entry->pinSalt, sizeof entry->pinSalt);
+
+    if (result == EXECUTION_OK) {
+        result = userCredentialsDerive(entry, pin, pinLength, entry->pinSalt, entry->pinHash);
+    }
+    return result;
+}
+
+short int userCredentialsOpen(struct UserCredentials *credentials,
+                              const char *directory,
+                              unsigned int costLog2)
+{
+    short int result;
+
+    memset(credentials, 0, sizeof *credentials);
+    credentials->costLog2 = costLog2 != 0 ? costLog2 : SCRYPT_DEFAULT_COST_LOG2;
+    credentials->directory = strdup(directory);
+    if (credentials->directory == NULL) {
+        return ERROR_STORAGE_FAILURE;
+    }
+    result = userCredentialsLoad(credentials);
+    if (result != EXECUTION_OK) {
+        free(credentials->directory);
+        credentials->directory = NULL;
+        return result;
+    }
+    pthread_mutex_init(&credentials->lock, NULL);
+    return EXECUTION_OK;
+}
+
+short int userCredentialsSet(struct UserCredentials *credentials,
+                             const unsigned char *userId,
+                             unsigned int userIdLength,
+                             const unsigned char *pin,
+                             unsigned int pinLength,
+                             const unsigned char *puk,
+                             unsigned int pukLength,
+                             uint32_t permissions)
+{
+    struct UserCredential entry;
+    struct UserCredential previous;
+    size_t index;
+    short int result;
+
+    if (userIdLength == 0 || userIdLength > USER_ID_MAX_LENGTH) {
+        return ERROR_PARAMETER_MISMATCH;
+    }
+    memset(&entry, 0, sizeof entry);
+    memcpy(entry.userId, userId, userIdLength);
+    entry.userIdLength = userIdLength;
+    entry.permissions = permissions;
+    entry.remainingPinRetries = USER_CREDENTIALS_MAX_PIN_RETRIES;
+    entry.remainingPukRetries = USER_CREDENTIALS_MAX_PUK_RETRIES;
+    entry.costLog2 = (uint8_t) credentials->costLog2;
+    entry.blockSize = SCRYPT_DEFAULT_BLOCK_SIZE;
+    entry.parallelism = SCRYPT_DEFAULT_PARALLELISM;
+
+    /* the hashes are derived without holding the lock */
+    result = userCredentialsHashPin(&entry, pin, pinLength);
+    if (result == EXECUTION_OK) {
+        result = userCredentialsRandom(entry.pukSalt, sizeof entry.pukSalt);
+    }
+    if (result == EXECUTION_OK) {
+        result = userCredentialsDerive(&entry, puk, pukLength, entry.pukSalt, entry.pukHash);
+    }
+    if (result != EXECUTION_OK) {
+        return result;
+    }
+
+    pthread_mutex_lock(&credentials->lock);
+    index = userCredentialsFind(credentials, userId, userIdLength);
+    if (index == USER_CREDENTIALS_MAX_USERS) {
+        if (credentials->userCount == USER_CREDENTIALS_MAX_USERS) {
+            pthread_mutex_unlock(&credentials->lock);
+            return ERROR_PARAMETER_MISMATCH;
+        }
+        index = credentials->userCount++;
+        memset(&previous, 0, sizeof previous);
+    } else {
+        previous = credentials->users[index];
+    }
+    credentials->users[index] = entry;
+    result = userCredentialsPersist(credentials);
+    if (result != EXECUTION_OK) {
+        if (previous.userIdLength == 0) {
+            credentials->userCount--;
+        } else {
+            credentials->users[index] = previous;
+        }
+    }
+    pthread_mutex_unlock(&credentials->lock);
+    return result;
+}
+
+short int userCredentialsAuthenticate(struct UserCredentials *credentials,
+                                      const unsigned char *userId,
+                                      unsigned int userIdLength,
+                                      const unsigned char *pin,
+                                      unsigned int pinLength,
+                                      enum CredentialCheck *result,
+                                      short int *remainingRetries,
+                                      uint32_t *permissions)
+{
+    struct UserCredential entry;
+    unsigned char hash[USER_CREDENTIALS_HASH_LENGTH];
+    size_t index;
+    short int status;
+
+    *remainingRetries = 0;
+    pthread_mutex_lock(&credentials->lock);
+    index = userCredentialsFind(credentials, userId, userIdLength);
+    if (index == USER_CREDENTIALS_MAX_USERS) {
+        pthread_mutex_unlock(&credentials->lock);
+        userCredentialsDeriveDummy(credentials, pin, pinLength);
+        *result = credentialUnknownUser;
+        return EXECUTION_OK;
+    }
+    if (credentials->users[index].remainingPinRetries == 0) {
+        pthread_mutex_unlock(&credentials->lock);
+        *result = credentialBlocked;
+        return EXECUTION_OK;
+    }
+
+    /* the attempt is counted durably before the PIN is verified */
+    credentials->users[index].remainingPinRetries--;
+    status = userCredentialsPersist(credentials);
+    if (status != EXECUTION_OK) {
+        credentials->users[index].remainingPinRetries++;
+        pthread_mutex_unlock(&credentials->lock);
+        return status;
+    }
+    entry = credentials->users[index];
+    pthread_mutex_unlock(&credentials->lock);
+
+    status = userCredentialsDerive(&entry, pin, pinLength, entry.pinSalt, hash);
+    if (status != EXECUTION_OK) {
+        return status;
+    }
+    if (!userCredentialsHashEqual(hash, entry.pinHash)) {
+        *result = credentialFailed;
+        *remainingRetries = (short int) entry.remainingPinRetries;
+        return EXECUTION_OK;
+    }
+
+    pthread_mutex_lock(&credentials->lock);
+    index = userCredentialsFind(credentials, userId, userIdLength);
+    if (index == USER_CREDENTIALS_MAX_USERS
+        || memcmp(credentials->users[index].pinSalt, entry.pinSalt, sizeof entry.pinSalt) != 0) {
+        /* the PIN has been replaced in the meantime */
+        pthread_mutex_unlock(&credentials->lock);
+        *result = credentialFailed;
+        return EXECUTION_OK;
+    }
+    entry.remainingPinRetries = credentials->users[index].remainingPinRetries;
+    credentials->users[index].remainingPinRetries = USER_CREDENTIALS_MAX_PIN_RETRIES;
+    status = userCredentialsPersist(credentials);
+    if (status != EXECUTION_OK) {
+        credentials->users[index].remainingPinRetries = entry.remainingPinRetries;
+        pthread_mutex_unlock(&credentials->lock);
+        return status;
+    }
+    *permissions = credentials->users[index].permissions;
+    pthread_mutex_unlock(&credentials->lock);
+
+    *result = credentialOk;
+    *remainingRetries = USER_CREDENTIALS_MAX_PIN_RETRIES;
+    return EXECUTION_OK;
+}
+
+short int userCredentialsUnblock(struct UserCredentials *credentials,
+                                 const unsigned char *userId,
+                                 unsigned int userIdLength,
+                                 const unsigned char *puk,
+                                 unsigned int pukLength,
+                                 const unsigned char *newPin,
+                                 unsigned int newPinLength,
+                                 enum CredentialCheck *result)
+{
+    struct UserCredential entry;
+    struct UserCredential previous;
+    unsigned char hash[USER_CREDENTIALS_HASH_LENGTH];
+    size_t index;
+    short int status;
+
+    pthread_mutex_lock(&credentials->lock);
+    index = userCredentialsFind(credentials, userId, userIdLength);
+    if (index == USER_CREDENTIALS_MAX_USERS) {
+        pthread_mutex_unlock(&credentials->lock);
+        userCredentialsDeriveDummy(credentials, puk, pukLength);
+        *result = credentialUnknownUser;
+        return EXECUTION_OK;
+    }
+    if (credentials->users[index].remainingPukRetries == 0) {
+        pthread_mutex_unlock(&credentials->lock);
+        *result = credentialBlocked;
+        return EXECUTION_OK;
+    }
+    credentials->users[index].remainingPukRetries--;
+    status = userCredentialsPersist(credentials);
+    if (status != EXECUTION_OK) {
+        credentials->users[index].remainingPukRetries++;
+        pthread_mutex_unlock(&credentials->lock);
+        return status;
+    }
+    entry = credentials->users[index];
+    pthread_mutex_unlock(&credentials->lock);
+
+    status = userCredentialsDerive(&entry, puk, pukLength, entry.pukSalt, hash);
+    if (status != EXECUTION_OK) {
+        return status;
+    }
+    if (!userCredentialsHashEqual(hash, entry.pukHash)) {
+        *result = credentialFailed;
+        return EXECUTION_OK;
+    }
+    status = userCredentialsHashPin(&entry, newPin, newPinLength);
+    if (status != EXECUTION_OK) {
+        return status;
+    }
+
+    pthread_mutex_lock(&credentials->lock);
+    index = userCredentialsFind(credentials, userId, userIdLength);
+    if (index == USER_CREDENTIALS_MAX_USERS
+        || memcmp(credentials->users[index].pukSalt, entry.pukSalt, sizeof entry.pukSalt) != 0) {
+        pthread_mutex_unlock(&credentials->lock);
+        *result = credentialFailed;
+        return EXECUTION_OK;
+    }
+    previous = credentials->users[index];
+    memcpy(credentials->users[index].pinSalt, entry.pinSalt, sizeof entry.pinSalt);
+    memcpy(credentials->users[index].pinHash, entry.pinHash, sizeof entry.pinHash);
+    credentials->users[index].remainingPinRetries = USER_CREDENTIALS_MAX_PIN_RETRIES;
+    credentials->users[index].remainingPukRetries = USER_CREDENTIALS_MAX_PUK_RETRIES;
+    status = userCredentialsPersist(credentials);
+    if (status != EXECUTION_OK) {
+        credentials->users[index] = previous;
+    }
+    pthread_mutex_unlock(&credentials->lock);
+    memset(&previous, 0, sizeof previous);
+    memset(&entry, 0, sizeof entry);
+
+    *result = status == EXECUTION_OK ? credentialOk : credentialFailed;
+    return status;
+}
+
+bool userCredentialsContains(struct UserCredentials *credentials,
+                             const unsigned char *userId,
+                             unsigned int userIdLength)
+{
+    bool contained;
+
+    pthread_mutex_lock(&credentials->lock);
+    contained = userCredentialsFind(credentials, userId, userIdLength) != USER_CREDENTIALS_MAX_USERS;
+    pthread_mutex_unlock(&credentials->lock);
+    return contained;
+}
+
+void userCredentialsClose(struct UserCredentials *credentials)
+{
+    pthread_mutex_destroy(&credentials->lock);
+    memset(credentials->users, 0, sizeof credentials->users);
+    credentials->userCount = 0;
+    free(credentials->directory);
+    credentials->directory = NULL;
+}
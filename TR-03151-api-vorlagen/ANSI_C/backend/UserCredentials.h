@@ -0,0 +1,216 @@
+#ifndef SEAPI_BACKEND_USER_CREDENTIALS_H
+#define SEAPI_BACKEND_USER_CREDENTIALS_H
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "../Exception.h"
+#include "../Constant.h"
+
+/**
+ * This header file defines the credential file of the users who or applications that may authenticate to the
+ * SE API backend.
+ *
+ * PINs and PUKs are stored as salted scrypt hashes, so that a copy of the file does not reveal them. The hash is
+ * only derived by authenticateUser and unblockUser; restricted functions rely on the session table instead. For an
+ * unknown userId a hash is derived as well, so that the response time does not reveal which users are managed.
+ * The retry counter of a user is decremented and written to the storage before the hash of an entered PIN is
+ * derived, so that an interrupted attempt still counts and the counter survives a loss of power. The file is
+ * replaced atomically by writing a temporary file and renaming it.
+ */
+
+/**
+ * Maximum number of users and maximum length of a userId
+ */
+#define USER_CREDENTIALS_MAX_USERS 64
+#define USER_ID_MAX_LENGTH 64
+
+/**
+ * Number of attempts to enter a PIN, respectively a PUK, before the PIN, respectively the PUK, is blocked
+ */
+#define USER_CREDENTIALS_MAX_PIN_RETRIES 3
+#define USER_CREDENTIALS_MAX_PUK_RETRIES 10
+
+#define USER_CREDENTIALS_SALT_LENGTH 16
+#define USER_CREDENTIALS_HASH_LENGTH 32
+
+/**
+ * Represents the result of the verification of a PIN or PUK. It corresponds to the values of
+ * enum AuthenticationResult and enum UnblockResult of the SE API.
+ */
+enum CredentialCheck {
+credentialOk, credentialFailed, credentialBlocked, credentialUnknownUser
+};
+
+/**
+ * Stored credentials of a user. The entries are written to the credential file as they are.
+ */
+struct UserCredential {
+    unsigned char userId[USER_ID_MAX_LENGTH];
+    uint32_t userIdLength;
+    uint32_t permissions;
+    uint16_t remainingPinRetries;
+    uint16_t remainingPukRetries;
+    uint8_t costLog2;
+    uint8_t blockSize;
+    uint8_t parallelism;
+    uint8_t reserved;
+    unsigned char pinSalt[USER_CREDENTIALS_SALT_LENGTH];
+    unsigned char pinHash[USER_CREDENTIALS_HASH_LENGTH];
+    unsigned char pukSalt[USER_CREDENTIALS_SALT_LENGTH];
+    unsigned char pukHash[USER_CREDENTIALS_HASH_LENGTH];
+};
+
+/**
+ * State of an opened credential file. The members are managed by the functions of this header file.
+ */
+struct UserCredentials {
+    char *directory;
+    pthread_mutex_t lock;
+    struct UserCredential users[USER_CREDENTIALS_MAX_USERS];
+    size_t userCount;
+    unsigned int costLog2;
+};
+
+/**
+ * Opens the credential file in the passed directory. A missing file results in a file without users.
+ * @param[out] credentials
+ *                credentials to be initialized [REQUIRED]
+ * @param[in] directory
+ *                existing directory that holds the credential file [REQUIRED]
+ * @param[in] costLog2
+ *                binary logarithm of the scrypt cost parameter for new hashes, 0 for SCRYPT_DEFAULT_COST_LOG2 [REQUIRED]
+ * @return if the execution of the function has been successful, the return value EXECUTION_OK SHALL be returned.
+ *
+ *         If the execution of the function has failed, the appropriate error code SHALL be returned:
+ *
+ *             ERROR_STORAGE_FAILURE
+ *                the credential file could not be read or is damaged
+ */
+short int userCredentialsOpen(struct UserCredentials *credentials,
+                              const char *directory,
+                              unsigned int costLog2);
+
+/**
+ * Adds a user or replaces the PIN, PUK and permissions of a user, and resets the retry counters.
+ * @param[in] credentials
+ *                opened credentials [REQUIRED]
+ * @param[in] userId
+ *                the ID of the user or application [REQUIRED]
+ * @param[in] userIdLength
+ *                the length of the array that represents the userId [REQUIRED]
+ * @param[in] pin
+ *                the PIN of the user [REQUIRED]
+ * @param[in] pinLength
+ *                the length of the array that represents the pin [REQUIRED]
+ * @param[in] puk
+ *                the PUK of the user [REQUIRED]
+ * @param[in] pukLength
+ *                the length of the array that represents the puk [REQUIRED]
+ * @param[in] permissions
+ *                bit mask of the restricted functions that the user may call [REQUIRED]
+ * @return if the execution of the function has been successful, the return value EXECUTION_OK SHALL be returned.
+ *
+ *         If the execution of the function has failed, the appropriate error code SHALL be returned:
+ *
+ *             ERROR_PARAMETER_MISMATCH
+ *                the userId is empty or too long, or the maximum number of users has been reached
+ *             ERROR_STORAGE_FAILURE
+ *                the credential file could not be written
+ */
+short int userCredentialsSet(struct UserCredentials *credentials,
+                             const unsigned char *userId,
+                             unsigned int userIdLength,
+                             const unsigned char *pin,
+                             unsigned int pinLength,
+                             const unsigned char *puk,
+                             unsigned int pukLength,
+                             uint32_t permissions);
+
+/**
+ * Verifies the PIN of a user. A successful verification resets the retry counter.
+ * @param[in] credentials
+ *                opened credentials [REQUIRED]
+ * @param[in] userId
+ *                the ID of the user or application [REQUIRED]
+ * @param[in] userIdLength
+ *                the length of the array that represents the userId [REQUIRED]
+ * @param[in] pin
+ *                the entered PIN [REQUIRED]
+ * @param[in] pinLength
+ *                the length of the array that represents the pin [REQUIRED]
+ * @param[out] result
+ *                the result of the verification [REQUIRED]
+ * @param[out] remainingRetries
+ *                the number of remaining retries to enter the PIN [REQUIRED]
+ * @param[out] permissions
+ *                the permissions of the user, only set for credentialOk [REQUIRED]
+ * @return if the execution of the function has been successful, the return value EXECUTION_OK SHALL be returned.
+ *
+ *         If the execution of the function has failed, the appropriate error code SHALL be returned:
+ *
+ *             ERROR_STORAGE_FAILURE
+ *                the retry counter could not be written or the memory of the hash derivation could not be allocated
+ */
+short int userCredentialsAuthenticate(struct UserCredentials *credentials,
+                                      const unsigned char *userId,
+                                      unsigned int userIdLength,
+                                      const unsigned char *pin,
+                                      unsigned int pinLength,
+                                      enum CredentialCheck *result,
+                                      short int *remainingRetries,
+                                      uint32_t *permissions);
+
+/**
+ * Verifies the PUK of a user and sets a new PIN. A successful verification resets both retry counters.
+ * @param[in] credentials
+ *                opened credentials [REQUIRED]
+ * @param[in] userId
+ *                the ID of the user or application [REQUIRED]
+ * @param[in] userIdLength
+ *                the length of the array that represents the userId [REQUIRED]
+ * @param[in] puk
+ *                the entered PUK [REQUIRED]
+ * @param[in] pukLength
+ *                the length of the array that represents the puk [REQUIRED]
+ * @param[in] newPin
+ *                the new PIN [REQUIRED]
+ * @param[in] newPinLength
+ *                the length of the array that represents the newPin [REQUIRED]
+ * @param[out] result
+ *                the result of the verification, credentialBlocked if the PUK is blocked [REQUIRED]
+ * @return the return values of userCredentialsAuthenticate
+ */
+short int userCredentialsUnblock(struct UserCredentials *credentials,
+                                 const unsigned char *userId,
+                                 unsigned int userIdLength,
+                                 const unsigned char *puk,
+                                 unsigned int pukLength,
+                                 const unsigned char *newPin,
+                                 unsigned int newPinLength,
+                                 enum CredentialCheck *result);
+
+/**
+ * Determines whether a userId is managed by the credential file.
+ * @param[in] credentials
+ *                opened credentials [REQUIRED]
+ * @param[in] userId
+ *                the ID of the user or application [REQUIRED]
+ * @param[in] userIdLength
+ *                the length of the array that represents the userId [REQUIRED]
+ * @return true if the user is managed
+ */
+bool userCredentialsContains(struct UserCredentials *credentials,
+                             const unsigned char *userId,
+                             unsigned int userIdLength);
+
+/**
+ * Releases the resources of the credentials. The stored hashes are cleared from memory.
+ * @param[in] credentials
+ *                opened credentials [REQUIRED]
+ */
+void userCredentialsClose(struct UserCredentials *credentials);
+
+#endif
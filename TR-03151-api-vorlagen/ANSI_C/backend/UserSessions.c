@@ -0,0 +1,81 @@
+#include "UserSessions.h"
+
+short int userSessionsOpen(struct UserSessions *userSessions,
+                           const char *directory,
+                           int64_t lifetime)
+{
+    userSessions->lifetime = lifetime > 0 ? lifetime : USER_SESSION_DEFAULT_LIFETIME;
+    sessionTableInit(&userSessions->sessions);
+    return userCredentialsOpen(&userSessions->credentials, directory, 0);
+}
+
+short int userSessionsAuthenticate(struct UserSessions *userSessions,
+                                   const unsigned char *userId,
+                                   unsigned int userIdLength,
+                                   const unsigned char *pin,
+                                   unsigned int pinLength,
+                                   int64_t now,
+                                   enum CredentialCheck *authenticationResult,
+                                   short int *remainingRetries)
+{
+    uint32_t permissions = 0;
+    short int result = userCredentialsAuthenticate(&userSessions->credentials, userId, userIdLength, pin, pinLength,
+                                                   authenticationResult, remainingRetries, &permissions);
+
+    if (result != EXECUTION_OK) {
+        return result;
+    }
+    if (*authenticationResult != credentialOk) {
+        return AUTHENTICATION_FAILED;
+    }
+    return sessionTableInsert(&userSessions->sessions, userId, userIdLength, permissions,
+                              now + userSessions->lifetime, now);
+}
+
+short int userSessionsLogOut(struct UserSessions *userSessions,
+                             const unsigned char *userId,
+                             unsigned int userIdLength,
+                             int64_t now)
+{
+    if (sessionTableRemove(&userSessions->sessions, userId, userIdLength, now)) {
+        return EXECUTION_OK;
+    }
+    /* the credential file is only consulted to distinguish the error codes */
+    if (!userCredentialsContains(&userSessions->credentials, userId, userIdLength)) {
+        return ERROR_USER_ID_NOT_MANAGED;
+    }
+    return ERROR_USER_ID_NOT_AUTHENTICATED;
+}
+
+short int userSessionsUnblock(struct UserSessions *userSessions,
+                              const unsigned char *userId,
+                              unsigned int userIdLength,
+                              const unsigned char *puk,
+                              unsigned int pukLength,
+                              const unsigned char *newPin,
+                              unsigned int newPinLength,
+                              enum CredentialCheck *unblockResult)
+{
+    short int result = userCredentialsUnblock(&userSessions->credentials, userId, userIdLength, puk, pukLength,
+                                              newPin, newPinLength, unblockResult);
+
+    if (result != EXECUTION_OK) {
+        return result;
+    }
+    return *unblockResult == credentialOk ? EXECUTION_OK : UNBLOCK_FAILED;
+}
+
+short int userSessionsCheck(struct UserSessions *userSessions,
+                            const unsigned char *userId,
+                            unsigned int userIdLength,
+                            uint32_t requiredPermissions,
+                            int64_t now)
+{
+    return sessionTableCheck(&userSessions->sessions, userId, userIdLength, requiredPermissions, now);
+}
+
+void userSessionsClose(struct UserSessions *userSessions)
+{
+    sessionTableInit(&userSessions->sessions);
+    userCredentialsClose(&userSessions->credentials);
+}
@@ -0,0 +1,183 @@
+#ifndef SEAPI_BACKEND_USER_SESSIONS_H
+#define SEAPI_BACKEND_USER_SESSIONS_H
+
+#include <stdint.h>
+
+#include "../Exception.h"
+#include "../Constant.h"
+#include "SessionTable.h"
+#include "UserCredentials.h"
+
+/**
+ * This header file defines the backend implementation of authenticateUser, logOut and unblockUser and the
+ * authorization check of the restricted functions of the SE API.
+ *
+ * The PIN is verified against its memory-hard hash only by authenticateUser. A successful authentication opens a
+ * session in the session table that lasts for the configured lifetime, so that a batch of restricted calls, e.g.
+ * several deleteStoredData and restoreFromBackup calls of an administration job, is authorized by one table probe
+ * per call.
+ */
+
+/**
+ * Permissions of a user for the restricted functions of the SE API
+ */
+#define USER_PERMISSION_INITIALIZE (1u << 0)
+#define USER_PERMISSION_UPDATE_TIME (1u << 1)
+#define USER_PERMISSION_DISABLE_SECURE_ELEMENT (1u << 2)
+#define USER_PERMISSION_RESTORE_FROM_BACKUP (1u << 3)
+#define USER_PERMISSION_DELETE_STORED_DATA (1u << 4)
+#define USER_PERMISSION_ALL 0x1Fu
+
+/**
+ * Default lifetime of a session in seconds
+ */
+#define USER_SESSION_DEFAULT_LIFETIME 900
+
+/**
+ * Credentials and sessions of the SE API backend. The members are managed by the functions of this header file.
+ */
+struct UserSessions {
+    struct UserCredentials credentials;
+    struct SessionTable sessions;
+    int64_t lifetime;
+};
+
+/**
+ * Opens the credential file and starts without sessions.
+ * @param[out] userSessions
+ *                sessions to be initialized [REQUIRED]
+ * @param[in] directory
+ *                existing directory that holds the credential file [REQUIRED]
+ * @param[in] lifetime
+ *                lifetime of a session in seconds, 0 selects USER_SESSION_DEFAULT_LIFETIME [REQUIRED]
+ * @return the return values of userCredentialsOpen
+ */
+short int userSessionsOpen(struct UserSessions *userSessions,
+                           const char *directory,
+                           int64_t lifetime);
+
+/**
+ * Backend implementation of authenticateUser. The result values of enum AuthenticationResult correspond to
+ * credentialOk, credentialFailed, credentialBlocked and credentialUnknownUser.
+ * @param[in] userSessions
+ *                opened sessions [REQUIRED]
+ * @param[in] userId
+ *                the ID of the user who or application that wants to be authenticated [REQUIRED]
+ * @param[in] userIdLength
+ *                the length of the array that represents the userId [REQUIRED]
+ * @param[in] pin
+ *                the PIN for the authentication [REQUIRED]
+ * @param[in] pinLength
+ *                the length of the array that represents the pin [REQUIRED]
+ * @param[in] now
+ *                current time in seconds [REQUIRED]
+ * @param[out] authenticationResult
+ *                the result of the authentication [REQUIRED]
+ * @param[out] remainingRetries
+ *                the number of remaining retries to enter a PIN [REQUIRED]
+ * @return if the execution of the function has been successful, the return value EXECUTION_OK SHALL be returned.
+ *
+ *         If the authentication attempt has failed, the return value AUTHENTICATION_FAILED SHALL be returned.
+ *
+ *         If an error occurs during the processing the appropriate error code SHALL be returned:
+ *
+ *             ERROR_STORAGE_FAILURE
+ *                the retry counter could not be stored or all sessions are in use
+ */
+short int userSessionsAuthenticate(struct UserSessions *userSessions,
+                                   const unsigned char *userId,
+                                   unsigned int userIdLength,
+                                   const unsigned char *pin,
+                                   unsigned int pinLength,
+                                   int64_t now,
+                                   enum CredentialCheck *authenticationResult,
+                                   short int *remainingRetries);
+
+/**
+ * Backend implementation of logOut.
+ * @param[in] userSessions
+ *                opened sessions [REQUIRED]
+ * @param[in] userId
+ *                the ID of the user who or application that wants to be logged out [REQUIRED]
+ * @param[in] userIdLength
+ *                the length of the array that represents the userId [REQUIRED]
+ * @param[in] now
+ *                current time in seconds [REQUIRED]
+ * @return if the execution of the function has been successful, the return value EXECUTION_OK SHALL be returned.
+ *
+ *         If the execution of the function has failed, the appropriate error code SHALL be returned:
+ *
+ *             ERROR_USER_ID_NOT_MANAGED
+ *                the passed userId is not managed by the SE API
+ *             ERROR_USER_ID_NOT_AUTHENTICATED
+ *                the passed userId has not been authenticated
+ */
+short int userSessionsLogOut(struct UserSessions *userSessions,
+                             const unsigned char *userId,
+                             unsigned int userIdLength,
+                             int64_t now);
+
+/**
+ * Backend implementation of unblockUser. The sessions of the user are not affected.
+ * @param[in] userSessions
+ *                opened sessions [REQUIRED]
+ * @param[in] userId
+ *                the ID of the user who or application that wants to unblock the corresponding PIN entry [REQUIRED]
+ * @param[in] userIdLength
+ *                the length of the array that represents the userId [REQUIRED]
+ * @param[in] puk
+ *                the PUK of the user/application [REQUIRED]
+ * @param[in] pukLength
+ *                the length of the array that represents the puk [REQUIRED]
+ * @param[in] newPin
+ *                the new PIN for the user/application [REQUIRED]
+ * @param[in] newPinLength
+ *                the length of the array that represents the newPin [REQUIRED]
+ * @param[out] unblockResult
+ *                the result of the unblock procedure [REQUIRED]
+ * @return if the execution of the function has been successful, the return value EXECUTION_OK SHALL be returned.
+ *
+ *         If the execution of attempt to unblock a PIN entry has failed, the return value UNBLOCK_FAILED SHALL be returned.
+ *
+ *         If an error occurs during the processing the appropriate error code SHALL be returned:
+ *
+ *             ERROR_STORAGE_FAILURE
+ *                the retry counter or the new PIN could not be stored
+ */
+short int userSessionsUnblock(struct UserSessions *userSessions,
+                              const unsigned char *userId,
+                              unsigned int userIdLength,
+                              const unsigned char *puk,
+                              unsigned int pukLength,
+                              const unsigned char *newPin,
+                              unsigned int newPinLength,
+                              enum CredentialCheck *unblockResult);
+
+/**
+ * Authorization check of a restricted function, e.g. deleteStoredData or restoreFromBackup.
+ * @param[in] userSessions
+ *                opened sessions [REQUIRED]
+ * @param[in] userId
+ *                the ID of the user who has invoked the restricted function [REQUIRED]
+ * @param[in] userIdLength
+ *                the length of the array that represents the userId [REQUIRED]
+ * @param[in] requiredPermissions
+ *                USER_PERMISSION_* bits of the restricted function [REQUIRED]
+ * @param[in] now
+ *                current time in seconds [REQUIRED]
+ * @return the return values of sessionTableCheck
+ */
+short int userSessionsCheck(struct UserSessions *userSessions,
+                            const unsigned char *userId,
+                            unsigned int userIdLength,
+                            uint32_t requiredPermissions,
+                            int64_t now);
+
+/**
+ * Ends all sessions and closes the credential file.
+ * @param[in] userSessions
+ *                opened sessions [REQUIRED]
+ */
+void userSessionsClose(struct UserSessions *userSessions);
+
+#endif
@@ -0,0 +1,168 @@
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "../SeApiBinding.h"
+
+/**
+ * Measures the throughput of startTransaction and finishTransaction of the backend for an increasing number of
+ * threads, each of which is pinned to a core and acts as its own client, once with the append lock taken by every
+ * thread and once with the append shards.
+ *
+ *     appendbench <directory> [maximum number of threads] [seconds per run]
+ *
+ * creates a store per run in the existing directory and prints one line per run: number of threads, mode,
+ * transactions per second and the average number of requests executed per batch.
+ */
+
+#define APPEND_BENCHMARK_DEFAULT_THREADS 64
+#define APPEND_BENCHMARK_DEFAULT_SECONDS 3
+
+struct AppendBenchmarkClient {
+    pthread_t thread;
+    struct SeApiBinding *binding;
+    unsigned int index;
+    atomic_bool *stopping;
+    uint64_t transactionCount;
+    short int result;
+};
+
+static void *appendBenchmarkRun(void *argument)
+{
+    struct AppendBenchmarkClient *client = (struct AppendBenchmarkClient *) argument;
+    static const unsigned char processData[] = "Beleg^75.33_7.99_0.00_0.00_0.00^10.00:Bar_5.00:Bar:USD";
+    static const unsigned char processType[] = "Kassenbeleg-V1";
+    unsigned char clientId[32];
+    int clientIdLength = snprintf((char *) clientId, sizeof clientId, "Kasse%u", client->index);
+    long processors = sysconf(_SC_NPROCESSORS_ONLN);
+    cpu_set_t cpus;
+    int64_t results[SE_API_BINDING_RESULT_COUNT];
+
+    CPU_ZERO(&cpus);
+    CPU_SET(client->index % (unsigned int) (processors > 0 ? processors : 1), &cpus);
+    pthread_setaffinity_np(pthread_self(), sizeof cpus, &cpus);
+
+    while (!atomic_load_explicit(client->stopping, memory_order_relaxed)) {
+        client->result = seApiBindingLogTransaction(client->binding, seApiBindingStart, clientId,
+                                                    (uint64_t) clientIdLength, 0, NULL, 0, NULL, 0, results);
+        if (client->result == EXECUTION_OK) {
+            client->result = seApiBindingLogTransaction(client->binding, seApiBindingFinish, clientId,
+                                                        (uint64_t) clientIdLength, (uint64_t) results[0],
+                                                        processData, sizeof processData - 1, processType,
+                                                        sizeof processType - 1, results);
+        }
+        if (client->result != EXECUTION_OK) {
+            break;
+        }
+        client->transactionCount++;
+    }
+    return NULL;
+}
+
+static int appendBenchmarkMeasure(const char *directory,
+                                  unsigned int threadCount,
+                                  bool sharded,
+                                  unsigned int seconds)
+{
+    struct AppendBenchmarkClient *clients = calloc(threadCount, sizeof *clients);
+    struct SeApiBinding *binding;
+    struct timespec start;
+    struct timespec end;
+    atomic_bool stopping;
+    char path[4096];
+    int64_t results[SE_API_BINDING_RESULT_COUNT];
+    uint64_t transactionCount = 0;
+    double elapsed;
+    unsigned int i;
+    short int result;
+
+    snprintf(path, sizeof path, "%s/%s-%u", directory, sharded ? "shards" : "lock", threadCount);
+    if (clients == NULL || (mkdir(path, 0700) != 0 && errno != EEXIST)) {
+        free(clients);
+        return EXIT_FAILURE;
+    }
+    result = seApiBindingOpen(path, results);
+    if (result != EXECUTION_OK) {
+        fprintf(stderr, "%s: opening failed with %d\n", path, result);
+        free(clients);
+        return EXIT_FAILURE;
+    }
+    binding = (struct SeApiBinding *) (intptr_t) results[0];
+    result = seApiBindingUpdateTime(binding, (int64_t) time(NULL), results);
+    if (result == EXECUTION_OK && sharded) {
+        result = seApiBindingStartAppendShards(binding, 0);
+    }
+
+    atomic_init(&stopping, false);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0; i < threadCount && result == EXECUTION_OK; i++) {
+        clients[i].binding = binding;
+        clients[i].index = i;
+        clients[i].stopping = &stopping;
+        if (pthread_create(&clients[i].thread, NULL, appendBenchmarkRun, &clients[i]) != 0) {
+            threadCount = i;
+            result = ERROR_STORAGE_FAILURE;
+        }
+    }
+    if (result == EXECUTION_OK) {
+        sleep(seconds);
+    }
+    atomic_store(&stopping, true);
+    for (i = 0; i < threadCount; i++) {
+        pthread_join(clients[i].thread, NULL);
+        transactionCount += clients[i].transactionCount;
+        if (clients[i].result != EXECUTION_OK) {
+            result = clients[i].result;
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    elapsed = (double) (end.tv_sec - start.tv_sec) + (double) (end.tv_nsec - start.tv_nsec) / 1e9;
+
+    if (result == EXECUTION_OK) {
+        struct AppendShards *shards = atomic_load(&binding->shards);
+
+        printf("%7u %-6s %14.0f %6.1f\n", threadCount, sharded ? "shards" : "lock",
+               (double) transactionCount / elapsed,
+               shards != NULL && shards->batchCount > 0 ? (double) shards->requestCount / (double) shards->batchCount
+               : 1.0);
+    } else {
+        fprintf(stderr, "%s: run failed with %d\n", path, result);
+    }
+    seApiBindingClose(binding);
+    free(clients);
+    return result == EXECUTION_OK ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+int main(int argc,
+         char **argv)
+{
+    unsigned int maximumThreads = APPEND_BENCHMARK_DEFAULT_THREADS;
+    unsigned int seconds = APPEND_BENCHMARK_DEFAULT_SECONDS;
+    unsigned int threadCount;
+
+    if (argc < 2 || argc > 4) {
+        fprintf(stderr, "usage: %s <directory> [maximum number of threads] [seconds per run]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    if (argc > 2) {
+        maximumThreads = (unsigned int) strtoul(argv[2], NULL, 10);
+    }
+    if (argc > 3) {
+        seconds = (unsigned int) strtoul(argv[3], NULL, 10);
+    }
+    printf("threads mode  transactions/s  batch\n");
+    for (threadCount = 1; threadCount <= maximumThreads; threadCount *= 2) {
+        if (appendBenchmarkMeasure(argv[1], threadCount, false, seconds) != EXIT_SUCCESS
+            || appendBenchmarkMeasure(argv[1], threadCount, true, seconds) != EXIT_SUCCESS) {
+            return EXIT_FAILURE;
+        }
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,115 @@
+#include <signal.h>
+#include <stdint.h>
+#include <time.h>
+#include <sys/resource.h>
+
+#include "Test.h"
+#include "../SeApiBinding.h"
+
+/**
+ * Checks that the signature counter and the transaction number are only handed out with a stored log message:
+ * a rejected log message and a log message whose write fails leave no gap, a standby key takes over at the
+ * signature counter of the first log message that is stored, and the counters continue after the backend has been
+ * opened again.
+ */
+
+static const unsigned char counterTestClientId[] = "Kasse1";
+
+static struct SeApiBinding *counterTestOpen(const char *directory)
+{
+    int64_t results[SE_API_BINDING_RESULT_COUNT];
+
+    TEST_CHECK_RESULT(seApiBindingOpen(directory, results), EXECUTION_OK);
+    return (struct SeApiBinding *) (intptr_t) results[0];
+}
+
+static short int counterTestLog(struct SeApiBinding *binding,
+                                uint32_t operation,
+                                uint64_t transactionNumber,
+                                int64_t *results)
+{
+    static const unsigned char processData[] = "Beleg^75.33_7.99_0.00_0.00_0.00^10.00:Bar_5.00:Bar:USD";
+    static const unsigned char processType[] = "Kassenbeleg-V1";
+
+    return seApiBindingLogTransaction(binding, operation, counterTestClientId, sizeof counterTestClientId - 1,
+                                      transactionNumber, processData, sizeof processData - 1, processType,
+                                      sizeof processType - 1, results);
+}
+
+/**
+ * Limits the size of the files written by the process to the length of the active segment, so that the next
+ * append fails, or lifts the limit again.
+ */
+static void counterTestLimitWrites(struct SeApiBinding *binding,
+                                   bool limited)
+{
+    struct rlimit limit;
+
+    TEST_CHECK(getrlimit(RLIMIT_FSIZE, &limit) == 0);
+    limit.rlim_cur = limited ? (rlim_t) binding->store.segments[binding->store.segmentCount - 1].length + 1
+                     : limit.rlim_max;
+    TEST_CHECK(setrlimit(RLIMIT_FSIZE, &limit) == 0);
+}
+
+int main(int argc,
+         char **argv)
+{
+    static const unsigned char publicKey[65] = {0x04};
+    char directory[4096];
+    struct SeApiBinding *binding;
+    int64_t results[SE_API_BINDING_RESULT_COUNT];
+    int64_t signatureCounter;
+    int64_t transactionNumber;
+
+    testCreateDirectory(argc, argv, "counters", directory, sizeof directory);
+    /* a write beyond the file size limit fails with EFBIG instead of ending the process */
+    signal(SIGXFSZ, SIG_IGN);
+
+    binding = counterTestOpen(directory);
+    TEST_CHECK_RESULT(seApiBindingUpdateTime(binding, (int64_t) time(NULL), results), EXECUTION_OK);
+    TEST_CHECK_RESULT(counterTestLog(binding, seApiBindingStart, 0, results), EXECUTION_OK);
+    transactionNumber = results[SE_API_BINDING_TRANSACTION_NUMBER];
+    signatureCounter = results[SE_API_BINDING_SIGNATURE_COUNTER];
+
+    /* a log message of an unknown transaction is rejected by the store */
+    TEST_CHECK_RESULT(counterTestLog(binding, seApiBindingUpdate, (uint64_t) transactionNumber + 1000, results),
+                      ERROR_NO_TRANSACTION);
+    TEST_CHECK_RESULT(counterTestLog(binding, seApiBindingUpdate, (uint64_t) transactionNumber, results),
+                      EXECUTION_OK);
+    TEST_CHECK_RESULT(results[SE_API_BINDING_SIGNATURE_COUNTER], signatureCounter + 1);
+
+    /* a startTransaction whose write fails hands out neither its transaction number nor its signature counter */
+    counterTestLimitWrites(binding, true);
+    TEST_CHECK(counterTestLog(binding, seApiBindingStart, 0, results) != EXECUTION_OK);
+    counterTestLimitWrites(binding, false);
+    TEST_CHECK_RESULT(counterTestLog(binding, seApiBindingStart, 0, results), EXECUTION_OK);
+    TEST_CHECK_RESULT(results[SE_API_BINDING_TRANSACTION_NUMBER], transactionNumber + 1);
+    TEST_CHECK_RESULT(results[SE_API_BINDING_SIGNATURE_COUNTER], signatureCounter + 2);
+
+    /* the first key takes over with the next log message; its write fails, so the key is used from the signature
+       counter of the log message stored after it */
+    TEST_CHECK_RESULT(seApiBindingAddStandbyKey(binding, "ecdsa", 5, publicKey, sizeof publicKey,
+                                                (const unsigned char *) "CERT-A", 6, (int64_t) time(NULL) + 100000),
+                      EXECUTION_OK);
+    counterTestLimitWrites(binding, true);
+    TEST_CHECK(counterTestLog(binding, seApiBindingFinish, (uint64_t) transactionNumber, results) != EXECUTION_OK);
+    counterTestLimitWrites(binding, false);
+    TEST_CHECK_RESULT(counterTestLog(binding, seApiBindingFinish, (uint64_t) transactionNumber, results),
+                      EXECUTION_OK);
+    TEST_CHECK_RESULT(results[SE_API_BINDING_SIGNATURE_COUNTER], signatureCounter + 3);
+    TEST_CHECK_RESULT(binding->keys.keyCount, 1);
+    TEST_CHECK_RESULT(binding->keys.keys[0].firstSignatureCounter, signatureCounter + 3);
+    TEST_CHECK_RESULT(seApiBindingClose(binding), EXECUTION_OK);
+
+    /* the counters continue after the backend has been opened again */
+    binding = counterTestOpen(directory);
+    TEST_CHECK_RESULT(seApiBindingUpdateTime(binding, (int64_t) time(NULL), results), EXECUTION_OK);
+    TEST_CHECK_RESULT(results[SE_API_BINDING_SIGNATURE_COUNTER], signatureCounter + 4);
+    TEST_CHECK_RESULT(counterTestLog(binding, seApiBindingStart, 0, results), EXECUTION_OK);
+    TEST_CHECK_RESULT(results[SE_API_BINDING_TRANSACTION_NUMBER], transactionNumber + 2);
+    TEST_CHECK_RESULT(results[SE_API_BINDING_SIGNATURE_COUNTER], signatureCounter + 5);
+    TEST_CHECK_RESULT(seApiBindingClose(binding), EXECUTION_OK);
+
+    testRemoveDirectory(directory);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,169 @@
+#include <stdint.h>
+#include <time.h>
+
+#include "Test.h"
+#include "../Scrypt.h"
+#include "../UserCredentials.h"
+
+/**
+ * Checks the derivation of scrypt against the test vectors of RFC 7914, section 12, and the verification of PINs
+ * and PUKs: wrong PINs count down to the blocking of the PIN, the PUK unblocks it with a new PIN, the retry
+ * counters survive the reopening of the file, and an unknown userId is answered after a derivation like a wrong PIN.
+ */
+
+/**
+ * Binary logarithm of the scrypt cost parameter of the test users, which keeps a derivation in the order of
+ * milliseconds
+ */
+#define CREDENTIAL_TEST_COST_LOG2 12
+
+struct CredentialTestVector {
+    const char *password;
+    const char *salt;
+    unsigned int costLog2;
+    uint32_t blockSize;
+    uint32_t parallelism;
+    unsigned char output[64];
+};
+
+static const struct CredentialTestVector credentialTestVectors[] = {
+    {"", "", 4, 1, 1,
+     {0x77, 0xd6, 0x57, 0x62, 0x38, 0x65, 0x7b, 0x20, 0x3b, 0x19, 0xca, 0x42, 0xc1, 0x8a, 0x04, 0x97,
+      0xf1, 0x6b, 0x48, 0x44, 0xe3, 0x07, 0x4a, 0xe8, 0xdf, 0xdf, 0xfa, 0x3f, 0xed, 0xe2, 0x14, 0x42,
+      0xfc, 0xd0, 0x06, 0x9d, 0xed, 0x09, 0x48, 0xf8, 0x32, 0x6a, 0x75, 0x3a, 0x0f, 0xc8, 0x1f, 0x17,
+      0xe8, 0xd3, 0xe0, 0xfb, 0x2e, 0x0d, 0x36, 0x28, 0xcf, 0x35, 0xe2, 0x0c, 0x38, 0xd1, 0x89, 0x06}},
+    {"password", "NaCl", 10, 8, 16,
+     {0xfd, 0xba, 0xbe, 0x1c, 0x9d, 0x34, 0x72, 0x00, 0x78, 0x56, 0xe7, 0x19, 0x0d, 0x01, 0xe9, 0xfe,
+      0x7c, 0x6a, 0xd7, 0xcb, 0xc8, 0x23, 0x78, 0x30, 0xe7, 0x73, 0x76, 0x63, 0x4b, 0x37, 0x31, 0x62,
+      0x2e, 0xaf, 0x30, 0xd9, 0x2e, 0x22, 0xa3, 0x88, 0x6f, 0xf1, 0x09, 0x27, 0x9d, 0x98, 0x30, 0xda,
+      0xc7, 0x27, 0xaf, 0xb9, 0x4a, 0x83, 0xee, 0x6d, 0x83, 0x60, 0xcb, 0xdf, 0xa2, 0xcc, 0x06, 0x40}},
+    {"pleaseletmein", "SodiumChloride", 14, 8, 1,
+     {0x70, 0x23, 0xbd, 0xcb, 0x3a, 0xfd, 0x73, 0x48, 0x46, 0x1c, 0x06, 0xcd, 0x81, 0xfd, 0x38, 0xeb,
+      0xfd, 0xa8, 0xfb, 0xba, 0x90, 0x4f, 0x8e, 0x3e, 0xa9, 0xb5, 0x43, 0xf6, 0x54, 0x5d, 0xa1, 0xf2,
+      0xd5, 0x43, 0x29, 0x55, 0x61, 0x3f, 0x0f, 0xcf, 0x62, 0xd4, 0x97, 0x05, 0x24, 0x2a, 0x9a, 0xf9,
+      0xe6, 0x1e, 0x85, 0xdc, 0x0d, 0x65, 0x1e, 0x40, 0xdf, 0xcf, 0x01, 0x7b, 0x45, 0x57, 0x58, 0x87}}
+};
+
+static const unsigned char credentialTestUser[] = "admin";
+static const unsigned char credentialTestPin[] = "123456";
+static const unsigned char credentialTestPuk[] = "1234567890";
+static const unsigned char credentialTestWrongSecret[] = "000000";
+
+static short int credentialTestAuthenticate(struct UserCredentials *credentials,
+                                            const unsigned char *userId,
+                                            unsigned int userIdLength,
+                                            const unsigned char *pin,
+                                            unsigned int pinLength,
+                                            enum CredentialCheck expected,
+                                            uint32_t *permissions)
+{
+    enum CredentialCheck check;
+    short int remainingRetries;
+
+    TEST_CHECK_RESULT(userCredentialsAuthenticate(credentials, userId, userIdLength, pin, pinLength, &check,
+                                                  &remainingRetries, permissions), EXECUTION_OK);
+    TEST_CHECK_RESULT(check, expected);
+    return remainingRetries;
+}
+
+/**
+ * @return the shortest of several durations of an authentication in nanoseconds
+ */
+static int64_t credentialTestDuration(struct UserCredentials *credentials,
+                                      const unsigned char *userId,
+                                      unsigned int userIdLength,
+                                      enum CredentialCheck expected)
+{
+    int64_t shortest = INT64_MAX;
+    uint32_t permissions;
+    int i;
+
+    for (i = 0; i < 3; i++) {
+        struct timespec start;
+        struct timespec end;
+        int64_t duration;
+
+        TEST_CHECK(clock_gettime(CLOCK_MONOTONIC, &start) == 0);
+        credentialTestAuthenticate(credentials, userId, userIdLength, credentialTestWrongSecret,
+                                   sizeof credentialTestWrongSecret - 1, expected, &permissions);
+        TEST_CHECK(clock_gettime(CLOCK_MONOTONIC, &end) == 0);
+        duration = (int64_t) (end.tv_sec - start.tv_sec) * 1000000000 + (end.tv_nsec - start.tv_nsec);
+        if (duration < shortest) {
+            shortest = duration;
+        }
+    }
+    return shortest;
+}
+
+int main(int argc,
+         char **argv)
+{
+    static const unsigned char unknownUser[] = "nobody";
+    static const unsigned char newPin[] = "654321";
+    char directory[4096];
+    unsigned char output[64];
+    struct UserCredentials credentials;
+    enum CredentialCheck check;
+    uint32_t permissions = 0;
+    int64_t wrongPinDuration;
+    int64_t unknownUserDuration;
+    size_t i;
+
+    for (i = 0; i < sizeof credentialTestVectors / sizeof credentialTestVectors[0]; i++) {
+        const struct CredentialTestVector *vector = &credentialTestVectors[i];
+
+        TEST_CHECK_RESULT(scryptDerive((const unsigned char *) vector->password, strlen(vector->password),
+                                       (const unsigned char *) vector->salt, strlen(vector->salt), vector->costLog2,
+                                       vector->blockSize, vector->parallelism, output, sizeof output),
+                          EXECUTION_OK);
+        TEST_CHECK(memcmp(output, vector->output, sizeof output) == 0);
+    }
+    TEST_CHECK_RESULT(scryptDerive(credentialTestPin, 6, credentialTestPin, 6, 0, 1, 1, output, sizeof output),
+                      ERROR_PARAMETER_MISMATCH);
+
+    testCreateDirectory(argc, argv, "credentials", directory, sizeof directory);
+    TEST_CHECK_RESULT(userCredentialsOpen(&credentials, directory, CREDENTIAL_TEST_COST_LOG2), EXECUTION_OK);
+    TEST_CHECK_RESULT(userCredentialsSet(&credentials, credentialTestUser, sizeof credentialTestUser - 1,
+                                         credentialTestPin, sizeof credentialTestPin - 1, credentialTestPuk,
+                                         sizeof credentialTestPuk - 1, 0x5u), EXECUTION_OK);
+    TEST_CHECK_RESULT(credentialTestAuthenticate(&credentials, credentialTestUser, sizeof credentialTestUser - 1,
+                                                 credentialTestPin, sizeof credentialTestPin - 1, credentialOk,
+                                                 &permissions), USER_CREDENTIALS_MAX_PIN_RETRIES);
+    TEST_CHECK_RESULT(permissions, 0x5u);
+
+    /* an unknown userId takes at least a part of the time of a wrong PIN instead of being answered at once */
+    unknownUserDuration = credentialTestDuration(&credentials, unknownUser, sizeof unknownUser - 1,
+                                                 credentialUnknownUser);
+    wrongPinDuration = credentialTestDuration(&credentials, credentialTestUser, sizeof credentialTestUser - 1,
+                                              credentialFailed);
+    TEST_CHECK(unknownUserDuration * 4 >= wrongPinDuration);
+
+    /* the three wrong PINs of the measurement have blocked the PIN, also after the file has been opened again */
+    userCredentialsClose(&credentials);
+    TEST_CHECK_RESULT(userCredentialsOpen(&credentials, directory, CREDENTIAL_TEST_COST_LOG2), EXECUTION_OK);
+    credentialTestAuthenticate(&credentials, credentialTestUser, sizeof credentialTestUser - 1, credentialTestPin,
+                               sizeof credentialTestPin - 1, credentialBlocked, &permissions);
+
+    /* a wrong PUK does not unblock the PIN, the right one sets the new PIN */
+    TEST_CHECK_RESULT(userCredentialsUnblock(&credentials, credentialTestUser, sizeof credentialTestUser - 1,
+                                             credentialTestWrongSecret, sizeof credentialTestWrongSecret - 1,
+                                             newPin, sizeof newPin - 1, &check), EXECUTION_OK);
+    TEST_CHECK_RESULT(check, credentialFailed);
+    TEST_CHECK_RESULT(userCredentialsUnblock(&credentials, unknownUser, sizeof unknownUser - 1, credentialTestPuk,
+                                             sizeof credentialTestPuk - 1, newPin, sizeof newPin - 1, &check),
+                      EXECUTION_OK);
+    TEST_CHECK_RESULT(check, credentialUnknownUser);
+    TEST_CHECK_RESULT(userCredentialsUnblock(&credentials, credentialTestUser, sizeof credentialTestUser - 1,
+                                             credentialTestPuk, sizeof credentialTestPuk - 1, newPin,
+                                             sizeof newPin - 1, &check), EXECUTION_OK);
+    TEST_CHECK_RESULT(check, credentialOk);
+    credentialTestAuthenticate(&credentials, credentialTestUser, sizeof credentialTestUser - 1, credentialTestPin,
+                               sizeof credentialTestPin - 1, credentialFailed, &permissions);
+    TEST_CHECK_RESULT(credentialTestAuthenticate(&credentials, credentialTestUser, sizeof credentialTestUser - 1,
+                                                 newPin, sizeof newPin - 1, credentialOk, &permissions),
+                      USER_CREDENTIALS_MAX_PIN_RETRIES);
+    userCredentialsClose(&credentials);
+
+    testRemoveDirectory(directory);
+    return EXIT_SUCCESS;
+}
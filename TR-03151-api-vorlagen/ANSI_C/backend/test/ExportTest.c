@@ -0,0 +1,286 @@
+#include <inttypes.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "Test.h"
+#include "../ExportScan.h"
+#include "../TarManifest.h"
+
+/**
+ * Checks the archives of the export functions: the log messages of many small segments are merged in the order of
+ * the signature counter without a gap, every file has a valid ustar header and its stored payload as content, the
+ * integrity manifest lists every file with the digest of the content at its offset, and a period of time selects
+ * exactly the log messages of the period.
+ */
+
+#define EXPORT_TEST_RECORDS 600
+#define EXPORT_TEST_CLIENTS 3
+#define EXPORT_TEST_MAX_FILES (EXPORT_TEST_RECORDS + 1)
+
+/**
+ * The log time of a log message is its signature counter plus this offset
+ */
+#define EXPORT_TEST_TIME_OFFSET 1600000000
+
+/**
+ * File of an archive, whose content lies at offset
+ */
+struct ExportTestFile {
+    char name[101];
+    uint64_t offset;
+    uint64_t length;
+};
+
+static void exportTestPayload(uint64_t signatureCounter,
+                              unsigned char *payload,
+                              unsigned long int *payloadLength)
+{
+    unsigned long int i;
+
+    *payloadLength = 16 + signatureCounter % 700;
+    for (i = 0; i < *payloadLength; i++) {
+        payload[i] = (unsigned char) (signatureCounter * 31 + i);
+    }
+}
+
+/**
+ * Appends the transactions of the clients, which take turns, and a system log message after every 50 log messages.
+ */
+static void exportTestFill(struct LogStore *store)
+{
+    static unsigned char payload[1024];
+    uint64_t openTransactions[EXPORT_TEST_CLIENTS] = {0};
+    unsigned char clientId[16];
+    struct LogRecord record;
+    uint64_t signatureCounter;
+    uint64_t transactionNumber = 0;
+    unsigned int client = 0;
+
+    for (signatureCounter = 1; signatureCounter <= EXPORT_TEST_RECORDS; signatureCounter++) {
+        memset(&record, 0, sizeof record);
+        record.signatureCounter = signatureCounter;
+        record.logTime = EXPORT_TEST_TIME_OFFSET + (int64_t) signatureCounter;
+        exportTestPayload(signatureCounter, payload, &record.payloadLength);
+        record.payload = payload;
+        if (signatureCounter % 50 == 0) {
+            record.type = systemLogMessage;
+        } else {
+            int length = snprintf((char *) clientId, sizeof clientId, "Kasse-%u", client);
+
+            TEST_CHECK(length > 0 && (size_t) length < sizeof clientId);
+            record.type = transactionLogMessage;
+            record.clientId = clientId;
+            record.clientIdLength = (unsigned long int) length;
+            if (openTransactions[client] == 0) {
+                record.operation = startTransactionOperation;
+                record.transactionNumber = ++transactionNumber;
+                openTransactions[client] = transactionNumber;
+            } else {
+                record.operation = finishTransactionOperation;
+                record.transactionNumber = openTransactions[client];
+                openTransactions[client] = 0;
+            }
+            client = (client + 1) % EXPORT_TEST_CLIENTS;
+        }
+        TEST_CHECK_RESULT(logStoreAppend(store, &record), EXECUTION_OK);
+    }
+}
+
+static uint64_t exportTestOctal(const unsigned char *field,
+                                size_t fieldSize)
+{
+    uint64_t value = 0;
+    size_t i;
+
+    for (i = 0; i < fieldSize && field[i] >= '0' && field[i] <= '7'; i++) {
+        value = value * 8 + (uint64_t) (field[i] - '0');
+    }
+    return value;
+}
+
+/**
+ * Splits an archive into its files and checks the headers and the end of the archive.
+ * @return the number of files
+ */
+static size_t exportTestParse(const unsigned char *data,
+                              size_t dataLength,
+                              struct ExportTestFile *files)
+{
+    static const unsigned char zeros[2 * TAR_BLOCK_SIZE];
+    size_t position = 0;
+    size_t count = 0;
+
+    TEST_CHECK(dataLength % TAR_BLOCK_SIZE == 0);
+    while (position + TAR_BLOCK_SIZE <= dataLength && memcmp(data + position, zeros, TAR_BLOCK_SIZE) != 0) {
+        const unsigned char *header = data + position;
+        unsigned int checksum = 0;
+        size_t i;
+
+        TEST_CHECK(count < EXPORT_TEST_MAX_FILES);
+        TEST_CHECK(memcmp(header + 257, "ustar", 6) == 0);
+        for (i = 0; i < TAR_BLOCK_SIZE; i++) {
+            checksum += i >= 148 && i < 156 ? ' ' : header[i];
+        }
+        TEST_CHECK_RESULT(exportTestOctal(header + 148, 8), checksum);
+        memcpy(files[count].name, header, 100);
+        files[count].name[100] = '\0';
+        files[count].offset = position + TAR_BLOCK_SIZE;
+        files[count].length = exportTestOctal(header + 124, 12);
+        position += TAR_BLOCK_SIZE + (files[count].length + TAR_BLOCK_SIZE - 1) / TAR_BLOCK_SIZE * TAR_BLOCK_SIZE;
+        TEST_CHECK(position <= dataLength);
+        count++;
+    }
+    /* the archive ends with two blocks of zeros */
+    TEST_CHECK_RESULT(dataLength - position, sizeof zeros);
+    TEST_CHECK(memcmp(data + position, zeros, sizeof zeros) == 0);
+    return count;
+}
+
+/**
+ * Checks that the log messages of an archive are those from firstSignatureCounter to lastSignatureCounter in this
+ * order and with their payloads.
+ * @return the number of files of the archive
+ */
+static size_t exportTestCheckLogMessages(const unsigned char *data,
+                                         size_t dataLength,
+                                         struct ExportTestFile *files,
+                                         uint64_t firstSignatureCounter,
+                                         uint64_t lastSignatureCounter)
+{
+    static unsigned char payload[1024];
+    unsigned long int payloadLength;
+    uint64_t signatureCounter = firstSignatureCounter;
+    size_t count = exportTestParse(data, dataLength, files);
+    size_t i;
+
+    for (i = 0; i < count && strncmp(files[i].name, "Unixt_", 6) == 0; i++, signatureCounter++) {
+        char prefix[64];
+        int length = snprintf(prefix, sizeof prefix, "Unixt_%" PRId64 "_Sig-%" PRIu64 "_Log-",
+                              EXPORT_TEST_TIME_OFFSET + (int64_t) signatureCounter, signatureCounter);
+
+        TEST_CHECK(length > 0 && (size_t) length < sizeof prefix);
+        if (strncmp(files[i].name, prefix, (size_t) length) != 0) {
+            fprintf(stderr, "file %zu is %s instead of %s...\n", i, files[i].name, prefix);
+            exit(EXIT_FAILURE);
+        }
+        TEST_CHECK((signatureCounter % 50 == 0) == (strstr(files[i].name, "_Log-Sys.log") != NULL));
+        exportTestPayload(signatureCounter, payload, &payloadLength);
+        TEST_CHECK_RESULT(files[i].length, payloadLength);
+        TEST_CHECK(memcmp(data + files[i].offset, payload, payloadLength) == 0);
+    }
+    TEST_CHECK_RESULT(signatureCounter, lastSignatureCounter + 1);
+    return count;
+}
+
+/**
+ * Checks that the last file of an archive is the manifest of all files before it.
+ */
+static void exportTestCheckManifest(const unsigned char *data,
+                                    const struct ExportTestFile *files,
+                                    size_t count)
+{
+    static char text[EXPORT_TEST_MAX_FILES * 256];
+    const struct ExportTestFile *manifestFile = &files[count - 1];
+    struct TarManifest manifest;
+    unsigned char digest[SHA256_DIGEST_LENGTH];
+    unsigned char root[SHA256_DIGEST_LENGTH];
+    char hex[2 * SHA256_DIGEST_LENGTH + 1];
+    char *line;
+    size_t entries;
+    size_t i;
+    size_t j;
+
+    TEST_CHECK_RESULT(strcmp(manifestFile->name, TAR_MANIFEST_NAME), 0);
+    TEST_CHECK(manifestFile->length < sizeof text);
+    memcpy(text, data + manifestFile->offset, (size_t) manifestFile->length);
+    text[manifestFile->length] = '\0';
+
+    line = strtok(text, "\n");
+    TEST_CHECK(line != NULL && strcmp(line, "SHA-256 manifest 1") == 0);
+    line = strtok(NULL, "\n");
+    TEST_CHECK(line != NULL && strncmp(line, "root ", 5) == 0);
+    snprintf(hex, sizeof hex, "%s", line + 5);
+    line = strtok(NULL, "\n");
+    TEST_CHECK(line != NULL && sscanf(line, "entries %zu", &entries) == 1);
+    TEST_CHECK_RESULT(entries, count - 1);
+
+    /* every entry matches the header and the content of its file, and the root is that of the listed entries */
+    tarManifestInit(&manifest, 0);
+    for (i = 0; i < entries; i++) {
+        uint64_t offset;
+        uint64_t length;
+        char digestHex[2 * SHA256_DIGEST_LENGTH + 1];
+        int nameOffset;
+
+        line = strtok(NULL, "\n");
+        TEST_CHECK(line != NULL);
+        TEST_CHECK(sscanf(line, "%" SCNu64 " %" SCNu64 " %64s %n", &offset, &length, digestHex, &nameOffset) == 3);
+        TEST_CHECK_RESULT(strcmp(line + nameOffset, files[i].name), 0);
+        TEST_CHECK_RESULT(offset, files[i].offset);
+        TEST_CHECK_RESULT(length, files[i].length);
+        sha256Digest(data + offset, (size_t) length, digest);
+        for (j = 0; j < sizeof digest; j++) {
+            char byte[3];
+
+            snprintf(byte, sizeof byte, "%02x", digest[j]);
+            TEST_CHECK(memcmp(digestHex + 2 * j, byte, 2) == 0);
+        }
+        TEST_CHECK_RESULT(tarManifestAdd(&manifest, files[i].name, offset, length, digest), EXECUTION_OK);
+    }
+    TEST_CHECK(strtok(NULL, "\n") == NULL);
+    TEST_CHECK_RESULT(tarManifestRoot(&manifest, root), EXECUTION_OK);
+    for (j = 0; j < sizeof root; j++) {
+        char byte[3];
+
+        snprintf(byte, sizeof byte, "%02x", root[j]);
+        TEST_CHECK(memcmp(hex + 2 * j, byte, 2) == 0);
+    }
+    tarManifestFree(&manifest);
+}
+
+int main(int argc,
+         char **argv)
+{
+    static struct ExportTestFile files[EXPORT_TEST_MAX_FILES];
+    char directory[4096];
+    char storeDirectory[4096];
+    struct LogStoreOptions options;
+    struct LogStore store;
+    struct tm startDate;
+    struct tm endDate;
+    time_t startTime = EXPORT_TEST_TIME_OFFSET + 120;
+    time_t endTime = EXPORT_TEST_TIME_OFFSET + 480;
+    unsigned char *data;
+    unsigned long int dataLength;
+    size_t count;
+
+    testCreateDirectory(argc, argv, "export", directory, sizeof directory);
+    testCreateSubdirectory(directory, "store", storeDirectory, sizeof storeDirectory);
+    memset(&options, 0, sizeof options);
+    /* small segments, so that the export merges the scans of many segments */
+    options.segmentSizeLimit = 16u * 1024u;
+    TEST_CHECK_RESULT(logStoreOpen(&store, storeDirectory, &options), EXECUTION_OK);
+    exportTestFill(&store);
+    TEST_CHECK(store.segmentCount > 10);
+
+    TEST_CHECK_RESULT(exportScanAll(&store, 0, true, NULL, NULL, &data, &dataLength), EXECUTION_OK);
+    count = exportTestCheckLogMessages(data, dataLength, files, 1, EXPORT_TEST_RECORDS);
+    TEST_CHECK_RESULT(count, EXPORT_TEST_RECORDS + 1);
+    exportTestCheckManifest(data, files, count);
+    free(data);
+
+    /* both ends of the period are included */
+    TEST_CHECK(gmtime_r(&startTime, &startDate) != NULL);
+    TEST_CHECK(gmtime_r(&endTime, &endDate) != NULL);
+    TEST_CHECK_RESULT(exportScanPeriodOfTime(&store, &startDate, &endDate, NULL, 0, 0, false, NULL, NULL, &data,
+                                             &dataLength), EXECUTION_OK);
+    count = exportTestCheckLogMessages(data, dataLength, files, 120, 480);
+    TEST_CHECK_RESULT(count, 480 - 120 + 1);
+    free(data);
+    TEST_CHECK_RESULT(exportScanPeriodOfTime(&store, &startDate, &endDate, NULL, 0, 100, false, NULL, NULL, &data,
+                                             &dataLength), ERROR_TOO_MANY_RECORDS);
+    TEST_CHECK_RESULT(logStoreClose(&store), EXECUTION_OK);
+
+    testRemoveDirectory(directory);
+    return EXIT_SUCCESS;
+}
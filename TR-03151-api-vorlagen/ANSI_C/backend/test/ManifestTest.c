@@ -0,0 +1,107 @@
+#include <stdint.h>
+
+#include "Test.h"
+#include "../Sha256.h"
+#include "../TarManifest.h"
+
+/**
+ * Checks the integrity manifest of export archives against roots calculated independently after RFC 6962: the
+ * root of an empty archive, of trees whose number of files is no power of two, the encoding of the manifest, and
+ * a tree that is reduced by several threads.
+ */
+
+#define MANIFEST_TEST_ENTRIES 10000
+
+struct ManifestTestVector {
+    size_t entryCount;
+    const char *root;
+};
+
+/**
+ * Roots of the manifests of the first entryCount files of manifestTestAdd
+ */
+static const struct ManifestTestVector manifestTestVectors[] = {
+    {0, "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855"},
+    {1, "a0f8d5d4e53ba8eac3917f758a1eee661284d1eb4ff8b859395f05db8712554b"},
+    {2, "38d8511b4df9d9f70e3772ba1922cc2750035d99244c67d3ac27fde1451e0e3d"},
+    {3, "f73ed06e1cebb546bfda4fae033444eb8b6b9b42743899f74915c2ffb3d86ffc"},
+    {5, "fd673e33cd1da34e501b985daedf3c60f91d86ebd936314ce8c9ff0a3ecd3935"},
+    {7, "a0b754da32417260a40ed659355beab7b189affbc590b805e95f8401952df5ea"},
+    {MANIFEST_TEST_ENTRIES, "2fa1d2a45e5188202461ee89ff601de762276db9ce9a0281ad47fa7ca8df656d"}
+};
+
+#define MANIFEST_TEST_VECTOR_COUNT (sizeof manifestTestVectors / sizeof manifestTestVectors[0])
+
+static const char manifestTestEncoded[] =
+    "SHA-256 manifest 1\n"
+    "root f73ed06e1cebb546bfda4fae033444eb8b6b9b42743899f74915c2ffb3d86ffc\n"
+    "entries 3\n"
+    "512 100 0482d5484c878b8ed205555d036443a94888ae6876bcb032d239737d2daf140f Log-00000.log\n"
+    "2048 101 6324440a4018bc9ab874d63951d344352f27074b23997ffbb909e862c799c852 Log-00001.log\n"
+    "3584 102 68f05ea066b963de6f49c0699e407ebd6abc11c45064cb5d5c9cedbb2b875d11 Log-00002.log\n";
+
+/**
+ * Adds the files "Log-00000.log" to "Log-<entryCount - 1>.log", whose content is their name.
+ */
+static void manifestTestAdd(struct TarManifest *manifest,
+                            size_t entryCount)
+{
+    char name[32];
+    unsigned char digest[SHA256_DIGEST_LENGTH];
+    size_t i;
+
+    for (i = 0; i < entryCount; i++) {
+        int length = snprintf(name, sizeof name, "Log-%05zu.log", i);
+
+        TEST_CHECK(length > 0 && (size_t) length < sizeof name);
+        sha256Digest(name, (size_t) length, digest);
+        TEST_CHECK_RESULT(tarManifestAdd(manifest, name, 512 * (i + 1) + 1024 * i, 100 + i, digest), EXECUTION_OK);
+    }
+}
+
+static void manifestTestCheckRoot(const struct TarManifest *manifest,
+                                  const char *expected)
+{
+    unsigned char root[SHA256_DIGEST_LENGTH];
+    char hex[2 * SHA256_DIGEST_LENGTH + 1];
+    size_t i;
+
+    TEST_CHECK_RESULT(tarManifestRoot(manifest, root), EXECUTION_OK);
+    for (i = 0; i < sizeof root; i++) {
+        snprintf(hex + 2 * i, 3, "%02x", root[i]);
+    }
+    if (strcmp(hex, expected) != 0) {
+        fprintf(stderr, "root of %zu files is %s instead of %s\n", manifest->entryCount, hex, expected);
+        exit(EXIT_FAILURE);
+    }
+}
+
+int main(void)
+{
+    struct TarManifest manifest;
+    unsigned char *data;
+    size_t dataLength;
+    size_t i;
+
+    for (i = 0; i < MANIFEST_TEST_VECTOR_COUNT; i++) {
+        tarManifestInit(&manifest, 0);
+        manifestTestAdd(&manifest, manifestTestVectors[i].entryCount);
+        manifestTestCheckRoot(&manifest, manifestTestVectors[i].root);
+        tarManifestFree(&manifest);
+    }
+
+    tarManifestInit(&manifest, 0);
+    manifestTestAdd(&manifest, 3);
+    TEST_CHECK_RESULT(tarManifestEncode(&manifest, &data, &dataLength), EXECUTION_OK);
+    TEST_CHECK_RESULT(dataLength, sizeof manifestTestEncoded - 1);
+    TEST_CHECK(memcmp(data, manifestTestEncoded, dataLength) == 0);
+    free(data);
+    tarManifestFree(&manifest);
+
+    /* the subtrees of several threads are combined to the same root */
+    tarManifestInit(&manifest, 4);
+    manifestTestAdd(&manifest, MANIFEST_TEST_ENTRIES);
+    manifestTestCheckRoot(&manifest, manifestTestVectors[MANIFEST_TEST_VECTOR_COUNT - 1].root);
+    tarManifestFree(&manifest);
+    return EXIT_SUCCESS;
+}
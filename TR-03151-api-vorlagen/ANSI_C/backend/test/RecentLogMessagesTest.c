@@ -0,0 +1,152 @@
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+
+#include "Test.h"
+#include "../RecentLogMessages.h"
+
+/**
+ * Checks the recent log messages: the ring of a client keeps its last RECENT_LOG_MESSAGES_PER_CLIENT log messages,
+ * long payloads are not kept, the client whose last log message is the oldest gives up its entry when the table is
+ * full, and readers that run concurrently with the writer only return log messages whose members belong together.
+ */
+
+#define RECENT_TEST_CLIENTS 4
+#define RECENT_TEST_READERS 4
+#define RECENT_TEST_MESSAGES 200000
+
+static struct RecentLogMessages recentTestMessages;
+static atomic_bool recentTestStopping;
+
+/**
+ * Derives all members of a log message from its signature counter, so that a reader can recognize a copy that mixes
+ * two log messages.
+ */
+static void recentTestRecord(uint64_t signatureCounter,
+                             unsigned int client,
+                             struct LogRecord *record,
+                             unsigned char *clientId,
+                             unsigned char *payload)
+{
+    int length = snprintf((char *) clientId, TRANSACTION_CLIENT_ID_MAX, "Kasse-%u", client);
+
+    TEST_CHECK(length > 0 && length < TRANSACTION_CLIENT_ID_MAX);
+    memset(record, 0, sizeof *record);
+    record->signatureCounter = signatureCounter;
+    record->transactionNumber = signatureCounter;
+    record->logTime = 3 * (int64_t) signatureCounter;
+    record->type = transactionLogMessage;
+    record->operation = updateTransactionOperation;
+    record->clientId = clientId;
+    record->clientIdLength = (unsigned long int) length;
+    record->payloadLength = 1 + signatureCounter % RECENT_LOG_MESSAGE_PAYLOAD_SIZE;
+    memset(payload, (int) (signatureCounter & 0xff), record->payloadLength);
+    record->payload = payload;
+}
+
+static void recentTestCheck(const struct RecentLogMessage *message)
+{
+    unsigned char clientId[TRANSACTION_CLIENT_ID_MAX];
+    uint32_t i;
+    int length = snprintf((char *) clientId, sizeof clientId, "Kasse-%u",
+                          (unsigned int) (message->signatureCounter % RECENT_TEST_CLIENTS));
+
+    TEST_CHECK_RESULT(message->transactionNumber, message->signatureCounter);
+    TEST_CHECK_RESULT(message->logTime, 3 * (int64_t) message->signatureCounter);
+    TEST_CHECK_RESULT(message->payloadLength, 1 + message->signatureCounter % RECENT_LOG_MESSAGE_PAYLOAD_SIZE);
+    TEST_CHECK_RESULT(message->clientIdLength, length);
+    TEST_CHECK(memcmp(message->clientId, clientId, (size_t) length) == 0);
+    for (i = 0; i < message->payloadLength; i++) {
+        TEST_CHECK_RESULT(message->payload[i], message->signatureCounter & 0xff);
+    }
+}
+
+static void *recentTestRead(void *context)
+{
+    unsigned int client = (unsigned int) (uintptr_t) context;
+    unsigned char clientId[TRANSACTION_CLIENT_ID_MAX];
+    int length = snprintf((char *) clientId, sizeof clientId, "Kasse-%u", client);
+    static _Thread_local struct RecentLogMessage message;
+    uint64_t lastSignatureCounter = 0;
+    uint64_t clientSignatureCounter = 0;
+
+    while (!atomic_load(&recentTestStopping)) {
+        if (recentLogMessagesLast(&recentTestMessages, &message) == EXECUTION_OK) {
+            recentTestCheck(&message);
+            TEST_CHECK(message.signatureCounter >= lastSignatureCounter);
+            lastSignatureCounter = message.signatureCounter;
+        }
+        if (recentLogMessagesFind(&recentTestMessages, clientId, (uint32_t) length, 0, &message) == EXECUTION_OK) {
+            recentTestCheck(&message);
+            TEST_CHECK_RESULT(message.signatureCounter % RECENT_TEST_CLIENTS, client);
+            TEST_CHECK(message.signatureCounter >= clientSignatureCounter);
+            clientSignatureCounter = message.signatureCounter;
+        }
+    }
+    return NULL;
+}
+
+int main(void)
+{
+    static unsigned char payload[2 * RECENT_LOG_MESSAGE_PAYLOAD_SIZE];
+    static struct RecentLogMessage message;
+    unsigned char clientId[TRANSACTION_CLIENT_ID_MAX];
+    pthread_t readers[RECENT_TEST_READERS];
+    struct LogRecord record;
+    uint64_t signatureCounter;
+    unsigned int i;
+
+    /* the ring of a client keeps its most recent log messages */
+    recentLogMessagesInit(&recentTestMessages);
+    TEST_CHECK_RESULT(recentLogMessagesLast(&recentTestMessages, &message), ERROR_NO_LOG_MESSAGE);
+    for (signatureCounter = 1; signatureCounter <= 2 * RECENT_LOG_MESSAGES_PER_CLIENT; signatureCounter++) {
+        recentTestRecord(signatureCounter, 0, &record, clientId, payload);
+        recentLogMessagesAdd(&recentTestMessages, &record);
+    }
+    TEST_CHECK_RESULT(recentLogMessagesFind(&recentTestMessages, clientId, (uint32_t) record.clientIdLength,
+                                            RECENT_LOG_MESSAGES_PER_CLIENT, &message), ERROR_NO_LOG_MESSAGE);
+    TEST_CHECK_RESULT(recentLogMessagesFind(&recentTestMessages, clientId, (uint32_t) record.clientIdLength,
+                                            RECENT_LOG_MESSAGES_PER_CLIENT + 1, &message), EXECUTION_OK);
+    TEST_CHECK_RESULT(message.signatureCounter, RECENT_LOG_MESSAGES_PER_CLIENT + 1);
+    TEST_CHECK_RESULT(message.payloadLength, RECENT_LOG_MESSAGES_PER_CLIENT + 2);
+
+    /* a payload longer than a slot is only announced by its length */
+    recentTestRecord(signatureCounter, 0, &record, clientId, payload);
+    record.payloadLength = sizeof payload;
+    recentLogMessagesAdd(&recentTestMessages, &record);
+    TEST_CHECK_RESULT(recentLogMessagesLast(&recentTestMessages, &message), EXECUTION_OK);
+    TEST_CHECK_RESULT(message.signatureCounter, signatureCounter);
+    TEST_CHECK_RESULT(message.payloadLength, sizeof payload);
+    signatureCounter++;
+
+    /* a full table gives the entry of the client with the oldest log message to the new client */
+    for (i = 1; i <= RECENT_LOG_CLIENT_CAPACITY; i++, signatureCounter++) {
+        recentTestRecord(signatureCounter, i, &record, clientId, payload);
+        recentLogMessagesAdd(&recentTestMessages, &record);
+    }
+    recentTestRecord(signatureCounter, 0, &record, clientId, payload);
+    TEST_CHECK_RESULT(recentLogMessagesFind(&recentTestMessages, clientId, (uint32_t) record.clientIdLength, 0,
+                                            &message), ERROR_NO_LOG_MESSAGE);
+    recentTestRecord(signatureCounter, RECENT_LOG_CLIENT_CAPACITY, &record, clientId, payload);
+    TEST_CHECK_RESULT(recentLogMessagesFind(&recentTestMessages, clientId, (uint32_t) record.clientIdLength, 0,
+                                            &message), EXECUTION_OK);
+
+    /* the readers check every copy while one writer adds the log messages of RECENT_TEST_CLIENTS clients */
+    recentLogMessagesInit(&recentTestMessages);
+    for (i = 0; i < RECENT_TEST_READERS; i++) {
+        TEST_CHECK(pthread_create(&readers[i], NULL, recentTestRead, (void *) (uintptr_t) (i % RECENT_TEST_CLIENTS))
+                   == 0);
+    }
+    for (signatureCounter = 1; signatureCounter <= RECENT_TEST_MESSAGES; signatureCounter++) {
+        recentTestRecord(signatureCounter, (unsigned int) (signatureCounter % RECENT_TEST_CLIENTS), &record,
+                         clientId, payload);
+        recentLogMessagesAdd(&recentTestMessages, &record);
+    }
+    atomic_store(&recentTestStopping, true);
+    for (i = 0; i < RECENT_TEST_READERS; i++) {
+        TEST_CHECK(pthread_join(readers[i], NULL) == 0);
+    }
+    TEST_CHECK_RESULT(recentLogMessagesLast(&recentTestMessages, &message), EXECUTION_OK);
+    TEST_CHECK_RESULT(message.signatureCounter, RECENT_TEST_MESSAGES);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,156 @@
+#include <fcntl.h>
+#include <signal.h>
+#include <stdint.h>
+#include <sys/resource.h>
+
+#include "Test.h"
+#include "../LogStore.h"
+
+/**
+ * Checks the recovery of the log store: an incomplete record at the end of the last segment is cut off, a record
+ * header with an oversized length is treated as the end of the records without allocating its length, a write that
+ * fails leaves neither the record nor its open transaction behind, and a store whose checkpoint cannot be written
+ * is not opened.
+ */
+
+#define RECOVERY_TEST_RECORDS 100
+
+/**
+ * Length of the header of a record and offset of its member payloadLength
+ */
+#define RECOVERY_TEST_HEADER_LENGTH 40
+#define RECOVERY_TEST_PAYLOAD_LENGTH_OFFSET 32
+
+static const unsigned char recoveryTestClientId[] = "Kasse1";
+static const unsigned char recoveryTestPayload[200] = {1};
+
+static short int recoveryTestAppend(struct LogStore *store,
+                                    uint64_t signatureCounter,
+                                    uint64_t transactionNumber,
+                                    enum TransactionOperation operation)
+{
+    struct LogRecord record;
+
+    memset(&record, 0, sizeof record);
+    record.signatureCounter = signatureCounter;
+    record.transactionNumber = transactionNumber;
+    record.logTime = 1700000000 + (int64_t) signatureCounter;
+    record.type = transactionLogMessage;
+    record.operation = operation;
+    record.clientId = recoveryTestClientId;
+    record.clientIdLength = sizeof recoveryTestClientId - 1;
+    record.payload = recoveryTestPayload;
+    record.payloadLength = sizeof recoveryTestPayload;
+    return logStoreAppend(store, &record);
+}
+
+static void recoveryTestSegmentPath(const char *directory,
+                                    const struct LogStore *store,
+                                    char *path,
+                                    size_t pathSize)
+{
+    int length = snprintf(path, pathSize, "%s/segment-%08x.log", directory,
+                          store->segments[store->segmentCount - 1].id);
+
+    TEST_CHECK(length > 0 && (size_t) length < pathSize);
+}
+
+static off_t recoveryTestFileSize(const char *path)
+{
+    struct stat status;
+
+    TEST_CHECK(stat(path, &status) == 0);
+    return status.st_size;
+}
+
+int main(int argc,
+         char **argv)
+{
+    char directory[4096];
+    char storeDirectory[4096];
+    char segmentPath[4096];
+    char checkpointPath[4096];
+    unsigned char header[RECOVERY_TEST_HEADER_LENGTH];
+    struct LogStoreOptions options;
+    struct LogStore store;
+    struct rlimit limit;
+    uint32_t payloadLength = UINT32_MAX;
+    uint64_t i;
+    off_t size;
+    int fd;
+
+    testCreateDirectory(argc, argv, "recovery", directory, sizeof directory);
+    testCreateSubdirectory(directory, "store", storeDirectory, sizeof storeDirectory);
+    memset(&options, 0, sizeof options);
+    options.segmentSizeLimit = 1024u * 1024u;
+
+    /* every second transaction stays open */
+    TEST_CHECK_RESULT(logStoreOpen(&store, storeDirectory, &options), EXECUTION_OK);
+    for (i = 1; i <= RECOVERY_TEST_RECORDS; i++) {
+        TEST_CHECK_RESULT(recoveryTestAppend(&store, i, (i + 1) / 2, i % 2 == 1 ? startTransactionOperation
+                                             : i % 4 == 0 ? finishTransactionOperation : updateTransactionOperation),
+                          EXECUTION_OK);
+    }
+    recoveryTestSegmentPath(storeDirectory, &store, segmentPath, sizeof segmentPath);
+    TEST_CHECK_RESULT(store.openTransactions.count, RECOVERY_TEST_RECORDS / 4);
+    TEST_CHECK_RESULT(logStoreClose(&store), EXECUTION_OK);
+
+    /* the last record loses its end, e.g. by a loss of power during the write */
+    size = recoveryTestFileSize(segmentPath);
+    TEST_CHECK(truncate(segmentPath, size - 10) == 0);
+    TEST_CHECK_RESULT(logStoreOpen(&store, storeDirectory, &options), EXECUTION_OK);
+    TEST_CHECK_RESULT(store.lastSignatureCounter, RECOVERY_TEST_RECORDS - 1);
+    TEST_CHECK_RESULT(store.openTransactions.count, RECOVERY_TEST_RECORDS / 4 + 1);
+    TEST_CHECK(recoveryTestFileSize(segmentPath) < size - 10);
+    TEST_CHECK_RESULT(recoveryTestAppend(&store, RECOVERY_TEST_RECORDS, RECOVERY_TEST_RECORDS / 2,
+                                         finishTransactionOperation), EXECUTION_OK);
+    size = recoveryTestFileSize(segmentPath);
+    TEST_CHECK_RESULT(logStoreClose(&store), EXECUTION_OK);
+
+    /* a header that has the right magic but a length of 4 GiB ends the records without reading its length */
+    fd = open(segmentPath, O_RDWR);
+    TEST_CHECK(fd >= 0);
+    TEST_CHECK(pread(fd, header, sizeof header, 0) == (ssize_t) sizeof header);
+    memcpy(header + RECOVERY_TEST_PAYLOAD_LENGTH_OFFSET, &payloadLength, sizeof payloadLength);
+    TEST_CHECK(pwrite(fd, header, sizeof header, size) == (ssize_t) sizeof header);
+    TEST_CHECK(close(fd) == 0);
+    /* the shadow memory of -fsanitize=address does not fit into the limit of the data segment */
+#ifndef __SANITIZE_ADDRESS__
+    TEST_CHECK(getrlimit(RLIMIT_DATA, &limit) == 0);
+    limit.rlim_cur = limit.rlim_max != RLIM_INFINITY && limit.rlim_max < (rlim_t) 1 << 30 ? limit.rlim_max
+                     : (rlim_t) 1 << 30;
+    TEST_CHECK(setrlimit(RLIMIT_DATA, &limit) == 0);
+#endif
+    TEST_CHECK_RESULT(logStoreOpen(&store, storeDirectory, &options), EXECUTION_OK);
+    TEST_CHECK_RESULT(store.lastSignatureCounter, RECOVERY_TEST_RECORDS);
+    TEST_CHECK_RESULT(recoveryTestFileSize(segmentPath), size);
+
+    /* a start record whose write fails is neither stored nor opens its transaction */
+    signal(SIGXFSZ, SIG_IGN);
+    TEST_CHECK(getrlimit(RLIMIT_FSIZE, &limit) == 0);
+    limit.rlim_cur = (rlim_t) size + 1;
+    TEST_CHECK(setrlimit(RLIMIT_FSIZE, &limit) == 0);
+    TEST_CHECK_RESULT(recoveryTestAppend(&store, RECOVERY_TEST_RECORDS + 1, RECOVERY_TEST_RECORDS,
+                                         startTransactionOperation), ERROR_STORAGE_FAILURE);
+    limit.rlim_cur = limit.rlim_max;
+    TEST_CHECK(setrlimit(RLIMIT_FSIZE, &limit) == 0);
+    TEST_CHECK_RESULT(recoveryTestFileSize(segmentPath), size);
+    TEST_CHECK_RESULT(store.lastSignatureCounter, RECOVERY_TEST_RECORDS);
+    TEST_CHECK(transactionTableFind(&store.openTransactions, RECOVERY_TEST_RECORDS) == NULL);
+    TEST_CHECK_RESULT(recoveryTestAppend(&store, RECOVERY_TEST_RECORDS + 1, RECOVERY_TEST_RECORDS,
+                                         startTransactionOperation), EXECUTION_OK);
+    TEST_CHECK(transactionTableFind(&store.openTransactions, RECOVERY_TEST_RECORDS) != NULL);
+    TEST_CHECK_RESULT(logStoreClose(&store), EXECUTION_OK);
+
+    /* the checkpoint written by the opening cannot be created; the store is released and the caller does not close
+       it, which a build with -fsanitize=address reports as a leak otherwise */
+    testCreateSubdirectory(storeDirectory, "index.ckp.tmp", checkpointPath, sizeof checkpointPath);
+    TEST_CHECK(logStoreOpen(&store, storeDirectory, &options) != EXECUTION_OK);
+    TEST_CHECK(rmdir(checkpointPath) == 0);
+    TEST_CHECK_RESULT(logStoreOpen(&store, storeDirectory, &options), EXECUTION_OK);
+    TEST_CHECK_RESULT(store.lastSignatureCounter, RECOVERY_TEST_RECORDS + 1);
+    TEST_CHECK_RESULT(logStoreClose(&store), EXECUTION_OK);
+
+    testRemoveDirectory(directory);
+    return EXIT_SUCCESS;
+}
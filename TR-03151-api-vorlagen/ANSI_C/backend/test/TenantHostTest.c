@@ -0,0 +1,88 @@
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdint.h>
+
+#include "Test.h"
+#include "../TenantHost.h"
+
+/**
+ * Checks the attaching of tenants: concurrent attaches of a new tenant open its backend once and return the same
+ * backend, an attach whose backend cannot be opened leaves no entry behind, and a detached tenant can be attached
+ * again.
+ */
+
+#define TENANT_HOST_TEST_THREADS 16
+
+struct TenantHostTestAttach {
+    pthread_t thread;
+    struct TenantHost *host;
+    short int result;
+    int64_t binding;
+};
+
+static void *tenantHostTestAttach(void *context)
+{
+    struct TenantHostTestAttach *attach = context;
+    int64_t results[1];
+
+    attach->result = tenantHostAttach(attach->host, "shop", 4, NULL, 0, results);
+    attach->binding = results[0];
+    return NULL;
+}
+
+int main(int argc,
+         char **argv)
+{
+    static struct TenantHostTestAttach attaches[TENANT_HOST_TEST_THREADS];
+    char directory[4096];
+    char brokenPath[4096];
+    struct TenantHost *host;
+    int64_t results[SE_API_BINDING_RESULT_COUNT];
+    int64_t binding;
+    int length;
+    int fd;
+    size_t i;
+
+    testCreateDirectory(argc, argv, "tenants", directory, sizeof directory);
+    TEST_CHECK_RESULT(tenantHostOpen(directory, 0, 0, 0, 0, results), EXECUTION_OK);
+    host = (struct TenantHost *) (intptr_t) results[0];
+
+    /* the threads attach the new tenant at the same time; one of them creates and opens it */
+    for (i = 0; i < TENANT_HOST_TEST_THREADS; i++) {
+        attaches[i].host = host;
+        TEST_CHECK(pthread_create(&attaches[i].thread, NULL, tenantHostTestAttach, &attaches[i]) == 0);
+    }
+    for (i = 0; i < TENANT_HOST_TEST_THREADS; i++) {
+        TEST_CHECK(pthread_join(attaches[i].thread, NULL) == 0);
+        TEST_CHECK_RESULT(attaches[i].result, EXECUTION_OK);
+        TEST_CHECK_RESULT(attaches[i].binding, attaches[0].binding);
+    }
+    TEST_CHECK_RESULT(host->tenantCount, 1);
+    binding = attaches[0].binding;
+    TEST_CHECK_RESULT(seApiBindingUpdateTime((struct SeApiBinding *) (intptr_t) binding, 1562781600, results),
+                      EXECUTION_OK);
+
+    /* a file in place of the subdirectory cannot be opened as a backend */
+    length = snprintf(brokenPath, sizeof brokenPath, "%s/broken", directory);
+    TEST_CHECK(length > 0 && (size_t) length < sizeof brokenPath);
+    fd = open(brokenPath, O_WRONLY | O_CREAT | O_EXCL, 0600);
+    TEST_CHECK(fd >= 0);
+    TEST_CHECK(close(fd) == 0);
+    TEST_CHECK(tenantHostAttach(host, "broken", 6, NULL, 0, results) != EXECUTION_OK);
+    TEST_CHECK(tenantHostAttach(host, "broken", 6, NULL, 0, results) != EXECUTION_OK);
+    TEST_CHECK_RESULT(tenantHostDetach(host, "broken", 6), ERROR_ID_NOT_FOUND);
+    TEST_CHECK_RESULT(host->tenantCount, 1);
+
+    /* the tenant is opened again after it has been detached and continues its signature counter */
+    TEST_CHECK_RESULT(tenantHostDetach(host, "shop", 4), EXECUTION_OK);
+    TEST_CHECK_RESULT(tenantHostDetach(host, "shop", 4), ERROR_ID_NOT_FOUND);
+    TEST_CHECK_RESULT(tenantHostAttach(host, "shop", 4, NULL, 0, results), EXECUTION_OK);
+    binding = results[0];
+    TEST_CHECK_RESULT(seApiBindingUpdateTime((struct SeApiBinding *) (intptr_t) binding, 1562781660, results),
+                      EXECUTION_OK);
+    TEST_CHECK_RESULT(results[SE_API_BINDING_SIGNATURE_COUNTER], 2);
+    TEST_CHECK_RESULT(tenantHostClose(host), EXECUTION_OK);
+
+    testRemoveDirectory(directory);
+    return EXIT_SUCCESS;
+}
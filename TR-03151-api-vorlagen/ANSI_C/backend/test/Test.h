@@ -0,0 +1,118 @@
+#ifndef SEAPI_BACKEND_TEST_H
+#define SEAPI_BACKEND_TEST_H
+
+#include <ftw.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+/**
+ * This header file defines the checks shared by the behavior tests of the SE API backend. Every test is a program
+ *
+ *     <test> <directory>
+ *
+ * that creates its data in a new subdirectory of the existing directory, removes it at the end and returns
+ * EXIT_SUCCESS if all of its checks hold. A failed check is printed with its position and ends the test.
+ */
+
+/**
+ * Ends the test with EXIT_FAILURE if the condition does not hold.
+ */
+#define TEST_CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+            exit(EXIT_FAILURE); \
+        } \
+    } while (0)
+
+/**
+ * Ends the test with EXIT_FAILURE if a return value is not the expected one.
+ */
+#define TEST_CHECK_RESULT(result, expected) \
+    do { \
+        long long testActual = (long long) (result); \
+        long long testExpected = (long long) (expected); \
+        if (testActual != testExpected) { \
+            fprintf(stderr, "%s:%d: %s returned %lld instead of %lld\n", __FILE__, __LINE__, #result, testActual, \
+                    testExpected); \
+            exit(EXIT_FAILURE); \
+        } \
+    } while (0)
+
+static inline int testRemoveEntry(const char *path,
+                                  const struct stat *status,
+                                  int type,
+                                  struct FTW *position)
+{
+    (void) status;
+    (void) type;
+    (void) position;
+    return remove(path);
+}
+
+/**
+ * Creates the subdirectory of a test in the directory passed on the command line.
+ * @param[in] argc
+ *                number of the arguments of the test [REQUIRED]
+ * @param[in] argv
+ *                arguments of the test [REQUIRED]
+ * @param[in] name
+ *                name of the test, terminated by NUL [REQUIRED]
+ * @param[out] path
+ *                receives the path of the subdirectory [REQUIRED]
+ * @param[in] pathSize
+ *                size of path [REQUIRED]
+ */
+static inline void testCreateDirectory(int argc,
+                                       char **argv,
+                                       const char *name,
+                                       char *path,
+                                       size_t pathSize)
+{
+    int length;
+
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s <directory>\n", argv[0]);
+        exit(EXIT_FAILURE);
+    }
+    length = snprintf(path, pathSize, "%s/%s-XXXXXX", argv[1], name);
+    TEST_CHECK(length > 0 && (size_t) length < pathSize);
+    TEST_CHECK(mkdtemp(path) != NULL);
+}
+
+/**
+ * Creates a directory below the subdirectory of a test.
+ * @param[in] base
+ *                subdirectory of the test [REQUIRED]
+ * @param[in] name
+ *                name of the new directory, terminated by NUL [REQUIRED]
+ * @param[out] path
+ *                receives the path of the new directory [REQUIRED]
+ * @param[in] pathSize
+ *                size of path [REQUIRED]
+ */
+static inline void testCreateSubdirectory(const char *base,
+                                          const char *name,
+                                          char *path,
+                                          size_t pathSize)
+{
+    int length = snprintf(path, pathSize, "%s/%s", base, name);
+
+    TEST_CHECK(length > 0 && (size_t) length < pathSize);
+    TEST_CHECK(mkdir(path, 0700) == 0);
+}
+
+/**
+ * Removes the subdirectory of a test with its content.
+ * @param[in] path
+ *                subdirectory of the test [REQUIRED]
+ */
+static inline void testRemoveDirectory(const char *path)
+{
+    nftw(path, testRemoveEntry, 16, FTW_DEPTH | FTW_PHYS);
+}
+
+#endif
@@ -0,0 +1,209 @@
+package de.bsi.seapi;
+
+/**
+ * This class defines the error codes of the SE API as return values. The values are equal to the error codes
+ * of Exception.h of the ANSI C interface and to the return values of the native SE API backend. Each error
+ * code corresponds to the exception class of the same name in the package de.bsi.seapi.exceptions
+ */
+public final class ErrorCodes {
+
+    /**
+     * Error code that corresponds to the exception ErrorRetrieveLogMessageFailed
+     */
+    public static final short ERROR_RETRIEVE_LOG_MESSAGE_FAILED = -5001;
+
+    /**
+     * Error code that corresponds to the exception ErrorStorageFailure
+     */
+    public static final short ERROR_STORAGE_FAILURE = -5002;
+
+    /**
+     * Error code that corresponds to the exception ErrorUpdateTimeFailed
+     */
+    public static final short ERROR_UPDATE_TIME_FAILED = -5003;
+
+    /**
+     * Error code that corresponds to the exception ErrorParameterMismatch
+     */
+    public static final short ERROR_PARAMETER_MISMATCH = -5004;
+
+    /**
+     * Error code that corresponds to the exception ErrorIdNotFound
+     */
+    public static final short ERROR_ID_NOT_FOUND = -5005;
+
+    /**
+     * Error code that corresponds to the exception ErrorTransactionNumberNotFound
+     */
+    public static final short ERROR_TRANSACTION_NUMBER_NOT_FOUND = -5006;
+
+    /**
+     * Error code that corresponds to the exception ErrorNoDataAvailable
+     */
+    public static final short ERROR_NO_DATA_AVAILABLE = -5007;
+
+    /**
+     * Error code that corresponds to the exception ErrorTooManyRecords
+     */
+    public static final short ERROR_TOO_MANY_RECORDS = -5008;
+
+    /**
+     * Error code that corresponds to the exception ErrorStartTransactionFailed
+     */
+    public static final short ERROR_START_TRANSACTION_FAILED = -5009;
+
+    /**
+     * Error code that corresponds to the exception ErrorUpdateTransactionFailed
+     */
+    public static final short ERROR_UPDATE_TRANSACTION_FAILED = -5010;
+
+    /**
+     * Error code that corresponds to the exception ErrorFinishTransactionFailed
+     */
+    public static final short ERROR_FINISH_TRANSACTION_FAILED = -5011;
+
+    /**
+     * Error code that corresponds to the exception ErrorRestoreFailed
+     */
+    public static final short ERROR_RESTORE_FAILED = -5012;
+
+    /**
+     * Error code that corresponds to the exception ErrorStoringInitDataFailed
+     */
+    public static final short ERROR_STORING_INIT_DATA_FAILED = -5013;
+
+    /**
+     * Error code that corresponds to the exception ErrorExportCertFailed
+     */
+    public static final short ERROR_EXPORT_CERT_FAILED = -5014;
+
+    /**
+     * Error code that corresponds to the exception ErrorNoLogMessage
+     */
+    public static final short ERROR_NO_LOG_MESSAGE = -5015;
+
+    /**
+     * Error code that corresponds to the exception ErrorReadingLogMessage
+     */
+    public static final short ERROR_READING_LOG_MESSAGE = -5016;
+
+    /**
+     * Error code that corresponds to the exception ErrorNoTransaction
+     */
+    public static final short ERROR_NO_TRANSACTION = -5017;
+
+    /**
+     * Error code that corresponds to the exception ErrorSeApiNotInitialized
+     */
+    public static final short ERROR_SE_API_NOT_INITIALIZED = -5018;
+
+    /**
+     * Error code that corresponds to the exception ErrorTimeNotSet
+     */
+    public static final short ERROR_TIME_NOT_SET = -5019;
+
+    /**
+     * Error code that corresponds to the exception ErrorCertificateExpired
+     */
+    public static final short ERROR_CERTIFICATE_EXPIRED = -5020;
+
+    /**
+     * Error code that corresponds to the exception ErrorSecureElementDisabled
+     */
+    public static final short ERROR_SECURE_ELEMENT_DISABLED = -5021;
+
+    /**
+     * Error code that corresponds to the exception ErrorUserNotAuthorized
+     */
+    public static final short ERROR_USER_NOT_AUTHORIZED = -5022;
+
+    /**
+     * Error code that corresponds to the exception ErrorUserNotAuthenticated
+     */
+    public static final short ERROR_USER_NOT_AUTHENTICATED = -5023;
+
+    /**
+     * Error code that corresponds to the exception ErrorDescriptionNotSetByManufacturer
+     */
+    public static final short ERROR_DESCRIPTION_NOT_SET_BY_MANUFACTURER = -5024;
+
+    /**
+     * Error code that corresponds to the exception ErrorDescriptionSetByManufacturer
+     */
+    public static final short ERROR_DESCRIPTION_SET_BY_MANUFACTURER = -5025;
+
+    /**
+     * Error code that corresponds to the exception ErrorExportSerialNumbersFailed
+     */
+    public static final short ERROR_EXPORT_SERIAL_NUMBERS_FAILED = -5026;
+
+    /**
+     * Error code that corresponds to the exception ErrorGetMaxNumberOfClientsFailed
+     */
+    public static final short ERROR_GET_MAX_NUMBER_OF_CLIENTS_FAILED = -5027;
+
+    /**
+     * Error code that corresponds to the exception ErrorGetCurrentNumberOfClientsFailed
+     */
+    public static final short ERROR_GET_CURRENT_NUMBER_OF_CLIENTS_FAILED = -5028;
+
+    /**
+     * Error code that corresponds to the exception ErrorGetMaxNumberTransactionsFailed. As in Exception.h, the value is shared
+     * with another error code and is interpreted according to the function that returned it
+     */
+    public static final short ERROR_GET_MAX_NUMBER_TRANSACTIONS_FAILED = -5039;
+
+    /**
+     * Error code that corresponds to the exception ErrorGetCurrentNumberOfTransactionsFailed
+     */
+    public static final short ERROR_GET_CURRENT_NUMBER_OF_TRANSACTIONS_FAILED = -5030;
+
+    /**
+     * Error code that corresponds to the exception ErrorGetSupportedUpdateVariantsFailed
+     */
+    public static final short ERROR_GET_SUPPORTED_UPDATE_VARIANTS_FAILED = -5031;
+
+    /**
+     * Error code that corresponds to the exception ErrorDeleteStoredDataFailed
+     */
+    public static final short ERROR_DELETE_STORED_DATA_FAILED = -5032;
+
+    /**
+     * Error code that corresponds to the exception ErrorUnexportedStoredData
+     */
+    public static final short ERROR_UNEXPORTED_STORED_DATA = -5033;
+
+    /**
+     * Error code that corresponds to the exception ErrorSigningSystemOperationDataFailed
+     */
+    public static final short ERROR_SIGNING_SYSTEM_OPERATION_DATA_FAILED = -5034;
+
+    /**
+     * Error code that corresponds to the exception ErrorUserIdNotManaged
+     */
+    public static final short ERROR_USER_ID_NOT_MANAGED = -5035;
+
+    /**
+     * Error code that corresponds to the exception ErrorUserIdNotAuthenticated
+     */
+    public static final short ERROR_USER_ID_NOT_AUTHENTICATED = -5036;
+
+    /**
+     * Error code that corresponds to the exception ErrorDisableSecureElementFailed
+     */
+    public static final short ERROR_DISABLE_SECURE_ELEMENT_FAILED = -5037;
+
+    /**
+     * Error code that corresponds to the exception ErrorInvalidTime
+     */
+    public static final short ERROR_INVALID_TIME = -5038;
+
+    /**
+     * Error code that corresponds to the exception ErrorGetTimeSyncVariantFailed. As in Exception.h, the value is shared
+     * with another error code and is interpreted according to the function that returned it
+     */
+    public static final short ERROR_GET_TIME_SYNC_VARIANT_FAILED = -5039;
+
+    private ErrorCodes() {
+    }
+}
@@ -0,0 +1,117 @@
+package de.bsi.seapi;
+
+import de.bsi.seapi.holdertypes.TransactionResultHolder;
+
+/**
+ * This interface defines the transaction functions of the Secure Element API (SE API) in a variant that reports
+ * failures by return values instead of exceptions. The return values are EXECUTION_OK of Constant.java and the
+ * error codes of ErrorCodes.java, which are equal to those of Exception.h of the ANSI C interface.
+ *
+ * The output parameters of a function are set in a TransactionResultHolder that can be reused across calls.
+ * If ERROR_CERTIFICATE_EXPIRED is returned, the log message has been stored and the output parameters are set
+ * as in case of EXECUTION_OK.
+ */
+
+public interface SEAPIStatus {
+
+    /**
+     * Starts a new transaction
+     * 
+     * @param clientId
+     *            represents the ID of the application that has invoked the function
+     *            [INPUT PARAMETER, REQUIRED]
+     * @param processData
+     *            represents all the necessary information regarding the initial
+     *            state of the process [INPUT PARAMETER, REQUIRED]
+     * @param processType
+     *            identifies the type of the transaction as defined by the
+     *            application. The String representing the processType SHALL be
+     *            restricted to a length of 100 [INPUT PARAMETER, OPTIONAL]
+     * @param additionalData
+     *            reserved for future use [INPUT PARAMETER, OPTIONAL]
+     * @param result
+     *            receives the transaction number, the log time, the serial number,
+     *            the signature counter and the signature value
+     *            [OUTPUT PARAMETER, REQUIRED]
+     * @return if the execution of the function has been successful, the return
+     *         value EXECUTION_OK SHALL be returned. Otherwise one of the error
+     *         codes ERROR_START_TRANSACTION_FAILED, ERROR_RETRIEVE_LOG_MESSAGE_FAILED,
+     *         ERROR_STORAGE_FAILURE, ERROR_SE_API_NOT_INITIALIZED, ERROR_TIME_NOT_SET,
+     *         ERROR_CERTIFICATE_EXPIRED or ERROR_SECURE_ELEMENT_DISABLED SHALL be
+     *         returned
+     */
+    short startTransaction(String clientId, 
+                           byte[] processData, 
+                           String processType, 
+                           byte[] additionalData,
+                           TransactionResultHolder result);
+
+    /**
+     * Updates an open transaction
+     * 
+     * @param clientId
+     *            represents the ID of the application that has invoked the function
+     *            [INPUT PARAMETER, REQUIRED]
+     * @param transactionNumber
+     *            parameter is used to unambiguously identify the current
+     *            transaction [INPUT PARAMETER, REQUIRED]
+     * @param processData
+     *            represents all the new information regarding the state of the
+     *            process since the start of the transaction or the last update
+     *            [INPUT PARAMETER, REQUIRED]
+     * @param processType
+     *            identifies the type of the transaction as defined by the
+     *            application. The String representing the processType SHALL be
+     *            restricted to a length of 100 [INPUT PARAMETER, OPTIONAL]
+     * @param result
+     *            receives the log time, the signature counter and the signature
+     *            value [OUTPUT PARAMETER, REQUIRED]
+     * @return if the execution of the function has been successful, the return
+     *         value EXECUTION_OK SHALL be returned. Otherwise one of the error
+     *         codes ERROR_UPDATE_TRANSACTION_FAILED, ERROR_STORAGE_FAILURE,
+     *         ERROR_RETRIEVE_LOG_MESSAGE_FAILED, ERROR_NO_TRANSACTION,
+     *         ERROR_SE_API_NOT_INITIALIZED, ERROR_TIME_NOT_SET,
+     *         ERROR_CERTIFICATE_EXPIRED or ERROR_SECURE_ELEMENT_DISABLED SHALL be
+     *         returned
+     */
+    short updateTransaction(String clientId, 
+                            long transactionNumber, 
+                            byte[] processData, 
+                            String processType,
+                            TransactionResultHolder result);
+
+    /**
+     * Finishes a transaction
+     * 
+     * @param clientId
+     *            represents the ID of the application that has invoked the function
+     *            [INPUT PARAMETER, REQUIRED]
+     * @param transactionNumber
+     *            parameter is used to unambiguously identify the current
+     *            transaction [INPUT PARAMETER, REQUIRED]
+     * @param processData
+     *            represents all the information regarding the final state of the
+     *            process [INPUT PARAMETER, REQUIRED]
+     * @param processType
+     *            identifies the type of the transaction as defined by the
+     *            application. The String representing the processType SHALL be
+     *            restricted to a length of 100 [INPUT PARAMETER, OPTIONAL]
+     * @param additionalData
+     *            reserved for future use [INPUT PARAMETER, OPTIONAL]
+     * @param result
+     *            receives the log time, the signature counter and the signature
+     *            value [OUTPUT PARAMETER, REQUIRED]
+     * @return if the execution of the function has been successful, the return
+     *         value EXECUTION_OK SHALL be returned. Otherwise one of the error
+     *         codes ERROR_FINISH_TRANSACTION_FAILED, ERROR_RETRIEVE_LOG_MESSAGE_FAILED,
+     *         ERROR_STORAGE_FAILURE, ERROR_NO_TRANSACTION, ERROR_SE_API_NOT_INITIALIZED,
+     *         ERROR_TIME_NOT_SET, ERROR_CERTIFICATE_EXPIRED or
+     *         ERROR_SECURE_ELEMENT_DISABLED SHALL be returned
+     */
+    short finishTransaction(String clientId, 
+                            long transactionNumber, 
+                            byte[] processData, 
+                            String processType,
+                            byte[] additionalData, 
+                            TransactionResultHolder result);
+}
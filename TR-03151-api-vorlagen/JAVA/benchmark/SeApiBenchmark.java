@@ -0,0 +1,191 @@
+package de.bsi.seapi.benchmark;
+
+import java.io.IOException;
+import java.nio.ByteBuffer;
+import java.nio.file.Files;
+import java.nio.file.Path;
+import java.nio.file.Paths;
+import java.time.ZonedDateTime;
+import java.util.Comparator;
+import java.util.concurrent.TimeUnit;
+import java.util.stream.Stream;
+
+import org.openjdk.jmh.annotations.Benchmark;
+import org.openjdk.jmh.annotations.BenchmarkMode;
+import org.openjdk.jmh.annotations.Fork;
+import org.openjdk.jmh.annotations.Level;
+import org.openjdk.jmh.annotations.Measurement;
+import org.openjdk.jmh.annotations.Mode;
+import org.openjdk.jmh.annotations.OutputTimeUnit;
+import org.openjdk.jmh.annotations.Param;
+import org.openjdk.jmh.annotations.Scope;
+import org.openjdk.jmh.annotations.Setup;
+import org.openjdk.jmh.annotations.State;
+import org.openjdk.jmh.annotations.TearDown;
+import org.openjdk.jmh.annotations.Warmup;
+import org.openjdk.jmh.infra.Blackhole;
+
+import de.bsi.seapi.holdertypes.ByteArrayHolder;
+import de.bsi.seapi.holdertypes.LongHolder;
+import de.bsi.seapi.holdertypes.TransactionResultHolder;
+import de.bsi.seapi.holdertypes.ZonedDateTimeHolder;
+import de.bsi.seapi.nativebinding.FfmSeApiBackend;
+import de.bsi.seapi.nativebinding.JavaSeApiBackend;
+import de.bsi.seapi.nativebinding.JniSeApiBackend;
+import de.bsi.seapi.nativebinding.NativeArchive;
+import de.bsi.seapi.nativebinding.NativeSEAPI;
+import de.bsi.seapi.nativebinding.SeApiBackend;
+
+/**
+ * This class defines JMH benchmarks that compare the SE API on the native backend, called by the Foreign Function
+ * &amp; Memory API or by JNI, with the pure Java backend. The path of the shared library of the native backend is
+ * passed by the system property seapi.library, e.g.
+ *
+ * java -Dseapi.library=/path/to/libseapi.so --enable-native-access=ALL-UNNAMED -jar benchmarks.jar SeApiBenchmark
+ */
+@State(Scope.Thread)
+@BenchmarkMode(Mode.Throughput)
+@OutputTimeUnit(TimeUnit.SECONDS)
+@Warmup(iterations = 3, time = 2)
+@Measurement(iterations = 5, time = 2)
+@Fork(1)
+public class SeApiBenchmark {
+
+    /**
+     * Number of transactions that are stored before the export benchmarks
+     */
+    private static final int EXPORTED_TRANSACTIONS = 10000;
+
+    @Param({ "ffm", "jni", "java" })
+    public String backend;
+
+    @Param({ "64", "4096" })
+    public int processDataSize;
+
+    private Path directory;
+    private NativeSEAPI seApi;
+    private byte[] processData;
+    private ByteBuffer offHeapProcessData;
+    private final NativeArchive archive = new NativeArchive();
+    private final LongHolder transactionNumber = new LongHolder();
+    private final LongHolder signatureCounter = new LongHolder();
+    private final ZonedDateTimeHolder logTime = new ZonedDateTimeHolder();
+    private final ByteArrayHolder serialNumber = new ByteArrayHolder();
+    private final ByteArrayHolder signatureValue = new ByteArrayHolder();
+    private final ByteArrayHolder exportedData = new ByteArrayHolder();
+    private final TransactionResultHolder transactionResult = new TransactionResultHolder();
+
+    @Setup(Level.Trial)
+    public void open() throws Exception {
+        directory = Files.createTempDirectory("seapi-benchmark");
+        Path library = Paths.get(System.getProperty("seapi.library", "libseapi.so"));
+        SeApiBackend opened;
+        switch (backend) {
+        case "ffm":
+            opened = FfmSeApiBackend.open(library, directory);
+            break;
+        case "jni":
+            opened = JniSeApiBackend.open(library, directory);
+            break;
+        default:
+            opened = JavaSeApiBackend.open(directory);
+            break;
+        }
+        seApi = new NativeSEAPI(opened);
+        seApi.updateTime(ZonedDateTime.now());
+
+        processData = new byte[processDataSize];
+        for (int i = 0; i < processData.length; i++) {
+            processData[i] = (byte) ('A' + i % 26);
+        }
+        offHeapProcessData = ByteBuffer.allocateDirect(processDataSize);
+        offHeapProcessData.put(processData).flip();
+
+        for (int i = 0; i < EXPORTED_TRANSACTIONS; i++) {
+            seApi.startTransaction("Kasse-1", processData, "Kassenbeleg-V1", null, transactionNumber, logTime,
+                                   serialNumber, signatureCounter, signatureValue);
+            seApi.finishTransaction("Kasse-1", transactionNumber.getValue(), processData, "Kassenbeleg-V1", null,
+                                    logTime, signatureValue, signatureCounter);
+        }
+    }
+
+    @TearDown(Level.Trial)
+    public void close() throws IOException {
+        seApi.close();
+        try (Stream<Path> files = Files.walk(directory)) {
+            files.sorted(Comparator.reverseOrder()).forEach(path -> path.toFile().delete());
+        }
+    }
+
+    /**
+     * Start and finish of a transaction with the processData passed as byte array
+     */
+    @Benchmark
+    public long transactionByteArray() throws Exception {
+        seApi.startTransaction("Kasse-1", processData, "Kassenbeleg-V1", null, transactionNumber, logTime,
+                               serialNumber, signatureCounter, signatureValue);
+        seApi.finishTransaction("Kasse-1", transactionNumber.getValue(), processData, "Kassenbeleg-V1", null,
+                                logTime, signatureValue, signatureCounter);
+        return signatureCounter.getValue();
+    }
+
+    /**
+     * Start and finish of a transaction with the processData passed off-heap
+     */
+    @Benchmark
+    public long transactionOffHeap() throws Exception {
+        seApi.startTransaction("Kasse-1", offHeapProcessData, "Kassenbeleg-V1", transactionNumber, logTime,
+                               signatureCounter);
+        seApi.finishTransaction("Kasse-1", transactionNumber.getValue(), offHeapProcessData, "Kassenbeleg-V1",
+                                logTime, signatureCounter);
+        return signatureCounter.getValue();
+    }
+
+    /**
+     * Start and finish of a transaction through the status code functions of SEAPIStatus
+     */
+    @Benchmark
+    public long transactionStatus() {
+        seApi.startTransaction("Kasse-1", processData, "Kassenbeleg-V1", null, transactionResult);
+        seApi.finishTransaction("Kasse-1", transactionResult.getTransactionNumber(), processData, "Kassenbeleg-V1",
+                                null, transactionResult);
+        return transactionResult.getSignatureCounter();
+    }
+
+    /**
+     * Finish of an unknown transaction, reported by an exception of SEAPI
+     */
+    @Benchmark
+    public Object failedTransactionException() {
+        try {
+            seApi.finishTransaction("Kasse-1", -1L, processData, "Kassenbeleg-V1", null, logTime, signatureValue,
+                                    signatureCounter);
+            return null;
+        } catch (Exception e) {
+            return e;
+        }
+    }
+
+    /**
+     * Export of the last 100 transactions into a byte array
+     */
+    @Benchmark
+    public int exportByteArray() throws Exception {
+        long last = transactionNumber.getValue();
+        seApi.exportData(last - 99, last, 0, exportedData);
+        return exportedData.getValue().length;
+    }
+
+    /**
+     * Export of the last 100 transactions that is read in place
+     */
+    @Benchmark
+    public void exportOffHeap(Blackhole blackhole) throws Exception {
+        long last = transactionNumber.getValue();
+        seApi.exportData(last - 99, last, null, 0, archive);
+        try (NativeArchive held = archive) {
+            ByteBuffer data = held.getData();
+            blackhole.consume(data.get(data.limit() - 1));
+        }
+    }
+}
@@ -0,0 +1,247 @@
+package de.bsi.seapi.exceptions;
+
+/**
+ * This class defines one preallocated instance of each exception of the SE API. The instances are created without
+ * stack trace and without suppression, so that throwing them costs no more than a return. They are immutable and
+ * therefore shared by all threads. Implementations of SEAPI that report the status codes of an underlying status
+ * code API as exceptions throw these instances instead of creating a new exception per failure
+ */
+public final class PreallocatedExceptions {
+
+    /**
+     * Preallocated instance of ErrorRetrieveLogMessageFailed
+     */
+    public static final ErrorRetrieveLogMessageFailed RETRIEVE_LOG_MESSAGE_FAILED
+            = new ErrorRetrieveLogMessageFailed("ERROR_RETRIEVE_LOG_MESSAGE_FAILED (-5001)", null, false, false);
+
+    /**
+     * Preallocated instance of ErrorStorageFailure
+     */
+    public static final ErrorStorageFailure STORAGE_FAILURE
+            = new ErrorStorageFailure("ERROR_STORAGE_FAILURE (-5002)", null, false, false);
+
+    /**
+     * Preallocated instance of ErrorUpdateTimeFailed
+     */
+    public static final ErrorUpdateTimeFailed UPDATE_TIME_FAILED
+            = new ErrorUpdateTimeFailed("ERROR_UPDATE_TIME_FAILED (-5003)", null, false, false);
+
+    /**
+     * Preallocated instance of ErrorParameterMismatch
+     */
+    public static final ErrorParameterMismatch PARAMETER_MISMATCH
+            = new ErrorParameterMismatch("ERROR_PARAMETER_MISMATCH (-5004)", null, false, false);
+
+    /**
+     * Preallocated instance of ErrorIdNotFound
+     */
+    public static final ErrorIdNotFound ID_NOT_FOUND
+            = new ErrorIdNotFound("ERROR_ID_NOT_FOUND (-5005)", null, false, false);
+
+    /**
+     * Preallocated instance of ErrorTransactionNumberNotFound
+     */
+    public static final ErrorTransactionNumberNotFound TRANSACTION_NUMBER_NOT_FOUND
+            = new ErrorTransactionNumberNotFound("ERROR_TRANSACTION_NUMBER_NOT_FOUND (-5006)", null, false, false);
+
+    /**
+     * Preallocated instance of ErrorNoDataAvailable
+     */
+    public static final ErrorNoDataAvailable NO_DATA_AVAILABLE
+            = new ErrorNoDataAvailable("ERROR_NO_DATA_AVAILABLE (-5007)", null, false, false);
+
+    /**
+     * Preallocated instance of ErrorTooManyRecords
+     */
+    public static final ErrorTooManyRecords TOO_MANY_RECORDS
+            = new ErrorTooManyRecords("ERROR_TOO_MANY_RECORDS (-5008)", null, false, false);
+
+    /**
+     * Preallocated instance of ErrorStartTransactionFailed
+     */
+    public static final ErrorStartTransactionFailed START_TRANSACTION_FAILED
+            = new ErrorStartTransactionFailed("ERROR_START_TRANSACTION_FAILED (-5009)", null, false, false);
+
+    /**
+     * Preallocated instance of ErrorUpdateTransactionFailed
+     */
+    public static final ErrorUpdateTransactionFailed UPDATE_TRANSACTION_FAILED
+            = new ErrorUpdateTransactionFailed("ERROR_UPDATE_TRANSACTION_FAILED (-5010)", null, false, false);
+
+    /**
+     * Preallocated instance of ErrorFinishTransactionFailed
+     */
+    public static final ErrorFinishTransactionFailed FINISH_TRANSACTION_FAILED
+            = new ErrorFinishTransactionFailed("ERROR_FINISH_TRANSACTION_FAILED (-5011)", null, false, false);
+
+    /**
+     * Preallocated instance of ErrorRestoreFailed
+     */
+    public static final ErrorRestoreFailed RESTORE_FAILED
+            = new ErrorRestoreFailed("ERROR_RESTORE_FAILED (-5012)", null, false, false);
+
+    /**
+     * Preallocated instance of ErrorStoringInitDataFailed
+     */
+    public static final ErrorStoringInitDataFailed STORING_INIT_DATA_FAILED
+            = new ErrorStoringInitDataFailed("ERROR_STORING_INIT_DATA_FAILED (-5013)", null, false, false);
+
+    /**
+     * Preallocated instance of ErrorExportCertFailed
+     */
+    public static final ErrorExportCertFailed EXPORT_CERT_FAILED
+            = new ErrorExportCertFailed("ERROR_EXPORT_CERT_FAILED (-5014)", null, false, false);
+
+    /**
+     * Preallocated instance of ErrorNoLogMessage
+     */
+    public static final ErrorNoLogMessage NO_LOG_MESSAGE
+            = new ErrorNoLogMessage("ERROR_NO_LOG_MESSAGE (-5015)", null, false, false);
+
+    /**
+     * Preallocated instance of ErrorReadingLogMessage
+     */
+    public static final ErrorReadingLogMessage READING_LOG_MESSAGE
+            = new ErrorReadingLogMessage("ERROR_READING_LOG_MESSAGE (-5016)", null, false, false);
+
+    /**
+     * Preallocated instance of ErrorNoTransaction
+     */
+    public static final ErrorNoTransaction NO_TRANSACTION
+            = new ErrorNoTransaction("ERROR_NO_TRANSACTION (-5017)", null, false, false);
+
+    /**
+     * Preallocated instance of ErrorSeApiNotInitialized
+     */
+    public static final ErrorSeApiNotInitialized SE_API_NOT_INITIALIZED
+            = new ErrorSeApiNotInitialized("ERROR_SE_API_NOT_INITIALIZED (-5018)", null, false, false);
+
+    /**
+     * Preallocated instance of ErrorTimeNotSet
+     */
+    public static final ErrorTimeNotSet TIME_NOT_SET
+            = new ErrorTimeNotSet("ERROR_TIME_NOT_SET (-5019)", null, false, false);
+
+    /**
+     * Preallocated instance of ErrorCertificateExpired
+     */
+    public static final ErrorCertificateExpired CERTIFICATE_EXPIRED
+            = new ErrorCertificateExpired("ERROR_CERTIFICATE_EXPIRED (-5020)", null, false, false);
+
+    /**
+     * Preallocated instance of ErrorSecureElementDisabled
+     */
+    public static final ErrorSecureElementDisabled SECURE_ELEMENT_DISABLED
+            = new ErrorSecureElementDisabled("ERROR_SECURE_ELEMENT_DISABLED (-5021)", null, false, false);
+
+    /**
+     * Preallocated instance of ErrorUserNotAuthorized
+     */
+    public static final ErrorUserNotAuthorized USER_NOT_AUTHORIZED
+            = new ErrorUserNotAuthorized("ERROR_USER_NOT_AUTHORIZED (-5022)", null, false, false);
+
+    /**
+     * Preallocated instance of ErrorUserNotAuthenticated
+     */
+    public static final ErrorUserNotAuthenticated USER_NOT_AUTHENTICATED
+            = new ErrorUserNotAuthenticated("ERROR_USER_NOT_AUTHENTICATED (-5023)", null, false, false);
+
+    /**
+     * Preallocated instance of ErrorDescriptionNotSetByManufacturer
+     */
+    public static final ErrorDescriptionNotSetByManufacturer DESCRIPTION_NOT_SET_BY_MANUFACTURER
+            = new ErrorDescriptionNotSetByManufacturer("ERROR_DESCRIPTION_NOT_SET_BY_MANUFACTURER (-5024)", null, false, false);
+
+    /**
+     * Preallocated instance of ErrorDescriptionSetByManufacturer
+     */
+    public static final ErrorDescriptionSetByManufacturer DESCRIPTION_SET_BY_MANUFACTURER
+            = new ErrorDescriptionSetByManufacturer("ERROR_DESCRIPTION_SET_BY_MANUFACTURER (-5025)", null, false, false);
+
+    /**
+     * Preallocated instance of ErrorExportSerialNumbersFailed
+     */
+    public static final ErrorExportSerialNumbersFailed EXPORT_SERIAL_NUMBERS_FAILED
+            = new ErrorExportSerialNumbersFailed("ERROR_EXPORT_SERIAL_NUMBERS_FAILED (-5026)", null, false, false);
+
+    /**
+     * Preallocated instance of ErrorGetMaxNumberOfClientsFailed
+     */
+    public static final ErrorGetMaxNumberOfClientsFailed GET_MAX_NUMBER_OF_CLIENTS_FAILED
+            = new ErrorGetMaxNumberOfClientsFailed("ERROR_GET_MAX_NUMBER_OF_CLIENTS_FAILED (-5027)", null, false, false);
+
+    /**
+     * Preallocated instance of ErrorGetCurrentNumberOfClientsFailed
+     */
+    public static final ErrorGetCurrentNumberOfClientsFailed GET_CURRENT_NUMBER_OF_CLIENTS_FAILED
+            = new ErrorGetCurrentNumberOfClientsFailed("ERROR_GET_CURRENT_NUMBER_OF_CLIENTS_FAILED (-5028)", null, false, false);
+
+    /**
+     * Preallocated instance of ErrorGetMaxNumberTransactionsFailed
+     */
+    public static final ErrorGetMaxNumberTransactionsFailed GET_MAX_NUMBER_TRANSACTIONS_FAILED
+            = new ErrorGetMaxNumberTransactionsFailed("ERROR_GET_MAX_NUMBER_TRANSACTIONS_FAILED (-5039)", null, false, false);
+
+    /**
+     * Preallocated instance of ErrorGetCurrentNumberOfTransactionsFailed
+     */
+    public static final ErrorGetCurrentNumberOfTransactionsFailed GET_CURRENT_NUMBER_OF_TRANSACTIONS_FAILED
+            = new ErrorGetCurrentNumberOfTransactionsFailed("ERROR_GET_CURRENT_NUMBER_OF_TRANSACTIONS_FAILED (-5030)", null, false, false);
+
+    /**
+     * Preallocated instance of ErrorGetSupportedUpdateVariantsFailed
+     */
+    public static final ErrorGetSupportedUpdateVariantsFailed GET_SUPPORTED_UPDATE_VARIANTS_FAILED
+            = new ErrorGetSupportedUpdateVariantsFailed("ERROR_GET_SUPPORTED_UPDATE_VARIANTS_FAILED (-5031)", null, false, false);
+
+    /**
+     * Preallocated instance of ErrorDeleteStoredDataFailed
+     */
+    public static final ErrorDeleteStoredDataFailed DELETE_STORED_DATA_FAILED
+            = new ErrorDeleteStoredDataFailed("ERROR_DELETE_STORED_DATA_FAILED (-5032)", null, false, false);
+
+    /**
+     * Preallocated instance of ErrorUnexportedStoredData
+     */
+    public static final ErrorUnexportedStoredData UNEXPORTED_STORED_DATA
+            = new ErrorUnexportedStoredData("ERROR_UNEXPORTED_STORED_DATA (-5033)", null, false, false);
+
+    /**
+     * Preallocated instance of ErrorSigningSystemOperationDataFailed
+     */
+    public static final ErrorSigningSystemOperationDataFailed SIGNING_SYSTEM_OPERATION_DATA_FAILED
+            = new ErrorSigningSystemOperationDataFailed("ERROR_SIGNING_SYSTEM_OPERATION_DATA_FAILED (-5034)", null, false, false);
+
+    /**
+     * Preallocated instance of ErrorUserIdNotManaged
+     */
+    public static final ErrorUserIdNotManaged USER_ID_NOT_MANAGED
+            = new ErrorUserIdNotManaged("ERROR_USER_ID_NOT_MANAGED (-5035)", null, false, false);
+
+    /**
+     * Preallocated instance of ErrorUserIdNotAuthenticated
+     */
+    public static final ErrorUserIdNotAuthenticated USER_ID_NOT_AUTHENTICATED
+            = new ErrorUserIdNotAuthenticated("ERROR_USER_ID_NOT_AUTHENTICATED (-5036)", null, false, false);
+
+    /**
+     * Preallocated instance of ErrorDisableSecureElementFailed
+     */
+    public static final ErrorDisableSecureElementFailed DISABLE_SECURE_ELEMENT_FAILED
+            = new ErrorDisableSecureElementFailed("ERROR_DISABLE_SECURE_ELEMENT_FAILED (-5037)", null, false, false);
+
+    /**
+     * Preallocated instance of ErrorInvalidTime
+     */
+    public static final ErrorInvalidTime INVALID_TIME
+            = new ErrorInvalidTime("ERROR_INVALID_TIME (-5038)", null, false, false);
+
+    /**
+     * Preallocated instance of ErrorGetTimeSyncVariantFailed
+     */
+    public static final ErrorGetTimeSyncVariantFailed GET_TIME_SYNC_VARIANT_FAILED
+            = new ErrorGetTimeSyncVariantFailed("ERROR_GET_TIME_SYNC_VARIANT_FAILED (-5039)", null, false, false);
+
+    private PreallocatedExceptions() {
+    }
+}
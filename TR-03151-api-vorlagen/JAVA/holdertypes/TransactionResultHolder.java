@@ -0,0 +1,126 @@
+package de.bsi.seapi.holdertypes;
+
+import java.time.Instant;
+import java.time.ZoneOffset;
+import java.time.ZonedDateTime;
+
+/**
+ * This class defines a holder class that enables the specification of the output parameters of the transaction
+ * functions of SEAPIStatus in one object. The numeric values are held as primitives, so that a holder that is
+ * reused across calls does not allocate
+ */
+public final class TransactionResultHolder {
+
+    /**
+     * Encapsulated transaction number
+     */
+    private long transactionNumber;
+
+    /**
+     * Encapsulated signature counter
+     */
+    private long signatureCounter;
+
+    /**
+     * Encapsulated log time in seconds since the epoch
+     */
+    private long logTime;
+
+    /**
+     * Encapsulated serial number of the key
+     */
+    private byte[] serialNumber;
+
+    /**
+     * Encapsulated signature value
+     */
+    private byte[] signatureValue;
+
+    /**
+     * This function returns the encapsulated transaction number
+     * @return encapsulated transaction number
+     */
+    public long getTransactionNumber() {
+        return transactionNumber;
+    }
+
+    /**
+     * This function sets a new value for the encapsulated transaction number
+     * @param transactionNumber new value for the encapsulated transaction number
+     */
+    public void setTransactionNumber(long transactionNumber) {
+        this.transactionNumber = transactionNumber;
+    }
+
+    /**
+     * This function returns the encapsulated signature counter
+     * @return encapsulated signature counter
+     */
+    public long getSignatureCounter() {
+        return signatureCounter;
+    }
+
+    /**
+     * This function sets a new value for the encapsulated signature counter
+     * @param signatureCounter new value for the encapsulated signature counter
+     */
+    public void setSignatureCounter(long signatureCounter) {
+        this.signatureCounter = signatureCounter;
+    }
+
+    /**
+     * This function returns the encapsulated log time
+     * @return encapsulated log time in seconds since the epoch
+     */
+    public long getLogTime() {
+        return logTime;
+    }
+
+    /**
+     * This function returns the encapsulated log time as date and time in UTC
+     * @return encapsulated log time
+     */
+    public ZonedDateTime getLogDateTime() {
+        return ZonedDateTime.ofInstant(Instant.ofEpochSecond(logTime), ZoneOffset.UTC);
+    }
+
+    /**
+     * This function sets a new value for the encapsulated log time
+     * @param logTime new value for the encapsulated log time in seconds since the epoch
+     */
+    public void setLogTime(long logTime) {
+        this.logTime = logTime;
+    }
+
+    /**
+     * This function returns the encapsulated serial number
+     * @return encapsulated serial number
+     */
+    public byte[] getSerialNumber() {
+        return serialNumber;
+    }
+
+    /**
+     * This function sets a new value for the encapsulated serial number
+     * @param serialNumber new value for the encapsulated serial number
+     */
+    public void setSerialNumber(byte[] serialNumber) {
+        this.serialNumber = serialNumber;
+    }
+
+    /**
+     * This function returns the encapsulated signature value
+     * @return encapsulated signature value
+     */
+    public byte[] getSignatureValue() {
+        return signatureValue;
+    }
+
+    /**
+     * This function sets a new value for the encapsulated signature value
+     * @param signatureValue new value for the encapsulated signature value
+     */
+    public void setSignatureValue(byte[] signatureValue) {
+        this.signatureValue = signatureValue;
+    }
+}
@@ -0,0 +1,260 @@
+package de.bsi.seapi.nativebinding;
+
+import static java.lang.foreign.ValueLayout.ADDRESS;
+import static java.lang.foreign.ValueLayout.JAVA_INT;
+import static java.lang.foreign.ValueLayout.JAVA_LONG;
+import static java.lang.foreign.ValueLayout.JAVA_SHORT;
+
+import java.lang.foreign.Arena;
+import java.lang.foreign.FunctionDescriptor;
+import java.lang.foreign.Linker;
+import java.lang.foreign.MemoryLayout;
+import java.lang.foreign.MemorySegment;
+import java.lang.foreign.SymbolLookup;
+import java.lang.invoke.MethodHandle;
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+import java.nio.file.Path;
+
+import de.bsi.seapi.Constant;
+
+/**
+ * This class implements SeApiBackend by calling the functions of SeApiBinding.h through the Foreign Function &amp;
+ * Memory API (Java 22 or later). Direct buffers are passed to the backend as memory segments that refer to their
+ * off-heap memory, and exported archives are mapped as segments of the memory allocated by the backend.
+ */
+public final class FfmSeApiBackend implements SeApiBackend {
+
+    private static final Linker LINKER = Linker.nativeLinker();
+
+    private final Arena arena;
+    private final MemorySegment binding;
+    private final MethodHandle close;
+    private final MethodHandle updateTime;
+    private final MethodHandle logTransaction;
+    private final MethodHandle finishTransaction;
+    private final MethodHandle export;
+    private final MethodHandle freeExport;
+    private final MethodHandle readLogMessage;
+    private final MethodHandle authenticateUser;
+    private final MethodHandle logOut;
+    private final MethodHandle unblockUser;
+    private final MethodHandle deleteStoredData;
+    private final MethodHandle currentNumberOfTransactions;
+    private final NativeArchive.Release release = this::freeExport;
+
+    private FfmSeApiBackend(Arena arena, SymbolLookup lookup, Path directory) throws Throwable {
+        this.arena = arena;
+        MethodHandle open = handle(lookup, "seApiBindingOpen", ADDRESS, ADDRESS);
+        close = handle(lookup, "seApiBindingClose", ADDRESS);
+        updateTime = handle(lookup, "seApiBindingUpdateTime", ADDRESS, JAVA_LONG, ADDRESS);
+        logTransaction = handle(lookup, "seApiBindingLogTransaction", ADDRESS, JAVA_INT, ADDRESS, JAVA_LONG, JAVA_LONG,
+                                ADDRESS, JAVA_LONG, ADDRESS, JAVA_LONG, ADDRESS);
+        finishTransaction = handle(lookup, "seApiBindingFinishTransaction", ADDRESS, ADDRESS, JAVA_LONG, JAVA_LONG,
+                                   ADDRESS, JAVA_LONG, ADDRESS, JAVA_LONG, ADDRESS, JAVA_LONG, ADDRESS);
+        export = handle(lookup, "seApiBindingExport", ADDRESS, JAVA_INT, JAVA_LONG, JAVA_LONG, ADDRESS, JAVA_LONG,
+                        JAVA_LONG, ADDRESS);
+        freeExport = LINKER.downcallHandle(lookup.find("seApiBindingFreeExport").orElseThrow(),
+                                           FunctionDescriptor.ofVoid(ADDRESS));
+        readLogMessage = handle(lookup, "seApiBindingReadLogMessage", ADDRESS, ADDRESS, JAVA_LONG, JAVA_LONG, ADDRESS,
+                                JAVA_LONG, ADDRESS);
+        authenticateUser = handle(lookup, "seApiBindingAuthenticateUser", ADDRESS, ADDRESS, JAVA_LONG, ADDRESS,
+                                  JAVA_LONG, ADDRESS);
+        logOut = handle(lookup, "seApiBindingLogOut", ADDRESS, ADDRESS, JAVA_LONG);
+        unblockUser = handle(lookup, "seApiBindingUnblockUser", ADDRESS, ADDRESS, JAVA_LONG, ADDRESS, JAVA_LONG,
+                             ADDRESS, JAVA_LONG, ADDRESS);
+        deleteStoredData = handle(lookup, "seApiBindingDeleteStoredData", ADDRESS, ADDRESS, JAVA_LONG);
+        currentNumberOfTransactions = handle(lookup, "seApiBindingCurrentNumberOfTransactions", ADDRESS, ADDRESS);
+
+        MemorySegment results = arena.allocate(JAVA_LONG, RESULT_COUNT);
+        short result = (short) open.invokeExact(arena.allocateFrom(directory.toString()), results);
+        if (result != Constant.EXECUTION_OK) {
+            throw new IllegalStateException("seApiBindingOpen returned " + result);
+        }
+        binding = MemorySegment.ofAddress(results.getAtIndex(JAVA_LONG, 0));
+    }
+
+    /**
+     * This function opens the native backend
+     * @param library path of the shared library of the native backend
+     * @param directory directory of the stored data
+     * @return opened backend
+     * @throws IllegalStateException if the backend could not be opened
+     */
+    public static FfmSeApiBackend open(Path library, Path directory) {
+        Arena arena = Arena.ofShared();
+        try {
+            return new FfmSeApiBackend(arena, SymbolLookup.libraryLookup(library, arena), directory);
+        } catch (RuntimeException | Error e) {
+            arena.close();
+            throw e;
+        } catch (Throwable e) {
+            arena.close();
+            throw new IllegalStateException(e);
+        }
+    }
+
+    private static MethodHandle handle(SymbolLookup lookup, String name, MemoryLayout... arguments) {
+        return LINKER.downcallHandle(lookup.find(name).orElseThrow(), FunctionDescriptor.of(JAVA_SHORT, arguments));
+    }
+
+    /**
+     * Returns a segment of the content of a direct buffer between its position and its limit
+     */
+    private static MemorySegment segment(ByteBuffer buffer) {
+        if (buffer == null) {
+            return MemorySegment.NULL;
+        }
+        if (!buffer.isDirect()) {
+            throw new IllegalArgumentException("the SE API backend only accepts direct buffers");
+        }
+        return MemorySegment.ofBuffer(buffer);
+    }
+
+    private static long length(ByteBuffer buffer) {
+        return buffer != null ? buffer.remaining() : 0;
+    }
+
+    private static short rethrow(Throwable e) {
+        if (e instanceof RuntimeException) {
+            throw (RuntimeException) e;
+        }
+        if (e instanceof Error) {
+            throw (Error) e;
+        }
+        throw new IllegalStateException(e);
+    }
+
+    @Override
+    public short updateTime(long newTime, ByteBuffer results) {
+        try {
+            return (short) updateTime.invokeExact(binding, newTime, segment(results));
+        } catch (Throwable e) {
+            return rethrow(e);
+        }
+    }
+
+    @Override
+    public short logTransaction(int operation, ByteBuffer clientId, long transactionNumber, ByteBuffer processData,
+                                ByteBuffer processType, ByteBuffer results) {
+        try {
+            return (short) logTransaction.invokeExact(binding, operation, segment(clientId), length(clientId),
+                                                      transactionNumber, segment(processData), length(processData),
+                                                      segment(processType), length(processType), segment(results));
+        } catch (Throwable e) {
+            return rethrow(e);
+        }
+    }
+
+    @Override
+    public short finishTransaction(ByteBuffer clientId, long transactionNumber, ByteBuffer processData,
+                                   ByteBuffer processType, ByteBuffer receiptCode, ByteBuffer results) {
+        try {
+            return (short) finishTransaction.invokeExact(binding, segment(clientId), length(clientId),
+                                                         transactionNumber, segment(processData), length(processData),
+                                                         segment(processType), length(processType),
+                                                         segment(receiptCode), length(receiptCode), segment(results));
+        } catch (Throwable e) {
+            return rethrow(e);
+        }
+    }
+
+    @Override
+    public short exportData(int filter, long start, long end, ByteBuffer clientId, long maximumNumberRecords,
+                            NativeArchive archive) {
+        try (Arena call = Arena.ofConfined()) {
+            MemorySegment results = call.allocate(JAVA_LONG, RESULT_COUNT);
+            short result = (short) export.invokeExact(binding, filter, start, end, segment(clientId), length(clientId),
+                                                      maximumNumberRecords, results);
+            if (result == Constant.EXECUTION_OK) {
+                long address = results.getAtIndex(JAVA_LONG, 0);
+                ByteBuffer data = MemorySegment.ofAddress(address).reinterpret(results.getAtIndex(JAVA_LONG, 1))
+                                               .asByteBuffer().order(ByteOrder.BIG_ENDIAN);
+                archive.set(data, address, release);
+            }
+            return result;
+        } catch (Throwable e) {
+            return rethrow(e);
+        }
+    }
+
+    private void freeExport(long address) {
+        try {
+            freeExport.invokeExact(MemorySegment.ofAddress(address));
+        } catch (Throwable e) {
+            rethrow(e);
+        }
+    }
+
+    @Override
+    public short readLogMessage(ByteBuffer clientId, long transactionNumber, ByteBuffer logMessage,
+                                ByteBuffer results) {
+        try {
+            return (short) readLogMessage.invokeExact(binding, segment(clientId), length(clientId), transactionNumber,
+                                                      segment(logMessage), length(logMessage), segment(results));
+        } catch (Throwable e) {
+            return rethrow(e);
+        }
+    }
+
+    @Override
+    public short authenticateUser(ByteBuffer userId, ByteBuffer pin, ByteBuffer results) {
+        try {
+            return (short) authenticateUser.invokeExact(binding, segment(userId), length(userId), segment(pin),
+                                                        length(pin), segment(results));
+        } catch (Throwable e) {
+            return rethrow(e);
+        }
+    }
+
+    @Override
+    public short logOut(ByteBuffer userId) {
+        try {
+            return (short) logOut.invokeExact(binding, segment(userId), length(userId));
+        } catch (Throwable e) {
+            return rethrow(e);
+        }
+    }
+
+    @Override
+    public short unblockUser(ByteBuffer userId, ByteBuffer puk, ByteBuffer newPin, ByteBuffer results) {
+        try {
+            return (short) unblockUser.invokeExact(binding, segment(userId), length(userId), segment(puk), length(puk),
+                                                   segment(newPin), length(newPin), segment(results));
+        } catch (Throwable e) {
+            return rethrow(e);
+        }
+    }
+
+    @Override
+    public short deleteStoredData(ByteBuffer userId) {
+        try {
+            return (short) deleteStoredData.invokeExact(binding, segment(userId), length(userId));
+        } catch (Throwable e) {
+            return rethrow(e);
+        }
+    }
+
+    @Override
+    public short getCurrentNumberOfTransactions(ByteBuffer results) {
+        try {
+            return (short) currentNumberOfTransactions.invokeExact(binding, segment(results));
+        } catch (Throwable e) {
+            return rethrow(e);
+        }
+    }
+
+    @Override
+    public void close() {
+        try {
+            short result = (short) close.invokeExact(binding);
+            if (result != Constant.EXECUTION_OK) {
+                throw new IllegalStateException("seApiBindingClose returned " + result);
+            }
+        } catch (Throwable e) {
+            rethrow(e);
+        } finally {
+            arena.close();
+        }
+    }
+}
@@ -0,0 +1,424 @@
+package de.bsi.seapi.nativebinding;
+
+import java.io.ByteArrayOutputStream;
+import java.io.IOException;
+import java.io.UncheckedIOException;
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+import java.nio.MappedByteBuffer;
+import java.nio.channels.FileChannel;
+import java.nio.charset.StandardCharsets;
+import java.nio.file.Path;
+import java.nio.file.StandardOpenOption;
+import java.time.Instant;
+import java.time.ZoneOffset;
+import java.time.format.DateTimeFormatter;
+import java.util.Arrays;
+import java.util.HashMap;
+import java.util.Map;
+
+import de.bsi.seapi.Constant;
+import de.bsi.seapi.ErrorCodes;
+
+/**
+ * This class implements SeApiBackend in Java without the native backend. The log messages are appended to a single
+ * file by a FileChannel and exports read the complete file, comparable to a plain Java implementation of the SE API.
+ * It serves as comparison for the native backend and as fallback where the shared library is not available.
+ * Users are not managed, so that authenticateUser reports unknown users and deleteStoredData is not authorized.
+ *
+ * Each log message is stored as length (4 bytes), signature counter, transaction number, log time (8 bytes each),
+ * type, operation (1 byte each), length of the clientId (2 bytes), clientId and payload.
+ */
+public final class JavaSeApiBackend implements SeApiBackend {
+
+    private static final String LOG_FILE_NAME = "javalog.dat";
+    private static final int HEADER_SIZE = 4 + 8 + 8 + 8 + 1 + 1 + 2;
+    private static final byte TRANSACTION_LOG_MESSAGE = 0;
+    private static final byte SYSTEM_LOG_MESSAGE = 1;
+    private static final int MAX_CLIENT_ID_LENGTH = 128;
+    private static final int MAX_PROCESS_TYPE_LENGTH = 100;
+    private static final String[] OPERATIONS = { "", "Start", "Update", "Finish" };
+
+    /**
+     * Values of the authentication and unblock results that correspond to an unknown user
+     */
+    private static final long UNKNOWN_USER = 3;
+
+    private final FileChannel channel;
+    private final Map<Long, Long> openTransactions = new HashMap<>();
+    private ByteBuffer record = ByteBuffer.allocateDirect(4096).order(ByteOrder.BIG_ENDIAN);
+    private long signatureCounter;
+    private long transactionNumber;
+    private long timeOffset;
+    private boolean timeSet;
+
+    private JavaSeApiBackend(FileChannel channel) throws IOException {
+        this.channel = channel;
+        long size = channel.size();
+        if (size == 0) {
+            return;
+        }
+        MappedByteBuffer log = channel.map(FileChannel.MapMode.READ_ONLY, 0, size);
+        while (log.remaining() >= HEADER_SIZE) {
+            int start = log.position();
+            int length = log.getInt(start);
+            if (length < HEADER_SIZE || length > log.remaining()) {
+                break;
+            }
+            signatureCounter = log.getLong(start + 4);
+            long number = log.getLong(start + 12);
+            byte operation = log.get(start + 29);
+            if (log.get(start + 28) == TRANSACTION_LOG_MESSAGE) {
+                transactionNumber = Math.max(transactionNumber, number);
+                if (operation == FINISH) {
+                    openTransactions.remove(number);
+                } else {
+                    openTransactions.putIfAbsent(number, log.getLong(start + 20));
+                }
+            }
+            log.position(start + length);
+        }
+        /* a partially written log message at the end is discarded */
+        channel.truncate(log.position());
+        channel.position(log.position());
+    }
+
+    /**
+     * This function opens the Java backend
+     * @param directory directory of the stored data
+     * @return opened backend
+     * @throws UncheckedIOException if the log file could not be opened
+     */
+    public static JavaSeApiBackend open(Path directory) {
+        FileChannel channel = null;
+        try {
+            channel = FileChannel.open(directory.resolve(LOG_FILE_NAME), StandardOpenOption.CREATE,
+                                       StandardOpenOption.READ, StandardOpenOption.WRITE);
+            return new JavaSeApiBackend(channel);
+        } catch (IOException e) {
+            if (channel != null) {
+                try {
+                    channel.close();
+                } catch (IOException suppressed) {
+                    e.addSuppressed(suppressed);
+                }
+            }
+            throw new UncheckedIOException(e);
+        }
+    }
+
+    private static int length(ByteBuffer buffer) {
+        return buffer != null ? buffer.remaining() : 0;
+    }
+
+    private long now() {
+        return System.currentTimeMillis() / 1000 + timeOffset;
+    }
+
+    private short append(byte type, int operation, long number, long logTime, ByteBuffer clientId,
+                         ByteBuffer processType, ByteBuffer processData, ByteBuffer results) {
+        int length = HEADER_SIZE + length(clientId) + 1 + length(processType) + length(processData);
+        if (record.capacity() < length) {
+            record = ByteBuffer.allocateDirect(Math.max(length, record.capacity() * 2)).order(ByteOrder.BIG_ENDIAN);
+        }
+        record.clear();
+        record.putInt(length).putLong(signatureCounter + 1).putLong(number).putLong(logTime).put(type)
+              .put((byte) operation).putShort((short) length(clientId));
+        if (clientId != null) {
+            record.put(clientId.duplicate());
+        }
+        record.put((byte) length(processType));
+        if (processType != null) {
+            record.put(processType.duplicate());
+        }
+        if (processData != null) {
+            record.put(processData.duplicate());
+        }
+        record.flip();
+        try {
+            while (record.hasRemaining()) {
+                channel.write(record);
+            }
+        } catch (IOException e) {
+            return ErrorCodes.ERROR_STORAGE_FAILURE;
+        }
+        signatureCounter++;
+        results.putLong(TRANSACTION_NUMBER * Long.BYTES, number);
+        results.putLong(SIGNATURE_COUNTER * Long.BYTES, signatureCounter);
+        results.putLong(LOG_TIME * Long.BYTES, logTime);
+        return Constant.EXECUTION_OK;
+    }
+
+    @Override
+    public synchronized short updateTime(long newTime, ByteBuffer results) {
+        if (newTime <= 0) {
+            return ErrorCodes.ERROR_INVALID_TIME;
+        }
+        ByteBuffer payload = ByteBuffer.wrap("updateTime".getBytes(StandardCharsets.US_ASCII));
+        short result = append(SYSTEM_LOG_MESSAGE, 0, 0, newTime, null, null, payload, results);
+        if (result == Constant.EXECUTION_OK) {
+            timeOffset = newTime - System.currentTimeMillis() / 1000;
+            timeSet = true;
+        }
+        return result;
+    }
+
+    @Override
+    public synchronized short logTransaction(int operation, ByteBuffer clientId, long transactionNumber,
+                                             ByteBuffer processData, ByteBuffer processType, ByteBuffer results) {
+        if (operation < START || operation > FINISH || length(clientId) == 0
+            || length(clientId) > MAX_CLIENT_ID_LENGTH || length(processType) > MAX_PROCESS_TYPE_LENGTH) {
+            return ErrorCodes.ERROR_PARAMETER_MISMATCH;
+        }
+        if (!timeSet) {
+            return ErrorCodes.ERROR_TIME_NOT_SET;
+        }
+        long number = operation == START ? this.transactionNumber + 1 : transactionNumber;
+        if (operation != START && !openTransactions.containsKey(number)) {
+            return ErrorCodes.ERROR_NO_TRANSACTION;
+        }
+        short result = append(TRANSACTION_LOG_MESSAGE, operation, number, now(), clientId, processType, processData,
+                              results);
+        if (result == Constant.EXECUTION_OK) {
+            if (operation == START) {
+                this.transactionNumber = number;
+                openTransactions.put(number, results.getLong(LOG_TIME * Long.BYTES));
+            } else if (operation == FINISH) {
+                openTransactions.remove(number);
+            }
+        }
+        return result;
+    }
+
+    @Override
+    public synchronized short finishTransaction(ByteBuffer clientId, long transactionNumber, ByteBuffer processData,
+                                                ByteBuffer processType, ByteBuffer receiptCode, ByteBuffer results) {
+        Long startTime = openTransactions.get(transactionNumber);
+        short result = logTransaction(FINISH, clientId, transactionNumber, processData, processType, results);
+        if (result != Constant.EXECUTION_OK) {
+            return result;
+        }
+        /* the Java backend does not sign, so that the signature algorithm, the signature and the key are empty */
+        DateTimeFormatter utcTime = DateTimeFormatter.ofPattern("uuuu-MM-dd'T'HH:mm:ss'.000Z'")
+                                                     .withZone(ZoneOffset.UTC);
+        ByteArrayOutputStream code = new ByteArrayOutputStream();
+        code.writeBytes("V0;".getBytes(StandardCharsets.US_ASCII));
+        for (ByteBuffer field : new ByteBuffer[] { clientId, processType, processData }) {
+            if (field != null) {
+                ByteBuffer content = field.duplicate();
+                while (content.hasRemaining()) {
+                    code.write(content.get());
+                }
+            }
+            code.write(';');
+        }
+        String numbers = transactionNumber + ";" + results.getLong(SIGNATURE_COUNTER * Long.BYTES) + ";"
+                         + utcTime.format(Instant.ofEpochSecond(startTime)) + ";"
+                         + utcTime.format(Instant.ofEpochSecond(results.getLong(LOG_TIME * Long.BYTES)))
+                         + ";;utcTime;;";
+        code.writeBytes(numbers.getBytes(StandardCharsets.US_ASCII));
+        results.putLong(RECEIPT_CODE_LENGTH * Long.BYTES, code.size());
+        if (receiptCode != null && code.size() <= receiptCode.remaining()) {
+            receiptCode.duplicate().put(code.toByteArray());
+        }
+        return result;
+    }
+
+    @Override
+    public synchronized short exportData(int filter, long start, long end, ByteBuffer clientId,
+                                         long maximumNumberRecords, NativeArchive archive) {
+        if (maximumNumberRecords < 0 || (filter == EXPORT_TRANSACTIONS && start > end)
+            || (filter == EXPORT_PERIOD && ((start == NO_START_TIME && end == NO_END_TIME) || start > end))
+            || filter < EXPORT_ALL || filter > EXPORT_PERIOD) {
+            return ErrorCodes.ERROR_PARAMETER_MISMATCH;
+        }
+        ByteArrayOutputStream tar = new ByteArrayOutputStream();
+        long selected = 0;
+        long clientSelected = 0;
+        try {
+            MappedByteBuffer log = channel.map(FileChannel.MapMode.READ_ONLY, 0, channel.position());
+            while (log.hasRemaining()) {
+                int position = log.position();
+                int length = log.getInt(position);
+                long number = log.getLong(position + 12);
+                long logTime = log.getLong(position + 20);
+                byte type = log.get(position + 28);
+                int clientIdLength = log.getShort(position + 30);
+                ByteBuffer recordClientId = log.duplicate().position(position + HEADER_SIZE)
+                                               .limit(position + HEADER_SIZE + clientIdLength);
+                log.position(position + length);
+
+                boolean inRange = filter == EXPORT_ALL
+                                  || (filter == EXPORT_TRANSACTIONS && type == TRANSACTION_LOG_MESSAGE
+                                      && number >= start && number <= end)
+                                  || (filter == EXPORT_PERIOD && logTime >= start && logTime <= end);
+                if (!inRange) {
+                    continue;
+                }
+                selected++;
+                if (clientId != null && (type != TRANSACTION_LOG_MESSAGE || !recordClientId.equals(clientId))) {
+                    continue;
+                }
+                clientSelected++;
+                if (maximumNumberRecords > 0 && clientSelected > maximumNumberRecords) {
+                    return ErrorCodes.ERROR_TOO_MANY_RECORDS;
+                }
+                ByteBuffer entry = log.duplicate().position(position).limit(position + length);
+                addEntry(tar, name(entry), entry.position(position + HEADER_SIZE + clientIdLength), logTime);
+            }
+        } catch (IOException e) {
+            return ErrorCodes.ERROR_STORAGE_FAILURE;
+        }
+        if (filter != EXPORT_ALL && clientSelected == 0) {
+            if (clientId != null && selected > 0) {
+                return ErrorCodes.ERROR_ID_NOT_FOUND;
+            }
+            return filter == EXPORT_TRANSACTIONS ? ErrorCodes.ERROR_TRANSACTION_NUMBER_NOT_FOUND
+                                                 : ErrorCodes.ERROR_NO_DATA_AVAILABLE;
+        }
+        tar.write(new byte[2 * 512], 0, 2 * 512);
+        ByteBuffer data = ByteBuffer.allocateDirect(tar.size());
+        data.put(tar.toByteArray()).flip();
+        archive.set(data, 0, null);
+        return Constant.EXECUTION_OK;
+    }
+
+    /**
+     * Returns the file name of a log message within the archive, following the names of the native backend
+     */
+    private static String name(ByteBuffer entry) {
+        int position = entry.position();
+        long logTime = entry.getLong(position + 20);
+        long signature = entry.getLong(position + 4);
+        if (entry.get(position + 28) != TRANSACTION_LOG_MESSAGE) {
+            return "Unixt_" + logTime + "_Sig-" + signature + "_Log-Sys.log";
+        }
+        StringBuilder clientId = new StringBuilder();
+        for (int i = 0; i < entry.getShort(position + 30); i++) {
+            int c = entry.get(position + HEADER_SIZE + i) & 0xFF;
+            clientId.append(c > 0x20 && c < 0x7F && c != '/' ? (char) c : '_');
+        }
+        return "Unixt_" + logTime + "_Sig-" + signature + "_Log-Tra_No-" + entry.getLong(position + 12) + "_"
+               + OPERATIONS[entry.get(position + 29)] + "_Client-" + clientId + ".log";
+    }
+
+    /**
+     * Appends a file with a ustar header to the archive
+     */
+    private static void addEntry(ByteArrayOutputStream tar, String name, ByteBuffer content, long modificationTime) {
+        byte[] header = new byte[512];
+        byte[] nameBytes = name.getBytes(StandardCharsets.US_ASCII);
+        System.arraycopy(nameBytes, 0, header, 0, Math.min(nameBytes.length, 99));
+        octal(header, 100, 8, 0644);
+        octal(header, 108, 8, 0);
+        octal(header, 116, 8, 0);
+        octal(header, 124, 12, content.remaining());
+        octal(header, 136, 12, modificationTime);
+        header[156] = '0';
+        System.arraycopy("ustar\0".getBytes(StandardCharsets.US_ASCII), 0, header, 257, 6);
+        header[263] = '0';
+        header[264] = '0';
+        Arrays.fill(header, 148, 156, (byte) ' ');
+        int checksum = 0;
+        for (byte b : header) {
+            checksum += b & 0xFF;
+        }
+        octal(header, 148, 7, checksum);
+        tar.write(header, 0, header.length);
+
+        byte[] bytes = new byte[content.remaining()];
+        content.get(bytes);
+        tar.write(bytes, 0, bytes.length);
+        int padding = (512 - bytes.length % 512) % 512;
+        tar.write(new byte[padding], 0, padding);
+    }
+
+    private static void octal(byte[] header, int offset, int size, long value) {
+        header[offset + size - 1] = 0;
+        for (int i = size - 2; i >= 0; i--) {
+            header[offset + i] = (byte) ('0' + (value & 7));
+            value >>>= 3;
+        }
+    }
+
+    @Override
+    public synchronized short readLogMessage(ByteBuffer clientId, long transactionNumber, ByteBuffer logMessage,
+                                             ByteBuffer results) {
+        if (length(clientId) > MAX_CLIENT_ID_LENGTH) {
+            return ErrorCodes.ERROR_PARAMETER_MISMATCH;
+        }
+        int found = -1;
+        MappedByteBuffer log;
+        try {
+            log = channel.map(FileChannel.MapMode.READ_ONLY, 0, channel.position());
+        } catch (IOException e) {
+            return ErrorCodes.ERROR_READING_LOG_MESSAGE;
+        }
+        /* the log file is read from the start, the last matching log message is returned */
+        while (log.hasRemaining()) {
+            int position = log.position();
+            int clientIdLength = log.getShort(position + 30);
+            ByteBuffer recordClientId = log.duplicate().position(position + HEADER_SIZE)
+                                           .limit(position + HEADER_SIZE + clientIdLength);
+            if (clientId == null || (log.get(position + 28) == TRANSACTION_LOG_MESSAGE
+                                     && recordClientId.equals(clientId)
+                                     && (transactionNumber == 0 || log.getLong(position + 12) == transactionNumber))) {
+                found = position;
+            }
+            log.position(position + log.getInt(position));
+        }
+        if (found < 0) {
+            return ErrorCodes.ERROR_NO_LOG_MESSAGE;
+        }
+        int payload = found + HEADER_SIZE + log.getShort(found + 30);
+        int payloadLength = found + log.getInt(found) - payload;
+        results.putLong(TRANSACTION_NUMBER * Long.BYTES, log.getLong(found + 12));
+        results.putLong(SIGNATURE_COUNTER * Long.BYTES, log.getLong(found + 4));
+        results.putLong(LOG_TIME * Long.BYTES, log.getLong(found + 20));
+        results.putLong(LOG_MESSAGE_LENGTH * Long.BYTES, payloadLength);
+        if (payloadLength > logMessage.remaining()) {
+            return ErrorCodes.ERROR_PARAMETER_MISMATCH;
+        }
+        logMessage.duplicate().put(log.duplicate().position(payload).limit(payload + payloadLength));
+        return Constant.EXECUTION_OK;
+    }
+
+    @Override
+    public short authenticateUser(ByteBuffer userId, ByteBuffer pin, ByteBuffer results) {
+        results.putLong(RESULT * Long.BYTES, UNKNOWN_USER);
+        results.putLong(REMAINING_RETRIES * Long.BYTES, 0);
+        return Constant.AUTHENTICATION_FAILED;
+    }
+
+    @Override
+    public short logOut(ByteBuffer userId) {
+        return ErrorCodes.ERROR_USER_ID_NOT_MANAGED;
+    }
+
+    @Override
+    public short unblockUser(ByteBuffer userId, ByteBuffer puk, ByteBuffer newPin, ByteBuffer results) {
+        results.putLong(RESULT * Long.BYTES, UNKNOWN_USER);
+        return Constant.UNBLOCK_FAILED;
+    }
+
+    @Override
+    public short deleteStoredData(ByteBuffer userId) {
+        return ErrorCodes.ERROR_USER_NOT_AUTHENTICATED;
+    }
+
+    @Override
+    public synchronized short getCurrentNumberOfTransactions(ByteBuffer results) {
+        results.putLong(0, openTransactions.size());
+        return Constant.EXECUTION_OK;
+    }
+
+    @Override
+    public synchronized void close() {
+        try {
+            channel.force(false);
+            channel.close();
+        } catch (IOException e) {
+            throw new UncheckedIOException(e);
+        }
+    }
+}
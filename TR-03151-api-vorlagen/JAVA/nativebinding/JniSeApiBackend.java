@@ -0,0 +1,184 @@
+package de.bsi.seapi.nativebinding;
+
+import java.nio.ByteBuffer;
+import java.nio.charset.StandardCharsets;
+import java.nio.file.Path;
+
+import de.bsi.seapi.Constant;
+
+/**
+ * This class implements SeApiBackend by calling the functions of SeApiBinding.h through JNI. It is used on Java
+ * versions without the Foreign Function &amp; Memory API. The shared library has to contain the backend and the JNI
+ * functions of native/SeApiBindingJni.c. Direct buffers are read in place by means of GetDirectBufferAddress and
+ * exported archives are wrapped by NewDirectByteBuffer, so that the data is not copied either.
+ */
+public final class JniSeApiBackend implements SeApiBackend {
+
+    private final long binding;
+    private final NativeArchive.Release release = JniSeApiBackend::nativeFreeExport;
+
+    private JniSeApiBackend(long binding) {
+        this.binding = binding;
+    }
+
+    /**
+     * This function opens the native backend
+     * @param library path of the shared library of the native backend
+     * @param directory directory of the stored data
+     * @return opened backend
+     * @throws IllegalStateException if the backend could not be opened
+     */
+    public static JniSeApiBackend open(Path library, Path directory) {
+        System.load(library.toAbsolutePath().toString());
+        ByteBuffer results = NativeBuffers.results();
+        short result = nativeOpen(directory.toString().getBytes(StandardCharsets.UTF_8), results);
+        if (result != Constant.EXECUTION_OK) {
+            throw new IllegalStateException("seApiBindingOpen returned " + result);
+        }
+        return new JniSeApiBackend(results.getLong(0));
+    }
+
+    private static ByteBuffer direct(ByteBuffer buffer) {
+        if (buffer != null && !buffer.isDirect()) {
+            throw new IllegalArgumentException("the SE API backend only accepts direct buffers");
+        }
+        return buffer;
+    }
+
+    private static int position(ByteBuffer buffer) {
+        return buffer != null ? buffer.position() : 0;
+    }
+
+    private static int length(ByteBuffer buffer) {
+        return buffer != null ? buffer.remaining() : 0;
+    }
+
+    @Override
+    public short updateTime(long newTime, ByteBuffer results) {
+        return nativeUpdateTime(binding, newTime, direct(results));
+    }
+
+    @Override
+    public short logTransaction(int operation, ByteBuffer clientId, long transactionNumber, ByteBuffer processData,
+                                ByteBuffer processType, ByteBuffer results) {
+        return nativeLogTransaction(binding, operation, direct(clientId), position(clientId), length(clientId),
+                                    transactionNumber, direct(processData), position(processData),
+                                    length(processData), direct(processType), position(processType),
+                                    length(processType), direct(results));
+    }
+
+    @Override
+    public short finishTransaction(ByteBuffer clientId, long transactionNumber, ByteBuffer processData,
+                                   ByteBuffer processType, ByteBuffer receiptCode, ByteBuffer results) {
+        return nativeFinishTransaction(binding, direct(clientId), position(clientId), length(clientId),
+                                       transactionNumber, direct(processData), position(processData),
+                                       length(processData), direct(processType), position(processType),
+                                       length(processType), direct(receiptCode), position(receiptCode),
+                                       length(receiptCode), direct(results));
+    }
+
+    @Override
+    public short exportData(int filter, long start, long end, ByteBuffer clientId, long maximumNumberRecords,
+                            NativeArchive archive) {
+        ByteBuffer results = NativeBuffers.results();
+        short result = nativeExport(binding, filter, start, end, direct(clientId), position(clientId),
+                                    length(clientId), maximumNumberRecords, results);
+        if (result == Constant.EXECUTION_OK) {
+            long address = results.getLong(0);
+            archive.set(nativeWrap(address, results.getLong(8)), address, release);
+        }
+        return result;
+    }
+
+    @Override
+    public short readLogMessage(ByteBuffer clientId, long transactionNumber, ByteBuffer logMessage,
+                                ByteBuffer results) {
+        return nativeReadLogMessage(binding, direct(clientId), position(clientId), length(clientId), transactionNumber,
+                                    direct(logMessage), position(logMessage), length(logMessage), direct(results));
+    }
+
+    @Override
+    public short authenticateUser(ByteBuffer userId, ByteBuffer pin, ByteBuffer results) {
+        return nativeAuthenticateUser(binding, direct(userId), position(userId), length(userId), direct(pin),
+                                      position(pin), length(pin), direct(results));
+    }
+
+    @Override
+    public short logOut(ByteBuffer userId) {
+        return nativeLogOut(binding, direct(userId), position(userId), length(userId));
+    }
+
+    @Override
+    public short unblockUser(ByteBuffer userId, ByteBuffer puk, ByteBuffer newPin, ByteBuffer results) {
+        return nativeUnblockUser(binding, direct(userId), position(userId), length(userId), direct(puk), position(puk),
+                                 length(puk), direct(newPin), position(newPin), length(newPin), direct(results));
+    }
+
+    @Override
+    public short deleteStoredData(ByteBuffer userId) {
+        return nativeDeleteStoredData(binding, direct(userId), position(userId), length(userId));
+    }
+
+    @Override
+    public short getCurrentNumberOfTransactions(ByteBuffer results) {
+        return nativeCurrentNumberOfTransactions(binding, direct(results));
+    }
+
+    @Override
+    public void close() {
+        short result = nativeClose(binding);
+        if (result != Constant.EXECUTION_OK) {
+            throw new IllegalStateException("seApiBindingClose returned " + result);
+        }
+    }
+
+    private static native short nativeOpen(byte[] directory, ByteBuffer results);
+
+    private static native short nativeClose(long binding);
+
+    private static native short nativeUpdateTime(long binding, long newTime, ByteBuffer results);
+
+    private static native short nativeLogTransaction(long binding, int operation, ByteBuffer clientId,
+                                                     int clientIdPosition, int clientIdLength, long transactionNumber,
+                                                     ByteBuffer processData, int processDataPosition,
+                                                     int processDataLength, ByteBuffer processType,
+                                                     int processTypePosition, int processTypeLength,
+                                                     ByteBuffer results);
+
+    private static native short nativeFinishTransaction(long binding, ByteBuffer clientId, int clientIdPosition,
+                                                        int clientIdLength, long transactionNumber,
+                                                        ByteBuffer processData, int processDataPosition,
+                                                        int processDataLength, ByteBuffer processType,
+                                                        int processTypePosition, int processTypeLength,
+                                                        ByteBuffer receiptCode, int receiptCodePosition,
+                                                        int receiptCodeCapacity, ByteBuffer results);
+
+    private static native short nativeExport(long binding, int filter, long start, long end, ByteBuffer clientId,
+                                             int clientIdPosition, int clientIdLength, long maximumNumberRecords,
+                                             ByteBuffer results);
+
+    private static native ByteBuffer nativeWrap(long address, long length);
+
+    private static native void nativeFreeExport(long address);
+
+    private static native short nativeReadLogMessage(long binding, ByteBuffer clientId, int clientIdPosition,
+                                                     int clientIdLength, long transactionNumber,
+                                                     ByteBuffer logMessage, int logMessagePosition,
+                                                     int logMessageCapacity, ByteBuffer results);
+
+    private static native short nativeAuthenticateUser(long binding, ByteBuffer userId, int userIdPosition,
+                                                       int userIdLength, ByteBuffer pin, int pinPosition,
+                                                       int pinLength, ByteBuffer results);
+
+    private static native short nativeLogOut(long binding, ByteBuffer userId, int userIdPosition, int userIdLength);
+
+    private static native short nativeUnblockUser(long binding, ByteBuffer userId, int userIdPosition,
+                                                  int userIdLength, ByteBuffer puk, int pukPosition, int pukLength,
+                                                  ByteBuffer newPin, int newPinPosition, int newPinLength,
+                                                  ByteBuffer results);
+
+    private static native short nativeDeleteStoredData(long binding, ByteBuffer userId, int userIdPosition,
+                                                       int userIdLength);
+
+    private static native short nativeCurrentNumberOfTransactions(long binding, ByteBuffer results);
+}
@@ -0,0 +1,64 @@
+package de.bsi.seapi.nativebinding;
+
+import java.nio.ByteBuffer;
+
+/**
+ * This class holds a TAR archive that has been exported by a SeApiBackend. The archive is kept in the memory of
+ * the backend and exposed as read-only direct ByteBuffer, so that it can be written to a channel without being
+ * copied to the Java heap. The memory is released by close, after which the buffer MUST NOT be used anymore.
+ * An instance can be reused for further exports after it has been closed.
+ */
+public final class NativeArchive implements AutoCloseable {
+
+    /**
+     * Releases the memory of an archive
+     */
+    interface Release {
+        void release(long address);
+    }
+
+    private ByteBuffer data;
+    private long address;
+    private Release release;
+
+    /**
+     * This function returns the exported archive
+     * @return read-only buffer of the archive or null if no archive is held
+     */
+    public ByteBuffer getData() {
+        return data;
+    }
+
+    /**
+     * This function copies the archive to the Java heap
+     * @return content of the archive or null if no archive is held
+     */
+    public byte[] toByteArray() {
+        if (data == null) {
+            return null;
+        }
+        byte[] copy = new byte[data.remaining()];
+        data.duplicate().get(copy);
+        return copy;
+    }
+
+    void set(ByteBuffer data, long address, Release release) {
+        close();
+        this.data = data.asReadOnlyBuffer();
+        this.address = address;
+        this.release = release;
+    }
+
+    /**
+     * This function releases the memory of the archive
+     */
+    @Override
+    public void close() {
+        if (release != null) {
+            release.release(address);
+        }
+        data = null;
+        address = 0;
+        release = null;
+    }
+}
@@ -0,0 +1,124 @@
+package de.bsi.seapi.nativebinding;
+
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+import java.nio.CharBuffer;
+import java.nio.charset.CharsetEncoder;
+import java.nio.charset.CoderResult;
+import java.nio.charset.StandardCharsets;
+
+import de.bsi.seapi.holdertypes.TransactionResultHolder;
+
+/**
+ * This class holds the direct buffers that a thread reuses for the calls of a SeApiBackend, so that byte arrays
+ * and strings are copied once into off-heap memory and no buffers are allocated per call.
+ */
+final class NativeBuffers {
+
+    private static final ThreadLocal<NativeBuffers> CURRENT = ThreadLocal.withInitial(NativeBuffers::new);
+
+    /**
+     * Capacities of the buffers for strings, one byte above the limits of the backend, so that a longer string
+     * reaches the backend with a length that it rejects
+     */
+    private static final int CLIENT_ID_CAPACITY = 129;
+    private static final int PROCESS_TYPE_CAPACITY = 101;
+    private static final int USER_ID_CAPACITY = 65;
+    private static final int INITIAL_DATA_CAPACITY = 4096;
+
+    /**
+     * Index of the growable data buffer that receives outputs of the backend, i.e. log messages and receipt codes
+     */
+    static final int OUTPUT = 2;
+
+    final ByteBuffer results = allocate(SeApiBackend.RESULT_COUNT * Long.BYTES);
+    final ByteBuffer clientId = allocate(CLIENT_ID_CAPACITY);
+    final ByteBuffer processType = allocate(PROCESS_TYPE_CAPACITY);
+    final ByteBuffer userId = allocate(USER_ID_CAPACITY);
+    final NativeArchive archive = new NativeArchive();
+    final TransactionResultHolder transactionResult = new TransactionResultHolder();
+    private final ByteBuffer[] data = { allocate(INITIAL_DATA_CAPACITY), allocate(INITIAL_DATA_CAPACITY),
+                                        allocate(INITIAL_DATA_CAPACITY) };
+    private final CharsetEncoder encoder = StandardCharsets.UTF_8.newEncoder();
+
+    static NativeBuffers current() {
+        return CURRENT.get();
+    }
+
+    /**
+     * This function returns the cleared results buffer of the current thread
+     * @return results buffer in native byte order
+     */
+    static ByteBuffer results() {
+        ByteBuffer results = CURRENT.get().results;
+        results.clear();
+        return results;
+    }
+
+    private static ByteBuffer allocate(int capacity) {
+        return ByteBuffer.allocateDirect(capacity).order(ByteOrder.nativeOrder());
+    }
+
+    /**
+     * This function encodes a string as UTF-8 into a buffer
+     * @param target buffer of this instance
+     * @param value string to be encoded
+     * @return target with the encoded string between position and limit or null if value is null
+     */
+    ByteBuffer encode(ByteBuffer target, String value) {
+        if (value == null) {
+            return null;
+        }
+        target.clear();
+        encoder.reset();
+        CoderResult result = encoder.encode(CharBuffer.wrap(value), target, true);
+        if (result.isOverflow()) {
+            target.position(target.limit());
+        } else {
+            encoder.flush(target);
+        }
+        target.flip();
+        return target;
+    }
+
+    /**
+     * This function copies data into one of the two growable data buffers
+     * @param slot 0 or 1
+     * @param value data to be copied
+     * @return buffer with the data between position and limit or null if value is null
+     */
+    ByteBuffer copy(int slot, byte[] value) {
+        if (value == null) {
+            return null;
+        }
+        ByteBuffer target = reserve(slot, value.length);
+        target.put(value).flip();
+        return target;
+    }
+
+    /**
+     * This function copies the content of a heap buffer into one of the two growable data buffers
+     * @param slot 0 or 1
+     * @param value buffer whose content between position and limit is copied, remains unchanged
+     * @return buffer with the data between position and limit
+     */
+    ByteBuffer copy(int slot, ByteBuffer value) {
+        ByteBuffer target = reserve(slot, value.remaining());
+        target.put(value.duplicate()).flip();
+        return target;
+    }
+
+    /**
+     * This function returns one of the growable data buffers with room for at least length bytes
+     * @param slot 0, 1 or OUTPUT
+     * @param length required capacity
+     * @return cleared buffer
+     */
+    ByteBuffer reserve(int slot, int length) {
+        if (data[slot].capacity() < length) {
+            data[slot] = allocate(Math.max(length, data[slot].capacity() * 2));
+        }
+        data[slot].clear();
+        return data[slot];
+    }
+}
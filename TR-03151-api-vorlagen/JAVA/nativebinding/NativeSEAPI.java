@@ -0,0 +1,874 @@
+package de.bsi.seapi.nativebinding;
+
+import java.nio.ByteBuffer;
+import java.time.Instant;
+import java.time.ZoneOffset;
+import java.time.ZonedDateTime;
+
+import de.bsi.seapi.Constant;
+import de.bsi.seapi.ErrorCodes;
+import de.bsi.seapi.SEAPI;
+import de.bsi.seapi.SEAPIStatus;
+import de.bsi.seapi.exceptions.ErrorCertificateExpired;
+import de.bsi.seapi.exceptions.ErrorDeleteStoredDataFailed;
+import de.bsi.seapi.exceptions.ErrorDisableSecureElementFailed;
+import de.bsi.seapi.exceptions.ErrorExportCertFailed;
+import de.bsi.seapi.exceptions.ErrorExportSerialNumbersFailed;
+import de.bsi.seapi.exceptions.ErrorFinishTransactionFailed;
+import de.bsi.seapi.exceptions.ErrorGetCurrentNumberOfClientsFailed;
+import de.bsi.seapi.exceptions.ErrorGetCurrentNumberOfTransactionsFailed;
+import de.bsi.seapi.exceptions.ErrorGetMaxNumberOfClientsFailed;
+import de.bsi.seapi.exceptions.ErrorGetMaxNumberTransactionsFailed;
+import de.bsi.seapi.exceptions.ErrorIdNotFound;
+import de.bsi.seapi.exceptions.ErrorInvalidTime;
+import de.bsi.seapi.exceptions.ErrorNoDataAvailable;
+import de.bsi.seapi.exceptions.ErrorNoLogMessage;
+import de.bsi.seapi.exceptions.ErrorNoTransaction;
+import de.bsi.seapi.exceptions.ErrorParameterMismatch;
+import de.bsi.seapi.exceptions.ErrorReadingLogMessage;
+import de.bsi.seapi.exceptions.ErrorRestoreFailed;
+import de.bsi.seapi.exceptions.ErrorStartTransactionFailed;
+import de.bsi.seapi.exceptions.ErrorStorageFailure;
+import de.bsi.seapi.exceptions.ErrorTimeNotSet;
+import de.bsi.seapi.exceptions.ErrorTooManyRecords;
+import de.bsi.seapi.exceptions.ErrorTransactionNumberNotFound;
+import de.bsi.seapi.exceptions.ErrorUnexportedStoredData;
+import de.bsi.seapi.exceptions.ErrorUpdateTimeFailed;
+import de.bsi.seapi.exceptions.ErrorUpdateTransactionFailed;
+import de.bsi.seapi.exceptions.ErrorUserIdNotAuthenticated;
+import de.bsi.seapi.exceptions.ErrorUserIdNotManaged;
+import de.bsi.seapi.exceptions.ErrorUserNotAuthenticated;
+import de.bsi.seapi.exceptions.ErrorUserNotAuthorized;
+import de.bsi.seapi.exceptions.PreallocatedExceptions;
+import de.bsi.seapi.holdertypes.AuthenticationResultHolder;
+import de.bsi.seapi.holdertypes.ByteArrayHolder;
+import de.bsi.seapi.holdertypes.LongHolder;
+import de.bsi.seapi.holdertypes.ShortHolder;
+import de.bsi.seapi.holdertypes.SyncVariantsHolder;
+import de.bsi.seapi.holdertypes.TransactionResultHolder;
+import de.bsi.seapi.holdertypes.UnblockResultHolder;
+import de.bsi.seapi.holdertypes.UpdateVariantsHolder;
+import de.bsi.seapi.holdertypes.ZonedDateTimeHolder;
+
+/**
+ * This class implements the SE API on top of a SeApiBackend, usually the native backend of the ANSI C interface.
+ *
+ * The byte arrays and strings of a call are copied once into direct buffers that are reused by the calling thread
+ * and read in place by the backend. Callers that hold the processData off-heap use the overloads of the
+ * transaction functions that accept a ByteBuffer, and callers that write exported archives to a channel use the
+ * overloads of exportData that return a NativeArchive, so that the data does not pass the Java heap at all.
+ *
+ * The backend stores the log messages unsigned, so that serial numbers and signature values are returned as
+ * empty arrays and the functions for certificates, serial numbers, backups and the deactivation of the Secure
+ * Element fail with their function-specific exceptions. The time has to be set by updateTime with a date and
+ * time. The additionalData of startTransaction and finishTransaction is not stored. Status codes of the backend
+ * for which a function declares no exception are reported by an IllegalStateException.
+ *
+ * The transaction functions are also provided by SEAPIStatus, which returns the status codes of the backend and
+ * sets the output parameters in a reusable TransactionResultHolder. The functions of SEAPI are a compatibility
+ * layer on top of it that throws the preallocated instances of PreallocatedExceptions, so that a failure does not
+ * capture a stack trace either.
+ */
+public final class NativeSEAPI implements SEAPI, SEAPIStatus, AutoCloseable {
+
+    private static final byte[] EMPTY = new byte[0];
+
+    private final SeApiBackend backend;
+
+    /**
+     * ID of the user that has been authenticated most recently, on whose behalf deleteStoredData is executed
+     */
+    private volatile String authenticatedUserId;
+
+    /**
+     * Constructs the SE API on top of an opened backend, which is closed together with this instance
+     * @param backend opened backend
+     */
+    public NativeSEAPI(SeApiBackend backend) {
+        this.backend = backend;
+    }
+
+    private static ZonedDateTime time(long seconds) {
+        return ZonedDateTime.ofInstant(Instant.ofEpochSecond(seconds), ZoneOffset.UTC);
+    }
+
+    private static long result(ByteBuffer results, int index) {
+        return results.getLong(index * Long.BYTES);
+    }
+
+    private static IllegalStateException unexpected(short result) {
+        return new IllegalStateException("SE API backend returned " + result);
+    }
+
+    /**
+     * Returns the processData as direct buffer, copying it into the buffers of the thread if it is on the heap
+     */
+    private static ByteBuffer direct(NativeBuffers buffers, ByteBuffer processData) {
+        if (processData == null || processData.isDirect()) {
+            return processData;
+        }
+        return buffers.copy(0, processData);
+    }
+
+    @Override
+    public short initialize(String description) {
+        /* the backend is ready for use once it has been opened */
+        return Constant.EXECUTION_OK;
+    }
+
+    @Override
+    public short initialize() {
+        return Constant.EXECUTION_OK;
+    }
+
+    @Override
+    public short updateTime(ZonedDateTime newDateTime) throws ErrorUpdateTimeFailed, ErrorStorageFailure,
+                                                              ErrorInvalidTime, ErrorCertificateExpired {
+        short result = backend.updateTime(newDateTime.toEpochSecond(), NativeBuffers.results());
+        switch (result) {
+        case Constant.EXECUTION_OK:
+            return result;
+        case ErrorCodes.ERROR_CERTIFICATE_EXPIRED:
+            /* the time has been set and its log message has been stored */
+            throw PreallocatedExceptions.CERTIFICATE_EXPIRED;
+        case ErrorCodes.ERROR_INVALID_TIME:
+            throw PreallocatedExceptions.INVALID_TIME;
+        case ErrorCodes.ERROR_STORAGE_FAILURE:
+            throw PreallocatedExceptions.STORAGE_FAILURE;
+        default:
+            throw PreallocatedExceptions.UPDATE_TIME_FAILED;
+        }
+    }
+
+    @Override
+    public short updateTime() throws ErrorUpdateTimeFailed {
+        throw PreallocatedExceptions.UPDATE_TIME_FAILED;
+    }
+
+    @Override
+    public short disableSecureElement() throws ErrorDisableSecureElementFailed {
+        throw PreallocatedExceptions.DISABLE_SECURE_ELEMENT_FAILED;
+    }
+
+    /**
+     * Logs a transaction log message and sets the output parameters if the log message has been stored
+     */
+    private short logTransaction(int operation, String clientId, long transactionNumber, ByteBuffer processData,
+                                 String processType, TransactionResultHolder result) {
+        NativeBuffers buffers = NativeBuffers.current();
+        ByteBuffer results = NativeBuffers.results();
+        short status = backend.logTransaction(operation, buffers.encode(buffers.clientId, clientId), transactionNumber,
+                                              direct(buffers, processData),
+                                              buffers.encode(buffers.processType, processType), results);
+        if (status == Constant.EXECUTION_OK || status == ErrorCodes.ERROR_CERTIFICATE_EXPIRED) {
+            result.setTransactionNumber(result(results, SeApiBackend.TRANSACTION_NUMBER));
+            result.setSignatureCounter(result(results, SeApiBackend.SIGNATURE_COUNTER));
+            result.setLogTime(result(results, SeApiBackend.LOG_TIME));
+            result.setSerialNumber(EMPTY);
+            result.setSignatureValue(EMPTY);
+        }
+        return status;
+    }
+
+    @Override
+    public short startTransaction(String clientId, byte[] processData, String processType, byte[] additionalData,
+                                  TransactionResultHolder result) {
+        return logTransaction(SeApiBackend.START, clientId, 0, NativeBuffers.current().copy(0, processData),
+                              processType, result);
+    }
+
+    /**
+     * This function starts a transaction with processData that is read in place if it is a direct buffer.
+     * The parameters and return values correspond to those of startTransaction of SEAPIStatus
+     * @param clientId ID of the application that has invoked the function
+     * @param processData process data between position and limit of the buffer, the buffer remains unchanged
+     * @param processType type of the transaction
+     * @param result receives the output parameters
+     * @return EXECUTION_OK or an error code of ErrorCodes
+     */
+    public short startTransaction(String clientId, ByteBuffer processData, String processType,
+                                  TransactionResultHolder result) {
+        return logTransaction(SeApiBackend.START, clientId, 0, processData, processType, result);
+    }
+
+    @Override
+    public short updateTransaction(String clientId, long transactionNumber, byte[] processData, String processType,
+                                   TransactionResultHolder result) {
+        return logTransaction(SeApiBackend.UPDATE, clientId, transactionNumber,
+                              NativeBuffers.current().copy(0, processData), processType, result);
+    }
+
+    /**
+     * This function updates a transaction with processData that is read in place if it is a direct buffer.
+     * The parameters and return values correspond to those of updateTransaction of SEAPIStatus
+     * @param clientId ID of the application that has invoked the function
+     * @param transactionNumber number of the transaction
+     * @param processData process data between position and limit of the buffer, the buffer remains unchanged
+     * @param processType type of the transaction
+     * @param result receives the output parameters
+     * @return EXECUTION_OK or an error code of ErrorCodes
+     */
+    public short updateTransaction(String clientId, long transactionNumber, ByteBuffer processData,
+                                   String processType, TransactionResultHolder result) {
+        return logTransaction(SeApiBackend.UPDATE, clientId, transactionNumber, processData, processType, result);
+    }
+
+    @Override
+    public short finishTransaction(String clientId, long transactionNumber, byte[] processData, String processType,
+                                   byte[] additionalData, TransactionResultHolder result) {
+        return logTransaction(SeApiBackend.FINISH, clientId, transactionNumber,
+                              NativeBuffers.current().copy(0, processData), processType, result);
+    }
+
+    /**
+     * This function finishes a transaction with processData that is read in place if it is a direct buffer.
+     * The parameters and return values correspond to those of finishTransaction of SEAPIStatus
+     * @param clientId ID of the application that has invoked the function
+     * @param transactionNumber number of the transaction
+     * @param processData process data between position and limit of the buffer, the buffer remains unchanged
+     * @param processType type of the transaction
+     * @param result receives the output parameters
+     * @return EXECUTION_OK or an error code of ErrorCodes
+     */
+    public short finishTransaction(String clientId, long transactionNumber, ByteBuffer processData,
+                                   String processType, TransactionResultHolder result) {
+        return logTransaction(SeApiBackend.FINISH, clientId, transactionNumber, processData, processType, result);
+    }
+
+    /**
+     * Copies the output parameters of a stored log message to the holders of SEAPI
+     */
+    /**
+     * Sets the output parameters of finishTransaction with a receipt code once the log message has been stored
+     */
+    private static void setReceiptCodeResults(NativeBuffers buffers, ByteBuffer results, ByteBuffer code,
+                                              ZonedDateTimeHolder logTime, LongHolder signatureCounter,
+                                              ByteBuffer receiptCode) {
+        TransactionResultHolder transactionResult = buffers.transactionResult;
+        transactionResult.setLogTime(result(results, SeApiBackend.LOG_TIME));
+        transactionResult.setSignatureCounter(result(results, SeApiBackend.SIGNATURE_COUNTER));
+        setTransactionResults(transactionResult, null, logTime, signatureCounter);
+        int length = (int) result(results, SeApiBackend.RECEIPT_CODE_LENGTH);
+        if (length <= receiptCode.remaining()) {
+            if (code != receiptCode) {
+                receiptCode.put(code.limit(length));
+            } else {
+                receiptCode.position(receiptCode.position() + length);
+            }
+        }
+    }
+
+    private static void setTransactionResults(TransactionResultHolder result,
+                                              LongHolder transactionNumber,
+                                              ZonedDateTimeHolder logTime,
+                                              LongHolder signatureCounter) {
+        if (transactionNumber != null) {
+            transactionNumber.setValue(result.getTransactionNumber());
+        }
+        logTime.setValue(result.getLogDateTime());
+        signatureCounter.setValue(result.getSignatureCounter());
+    }
+
+    @Override
+    public short startTransaction(String clientId, byte[] processData, String processType, byte[] additionalData,
+                                  LongHolder transactionNumber, ZonedDateTimeHolder logTime,
+                                  ByteArrayHolder serialNumber, LongHolder signatureCounter,
+                                  ByteArrayHolder signatureValue)
+                                  throws ErrorStartTransactionFailed, ErrorStorageFailure, ErrorTimeNotSet,
+                                         ErrorCertificateExpired {
+        serialNumber.setValue(EMPTY);
+        signatureValue.setValue(EMPTY);
+        return startTransaction(clientId, NativeBuffers.current().copy(0, processData), processType,
+                                transactionNumber, logTime, signatureCounter);
+    }
+
+    /**
+     * This function starts a transaction with processData that is read in place if it is a direct buffer.
+     * The parameters and exceptions correspond to those of startTransaction of SEAPI
+     * @param clientId ID of the application that has invoked the function
+     * @param processData process data between position and limit of the buffer, the buffer remains unchanged
+     * @param processType type of the transaction
+     * @param transactionNumber receives the number of the transaction
+     * @param logTime receives the time of the log message
+     * @param signatureCounter receives the signature counter of the log message
+     * @return EXECUTION_OK
+     * @throws ErrorStartTransactionFailed if the log message could not be created
+     * @throws ErrorStorageFailure if the log message could not be stored
+     * @throws ErrorTimeNotSet if the time has not been set
+     * @throws ErrorCertificateExpired after the log message has been stored, if the certificate is expired
+     */
+    public short startTransaction(String clientId, ByteBuffer processData, String processType,
+                                  LongHolder transactionNumber, ZonedDateTimeHolder logTime,
+                                  LongHolder signatureCounter)
+                                  throws ErrorStartTransactionFailed, ErrorStorageFailure, ErrorTimeNotSet,
+                                         ErrorCertificateExpired {
+        TransactionResultHolder transactionResult = NativeBuffers.current().transactionResult;
+        short result = logTransaction(SeApiBackend.START, clientId, 0, processData, processType, transactionResult);
+        switch (result) {
+        case Constant.EXECUTION_OK:
+            setTransactionResults(transactionResult, transactionNumber, logTime, signatureCounter);
+            return result;
+        case ErrorCodes.ERROR_CERTIFICATE_EXPIRED:
+            setTransactionResults(transactionResult, transactionNumber, logTime, signatureCounter);
+            throw PreallocatedExceptions.CERTIFICATE_EXPIRED;
+        case ErrorCodes.ERROR_STORAGE_FAILURE:
+            throw PreallocatedExceptions.STORAGE_FAILURE;
+        case ErrorCodes.ERROR_TIME_NOT_SET:
+            throw PreallocatedExceptions.TIME_NOT_SET;
+        default:
+            throw PreallocatedExceptions.START_TRANSACTION_FAILED;
+        }
+    }
+
+    @Override
+    public short updateTransaction(String clientId, long transactionNumber, byte[] processData, String processType,
+                                   ZonedDateTimeHolder logTime, ByteArrayHolder signatureValue,
+                                   LongHolder signatureCounter)
+                                   throws ErrorUpdateTransactionFailed, ErrorStorageFailure, ErrorNoTransaction,
+                                          ErrorTimeNotSet, ErrorCertificateExpired {
+        signatureValue.setValue(EMPTY);
+        return updateTransaction(clientId, transactionNumber, NativeBuffers.current().copy(0, processData),
+                                 processType, logTime, signatureCounter);
+    }
+
+    /**
+     * This function updates a transaction with processData that is read in place if it is a direct buffer.
+     * The parameters and exceptions correspond to those of updateTransaction of SEAPI
+     * @param clientId ID of the application that has invoked the function
+     * @param transactionNumber number of the transaction
+     * @param processData process data between position and limit of the buffer, the buffer remains unchanged
+     * @param processType type of the transaction
+     * @param logTime receives the time of the log message
+     * @param signatureCounter receives the signature counter of the log message
+     * @return EXECUTION_OK
+     * @throws ErrorUpdateTransactionFailed if the log message could not be created
+     * @throws ErrorStorageFailure if the log message could not be stored
+     * @throws ErrorNoTransaction if no transaction is open under the transaction number
+     * @throws ErrorTimeNotSet if the time has not been set
+     * @throws ErrorCertificateExpired after the log message has been stored, if the certificate is expired
+     */
+    public short updateTransaction(String clientId, long transactionNumber, ByteBuffer processData,
+                                   String processType, ZonedDateTimeHolder logTime, LongHolder signatureCounter)
+                                   throws ErrorUpdateTransactionFailed, ErrorStorageFailure, ErrorNoTransaction,
+                                          ErrorTimeNotSet, ErrorCertificateExpired {
+        TransactionResultHolder transactionResult = NativeBuffers.current().transactionResult;
+        short result = logTransaction(SeApiBackend.UPDATE, clientId, transactionNumber, processData, processType,
+                                      transactionResult);
+        switch (result) {
+        case Constant.EXECUTION_OK:
+            setTransactionResults(transactionResult, null, logTime, signatureCounter);
+            return result;
+        case ErrorCodes.ERROR_CERTIFICATE_EXPIRED:
+            setTransactionResults(transactionResult, null, logTime, signatureCounter);
+            throw PreallocatedExceptions.CERTIFICATE_EXPIRED;
+        case ErrorCodes.ERROR_STORAGE_FAILURE:
+            throw PreallocatedExceptions.STORAGE_FAILURE;
+        case ErrorCodes.ERROR_NO_TRANSACTION:
+            throw PreallocatedExceptions.NO_TRANSACTION;
+        case ErrorCodes.ERROR_TIME_NOT_SET:
+            throw PreallocatedExceptions.TIME_NOT_SET;
+        default:
+            throw PreallocatedExceptions.UPDATE_TRANSACTION_FAILED;
+        }
+    }
+
+    @Override
+    public short finishTransaction(String clientId, long transactionNumber, byte[] processData, String processType,
+                                   byte[] additionalData, ZonedDateTimeHolder logTime,
+                                   ByteArrayHolder signatureValue, LongHolder signatureCounter)
+                                   throws ErrorFinishTransactionFailed, ErrorStorageFailure, ErrorNoTransaction,
+                                          ErrorTimeNotSet, ErrorCertificateExpired {
+        signatureValue.setValue(EMPTY);
+        return finishTransaction(clientId, transactionNumber, NativeBuffers.current().copy(0, processData),
+                                 processType, logTime, signatureCounter);
+    }
+
+    /**
+     * This function finishs a transaction with processData that is read in place if it is a direct buffer.
+     * The parameters and exceptions correspond to those of finishTransaction of SEAPI
+     * @param clientId ID of the application that has invoked the function
+     * @param transactionNumber number of the transaction
+     * @param processData process data between position and limit of the buffer, the buffer remains unchanged
+     * @param processType type of the transaction
+     * @param logTime receives the time of the log message
+     * @param signatureCounter receives the signature counter of the log message
+     * @return EXECUTION_OK
+     * @throws ErrorFinishTransactionFailed if the log message could not be created
+     * @throws ErrorStorageFailure if the log message could not be stored
+     * @throws ErrorNoTransaction if no transaction is open under the transaction number
+     * @throws ErrorTimeNotSet if the time has not been set
+     * @throws ErrorCertificateExpired after the log message has been stored, if the certificate is expired
+     */
+    public short finishTransaction(String clientId, long transactionNumber, ByteBuffer processData,
+                                   String processType, ZonedDateTimeHolder logTime, LongHolder signatureCounter)
+                                   throws ErrorFinishTransactionFailed, ErrorStorageFailure, ErrorNoTransaction,
+                                          ErrorTimeNotSet, ErrorCertificateExpired {
+        TransactionResultHolder transactionResult = NativeBuffers.current().transactionResult;
+        short result = logTransaction(SeApiBackend.FINISH, clientId, transactionNumber, processData, processType,
+                                      transactionResult);
+        switch (result) {
+        case Constant.EXECUTION_OK:
+            setTransactionResults(transactionResult, null, logTime, signatureCounter);
+            return result;
+        case ErrorCodes.ERROR_CERTIFICATE_EXPIRED:
+            setTransactionResults(transactionResult, null, logTime, signatureCounter);
+            throw PreallocatedExceptions.CERTIFICATE_EXPIRED;
+        case ErrorCodes.ERROR_STORAGE_FAILURE:
+            throw PreallocatedExceptions.STORAGE_FAILURE;
+        case ErrorCodes.ERROR_NO_TRANSACTION:
+            throw PreallocatedExceptions.NO_TRANSACTION;
+        case ErrorCodes.ERROR_TIME_NOT_SET:
+            throw PreallocatedExceptions.TIME_NOT_SET;
+        default:
+            throw PreallocatedExceptions.FINISH_TRANSACTION_FAILED;
+        }
+    }
+
+    /**
+     * This function finishs a transaction like the previous function and additionally returns the receipt code of
+     * the transaction, i.e. the content of the QR code on the receipt, which the backend builds without allocating
+     * memory
+     * @param receiptCode receives the receipt code from its position on and its position is advanced; nothing is
+     *                    written if the receipt code is longer than the remaining space
+     * @return EXECUTION_OK
+     * @throws ErrorFinishTransactionFailed if the log message could not be created
+     * @throws ErrorStorageFailure if the log message could not be stored
+     * @throws ErrorNoTransaction if no transaction is open under the transaction number
+     * @throws ErrorTimeNotSet if the time has not been set
+     * @throws ErrorCertificateExpired after the log message has been stored and the receipt code has been written,
+     *                                 if the certificate is expired
+     */
+    public short finishTransaction(String clientId, long transactionNumber, ByteBuffer processData,
+                                   String processType, ZonedDateTimeHolder logTime, LongHolder signatureCounter,
+                                   ByteBuffer receiptCode)
+                                   throws ErrorFinishTransactionFailed, ErrorStorageFailure, ErrorNoTransaction,
+                                          ErrorTimeNotSet, ErrorCertificateExpired {
+        NativeBuffers buffers = NativeBuffers.current();
+        ByteBuffer results = NativeBuffers.results();
+        ByteBuffer code = receiptCode.isDirect() ? receiptCode
+                          : buffers.reserve(NativeBuffers.OUTPUT, receiptCode.remaining())
+                                   .limit(receiptCode.remaining());
+        short result = backend.finishTransaction(buffers.encode(buffers.clientId, clientId), transactionNumber,
+                                                 direct(buffers, processData),
+                                                 buffers.encode(buffers.processType, processType), code, results);
+        switch (result) {
+        case Constant.EXECUTION_OK:
+            setReceiptCodeResults(buffers, results, code, logTime, signatureCounter, receiptCode);
+            return result;
+        case ErrorCodes.ERROR_CERTIFICATE_EXPIRED:
+            setReceiptCodeResults(buffers, results, code, logTime, signatureCounter, receiptCode);
+            throw PreallocatedExceptions.CERTIFICATE_EXPIRED;
+        case ErrorCodes.ERROR_STORAGE_FAILURE:
+            throw PreallocatedExceptions.STORAGE_FAILURE;
+        case ErrorCodes.ERROR_NO_TRANSACTION:
+            throw PreallocatedExceptions.NO_TRANSACTION;
+        case ErrorCodes.ERROR_TIME_NOT_SET:
+            throw PreallocatedExceptions.TIME_NOT_SET;
+        default:
+            throw PreallocatedExceptions.FINISH_TRANSACTION_FAILED;
+        }
+    }
+
+    /**
+     * This function exports the log messages of an interval of transactions. The archive remains in the memory
+     * of the backend until exportedData is closed
+     * @param startTransactionNumber first transaction number of the interval
+     * @param endTransactionNumber last transaction number of the interval
+     * @param clientId ID of the client whose log messages are exported, may be null
+     * @param maximumNumberRecords maximum number of log messages, 0 for no limit
+     * @param exportedData receives the archive
+     * @return EXECUTION_OK
+     * @throws ErrorParameterMismatch if the interval is invalid
+     * @throws ErrorTransactionNumberNotFound if no transaction of the interval is stored
+     * @throws ErrorIdNotFound if no log message of the interval belongs to the client
+     * @throws ErrorTooManyRecords if more log messages than maximumNumberRecords are selected
+     */
+    public short exportData(long startTransactionNumber, long endTransactionNumber, String clientId,
+                            int maximumNumberRecords, NativeArchive exportedData)
+                            throws ErrorParameterMismatch, ErrorTransactionNumberNotFound, ErrorIdNotFound,
+                                   ErrorTooManyRecords {
+        NativeBuffers buffers = NativeBuffers.current();
+        short result = backend.exportData(SeApiBackend.EXPORT_TRANSACTIONS, startTransactionNumber,
+                                          endTransactionNumber, buffers.encode(buffers.clientId, clientId),
+                                          maximumNumberRecords, exportedData);
+        switch (result) {
+        case Constant.EXECUTION_OK:
+            return result;
+        case ErrorCodes.ERROR_PARAMETER_MISMATCH:
+            throw PreallocatedExceptions.PARAMETER_MISMATCH;
+        case ErrorCodes.ERROR_TRANSACTION_NUMBER_NOT_FOUND:
+            throw PreallocatedExceptions.TRANSACTION_NUMBER_NOT_FOUND;
+        case ErrorCodes.ERROR_ID_NOT_FOUND:
+            throw PreallocatedExceptions.ID_NOT_FOUND;
+        case ErrorCodes.ERROR_TOO_MANY_RECORDS:
+            throw PreallocatedExceptions.TOO_MANY_RECORDS;
+        default:
+            throw unexpected(result);
+        }
+    }
+
+    /**
+     * This function exports the log messages of a period of time. The archive remains in the memory of the
+     * backend until exportedData is closed
+     * @param startDate start of the period, null for an open start
+     * @param endDate end of the period, null for an open end
+     * @param clientId ID of the client whose log messages are exported, may be null
+     * @param maximumNumberRecords maximum number of log messages, 0 for no limit
+     * @param exportedData receives the archive
+     * @return EXECUTION_OK
+     * @throws ErrorParameterMismatch if the period is invalid
+     * @throws ErrorNoDataAvailable if no log message of the period is stored
+     * @throws ErrorIdNotFound if no log message of the period belongs to the client
+     * @throws ErrorTooManyRecords if more log messages than maximumNumberRecords are selected
+     */
+    public short exportData(ZonedDateTime startDate, ZonedDateTime endDate, String clientId,
+                            int maximumNumberRecords, NativeArchive exportedData)
+                            throws ErrorParameterMismatch, ErrorNoDataAvailable, ErrorIdNotFound,
+                                   ErrorTooManyRecords {
+        NativeBuffers buffers = NativeBuffers.current();
+        short result = backend.exportData(SeApiBackend.EXPORT_PERIOD,
+                                          startDate != null ? startDate.toEpochSecond() : SeApiBackend.NO_START_TIME,
+                                          endDate != null ? endDate.toEpochSecond() : SeApiBackend.NO_END_TIME,
+                                          buffers.encode(buffers.clientId, clientId), maximumNumberRecords,
+                                          exportedData);
+        switch (result) {
+        case Constant.EXECUTION_OK:
+            return result;
+        case ErrorCodes.ERROR_PARAMETER_MISMATCH:
+            throw PreallocatedExceptions.PARAMETER_MISMATCH;
+        case ErrorCodes.ERROR_NO_DATA_AVAILABLE:
+            throw PreallocatedExceptions.NO_DATA_AVAILABLE;
+        case ErrorCodes.ERROR_ID_NOT_FOUND:
+            throw PreallocatedExceptions.ID_NOT_FOUND;
+        case ErrorCodes.ERROR_TOO_MANY_RECORDS:
+            throw PreallocatedExceptions.TOO_MANY_RECORDS;
+        default:
+            throw unexpected(result);
+        }
+    }
+
+    /**
+     * This function exports all stored log messages. The archive remains in the memory of the backend until
+     * exportedData is closed
+     * @param maximumNumberRecords maximum number of log messages, 0 for no limit
+     * @param exportedData receives the archive
+     * @return EXECUTION_OK
+     * @throws ErrorTooManyRecords if more log messages than maximumNumberRecords are stored
+     */
+    public short exportData(int maximumNumberRecords, NativeArchive exportedData) throws ErrorTooManyRecords {
+        short result = backend.exportData(SeApiBackend.EXPORT_ALL, 0, 0, null, maximumNumberRecords, exportedData);
+        switch (result) {
+        case Constant.EXECUTION_OK:
+            return result;
+        case ErrorCodes.ERROR_TOO_MANY_RECORDS:
+            throw PreallocatedExceptions.TOO_MANY_RECORDS;
+        default:
+            throw unexpected(result);
+        }
+    }
+
+    /**
+     * Copies an archive to the heap and releases it
+     */
+    private static void copy(NativeArchive archive, ByteArrayHolder exportedData) {
+        try (NativeArchive held = archive) {
+            exportedData.setValue(held.toByteArray());
+        }
+    }
+
+    @Override
+    public short exportData(long transactionNumber, String clientId, ByteArrayHolder exportedData)
+                            throws ErrorTransactionNumberNotFound, ErrorIdNotFound {
+        NativeArchive archive = NativeBuffers.current().archive;
+        try {
+            exportData(transactionNumber, transactionNumber, clientId, 0, archive);
+        } catch (ErrorParameterMismatch | ErrorTooManyRecords e) {
+            throw new IllegalStateException(e);
+        }
+        copy(archive, exportedData);
+        return Constant.EXECUTION_OK;
+    }
+
+    @Override
+    public short exportData(long transactionNumber, ByteArrayHolder exportedData)
+                            throws ErrorTransactionNumberNotFound {
+        NativeArchive archive = NativeBuffers.current().archive;
+        try {
+            exportData(transactionNumber, transactionNumber, null, 0, archive);
+        } catch (ErrorParameterMismatch | ErrorIdNotFound | ErrorTooManyRecords e) {
+            throw new IllegalStateException(e);
+        }
+        copy(archive, exportedData);
+        return Constant.EXECUTION_OK;
+    }
+
+    @Override
+    public short exportData(long startTransactionNumber, long endTransactionNumber, int maximumNumberRecords,
+                            ByteArrayHolder exportedData)
+                            throws ErrorParameterMismatch, ErrorTransactionNumberNotFound, ErrorTooManyRecords {
+        NativeArchive archive = NativeBuffers.current().archive;
+        try {
+            exportData(startTransactionNumber, endTransactionNumber, null, maximumNumberRecords, archive);
+        } catch (ErrorIdNotFound e) {
+            throw new IllegalStateException(e);
+        }
+        copy(archive, exportedData);
+        return Constant.EXECUTION_OK;
+    }
+
+    @Override
+    public short exportData(long startTransactionNumber, long endTransactionNumber, String clientId,
+                            int maximumNumberRecords, ByteArrayHolder exportedData)
+                            throws ErrorParameterMismatch, ErrorTransactionNumberNotFound, ErrorIdNotFound,
+                                   ErrorTooManyRecords {
+        NativeArchive archive = NativeBuffers.current().archive;
+        exportData(startTransactionNumber, endTransactionNumber, clientId, maximumNumberRecords, archive);
+        copy(archive, exportedData);
+        return Constant.EXECUTION_OK;
+    }
+
+    @Override
+    public short exportData(ZonedDateTime startDate, ZonedDateTime endDate, int maximumNumberRecords,
+                            ByteArrayHolder exportedData)
+                            throws ErrorParameterMismatch, ErrorNoDataAvailable, ErrorTooManyRecords {
+        NativeArchive archive = NativeBuffers.current().archive;
+        try {
+            exportData(startDate, endDate, null, maximumNumberRecords, archive);
+        } catch (ErrorIdNotFound e) {
+            throw new IllegalStateException(e);
+        }
+        copy(archive, exportedData);
+        return Constant.EXECUTION_OK;
+    }
+
+    @Override
+    public short exportData(ZonedDateTime startDate, ZonedDateTime endDate, String clientId,
+                            int maximumNumberRecords, ByteArrayHolder exportedData)
+                            throws ErrorParameterMismatch, ErrorNoDataAvailable, ErrorIdNotFound,
+                                   ErrorTooManyRecords {
+        NativeArchive archive = NativeBuffers.current().archive;
+        exportData(startDate, endDate, clientId, maximumNumberRecords, archive);
+        copy(archive, exportedData);
+        return Constant.EXECUTION_OK;
+    }
+
+    @Override
+    public short exportData(int maximumNumberRecords, ByteArrayHolder exportedData) throws ErrorTooManyRecords {
+        NativeArchive archive = NativeBuffers.current().archive;
+        exportData(maximumNumberRecords, archive);
+        copy(archive, exportedData);
+        return Constant.EXECUTION_OK;
+    }
+
+    @Override
+    public short exportCertificates(ByteArrayHolder certificates) throws ErrorExportCertFailed {
+        throw PreallocatedExceptions.EXPORT_CERT_FAILED;
+    }
+
+    @Override
+    public short restoreFromBackup(byte[] restoreData) throws ErrorRestoreFailed {
+        throw PreallocatedExceptions.RESTORE_FAILED;
+    }
+
+    @Override
+    public short readLogMessage(ByteArrayHolder logMessage) throws ErrorNoLogMessage, ErrorReadingLogMessage {
+        return readLogMessage(null, 0, logMessage);
+    }
+
+    /**
+     * Reads the most recent log message of a client or of one of its transactions, e.g. to print the QR code of the
+     * receipt of a transaction while other clients log further transactions. The log message is served from the
+     * recent log messages that the backend keeps in memory
+     * @param clientId ID of the client, null for the last log message of all clients
+     * @param transactionNumber number of the transaction of the client, 0 for any transaction
+     * @param logMessage receives the payload of the log message
+     * @return EXECUTION_OK
+     * @throws ErrorNoLogMessage
+     *             no log message of the client or the transaction is held by the backend
+     * @throws ErrorReadingLogMessage
+     *             the log message could not be read
+     */
+    public short readLogMessage(String clientId, long transactionNumber, ByteArrayHolder logMessage)
+                                throws ErrorNoLogMessage, ErrorReadingLogMessage {
+        NativeBuffers buffers = NativeBuffers.current();
+        ByteBuffer encodedClientId = buffers.encode(buffers.clientId, clientId);
+        ByteBuffer results = NativeBuffers.results();
+        ByteBuffer message = buffers.reserve(NativeBuffers.OUTPUT, 0);
+        short result = backend.readLogMessage(encodedClientId, transactionNumber, message, results);
+        if (result == ErrorCodes.ERROR_PARAMETER_MISMATCH
+            && result(results, SeApiBackend.LOG_MESSAGE_LENGTH) > message.remaining()) {
+            /* the log message is longer than the buffer of the thread, which is enlarged once */
+            message = buffers.reserve(NativeBuffers.OUTPUT,
+                                      (int) result(results, SeApiBackend.LOG_MESSAGE_LENGTH));
+            result = backend.readLogMessage(encodedClientId, transactionNumber, message, results);
+        }
+        switch (result) {
+        case Constant.EXECUTION_OK:
+            byte[] value = new byte[(int) result(results, SeApiBackend.LOG_MESSAGE_LENGTH)];
+            message.get(value);
+            logMessage.setValue(value);
+            return result;
+        case ErrorCodes.ERROR_NO_LOG_MESSAGE:
+            throw PreallocatedExceptions.NO_LOG_MESSAGE;
+        default:
+            throw PreallocatedExceptions.READING_LOG_MESSAGE;
+        }
+    }
+
+    @Override
+    public short exportSerialNumbers(ByteArrayHolder serialNumbers) throws ErrorExportSerialNumbersFailed {
+        throw PreallocatedExceptions.EXPORT_SERIAL_NUMBERS_FAILED;
+    }
+
+    @Override
+    public short getMaxNumberOfClients(LongHolder maxNumberClients) throws ErrorGetMaxNumberOfClientsFailed {
+        throw PreallocatedExceptions.GET_MAX_NUMBER_OF_CLIENTS_FAILED;
+    }
+
+    @Override
+    public short getCurrentNumberOfClients(LongHolder currentNumberClients)
+                                           throws ErrorGetCurrentNumberOfClientsFailed {
+        throw PreallocatedExceptions.GET_CURRENT_NUMBER_OF_CLIENTS_FAILED;
+    }
+
+    @Override
+    public short getMaxNumberOfTransactions(LongHolder maxNumberTransactions)
+                                            throws ErrorGetMaxNumberTransactionsFailed {
+        throw PreallocatedExceptions.GET_MAX_NUMBER_TRANSACTIONS_FAILED;
+    }
+
+    @Override
+    public short getCurrentNumberOfTransactions(LongHolder currentNumberTransactions)
+                                                throws ErrorGetCurrentNumberOfTransactionsFailed {
+        ByteBuffer results = NativeBuffers.results();
+        short result = backend.getCurrentNumberOfTransactions(results);
+        if (result != Constant.EXECUTION_OK) {
+            throw PreallocatedExceptions.GET_CURRENT_NUMBER_OF_TRANSACTIONS_FAILED;
+        }
+        currentNumberTransactions.setValue(result(results, 0));
+        return result;
+    }
+
+    @Override
+    public short getSupportedTransactionUpdateVariants(UpdateVariantsHolder supportedUpdateVariants) {
+        supportedUpdateVariants.setValue(UpdateVariants.unsignedUpdate);
+        return Constant.EXECUTION_OK;
+    }
+
+    @Override
+    public short deleteStoredData() throws ErrorDeleteStoredDataFailed, ErrorUnexportedStoredData,
+                                           ErrorUserNotAuthorized, ErrorUserNotAuthenticated {
+        NativeBuffers buffers = NativeBuffers.current();
+        short result = backend.deleteStoredData(buffers.encode(buffers.userId, authenticatedUserId));
+        switch (result) {
+        case Constant.EXECUTION_OK:
+            return result;
+        case ErrorCodes.ERROR_UNEXPORTED_STORED_DATA:
+            throw PreallocatedExceptions.UNEXPORTED_STORED_DATA;
+        case ErrorCodes.ERROR_USER_NOT_AUTHORIZED:
+            throw PreallocatedExceptions.USER_NOT_AUTHORIZED;
+        case ErrorCodes.ERROR_USER_NOT_AUTHENTICATED:
+            throw PreallocatedExceptions.USER_NOT_AUTHENTICATED;
+        default:
+            throw PreallocatedExceptions.DELETE_STORED_DATA_FAILED;
+        }
+    }
+
+    @Override
+    public short getTimeSyncVariant(SyncVariantsHolder supportedSyncVariant) {
+        supportedSyncVariant.setValue(SyncVariants.unixTime);
+        return Constant.EXECUTION_OK;
+    }
+
+    @Override
+    public short authenticateUser(String userId, byte[] pin, AuthenticationResultHolder authenticationResult,
+                                  ShortHolder remainingRetries) throws ErrorStorageFailure {
+        NativeBuffers buffers = NativeBuffers.current();
+        ByteBuffer results = NativeBuffers.results();
+        short result = backend.authenticateUser(buffers.encode(buffers.userId, userId), buffers.copy(0, pin),
+                                                results);
+        switch (result) {
+        case Constant.EXECUTION_OK:
+            authenticatedUserId = userId;
+            break;
+        case Constant.AUTHENTICATION_FAILED:
+            break;
+        case ErrorCodes.ERROR_PARAMETER_MISMATCH:
+            /* a user ID that exceeds the limits of the backend cannot be managed */
+            authenticationResult.setValue(AuthenticationResult.unknownUserId);
+            remainingRetries.setValue((short) 0);
+            return Constant.AUTHENTICATION_FAILED;
+        case ErrorCodes.ERROR_STORAGE_FAILURE:
+            throw PreallocatedExceptions.STORAGE_FAILURE;
+        default:
+            throw unexpected(result);
+        }
+        authenticationResult.setValue(AuthenticationResult.values()[(int) result(results, SeApiBackend.RESULT)]);
+        remainingRetries.setValue((short) result(results, SeApiBackend.REMAINING_RETRIES));
+        return result;
+    }
+
+    @Override
+    public short logOut(String userId) throws ErrorUserIdNotManaged, ErrorUserIdNotAuthenticated,
+                                              ErrorStorageFailure {
+        NativeBuffers buffers = NativeBuffers.current();
+        short result = backend.logOut(buffers.encode(buffers.userId, userId));
+        switch (result) {
+        case Constant.EXECUTION_OK:
+            if (userId.equals(authenticatedUserId)) {
+                authenticatedUserId = null;
+            }
+            return result;
+        case ErrorCodes.ERROR_USER_ID_NOT_MANAGED:
+            throw PreallocatedExceptions.USER_ID_NOT_MANAGED;
+        case ErrorCodes.ERROR_USER_ID_NOT_AUTHENTICATED:
+            throw PreallocatedExceptions.USER_ID_NOT_AUTHENTICATED;
+        case ErrorCodes.ERROR_STORAGE_FAILURE:
+            throw PreallocatedExceptions.STORAGE_FAILURE;
+        default:
+            throw unexpected(result);
+        }
+    }
+
+    @Override
+    public short unblockUser(String userId, byte[] puk, byte[] newPin, UnblockResultHolder unblockResult)
+                             throws ErrorStorageFailure {
+        NativeBuffers buffers = NativeBuffers.current();
+        ByteBuffer results = NativeBuffers.results();
+        short result = backend.unblockUser(buffers.encode(buffers.userId, userId), buffers.copy(0, puk),
+                                           buffers.copy(1, newPin), results);
+        switch (result) {
+        case Constant.EXECUTION_OK:
+        case Constant.UNBLOCK_FAILED:
+            break;
+        case ErrorCodes.ERROR_PARAMETER_MISMATCH:
+            unblockResult.setValue(UnblockResult.unknownUserId);
+            return Constant.UNBLOCK_FAILED;
+        case ErrorCodes.ERROR_STORAGE_FAILURE:
+            throw PreallocatedExceptions.STORAGE_FAILURE;
+        default:
+            throw unexpected(result);
+        }
+        /* a blocked PUK is reported as failed attempt */
+        switch ((int) result(results, SeApiBackend.RESULT)) {
+        case 0:
+            unblockResult.setValue(UnblockResult.ok);
+            break;
+        case 3:
+            unblockResult.setValue(UnblockResult.unknownUserId);
+            break;
+        default:
+            unblockResult.setValue(UnblockResult.failed);
+            break;
+        }
+        return result;
+    }
+
+    /**
+     * This function closes the backend
+     */
+    @Override
+    public void close() {
+        backend.close();
+    }
+}
@@ -0,0 +1,175 @@
+package de.bsi.seapi.nativebinding;
+
+import java.nio.ByteBuffer;
+import java.nio.file.Path;
+
+/**
+ * This interface defines the calls of the SE API backend that are used by NativeSEAPI. The calls correspond to the
+ * functions of SeApiBinding.h of the native backend and return its status codes, i.e. EXECUTION_OK or one of the
+ * values of de.bsi.seapi.ErrorCodes.
+ *
+ * Input data is passed as ByteBuffer whose content lies between its position and its limit. Direct buffers are
+ * read in place by the native backend, so that off-heap data is never copied on the Java side. Output values are
+ * written as 64-bit integers in native byte order to the results buffer, which has to be direct and hold at least
+ * RESULT_COUNT values.
+ */
+public interface SeApiBackend extends AutoCloseable {
+
+    /**
+     * Values of the operation parameter of logTransaction
+     */
+    int START = 1;
+    int UPDATE = 2;
+    int FINISH = 3;
+
+    /**
+     * Values of the filter parameter of exportData
+     */
+    int EXPORT_ALL = 0;
+    int EXPORT_TRANSACTIONS = 1;
+    int EXPORT_PERIOD = 2;
+
+    /**
+     * Indexes of the output values in the results buffer
+     */
+    int TRANSACTION_NUMBER = 0;
+    int SIGNATURE_COUNTER = 1;
+    int LOG_TIME = 2;
+    int LOG_MESSAGE_LENGTH = 3;
+    int RECEIPT_CODE_LENGTH = 3;
+    int RESULT = 0;
+    int REMAINING_RETRIES = 1;
+    int RESULT_COUNT = 4;
+
+    /**
+     * Bounds of exportData with the filter EXPORT_PERIOD that select an open period
+     */
+    long NO_START_TIME = Long.MIN_VALUE;
+    long NO_END_TIME = Long.MAX_VALUE;
+
+    /**
+     * This function sets the time of the backend and logs the update
+     * @param newTime new time in seconds since the epoch
+     * @param results receives the signature counter and the log time of the system log message
+     * @return status code of seApiBindingUpdateTime
+     */
+    short updateTime(long newTime, ByteBuffer results);
+
+    /**
+     * This function logs a transaction log message
+     * @param operation START, UPDATE or FINISH
+     * @param clientId ID of the client
+     * @param transactionNumber number of the transaction, ignored for START
+     * @param processData data of the process
+     * @param processType type of the process, may be null
+     * @param results receives the transaction number, the signature counter and the log time
+     * @return status code of seApiBindingLogTransaction
+     */
+    short logTransaction(int operation, ByteBuffer clientId, long transactionNumber, ByteBuffer processData,
+                         ByteBuffer processType, ByteBuffer results);
+
+    /**
+     * This function finishes a transaction and returns the receipt code of the transaction, i.e. the content of the
+     * QR code on the receipt. The receipt code is written to receiptCode from its position on if it fits into the
+     * remaining space; its length is returned in the results in any case
+     * @param clientId ID of the client
+     * @param transactionNumber number of the transaction
+     * @param processData data of the process
+     * @param processType type of the process, may be null
+     * @param receiptCode receives the receipt code, has to be direct
+     * @param results receives the transaction number, the signature counter, the log time and the length of the
+     *                receipt code
+     * @return status code of seApiBindingFinishTransaction
+     */
+    short finishTransaction(ByteBuffer clientId, long transactionNumber, ByteBuffer processData,
+                            ByteBuffer processType, ByteBuffer receiptCode, ByteBuffer results);
+
+    /**
+     * This function exports the stored data as TAR archive. The archive remains in memory of the backend and is
+     * handed to the caller by archive, which has to be closed to release it
+     * @param filter EXPORT_ALL, EXPORT_TRANSACTIONS or EXPORT_PERIOD
+     * @param start first transaction number or start time in seconds since the epoch
+     * @param end last transaction number or end time in seconds since the epoch
+     * @param clientId ID of the client whose log messages are selected, may be null
+     * @param maximumNumberRecords maximum number of log messages, 0 for no limit
+     * @param archive receives the exported archive
+     * @return status code of seApiBindingExport
+     */
+    short exportData(int filter, long start, long end, ByteBuffer clientId, long maximumNumberRecords,
+                     NativeArchive archive);
+
+    /**
+     * This function reads the last log message or the most recent log message of a client or a transaction. The
+     * payload is written to logMessage from its position on; if it is longer than the remaining space, nothing is
+     * written and the status ERROR_PARAMETER_MISMATCH is returned with the required length in the results
+     * @param clientId ID of the client, null for the last log message of all clients
+     * @param transactionNumber number of the transaction of the client, 0 for any transaction
+     * @param logMessage receives the payload of the log message, has to be direct
+     * @param results receives the transaction number, the signature counter, the log time and the length of the
+     *                log message
+     * @return status code of seApiBindingReadLogMessage
+     */
+    short readLogMessage(ByteBuffer clientId, long transactionNumber, ByteBuffer logMessage, ByteBuffer results);
+
+    /**
+     * This function authenticates a user
+     * @param userId ID of the user
+     * @param pin PIN of the user
+     * @param results receives the authentication result and the remaining retries
+     * @return status code of seApiBindingAuthenticateUser
+     */
+    short authenticateUser(ByteBuffer userId, ByteBuffer pin, ByteBuffer results);
+
+    /**
+     * This function logs out a user
+     * @param userId ID of the user
+     * @return status code of seApiBindingLogOut
+     */
+    short logOut(ByteBuffer userId);
+
+    /**
+     * This function unblocks the PIN of a user
+     * @param userId ID of the user
+     * @param puk PUK of the user
+     * @param newPin new PIN of the user
+     * @param results receives the unblock result
+     * @return status code of seApiBindingUnblockUser
+     */
+    short unblockUser(ByteBuffer userId, ByteBuffer puk, ByteBuffer newPin, ByteBuffer results);
+
+    /**
+     * This function deletes the exported data on behalf of an authenticated user
+     * @param userId ID of the user, may be null if no user is authenticated
+     * @return status code of seApiBindingDeleteStoredData
+     */
+    short deleteStoredData(ByteBuffer userId);
+
+    /**
+     * This function determines the number of open transactions
+     * @param results receives the number of open transactions at index 0
+     * @return status code of seApiBindingCurrentNumberOfTransactions
+     */
+    short getCurrentNumberOfTransactions(ByteBuffer results);
+
+    /**
+     * This function closes the backend
+     */
+    @Override
+    void close();
+
+    /**
+     * This function opens the native backend in a directory. The Foreign Function &amp; Memory API is used if it is
+     * available, otherwise the JNI implementation
+     * @param library path of the shared library of the native backend
+     * @param directory directory of the stored data
+     * @return opened backend
+     * @throws IllegalStateException if the backend could not be opened
+     */
+    static SeApiBackend open(Path library, Path directory) {
+        try {
+            return FfmSeApiBackend.open(library, directory);
+        } catch (LinkageError | UnsupportedOperationException e) {
+            return JniSeApiBackend.open(library, directory);
+        }
+    }
+}
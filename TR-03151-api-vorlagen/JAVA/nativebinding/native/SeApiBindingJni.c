@@ -0,0 +1,252 @@
+#include <stdint.h>
+#include <jni.h>
+
+#include "../../../ANSI_C/backend/SeApiBinding.h"
+
+/*
+ * JNI functions of de.bsi.seapi.nativebinding.JniSeApiBackend. The buffers are direct buffers whose memory is
+ * passed to the backend in place; the position and the length of their content are passed by the Java side.
+ */
+
+static const unsigned char *jniBufferData(JNIEnv *env,
+                                          jobject buffer,
+                                          jint position)
+{
+    unsigned char *address;
+
+    if (buffer == NULL) {
+        return NULL;
+    }
+    address = (*env)->GetDirectBufferAddress(env, buffer);
+    return address != NULL ? address + position : NULL;
+}
+
+static int64_t *jniResults(JNIEnv *env,
+                           jobject results)
+{
+    return (int64_t *) (*env)->GetDirectBufferAddress(env, results);
+}
+
+static struct SeApiBinding *jniBinding(jlong binding)
+{
+    return (struct SeApiBinding *) (intptr_t) binding;
+}
+
+JNIEXPORT jshort JNICALL Java_de_bsi_seapi_nativebinding_JniSeApiBackend_nativeOpen(JNIEnv *env,
+                                                                                   jclass type,
+                                                                                   jbyteArray directory,
+                                                                                   jobject results)
+{
+    jsize length = (*env)->GetArrayLength(env, directory);
+    char path[4096];
+
+    (void) type;
+    if (length <= 0 || (size_t) length >= sizeof path) {
+        return ERROR_PARAMETER_MISMATCH;
+    }
+    (*env)->GetByteArrayRegion(env, directory, 0, length, (jbyte *) path);
+    path[length] = '\0';
+    return seApiBindingOpen(path, jniResults(env, results));
+}
+
+JNIEXPORT jshort JNICALL Java_de_bsi_seapi_nativebinding_JniSeApiBackend_nativeClose(JNIEnv *env,
+                                                                                    jclass type,
+                                                                                    jlong binding)
+{
+    (void) env;
+    (void) type;
+    return seApiBindingClose(jniBinding(binding));
+}
+
+JNIEXPORT jshort JNICALL Java_de_bsi_seapi_nativebinding_JniSeApiBackend_nativeUpdateTime(JNIEnv *env,
+                                                                                         jclass type,
+                                                                                         jlong binding,
+                                                                                         jlong newTime,
+                                                                                         jobject results)
+{
+    (void) type;
+    return seApiBindingUpdateTime(jniBinding(binding), newTime, jniResults(env, results));
+}
+
+JNIEXPORT jshort JNICALL Java_de_bsi_seapi_nativebinding_JniSeApiBackend_nativeLogTransaction(JNIEnv *env,
+                                                                                             jclass type,
+                                                                                             jlong binding,
+                                                                                             jint operation,
+                                                                                             jobject clientId,
+                                                                                             jint clientIdPosition,
+                                                                                             jint clientIdLength,
+                                                                                             jlong transactionNumber,
+                                                                                             jobject processData,
+                                                                                             jint processDataPosition,
+                                                                                             jint processDataLength,
+                                                                                             jobject processType,
+                                                                                             jint processTypePosition,
+                                                                                             jint processTypeLength,
+                                                                                             jobject results)
+{
+    (void) type;
+    return seApiBindingLogTransaction(jniBinding(binding), (uint32_t) operation,
+                                      jniBufferData(env, clientId, clientIdPosition), (uint64_t) clientIdLength,
+                                      (uint64_t) transactionNumber,
+                                      jniBufferData(env, processData, processDataPosition),
+                                      (uint64_t) processDataLength,
+                                      jniBufferData(env, processType, processTypePosition),
+                                      (uint64_t) processTypeLength, jniResults(env, results));
+}
+
+JNIEXPORT jshort JNICALL
+Java_de_bsi_seapi_nativebinding_JniSeApiBackend_nativeFinishTransaction(JNIEnv *env,
+                                                                        jclass type,
+                                                                        jlong binding,
+                                                                        jobject clientId,
+                                                                        jint clientIdPosition,
+                                                                        jint clientIdLength,
+                                                                        jlong transactionNumber,
+                                                                        jobject processData,
+                                                                        jint processDataPosition,
+                                                                        jint processDataLength,
+                                                                        jobject processType,
+                                                                        jint processTypePosition,
+                                                                        jint processTypeLength,
+                                                                        jobject receiptCode,
+                                                                        jint receiptCodePosition,
+                                                                        jint receiptCodeCapacity,
+                                                                        jobject results)
+{
+    (void) type;
+    return seApiBindingFinishTransaction(jniBinding(binding), jniBufferData(env, clientId, clientIdPosition),
+                                         (uint64_t) clientIdLength, (uint64_t) transactionNumber,
+                                         jniBufferData(env, processData, processDataPosition),
+                                         (uint64_t) processDataLength,
+                                         jniBufferData(env, processType, processTypePosition),
+                                         (uint64_t) processTypeLength,
+                                         (char *) jniBufferData(env, receiptCode, receiptCodePosition),
+                                         (uint64_t) receiptCodeCapacity, jniResults(env, results));
+}
+
+JNIEXPORT jshort JNICALL Java_de_bsi_seapi_nativebinding_JniSeApiBackend_nativeExport(JNIEnv *env,
+                                                                                     jclass type,
+                                                                                     jlong binding,
+                                                                                     jint filter,
+                                                                                     jlong start,
+                                                                                     jlong end,
+                                                                                     jobject clientId,
+                                                                                     jint clientIdPosition,
+                                                                                     jint clientIdLength,
+                                                                                     jlong maximumNumberRecords,
+                                                                                     jobject results)
+{
+    (void) type;
+    return seApiBindingExport(jniBinding(binding), (uint32_t) filter, start, end,
+                              jniBufferData(env, clientId, clientIdPosition), (uint64_t) clientIdLength,
+                              maximumNumberRecords, jniResults(env, results));
+}
+
+JNIEXPORT jobject JNICALL Java_de_bsi_seapi_nativebinding_JniSeApiBackend_nativeWrap(JNIEnv *env,
+                                                                                   jclass type,
+                                                                                   jlong address,
+                                                                                   jlong length)
+{
+    (void) type;
+    return (*env)->NewDirectByteBuffer(env, (void *) (intptr_t) address, length);
+}
+
+JNIEXPORT void JNICALL Java_de_bsi_seapi_nativebinding_JniSeApiBackend_nativeFreeExport(JNIEnv *env,
+                                                                                       jclass type,
+                                                                                       jlong address)
+{
+    (void) env;
+    (void) type;
+    seApiBindingFreeExport((unsigned char *) (intptr_t) address);
+}
+
+JNIEXPORT jshort JNICALL Java_de_bsi_seapi_nativebinding_JniSeApiBackend_nativeReadLogMessage(JNIEnv *env,
+                                                                                             jclass type,
+                                                                                             jlong binding,
+                                                                                             jobject clientId,
+                                                                                             jint clientIdPosition,
+                                                                                             jint clientIdLength,
+                                                                                             jlong transactionNumber,
+                                                                                             jobject logMessage,
+                                                                                             jint logMessagePosition,
+                                                                                             jint logMessageCapacity,
+                                                                                             jobject results)
+{
+    (void) type;
+    return seApiBindingReadLogMessage(jniBinding(binding), jniBufferData(env, clientId, clientIdPosition),
+                                      (uint64_t) clientIdLength, (uint64_t) transactionNumber,
+                                      (unsigned char *) jniBufferData(env, logMessage, logMessagePosition),
+                                      (uint64_t) logMessageCapacity, jniResults(env, results));
+}
+
+JNIEXPORT jshort JNICALL Java_de_bsi_seapi_nativebinding_JniSeApiBackend_nativeAuthenticateUser(JNIEnv *env,
+                                                                                               jclass type,
+                                                                                               jlong binding,
+                                                                                               jobject userId,
+                                                                                               jint userIdPosition,
+                                                                                               jint userIdLength,
+                                                                                               jobject pin,
+                                                                                               jint pinPosition,
+                                                                                               jint pinLength,
+                                                                                               jobject results)
+{
+    (void) type;
+    return seApiBindingAuthenticateUser(jniBinding(binding), jniBufferData(env, userId, userIdPosition),
+                                        (uint64_t) userIdLength, jniBufferData(env, pin, pinPosition),
+                                        (uint64_t) pinLength, jniResults(env, results));
+}
+
+JNIEXPORT jshort JNICALL Java_de_bsi_seapi_nativebinding_JniSeApiBackend_nativeLogOut(JNIEnv *env,
+                                                                                     jclass type,
+                                                                                     jlong binding,
+                                                                                     jobject userId,
+                                                                                     jint userIdPosition,
+                                                                                     jint userIdLength)
+{
+    (void) type;
+    return seApiBindingLogOut(jniBinding(binding), jniBufferData(env, userId, userIdPosition),
+                              (uint64_t) userIdLength);
+}
+
+JNIEXPORT jshort JNICALL Java_de_bsi_seapi_nativebinding_JniSeApiBackend_nativeUnblockUser(JNIEnv *env,
+                                                                                          jclass type,
+                                                                                          jlong binding,
+                                                                                          jobject userId,
+                                                                                          jint userIdPosition,
+                                                                                          jint userIdLength,
+                                                                                          jobject puk,
+                                                                                          jint pukPosition,
+                                                                                          jint pukLength,
+                                                                                          jobject newPin,
+                                                                                          jint newPinPosition,
+                                                                                          jint newPinLength,
+                                                                                          jobject results)
+{
+    (void) type;
+    return seApiBindingUnblockUser(jniBinding(binding), jniBufferData(env, userId, userIdPosition),
+                                   (uint64_t) userIdLength, jniBufferData(env, puk, pukPosition),
+                                   (uint64_t) pukLength, jniBufferData(env, newPin, newPinPosition),
+                                   (uint64_t) newPinLength, jniResults(env, results));
+}
+
+JNIEXPORT jshort JNICALL Java_de_bsi_seapi_nativebinding_JniSeApiBackend_nativeDeleteStoredData(JNIEnv *env,
+                                                                                               jclass type,
+                                                                                               jlong binding,
+                                                                                               jobject userId,
+                                                                                               jint userIdPosition,
+                                                                                               jint userIdLength)
+{
+    (void) type;
+    return seApiBindingDeleteStoredData(jniBinding(binding), jniBufferData(env, userId, userIdPosition),
+                                        (uint64_t) userIdLength);
+}
+
+JNIEXPORT jshort JNICALL
+Java_de_bsi_seapi_nativebinding_JniSeApiBackend_nativeCurrentNumberOfTransactions(JNIEnv *env,
+                                                                                  jclass type,
+                                                                                  jlong binding,
+                                                                                  jobject results)
+{
+    (void) type;
+    return seApiBindingCurrentNumberOfTransactions(jniBinding(binding), jniResults(env, results));
+}
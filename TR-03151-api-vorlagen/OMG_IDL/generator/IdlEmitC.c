@@ -0,0 +1,665 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "IdlEmitter.h"
+
+/**
+ * Size of one C parameter declaration and maximum number of declarations of a function, since arrays are passed
+ * as address and length
+ */
+#define IDL_C_DECLARATION_SIZE 256
+#define IDL_C_MAX_DECLARATIONS (2 * IDL_MAX_PARAMETERS + 1)
+
+/**
+ * Indentation of the continuation lines of the documentation of parameters, exceptions and return values
+ */
+#define IDL_C_TAG_TEXT " *                "
+#define IDL_C_RETURN_TEXT " *         "
+
+static void idlWriteCBanner(FILE *file,
+                            const struct IdlModule *module)
+{
+    fprintf(file, "/*\n * Generated by idlgen from the IDL module %s. Do not edit.\n */\n\n", module->name);
+}
+
+static void idlWriteCComment(FILE *file,
+                             const char *documentation)
+{
+    char line[IDL_LINE_SIZE];
+
+    fputs("/**\n", file);
+    while (idlNextLine(&documentation, line)) {
+        fprintf(file, line[0] != '\0' ? " * %s\n" : " *\n", line);
+    }
+    fputs(" */\n", file);
+}
+
+static const struct IdlParameter *idlFindParameter(const struct IdlOperation *operation,
+                                                   const char *name)
+{
+    unsigned int i;
+
+    for (i = 0; i < operation->parameterCount; i++) {
+        if (strcmp(operation->parameters[i].name, name) == 0) {
+            return &operation->parameters[i];
+        }
+    }
+    return NULL;
+}
+
+static void idlWriteCLengthComment(FILE *file,
+                                   const struct IdlParameter *parameter)
+{
+    if (parameter == NULL) {
+        return;
+    }
+    fprintf(file, " * @param[%s] %sLength\n", parameter->direction == idlIn ? "in" : "out", parameter->name);
+    fprintf(file, IDL_C_TAG_TEXT "length of the array that represents the %s [REQUIRED]\n", parameter->name);
+}
+
+/**
+ * Writes the documentation of an operation in the form of SEAPI.h: parameters get their direction, arrays the
+ * documentation of their length and the raised exceptions are listed as error codes.
+ */
+static void idlWriteCOperationComment(FILE *file,
+                                      const struct IdlOperation *operation)
+{
+    enum {
+    idlSectionText, idlSectionTag, idlSectionReturn
+    } section = idlSectionText;
+    const struct IdlParameter *pendingLength = NULL;
+    const char *documentation = operation->documentation;
+    char line[IDL_LINE_SIZE];
+    char word[IDL_NAME_SIZE];
+    char code[IDL_GENERATED_NAME_SIZE];
+    bool raisesStarted = false;
+    const char *rest;
+
+    fputs("/**\n", file);
+    while (idlNextLine(&documentation, line)) {
+        if ((rest = idlTagLine(line, "@param", word)) != NULL) {
+            const struct IdlParameter *parameter = idlFindParameter(operation, word);
+
+            idlWriteCLengthComment(file, pendingLength);
+            fprintf(file, " * @param[%s] %s\n", parameter != NULL && parameter->direction == idlOut ? "out" : "in",
+                    word);
+            if (*rest != '\0') {
+                fprintf(file, IDL_C_TAG_TEXT "%s\n", rest);
+            }
+            pendingLength = parameter != NULL && idlHasLength(parameter) ? parameter : NULL;
+            section = idlSectionTag;
+        } else if (strncmp(line, "@return", 7) == 0) {
+            idlWriteCLengthComment(file, pendingLength);
+            pendingLength = NULL;
+            fprintf(file, " * @return %s\n", line + (line[7] == ' ' ? 8 : 7));
+            section = idlSectionReturn;
+        } else if ((rest = idlTagLine(line, "@raises", word)) != NULL) {
+            idlWriteCLengthComment(file, pendingLength);
+            pendingLength = NULL;
+            if (!raisesStarted) {
+                fputs(" *\n" IDL_C_RETURN_TEXT "If the execution of the function has failed, the appropriate error code "
+                      "SHALL be returned:\n *\n", file);
+                raisesStarted = true;
+            }
+            idlUpperSnakeCase(word, code);
+            fprintf(file, " *             %s\n", code);
+            if (*rest != '\0') {
+                fprintf(file, IDL_C_TAG_TEXT "%s\n", rest);
+            }
+            section = idlSectionTag;
+        } else if (line[0] == '\0') {
+            fputs(" *\n", file);
+        } else {
+            fprintf(file, section == idlSectionText ? " * %s\n"
+                          : section == idlSectionReturn ? IDL_C_RETURN_TEXT "%s\n" : IDL_C_TAG_TEXT "%s\n", line);
+        }
+    }
+    idlWriteCLengthComment(file, pendingLength);
+    fputs(" */\n", file);
+}
+
+static void idlCType(const struct IdlModule *module,
+                     const struct IdlParameter *parameter,
+                     char *result)
+{
+    switch (parameter->type) {
+    case idlShort:
+        strcpy(result, "short int");
+        break;
+    case idlLong:
+        strcpy(result, "long int");
+        break;
+    case idlUnsignedLong:
+        strcpy(result, "unsigned long int");
+        break;
+    case idlString:
+    case idlOctetSequence:
+        strcpy(result, "unsigned char");
+        break;
+    case idlDateTime:
+        strcpy(result, "struct tm");
+        break;
+    case idlEnum:
+        sprintf(result, "enum %s", module->enums[parameter->enumIndex].name);
+        break;
+    }
+}
+
+/**
+ * Returns the declarations of the parameters of the C function of an operation.
+ */
+static unsigned int idlCDeclarations(const struct IdlModule *module,
+                                     const struct IdlOperation *operation,
+                                     char declarations[][IDL_C_DECLARATION_SIZE])
+{
+    unsigned int count = 0;
+    unsigned int i;
+
+    for (i = 0; i < operation->parameterCount; i++) {
+        const struct IdlParameter *parameter = &operation->parameters[i];
+        const char *pointer = parameter->direction == idlOut ? "*" : "";
+        char type[IDL_GENERATED_NAME_SIZE];
+
+        idlCType(module, parameter, type);
+        if (idlHasLength(parameter)) {
+            sprintf(declarations[count++], "%s *%s%s", type, pointer, parameter->name);
+            sprintf(declarations[count++], "unsigned long int %s%sLength", pointer, parameter->name);
+        } else if (parameter->type == idlDateTime) {
+            sprintf(declarations[count++], "%s *%s", type, parameter->name);
+        } else {
+            sprintf(declarations[count++], "%s %s%s", type, pointer, parameter->name);
+        }
+    }
+    return count;
+}
+
+/**
+ * Writes a list of parameters or arguments, one per line and aligned to the opening parenthesis.
+ */
+static void idlWriteCList(FILE *file,
+                          const char *opening,
+                          char items[][IDL_C_DECLARATION_SIZE],
+                          unsigned int count,
+                          const char *empty,
+                          const char *closing)
+{
+    unsigned int i;
+
+    fputs(opening, file);
+    if (count == 0) {
+        fprintf(file, "%s%s", empty, closing);
+        return;
+    }
+    for (i = 0; i < count; i++) {
+        if (i > 0) {
+            fprintf(file, ",\n%*s", (int) strlen(opening), "");
+        }
+        fputs(items[i], file);
+    }
+    fputs(closing, file);
+}
+
+static bool idlEmitSeApiHeader(const struct IdlModule *module,
+                               const char *directory,
+                               char *error,
+                               size_t errorSize)
+{
+    char declarations[IDL_C_MAX_DECLARATIONS][IDL_C_DECLARATION_SIZE];
+    char name[IDL_GENERATED_NAME_SIZE];
+    char opening[IDL_GENERATED_NAME_SIZE + 16];
+    FILE *file = idlCreateFile(directory, "SEAPI.h", error, errorSize);
+    unsigned int i;
+    unsigned int j;
+
+    if (file == NULL) {
+        return false;
+    }
+    idlWriteCBanner(file, module);
+    fputs("#ifndef SEAPI_H\n#define SEAPI_H\n\n#include <stdbool.h>\n#include <stdint.h>\n#include <time.h>\n\n"
+          "#include \"Exception.h\"\n#include \"Constant.h\"\n\n", file);
+    fputs("/**\n * This header file defines the different functions of the Secure Element API (SE API)\n */\n", file);
+    for (i = 0; i < module->enumCount; i++) {
+        fputs("\n", file);
+        idlWriteCComment(file, module->enums[i].documentation);
+        fprintf(file, "enum %s {\n", module->enums[i].name);
+        for (j = 0; j < module->enums[i].valueCount; j++) {
+            idlCEnumValueName(module, i, j, name);
+            fprintf(file, "%s%s", j > 0 ? ", " : "", name);
+        }
+        fputs("\n};\n", file);
+    }
+    for (i = 0; i < module->operationCount; i++) {
+        fputs("\n", file);
+        idlWriteCOperationComment(file, &module->operations[i]);
+        idlCOperationName(module, i, name);
+        snprintf(opening, sizeof opening, "short int %s(", name);
+        idlWriteCList(file, opening, declarations, idlCDeclarations(module, &module->operations[i], declarations),
+                      "void", ");\n");
+    }
+    fputs("\n#endif\n", file);
+    return idlCloseFile(file, "SEAPI.h", error, errorSize);
+}
+
+static bool idlEmitExceptionHeader(const struct IdlModule *module,
+                                   const char *directory,
+                                   char *error,
+                                   size_t errorSize)
+{
+    static char documentation[IDL_DOCUMENTATION_SIZE + IDL_GENERATED_NAME_SIZE];
+    char code[IDL_GENERATED_NAME_SIZE];
+    char subject[2 * IDL_GENERATED_NAME_SIZE];
+    FILE *file = idlCreateFile(directory, "Exception.h", error, errorSize);
+    unsigned int i;
+
+    if (file == NULL) {
+        return false;
+    }
+    idlWriteCBanner(file, module);
+    fputs("#ifndef SEAPI_EXCEPTION_H\n#define SEAPI_EXCEPTION_H\n\n", file);
+    fputs("/**\n * This header file defines error codes that are returned in form of return values by the\n"
+          " * functions of the Secure Element API(SE API) in a particular case of failure\n */\n", file);
+    for (i = 0; i < module->exceptionCount; i++) {
+        idlExceptionCodeName(module, i, code);
+        snprintf(subject, sizeof subject, "The return value %s indicates that", code);
+        idlExceptionDocumentation(&module->exceptions[i], subject, documentation);
+        fputs("\n", file);
+        idlWriteCComment(file, documentation);
+        fprintf(file, "#define %s %ld\n", code, idlExceptionCode(i));
+    }
+    fputs("\n#endif\n", file);
+    return idlCloseFile(file, "Exception.h", error, errorSize);
+}
+
+static bool idlEmitConstantHeader(const struct IdlModule *module,
+                                  const char *directory,
+                                  char *error,
+                                  size_t errorSize)
+{
+    FILE *file = idlCreateFile(directory, "Constant.h", error, errorSize);
+    unsigned int i;
+
+    if (file == NULL) {
+        return false;
+    }
+    idlWriteCBanner(file, module);
+    fputs("#ifndef SEAPI_CONSTANT_H\n#define SEAPI_CONSTANT_H\n", file);
+    for (i = 0; i < module->constantCount; i++) {
+        fputs("\n", file);
+        idlWriteCComment(file, module->constants[i].documentation);
+        fprintf(file, "#define %s %ld\n", module->constants[i].name, module->constants[i].value);
+    }
+    fputs("\n#endif\n", file);
+    return idlCloseFile(file, "Constant.h", error, errorSize);
+}
+
+static void idlWireOperationName(const struct IdlModule *module,
+                                 unsigned int operationIndex,
+                                 const char *prefix,
+                                 char *result)
+{
+    char name[IDL_GENERATED_NAME_SIZE];
+
+    idlCOperationName(module, operationIndex, name);
+    idlUpperFirst(name, result + sprintf(result, "%s", prefix));
+}
+
+static bool idlEmitWireHeader(const struct IdlModule *module,
+                              const char *directory,
+                              char *error,
+                              size_t errorSize)
+{
+    char declarations[IDL_C_MAX_DECLARATIONS + 1][IDL_C_DECLARATION_SIZE];
+    char name[2 * IDL_GENERATED_NAME_SIZE];
+    char cName[IDL_GENERATED_NAME_SIZE];
+    char opening[2 * IDL_GENERATED_NAME_SIZE + 16];
+    FILE *file = idlCreateFile(directory, "SeApiWire.h", error, errorSize);
+    unsigned int i;
+
+    if (file == NULL) {
+        return false;
+    }
+    idlWriteCBanner(file, module);
+    fputs("#ifndef SEAPI_WIRE_H\n#define SEAPI_WIRE_H\n\n#include <stddef.h>\n\n#include \"SEAPI.h\"\n"
+          "#include \"SeApiWireRuntime.h\"\n\n", file);
+    fputs("/**\n"
+          " * This header file defines the stubs and the skeleton of the wire protocol of the SE API. A stub has the\n"
+          " * parameters of the SE API function of the same name and executes it through the transport of a client.\n"
+          " * Output arrays are allocated by the stub and released by the caller with free.\n"
+          " */\n\n", file);
+    fputs("/**\n * Numbers of the operations on the wire\n */\nenum SeApiWireOperation {\n", file);
+    for (i = 0; i < module->operationCount; i++) {
+        idlWireOperationName(module, i, "seApiWire", name);
+        fprintf(file, "%s = %u%s\n", name, i, i + 1 < module->operationCount ? "," : "");
+    }
+    fputs("};\n", file);
+    for (i = 0; i < module->operationCount; i++) {
+        idlCOperationName(module, i, cName);
+        idlWireOperationName(module, i, "seApiStub", name);
+        strcpy(declarations[0], "struct SeApiWireClient *client");
+        fprintf(file, "\n/**\n * Stub of %s\n */\n", cName);
+        snprintf(opening, sizeof opening, "short int %s(", name);
+        idlWriteCList(file, opening, declarations,
+                      1 + idlCDeclarations(module, &module->operations[i], declarations + 1), "", ");\n");
+    }
+    fputs("\n/**\n"
+          " * Decodes a request, executes the SE API function and encodes its response. Output arrays returned by the\n"
+          " * SE API functions are released with free after they have been encoded. The function has the type\n"
+          " * SeApiWireTransport, so that a client can call it directly.\n"
+          " * @param[in] context\n"
+          IDL_C_TAG_TEXT "not used [OPTIONAL]\n"
+          " * @param[in] request\n"
+          IDL_C_TAG_TEXT "encoded request [REQUIRED]\n"
+          " * @param[in] requestLength\n"
+          IDL_C_TAG_TEXT "length of the array that represents the request [REQUIRED]\n"
+          " * @param[out] response\n"
+          IDL_C_TAG_TEXT "receives the encoded response [REQUIRED]\n"
+          " * @return EXECUTION_OK if the response has been encoded, ERROR_PARAMETER_MISMATCH if the request is\n"
+          IDL_C_RETURN_TEXT "malformed or ERROR_STORAGE_FAILURE if the response cannot be allocated\n"
+          " */\n"
+          "short int seApiSkeletonDispatch(void *context,\n"
+          "                                const unsigned char *request,\n"
+          "                                size_t requestLength,\n"
+          "                                struct SeApiWireWriter *response);\n", file);
+    fputs("\n#endif\n", file);
+    return idlCloseFile(file, "SeApiWire.h", error, errorSize);
+}
+
+static bool idlHasEnum(const struct IdlOperation *operation,
+                       enum IdlDirection direction)
+{
+    unsigned int i;
+
+    for (i = 0; i < operation->parameterCount; i++) {
+        if (operation->parameters[i].direction == direction && operation->parameters[i].type == idlEnum) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool idlHasOutputs(const struct IdlOperation *operation)
+{
+    unsigned int i;
+
+    for (i = 0; i < operation->parameterCount; i++) {
+        if (operation->parameters[i].direction == idlOut) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Writes the encoding of a value. The expression of the value is the name of the parameter, prefixed by
+ * valuePrefix for values that are passed by pointer.
+ */
+static void idlWriteCEncode(FILE *file,
+                            const struct IdlParameter *parameter,
+                            const char *writer,
+                            const char *valuePrefix,
+                            const char *timePrefix)
+{
+    const char *name = parameter->name;
+
+    switch (parameter->type) {
+    case idlShort:
+    case idlLong:
+        fprintf(file, "    seApiWirePutSigned(%s, %s%s);\n", writer, valuePrefix, name);
+        break;
+    case idlUnsignedLong:
+        fprintf(file, "    seApiWirePutUnsigned(%s, %s%s);\n", writer, valuePrefix, name);
+        break;
+    case idlEnum:
+        fprintf(file, "    seApiWirePutUnsigned(%s, (uint64_t) %s%s);\n", writer, valuePrefix, name);
+        break;
+    case idlString:
+    case idlOctetSequence:
+        fprintf(file, "    seApiWirePutBytes(%s, %s%s, %s%sLength);\n", writer, valuePrefix, name, valuePrefix, name);
+        break;
+    case idlDateTime:
+        fprintf(file, "    seApiWirePutTime(%s, %s%s);\n", writer, timePrefix, name);
+        break;
+    }
+}
+
+/**
+ * Writes the decoding of a value into the parameter, prefixed by targetPrefix for values that are passed by pointer.
+ */
+static void idlWriteCDecode(FILE *file,
+                            const struct IdlModule *module,
+                            const struct IdlParameter *parameter,
+                            const char *reader,
+                            const char *targetPrefix,
+                            const char *timePrefix,
+                            bool copyBytes)
+{
+    const char *name = parameter->name;
+    char type[IDL_GENERATED_NAME_SIZE];
+    char last[IDL_GENERATED_NAME_SIZE];
+
+    idlCType(module, parameter, type);
+    switch (parameter->type) {
+    case idlShort:
+    case idlLong:
+        fprintf(file, "    %s%s = (%s) seApiWireGetSigned(%s);\n", targetPrefix, name, type, reader);
+        break;
+    case idlUnsignedLong:
+        fprintf(file, "    %s%s = (%s) seApiWireGetUnsigned(%s);\n", targetPrefix, name, type, reader);
+        break;
+    case idlEnum:
+        idlCEnumValueName(module, parameter->enumIndex, module->enums[parameter->enumIndex].valueCount - 1, last);
+        fprintf(file, "    value = seApiWireGetUnsigned(%s);\n", reader);
+        /* the reader is either a pointer or the address of a local variable */
+        if (reader[0] == '&') {
+            fprintf(file, "    if (value > (uint64_t) %s) {\n        %s.result = ERROR_PARAMETER_MISMATCH;\n    }\n",
+                    last, reader + 1);
+        } else {
+            fprintf(file, "    if (value > (uint64_t) %s) {\n        %s->result = ERROR_PARAMETER_MISMATCH;\n    }\n",
+                    last, reader);
+        }
+        fprintf(file, "    %s%s = (%s) value;\n", targetPrefix, name, type);
+        break;
+    case idlString:
+    case idlOctetSequence:
+        if (copyBytes) {
+            fprintf(file, "    %s%s = seApiWireCopyBytes(%s, %sLength);\n", targetPrefix, name, reader, name);
+        } else {
+            fprintf(file, "    %s = seApiWireGetBytes(%s, &%sLength);\n", name, reader, name);
+        }
+        break;
+    case idlDateTime:
+        fprintf(file, "    seApiWireGetTime(%s, %s%s);\n", reader, timePrefix, name);
+        break;
+    }
+}
+
+static void idlWriteStub(FILE *file,
+                         const struct IdlModule *module,
+                         unsigned int operationIndex)
+{
+    const struct IdlOperation *operation = &module->operations[operationIndex];
+    char declarations[IDL_C_MAX_DECLARATIONS + 1][IDL_C_DECLARATION_SIZE];
+    char name[2 * IDL_GENERATED_NAME_SIZE];
+    char opening[2 * IDL_GENERATED_NAME_SIZE + 16];
+    unsigned int i;
+
+    idlWireOperationName(module, operationIndex, "seApiStub", name);
+    strcpy(declarations[0], "struct SeApiWireClient *client");
+    snprintf(opening, sizeof opening, "short int %s(", name);
+    fputs("\n", file);
+    idlWriteCList(file, opening, declarations, 1 + idlCDeclarations(module, operation, declarations + 1), "", ")\n");
+    fputs("{\n    struct SeApiWireReader response;\n", file);
+    if (idlHasEnum(operation, idlOut)) {
+        fputs("    uint64_t value;\n", file);
+    }
+    fputs("    short int result;\n\n    seApiWireWriterReset(&client->request);\n", file);
+    idlWireOperationName(module, operationIndex, "seApiWire", name);
+    fprintf(file, "    seApiWirePutUnsigned(&client->request, %s);\n", name);
+    for (i = 0; i < operation->parameterCount; i++) {
+        if (operation->parameters[i].direction == idlIn) {
+            idlWriteCEncode(file, &operation->parameters[i], "&client->request", "", "");
+        }
+    }
+    fputs("    result = seApiWireClientCall(client, &response);\n", file);
+    if (!idlHasOutputs(operation)) {
+        fputs("    return result;\n}\n", file);
+        return;
+    }
+    fputs("    if (!seApiWireHasOutputs(result)) {\n        return result;\n    }\n", file);
+    for (i = 0; i < operation->parameterCount; i++) {
+        if (operation->parameters[i].direction == idlOut) {
+            idlWriteCDecode(file, module, &operation->parameters[i], "&response", "*", "", true);
+        }
+    }
+    fputs("    if (response.result != EXECUTION_OK) {\n", file);
+    for (i = 0; i < operation->parameterCount; i++) {
+        const struct IdlParameter *parameter = &operation->parameters[i];
+
+        if (parameter->direction == idlOut && idlHasLength(parameter)) {
+            fprintf(file, "        free(*%s);\n        *%s = NULL;\n        *%sLength = 0;\n", parameter->name,
+                    parameter->name, parameter->name);
+        }
+    }
+    fputs("        return response.result;\n    }\n    return result;\n}\n", file);
+}
+
+static void idlWriteSkeleton(FILE *file,
+                             const struct IdlModule *module,
+                             unsigned int operationIndex)
+{
+    const struct IdlOperation *operation = &module->operations[operationIndex];
+    char arguments[IDL_C_MAX_DECLARATIONS][IDL_C_DECLARATION_SIZE];
+    char name[2 * IDL_GENERATED_NAME_SIZE];
+    char opening[2 * IDL_GENERATED_NAME_SIZE + 16];
+    char type[IDL_GENERATED_NAME_SIZE];
+    char first[IDL_GENERATED_NAME_SIZE];
+    unsigned int argumentCount = 0;
+    unsigned int i;
+
+    idlWireOperationName(module, operationIndex, "seApiSkeleton", name);
+    fprintf(file, "\nstatic short int %s(struct SeApiWireReader *request,\n%*sstruct SeApiWireWriter *response)\n{\n",
+            name, (int) strlen(name) + 18, "");
+    for (i = 0; i < operation->parameterCount; i++) {
+        const struct IdlParameter *parameter = &operation->parameters[i];
+
+        idlCType(module, parameter, type);
+        if (idlHasLength(parameter) && parameter->direction == idlIn) {
+            fprintf(file, "    const unsigned char *%s;\n    uint64_t %sLength;\n", parameter->name, parameter->name);
+        } else if (idlHasLength(parameter)) {
+            fprintf(file, "    unsigned char *%s = NULL;\n    unsigned long int %sLength = 0;\n", parameter->name,
+                    parameter->name);
+        } else if (parameter->type == idlDateTime || parameter->direction == idlIn) {
+            fprintf(file, "    %s %s;\n", type, parameter->name);
+        } else if (parameter->type == idlEnum) {
+            idlCEnumValueName(module, parameter->enumIndex, 0, first);
+            fprintf(file, "    %s %s = %s;\n", type, parameter->name, first);
+        } else {
+            fprintf(file, "    %s %s = 0;\n", type, parameter->name);
+        }
+    }
+    if (idlHasEnum(operation, idlIn)) {
+        fputs("    uint64_t value;\n", file);
+    }
+    fputs("    short int result;\n\n", file);
+    for (i = 0; i < operation->parameterCount; i++) {
+        if (operation->parameters[i].direction == idlIn) {
+            idlWriteCDecode(file, module, &operation->parameters[i], "request", "", "&", false);
+        }
+    }
+    fputs("    if (request->result != EXECUTION_OK) {\n        return request->result;\n    }\n", file);
+    for (i = 0; i < operation->parameterCount; i++) {
+        const struct IdlParameter *parameter = &operation->parameters[i];
+
+        if (parameter->direction == idlOut && parameter->type == idlDateTime) {
+            fprintf(file, "    memset(&%s, 0, sizeof %s);\n", parameter->name, parameter->name);
+        }
+        if (idlHasLength(parameter) && parameter->direction == idlIn) {
+            sprintf(arguments[argumentCount++], "(unsigned char *) %s", parameter->name);
+            sprintf(arguments[argumentCount++], "(unsigned long int) %sLength", parameter->name);
+        } else if (idlHasLength(parameter)) {
+            sprintf(arguments[argumentCount++], "&%s", parameter->name);
+            sprintf(arguments[argumentCount++], "&%sLength", parameter->name);
+        } else if (parameter->direction == idlOut || parameter->type == idlDateTime) {
+            sprintf(arguments[argumentCount++], "&%s", parameter->name);
+        } else {
+            strcpy(arguments[argumentCount++], parameter->name);
+        }
+    }
+    idlCOperationName(module, operationIndex, name);
+    snprintf(opening, sizeof opening, "    result = %s(", name);
+    idlWriteCList(file, opening, arguments, argumentCount, "", ");\n");
+    fputs("    seApiWirePutSigned(response, result);\n", file);
+    if (idlHasOutputs(operation)) {
+        fputs("    if (seApiWireHasOutputs(result)) {\n", file);
+        for (i = 0; i < operation->parameterCount; i++) {
+            if (operation->parameters[i].direction == idlOut) {
+                fputs("    ", file);
+                idlWriteCEncode(file, &operation->parameters[i], "response", "", "&");
+            }
+        }
+        fputs("    }\n", file);
+    }
+    for (i = 0; i < operation->parameterCount; i++) {
+        if (operation->parameters[i].direction == idlOut && idlHasLength(&operation->parameters[i])) {
+            fprintf(file, "    free(%s);\n", operation->parameters[i].name);
+        }
+    }
+    fputs("    return response->result;\n}\n", file);
+}
+
+static bool idlEmitWireSource(const struct IdlModule *module,
+                              const char *directory,
+                              char *error,
+                              size_t errorSize)
+{
+    char name[2 * IDL_GENERATED_NAME_SIZE];
+    FILE *file = idlCreateFile(directory, "SeApiWire.c", error, errorSize);
+    unsigned int i;
+
+    if (file == NULL) {
+        return false;
+    }
+    idlWriteCBanner(file, module);
+    fputs("#include <stdlib.h>\n#include <string.h>\n\n#include \"SeApiWire.h\"\n", file);
+    for (i = 0; i < module->operationCount; i++) {
+        idlWriteStub(file, module, i);
+    }
+    for (i = 0; i < module->operationCount; i++) {
+        idlWriteSkeleton(file, module, i);
+    }
+    fputs("\nshort int seApiSkeletonDispatch(void *context,\n"
+          "                                const unsigned char *request,\n"
+          "                                size_t requestLength,\n"
+          "                                struct SeApiWireWriter *response)\n"
+          "{\n"
+          "    struct SeApiWireReader reader;\n"
+          "    uint64_t operation;\n"
+          "\n"
+          "    (void) context;\n"
+          "    seApiWireReaderInit(&reader, request, requestLength);\n"
+          "    operation = seApiWireGetUnsigned(&reader);\n"
+          "    if (reader.result != EXECUTION_OK) {\n"
+          "        return reader.result;\n"
+          "    }\n"
+          "    switch (operation) {\n", file);
+    for (i = 0; i < module->operationCount; i++) {
+        idlWireOperationName(module, i, "seApiWire", name);
+        fprintf(file, "    case %s:\n", name);
+        idlWireOperationName(module, i, "seApiSkeleton", name);
+        fprintf(file, "        return %s(&reader, response);\n", name);
+    }
+    fputs("    default:\n        return ERROR_PARAMETER_MISMATCH;\n    }\n}\n", file);
+    return idlCloseFile(file, "SeApiWire.c", error, errorSize);
+}
+
+bool idlEmitC(const struct IdlModule *module,
+              const char *directory,
+              char *error,
+              size_t errorSize)
+{
+    return idlEmitSeApiHeader(module, directory, error, errorSize)
+           && idlEmitExceptionHeader(module, directory, error, errorSize)
+           && idlEmitConstantHeader(module, directory, error, errorSize)
+           && idlEmitWireHeader(module, directory, error, errorSize)
+           && idlEmitWireSource(module, directory, error, errorSize);
+}
@@ -0,0 +1,836 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "IdlEmitter.h"
+
+/**
+ * Size of a path below the output directory
+ */
+#define IDL_JAVA_PATH_SIZE 256
+
+static void idlWriteJavaBanner(FILE *file,
+                               const struct IdlModule *module)
+{
+    fprintf(file, "/*\n * Generated by idlgen from the IDL module %s. Do not edit.\n */\n", module->name);
+}
+
+static void idlWriteJavaComment(FILE *file,
+                                const char *indent,
+                                const char *documentation)
+{
+    char line[IDL_LINE_SIZE];
+
+    fprintf(file, "%s/**\n", indent);
+    while (idlNextLine(&documentation, line)) {
+        fprintf(file, line[0] != '\0' ? "%s * %s\n" : "%s *\n", indent, line);
+    }
+    fprintf(file, "%s */\n", indent);
+}
+
+/**
+ * Writes the documentation of an operation in the form of SEAPI.java, where the raised exceptions are thrown.
+ */
+static void idlWriteJavaOperationComment(FILE *file,
+                                         const struct IdlOperation *operation)
+{
+    enum {
+    idlSectionText, idlSectionParameter, idlSectionReturn, idlSectionThrows
+    } section = idlSectionText;
+    const char *documentation = operation->documentation;
+    char line[IDL_LINE_SIZE];
+    char word[IDL_NAME_SIZE];
+    const char *rest;
+
+    fputs("    /**\n", file);
+    while (idlNextLine(&documentation, line)) {
+        if ((rest = idlTagLine(line, "@param", word)) != NULL) {
+            fprintf(file, "     * @param %s\n", word);
+            if (*rest != '\0') {
+                fprintf(file, "     *            %s\n", rest);
+            }
+            section = idlSectionParameter;
+        } else if (strncmp(line, "@return", 7) == 0) {
+            fprintf(file, "     * @return %s\n", line + (line[7] == ' ' ? 8 : 7));
+            section = idlSectionReturn;
+        } else if ((rest = idlTagLine(line, "@raises", word)) != NULL) {
+            fprintf(file, "     * @throws %s\n", word);
+            if (*rest != '\0') {
+                fprintf(file, "     *             %s\n", rest);
+            }
+            section = idlSectionThrows;
+        } else if (line[0] == '\0') {
+            fputs("     *\n", file);
+        } else {
+            fprintf(file, section == idlSectionParameter ? "     *            %s\n"
+                          : section == idlSectionReturn ? "     *         %s\n"
+                          : section == idlSectionThrows ? "     *             %s\n" : "     * %s\n", line);
+        }
+    }
+    fputs("     */\n", file);
+}
+
+/**
+ * Returns the Java type of an input parameter. Enums are nested in the interface and qualified by it outside.
+ */
+static void idlJavaType(const struct IdlModule *module,
+                        const struct IdlParameter *parameter,
+                        bool qualified,
+                        char *result)
+{
+    switch (parameter->type) {
+    case idlShort:
+        strcpy(result, "short");
+        break;
+    case idlLong:
+        strcpy(result, "int");
+        break;
+    case idlUnsignedLong:
+        strcpy(result, "long");
+        break;
+    case idlString:
+        strcpy(result, "String");
+        break;
+    case idlOctetSequence:
+        strcpy(result, "byte[]");
+        break;
+    case idlDateTime:
+        strcpy(result, "ZonedDateTime");
+        break;
+    case idlEnum:
+        sprintf(result, "%s%s", qualified ? "SEAPI." : "", module->enums[parameter->enumIndex].name);
+        break;
+    }
+}
+
+/**
+ * Returns the holder type of an output parameter in the package de.bsi.seapi.holdertypes.
+ */
+static void idlJavaHolder(const struct IdlModule *module,
+                          const struct IdlParameter *parameter,
+                          char *result)
+{
+    switch (parameter->type) {
+    case idlShort:
+        strcpy(result, "ShortHolder");
+        break;
+    case idlLong:
+    case idlUnsignedLong:
+        strcpy(result, "LongHolder");
+        break;
+    case idlString:
+    case idlOctetSequence:
+        strcpy(result, "ByteArrayHolder");
+        break;
+    case idlDateTime:
+        strcpy(result, "ZonedDateTimeHolder");
+        break;
+    case idlEnum:
+        sprintf(result, "%sHolder", module->enums[parameter->enumIndex].name);
+        break;
+    }
+}
+
+static void idlJavaMethodName(const struct IdlOperation *operation,
+                              char *result)
+{
+    idlLowerFirst(operation->name, result);
+}
+
+static void idlJavaOperationConstant(const struct IdlModule *module,
+                                     unsigned int operationIndex,
+                                     char *result)
+{
+    char cName[IDL_GENERATED_NAME_SIZE];
+
+    idlCOperationName(module, operationIndex, cName);
+    idlUpperSnakeCase(cName, result);
+}
+
+/**
+ * Writes the imports of ZonedDateTime, of the raised exceptions and of the holders of the output parameters, as far
+ * as they are used by the operations and selected.
+ */
+static void idlWriteJavaImports(FILE *file,
+                                const struct IdlModule *module,
+                                bool dateTimes,
+                                bool exceptions,
+                                bool holders)
+{
+    char holderNames[IDL_MAX_ENUMS + 8][IDL_GENERATED_NAME_SIZE];
+    bool raised[IDL_MAX_EXCEPTIONS] = { false };
+    bool dateTime = false;
+    unsigned int holderCount = 0;
+    unsigned int i;
+    unsigned int j;
+
+    for (i = 0; i < module->operationCount; i++) {
+        const struct IdlOperation *operation = &module->operations[i];
+
+        for (j = 0; j < operation->raiseCount; j++) {
+            raised[operation->raises[j]] = true;
+        }
+        for (j = 0; j < operation->parameterCount; j++) {
+            const struct IdlParameter *parameter = &operation->parameters[j];
+            char holder[IDL_GENERATED_NAME_SIZE];
+            unsigned int k;
+
+            if (parameter->direction == idlIn) {
+                dateTime = dateTime || parameter->type == idlDateTime;
+                continue;
+            }
+            idlJavaHolder(module, parameter, holder);
+            for (k = 0; k < holderCount && strcmp(holderNames[k], holder) != 0; k++) {
+            }
+            if (k == holderCount && holderCount < sizeof holderNames / sizeof holderNames[0]) {
+                strcpy(holderNames[holderCount++], holder);
+            }
+        }
+    }
+    if (dateTime && dateTimes) {
+        fputs("import java.time.ZonedDateTime;\n", file);
+    }
+    for (i = 0; exceptions && i < module->exceptionCount; i++) {
+        if (raised[i]) {
+            fprintf(file, "import de.bsi.seapi.exceptions.%s;\n", module->exceptions[i].name);
+        }
+    }
+    for (i = 0; holders && i < holderCount; i++) {
+        fprintf(file, "import de.bsi.seapi.holdertypes.%s;\n", holderNames[i]);
+    }
+}
+
+/**
+ * Writes the declaration of the method of an operation with one parameter and one exception per line.
+ */
+static void idlWriteJavaSignature(FILE *file,
+                                  const struct IdlModule *module,
+                                  const struct IdlOperation *operation,
+                                  const char *modifiers,
+                                  const char *terminator)
+{
+    char name[IDL_GENERATED_NAME_SIZE];
+    char type[IDL_GENERATED_NAME_SIZE];
+    int column;
+    unsigned int i;
+
+    idlJavaMethodName(operation, name);
+    column = fprintf(file, "%sshort %s(", modifiers, name);
+    for (i = 0; i < operation->parameterCount; i++) {
+        const struct IdlParameter *parameter = &operation->parameters[i];
+
+        if (parameter->direction == idlIn) {
+            idlJavaType(module, parameter, false, type);
+        } else {
+            idlJavaHolder(module, parameter, type);
+        }
+        if (i > 0) {
+            fprintf(file, ",\n%*s", column, "");
+        }
+        fprintf(file, "%s %s", type, parameter->name);
+    }
+    fputs(")", file);
+    for (i = 0; i < operation->raiseCount; i++) {
+        fprintf(file, i == 0 ? "\n%*sthrows %s" : ",\n%*s       %s", column, "",
+                module->exceptions[operation->raises[i]].name);
+    }
+    fputs(terminator, file);
+}
+
+static bool idlEmitJavaInterface(const struct IdlModule *module,
+                                 const char *directory,
+                                 char *error,
+                                 size_t errorSize)
+{
+    FILE *file = idlCreateFile(directory, "SEAPI.java", error, errorSize);
+    unsigned int i;
+    unsigned int j;
+
+    if (file == NULL) {
+        return false;
+    }
+    idlWriteJavaBanner(file, module);
+    fputs("package de.bsi.seapi;\n\n", file);
+    idlWriteJavaImports(file, module, true, false, false);
+    fputs("\n", file);
+    idlWriteJavaImports(file, module, false, true, true);
+    fputs("\n/**\n * This interface defines the functions that are provided by the Secure Element\n * API (SE API)\n */\n\n"
+          "public interface SEAPI {\n", file);
+    for (i = 0; i < module->enumCount; i++) {
+        fputs("\n", file);
+        idlWriteJavaComment(file, "    ", module->enums[i].documentation);
+        fprintf(file, "    enum %s {\n        ", module->enums[i].name);
+        for (j = 0; j < module->enums[i].valueCount; j++) {
+            fprintf(file, "%s%s", j > 0 ? ", " : "", module->enums[i].values[j]);
+        }
+        fputs("\n    };\n", file);
+    }
+    for (i = 0; i < module->operationCount; i++) {
+        fputs("\n", file);
+        idlWriteJavaOperationComment(file, &module->operations[i]);
+        idlWriteJavaSignature(file, module, &module->operations[i], "    ", ";\n");
+    }
+    fputs("}\n", file);
+    return idlCloseFile(file, "SEAPI.java", error, errorSize);
+}
+
+static bool idlEmitJavaException(const struct IdlModule *module,
+                                 unsigned int exceptionIndex,
+                                 const char *directory,
+                                 char *error,
+                                 size_t errorSize)
+{
+    static char documentation[IDL_DOCUMENTATION_SIZE + IDL_GENERATED_NAME_SIZE];
+    const char *name = module->exceptions[exceptionIndex].name;
+    char path[IDL_JAVA_PATH_SIZE];
+    char subject[2 * IDL_GENERATED_NAME_SIZE];
+    FILE *file;
+
+    snprintf(path, sizeof path, "exceptions/%s.java", name);
+    file = idlCreateFile(directory, path, error, errorSize);
+    if (file == NULL) {
+        return false;
+    }
+    snprintf(subject, sizeof subject, "This class defines the exception %s that is thrown if", name);
+    idlExceptionDocumentation(&module->exceptions[exceptionIndex], subject, documentation);
+    idlWriteJavaBanner(file, module);
+    fputs("package de.bsi.seapi.exceptions;\n\n", file);
+    idlWriteJavaComment(file, "", documentation);
+    fprintf(file, "\npublic final class %s extends java.lang.Exception {\n\n", name);
+    fprintf(file,
+            "    /**\n"
+            "     * Constructs a new %s exception with null as the value for its\n"
+            "     * detail message\n"
+            "     */\n"
+            "    public %s() {\n"
+            "        super();\n"
+            "    }\n\n", name, name);
+    fprintf(file,
+            "    /**\n"
+            "     * Constructs a new %s exception whereby its detail message is\n"
+            "     * initialized with the passed value\n"
+            "     * \n"
+            "     * @param message\n"
+            "     *            value for the detail message of the exception\n"
+            "     */\n"
+            "    public %s(String message) {\n"
+            "        super(message);\n"
+            "    }\n\n", name, name);
+    fprintf(file,
+            "    /**\n"
+            "     * Constructs a new %s exception whereby its detail message and\n"
+            "     * cause are initialized with the appropriate passed values\n"
+            "     * \n"
+            "     * @param message\n"
+            "     *            value for the detail message of the exception\n"
+            "     * @param cause\n"
+            "     *            value for the cause of the exception\n"
+            "     */\n"
+            "    public %s(String message, Throwable cause) {\n"
+            "        super(message, cause);\n"
+            "    }\n\n", name, name);
+    fprintf(file,
+            "    /**\n"
+            "     * Constructs a new %s exception whereby its detail message and\n"
+            "     * cause are initialized with the appropriate passed values. Furthermore, it is\n"
+            "     * specified whether or not suppression should be enabled or disabled and\n"
+            "     * whether or not the stack trace should be writable for this exception.\n"
+            "     * \n"
+            "     * @param message\n"
+            "     *            value for the detail message of the exception\n"
+            "     * @param cause\n"
+            "     *            value for the cause of the exception\n"
+            "     * @param enableSuppression\n"
+            "     *            specifies whether or not suppression should be enabled for this\n"
+            "     *            exception\n"
+            "     * @param writableStackTrace\n"
+            "     *            specifies whether or not the stack trace should be writable for\n"
+            "     *            this exception\n"
+            "     */\n"
+            "    public %s(String message, Throwable cause, boolean enableSuppression, boolean writableStackTrace) {\n"
+            "        super(message, cause, enableSuppression, writableStackTrace);\n"
+            "    }\n"
+            "}\n", name, name);
+    return idlCloseFile(file, path, error, errorSize);
+}
+
+static bool idlEmitJavaPreallocatedExceptions(const struct IdlModule *module,
+                                              const char *directory,
+                                              char *error,
+                                              size_t errorSize)
+{
+    const char *path = "exceptions/PreallocatedExceptions.java";
+    FILE *file = idlCreateFile(directory, path, error, errorSize);
+    char code[IDL_GENERATED_NAME_SIZE];
+    unsigned int i;
+
+    if (file == NULL) {
+        return false;
+    }
+    idlWriteJavaBanner(file, module);
+    fputs("package de.bsi.seapi.exceptions;\n\n"
+          "/**\n"
+          " * This class defines one preallocated instance of each exception of the SE API. The instances are created\n"
+          " * without stack trace and without suppression, so that throwing them costs no more than a return. They are\n"
+          " * immutable and therefore shared by all threads\n"
+          " */\n"
+          "public final class PreallocatedExceptions {\n", file);
+    for (i = 0; i < module->exceptionCount; i++) {
+        const char *name = module->exceptions[i].name;
+
+        idlExceptionCodeName(module, i, code);
+        fprintf(file, "\n    /**\n     * Preallocated instance of %s\n     */\n", name);
+        fprintf(file, "    public static final %s %s\n            = new %s(\"%s (%ld)\", null, false, false);\n", name,
+                strncmp(code, "ERROR_", 6) == 0 ? code + 6 : code, name, code, idlExceptionCode(i));
+    }
+    fputs("\n    private PreallocatedExceptions() {\n    }\n}\n", file);
+    return idlCloseFile(file, path, error, errorSize);
+}
+
+static bool idlEmitJavaErrorCodes(const struct IdlModule *module,
+                                  const char *directory,
+                                  char *error,
+                                  size_t errorSize)
+{
+    FILE *file = idlCreateFile(directory, "ErrorCodes.java", error, errorSize);
+    char code[IDL_GENERATED_NAME_SIZE];
+    unsigned int i;
+
+    if (file == NULL) {
+        return false;
+    }
+    idlWriteJavaBanner(file, module);
+    fputs("package de.bsi.seapi;\n\n"
+          "/**\n"
+          " * This class defines the error codes of the SE API as return values. The values are equal to the error codes\n"
+          " * of the generated Exception.h of the ANSI C interface. Each error code corresponds to the exception class of\n"
+          " * the same name in the package de.bsi.seapi.exceptions\n"
+          " */\n"
+          "public final class ErrorCodes {\n", file);
+    for (i = 0; i < module->exceptionCount; i++) {
+        idlExceptionCodeName(module, i, code);
+        fprintf(file, "\n    /**\n     * Error code that corresponds to the exception %s\n     */\n",
+                module->exceptions[i].name);
+        fprintf(file, "    public static final short %s = %ld;\n", code, idlExceptionCode(i));
+    }
+    fputs("\n    private ErrorCodes() {\n    }\n}\n", file);
+    return idlCloseFile(file, "ErrorCodes.java", error, errorSize);
+}
+
+static bool idlEmitJavaConstant(const struct IdlModule *module,
+                                const char *directory,
+                                char *error,
+                                size_t errorSize)
+{
+    FILE *file = idlCreateFile(directory, "Constant.java", error, errorSize);
+    unsigned int i;
+
+    if (file == NULL) {
+        return false;
+    }
+    idlWriteJavaBanner(file, module);
+    fputs("package de.bsi.seapi;\n\n"
+          "/**\n * This class defines the constants that are used in the context of the SE API\n */\n"
+          "public final class Constant {\n", file);
+    for (i = 0; i < module->constantCount; i++) {
+        fputs("\n", file);
+        idlWriteJavaComment(file, "    ", module->constants[i].documentation);
+        fprintf(file, "    public static final short %s = %ld;\n", module->constants[i].name,
+                module->constants[i].value);
+    }
+    fputs("\n    private Constant() {\n    }\n}\n", file);
+    return idlCloseFile(file, "Constant.java", error, errorSize);
+}
+
+static bool idlEmitJavaOperations(const struct IdlModule *module,
+                                  const char *directory,
+                                  char *error,
+                                  size_t errorSize)
+{
+    const char *path = "wire/SeApiWireOperations.java";
+    FILE *file = idlCreateFile(directory, path, error, errorSize);
+    char name[IDL_GENERATED_NAME_SIZE];
+    char constant[IDL_GENERATED_NAME_SIZE];
+    unsigned int i;
+
+    if (file == NULL) {
+        return false;
+    }
+    idlWriteJavaBanner(file, module);
+    fputs("package de.bsi.seapi.wire;\n\n"
+          "/**\n"
+          " * This class defines the numbers of the functions of the SE API in the wire protocol. The names are the\n"
+          " * names of the functions in SEAPI.h of the ANSI C interface, which distinguishes overloaded functions\n"
+          " */\n"
+          "public final class SeApiWireOperations {\n", file);
+    for (i = 0; i < module->operationCount; i++) {
+        idlCOperationName(module, i, name);
+        idlJavaOperationConstant(module, i, constant);
+        fprintf(file, "\n    /**\n     * Number of %s\n     */\n    public static final int %s = %u;\n", name,
+                constant, i);
+    }
+    fputs("\n    private SeApiWireOperations() {\n    }\n}\n", file);
+    return idlCloseFile(file, path, error, errorSize);
+}
+
+/**
+ * Writes the arrays of the values of the enums that are decoded by a stub or skeleton, since values() copies the
+ * array on every call.
+ */
+static void idlWriteJavaEnumArrays(FILE *file,
+                                   const struct IdlModule *module,
+                                   enum IdlDirection direction,
+                                   bool qualified)
+{
+    bool used[IDL_MAX_ENUMS] = { false };
+    char constant[IDL_GENERATED_NAME_SIZE];
+    const char *prefix = qualified ? "SEAPI." : "";
+    unsigned int i;
+    unsigned int j;
+
+    for (i = 0; i < module->operationCount; i++) {
+        for (j = 0; j < module->operations[i].parameterCount; j++) {
+            const struct IdlParameter *parameter = &module->operations[i].parameters[j];
+
+            if (parameter->type == idlEnum && parameter->direction == direction) {
+                used[parameter->enumIndex] = true;
+            }
+        }
+    }
+    for (i = 0; i < module->enumCount; i++) {
+        if (used[i]) {
+            idlUpperSnakeCase(module->enums[i].name, constant);
+            fprintf(file, "    private static final %s%s[] %s = %s%s.values();\n\n", prefix, module->enums[i].name,
+                    constant, prefix, module->enums[i].name);
+        }
+    }
+}
+
+/**
+ * Returns the expression that decodes a value. Enums are decoded through the arrays of idlWriteJavaEnumArrays.
+ */
+static void idlJavaDecode(const struct IdlModule *module,
+                          const struct IdlParameter *parameter,
+                          const char *reader,
+                          char *result)
+{
+    char constant[IDL_GENERATED_NAME_SIZE];
+
+    switch (parameter->type) {
+    case idlShort:
+        sprintf(result, "(short) %s.getSigned()", reader);
+        break;
+    case idlLong:
+        sprintf(result, "(int) %s.getSigned()", reader);
+        break;
+    case idlUnsignedLong:
+        sprintf(result, "%s.getUnsigned()", reader);
+        break;
+    case idlString:
+        sprintf(result, parameter->direction == idlIn ? "%s.getString()" : "%s.getBytes()", reader);
+        break;
+    case idlOctetSequence:
+        sprintf(result, "%s.getBytes()", reader);
+        break;
+    case idlDateTime:
+        sprintf(result, "%s.getTime()", reader);
+        break;
+    case idlEnum:
+        idlUpperSnakeCase(module->enums[parameter->enumIndex].name, constant);
+        sprintf(result, "%s[%s.getIndex(%s.length)]", constant, reader, constant);
+        break;
+    }
+}
+
+static void idlWriteJavaEncode(FILE *file,
+                               const struct IdlParameter *parameter,
+                               const char *writer,
+                               const char *value)
+{
+    switch (parameter->type) {
+    case idlShort:
+        fprintf(file, parameter->direction == idlIn ? "%s.putSigned(%s);\n" : "%s.putNullableSigned(%s);\n", writer,
+                value);
+        break;
+    case idlLong:
+        fprintf(file, "%s.putSigned(%s);\n", writer, value);
+        break;
+    case idlUnsignedLong:
+        fprintf(file, parameter->direction == idlIn ? "%s.putUnsigned(%s);\n" : "%s.putNullableUnsigned(%s);\n",
+                writer, value);
+        break;
+    case idlString:
+        fprintf(file, parameter->direction == idlIn ? "%s.putString(%s);\n" : "%s.putBytes(%s);\n", writer, value);
+        break;
+    case idlOctetSequence:
+        fprintf(file, "%s.putBytes(%s);\n", writer, value);
+        break;
+    case idlDateTime:
+        fprintf(file, "%s.putTime(%s);\n", writer, value);
+        break;
+    case idlEnum:
+        fprintf(file, "%s.putEnum(%s);\n", writer, value);
+        break;
+    }
+}
+
+static void idlWriteJavaStubMethod(FILE *file,
+                                   const struct IdlModule *module,
+                                   unsigned int operationIndex)
+{
+    const struct IdlOperation *operation = &module->operations[operationIndex];
+    char constant[IDL_GENERATED_NAME_SIZE];
+    char code[IDL_GENERATED_NAME_SIZE];
+    char name[IDL_GENERATED_NAME_SIZE];
+    char decode[2 * IDL_GENERATED_NAME_SIZE];
+    bool outputs = false;
+    unsigned int i;
+
+    idlJavaOperationConstant(module, operationIndex, constant);
+    fputs("\n    @Override\n", file);
+    idlWriteJavaSignature(file, module, operation, "    public ", " {\n");
+    fprintf(file, "        request.reset();\n        request.putUnsigned(SeApiWireOperations.%s);\n", constant);
+    for (i = 0; i < operation->parameterCount; i++) {
+        if (operation->parameters[i].direction == idlIn) {
+            fputs("        ", file);
+            idlWriteJavaEncode(file, &operation->parameters[i], "request", operation->parameters[i].name);
+        } else {
+            outputs = true;
+        }
+    }
+    fputs("        WireReader response = call();\n        short status = response.getStatus();\n", file);
+    if (outputs) {
+        fputs("        if (WireReader.hasOutputs(status)) {\n", file);
+        for (i = 0; i < operation->parameterCount; i++) {
+            if (operation->parameters[i].direction == idlOut) {
+                idlJavaDecode(module, &operation->parameters[i], "response", decode);
+                fprintf(file, "            %s.setValue(%s);\n", operation->parameters[i].name, decode);
+            }
+        }
+        fputs("        }\n", file);
+    }
+    fputs("        switch (status) {\n", file);
+    for (i = 0; i < module->constantCount; i++) {
+        fprintf(file, "        case Constant.%s:\n", module->constants[i].name);
+    }
+    fputs("            return status;\n", file);
+    for (i = 0; i < operation->raiseCount; i++) {
+        idlExceptionCodeName(module, operation->raises[i], code);
+        fprintf(file, "        case ErrorCodes.%s:\n            throw PreallocatedExceptions.%s;\n", code,
+                strncmp(code, "ERROR_", 6) == 0 ? code + 6 : code);
+    }
+    idlJavaMethodName(operation, name);
+    fprintf(file, "        default:\n            throw new IllegalStateException(\"unexpected status \" + status + \" of %s\");\n"
+            "        }\n    }\n", name);
+}
+
+static bool idlEmitJavaStub(const struct IdlModule *module,
+                            const char *directory,
+                            char *error,
+                            size_t errorSize)
+{
+    const char *path = "wire/SeApiWireStub.java";
+    FILE *file = idlCreateFile(directory, path, error, errorSize);
+    unsigned int i;
+
+    if (file == NULL) {
+        return false;
+    }
+    idlWriteJavaBanner(file, module);
+    fputs("package de.bsi.seapi.wire;\n\nimport java.io.IOException;\nimport java.io.UncheckedIOException;\n", file);
+    idlWriteJavaImports(file, module, true, false, false);
+    fputs("\nimport de.bsi.seapi.Constant;\nimport de.bsi.seapi.ErrorCodes;\nimport de.bsi.seapi.SEAPI;\n", file);
+    idlWriteJavaImports(file, module, false, true, false);
+    fputs("import de.bsi.seapi.exceptions.PreallocatedExceptions;\n", file);
+    idlWriteJavaImports(file, module, false, false, true);
+    fputs("\n"
+          "/**\n"
+          " * This class implements SEAPI by executing the functions through the wire protocol of the SE API. The\n"
+          " * marshalling of each function is generated. Exceptions are thrown as the instances of\n"
+          " * PreallocatedExceptions; a status that the function cannot return is reported as IllegalStateException and\n"
+          " * a failure of the transport as UncheckedIOException. The request buffer is reused, so an instance SHALL only\n"
+          " * be used by one thread at a time\n"
+          " */\n"
+          "public final class SeApiWireStub implements SEAPI {\n\n", file);
+    idlWriteJavaEnumArrays(file, module, idlOut, false);
+    fputs("    private final WireTransport transport;\n\n"
+          "    private final WireWriter request = new WireWriter();\n\n"
+          "    /**\n"
+          "     * Constructs a new stub\n"
+          "     * \n"
+          "     * @param transport\n"
+          "     *            transport to the skeleton\n"
+          "     */\n"
+          "    public SeApiWireStub(WireTransport transport) {\n"
+          "        this.transport = transport;\n"
+          "    }\n\n"
+          "    private WireReader call() {\n"
+          "        try {\n"
+          "            return new WireReader(transport.exchange(request.data(), request.length()));\n"
+          "        } catch (IOException e) {\n"
+          "            throw new UncheckedIOException(e);\n"
+          "        }\n"
+          "    }\n", file);
+    for (i = 0; i < module->operationCount; i++) {
+        idlWriteJavaStubMethod(file, module, i);
+    }
+    fputs("}\n", file);
+    return idlCloseFile(file, path, error, errorSize);
+}
+
+static void idlWriteJavaSkeletonMethod(FILE *file,
+                                       const struct IdlModule *module,
+                                       unsigned int operationIndex)
+{
+    const struct IdlOperation *operation = &module->operations[operationIndex];
+    char name[IDL_GENERATED_NAME_SIZE];
+    char type[IDL_GENERATED_NAME_SIZE];
+    char decode[2 * IDL_GENERATED_NAME_SIZE];
+    char value[2 * IDL_GENERATED_NAME_SIZE];
+    bool outputs = false;
+    int column;
+    unsigned int i;
+
+    idlJavaOperationConstant(module, operationIndex, type);
+    idlCOperationName(module, operationIndex, name);
+    fprintf(file, "\n    private void %s(WireReader request, WireWriter response) {\n", name);
+    for (i = 0; i < operation->parameterCount; i++) {
+        const struct IdlParameter *parameter = &operation->parameters[i];
+
+        if (parameter->direction == idlIn) {
+            idlJavaType(module, parameter, true, type);
+            idlJavaDecode(module, parameter, "request", decode);
+            fprintf(file, "        %s %s = %s;\n", type, parameter->name, decode);
+        } else {
+            idlJavaHolder(module, parameter, type);
+            fprintf(file, "        %s %s = new %s();\n", type, parameter->name, type);
+            outputs = true;
+        }
+    }
+    idlJavaMethodName(operation, name);
+    fputs("        short status;\n\n        try {\n", file);
+    column = fprintf(file, "            status = implementation.%s(", name);
+    for (i = 0; i < operation->parameterCount; i++) {
+        fprintf(file, i > 0 ? ",\n%*s%s" : "%*s%s", i > 0 ? column : 0, "", operation->parameters[i].name);
+    }
+    fputs(");\n        } catch (Exception e) {\n            status = codeOf(e);\n        }\n"
+          "        response.putSigned(status);\n", file);
+    if (outputs) {
+        fputs("        if (WireReader.hasOutputs(status)) {\n", file);
+        for (i = 0; i < operation->parameterCount; i++) {
+            if (operation->parameters[i].direction == idlOut) {
+                snprintf(value, sizeof value, "%s.getValue()", operation->parameters[i].name);
+                fputs("            ", file);
+                idlWriteJavaEncode(file, &operation->parameters[i], "response", value);
+            }
+        }
+        fputs("        }\n", file);
+    }
+    fputs("    }\n", file);
+}
+
+static bool idlEmitJavaSkeleton(const struct IdlModule *module,
+                                const char *directory,
+                                char *error,
+                                size_t errorSize)
+{
+    const char *path = "wire/SeApiWireSkeleton.java";
+    FILE *file = idlCreateFile(directory, path, error, errorSize);
+    char name[IDL_GENERATED_NAME_SIZE];
+    char constant[IDL_GENERATED_NAME_SIZE];
+    char code[IDL_GENERATED_NAME_SIZE];
+    unsigned int i;
+
+    if (file == NULL) {
+        return false;
+    }
+    idlWriteJavaBanner(file, module);
+    fputs("package de.bsi.seapi.wire;\n\n", file);
+    idlWriteJavaImports(file, module, true, false, false);
+    fputs("\nimport de.bsi.seapi.ErrorCodes;\nimport de.bsi.seapi.SEAPI;\n", file);
+    for (i = 0; i < module->exceptionCount; i++) {
+        fprintf(file, "import de.bsi.seapi.exceptions.%s;\n", module->exceptions[i].name);
+    }
+    idlWriteJavaImports(file, module, false, false, true);
+    fputs("\n/**\n"
+          " * This class executes the requests of the wire protocol of the SE API on an implementation of SEAPI. The\n"
+          " * marshalling of each function is generated. Exceptions of the SE API are returned as the status of the\n"
+          " * response, other exceptions are passed to the caller of exchange. Instances can be used by several threads\n"
+          " * if the implementation can\n"
+          " */\n"
+          "public final class SeApiWireSkeleton implements WireTransport {\n\n", file);
+    idlWriteJavaEnumArrays(file, module, idlIn, true);
+    fputs("    private final SEAPI implementation;\n\n"
+          "    /**\n"
+          "     * Constructs a new skeleton\n"
+          "     * \n"
+          "     * @param implementation\n"
+          "     *            implementation that executes the requests\n"
+          "     */\n"
+          "    public SeApiWireSkeleton(SEAPI implementation) {\n"
+          "        this.implementation = implementation;\n"
+          "    }\n\n"
+          "    /**\n"
+          "     * This function decodes a request, executes the function of the SE API and encodes its response\n"
+          "     * \n"
+          "     * @param request\n"
+          "     *            array that contains the encoded request\n"
+          "     * @param requestLength\n"
+          "     *            number of bytes of the request at the start of the array\n"
+          "     * @return the encoded response\n"
+          "     */\n"
+          "    @Override\n"
+          "    public byte[] exchange(byte[] request, int requestLength) {\n"
+          "        WireReader reader = new WireReader(request, requestLength);\n"
+          "        WireWriter response = new WireWriter();\n"
+          "        long operation = reader.getUnsigned();\n\n"
+          "        if (operation < 0 || operation > Integer.MAX_VALUE) {\n"
+          "            throw new IllegalArgumentException(\"unknown operation \" + operation);\n"
+          "        }\n"
+          "        switch ((int) operation) {\n", file);
+    for (i = 0; i < module->operationCount; i++) {
+        idlCOperationName(module, i, name);
+        idlJavaOperationConstant(module, i, constant);
+        fprintf(file, "        case SeApiWireOperations.%s:\n            %s(reader, response);\n            break;\n",
+                constant, name);
+    }
+    fputs("        default:\n"
+          "            throw new IllegalArgumentException(\"unknown operation \" + operation);\n"
+          "        }\n"
+          "        return response.toByteArray();\n"
+          "    }\n", file);
+    for (i = 0; i < module->operationCount; i++) {
+        idlWriteJavaSkeletonMethod(file, module, i);
+    }
+    fputs("\n    private static short codeOf(Exception exception) {\n"
+          "        if (exception instanceof RuntimeException) {\n"
+          "            throw (RuntimeException) exception;\n"
+          "        }\n", file);
+    for (i = 0; i < module->exceptionCount; i++) {
+        idlExceptionCodeName(module, i, code);
+        fprintf(file, "        if (exception instanceof %s) {\n            return ErrorCodes.%s;\n        }\n",
+                module->exceptions[i].name, code);
+    }
+    fputs("        throw new IllegalStateException(exception);\n    }\n}\n", file);
+    return idlCloseFile(file, path, error, errorSize);
+}
+
+bool idlEmitJava(const struct IdlModule *module,
+                 const char *directory,
+                 char *error,
+                 size_t errorSize)
+{
+    unsigned int i;
+
+    for (i = 0; i < module->exceptionCount; i++) {
+        if (!idlEmitJavaException(module, i, directory, error, errorSize)) {
+            return false;
+        }
+    }
+    return idlEmitJavaInterface(module, directory, error, errorSize)
+           && idlEmitJavaPreallocatedExceptions(module, directory, error, errorSize)
+           && idlEmitJavaErrorCodes(module, directory, error, errorSize)
+           && idlEmitJavaConstant(module, directory, error, errorSize)
+           && idlEmitJavaOperations(module, directory, error, errorSize)
+           && idlEmitJavaStub(module, directory, error, errorSize)
+           && idlEmitJavaSkeleton(module, directory, error, errorSize);
+}
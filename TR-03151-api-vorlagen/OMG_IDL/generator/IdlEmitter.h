@@ -0,0 +1,157 @@
+#ifndef SEAPI_IDL_EMITTER_H
+#define SEAPI_IDL_EMITTER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+
+#include "IdlParser.h"
+
+/**
+ * This header file defines the emitters of the IDL generator and the naming rules that they share, so that the
+ * C binding, the Java binding and the wire protocol use the same names and numbers for every declaration.
+ *
+ * Wire protocol: a request consists of the number of the operation (its position in the interface) followed by
+ * its input parameters in the order of the IDL. A response consists of the status followed by the output
+ * parameters, which are only present if the status is EXECUTION_OK, one of the other constants of the module or
+ * the code of ErrorCertificateExpired, since these are the cases in which an SE API function returns its outputs.
+ *
+ *     unsigned long, enums      unsigned LEB128 varint
+ *     short, long, status       zigzag-encoded varint
+ *     string, octet[]           varint length followed by the bytes
+ *     DateTime                  zigzag-encoded varint of the seconds since the epoch (UTC)
+ *
+ * The marshalling of every operation is generated as straight-line code on top of these primitives; no
+ * description of the operations is interpreted at run time.
+ */
+
+/**
+ * Size of the names produced by the naming rules
+ */
+#define IDL_GENERATED_NAME_SIZE 128
+
+/**
+ * Code of the first exception of the module. The exceptions are numbered downwards in the order of the IDL.
+ */
+#define IDL_FIRST_EXCEPTION_CODE -5001
+
+/**
+ * Size of one line of documentation
+ */
+#define IDL_LINE_SIZE 512
+
+/**
+ * Converts a name in camel case into upper case words separated by underscores, e.g. ErrorNoTransaction into
+ * ERROR_NO_TRANSACTION.
+ */
+void idlUpperSnakeCase(const char *name,
+                       char *result);
+
+/**
+ * Returns the name of the constant of an exception in Exception.h and ErrorCodes.java.
+ */
+void idlExceptionCodeName(const struct IdlModule *module,
+                          unsigned int exceptionIndex,
+                          char *result);
+
+/**
+ * Returns the error code of an exception.
+ */
+long idlExceptionCode(unsigned int exceptionIndex);
+
+/**
+ * Copies the documentation of an exception and replaces its introduction "The exception <name> is raised if" by the
+ * subject, e.g. "The return value ERROR_NO_TRANSACTION indicates that".
+ * @param[out] result
+ *                receives the documentation, at least IDL_DOCUMENTATION_SIZE + IDL_GENERATED_NAME_SIZE bytes [REQUIRED]
+ */
+void idlExceptionDocumentation(const struct IdlException *exception,
+                               const char *subject,
+                               char *result);
+
+/**
+ * Returns the name of the C function of an operation. Overloaded operations get the names of SEAPI.h of the
+ * ANSI C templates; overloads that are unknown to the generator get the names of their input parameters appended.
+ */
+void idlCOperationName(const struct IdlModule *module,
+                       unsigned int operationIndex,
+                       char *result);
+
+/**
+ * Returns the name of an enum value in C. Values whose names occur in more than one enum get a prefix, since the
+ * values of C enums share one name space.
+ */
+void idlCEnumValueName(const struct IdlModule *module,
+                       unsigned int enumIndex,
+                       unsigned int valueIndex,
+                       char *result);
+
+/**
+ * Returns the name with its first letter in lower case (Java method names) or upper case (C function suffixes).
+ */
+void idlLowerFirst(const char *name,
+                   char *result);
+void idlUpperFirst(const char *name,
+                   char *result);
+
+/**
+ * Returns whether a parameter is passed as array and length.
+ */
+bool idlHasLength(const struct IdlParameter *parameter);
+
+/**
+ * Reads the next line of a documentation.
+ * @param[in,out] cursor
+ *                position within the documentation, advanced to the next line [REQUIRED]
+ * @param[out] line
+ *                receives the line without line feed [REQUIRED]
+ * @return true if a line has been read, false at the end of the documentation
+ */
+bool idlNextLine(const char **cursor,
+                 char *line);
+
+/**
+ * If the line starts with the tag (e.g. "@param"), stores the following word in word, returns the text after the
+ * word and NULL otherwise.
+ */
+const char *idlTagLine(const char *line,
+                       const char *tag,
+                       char *word);
+
+/**
+ * Creates a file below a directory, including the missing subdirectories of its path.
+ * @return the opened file or NULL with a message in error
+ */
+FILE *idlCreateFile(const char *directory,
+                    const char *path,
+                    char *error,
+                    size_t errorSize);
+
+/**
+ * Closes a file created by idlCreateFile and reports write errors.
+ */
+bool idlCloseFile(FILE *file,
+                  const char *path,
+                  char *error,
+                  size_t errorSize);
+
+/**
+ * Writes SEAPI.h, Exception.h, Constant.h, SeApiWire.h and SeApiWire.c to the directory.
+ * @return true on success, false with a message in error
+ */
+bool idlEmitC(const struct IdlModule *module,
+              const char *directory,
+              char *error,
+              size_t errorSize);
+
+/**
+ * Writes the interface SEAPI, the classes of the exceptions, ErrorCodes, Constant and the wire stub and skeleton
+ * of the package de.bsi.seapi below the directory.
+ * @return true on success, false with a message in error
+ */
+bool idlEmitJava(const struct IdlModule *module,
+                 const char *directory,
+                 char *error,
+                 size_t errorSize);
+
+#endif
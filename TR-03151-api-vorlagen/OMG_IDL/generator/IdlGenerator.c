@@ -0,0 +1,46 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "IdlEmitter.h"
+
+/**
+ * Generates the C and Java bindings of the SE API and their wire protocol from the IDL.
+ *
+ *     idlgen SEAPI_version1.0.1.idl <output directory>
+ *
+ * writes the C files to <output directory>/c and the Java files to <output directory>/java.
+ */
+int main(int argc,
+         char **argv)
+{
+    struct IdlModule *module;
+    char directory[4096];
+    char error[512];
+    bool generated;
+
+    if (argc != 3) {
+        fprintf(stderr, "usage: %s <IDL file> <output directory>\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    /* the parsed module keeps the documentation of every declaration and is too large for the stack */
+    module = malloc(sizeof *module);
+    if (module == NULL) {
+        fprintf(stderr, "%s: out of memory\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    generated = idlParseFile(argv[1], module, error, sizeof error);
+    if (generated) {
+        snprintf(directory, sizeof directory, "%s/c", argv[2]);
+        generated = idlEmitC(module, directory, error, sizeof error);
+    }
+    if (generated) {
+        snprintf(directory, sizeof directory, "%s/java", argv[2]);
+        generated = idlEmitJava(module, directory, error, sizeof error);
+    }
+    free(module);
+    if (!generated) {
+        fprintf(stderr, "%s: %s\n", argv[1], error);
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,298 @@
+#include <ctype.h>
+#include <errno.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#include "IdlEmitter.h"
+
+/**
+ * C names of the overloaded operations of the SE API, identified by the names of their input parameters
+ */
+struct IdlOverloadName {
+    const char *operation;
+    const char *inputs;
+    const char *cName;
+};
+
+static const struct IdlOverloadName idlOverloadNames[] = {
+    { "initialize", "description", "initializeDescriptionNotSet" },
+    { "initialize", "", "initializeDescriptionSet" },
+    { "updateTime", "newDateTime", "updateTime" },
+    { "updateTime", "", "updateTimeWithTimeSync" },
+    { "exportData", "transactionNumber,clientId", "exportDataFilteredByTransactionNumberAndClientId" },
+    { "exportData", "transactionNumber", "exportDataFilteredByTransactionNumber" },
+    { "exportData", "startTransactionNumber,endTransactionNumber,maximumNumberRecords",
+      "exportDataFilteredByTransactionNumberInterval" },
+    { "exportData", "startTransactionNumber,endTransactionNumber,clientId,maximumNumberRecords",
+      "exportDataFilteredByTransactionNumberIntervalAndClientId" },
+    { "exportData", "startDate,endDate,maximumNumberRecords", "exportDataFilteredByPeriodOfTime" },
+    { "exportData", "startDate,endDate,clientId,maximumNumberRecords", "exportDataFilteredByPeriodOfTimeAndClientId" },
+    { "exportData", "maximumNumberRecords", "exportData" }
+};
+
+/**
+ * Prefixes of the values of C enums whose names are not unique
+ */
+struct IdlEnumPrefix {
+    const char *enumName;
+    const char *prefix;
+};
+
+static const struct IdlEnumPrefix idlEnumPrefixes[] = {
+    { "AuthenticationResult", "auth_" },
+    { "UnblockResult", "unblock_" }
+};
+
+void idlUpperSnakeCase(const char *name,
+                       char *result)
+{
+    size_t length = 0;
+    size_t i;
+
+    for (i = 0; name[i] != '\0' && length + 2 < IDL_GENERATED_NAME_SIZE; i++) {
+        if (i > 0 && isupper((unsigned char) name[i])
+            && (islower((unsigned char) name[i - 1]) || isdigit((unsigned char) name[i - 1]))) {
+            result[length++] = '_';
+        }
+        result[length++] = (char) toupper((unsigned char) name[i]);
+    }
+    result[length] = '\0';
+}
+
+void idlExceptionCodeName(const struct IdlModule *module,
+                          unsigned int exceptionIndex,
+                          char *result)
+{
+    idlUpperSnakeCase(module->exceptions[exceptionIndex].name, result);
+}
+
+long idlExceptionCode(unsigned int exceptionIndex)
+{
+    return IDL_FIRST_EXCEPTION_CODE - (long) exceptionIndex;
+}
+
+void idlExceptionDocumentation(const struct IdlException *exception,
+                               const char *subject,
+                               char *result)
+{
+    char introduction[IDL_GENERATED_NAME_SIZE];
+    const char *rest = exception->documentation;
+    size_t length;
+
+    snprintf(introduction, sizeof introduction, "The exception %s is raised if", exception->name);
+    length = strlen(introduction);
+    if (strncmp(rest, introduction, length) == 0) {
+        rest += length;
+        while (*rest == ' ') {
+            rest++;
+        }
+        /* the subject ends the first line if nothing followed the introduction */
+        sprintf(result, "%s%s%s", subject, *rest == '\n' ? "" : " ", rest);
+    } else {
+        strcpy(result, rest);
+    }
+}
+
+static bool idlIsOverloaded(const struct IdlModule *module,
+                            unsigned int operationIndex)
+{
+    unsigned int i;
+
+    for (i = 0; i < module->operationCount; i++) {
+        if (i != operationIndex
+            && strcmp(module->operations[i].name, module->operations[operationIndex].name) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void idlCOperationName(const struct IdlModule *module,
+                       unsigned int operationIndex,
+                       char *result)
+{
+    const struct IdlOperation *operation = &module->operations[operationIndex];
+    char inputs[IDL_MAX_PARAMETERS * IDL_NAME_SIZE] = "";
+    char suffix[IDL_NAME_SIZE];
+    size_t i;
+
+    strcpy(result, operation->name);
+    if (!idlIsOverloaded(module, operationIndex)) {
+        return;
+    }
+    for (i = 0; i < operation->parameterCount; i++) {
+        if (operation->parameters[i].direction == idlIn) {
+            if (inputs[0] != '\0') {
+                strcat(inputs, ",");
+            }
+            strcat(inputs, operation->parameters[i].name);
+        }
+    }
+    for (i = 0; i < sizeof idlOverloadNames / sizeof idlOverloadNames[0]; i++) {
+        if (strcmp(idlOverloadNames[i].operation, operation->name) == 0
+            && strcmp(idlOverloadNames[i].inputs, inputs) == 0) {
+            strcpy(result, idlOverloadNames[i].cName);
+            return;
+        }
+    }
+    for (i = 0; i < operation->parameterCount; i++) {
+        if (operation->parameters[i].direction == idlIn
+            && strlen(result) + strlen(operation->parameters[i].name) < IDL_GENERATED_NAME_SIZE) {
+            idlUpperFirst(operation->parameters[i].name, suffix);
+            strcat(result, suffix);
+        }
+    }
+}
+
+static bool idlIsUniqueEnumValue(const struct IdlModule *module,
+                                 unsigned int enumIndex,
+                                 const char *value)
+{
+    unsigned int i;
+    unsigned int j;
+
+    for (i = 0; i < module->enumCount; i++) {
+        for (j = 0; i != enumIndex && j < module->enums[i].valueCount; j++) {
+            if (strcmp(module->enums[i].values[j], value) == 0) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+void idlCEnumValueName(const struct IdlModule *module,
+                       unsigned int enumIndex,
+                       unsigned int valueIndex,
+                       char *result)
+{
+    const struct IdlEnum *idlEnum = &module->enums[enumIndex];
+    const char *value = idlEnum->values[valueIndex];
+    size_t i;
+
+    if (idlIsUniqueEnumValue(module, enumIndex, value)) {
+        strcpy(result, value);
+        return;
+    }
+    for (i = 0; i < sizeof idlEnumPrefixes / sizeof idlEnumPrefixes[0]; i++) {
+        if (strcmp(idlEnumPrefixes[i].enumName, idlEnum->name) == 0) {
+            strcpy(result, idlEnumPrefixes[i].prefix);
+            strcat(result, value);
+            return;
+        }
+    }
+    idlLowerFirst(idlEnum->name, result);
+    strcat(result, "_");
+    strcat(result, value);
+}
+
+void idlLowerFirst(const char *name,
+                   char *result)
+{
+    strcpy(result, name);
+    result[0] = (char) tolower((unsigned char) result[0]);
+}
+
+void idlUpperFirst(const char *name,
+                   char *result)
+{
+    strcpy(result, name);
+    result[0] = (char) toupper((unsigned char) result[0]);
+}
+
+bool idlHasLength(const struct IdlParameter *parameter)
+{
+    return parameter->type == idlString || parameter->type == idlOctetSequence;
+}
+
+bool idlNextLine(const char **cursor,
+                 char *line)
+{
+    const char *end;
+    size_t length;
+
+    if (**cursor == '\0') {
+        return false;
+    }
+    end = strchr(*cursor, '\n');
+    if (end == NULL) {
+        end = *cursor + strlen(*cursor);
+    }
+    length = (size_t) (end - *cursor);
+    if (length >= IDL_LINE_SIZE) {
+        length = IDL_LINE_SIZE - 1;
+    }
+    memcpy(line, *cursor, length);
+    line[length] = '\0';
+    *cursor = *end == '\n' ? end + 1 : end;
+    return true;
+}
+
+const char *idlTagLine(const char *line,
+                       const char *tag,
+                       char *word)
+{
+    size_t tagLength = strlen(tag);
+    size_t length = 0;
+
+    if (strncmp(line, tag, tagLength) != 0 || (line[tagLength] != ' ' && line[tagLength] != '\t'
+                                                && line[tagLength] != '\0')) {
+        return NULL;
+    }
+    line += tagLength;
+    while (*line == ' ' || *line == '\t') {
+        line++;
+    }
+    while (*line != '\0' && *line != ' ' && *line != '\t' && length + 1 < IDL_NAME_SIZE) {
+        word[length++] = *line++;
+    }
+    word[length] = '\0';
+    while (*line == ' ' || *line == '\t') {
+        line++;
+    }
+    return line;
+}
+
+FILE *idlCreateFile(const char *directory,
+                    const char *path,
+                    char *error,
+                    size_t errorSize)
+{
+    char fullPath[4096];
+    FILE *file;
+    char *separator;
+    int length;
+
+    length = snprintf(fullPath, sizeof fullPath, "%s/%s", directory, path);
+    if (length < 0 || (size_t) length >= sizeof fullPath) {
+        snprintf(error, errorSize, "path of %s is too long", path);
+        return NULL;
+    }
+    for (separator = strchr(fullPath + 1, '/'); separator != NULL; separator = strchr(separator + 1, '/')) {
+        *separator = '\0';
+        if (mkdir(fullPath, 0755) != 0 && errno != EEXIST) {
+            snprintf(error, errorSize, "%s cannot be created: %s", fullPath, strerror(errno));
+            return NULL;
+        }
+        *separator = '/';
+    }
+    file = fopen(fullPath, "w");
+    if (file == NULL) {
+        snprintf(error, errorSize, "%s cannot be created: %s", fullPath, strerror(errno));
+    }
+    return file;
+}
+
+bool idlCloseFile(FILE *file,
+                  const char *path,
+                  char *error,
+                  size_t errorSize)
+{
+    bool failed = ferror(file) != 0;
+
+    if (fclose(file) != 0 || failed) {
+        snprintf(error, errorSize, "%s cannot be written", path);
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,436 @@
+#include <ctype.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "IdlParser.h"
+
+enum IdlTokenKind {
+idlTokenEnd, idlTokenIdentifier, idlTokenNumber, idlTokenSymbol
+};
+
+struct IdlLexer {
+    const char *text;
+    size_t position;
+    unsigned int line;
+    /* comment lines read since the last declaration */
+    char comment[IDL_DOCUMENTATION_SIZE];
+    size_t commentLength;
+    /* current token */
+    enum IdlTokenKind kind;
+    char token[IDL_NAME_SIZE];
+    char *error;
+    size_t errorSize;
+    bool failed;
+};
+
+static void idlFail(struct IdlLexer *lexer,
+                    const char *format,
+                    ...)
+{
+    va_list arguments;
+    int length;
+
+    if (lexer->failed) {
+        return;
+    }
+    lexer->failed = true;
+    length = snprintf(lexer->error, lexer->errorSize, "line %u: ", lexer->line);
+    if (length < 0 || (size_t) length >= lexer->errorSize) {
+        return;
+    }
+    va_start(arguments, format);
+    vsnprintf(lexer->error + length, lexer->errorSize - (size_t) length, format, arguments);
+    va_end(arguments);
+}
+
+static void idlAppendComment(struct IdlLexer *lexer,
+                             const char *start,
+                             size_t length)
+{
+    /* leading blanks and trailing white space of the comment line are dropped */
+    while (length > 0 && (*start == ' ' || *start == '\t' || *start == '/')) {
+        start++;
+        length--;
+    }
+    while (length > 0 && isspace((unsigned char) start[length - 1])) {
+        length--;
+    }
+    if (lexer->commentLength + length + 2 > sizeof lexer->comment) {
+        return;
+    }
+    memcpy(lexer->comment + lexer->commentLength, start, length);
+    lexer->commentLength += length;
+    lexer->comment[lexer->commentLength++] = '\n';
+    lexer->comment[lexer->commentLength] = '\0';
+}
+
+/**
+ * Reads the next token and collects the comment lines before it.
+ */
+static void idlNext(struct IdlLexer *lexer)
+{
+    const char *text = lexer->text;
+    size_t length = 0;
+
+    for (;;) {
+        char c = text[lexer->position];
+
+        if (c == '\n') {
+            lexer->line++;
+            lexer->position++;
+        } else if (isspace((unsigned char) c)) {
+            lexer->position++;
+        } else if (c == '/' && text[lexer->position + 1] == '/') {
+            size_t start = lexer->position + 2;
+            size_t end = start;
+
+            while (text[end] != '\0' && text[end] != '\n') {
+                end++;
+            }
+            idlAppendComment(lexer, text + start, end - start);
+            lexer->position = end;
+        } else {
+            break;
+        }
+    }
+
+    if (text[lexer->position] == '\0') {
+        lexer->kind = idlTokenEnd;
+        lexer->token[0] = '\0';
+        return;
+    }
+    if (isalpha((unsigned char) text[lexer->position]) || text[lexer->position] == '_') {
+        lexer->kind = idlTokenIdentifier;
+        while (isalnum((unsigned char) text[lexer->position]) || text[lexer->position] == '_') {
+            if (length + 1 < sizeof lexer->token) {
+                lexer->token[length++] = text[lexer->position];
+            }
+            lexer->position++;
+        }
+    } else if (isdigit((unsigned char) text[lexer->position])
+               || (text[lexer->position] == '-' && isdigit((unsigned char) text[lexer->position + 1]))) {
+        lexer->kind = idlTokenNumber;
+        do {
+            if (length + 1 < sizeof lexer->token) {
+                lexer->token[length++] = text[lexer->position];
+            }
+            lexer->position++;
+        } while (isdigit((unsigned char) text[lexer->position]));
+    } else {
+        lexer->kind = idlTokenSymbol;
+        lexer->token[length++] = text[lexer->position++];
+    }
+    lexer->token[length] = '\0';
+}
+
+static bool idlIs(const struct IdlLexer *lexer,
+                  const char *token)
+{
+    return lexer->kind != idlTokenEnd && strcmp(lexer->token, token) == 0;
+}
+
+static void idlExpect(struct IdlLexer *lexer,
+                      const char *token)
+{
+    if (!idlIs(lexer, token)) {
+        idlFail(lexer, "expected '%s' instead of '%s'", token, lexer->token);
+        return;
+    }
+    idlNext(lexer);
+}
+
+static void idlIdentifier(struct IdlLexer *lexer,
+                          char *name)
+{
+    if (lexer->kind != idlTokenIdentifier) {
+        idlFail(lexer, "expected an identifier instead of '%s'", lexer->token);
+        return;
+    }
+    strcpy(name, lexer->token);
+    idlNext(lexer);
+}
+
+/**
+ * Hands the collected comment lines to a declaration and starts a new collection.
+ */
+static void idlTakeComment(struct IdlLexer *lexer,
+                           char *documentation)
+{
+    memcpy(documentation, lexer->comment, lexer->commentLength + 1);
+    lexer->commentLength = 0;
+    lexer->comment[0] = '\0';
+}
+
+static int idlFind(const char *name,
+                   const char *names,
+                   size_t stride,
+                   unsigned int count)
+{
+    unsigned int i;
+
+    for (i = 0; i < count; i++) {
+        if (strcmp(names + i * stride, name) == 0) {
+            return (int) i;
+        }
+    }
+    return -1;
+}
+
+static void idlParseType(struct IdlLexer *lexer,
+                         const struct IdlModule *module,
+                         struct IdlParameter *parameter)
+{
+    int enumIndex;
+
+    parameter->bound = 0;
+    parameter->enumIndex = 0;
+    if (idlIs(lexer, "short")) {
+        parameter->type = idlShort;
+        idlNext(lexer);
+    } else if (idlIs(lexer, "long")) {
+        parameter->type = idlLong;
+        idlNext(lexer);
+    } else if (idlIs(lexer, "unsigned")) {
+        idlNext(lexer);
+        idlExpect(lexer, "long");
+        parameter->type = idlUnsignedLong;
+    } else if (idlIs(lexer, "string")) {
+        parameter->type = idlString;
+        idlNext(lexer);
+        if (idlIs(lexer, "<")) {
+            idlNext(lexer);
+            if (lexer->kind != idlTokenNumber) {
+                idlFail(lexer, "expected the bound of the string instead of '%s'", lexer->token);
+                return;
+            }
+            parameter->bound = (unsigned int) strtoul(lexer->token, NULL, 10);
+            idlNext(lexer);
+            idlExpect(lexer, ">");
+        }
+    } else if (idlIs(lexer, "octet")) {
+        /* only sequences of octets are used, the brackets follow the parameter name */
+        parameter->type = idlOctetSequence;
+        idlNext(lexer);
+    } else if (lexer->kind == idlTokenIdentifier && strcmp(lexer->token, module->dateTimeName) == 0) {
+        parameter->type = idlDateTime;
+        idlNext(lexer);
+    } else if (lexer->kind == idlTokenIdentifier
+               && (enumIndex = idlFind(lexer->token, module->enums[0].name, sizeof module->enums[0],
+                                       module->enumCount)) >= 0) {
+        parameter->type = idlEnum;
+        parameter->enumIndex = (unsigned int) enumIndex;
+        idlNext(lexer);
+    } else {
+        idlFail(lexer, "unknown type '%s'", lexer->token);
+    }
+}
+
+static void idlParseOperation(struct IdlLexer *lexer,
+                              struct IdlModule *module)
+{
+    struct IdlOperation *operation;
+
+    if (module->operationCount == IDL_MAX_OPERATIONS) {
+        idlFail(lexer, "too many operations");
+        return;
+    }
+    operation = &module->operations[module->operationCount++];
+    memset(operation, 0, sizeof *operation);
+    idlTakeComment(lexer, operation->documentation);
+    idlExpect(lexer, "short");
+    idlIdentifier(lexer, operation->name);
+    idlExpect(lexer, "(");
+    while (!lexer->failed && !idlIs(lexer, ")")) {
+        struct IdlParameter *parameter;
+
+        if (operation->parameterCount == IDL_MAX_PARAMETERS) {
+            idlFail(lexer, "too many parameters of %s", operation->name);
+            return;
+        }
+        parameter = &operation->parameters[operation->parameterCount++];
+        if (idlIs(lexer, "in")) {
+            parameter->direction = idlIn;
+        } else if (idlIs(lexer, "out")) {
+            parameter->direction = idlOut;
+        } else {
+            idlFail(lexer, "expected 'in' or 'out' instead of '%s'", lexer->token);
+            return;
+        }
+        idlNext(lexer);
+        idlParseType(lexer, module, parameter);
+        idlIdentifier(lexer, parameter->name);
+        if (parameter->type == idlOctetSequence) {
+            idlExpect(lexer, "[");
+            idlExpect(lexer, "]");
+        }
+        if (idlIs(lexer, ",")) {
+            idlNext(lexer);
+        }
+    }
+    idlExpect(lexer, ")");
+    if (idlIs(lexer, "raises")) {
+        idlNext(lexer);
+        idlExpect(lexer, "(");
+        while (!lexer->failed && !idlIs(lexer, ")")) {
+            int index = idlFind(lexer->token, module->exceptions[0].name, sizeof module->exceptions[0],
+                                module->exceptionCount);
+
+            if (index < 0) {
+                idlFail(lexer, "unknown exception '%s'", lexer->token);
+                return;
+            }
+            if (operation->raiseCount == IDL_MAX_RAISES) {
+                idlFail(lexer, "too many exceptions raised by %s", operation->name);
+                return;
+            }
+            operation->raises[operation->raiseCount++] = (unsigned int) index;
+            idlNext(lexer);
+            if (idlIs(lexer, ",")) {
+                idlNext(lexer);
+            }
+        }
+        idlExpect(lexer, ")");
+    }
+    idlExpect(lexer, ";");
+}
+
+static void idlParseDeclaration(struct IdlLexer *lexer,
+                                struct IdlModule *module)
+{
+    if (idlIs(lexer, "native")) {
+        /* the comment of the native type is not kept */
+        idlTakeComment(lexer, (char [IDL_DOCUMENTATION_SIZE]) { 0 });
+        idlNext(lexer);
+        idlIdentifier(lexer, module->dateTimeName);
+        idlExpect(lexer, ";");
+    } else if (idlIs(lexer, "const")) {
+        struct IdlConstant *constant;
+
+        if (module->constantCount == IDL_MAX_CONSTANTS) {
+            idlFail(lexer, "too many constants");
+            return;
+        }
+        constant = &module->constants[module->constantCount++];
+        idlTakeComment(lexer, constant->documentation);
+        idlNext(lexer);
+        idlExpect(lexer, "short");
+        idlIdentifier(lexer, constant->name);
+        idlExpect(lexer, "=");
+        if (lexer->kind != idlTokenNumber) {
+            idlFail(lexer, "expected the value of %s instead of '%s'", constant->name, lexer->token);
+            return;
+        }
+        constant->value = strtol(lexer->token, NULL, 10);
+        idlNext(lexer);
+        idlExpect(lexer, ";");
+    } else if (idlIs(lexer, "enum")) {
+        struct IdlEnum *idlEnum;
+
+        if (module->enumCount == IDL_MAX_ENUMS) {
+            idlFail(lexer, "too many enums");
+            return;
+        }
+        idlEnum = &module->enums[module->enumCount++];
+        idlTakeComment(lexer, idlEnum->documentation);
+        idlNext(lexer);
+        idlIdentifier(lexer, idlEnum->name);
+        idlExpect(lexer, "{");
+        while (!lexer->failed && !idlIs(lexer, "}")) {
+            if (idlEnum->valueCount == IDL_MAX_ENUM_VALUES) {
+                idlFail(lexer, "too many values of %s", idlEnum->name);
+                return;
+            }
+            idlIdentifier(lexer, idlEnum->values[idlEnum->valueCount++]);
+            if (idlIs(lexer, ",")) {
+                idlNext(lexer);
+            }
+        }
+        idlExpect(lexer, "}");
+        idlExpect(lexer, ";");
+    } else if (idlIs(lexer, "exception")) {
+        struct IdlException *exception;
+
+        if (module->exceptionCount == IDL_MAX_EXCEPTIONS) {
+            idlFail(lexer, "too many exceptions");
+            return;
+        }
+        exception = &module->exceptions[module->exceptionCount++];
+        idlTakeComment(lexer, exception->documentation);
+        idlNext(lexer);
+        idlIdentifier(lexer, exception->name);
+        idlExpect(lexer, "{");
+        idlExpect(lexer, "}");
+        idlExpect(lexer, ";");
+    } else if (idlIs(lexer, "interface")) {
+        /* the comment of the interface is not kept */
+        idlTakeComment(lexer, (char [IDL_DOCUMENTATION_SIZE]) { 0 });
+        idlNext(lexer);
+        idlIdentifier(lexer, module->interfaceName);
+        idlExpect(lexer, "{");
+        while (!lexer->failed && !idlIs(lexer, "}")) {
+            idlParseOperation(lexer, module);
+        }
+        idlExpect(lexer, "}");
+        idlExpect(lexer, ";");
+    } else {
+        idlFail(lexer, "unexpected '%s'", lexer->token);
+    }
+}
+
+bool idlParseFile(const char *path,
+                  struct IdlModule *module,
+                  char *error,
+                  size_t errorSize)
+{
+    struct IdlLexer lexer;
+    FILE *file;
+    char *text;
+    long size;
+
+    memset(module, 0, sizeof *module);
+    file = fopen(path, "rb");
+    if (file == NULL) {
+        snprintf(error, errorSize, "%s cannot be opened", path);
+        return false;
+    }
+    if (fseek(file, 0, SEEK_END) != 0 || (size = ftell(file)) < 0 || fseek(file, 0, SEEK_SET) != 0
+        || (text = malloc((size_t) size + 1)) == NULL) {
+        fclose(file);
+        snprintf(error, errorSize, "%s cannot be read", path);
+        return false;
+    }
+    if (fread(text, 1, (size_t) size, file) != (size_t) size) {
+        free(text);
+        fclose(file);
+        snprintf(error, errorSize, "%s cannot be read", path);
+        return false;
+    }
+    fclose(file);
+    text[size] = '\0';
+
+    memset(&lexer, 0, sizeof lexer);
+    lexer.text = text;
+    lexer.line = 1;
+    lexer.error = error;
+    lexer.errorSize = errorSize;
+    idlNext(&lexer);
+    idlExpect(&lexer, "module");
+    idlIdentifier(&lexer, module->name);
+    idlExpect(&lexer, "{");
+    while (!lexer.failed && !idlIs(&lexer, "}")) {
+        if (lexer.kind == idlTokenEnd) {
+            idlFail(&lexer, "unexpected end of file");
+            break;
+        }
+        idlParseDeclaration(&lexer, module);
+    }
+    idlExpect(&lexer, "}");
+    idlExpect(&lexer, ";");
+    if (!lexer.failed && lexer.kind != idlTokenEnd) {
+        idlFail(&lexer, "unexpected '%s' after the module", lexer.token);
+    }
+    free(text);
+    return !lexer.failed;
+}
@@ -0,0 +1,114 @@
+#ifndef SEAPI_IDL_PARSER_H
+#define SEAPI_IDL_PARSER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * This header file defines the parser for the subset of OMG IDL that is used by SEAPI_version1.0.1.idl:
+ * one module with native types, constants of type short, enums, exceptions without members and one interface
+ * whose operations return short, take in and out parameters and raise exceptions. Operations may be overloaded.
+ *
+ * The comment lines (//) that precede a declaration are kept as its documentation.
+ */
+
+/**
+ * Limits of the parsed module
+ */
+#define IDL_NAME_SIZE 64
+#define IDL_MAX_CONSTANTS 16
+#define IDL_MAX_ENUMS 16
+#define IDL_MAX_ENUM_VALUES 16
+#define IDL_MAX_EXCEPTIONS 64
+#define IDL_MAX_OPERATIONS 64
+#define IDL_MAX_PARAMETERS 16
+#define IDL_MAX_RAISES 16
+#define IDL_DOCUMENTATION_SIZE 8192
+
+/**
+ * Represents the types of parameters. Sequences are written as "octet name[]" in the IDL.
+ */
+enum IdlTypeKind {
+idlShort, idlLong, idlUnsignedLong, idlString, idlOctetSequence, idlDateTime, idlEnum
+};
+
+/**
+ * Represents the direction of a parameter.
+ */
+enum IdlDirection {
+idlIn, idlOut
+};
+
+struct IdlParameter {
+    char name[IDL_NAME_SIZE];
+    enum IdlDirection direction;
+    enum IdlTypeKind type;
+    /* maximum length of a bounded string, 0 if unbounded */
+    unsigned int bound;
+    /* index of the enum if type is idlEnum */
+    unsigned int enumIndex;
+};
+
+struct IdlOperation {
+    char name[IDL_NAME_SIZE];
+    char documentation[IDL_DOCUMENTATION_SIZE];
+    struct IdlParameter parameters[IDL_MAX_PARAMETERS];
+    unsigned int parameterCount;
+    /* indexes of the raised exceptions */
+    unsigned int raises[IDL_MAX_RAISES];
+    unsigned int raiseCount;
+};
+
+struct IdlEnum {
+    char name[IDL_NAME_SIZE];
+    char documentation[IDL_DOCUMENTATION_SIZE];
+    char values[IDL_MAX_ENUM_VALUES][IDL_NAME_SIZE];
+    unsigned int valueCount;
+};
+
+struct IdlConstant {
+    char name[IDL_NAME_SIZE];
+    char documentation[IDL_DOCUMENTATION_SIZE];
+    long value;
+};
+
+struct IdlException {
+    char name[IDL_NAME_SIZE];
+    char documentation[IDL_DOCUMENTATION_SIZE];
+};
+
+/**
+ * Parsed module. The declarations are kept in the order of the IDL file.
+ */
+struct IdlModule {
+    char name[IDL_NAME_SIZE];
+    char interfaceName[IDL_NAME_SIZE];
+    char dateTimeName[IDL_NAME_SIZE];
+    struct IdlConstant constants[IDL_MAX_CONSTANTS];
+    unsigned int constantCount;
+    struct IdlEnum enums[IDL_MAX_ENUMS];
+    unsigned int enumCount;
+    struct IdlException exceptions[IDL_MAX_EXCEPTIONS];
+    unsigned int exceptionCount;
+    struct IdlOperation operations[IDL_MAX_OPERATIONS];
+    unsigned int operationCount;
+};
+
+/**
+ * Parses an IDL file.
+ * @param[in] path
+ *                path of the IDL file [REQUIRED]
+ * @param[out] module
+ *                parsed module [REQUIRED]
+ * @param[out] error
+ *                receives a message with the line number if the file could not be parsed [REQUIRED]
+ * @param[in] errorSize
+ *                size of the array that represents the error [REQUIRED]
+ * @return true if the file has been parsed, false otherwise
+ */
+bool idlParseFile(const char *path,
+                  struct IdlModule *module,
+                  char *error,
+                  size_t errorSize);
+
+#endif
@@ -0,0 +1,240 @@
+/* timegm and gmtime_r are not part of ISO C */
+#define _DEFAULT_SOURCE
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "SeApiWireRuntime.h"
+
+/**
+ * Maximum number of bytes of a varint of 64 bits
+ */
+#define SE_API_WIRE_VARINT_SIZE 10
+
+void seApiWireClientInit(struct SeApiWireClient *client,
+                         SeApiWireTransport transport,
+                         void *transportContext)
+{
+    memset(client, 0, sizeof *client);
+    client->transport = transport;
+    client->transportContext = transportContext;
+}
+
+void seApiWireClientClose(struct SeApiWireClient *client)
+{
+    seApiWireWriterFree(&client->request);
+    seApiWireWriterFree(&client->response);
+}
+
+short int seApiWireClientCall(struct SeApiWireClient *client,
+                              struct SeApiWireReader *response)
+{
+    short int result;
+    int64_t status;
+
+    seApiWireReaderInit(response, NULL, 0);
+    if (client->request.result != EXECUTION_OK) {
+        return client->request.result;
+    }
+    seApiWireWriterReset(&client->response);
+    result = client->transport(client->transportContext, client->request.data, client->request.length,
+                               &client->response);
+    if (result != EXECUTION_OK) {
+        return result;
+    }
+    if (client->response.result != EXECUTION_OK) {
+        return client->response.result;
+    }
+    seApiWireReaderInit(response, client->response.data, client->response.length);
+    status = seApiWireGetSigned(response);
+    if (response->result != EXECUTION_OK) {
+        return response->result;
+    }
+    if (status < INT16_MIN || status > INT16_MAX) {
+        return ERROR_PARAMETER_MISMATCH;
+    }
+    return (short int) status;
+}
+
+int seApiWireHasOutputs(short int status)
+{
+    return status == EXECUTION_OK || status == AUTHENTICATION_FAILED || status == UNBLOCK_FAILED
+           || status == ERROR_CERTIFICATE_EXPIRED;
+}
+
+void seApiWireWriterReset(struct SeApiWireWriter *writer)
+{
+    writer->length = 0;
+    writer->result = EXECUTION_OK;
+}
+
+void seApiWireWriterFree(struct SeApiWireWriter *writer)
+{
+    free(writer->data);
+    memset(writer, 0, sizeof *writer);
+}
+
+static unsigned char *seApiWireReserve(struct SeApiWireWriter *writer,
+                                       uint64_t size)
+{
+    if (writer->result != EXECUTION_OK) {
+        return NULL;
+    }
+    if (size > SIZE_MAX - writer->length) {
+        writer->result = ERROR_STORAGE_FAILURE;
+        return NULL;
+    }
+    if (writer->length + size > writer->capacity) {
+        size_t capacity = writer->capacity != 0 ? writer->capacity : 256;
+        unsigned char *grown;
+
+        while (capacity < writer->length + size) {
+            capacity = capacity <= SIZE_MAX / 2 ? capacity * 2 : writer->length + (size_t) size;
+        }
+        grown = realloc(writer->data, capacity);
+        if (grown == NULL) {
+            writer->result = ERROR_STORAGE_FAILURE;
+            return NULL;
+        }
+        writer->data = grown;
+        writer->capacity = capacity;
+    }
+    return writer->data + writer->length;
+}
+
+void seApiWirePutUnsigned(struct SeApiWireWriter *writer,
+                          uint64_t value)
+{
+    unsigned char *target = seApiWireReserve(writer, SE_API_WIRE_VARINT_SIZE);
+    size_t length = 0;
+
+    if (target == NULL) {
+        return;
+    }
+    while (value >= 0x80) {
+        target[length++] = (unsigned char) (value | 0x80);
+        value >>= 7;
+    }
+    target[length++] = (unsigned char) value;
+    writer->length += length;
+}
+
+void seApiWirePutSigned(struct SeApiWireWriter *writer,
+                        int64_t value)
+{
+    seApiWirePutUnsigned(writer, ((uint64_t) value << 1) ^ (uint64_t) (value >> 63));
+}
+
+void seApiWirePutBytes(struct SeApiWireWriter *writer,
+                       const unsigned char *data,
+                       uint64_t dataLength)
+{
+    unsigned char *target;
+
+    seApiWirePutUnsigned(writer, dataLength);
+    target = seApiWireReserve(writer, dataLength);
+    if (target == NULL || dataLength == 0) {
+        return;
+    }
+    memcpy(target, data, (size_t) dataLength);
+    writer->length += (size_t) dataLength;
+}
+
+void seApiWirePutTime(struct SeApiWireWriter *writer,
+                      const struct tm *time)
+{
+    struct tm copy = *time;
+
+    seApiWirePutSigned(writer, (int64_t) timegm(&copy));
+}
+
+void seApiWireReaderInit(struct SeApiWireReader *reader,
+                         const unsigned char *data,
+                         size_t dataLength)
+{
+    reader->data = data;
+    reader->length = dataLength;
+    reader->position = 0;
+    reader->result = EXECUTION_OK;
+}
+
+uint64_t seApiWireGetUnsigned(struct SeApiWireReader *reader)
+{
+    uint64_t value = 0;
+    unsigned int shift = 0;
+
+    while (reader->result == EXECUTION_OK) {
+        unsigned char byte;
+
+        if (reader->position == reader->length || shift >= 64) {
+            reader->result = ERROR_PARAMETER_MISMATCH;
+            break;
+        }
+        byte = reader->data[reader->position++];
+        value |= (uint64_t) (byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0) {
+            return value;
+        }
+        shift += 7;
+    }
+    return 0;
+}
+
+int64_t seApiWireGetSigned(struct SeApiWireReader *reader)
+{
+    uint64_t value = seApiWireGetUnsigned(reader);
+
+    return (int64_t) (value >> 1) ^ -(int64_t) (value & 1);
+}
+
+const unsigned char *seApiWireGetBytes(struct SeApiWireReader *reader,
+                                       uint64_t *dataLength)
+{
+    uint64_t length = seApiWireGetUnsigned(reader);
+    const unsigned char *data;
+
+    *dataLength = 0;
+    if (reader->result != EXECUTION_OK) {
+        return NULL;
+    }
+    if (length > reader->length - reader->position) {
+        reader->result = ERROR_PARAMETER_MISMATCH;
+        return NULL;
+    }
+    data = reader->data + reader->position;
+    reader->position += (size_t) length;
+    *dataLength = length;
+    return data;
+}
+
+unsigned char *seApiWireCopyBytes(struct SeApiWireReader *reader,
+                                  unsigned long int *dataLength)
+{
+    uint64_t length;
+    const unsigned char *data = seApiWireGetBytes(reader, &length);
+    unsigned char *copy;
+
+    *dataLength = 0;
+    if (data == NULL || length == 0) {
+        return NULL;
+    }
+    copy = malloc((size_t) length);
+    if (copy == NULL) {
+        reader->result = ERROR_STORAGE_FAILURE;
+        return NULL;
+    }
+    memcpy(copy, data, (size_t) length);
+    *dataLength = (unsigned long int) length;
+    return copy;
+}
+
+void seApiWireGetTime(struct SeApiWireReader *reader,
+                      struct tm *time)
+{
+    time_t seconds = (time_t) seApiWireGetSigned(reader);
+
+    memset(time, 0, sizeof *time);
+    if (reader->result == EXECUTION_OK && gmtime_r(&seconds, time) == NULL) {
+        reader->result = ERROR_PARAMETER_MISMATCH;
+    }
+}
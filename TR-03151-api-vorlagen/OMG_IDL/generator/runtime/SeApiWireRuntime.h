@@ -0,0 +1,156 @@
+#ifndef SEAPI_WIRE_RUNTIME_H
+#define SEAPI_WIRE_RUNTIME_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "Exception.h"
+#include "Constant.h"
+
+/**
+ * This header file defines the primitives of the wire protocol of the SE API, on top of which the IDL generator
+ * emits the stubs and the skeleton of every operation (SeApiWire.h and SeApiWire.c). Exception.h and Constant.h
+ * are the files generated next to them.
+ *
+ * Writers and readers keep the first error in their member result and ignore all further calls, so that the
+ * generated code checks the result once per message instead of once per value.
+ */
+
+/**
+ * Growable buffer into which a message is encoded.
+ */
+struct SeApiWireWriter {
+    unsigned char *data;
+    size_t length;
+    size_t capacity;
+    short int result;
+};
+
+/**
+ * Message from which values are decoded in place.
+ */
+struct SeApiWireReader {
+    const unsigned char *data;
+    size_t length;
+    size_t position;
+    short int result;
+};
+
+/**
+ * Callback that delivers an encoded request to the SE API and receives the encoded response, e.g. over a socket.
+ * The generated function seApiSkeletonDispatch has this type, so that a stub can call a skeleton in the same process.
+ * @param[in] transportContext
+ *                context that has been passed to seApiWireClientInit [OPTIONAL]
+ * @param[in] request
+ *                encoded request [REQUIRED]
+ * @param[in] requestLength
+ *                length of the array that represents the request [REQUIRED]
+ * @param[out] response
+ *                reset writer that receives the encoded response [REQUIRED]
+ * @return EXECUTION_OK if a response has been received, an error code otherwise
+ */
+typedef short int (*SeApiWireTransport)(void *transportContext,
+                                        const unsigned char *request,
+                                        size_t requestLength,
+                                        struct SeApiWireWriter *response);
+
+/**
+ * Client of the generated stubs. The buffers of the messages are reused by all calls, so a client SHALL only be
+ * used by one thread at a time.
+ */
+struct SeApiWireClient {
+    SeApiWireTransport transport;
+    void *transportContext;
+    struct SeApiWireWriter request;
+    struct SeApiWireWriter response;
+};
+
+/**
+ * Initializes a client.
+ * @param[out] client
+ *                client to be initialized [REQUIRED]
+ * @param[in] transport
+ *                callback that exchanges the messages [REQUIRED]
+ * @param[in] transportContext
+ *                context passed to the transport [OPTIONAL]
+ */
+void seApiWireClientInit(struct SeApiWireClient *client,
+                         SeApiWireTransport transport,
+                         void *transportContext);
+
+/**
+ * Releases the buffers of a client.
+ */
+void seApiWireClientClose(struct SeApiWireClient *client);
+
+/**
+ * Sends the request that has been encoded into client->request and decodes the status of the response.
+ * @param[in] client
+ *                initialized client [REQUIRED]
+ * @param[out] response
+ *                reader positioned behind the status, i.e. at the output parameters [REQUIRED]
+ * @return the status of the response, the error code of the transport or ERROR_PARAMETER_MISMATCH if the response
+ *         is malformed
+ */
+short int seApiWireClientCall(struct SeApiWireClient *client,
+                              struct SeApiWireReader *response);
+
+/**
+ * Returns whether a response with the status carries the output parameters.
+ */
+int seApiWireHasOutputs(short int status);
+
+/**
+ * Empties a writer and clears its result.
+ */
+void seApiWireWriterReset(struct SeApiWireWriter *writer);
+
+/**
+ * Releases the memory of a writer.
+ */
+void seApiWireWriterFree(struct SeApiWireWriter *writer);
+
+/**
+ * Encoders. A writer that cannot grow gets the result ERROR_STORAGE_FAILURE.
+ */
+void seApiWirePutUnsigned(struct SeApiWireWriter *writer,
+                          uint64_t value);
+void seApiWirePutSigned(struct SeApiWireWriter *writer,
+                        int64_t value);
+void seApiWirePutBytes(struct SeApiWireWriter *writer,
+                       const unsigned char *data,
+                       uint64_t dataLength);
+void seApiWirePutTime(struct SeApiWireWriter *writer,
+                      const struct tm *time);
+
+/**
+ * Initializes a reader over a message.
+ */
+void seApiWireReaderInit(struct SeApiWireReader *reader,
+                         const unsigned char *data,
+                         size_t dataLength);
+
+/**
+ * Decoders. A reader that reaches the end of the message gets the result ERROR_PARAMETER_MISMATCH and returns 0.
+ */
+uint64_t seApiWireGetUnsigned(struct SeApiWireReader *reader);
+int64_t seApiWireGetSigned(struct SeApiWireReader *reader);
+
+/**
+ * Returns the address of a byte array within the message and its length.
+ */
+const unsigned char *seApiWireGetBytes(struct SeApiWireReader *reader,
+                                       uint64_t *dataLength);
+
+/**
+ * Returns a copy of a byte array that the caller releases with free, or NULL for an empty array. A reader whose copy
+ * cannot be allocated gets the result ERROR_STORAGE_FAILURE.
+ */
+unsigned char *seApiWireCopyBytes(struct SeApiWireReader *reader,
+                                  unsigned long int *dataLength);
+
+void seApiWireGetTime(struct SeApiWireReader *reader,
+                      struct tm *time);
+
+#endif
@@ -0,0 +1,162 @@
+package de.bsi.seapi.wire;
+
+import java.nio.charset.StandardCharsets;
+import java.time.Instant;
+import java.time.ZoneOffset;
+import java.time.ZonedDateTime;
+import java.util.Arrays;
+
+import de.bsi.seapi.Constant;
+import de.bsi.seapi.ErrorCodes;
+
+/**
+ * This class defines the decoder of the messages of the wire protocol of the SE API, see WireWriter. A message that
+ * ends before all of its values have been decoded or contains values out of range is rejected with an
+ * IllegalArgumentException
+ */
+public final class WireReader {
+
+    private final byte[] data;
+
+    private final int length;
+
+    private int position;
+
+    /**
+     * Constructs a new reader over a message
+     * 
+     * @param data
+     *            the encoded message
+     */
+    public WireReader(byte[] data) {
+        this(data, data.length);
+    }
+
+    /**
+     * Constructs a new reader over a message at the start of an array
+     * 
+     * @param data
+     *            array that contains the encoded message
+     * @param length
+     *            length of the message
+     */
+    public WireReader(byte[] data, int length) {
+        this.data = data;
+        this.length = length;
+    }
+
+    /**
+     * This function returns whether a response with the status carries the output parameters of the function
+     * 
+     * @param status
+     *            status of the response
+     * @return true for EXECUTION_OK, AUTHENTICATION_FAILED, UNBLOCK_FAILED and ERROR_CERTIFICATE_EXPIRED
+     */
+    public static boolean hasOutputs(short status) {
+        return status == Constant.EXECUTION_OK || status == Constant.AUTHENTICATION_FAILED
+                || status == Constant.UNBLOCK_FAILED || status == ErrorCodes.ERROR_CERTIFICATE_EXPIRED;
+    }
+
+    /**
+     * This function decodes an unsigned 64-bit value
+     * 
+     * @return the decoded value, interpreted as unsigned
+     */
+    public long getUnsigned() {
+        long value = 0;
+
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (position == length) {
+                break;
+            }
+            byte next = data[position++];
+            value |= (long) (next & 0x7f) << shift;
+            if (next >= 0) {
+                return value;
+            }
+        }
+        throw new IllegalArgumentException("malformed message");
+    }
+
+    /**
+     * This function decodes a signed 64-bit value
+     * 
+     * @return the decoded value
+     */
+    public long getSigned() {
+        long value = getUnsigned();
+
+        return (value >>> 1) ^ -(value & 1);
+    }
+
+    /**
+     * This function decodes the status of a response
+     * 
+     * @return the decoded status
+     */
+    public short getStatus() {
+        long status = getSigned();
+
+        if (status < Short.MIN_VALUE || status > Short.MAX_VALUE) {
+            throw new IllegalArgumentException("malformed status " + status);
+        }
+        return (short) status;
+    }
+
+    /**
+     * This function decodes the ordinal of an enum value
+     * 
+     * @param count
+     *            number of the values of the enum
+     * @return the decoded ordinal
+     */
+    public int getIndex(int count) {
+        long index = getUnsigned();
+
+        if (index < 0 || index >= count) {
+            throw new IllegalArgumentException("malformed enum value " + index);
+        }
+        return (int) index;
+    }
+
+    /**
+     * This function decodes a byte array
+     * 
+     * @return a copy of the decoded array
+     */
+    public byte[] getBytes() {
+        long arrayLength = getUnsigned();
+
+        if (arrayLength < 0 || arrayLength > length - position) {
+            throw new IllegalArgumentException("malformed message");
+        }
+        byte[] value = Arrays.copyOfRange(data, position, position + (int) arrayLength);
+        position += (int) arrayLength;
+        return value;
+    }
+
+    /**
+     * This function decodes a string encoded as UTF-8
+     * 
+     * @return the decoded string
+     */
+    public String getString() {
+        long stringLength = getUnsigned();
+
+        if (stringLength < 0 || stringLength > length - position) {
+            throw new IllegalArgumentException("malformed message");
+        }
+        String value = new String(data, position, (int) stringLength, StandardCharsets.UTF_8);
+        position += (int) stringLength;
+        return value;
+    }
+
+    /**
+     * This function decodes a point in time
+     * 
+     * @return the decoded point in time in UTC
+     */
+    public ZonedDateTime getTime() {
+        return ZonedDateTime.ofInstant(Instant.ofEpochSecond(getSigned()), ZoneOffset.UTC);
+    }
+}
@@ -0,0 +1,24 @@
+package de.bsi.seapi.wire;
+
+import java.io.IOException;
+
+/**
+ * This interface defines the transport of the wire protocol of the SE API, e.g. over a socket. The generated class
+ * SeApiWireSkeleton implements it, so that a SeApiWireStub can call a skeleton in the same process
+ */
+@FunctionalInterface
+public interface WireTransport {
+
+    /**
+     * This function delivers an encoded request to the SE API and returns the encoded response
+     * 
+     * @param request
+     *            array that contains the encoded request
+     * @param requestLength
+     *            number of bytes of the request at the start of the array
+     * @return the encoded response
+     * @throws IOException
+     *             if the request cannot be delivered or the response cannot be received
+     */
+    byte[] exchange(byte[] request, int requestLength) throws IOException;
+}
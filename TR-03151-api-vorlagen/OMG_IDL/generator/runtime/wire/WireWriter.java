@@ -0,0 +1,150 @@
+package de.bsi.seapi.wire;
+
+import java.nio.charset.StandardCharsets;
+import java.time.ZonedDateTime;
+import java.util.Arrays;
+
+/**
+ * This class defines the encoder of the messages of the wire protocol of the SE API. The values are encoded as in
+ * SeApiWireRuntime.c: unsigned values and enums as varint, signed values and points in time as zigzag-encoded
+ * varint, strings (UTF-8) and byte arrays as varint length followed by the bytes. Absent values (null) are encoded
+ * as zero and as empty arrays
+ */
+public final class WireWriter {
+
+    private byte[] data = new byte[256];
+
+    private int length;
+
+    /**
+     * This function empties the writer, so that its buffer is reused for the next message
+     */
+    public void reset() {
+        length = 0;
+    }
+
+    /**
+     * This function returns the buffer of the writer, whose first length() bytes are the encoded message
+     * 
+     * @return buffer of the writer
+     */
+    public byte[] data() {
+        return data;
+    }
+
+    /**
+     * This function returns the length of the encoded message
+     * 
+     * @return length of the encoded message
+     */
+    public int length() {
+        return length;
+    }
+
+    /**
+     * This function returns a copy of the encoded message
+     * 
+     * @return copy of the encoded message
+     */
+    public byte[] toByteArray() {
+        return Arrays.copyOf(data, length);
+    }
+
+    private void reserve(int size) {
+        if (size > data.length - length) {
+            data = Arrays.copyOf(data, Math.max(Math.addExact(length, size), data.length * 2));
+        }
+    }
+
+    /**
+     * This function encodes an unsigned 64-bit value
+     * 
+     * @param value
+     *            value to be encoded, interpreted as unsigned
+     */
+    public void putUnsigned(long value) {
+        reserve(10);
+        while ((value & ~0x7fL) != 0) {
+            data[length++] = (byte) (value | 0x80);
+            value >>>= 7;
+        }
+        data[length++] = (byte) value;
+    }
+
+    /**
+     * This function encodes a signed 64-bit value
+     * 
+     * @param value
+     *            value to be encoded
+     */
+    public void putSigned(long value) {
+        putUnsigned((value << 1) ^ (value >> 63));
+    }
+
+    /**
+     * This function encodes the value of a LongHolder
+     * 
+     * @param value
+     *            value to be encoded, interpreted as unsigned [OPTIONAL]
+     */
+    public void putNullableUnsigned(Long value) {
+        putUnsigned(value != null ? value : 0);
+    }
+
+    /**
+     * This function encodes the value of a ShortHolder
+     * 
+     * @param value
+     *            value to be encoded [OPTIONAL]
+     */
+    public void putNullableSigned(Short value) {
+        putSigned(value != null ? value : 0);
+    }
+
+    /**
+     * This function encodes a byte array
+     * 
+     * @param value
+     *            array to be encoded [OPTIONAL]
+     */
+    public void putBytes(byte[] value) {
+        if (value == null) {
+            putUnsigned(0);
+            return;
+        }
+        putUnsigned(value.length);
+        reserve(value.length);
+        System.arraycopy(value, 0, data, length, value.length);
+        length += value.length;
+    }
+
+    /**
+     * This function encodes a string as UTF-8
+     * 
+     * @param value
+     *            string to be encoded [OPTIONAL]
+     */
+    public void putString(String value) {
+        putBytes(value != null ? value.getBytes(StandardCharsets.UTF_8) : null);
+    }
+
+    /**
+     * This function encodes a point in time as seconds since the epoch
+     * 
+     * @param value
+     *            point in time to be encoded [OPTIONAL]
+     */
+    public void putTime(ZonedDateTime value) {
+        putSigned(value != null ? value.toEpochSecond() : 0);
+    }
+
+    /**
+     * This function encodes the value of an enum
+     * 
+     * @param value
+     *            value to be encoded [OPTIONAL]
+     */
+    public void putEnum(Enum<?> value) {
+        putUnsigned(value != null ? value.ordinal() : 0);
+    }
+}